@@ -0,0 +1,49 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "../include/common/checksum.h"
+#include "../include/common/config.h"
+
+namespace {
+
+std::vector<uint8_t> MakePageBytes() {
+  std::vector<uint8_t> page(PAGE_SIZE);
+  std::mt19937 rng(42);
+  for (uint8_t& byte : page) {
+    byte = static_cast<uint8_t>(rng());
+  }
+  return page;
+}
+
+// One page checksum with the given algorithm
+void BM_ChecksumPage(benchmark::State& state, checksum::Algorithm algorithm) {
+  const std::vector<uint8_t> page = MakePageBytes();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        checksum::Compute(algorithm, page.data(), page.size()));
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          PAGE_SIZE);
+  if (algorithm == checksum::Algorithm::CRC32C) {
+    state.SetLabel(checksum::Crc32cImplementation());
+  }
+}
+BENCHMARK_CAPTURE(BM_ChecksumPage, crc32c, checksum::Algorithm::CRC32C);
+BENCHMARK_CAPTURE(BM_ChecksumPage, crc32_legacy, checksum::Algorithm::CRC32);
+
+// Table-driven CRC32C, the fallback on CPUs without CRC instructions
+void BM_ChecksumPagePortable(benchmark::State& state) {
+  const std::vector<uint8_t> page = MakePageBytes();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(checksum::UpdateCrc32cPortable(
+        checksum::INITIAL_CRC, page.data(), page.size()));
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          PAGE_SIZE);
+}
+BENCHMARK(BM_ChecksumPagePortable);
+
+}  // namespace
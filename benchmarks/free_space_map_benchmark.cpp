@@ -0,0 +1,47 @@
+#include <benchmark/benchmark.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../include/storage/free_space_map.h"
+
+namespace {
+
+// FindPageWithSpace() over state.range(0) pages. Most pages are nearly
+// full and a few have room, so searches descend past many subtrees.
+void BM_FindPageWithSpace(benchmark::State& state) {
+  const page_id_t page_count = static_cast<page_id_t>(state.range(0));
+  const std::string file_name =
+      "/tmp/fsm_benchmark_" + std::to_string(getpid()) + ".fsm";
+  {
+    FreeSpaceMap fsm(file_name);
+    fsm.Initialize();
+
+    std::mt19937 rng(42);
+    std::vector<uint16_t> available(page_count - 1);
+    for (uint16_t& bytes : available) {
+      bytes = rng() % 100 == 0 ? static_cast<uint16_t>(rng() % PAGE_SIZE)
+                               : static_cast<uint16_t>(rng() % 256);
+    }
+    fsm.UpdatePagesFreeSpace(1, available);
+
+    std::vector<uint16_t> requests(1024);
+    for (uint16_t& bytes : requests) {
+      bytes = static_cast<uint16_t>(256 + rng() % 4096);
+    }
+
+    size_t next = 0;
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(fsm.FindPageWithSpace(requests[next]));
+      next = (next + 1) % requests.size();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+  }
+  std::remove(file_name.c_str());
+}
+BENCHMARK(BM_FindPageWithSpace)->Arg(10000)->Arg(1000000);
+
+}  // namespace
@@ -0,0 +1,61 @@
+#include <benchmark/benchmark.h>
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "../include/page/page.h"
+
+namespace {
+
+// Tuples of tuple_size that fit an empty page (each also takes a slot)
+size_t TuplesPerPage(uint16_t tuple_size) {
+  return (PAGE_SIZE - sizeof(PageHeader)) / (tuple_size + SLOT_ENTRY_SIZE);
+}
+
+// Fill an empty page with tuples of state.range(0) bytes; items are tuples
+void BM_PageInsertTuple(benchmark::State& state) {
+  const uint16_t tuple_size = static_cast<uint16_t>(state.range(0));
+  const std::vector<char> tuple(tuple_size, 'x');
+  const size_t per_page = TuplesPerPage(tuple_size);
+  auto page = Page::CreateNew();
+
+  for (auto _ : state) {
+    page->ResetMemory();
+    for (size_t i = 0; i < per_page; i++) {
+      benchmark::DoNotOptimize(page->InsertTuple(tuple.data(), tuple_size));
+    }
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() *
+                                               per_page));
+}
+BENCHMARK(BM_PageInsertTuple)->Arg(32)->Arg(128)->Arg(512);
+
+// Compact a full page with every other tuple deleted. Each iteration
+// restores the fragmented image first (one 8 KB copy).
+void BM_PageCompact(benchmark::State& state) {
+  const uint16_t tuple_size = static_cast<uint16_t>(state.range(0));
+  const std::vector<char> tuple(tuple_size, 'x');
+  const size_t per_page = TuplesPerPage(tuple_size);
+  auto page = Page::CreateNew();
+  for (size_t i = 0; i < per_page; i++) {
+    page->InsertTuple(tuple.data(), tuple_size);
+  }
+  for (slot_id_t slot = 0; slot < per_page; slot += 2) {
+    page->DeleteTuple(slot);
+  }
+
+  std::vector<char> image(page->GetRawBuffer(),
+                          page->GetRawBuffer() + PAGE_SIZE);
+  std::vector<char> scratch(PAGE_SIZE);
+  for (auto _ : state) {
+    std::memcpy(page->GetRawBuffer(), image.data(), PAGE_SIZE);
+    page->CompactPage(scratch.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_PageCompact)->Arg(32)->Arg(128)->Arg(512);
+
+}  // namespace
@@ -0,0 +1,134 @@
+#include <benchmark/benchmark.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../include/storage/disk_manager.h"
+#include "../include/storage/free_space_map.h"
+#include "../include/storage/page_manager.h"
+
+namespace {
+
+constexpr size_t TUPLE_SIZE = 100;
+constexpr size_t TABLE_ROWS = 100000;  // about 10 MB of pages
+
+// Buffer pool sizes: HOT holds the whole table, COLD about a tenth of it,
+// so most cold reads miss the pool (the OS page cache still serves them)
+constexpr size_t HOT_POOL_MB = 64;
+constexpr size_t COLD_POOL_MB = 1;
+
+// A table in its own files, removed again on destruction
+class BenchmarkTable {
+ public:
+  BenchmarkTable(const std::string& name, size_t pool_mb) {
+    const std::string base = "/tmp/benchmark_" + name + "_" +
+                             std::to_string(getpid());
+    db_file_ = base + ".db";
+    fsm_file_ = base + ".fsm";
+    std::remove(db_file_.c_str());
+    std::remove(fsm_file_.c_str());
+
+    disk_manager_ =
+        std::make_unique<DiskManager>(db_file_, DurabilityMode::BATCHED);
+    fsm_ = std::make_unique<FreeSpaceMap>(fsm_file_);
+    page_manager_ =
+        std::make_unique<PageManager>(disk_manager_.get(), fsm_.get(), pool_mb);
+  }
+
+  ~BenchmarkTable() {
+    page_manager_.reset();
+    fsm_.reset();
+    disk_manager_.reset();
+    std::remove(db_file_.c_str());
+    std::remove(fsm_file_.c_str());
+  }
+
+  PageManager* GetPageManager() const { return page_manager_.get(); }
+
+  std::vector<TupleId> Load(size_t rows) {
+    std::vector<TupleId> ids;
+    ids.reserve(rows);
+    std::string tuple(TUPLE_SIZE, 'r');
+    for (size_t row = 0; row < rows; row++) {
+      ids.push_back(page_manager_->InsertTuple(
+          tuple.data(), static_cast<uint16_t>(tuple.size())));
+    }
+    page_manager_->FlushAllPages();
+    return ids;
+  }
+
+ private:
+  std::string db_file_;
+  std::string fsm_file_;
+  std::unique_ptr<DiskManager> disk_manager_;
+  std::unique_ptr<FreeSpaceMap> fsm_;
+  std::unique_ptr<PageManager> page_manager_;
+};
+
+// Point-get tables by cache mode (0 = hot, 1 = cold). Loaded on first use
+// and kept for every thread count.
+std::unique_ptr<BenchmarkTable> read_tables[2];
+std::vector<TupleId> read_ids[2];
+
+void SetUpReadTable(const benchmark::State& state) {
+  const size_t mode = static_cast<size_t>(state.range(0));
+  if (read_tables[mode] == nullptr) {
+    read_tables[mode] = std::make_unique<BenchmarkTable>(
+        mode == 0 ? "hot" : "cold", mode == 0 ? HOT_POOL_MB : COLD_POOL_MB);
+    read_ids[mode] = read_tables[mode]->Load(TABLE_ROWS);
+  }
+}
+
+// Uniformly random point gets; range(0) picks the cache mode
+void BM_PageManagerPointGet(benchmark::State& state) {
+  const size_t mode = static_cast<size_t>(state.range(0));
+  PageManager* page_manager = read_tables[mode]->GetPageManager();
+  const std::vector<TupleId>& ids = read_ids[mode];
+  std::mt19937 rng(static_cast<uint32_t>(state.thread_index()) + 1);
+  char buffer[TUPLE_SIZE];
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        page_manager->GetTuple(ids[rng() % ids.size()], buffer,
+                               sizeof(buffer)));
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+  state.SetLabel(mode == 0 ? "hot" : "cold");
+}
+BENCHMARK(BM_PageManagerPointGet)
+    ->Arg(0)
+    ->Arg(1)
+    ->Setup(SetUpReadTable)
+    ->ThreadRange(1, 32)
+    ->UseRealTime();
+
+// Inserts start from an empty table for every thread count
+std::unique_ptr<BenchmarkTable> insert_table;
+
+void SetUpInsertTable(const benchmark::State&) {
+  insert_table = std::make_unique<BenchmarkTable>("insert", HOT_POOL_MB);
+}
+
+void TearDownInsertTable(const benchmark::State&) { insert_table.reset(); }
+
+void BM_PageManagerInsert(benchmark::State& state) {
+  PageManager* page_manager = insert_table->GetPageManager();
+  const std::string tuple(TUPLE_SIZE, 'i');
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(page_manager->InsertTuple(
+        tuple.data(), static_cast<uint16_t>(tuple.size())));
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_PageManagerInsert)
+    ->Setup(SetUpInsertTable)
+    ->Teardown(TearDownInsertTable)
+    ->ThreadRange(1, 32)
+    ->UseRealTime();
+
+}  // namespace
@@ -0,0 +1,134 @@
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "../include/common/arena.h"
+#include "../include/schema/schema.h"
+#include "../include/tuple/field_value.h"
+#include "../include/tuple/tuple_accessor.h"
+#include "../include/tuple/tuple_serializer.h"
+#include "../include/tuple/value_ref.h"
+
+namespace {
+
+// id, score, created_at, active: the fixed-length layout
+Schema MakeFixedSchema() {
+  Schema schema;
+  schema.AddColumn("id", DataType::INTEGER, false, 0);
+  schema.AddColumn("score", DataType::DOUBLE, false, 0);
+  schema.AddColumn("created_at", DataType::BIGINT, false, 0);
+  schema.AddColumn("active", DataType::BOOLEAN, true, 0);
+  schema.Finalize();
+  return schema;
+}
+
+// id, name, email, balance: the variable-length layout
+Schema MakeVariableSchema() {
+  Schema schema;
+  schema.AddColumn("id", DataType::INTEGER, false, 0);
+  schema.AddColumn("name", DataType::VARCHAR, false, 64);
+  schema.AddColumn("email", DataType::VARCHAR, true, 128);
+  schema.AddColumn("balance", DataType::DOUBLE, false, 0);
+  schema.Finalize();
+  return schema;
+}
+
+std::vector<FieldValue> MakeFixedValues() {
+  return {FieldValue::Integer(42), FieldValue::Double(98.6),
+          FieldValue::BigInt(1700000000000), FieldValue::Boolean(true)};
+}
+
+std::vector<FieldValue> MakeVariableValues() {
+  return {FieldValue::Integer(42), FieldValue::VarChar("Alice Example"),
+          FieldValue::VarChar("alice@example.com"), FieldValue::Double(12.5)};
+}
+
+// FieldValue round trip: serialize, then deserialize into new values
+void BM_SerializerRoundTrip(benchmark::State& state, bool fixed) {
+  const Schema schema = fixed ? MakeFixedSchema() : MakeVariableSchema();
+  const std::vector<FieldValue> values =
+      fixed ? MakeFixedValues() : MakeVariableValues();
+  char buffer[512];
+
+  for (auto _ : state) {
+    if (fixed) {
+      const size_t size = TupleSerializer::SerializeFixedLength(
+          schema, values, buffer, sizeof(buffer));
+      benchmark::DoNotOptimize(
+          TupleSerializer::DeserializeFixedLength(schema, buffer, size));
+    } else {
+      const size_t size = TupleSerializer::SerializeVariableLength(
+          schema, values, buffer, sizeof(buffer));
+      benchmark::DoNotOptimize(
+          TupleSerializer::DeserializeVariableLength(schema, buffer, size));
+    }
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK_CAPTURE(BM_SerializerRoundTrip, fixed, true);
+BENCHMARK_CAPTURE(BM_SerializerRoundTrip, variable, false);
+
+// Allocation-free round trip over ValueRef, reusing the output vector
+void BM_SerializerRefRoundTrip(benchmark::State& state, bool fixed) {
+  const Schema schema = fixed ? MakeFixedSchema() : MakeVariableSchema();
+  Arena arena;
+  std::vector<ValueRef> values;
+  for (const FieldValue& value :
+       fixed ? MakeFixedValues() : MakeVariableValues()) {
+    values.push_back(ValueRef::FromFieldValue(value, &arena));
+  }
+  std::vector<ValueRef> decoded;
+  char buffer[512];
+
+  for (auto _ : state) {
+    const size_t size =
+        TupleSerializer::Serialize(schema, values, buffer, sizeof(buffer));
+    TupleSerializer::Deserialize(schema, buffer, size, nullptr, &decoded);
+    benchmark::DoNotOptimize(decoded.data());
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK_CAPTURE(BM_SerializerRefRoundTrip, fixed, true);
+BENCHMARK_CAPTURE(BM_SerializerRefRoundTrip, variable, false);
+
+// Single-field reads through TupleAccessor, by index and by name
+void BM_AccessorGetInteger(benchmark::State& state) {
+  const Schema schema = MakeFixedSchema();
+  char buffer[512];
+  const size_t size = TupleSerializer::SerializeFixedLength(
+      schema, MakeFixedValues(), buffer, sizeof(buffer));
+  TupleAccessor accessor(schema, buffer, size);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(accessor.GetInteger(0));
+  }
+}
+BENCHMARK(BM_AccessorGetInteger);
+
+void BM_AccessorGetIntegerByName(benchmark::State& state) {
+  const Schema schema = MakeFixedSchema();
+  char buffer[512];
+  const size_t size = TupleSerializer::SerializeFixedLength(
+      schema, MakeFixedValues(), buffer, sizeof(buffer));
+  TupleAccessor accessor(schema, buffer, size);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(accessor.GetInteger("id"));
+  }
+}
+BENCHMARK(BM_AccessorGetIntegerByName);
+
+void BM_AccessorGetStringView(benchmark::State& state) {
+  const Schema schema = MakeVariableSchema();
+  char buffer[512];
+  const size_t size = TupleSerializer::SerializeVariableLength(
+      schema, MakeVariableValues(), buffer, sizeof(buffer));
+  TupleAccessor accessor(schema, buffer, size);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(accessor.GetStringView(2));
+  }
+}
+BENCHMARK(BM_AccessorGetStringView);
+
+}  // namespace
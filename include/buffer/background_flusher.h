@@ -0,0 +1,94 @@
+#ifndef STORAGEENGINE_BACKGROUND_FLUSHER_H
+#define STORAGEENGINE_BACKGROUND_FLUSHER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#include "../common/config.h"
+#include "../common/types.h"
+#include "buffer_pool_manager.h"
+
+// BackgroundFlusher writes dirty buffer pool pages back from its own
+// thread, so foreground evictions find clean victims instead of paying for
+// a synchronous write and fsync.
+//
+// Every interval_ms it checks how many frames are dirty. If fewer than
+// clean_target of the pool's frames are clean, it writes the excess (at
+// most max_pages_per_round pages) in ascending page-id order, resuming
+// after the last page it wrote so every region of the file gets its turn.
+// Consecutive ids are coalesced into one vectored write and each round
+// ends with a single Sync().
+//
+// Every checkpoint_interval_ms (0 disables) it also runs a checkpoint:
+// every page dirty at that moment is written, which bounds how long a
+// modification stays only in memory. Checkpoint() can be called directly.
+//
+// Pages are copied under their shared latch into a staging area owned by
+// the flusher (max_pages_per_round pages), so writers are never blocked
+// on I/O. The BufferPoolManager must outlive the flusher.
+//
+// Usage example:
+//   BufferPoolManager bpm(frames, &dm);
+//   BackgroundFlusher flusher(&bpm);  // default policy, starts the thread
+//   ... workload ...
+//   flusher.Checkpoint();             // everything dirty so far is on disk
+class BackgroundFlusher {
+ public:
+  BackgroundFlusher(
+      BufferPoolManager* buffer_pool,
+      uint32_t interval_ms = DEFAULT_FLUSH_INTERVAL_MS,
+      double clean_target = DEFAULT_FLUSH_CLEAN_TARGET,
+      size_t max_pages_per_round = DEFAULT_FLUSH_MAX_PAGES,
+      uint32_t checkpoint_interval_ms = DEFAULT_CHECKPOINT_INTERVAL_MS);
+
+  // Stops the thread (no final checkpoint; the pool flushes on destruction)
+  ~BackgroundFlusher();
+
+  BackgroundFlusher(const BackgroundFlusher&) = delete;
+  BackgroundFlusher& operator=(const BackgroundFlusher&) = delete;
+
+  // Run one clean-target round now on the calling thread
+  ErrorCode RunOnce();
+
+  // Write every page that is dirty now, in page-id order
+  ErrorCode Checkpoint();
+
+  // Finish the current round and join the thread. Idempotent.
+  void Stop();
+
+  uint64_t GetPagesWritten() const { return pages_written_.load(); }
+  uint64_t GetRoundCount() const { return rounds_.load(); }
+  uint64_t GetCheckpointCount() const { return checkpoints_.load(); }
+
+ private:
+  BufferPoolManager* buffer_pool_;
+  uint32_t interval_ms_;
+  size_t max_dirty_pages_;  // pool size * (1 - clean_target)
+  size_t max_pages_per_round_;
+  uint32_t checkpoint_interval_ms_;
+
+  // Guards staging_ and cursor_ (rounds and checkpoints are serialized)
+  std::mutex round_mutex_;
+  AlignedBuffer staging_;
+  page_id_t cursor_;  // first page id considered by the next round
+
+  std::atomic<uint64_t> pages_written_;
+  std::atomic<uint64_t> rounds_;
+  std::atomic<uint64_t> checkpoints_;
+
+  std::thread thread_;
+  std::mutex thread_mutex_;
+  std::condition_variable thread_cv_;
+  bool stop_thread_;
+
+  // Write page_ids (ascending) in staging-sized batches
+  ErrorCode WriteBatches(const std::vector<page_id_t>& page_ids);
+
+  void ThreadLoop();
+};
+
+#endif  // STORAGEENGINE_BACKGROUND_FLUSHER_H
@@ -0,0 +1,234 @@
+#ifndef STORAGEENGINE_BUFFER_POOL_MANAGER_H
+#define STORAGEENGINE_BUFFER_POOL_MANAGER_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "../common/config.h"
+#include "../common/metrics.h"
+#include "../common/types.h"
+#include "../page/page.h"
+#include "../storage/disk_manager.h"
+#include "frame_pool.h"
+#include "replacer.h"
+
+class LogManager;
+
+// BufferPoolManager caches disk pages in a fixed array of frames that is
+// allocated once at construction time and recycled across evictions.
+//
+//   partitions_:  page_id -> frame_id, sharded by page_id % N, one latch each
+//   frames_:      frame_id -> Page      (one FramePool mapping + RW latch)
+//   descriptors_: frame_id -> {page_id, pin_count, is_dirty}
+//   free_lists_:  frames that hold no page, per NUMA node (own latches)
+//   replacer_:    picks a victim among unpinned frames (CLOCK or LRU-K)
+//
+// Concurrency:
+//   - A frame's descriptor is guarded by the partition latch of the page it
+//     holds. Lookups in different partitions never contend, and a cache miss
+//     only blocks its own partition while the page is read from disk.
+//   - Latches are never nested across partitions. Lock order is
+//     partition -> free list -> replacer.
+//   - Page contents are protected by the page's own RLatch/WLatch, taken by
+//     PageGuard. The pool only takes a page latch when flushing a pinned page.
+//
+// NUMA: the frames are split into one range per node (bound to that
+// node's memory, see FramePool) with a free list each. A miss or new page
+// takes a free frame of the calling thread's node first, then of the
+// others; victims are chosen pool-wide. GetMetrics() reports per-node
+// occupancy and how many frames were taken locally.
+//
+// Write-ahead logging: with a LogManager attached, a page is written only
+// after the log is durable up to the page's LSN, so every change on disk
+// can be found in the log. Single page writes then skip their own fsync
+// (the log can rebuild a lost or torn page); FlushAllPages() and
+// WriteDirtyPages() still end with one sync.
+//
+// Callers must pair every successful FetchPage()/NewPage() with exactly one
+// UnpinPage(). A pinned frame is never evicted. Use PageGuard for RAII.
+//
+// Usage example:
+//   DiskManager dm("data.db");
+//   BufferPoolManager bpm(
+//       BufferPoolManager::FramesForMemoryBudget(64), &dm);
+//   Page* page = bpm.FetchPage(page_id);
+//   ... read / modify page ...
+//   bpm.UnpinPage(page_id, /*is_dirty=*/true);
+class BufferPoolManager {
+ public:
+  BufferPoolManager(size_t pool_size, DiskManager* disk_manager,
+                    ReplacerType replacer_type = ReplacerType::LRU_K,
+                    size_t lru_k = DEFAULT_LRU_K,
+                    size_t num_partitions = DEFAULT_PAGE_TABLE_PARTITIONS);
+
+  // Flushes all dirty pages before releasing frames
+  ~BufferPoolManager();
+
+  BufferPoolManager(const BufferPoolManager&) = delete;
+  BufferPoolManager& operator=(const BufferPoolManager&) = delete;
+
+  // Enforce the write-ahead rule for every later page write (nullptr: none).
+  // Set before the pool is shared with other threads.
+  void SetLogManager(LogManager* log_manager) { log_manager_ = log_manager; }
+
+  // Convert a memory budget in MB into a frame count (at least 1 frame)
+  static size_t FramesForMemoryBudget(size_t budget_mb);
+
+  // Pin the page, reading it from disk on a miss.
+  // Returns nullptr if every frame is pinned or the read fails.
+  Page* FetchPage(page_id_t page_id);
+
+  // Pin a batch of pages. Misses are read with one asynchronous submission
+  // so their I/O overlaps instead of running one read at a time.
+  // Entry i is nullptr if page_ids[i] could not be loaded; every non-null
+  // entry must be unpinned once (duplicate ids are pinned once per entry).
+  std::vector<Page*> FetchPages(const std::vector<page_id_t>& page_ids);
+
+  // Allocate a page id from the DiskManager and pin an empty page for it.
+  // Returns nullptr (and leaves *page_id untouched) on failure.
+  Page* NewPage(page_id_t* page_id);
+
+  // Drop the page from the pool without writing it back and return its id
+  // to the DiskManager's free list. The caller guarantees nothing refers to
+  // the page any more. Returns false if it is pinned (page untouched) or
+  // the deallocation fails (the page is leaked).
+  bool DeletePage(page_id_t page_id);
+
+  // Drop one pin. is_dirty is OR-ed into the frame's dirty flag.
+  // Returns false if the page is not resident or was not pinned.
+  bool UnpinPage(page_id_t page_id, bool is_dirty);
+
+  // Write the page to disk if resident and dirty.
+  // Must not be called while holding a latch on the same page.
+  ErrorCode FlushPage(page_id_t page_id);
+
+  // Write every dirty resident page to disk, then make them durable with a
+  // single DiskManager::Sync() regardless of the durability mode
+  ErrorCode FlushAllPages();
+
+  // Dirty resident page ids in ascending order (a snapshot)
+  std::vector<page_id_t> GetDirtyPageIds() const;
+
+  // Write back the dirty pages among page_ids (ascending, at most
+  // staging_pages of them) and make them durable with one Sync().
+  // Each page is copied into staging under its shared latch, so writers
+  // are blocked only for the copy, never for the I/O; consecutive ids are
+  // written with one vectored write. staging must hold staging_pages
+  // pages aligned to DIRECT_IO_ALIGNMENT. *pages_written (if non-null)
+  // receives the number of pages written. A page modified after its copy
+  // stays dirty; a page whose write fails is marked dirty again.
+  ErrorCode WriteDirtyPages(const std::vector<page_id_t>& page_ids,
+                            char* staging, size_t staging_pages,
+                            size_t* pages_written = nullptr);
+
+  // Flush dirty pages and release every unpinned frame back to the free list
+  // (one Sync() for the whole batch)
+  ErrorCode EvictAllPages();
+
+  size_t GetPoolSize() const { return pool_size_; }
+  size_t GetPartitionCount() const { return num_partitions_; }
+
+  // Number of frames currently holding a page
+  size_t GetResidentPageCount() const;
+
+  bool IsPageResident(page_id_t page_id) const;
+
+  // Ids of every page currently holding a frame (a snapshot)
+  std::vector<page_id_t> GetResidentPageIds() const;
+
+  // Pin the page only if it is already resident: never reads from disk and
+  // does not count as an access for the replacer, so background work does
+  // not keep cold pages cached. Returns nullptr if the page is not resident.
+  Page* FetchResidentPage(page_id_t page_id);
+
+  // Current pin count of a resident page (0 if not resident)
+  int GetPinCount(page_id_t page_id) const;
+
+  // Victims that had to be written back before their frame could be reused
+  // (foreground evictions that blocked on a write)
+  uint64_t GetDirtyEvictionCount() const { return dirty_evictions_.load(); }
+
+  // Hit/miss and eviction counters plus current occupancy
+  BufferPoolMetrics GetMetrics() const;
+
+ private:
+  struct FrameDescriptor {
+    // Atomic so an evictor can find the victim's partition before latching it
+    std::atomic<page_id_t> page_id{INVALID_PAGE_ID};
+    int pin_count = 0;
+    bool is_dirty = false;
+
+    void Reset() {
+      page_id.store(INVALID_PAGE_ID, std::memory_order_relaxed);
+      pin_count = 0;
+      is_dirty = false;
+    }
+  };
+
+  struct Partition {
+    mutable std::mutex latch;
+    std::unordered_map<page_id_t, frame_id_t> page_table;
+    // Bumped under latch, so they share its cache line instead of
+    // contending across partitions; atomic for GetMetrics()
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> misses{0};
+  };
+
+  size_t pool_size_;
+  DiskManager* disk_manager_;
+  LogManager* log_manager_ = nullptr;
+
+  std::unique_ptr<FramePool> frames_;
+  std::vector<FrameDescriptor> descriptors_;
+  size_t num_partitions_;
+  std::unique_ptr<Partition[]> partitions_;
+  std::unique_ptr<Replacer> replacer_;
+
+  // Frames that hold no page, one list per NUMA node
+  struct FreeList {
+    std::mutex latch;
+    std::vector<frame_id_t> frames;
+  };
+  std::unique_ptr<FreeList[]> free_lists_;
+
+  std::atomic<uint64_t> dirty_evictions_{0};
+  std::atomic<uint64_t> clean_evictions_{0};
+  std::atomic<uint64_t> local_frame_acquires_{0};
+  std::atomic<uint64_t> remote_frame_acquires_{0};
+
+  Partition& PartitionFor(page_id_t page_id) const;
+
+  // Take a frame off the free list, or evict a victim (writing it back if
+  // dirty). Must be called with no partition latch held.
+  // Returns INVALID_FRAME_ID if every frame is pinned.
+  frame_id_t AcquireFrame();
+
+  void ReturnFrame(frame_id_t frame_id);
+
+  // Pin an already resident frame (partition latch must be held)
+  void PinFrame(frame_id_t frame_id);
+
+  // Same without recording an access, for background work that should not
+  // keep a page cached
+  void PinFrameWithoutAccess(frame_id_t frame_id);
+
+  // Write a frame back if dirty. The caller must hold the partition latch
+  // and guarantee nobody else can latch the page (pin count of zero).
+  // defer_sync: caller issues one SyncBatch() after a batch of writes.
+  ErrorCode FlushFrame(frame_id_t frame_id, bool defer_sync = false);
+
+  // Flush a resident page that may be pinned by others: pins it, takes its
+  // exclusive latch with no partition latch held, writes, then unpins.
+  ErrorCode FlushPinnedPage(page_id_t page_id, bool defer_sync = false);
+
+  // Make deferred writes durable with a single fdatasync
+  ErrorCode SyncBatch();
+
+  // Flush the log up to page_lsn before a page carrying it is written
+  ErrorCode FlushLogFor(lsn_t page_lsn);
+};
+
+#endif  // STORAGEENGINE_BUFFER_POOL_MANAGER_H
@@ -0,0 +1,42 @@
+#ifndef STORAGEENGINE_CLOCK_REPLACER_H
+#define STORAGEENGINE_CLOCK_REPLACER_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "replacer.h"
+
+// CLOCK (second-chance) replacement policy.
+//
+// Frames are arranged in a circular buffer with a single reference bit each.
+// RecordAccess() sets the bit; Evict() sweeps the clock hand, clearing bits
+// until it finds an evictable frame whose bit is already clear.
+//
+//   hand -> [f0 ref=1] -> [f1 ref=0] -> [f2 pinned] -> ...
+//           clear bit     VICTIM
+//
+// Reference bits are atomics so RecordAccess() on the buffer pool hit path
+// never takes the replacer latch; only Evict()/SetEvictable()/Remove() do.
+class ClockReplacer : public Replacer {
+ public:
+  explicit ClockReplacer(size_t num_frames);
+  ~ClockReplacer() override = default;
+
+  void RecordAccess(frame_id_t frame_id) override;
+  void SetEvictable(frame_id_t frame_id, bool evictable) override;
+  bool Evict(frame_id_t* frame_id) override;
+  void Remove(frame_id_t frame_id) override;
+  size_t Size() const override;
+
+ private:
+  const size_t num_frames_;
+  std::vector<bool> evictable_;                    // guarded by latch_
+  std::unique_ptr<std::atomic<bool>[]> referenced_;  // lock-free
+  size_t hand_;
+  size_t evictable_count_;
+  mutable std::mutex latch_;
+};
+
+#endif  // STORAGEENGINE_CLOCK_REPLACER_H
@@ -0,0 +1,65 @@
+#ifndef STORAGEENGINE_FRAME_POOL_H
+#define STORAGEENGINE_FRAME_POOL_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "../common/config.h"
+#include "../page/page.h"
+
+// FramePool carves a fixed number of page frames out of one anonymous
+// mapping: no per-frame allocation, frames adjacent in memory, and, when
+// huge pages are used, a TLB entry per HUGE_PAGE_SIZE instead of per 4 KB.
+// Frames are recycled by their owner (BufferPoolManager, TableScan) and
+// released only with the pool.
+//
+// Backing, with use_huge_pages:
+//   - explicit huge pages (MAP_HUGETLB) if the pool spans at least one
+//     and the system has enough reserved;
+//   - otherwise normal pages, aligned to HUGE_PAGE_SIZE and advised
+//     MADV_HUGEPAGE so transparent huge pages can back them.
+// Mapped memory reads as zeros and is faulted in on first use. Frames are
+// PAGE_SIZE aligned, as O_DIRECT needs.
+//
+// NUMA: with numa_nodes > 1 the frames are split into that many contiguous
+// ranges, range n bound to node n (BindMemoryToNumaNode()), so a frame's
+// memory is local to the node GetNodeOf() reports.
+//
+// Usage example:
+//   FramePool pool(1024);
+//   Page* page = pool.GetFrame(0);
+//   page->ResetMemory();
+class FramePool {
+ public:
+  // Throws std::invalid_argument for zero frames and std::runtime_error if
+  // the memory cannot be mapped
+  explicit FramePool(size_t frame_count,
+                     bool use_huge_pages = BUFFER_POOL_USE_HUGE_PAGES,
+                     size_t numa_nodes = 1);
+
+  ~FramePool();
+
+  FramePool(const FramePool&) = delete;
+  FramePool& operator=(const FramePool&) = delete;
+
+  Page* GetFrame(size_t frame_id) const { return frames_[frame_id].get(); }
+  size_t GetFrameCount() const { return frames_.size(); }
+
+  // Whether the frames sit on explicit huge pages (MAP_HUGETLB)
+  bool IsHugeTlbBacked() const { return huge_tlb_; }
+
+  // Frames of node n are [GetFirstFrame(n), GetFirstFrame(n + 1))
+  size_t GetNodeCount() const { return node_first_frame_.size() - 1; }
+  size_t GetFirstFrame(size_t node) const { return node_first_frame_[node]; }
+  size_t GetNodeOf(size_t frame_id) const;
+
+ private:
+  void* mapping_;
+  size_t mapping_size_;
+  bool huge_tlb_;
+  std::vector<std::unique_ptr<Page>> frames_;
+  std::vector<size_t> node_first_frame_;  // per node, plus the frame count
+};
+
+#endif  // STORAGEENGINE_FRAME_POOL_H
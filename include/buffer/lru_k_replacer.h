@@ -0,0 +1,55 @@
+#ifndef STORAGEENGINE_LRU_K_REPLACER_H
+#define STORAGEENGINE_LRU_K_REPLACER_H
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "replacer.h"
+
+// LRU-K replacement policy.
+//
+// The backward K-distance of a frame is the difference between the current
+// logical timestamp and the timestamp of its K-th most recent access.
+// Frames with fewer than K recorded accesses have +inf distance and are
+// evicted first (earliest first access wins among them), so a one-off scan
+// touching many pages once cannot push out pages that are genuinely hot.
+//
+// Evictable frames are kept in two ordered sets keyed by the timestamp that
+// decides their eviction order, so Evict() and RecordAccess() are O(log N).
+class LRUKReplacer : public Replacer {
+ public:
+  LRUKReplacer(size_t num_frames, size_t k);
+  ~LRUKReplacer() override = default;
+
+  void RecordAccess(frame_id_t frame_id) override;
+  void SetEvictable(frame_id_t frame_id, bool evictable) override;
+  bool Evict(frame_id_t* frame_id) override;
+  void Remove(frame_id_t frame_id) override;
+  size_t Size() const override;
+
+ private:
+  using OrderKey = std::pair<uint64_t, frame_id_t>;
+
+  struct FrameHistory {
+    std::deque<uint64_t> timestamps;  // most recent at back, at most K entries
+    bool evictable = false;
+  };
+
+  // Timestamp used to order this frame inside its eviction set
+  OrderKey KeyFor(frame_id_t frame_id) const;
+  void Unlink(frame_id_t frame_id);
+  void Link(frame_id_t frame_id);
+
+  size_t k_;
+  uint64_t current_timestamp_;
+  std::vector<FrameHistory> history_;
+  std::set<OrderKey> infinite_distance_;  // < K accesses, keyed by first access
+  std::set<OrderKey> finite_distance_;    // >= K accesses, keyed by K-th access
+  mutable std::mutex latch_;
+};
+
+#endif  // STORAGEENGINE_LRU_K_REPLACER_H
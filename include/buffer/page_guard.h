@@ -0,0 +1,61 @@
+#ifndef STORAGEENGINE_PAGE_GUARD_H
+#define STORAGEENGINE_PAGE_GUARD_H
+
+#include "../common/types.h"
+#include "../page/page.h"
+
+class BufferPoolManager;
+
+// How a PageGuard latches the page it pins
+enum class LatchMode {
+  NONE,       // pin only; caller coordinates access itself
+  SHARED,     // RLatch: concurrent readers allowed
+  EXCLUSIVE,  // WLatch: single writer
+};
+
+// RAII pin (and optionally latch) on a buffer pool page.
+// The destructor (or Release()) drops the latch first and then calls
+// BufferPoolManager::UnpinPage exactly once, passing along whether the holder
+// modified the page. Move-only to prevent double unpins.
+//
+// Example:
+//   PageGuard guard(bpm, page_id, bpm->FetchPage(page_id),
+//                   LatchMode::EXCLUSIVE);
+//   if (!guard) return error;
+//   guard->InsertTuple(data, size);
+//   guard.MarkDirty();
+//   // unlatched and unpinned here
+class PageGuard {
+ public:
+  PageGuard() = default;
+  PageGuard(BufferPoolManager* bpm, page_id_t page_id, Page* page,
+            LatchMode mode = LatchMode::NONE);
+  ~PageGuard();
+
+  PageGuard(PageGuard&& other) noexcept;
+  PageGuard& operator=(PageGuard&& other) noexcept;
+
+  PageGuard(const PageGuard&) = delete;
+  PageGuard& operator=(const PageGuard&) = delete;
+
+  Page* GetPage() const { return page_; }
+  Page* operator->() const { return page_; }
+  page_id_t GetPageId() const { return page_id_; }
+  LatchMode GetLatchMode() const { return mode_; }
+  explicit operator bool() const { return page_ != nullptr; }
+
+  // Record that the page was modified; reported to the pool on unpin
+  void MarkDirty() { is_dirty_ = true; }
+
+  // Unlatch and unpin now instead of at destruction
+  void Release();
+
+ private:
+  BufferPoolManager* bpm_ = nullptr;
+  page_id_t page_id_ = INVALID_PAGE_ID;
+  Page* page_ = nullptr;
+  LatchMode mode_ = LatchMode::NONE;
+  bool is_dirty_ = false;
+};
+
+#endif  // STORAGEENGINE_PAGE_GUARD_H
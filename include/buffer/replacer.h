@@ -0,0 +1,40 @@
+#ifndef STORAGEENGINE_REPLACER_H
+#define STORAGEENGINE_REPLACER_H
+
+#include <cstddef>
+
+#include "../common/config.h"
+#include "../common/types.h"
+
+// Replacer decides which buffer pool frame to evict when the pool is full.
+// The BufferPoolManager reports every page access and every pin/unpin
+// transition; only frames marked evictable (pin count == 0) may be chosen
+// as victims.
+//
+// Implementations:
+//   - ClockReplacer: second-chance CLOCK, O(1) amortized, one ref bit/frame
+//   - LRUKReplacer:  evicts the frame with the largest backward K-distance
+enum class ReplacerType { CLOCK, LRU_K };
+
+class Replacer {
+ public:
+  virtual ~Replacer() = default;
+
+  // Record that the frame was accessed (fetched or newly created)
+  virtual void RecordAccess(frame_id_t frame_id) = 0;
+
+  // Mark a frame as evictable (unpinned) or non-evictable (pinned)
+  virtual void SetEvictable(frame_id_t frame_id, bool evictable) = 0;
+
+  // Choose a victim frame. Returns false if no frame is evictable.
+  // The victim's access history is cleared.
+  virtual bool Evict(frame_id_t* frame_id) = 0;
+
+  // Forget a frame entirely (page deleted / frame returned to free list)
+  virtual void Remove(frame_id_t frame_id) = 0;
+
+  // Number of evictable frames
+  virtual size_t Size() const = 0;
+};
+
+#endif  // STORAGEENGINE_REPLACER_H
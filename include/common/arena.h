@@ -0,0 +1,64 @@
+#ifndef STORAGEENGINE_ARENA_H
+#define STORAGEENGINE_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "config.h"
+
+// Bump allocator for short-lived tuple data (strings and blobs of ValueRef).
+//
+// Allocate() hands out memory from large blocks; nothing is freed
+// individually. Reset() rewinds to the first block and keeps every block,
+// so an arena reused per batch stops calling malloc once it has grown to
+// the batch's high-water mark. Everything allocated before a Reset() is
+// invalidated by it.
+//
+// Not thread-safe. ForThread() returns a per-thread instance for callers
+// that do not want to own one.
+//
+// Usage example:
+//   Arena& arena = Arena::ForThread();
+//   for (each batch) {
+//     arena.Reset();
+//     ... decode tuples into ValueRefs backed by arena ...
+//   }
+class Arena {
+ public:
+  explicit Arena(size_t block_size = DEFAULT_ARENA_BLOCK_SIZE);
+
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  static Arena& ForThread();
+
+  // Never returns nullptr. align must be a power of two.
+  char* Allocate(size_t size, size_t align = alignof(std::max_align_t));
+
+  // Copy size bytes into the arena (no alignment). Returns nullptr for 0.
+  const char* Copy(const void* data, size_t size);
+
+  void Reset();
+
+  // Bytes handed out since the last Reset()
+  size_t GetBytesUsed() const { return bytes_used_; }
+
+  // Bytes held in blocks (survives Reset())
+  size_t GetCapacity() const { return capacity_; }
+
+ private:
+  struct Block {
+    std::unique_ptr<char[]> data;
+    size_t size;
+  };
+
+  size_t block_size_;
+  std::vector<Block> blocks_;
+  size_t current_block_;  // index into blocks_, == size() when none
+  size_t block_offset_;   // next free byte in the current block
+  size_t bytes_used_;
+  size_t capacity_;
+};
+
+#endif  // STORAGEENGINE_ARENA_H
@@ -5,26 +5,42 @@
 #ifndef STORAGEENGINE_CHECKSUM_H
 #define STORAGEENGINE_CHECKSUM_H
 
-#include <mutex>
-
+#include <cstddef>
+#include <cstdint>
+
+// Page checksums. Two algorithms are supported:
+//   CRC32  - MSB-first, polynomial 0x04C11DB7, byte-at-a-time table.
+//            The original page checksum, kept so old files still verify.
+//   CRC32C - Castagnoli (reflected polynomial 0x82F63B78). Uses the SSE4.2
+//            crc32 / ARMv8 CRC instructions when the CPU has them (picked
+//            once at runtime), slicing-by-8 tables otherwise.
+// The Init/Update/Finalize overloads without an Algorithm are CRC32.
 class checksum final {
  public:
+  enum class Algorithm : uint8_t { CRC32 = 0, CRC32C = 1 };
+
   static constexpr uint32_t POLYNOMIAL = 0x04C11DB7;
+  static constexpr uint32_t CRC32C_POLYNOMIAL = 0x82F63B78;  // reflected
   static constexpr uint32_t INITIAL_CRC = 0xFFFFFFFF;
 
   static uint32_t Compute(const uint8_t* data, std::size_t length);
+  static uint32_t Compute(Algorithm algorithm, const uint8_t* data,
+                          std::size_t length);
 
-  // Incremental CRC32 computation
+  // Incremental CRC computation
   static uint32_t Init();
   static uint32_t Update(uint32_t crc, const uint8_t* data, std::size_t length);
+  static uint32_t Update(Algorithm algorithm, uint32_t crc, const uint8_t* data,
+                         std::size_t length);
   static uint32_t Finalize(uint32_t crc);
 
- private:
-  static uint32_t lookup_table_[256];
-  static std::once_flag init_flag_;
+  // Portable CRC32C (slicing-by-8), exposed to cross-check the hardware path
+  static uint32_t UpdateCrc32cPortable(uint32_t crc, const uint8_t* data,
+                                       std::size_t length);
 
-  static void BuildLookupTable();
-  static void EnsureTableInitialized();
+  // CRC32C implementation selected for this CPU:
+  // "sse4.2", "armv8-crc" or "slicing-by-8"
+  static const char* Crc32cImplementation();
 };
 
 #endif  // STORAGEENGINE_CHECKSUM_H
@@ -0,0 +1,99 @@
+#ifndef STORAGEENGINE_COMPRESSION_H
+#define STORAGEENGINE_COMPRESSION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "config.h"
+#include "types.h"
+
+// Per-table tuple compression for SLOT_COMPRESSED slots.
+//
+// Codec: the LZ4 block format (token, literals, 2-byte offset, match
+// length; last 5 bytes literal), encoded with a single-probe hash table as
+// LZ4's fast mode does, so any LZ4 block decoder could read the payload.
+// It is implemented here because the engine has no external dependencies.
+//
+// Dictionary: rows of one table mostly repeat each other (column names in
+// JSON, enum-like strings, shared prefixes), which a single short tuple
+// cannot exploit on its own. An optional dictionary, trained from sample
+// tuples with TrainDictionary(), is treated as if it preceded every tuple,
+// so matches can reach back into it, like LZ4_loadDict() or a zstd
+// dictionary. The same dictionary must be supplied whenever the table is
+// reopened; each payload records the dictionary's id, and a tuple written
+// with a different dictionary fails to decompress instead of decoding
+// garbage.
+//
+// Stored form of a compressed tuple:
+//   [uint16_t raw size][uint16_t dictionary id, 0 for none][LZ4 block]
+// Compress() produces it only when it is smaller than the tuple.
+//
+// Usage example:
+//   TupleCompressor compressor(
+//       TupleCompressor::TrainDictionary(sample_rows));
+//   page_manager.SetTupleCompressor(&compressor);
+
+struct CompressedTupleHeader {
+  uint16_t raw_size;
+  uint16_t dictionary_id;
+};
+
+constexpr size_t COMPRESSED_TUPLE_HEADER_SIZE = sizeof(CompressedTupleHeader);
+static_assert(COMPRESSED_TUPLE_HEADER_SIZE == 4,
+              "CompressedTupleHeader must be 4 bytes");
+
+// Tuples shorter than this are stored as they are
+constexpr uint16_t MIN_COMPRESSIBLE_TUPLE_SIZE = 24;
+
+// Matches reach back at most 64 KB - 1, and a tuple is at most a page
+constexpr size_t MAX_COMPRESSION_DICTIONARY_SIZE = 32 * 1024;
+
+class TupleCompressor {
+ public:
+  // dictionary may be empty; throws std::invalid_argument if it exceeds
+  // MAX_COMPRESSION_DICTIONARY_SIZE
+  explicit TupleCompressor(std::string dictionary = std::string());
+
+  TupleCompressor(const TupleCompressor&) = delete;
+  TupleCompressor& operator=(const TupleCompressor&) = delete;
+
+  // Build a dictionary of at most max_size bytes from representative
+  // tuples: the segments whose 8-byte substrings recur across the most
+  // samples, most valuable last (nearest to the tuple)
+  static std::string TrainDictionary(
+      const std::vector<std::string>& samples,
+      size_t max_size = DEFAULT_COMPRESSION_DICTIONARY_SIZE);
+
+  const std::string& GetDictionary() const { return dictionary_; }
+  // 0 without a dictionary
+  uint16_t GetDictionaryId() const { return dictionary_id_; }
+
+  // Write the stored form of data[0, size) into out (capacity bytes).
+  // Returns its size, or 0 if it would not be smaller than size (the tuple
+  // should then be stored as it is).
+  uint16_t Compress(const char* data, uint16_t size, char* out,
+                    size_t capacity) const;
+
+  // Raw size recorded in a stored form of stored_size bytes (0 if it is
+  // too short to hold the header)
+  static uint16_t RawSize(const char* stored, uint16_t stored_size);
+
+  // Decode a stored form into out (capacity bytes); *size receives the raw
+  // size. Fails on corrupt input, a too-small buffer, or a payload written
+  // with a different dictionary.
+  ErrorCode Decompress(const char* stored, uint16_t stored_size, char* out,
+                       size_t capacity, uint16_t* size) const;
+
+ private:
+  static constexpr size_t HASH_BITS = 12;
+
+  std::string dictionary_;
+  uint16_t dictionary_id_;
+  // Last dictionary position (+ 1, 0 = none) of each 4-byte hash, copied
+  // into every Compress() call's table
+  std::vector<uint16_t> dictionary_table_;
+};
+
+#endif  // STORAGEENGINE_COMPRESSION_H
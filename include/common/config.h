@@ -10,6 +10,119 @@ constexpr size_t PAGE_SIZE = 8192;
 
 constexpr int INVALID_PAGE_ID = 0;
 constexpr slot_id_t INVALID_SLOT_ID = 65535;
-constexpr int INVALID_FRAME_ID = -1;
+constexpr frame_id_t INVALID_FRAME_ID = static_cast<frame_id_t>(-1);
+// Write-ahead log: LSNs are log byte offsets, so 0 is never a record
+constexpr lsn_t INVALID_LSN = 0;
+
+// Buffer pool defaults
+constexpr size_t DEFAULT_BUFFER_POOL_SIZE_MB = 8;  // 1024 frames
+constexpr size_t DEFAULT_LRU_K = 2;
+constexpr size_t DEFAULT_PAGE_TABLE_PARTITIONS = 16;
+
+// Buffer pool frames (FramePool): one mapping per pool, backed by explicit
+// huge pages (MAP_HUGETLB) when it spans at least one and they are
+// available, else by transparent huge pages where the kernel grants them
+constexpr bool BUFFER_POOL_USE_HUGE_PAGES = true;
+constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+// Buffer pool NUMA placement: split frames and free lists per node
+constexpr bool BUFFER_POOL_NUMA_AWARE = true;
+
+// Durability defaults
+constexpr uint32_t DEFAULT_SYNC_INTERVAL_MS = 100;  // DurabilityMode::PERIODIC
+
+// Background flusher: pause between rounds, fraction of frames kept clean,
+// pages written per round, and checkpoint period (0 disables checkpoints)
+constexpr uint32_t DEFAULT_FLUSH_INTERVAL_MS = 50;
+constexpr double DEFAULT_FLUSH_CLEAN_TARGET = 0.5;
+constexpr size_t DEFAULT_FLUSH_MAX_PAGES = 128;  // 1 MB
+constexpr uint32_t DEFAULT_CHECKPOINT_INTERVAL_MS = 30000;
+
+// Write-ahead log: records buffered in memory before a group commit
+// (the buffer grows past this if needed, it is only the initial reservation)
+constexpr size_t DEFAULT_LOG_BUFFER_SIZE = 1024 * 1024;
+
+// Async I/O defaults
+constexpr size_t DEFAULT_IO_QUEUE_DEPTH = 64;
+constexpr size_t DEFAULT_IO_THREAD_POOL_SIZE = 4;
+
+// Striped tablespaces: consecutive pages kept together in one data file
+// before the next extent moves on to the next file (device)
+constexpr uint32_t DEFAULT_TABLESPACE_EXTENT_PAGES = 128;  // 1 MB
+
+// Table scans: pages read ahead (and private ring frames) per scan
+constexpr size_t DEFAULT_SCAN_READ_AHEAD_PAGES = 32;
+// Parallel scans: pages per unit of work handed to (or stolen by) a worker
+constexpr size_t DEFAULT_SCAN_MORSEL_PAGES = 64;
+
+// Bulk load: pages built in memory and written per pwritev run
+constexpr size_t DEFAULT_BULK_LOAD_RUN_PAGES = 128;  // 1 MB
+
+// Backups (PageSnapshot): pages per sequential read of a snapshot's image
+constexpr size_t DEFAULT_SNAPSHOT_READ_PAGES = 64;  // 512 KB
+
+// Forwarding chains: stubs followed before a chain is treated as corrupt
+constexpr int MAX_FORWARDING_HOPS = 10;
+
+// Table fill factor (PageManager::SetFillFactor()): percent of each page
+// inserts may fill, the rest staying free for updates that grow a tuple
+constexpr uint8_t DEFAULT_TABLE_FILL_FACTOR = 100;
+constexpr uint8_t MIN_TABLE_FILL_FACTOR = 10;
+
+// Background maintenance (MaintenanceWorker): pause between rounds, pages
+// compacted per round (each becomes one page write at flush time), CPU time
+// per round, and pages scanned per round for forwarding chains
+constexpr uint32_t DEFAULT_MAINTENANCE_INTERVAL_MS = 1000;
+constexpr size_t DEFAULT_MAINTENANCE_MAX_PAGES = 64;
+constexpr uint32_t DEFAULT_MAINTENANCE_MAX_ROUND_MS = 10;
+constexpr size_t DEFAULT_MAINTENANCE_CHAIN_PAGES = 256;
+
+// B+ tree index: fraction of each node filled by BPlusTree::BulkLoad(), so
+// later inserts do not split every node right away
+constexpr double DEFAULT_INDEX_FILL_FACTOR = 0.9;
+
+// Tuple compression: dictionary size TupleCompressor::TrainDictionary()
+// aims for. Every compressed tuple can reach back into all of it.
+constexpr size_t DEFAULT_COMPRESSION_DICTIONARY_SIZE = 4096;
+
+// Out-of-line values: variable-length values longer than this are moved to
+// overflow pages when the serializer has an OverflowValueStore, keeping
+// tuples to about a quarter page
+constexpr size_t OVERFLOW_VALUE_THRESHOLD = PAGE_SIZE / 4;
+
+// Zone maps (ZoneMap): columns summarized per page, largest bloom filter
+// per column and page, and most EQ/IN values probed in a bloom filter
+constexpr size_t ZONE_MAP_MAX_COLUMNS = 16;
+constexpr size_t ZONE_MAP_MAX_BLOOM_BITS = 4096;
+constexpr size_t ZONE_MAP_MAX_BLOOM_PROBES = 64;
+
+// Versioned tables (VersionClock, VersionedTable): timestamps reserved on
+// disk at a time, restarts of a version chain walk that raced a vacuum
+// before a read gives up, and write lock stripes (writers to tuples in the
+// same stripe are serialized)
+constexpr uint64_t VERSION_CLOCK_RESERVE_BLOCK = 1 << 16;
+constexpr int MAX_VERSION_CHAIN_RETRIES = 8;
+constexpr size_t VERSIONED_TABLE_LOCK_STRIPES = 64;
+
+// Tuple format: most columns per schema (a 1-bit null flag each, in 64-bit
+// words, plus a 2-byte header offset per variable-length column)
+constexpr size_t TUPLE_MAX_FIELDS = 1024;
+
+// Dictionary-encoded columns (ColumnDictionary): most distinct values per
+// column, as many as a 16-bit code can name
+constexpr size_t DICTIONARY_MAX_ENTRIES = 1 << 16;
+// Bytes all dictionaries of a schema may take in their persisted form (a
+// 4-byte record header plus the value per entry), so they always fit in
+// DiskManager's schema area, what is left of the header page slot
+constexpr size_t DICTIONARY_BUDGET_BYTES = PAGE_SIZE - 1024;
+
+// Tuple encode/decode: bytes per Arena block
+constexpr size_t DEFAULT_ARENA_BLOCK_SIZE = 64 * 1024;
+
+// O_DIRECT buffer/offset alignment (covers 512B and 4KB logical blocks)
+constexpr size_t DIRECT_IO_ALIGNMENT = 4096;
+
+// Tracing (Tracer): spans kept per thread before the oldest are overwritten
+constexpr size_t DEFAULT_TRACE_BUFFER_EVENTS = 16384;
 
 #endif  // STORAGEENGINE_CONFIG_H
\ No newline at end of file
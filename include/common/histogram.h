@@ -0,0 +1,79 @@
+#ifndef STORAGEENGINE_HISTOGRAM_H
+#define STORAGEENGINE_HISTOGRAM_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Latency histograms with log-linear (HDR-style) buckets: values below 16
+// are exact, above that every power of two is split into 16 sub-buckets,
+// so a reported percentile is within 1/16 (6.25%) of the true value over
+// the whole uint64_t range with a fixed 8 KB of buckets.
+//
+//   LatencyHistogram       - plain counters, not thread-safe; use one per
+//                            thread and Merge() them
+//   AtomicLatencyHistogram - relaxed atomic counters, safe to Record() from
+//                            any thread; Snapshot() copies it into a
+//                            LatencyHistogram for reporting
+//
+// Usage example:
+//   AtomicLatencyHistogram read_latency;
+//   read_latency.Record(elapsed_ns);                    // any thread
+//   LatencyHistogram snapshot = read_latency.Snapshot();
+//   uint64_t p99 = snapshot.GetPercentile(0.99);
+
+class LatencyHistogram {
+ public:
+  LatencyHistogram();
+
+  void Record(uint64_t nanos);
+  void Merge(const LatencyHistogram& other);
+
+  uint64_t GetCount() const { return count_; }
+  uint64_t GetMax() const { return max_; }
+  double GetSum() const { return sum_; }
+  double GetMean() const;
+
+  // Smallest bucket bound with at least fraction (0-1] of the samples at or
+  // below it (0 if empty)
+  uint64_t GetPercentile(double fraction) const;
+
+  static constexpr size_t SUB_BUCKET_BITS = 4;
+  static constexpr size_t SUB_BUCKETS = size_t{1} << SUB_BUCKET_BITS;
+  static constexpr size_t BUCKET_COUNT = 64 * SUB_BUCKETS;
+
+  static size_t BucketFor(uint64_t nanos);
+  static uint64_t BucketUpperBound(size_t bucket);
+
+ private:
+  friend class AtomicLatencyHistogram;
+
+  std::vector<uint64_t> buckets_;
+  uint64_t count_;
+  uint64_t max_;
+  double sum_;
+};
+
+class AtomicLatencyHistogram {
+ public:
+  AtomicLatencyHistogram();
+
+  AtomicLatencyHistogram(const AtomicLatencyHistogram&) = delete;
+  AtomicLatencyHistogram& operator=(const AtomicLatencyHistogram&) = delete;
+
+  void Record(uint64_t nanos);
+
+  // Copy of the current counts. Samples recorded concurrently may or may
+  // not be included; the copy is never torn within one bucket.
+  LatencyHistogram Snapshot() const;
+
+ private:
+  std::unique_ptr<std::atomic<uint64_t>[]> buckets_;
+  std::atomic<uint64_t> count_{0};
+  std::atomic<uint64_t> max_{0};
+  std::atomic<uint64_t> sum_{0};
+};
+
+#endif  // STORAGEENGINE_HISTOGRAM_H
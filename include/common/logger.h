@@ -1,14 +1,56 @@
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
 #include <fstream>
+#include <memory>
 #include <mutex>
 #include <sstream>
 #include <string>
+#include <thread>
+
+#include "ring_buffer.h"
+
+// Compile-time minimum level: 0 = INFO, 1 = WARNING, 2 = ERROR.
+// Calls below it compile to nothing (operands are not evaluated). Release
+// builds (NDEBUG) drop INFO by default; override with
+// -DSTORAGE_ENGINE_MIN_LOG_LEVEL=<n>.
+#ifndef STORAGE_ENGINE_MIN_LOG_LEVEL
+#ifdef NDEBUG
+#define STORAGE_ENGINE_MIN_LOG_LEVEL 1
+#else
+#define STORAGE_ENGINE_MIN_LOG_LEVEL 0
+#endif
+#endif
 
 namespace storage {
 
 enum class LogLevel { INFO, WARNING, ERROR };
 
+constexpr bool IsLogLevelCompiledIn(LogLevel level) {
+  return static_cast<int>(level) >= STORAGE_ENGINE_MIN_LOG_LEVEL;
+}
+
+// What a producer does when the async ring buffer is full
+enum class LogOverflowPolicy {
+  DROP,  // discard the record and count it (never blocks the caller)
+  BLOCK  // spin until the writer thread frees a slot
+};
+
+constexpr size_t DEFAULT_ASYNC_LOG_CAPACITY = 8192;  // records
+
+// Logger writes "[timestamp] [LEVEL] message" lines to a daily log file.
+//
+// Synchronous mode (default): each record is written and flushed under
+// mutex_ by the calling thread.
+//
+// Asynchronous mode (enableAsync): callers format the record and push it into
+// a lock-free MPSC ring buffer; a background writer drains it to the file in
+// batches with one flush per batch. Producers never take mutex_ or touch the
+// file. flush() waits until everything logged so far is written, and
+// disableAsync() (also run at destruction) drains the buffer before
+// returning, so no accepted record is lost on shutdown.
 class Logger {
  public:
   static Logger& getInstance();
@@ -34,13 +76,58 @@ class Logger {
   // Generic log method
   void log(LogLevel level, const std::string& message);
 
+  // printf-style logging; formats into a stack buffer (no allocation until
+  // the record is written). Call through the LOG_*_F macros.
+  void logf(LogLevel level, const char* format, ...)
+      __attribute__((format(printf, 3, 4)));
+
+  // Switch to the background writer. If already async, only the policy
+  // changes (the capacity is kept).
+  void enableAsync(size_t capacity = DEFAULT_ASYNC_LOG_CAPACITY,
+                   LogOverflowPolicy policy = LogOverflowPolicy::DROP);
+
+  // Drain pending records, stop the writer and return to synchronous mode
+  void disableAsync();
+
+  bool isAsync() const { return async_.load(); }
+
+  // Block until every record accepted so far has been written to the file
+  void flush();
+
+  // Records discarded under LogOverflowPolicy::DROP since startup
+  uint64_t getDroppedCount() const { return droppedCount_.load(); }
+
+  // Lock-free check the macros run before building a message
+  bool isEnabled(LogLevel level) const {
+    return level != LogLevel::INFO ||
+           debugMode_.load(std::memory_order_relaxed);
+  }
+
  private:
   Logger();
   ~Logger();
 
+  struct Record {
+    LogLevel level = LogLevel::INFO;
+    std::string text;  // fully formatted line, newline included
+  };
+
   // Internal log method (assumes mutex is already locked)
   void logInternal(LogLevel level, const std::string& message);
 
+  // Build "[timestamp] [LEVEL] message\n"
+  std::string formatRecord(LogLevel level, const std::string& message) const;
+
+  // Write one formatted line (assumes mutex is already locked)
+  void writeRecord(const Record& record);
+
+  // Push to the ring buffer. Returns false if async mode was switched off
+  // meanwhile and the caller should log synchronously instead.
+  bool enqueueAsync(LogLevel level, const std::string& message);
+
+  // Background writer: drain the ring buffer in batches until stopped
+  void writerLoop();
+
   // Check if we need to rotate log file (new day)
   void rotateLogFileIfNeeded();
 
@@ -61,36 +148,70 @@ class Logger {
 
   std::ofstream logFile_;
   mutable std::mutex mutex_;
-  bool debugMode_;
+  std::atomic<bool> debugMode_;
   std::string logDirectory_;
   std::string currentDate_;
+
+  // Async mode state
+  std::atomic<bool> async_;
+  std::atomic<int> activeProducers_;  // producers inside enqueueAsync()
+  std::atomic<LogOverflowPolicy> overflowPolicy_;
+  std::unique_ptr<MpscRingBuffer<Record>> ring_;
+  std::atomic<uint64_t> enqueuedCount_;
+  std::atomic<uint64_t> writtenCount_;
+  std::atomic<uint64_t> droppedCount_;
+  std::thread writerThread_;
+  std::mutex writerMutex_;  // guards stopWriter_ and the two cvs below
+  std::condition_variable writerCv_;  // wakes the writer
+  std::condition_variable flushCv_;   // signals progress to flush()
+  bool stopWriter_;
+  std::mutex asyncConfigMutex_;  // serializes enable/disableAsync
 };
 
-// Convenience macros for easy logging from anywhere
-#define LOG_INFO(msg) storage::Logger::getInstance().info(msg)
-#define LOG_WARNING(msg) storage::Logger::getInstance().warning(msg)
-#define LOG_ERROR(msg) storage::Logger::getInstance().error(msg)
+// Convenience macros for easy logging from anywhere.
+// The level is checked (at compile time, then at runtime) before the message
+// expression is evaluated, so disabled calls cost one relaxed load.
+#define STORAGE_LOG_ENABLED(level)          \
+  (storage::IsLogLevelCompiledIn(level) && \
+   storage::Logger::getInstance().isEnabled(level))
 
-// Stream-style logging macros
-#define LOG_INFO_STREAM(msg)                        \
-  {                                                 \
-    std::ostringstream oss;                         \
-    oss << msg;                                     \
-    storage::Logger::getInstance().info(oss.str()); \
-  }
+#define STORAGE_LOG(level, msg)                         \
+  do {                                                  \
+    if (STORAGE_LOG_ENABLED(level)) {                   \
+      storage::Logger::getInstance().log(level, (msg)); \
+    }                                                   \
+  } while (0)
 
-#define LOG_WARNING_STREAM(msg)                        \
-  {                                                    \
-    std::ostringstream oss;                            \
-    oss << msg;                                        \
-    storage::Logger::getInstance().warning(oss.str()); \
-  }
+#define LOG_INFO(msg) STORAGE_LOG(storage::LogLevel::INFO, msg)
+#define LOG_WARNING(msg) STORAGE_LOG(storage::LogLevel::WARNING, msg)
+#define LOG_ERROR(msg) STORAGE_LOG(storage::LogLevel::ERROR, msg)
 
-#define LOG_ERROR_STREAM(msg)                        \
-  {                                                  \
-    std::ostringstream oss;                          \
-    oss << msg;                                      \
-    storage::Logger::getInstance().error(oss.str()); \
-  }
+// Stream-style logging macros
+#define STORAGE_LOG_STREAM(level, msg)                                   \
+  do {                                                                   \
+    if (STORAGE_LOG_ENABLED(level)) {                                    \
+      std::ostringstream storage_log_oss_;                               \
+      storage_log_oss_ << msg;                                           \
+      storage::Logger::getInstance().log(level, storage_log_oss_.str()); \
+    }                                                                    \
+  } while (0)
+
+#define LOG_INFO_STREAM(msg) STORAGE_LOG_STREAM(storage::LogLevel::INFO, msg)
+#define LOG_WARNING_STREAM(msg) \
+  STORAGE_LOG_STREAM(storage::LogLevel::WARNING, msg)
+#define LOG_ERROR_STREAM(msg) STORAGE_LOG_STREAM(storage::LogLevel::ERROR, msg)
+
+// printf-style macros for hot paths: LOG_INFO_F("read page %u", page_id)
+#define STORAGE_LOG_F(level, ...)                              \
+  do {                                                         \
+    if (STORAGE_LOG_ENABLED(level)) {                          \
+      storage::Logger::getInstance().logf(level, __VA_ARGS__); \
+    }                                                          \
+  } while (0)
+
+#define LOG_INFO_F(...) STORAGE_LOG_F(storage::LogLevel::INFO, __VA_ARGS__)
+#define LOG_WARNING_F(...) \
+  STORAGE_LOG_F(storage::LogLevel::WARNING, __VA_ARGS__)
+#define LOG_ERROR_F(...) STORAGE_LOG_F(storage::LogLevel::ERROR, __VA_ARGS__)
 
 }  // namespace storage
@@ -0,0 +1,101 @@
+#ifndef STORAGEENGINE_METRICS_H
+#define STORAGEENGINE_METRICS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "histogram.h"
+
+// Runtime metrics of the storage engine.
+//
+// Each component keeps its own counters (relaxed atomics, most on their
+// own cache line or inside an already latched structure) and latency
+// histograms, and exposes them as a plain snapshot struct through
+// GetMetrics(). PageManager::GetMetrics() collects every layer below it
+// into one StorageMetrics; FormatMetrics() renders that as Prometheus
+// text exposition format for scraping.
+//
+// Counters are monotonic since the component was constructed. Snapshots
+// are not atomic across counters: values recorded while a snapshot is
+// taken may be partially included.
+//
+// Usage example:
+//   StorageMetrics metrics = page_manager.GetMetrics();
+//   double hit_rate = metrics.buffer_pool.GetHitRate();
+//   std::cout << FormatMetrics(metrics);
+
+// Event counter padded to its own cache line, so counters bumped by
+// different threads do not false-share
+class alignas(64) MetricCounter {
+ public:
+  void Add(uint64_t n = 1) { value_.fetch_add(n, std::memory_order_relaxed); }
+  uint64_t Get() const { return value_.load(std::memory_order_relaxed); }
+
+ private:
+  std::atomic<uint64_t> value_{0};
+};
+
+struct DiskMetrics {
+  uint64_t page_reads = 0;         // pages read (sync and async)
+  uint64_t page_writes = 0;        // pages written (sync and async)
+  uint64_t syncs = 0;              // fdatasync calls that ran
+  uint64_t checksum_failures = 0;  // pages rejected on read
+  uint64_t checksum_skips = 0;     // reads of known-good pages, unverified
+  uint64_t snapshot_preserved_pages = 0;  // pre-images kept for snapshots
+  LatencyHistogram read_latency;   // ns per page read (async: incl. queue)
+  LatencyHistogram write_latency;  // ns per write call (vectored: batch)
+  LatencyHistogram sync_latency;   // ns per fdatasync
+};
+
+struct BufferPoolNodeMetrics {
+  size_t frames = 0;          // frames placed on the node
+  size_t resident_pages = 0;  // of them holding a page
+};
+
+struct BufferPoolMetrics {
+  uint64_t hits = 0;             // fetches served from a resident frame
+  uint64_t misses = 0;           // fetches that read the page from disk
+  uint64_t clean_evictions = 0;  // victims dropped without a write
+  uint64_t dirty_evictions = 0;  // victims written back before reuse
+  size_t pool_size = 0;          // frames
+  size_t resident_pages = 0;
+  // Frames taken for a miss or new page on / off the caller's NUMA node
+  uint64_t local_frame_acquires = 0;
+  uint64_t remote_frame_acquires = 0;
+  std::vector<BufferPoolNodeMetrics> numa_nodes;  // indexed by node
+
+  // hits / (hits + misses), 0 before the first fetch
+  double GetHitRate() const;
+};
+
+struct FreeSpaceMapMetrics {
+  uint64_t searches = 0;       // tree searches for a page with space
+  uint64_t search_misses = 0;  // searches that found no page
+  uint64_t search_steps = 0;   // node scans (levels + leaf), all searches
+  uint64_t page_loads = 0;     // FSM pages read on demand
+};
+
+struct PageManagerMetrics {
+  uint64_t forwarded_lookups = 0;  // chain walks that followed >= 1 hop
+  uint64_t forwarding_hops = 0;    // hops over all chain walks
+  uint64_t compactions = 0;        // data pages compacted
+  uint64_t moved_updates = 0;      // grown tuples kept on their page
+  uint64_t forwarded_updates = 0;  // grown tuples moved to another page
+};
+
+struct StorageMetrics {
+  DiskMetrics disk;
+  BufferPoolMetrics buffer_pool;
+  FreeSpaceMapMetrics fsm;
+  PageManagerMetrics page_manager;
+};
+
+// Prometheus text exposition format: counters as `storage_<name>_total`,
+// gauges as `storage_<name>`, latency histograms as summaries with p50,
+// p99 and p99.9 quantiles (in nanoseconds) plus _sum and _count
+std::string FormatMetrics(const StorageMetrics& metrics);
+
+#endif  // STORAGEENGINE_METRICS_H
@@ -0,0 +1,28 @@
+#ifndef STORAGEENGINE_NUMA_H
+#define STORAGEENGINE_NUMA_H
+
+#include <cstddef>
+
+// NUMA topology and memory placement, straight from sysfs and the
+// getcpu/mbind system calls (no libnuma). On a single-node machine, or
+// one without NUMA support, everything reports node 0 and binding is a
+// no-op that fails harmlessly.
+//
+// Usage example:
+//   size_t nodes = GetNumaNodeCount();
+//   BindMemoryToNumaNode(buffer, size, 1);  // faulted in on node 1
+//   size_t local = GetCurrentNumaNode();
+
+// Nodes 0..n-1 the system has online (read once; at least 1)
+size_t GetNumaNodeCount();
+
+// Node of the CPU the calling thread runs on right now (0 if unknown)
+size_t GetCurrentNumaNode();
+
+// Ask that pages of [address, address + size) be placed on node when they
+// are first touched (MPOL_PREFERRED: another node when it is full).
+// address must be aligned to the system page size. Returns false if the
+// kernel refused or the node does not exist.
+bool BindMemoryToNumaNode(void* address, size_t size, size_t node);
+
+#endif  // STORAGEENGINE_NUMA_H
@@ -0,0 +1,112 @@
+#ifndef STORAGEENGINE_RING_BUFFER_H
+#define STORAGEENGINE_RING_BUFFER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+namespace storage {
+
+// Bounded lock-free queue for many producers and a single consumer.
+//
+// Each cell carries a sequence number (Vyukov's bounded queue): producers
+// claim a position with one CAS on enqueue_pos_ and publish the cell with a
+// release store; the consumer owns dequeue_pos_ and never contends with
+// producers except through the cell it is reading. TryPush() fails instead
+// of waiting when the queue is full, so callers choose the overflow policy.
+//
+// Capacity is rounded up to a power of two.
+template <typename T>
+class MpscRingBuffer {
+ public:
+  explicit MpscRingBuffer(size_t capacity)
+      : capacity_(RoundUpToPowerOfTwo(capacity)),
+        mask_(capacity_ - 1),
+        cells_(new Cell[capacity_]),
+        enqueue_pos_(0),
+        dequeue_pos_(0) {
+    for (size_t i = 0; i < capacity_; i++) {
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  MpscRingBuffer(const MpscRingBuffer&) = delete;
+  MpscRingBuffer& operator=(const MpscRingBuffer&) = delete;
+
+  // Any thread. Returns false (value untouched) if the queue is full.
+  bool TryPush(T&& value) {
+    size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    Cell* cell;
+    for (;;) {
+      cell = &cells_[pos & mask_];
+      const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+      const intptr_t diff =
+          static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+      if (diff == 0) {
+        if (enqueue_pos_.compare_exchange_weak(pos, pos + 1,
+                                               std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false;  // consumer has not freed this cell yet
+      } else {
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+
+    cell->value = std::move(value);
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer thread only. Returns false if the queue is empty.
+  bool TryPop(T* value) {
+    Cell* cell = &cells_[dequeue_pos_ & mask_];
+    const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+    if (static_cast<intptr_t>(sequence) -
+            static_cast<intptr_t>(dequeue_pos_ + 1) <
+        0) {
+      return false;
+    }
+
+    *value = std::move(cell->value);
+    cell->sequence.store(dequeue_pos_ + capacity_, std::memory_order_release);
+    dequeue_pos_++;
+    return true;
+  }
+
+  size_t Capacity() const { return capacity_; }
+
+ private:
+  struct Cell {
+    std::atomic<size_t> sequence;
+    T value;
+  };
+
+  static size_t RoundUpToPowerOfTwo(size_t capacity) {
+    if (capacity == 0) {
+      throw std::invalid_argument("MpscRingBuffer capacity must be positive");
+    }
+    size_t rounded = 1;
+    while (rounded < capacity) {
+      rounded <<= 1;
+    }
+    return rounded;
+  }
+
+  const size_t capacity_;
+  const size_t mask_;
+  std::unique_ptr<Cell[]> cells_;
+
+  // Separate cache lines: producers hammer enqueue_pos_, the consumer owns
+  // dequeue_pos_
+  alignas(64) std::atomic<size_t> enqueue_pos_;
+  alignas(64) size_t dequeue_pos_;
+};
+
+}  // namespace storage
+
+#endif  // STORAGEENGINE_RING_BUFFER_H
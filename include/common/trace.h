@@ -0,0 +1,146 @@
+#ifndef STORAGEENGINE_TRACE_H
+#define STORAGEENGINE_TRACE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "config.h"
+
+// Sampled hot-path tracing for per-operation latency breakdowns.
+//
+// TRACE_SPAN("name") opens a span that closes at the end of the enclosing
+// scope. Spans nest: the outermost span on a thread is the root, and the
+// sampling decision is taken once per root, so a sampled operation is
+// recorded with every span below it (latch waits, page fetches, disk
+// reads, checksum verification, chain following, compaction) and an
+// unsampled one costs a thread-local check per span.
+//
+// Finished spans go into a per-thread ring buffer of
+// DEFAULT_TRACE_BUFFER_EVENTS entries that overwrites its oldest spans;
+// ExportChromeTrace() merges every buffer into Chrome trace event JSON,
+// which chrome://tracing and Perfetto (ui.perfetto.dev) open directly.
+//
+// Cost control:
+//   - compile time: TRACE_SPAN expands to nothing unless the build defines
+//     STORAGE_ENGINE_ENABLE_TRACING=1 (CMake option ENABLE_TRACING)
+//   - run time: SetSampleRate(0) (the default) records nothing;
+//     SetSampleRate(n) records one root operation in n per thread
+// TraceSpan itself is always available, for code that traces explicitly.
+//
+// Usage example:
+//   Tracer::Instance().SetSampleRate(100);  // 1% of operations
+//   ... run the workload ...
+//   Tracer::Instance().WriteChromeTrace("/tmp/storage.trace.json");
+//
+//   ErrorCode PageManager::GetTuple(...) const {
+//     TRACE_SPAN("PageManager::GetTuple");
+//     ...
+//   }
+
+struct TraceEvent {
+  const char* name;      // static string given to the span
+  uint64_t start_ns;     // since the tracer was created
+  uint64_t duration_ns;
+  uint32_t thread_id;    // small sequential id, in order of first span
+  uint32_t depth;        // 0 for a root span
+};
+
+class Tracer {
+ public:
+  static Tracer& Instance();
+
+  Tracer(const Tracer&) = delete;
+  Tracer& operator=(const Tracer&) = delete;
+
+  // Record one root span in one_in_n per thread (0: tracing off)
+  void SetSampleRate(uint32_t one_in_n);
+  uint32_t GetSampleRate() const {
+    return sample_rate_.load(std::memory_order_relaxed);
+  }
+
+  // Drop every recorded span (buffers stay registered)
+  void Clear();
+
+  // Recorded spans of every thread, ordered by start time
+  std::vector<TraceEvent> Collect() const;
+
+  // Chrome trace event format ("X" complete events, microseconds)
+  std::string ExportChromeTrace() const;
+
+  // ExportChromeTrace() into a file. Returns false if it cannot be written.
+  bool WriteChromeTrace(const std::string& path) const;
+
+ private:
+  friend class TraceSpan;
+
+  // One thread's spans; written by its thread, read by Collect()
+  struct ThreadBuffer {
+    explicit ThreadBuffer(uint32_t id)
+        : thread_id(id), events(DEFAULT_TRACE_BUFFER_EVENTS) {}
+
+    uint32_t thread_id;
+    std::mutex mutex;  // uncontended except while exporting
+    std::vector<TraceEvent> events;
+    size_t next = 0;   // total spans written; slot is next % size
+  };
+
+  // Per-thread nesting and sampling state
+  struct ThreadState {
+    uint32_t depth = 0;
+    bool sampled = false;
+    uint32_t roots = 0;
+    ThreadBuffer* buffer = nullptr;
+  };
+
+  Tracer();
+
+  // This thread's state (thread_local)
+  static ThreadState& State();
+
+  uint64_t NowNanos() const;
+
+  // Sampling decision for a new root span on this thread
+  bool SampleRoot(ThreadState* state);
+
+  void Record(ThreadState* state, const char* name, uint64_t start_ns,
+              uint64_t end_ns);
+
+  std::atomic<uint32_t> sample_rate_{0};
+  uint64_t epoch_ns_;
+
+  // Buffers outlive their threads so late exports still see their spans
+  mutable std::mutex buffers_mutex_;
+  std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+};
+
+// Times the enclosing scope when its root operation is sampled
+class TraceSpan {
+ public:
+  explicit TraceSpan(const char* name);
+  ~TraceSpan();
+
+  TraceSpan(const TraceSpan&) = delete;
+  TraceSpan& operator=(const TraceSpan&) = delete;
+
+ private:
+  const char* name_;
+  uint64_t start_ns_ = 0;
+  bool active_ = false;
+};
+
+#define STORAGE_TRACE_CONCAT_INNER(a, b) a##b
+#define STORAGE_TRACE_CONCAT(a, b) STORAGE_TRACE_CONCAT_INNER(a, b)
+
+#if defined(STORAGE_ENGINE_ENABLE_TRACING) && STORAGE_ENGINE_ENABLE_TRACING
+#define TRACE_SPAN(name) \
+  TraceSpan STORAGE_TRACE_CONCAT(storage_trace_span_, __LINE__)(name)
+#else
+#define TRACE_SPAN(name) static_cast<void>(0)
+#endif
+
+#endif  // STORAGEENGINE_TRACE_H
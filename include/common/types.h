@@ -11,11 +11,15 @@
 #define page_id_t uint32_t
 #define slot_id_t uint16_t
 #define frame_id_t uint32_t
+#define lsn_t uint64_t
 
 enum PageType {
-  DATA_PAGE,   // 0
-  INDEX_PAGE,  // 1
-  FSM_PAGE     // 2
+  DATA_PAGE,      // 0
+  INDEX_PAGE,     // 1
+  FSM_PAGE,       // 2
+  FREE_PAGE,      // 3
+  OVERFLOW_PAGE,  // 4
+  PAX_PAGE        // 5
 };
 
 enum DataType {
@@ -35,15 +39,30 @@ enum DataType {
 struct TupleId {
   page_id_t page_id;
   slot_id_t slot_id;
+
+  bool operator==(const TupleId& other) const {
+    return page_id == other.page_id && slot_id == other.slot_id;
+  }
+  bool operator!=(const TupleId& other) const { return !(*this == other); }
+};
+
+// Serialized tuple bytes passed to batch APIs (not owned)
+struct TupleSlice {
+  const char* data;
+  uint16_t size;
 };
 
 // Custom deleter for aligned memory allocated with std::aligned_alloc
 // Must use std::free() instead of delete because aligned_alloc uses malloc
 // family
 
+// Buffers carved out of a FramePool mapping are not owned (owned = false)
+
 struct AlignedDeleter {
+  bool owned = true;
+
   void operator()(char* ptr) const {
-    if (ptr) {
+    if (ptr && owned) {
       std::free(ptr);
     }
   }
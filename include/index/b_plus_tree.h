@@ -0,0 +1,248 @@
+#ifndef STORAGEENGINE_B_PLUS_TREE_H
+#define STORAGEENGINE_B_PLUS_TREE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+#include "../buffer/buffer_pool_manager.h"
+#include "../buffer/page_guard.h"
+#include "../common/config.h"
+#include "../common/types.h"
+#include "../page/page.h"
+#include "index_key.h"
+#include "index_page.h"
+#include "key_index.h"
+
+// Disk-resident B+ tree mapping fixed-size keys (see IndexKeyEncoder) to
+// TupleIds, stored in PAGE_TYPE_INDEX pages of a buffer pool.
+//
+// Layout: a meta page records the root, height and node capacities; every
+// other page is a node. Leaves hold sorted entries (key followed by the
+// TupleId, big-endian, so a non-unique index orders duplicates by TupleId
+// and every entry is distinct) and link to their right sibling. Inner nodes
+// hold n children and n - 1 separator entries: child i covers entries in
+// [separator i, separator i + 1). Nodes other than the root are kept at
+// least half full; deletes borrow from or merge with a sibling and merged
+// pages go back to the DiskManager's free list.
+//
+// Concurrency (latch crabbing over PageGuard latches):
+//   - Readers take shared latches top-down, releasing the parent once the
+//     child is latched.
+//   - Writers first descend the same way and latch only the leaf
+//     exclusively; if the leaf could split or underflow they restart,
+//     latching exclusively from the root and releasing all ancestors as
+//     soon as a node is safe (cannot split or underflow).
+//   - root_latch_ protects the root page id; it is held exclusively only
+//     while the root itself may change.
+//   - Sibling latches are always taken left to right, the direction scans
+//     move, so merges and scans cannot deadlock.
+// A scan never holds a latch between Next() calls: it copies a leaf's
+// matching entries and re-descends from the last one returned, so it sees
+// each entry committed before it passes at most once.
+//
+// The tree owns every page it allocates, so give it a buffer pool and data
+// file of its own: TableScan and PageManager treat all pages of their file
+// as data pages.
+//
+// Durability: index pages are written through the buffer pool like data
+// pages but are not covered by the write-ahead log. After a crash the index
+// must be rebuilt (BulkLoad() from a table scan).
+//
+// Usage example:
+//   DiskManager index_dm("orders_pk.idx");
+//   BufferPoolManager index_pool(1024, &index_dm);
+//   BPlusTree tree(&index_pool, encoder.GetKeySize(), /*unique=*/true);
+//   tree.Insert(key, tuple_id);
+//   std::vector<TupleId> matches;
+//   tree.Lookup(key, &matches);
+//   BPlusTreeScan scan(&tree, low_key, high_key);
+//   TupleId tid;
+//   while (scan.Next(&tid)) { ... }
+
+#pragma pack(push, 1)
+// Follows the IndexNodeHeader of the meta page
+typedef struct IndexMetaData {
+  uint32_t magic;  // INDEX_META_MAGIC
+  uint16_t key_size;
+  uint8_t unique;
+  uint8_t reserved;
+  uint32_t root_page_id;
+  uint32_t height;  // levels, 1 for a single leaf
+  uint16_t max_leaf_entries;
+  uint16_t max_inner_children;
+} IndexMetaData;
+#pragma pack(pop)
+
+constexpr uint32_t INDEX_META_MAGIC = 0x42505452;  // "BPTR"
+
+// Input to BPlusTree::BulkLoad(); key holds key_size bytes
+struct IndexEntry {
+  std::string key;
+  TupleId tuple_id;
+};
+
+class BPlusTree : public KeyIndex {
+ public:
+  // Create a tree in bpm (meta_page_id == INVALID_PAGE_ID) or open the one
+  // whose meta page is meta_page_id. max_node_entries caps leaf entries and
+  // inner children below what fits in a page (0: fill the page); it is
+  // recorded in the meta page and ignored on open. Throws
+  // std::invalid_argument on bad parameters and std::runtime_error if the
+  // meta page cannot be created, read, or does not match key_size/unique.
+  BPlusTree(BufferPoolManager* bpm, uint16_t key_size, bool unique = false,
+            page_id_t meta_page_id = INVALID_PAGE_ID,
+            size_t max_node_entries = 0);
+
+  BPlusTree(const BPlusTree&) = delete;
+  BPlusTree& operator=(const BPlusTree&) = delete;
+
+  // Where the tree lives in its file; pass it back to reopen the tree
+  page_id_t GetMetaPageId() const { return meta_page_id_; }
+  uint16_t GetKeySize() const override { return key_size_; }
+  bool IsUnique() const override { return unique_; }
+  size_t GetHeight() const;
+  size_t GetMaxLeafEntries() const { return max_leaf_entries_; }
+  size_t GetMaxInnerChildren() const { return max_inner_children_; }
+
+  // Add key -> tuple_id. Fails if the entry exists, or (unique index) if the
+  // key does.
+  ErrorCode Insert(const char* key, TupleId tuple_id) override;
+
+  // Remove key -> tuple_id. Fails if there is no such entry.
+  ErrorCode Delete(const char* key, TupleId tuple_id) override;
+
+  // Append every TupleId stored under key to *tuple_ids (in TupleId order)
+  ErrorCode Lookup(const char* key,
+                   std::vector<TupleId>* tuple_ids) const override;
+
+  // Build the tree bottom-up from entries sorted by key (and by TupleId
+  // among equal keys), filling nodes to fill_factor. Writes each page once
+  // instead of descending per entry. The tree must be empty.
+  ErrorCode BulkLoad(const std::vector<IndexEntry>& entries,
+                     double fill_factor = DEFAULT_INDEX_FILL_FACTOR);
+
+  // Walk the whole tree checking entry order, separator bounds, node
+  // occupancy, uniform leaf depth and the leaf chain. For tests and
+  // debugging; takes no write latches but expects no concurrent writers.
+  ErrorCode CheckIntegrity() const;
+
+ private:
+  friend class BPlusTreeScan;
+
+  BufferPoolManager* bpm_;
+  uint16_t key_size_;
+  bool unique_;
+  size_t entry_size_;    // key + TupleId
+  size_t compare_size_;  // bytes that order entries: key (+ TupleId)
+  size_t max_leaf_entries_;
+  size_t max_inner_children_;
+  page_id_t meta_page_id_;
+
+  // Guards root_page_id_ and height_ (and their copy in the meta page)
+  mutable std::shared_mutex root_latch_;
+  page_id_t root_page_id_;
+  size_t height_;
+
+  enum class WriteOp { INSERT, DELETE };
+
+  // Exclusively latched nodes a pessimistic write may still change, top
+  // first; child_index[i] is the position of nodes[i + 1] in nodes[i]
+  struct WritePath {
+    std::vector<PageGuard> nodes;
+    std::vector<size_t> child_index;
+    bool starts_at_root = false;  // nodes[0] is the root
+  };
+
+  void CreateMetaPage(size_t max_node_entries);
+  void OpenMetaPage();
+  // Persist root_page_id_ and height_ (root_latch_ held exclusively)
+  void WriteMetaPage();
+
+  PageGuard FetchNode(page_id_t page_id, LatchMode mode) const;
+  PageGuard NewNode(IndexNodeKind kind, uint16_t level);
+  void FreeNode(PageGuard* node);
+
+  void MakeEntry(const char* key, TupleId tuple_id, char* entry) const;
+  int CompareEntries(const char* a, const char* b) const;
+
+  // Index of the child of an inner node that covers entry
+  size_t FindChild(const PageGuard& node, const char* entry) const;
+  // First position in a leaf holding an entry >= entry (> entry if strict)
+  size_t FindInLeaf(const PageGuard& node, const char* entry,
+                    bool strict) const;
+
+  size_t MinLeafEntries() const;
+  size_t MinInnerChildren() const;
+
+  // Single-latch-per-level attempt: only the leaf is latched exclusively.
+  // Returns false if the leaf is not safe for op (nothing changed).
+  bool TryOptimisticWrite(WriteOp op, const char* entry, ErrorCode* result);
+  ErrorCode PessimisticWrite(WriteOp op, const char* entry);
+
+  // The node cannot split (insert) or fall below half full (delete)
+  bool IsSafe(const PageGuard& node, WriteOp op, bool is_root) const;
+
+  ErrorCode InsertIntoLeaf(PageGuard* leaf, const char* entry);
+  ErrorCode DeleteFromLeaf(PageGuard* leaf, const char* entry);
+
+  // Insert entry into the full leaf at the bottom of path, splitting it and
+  // as many ancestors as needed (and growing a new root if it splits)
+  ErrorCode InsertWithSplit(WritePath* path, const char* entry);
+
+  // Rebalance the bottom of path after it fell below half full, borrowing
+  // from or merging with a sibling, up the path as parents underflow
+  ErrorCode FixUnderflow(WritePath* path);
+
+  // Fill out with entries from the leaf holding the first entry >= from
+  // (> from if strict; the first leaf when from is null) and the leaves to
+  // its right until one is found, stopping at high_key. *more receives
+  // whether entries may follow.
+  ErrorCode ReadLeafEntries(const char* from, bool strict,
+                            const char* high_key, std::vector<char>* out,
+                            bool* more) const;
+
+  ErrorCode CheckSubtree(page_id_t page_id, size_t level, const char* low,
+                         const char* high, bool is_root,
+                         std::vector<page_id_t>* leaves) const;
+};
+
+// Forward scan over the entries with low_key <= key <= high_key (either
+// bound may be null for an open end), in key order and by TupleId within a
+// key. Holds no latch or pin between calls.
+class BPlusTreeScan {
+ public:
+  BPlusTreeScan(const BPlusTree* tree, const char* low_key,
+                const char* high_key);
+
+  BPlusTreeScan(const BPlusTreeScan&) = delete;
+  BPlusTreeScan& operator=(const BPlusTreeScan&) = delete;
+
+  // Advance to the next entry. Returns false at the end of the range or if
+  // a page cannot be read (GetStatus() tells which).
+  bool Next(TupleId* tuple_id);
+
+  // Key of the entry Next() returned last (GetKeySize() bytes)
+  const char* GetKey() const { return current_.data(); }
+
+  const ErrorCode& GetStatus() const { return status_; }
+
+ private:
+  const BPlusTree* tree_;
+  std::vector<char> low_entry_;  // smallest entry with low_key
+  std::vector<char> high_key_;
+  bool has_low_;
+  bool has_high_;
+
+  std::vector<char> batch_;  // entries copied from the current leaf
+  size_t position_ = 0;      // next entry in batch_
+  std::vector<char> current_;  // entry Next() returned last
+  bool started_ = false;
+  bool more_ = true;
+  ErrorCode status_{0, "BPlusTreeScan: Success"};
+};
+
+#endif  // STORAGEENGINE_B_PLUS_TREE_H
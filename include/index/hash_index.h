@@ -0,0 +1,166 @@
+#ifndef STORAGEENGINE_HASH_INDEX_H
+#define STORAGEENGINE_HASH_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <shared_mutex>
+#include <vector>
+
+#include "../buffer/buffer_pool_manager.h"
+#include "../buffer/page_guard.h"
+#include "../common/types.h"
+#include "../page/page.h"
+#include "index_key.h"
+#include "index_page.h"
+#include "key_index.h"
+
+// Disk-resident extendible hash index mapping fixed-size keys (see
+// IndexKeyEncoder) to TupleIds, stored in PAGE_TYPE_INDEX pages of a buffer
+// pool. For equality lookups only; use a BPlusTree for ranges.
+//
+// Layout: a meta page records the global depth and lists the directory
+// pages; directory pages hold 2^global_depth bucket page ids, indexed by the
+// low bits of the key's hash. Each bucket page has a local depth (bucket
+// pages are shared by 2^(global - local) directory slots), a fingerprint
+// byte per entry (the top byte of the hash) padded to a 16-byte multiple,
+// then the entries (key + TupleId). Entries are unordered.
+//
+// Growth: a full bucket splits in two on the next bit of the hash and only
+// its own entries move; the directory doubles (a copy, no rehash) when the
+// bucket's local depth already equals the global depth. Buckets never
+// merge, so deletes leave their space for later inserts.
+//
+// Lookups: the directory is cached in memory, so a lookup reads exactly one
+// page (the bucket), then compares the probe's fingerprint against the
+// bucket's fingerprint bytes 16 or 32 at a time (SSE2/AVX2/NEON, picked at
+// runtime) and compares full keys only for matching bytes.
+//
+// Limits: entries that hash alike cannot be split apart, so a bucket
+// (HashIndex::GetBucketCapacity() entries) bounds how many TupleIds one key
+// of a non-unique index may have, and the directory stops doubling at
+// HASH_INDEX_MAX_GLOBAL_DEPTH. Insert() fails past either.
+//
+// Concurrency: directory_latch_ guards the in-memory directory. Lookups and
+// writes share it until their bucket is latched (shared or exclusively);
+// a split takes it exclusively, so directory changes wait for in-flight
+// bucket accesses. Lock order is directory, then bucket(s).
+//
+// As with BPlusTree, give the index a buffer pool and file of its own, and
+// rebuild it after a crash: index pages are not covered by the WAL.
+//
+// Usage example:
+//   DiskManager index_dm("users_email.idx");
+//   BufferPoolManager index_pool(1024, &index_dm);
+//   HashIndex index(&index_pool, encoder.GetKeySize(), /*unique=*/true);
+//   index.Insert(key, tuple_id);
+//   std::vector<TupleId> matches;
+//   index.Lookup(key, &matches);
+
+#pragma pack(push, 1)
+// Follows the IndexNodeHeader of the meta page, itself followed by
+// directory_page_count directory page ids
+typedef struct HashIndexMetaData {
+  uint32_t magic;  // HASH_INDEX_META_MAGIC
+  uint16_t key_size;
+  uint8_t unique;
+  uint8_t global_depth;
+  uint16_t bucket_capacity;
+  uint16_t directory_page_count;
+} HashIndexMetaData;
+#pragma pack(pop)
+
+constexpr uint32_t HASH_INDEX_META_MAGIC = 0x48415348;  // "HASH"
+
+// 2^20 buckets; the meta page could list directory pages for 2^21
+constexpr uint8_t HASH_INDEX_MAX_GLOBAL_DEPTH = 20;
+
+class HashIndex : public KeyIndex {
+ public:
+  // Create an index in bpm (meta_page_id == INVALID_PAGE_ID) or open the
+  // one whose meta page is meta_page_id. bucket_capacity caps the entries
+  // per bucket below what fits in a page (0: fill the page); it is recorded
+  // in the meta page and ignored on open. Throws std::invalid_argument on
+  // bad parameters and std::runtime_error if the index cannot be created,
+  // read, or does not match key_size/unique.
+  HashIndex(BufferPoolManager* bpm, uint16_t key_size, bool unique = false,
+            page_id_t meta_page_id = INVALID_PAGE_ID,
+            size_t bucket_capacity = 0);
+
+  HashIndex(const HashIndex&) = delete;
+  HashIndex& operator=(const HashIndex&) = delete;
+
+  // Where the index lives in its file; pass it back to reopen the index
+  page_id_t GetMetaPageId() const { return meta_page_id_; }
+  uint16_t GetKeySize() const override { return key_size_; }
+  bool IsUnique() const override { return unique_; }
+  size_t GetBucketCapacity() const { return bucket_capacity_; }
+  size_t GetGlobalDepth() const;
+  // Distinct bucket pages the directory points at
+  size_t GetBucketCount() const;
+
+  ErrorCode Insert(const char* key, TupleId tuple_id) override;
+  ErrorCode Delete(const char* key, TupleId tuple_id) override;
+  // Appends matches in no particular order
+  ErrorCode Lookup(const char* key,
+                   std::vector<TupleId>* tuple_ids) const override;
+
+  // Check every bucket against the directory: local depths, the slots that
+  // share each bucket, that each entry hashes to its bucket and carries its
+  // fingerprint, and (unique index) that keys are distinct. For tests and
+  // debugging; expects no concurrent writers.
+  ErrorCode CheckIntegrity() const;
+
+ private:
+  BufferPoolManager* bpm_;
+  uint16_t key_size_;
+  bool unique_;
+  size_t entry_size_;    // key + TupleId
+  size_t compare_size_;  // bytes that identify an entry: key (+ TupleId)
+  size_t bucket_capacity_;
+  size_t entries_offset_;  // past the padded fingerprint bytes
+  page_id_t meta_page_id_;
+
+  // Guards directory_, global_depth_, directory_page_ids_ and their copy in
+  // the index pages
+  mutable std::shared_mutex directory_latch_;
+  std::vector<page_id_t> directory_;  // bucket page per hash suffix
+  uint8_t global_depth_;
+  std::vector<page_id_t> directory_page_ids_;
+
+  void CreateIndex(size_t bucket_capacity);
+  void OpenIndex();
+
+  // Persist global_depth_ and directory_page_ids_ to the meta page
+  ErrorCode WriteMetaPage();
+  // Persist the directory slots in [begin, end)
+  ErrorCode WriteDirectory(size_t begin, size_t end);
+  // Persist the listed directory slots (sorted)
+  ErrorCode WriteDirectorySlots(const std::vector<size_t>& slots);
+
+  PageGuard FetchIndexPage(page_id_t page_id, LatchMode mode) const;
+  PageGuard NewIndexPage(IndexNodeKind kind, uint16_t level);
+
+  // The bucket page for hash (directory_latch_ held)
+  page_id_t BucketFor(uint64_t hash) const {
+    return directory_[hash & ((uint64_t{1} << global_depth_) - 1)];
+  }
+
+  uint8_t* Fingerprints(const PageGuard& bucket) const;
+  char* Entry(const PageGuard& bucket, size_t i) const;
+  void MakeEntry(const char* key, TupleId tuple_id, char* entry) const;
+
+  // Position of the first entry at or after from with the fingerprint
+  // whose first compare_size bytes equal entry's, or the bucket size
+  size_t FindEntry(const PageGuard& bucket, const char* entry,
+                   size_t compare_size, uint8_t fingerprint,
+                   size_t from) const;
+
+  // Split the full bucket hash maps to in two (takes directory_latch_
+  // exclusively). Succeeds without a split if the bucket has room by now.
+  ErrorCode SplitBucket(uint64_t hash);
+
+  // Double the directory (directory_latch_ held exclusively)
+  ErrorCode GrowDirectory();
+};
+
+#endif  // STORAGEENGINE_HASH_INDEX_H
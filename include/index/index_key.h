@@ -0,0 +1,65 @@
+#ifndef STORAGEENGINE_INDEX_KEY_H
+#define STORAGEENGINE_INDEX_KEY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../common/types.h"
+#include "../schema/schema.h"
+#include "../tuple/field_value.h"
+#include "../tuple/tuple_accessor.h"
+
+// Largest encoded key an index accepts, so every node holds enough entries
+constexpr uint16_t MAX_INDEX_KEY_SIZE = 256;
+
+// IndexKeyEncoder turns the key columns of a tuple into a fixed-size byte
+// string whose memcmp() order is the columns' value order, which is what
+// BPlusTree compares. Columns are concatenated in the order given:
+//   BOOLEAN, integers  - big-endian with the sign bit flipped
+//   FLOAT, DOUBLE      - IEEE bits, sign bit flipped for positive values and
+//                        all bits flipped for negative ones
+//   CHAR, VARCHAR, TEXT- the bytes, NUL-padded to the column's max size (as
+//                        CHAR(n) is stored), so trailing NULs are not
+//                        significant
+// NULL key values are not indexable; BLOB columns and strings without a
+// max size are rejected.
+//
+// Usage example:
+//   IndexKeyEncoder encoder(schema, {"last_name", "id"});
+//   std::vector<char> key(encoder.GetKeySize());
+//   TupleAccessor tuple(schema, data, size);
+//   if (encoder.Encode(tuple, key.data())) tree.Insert(key.data(), tid);
+class IndexKeyEncoder {
+ public:
+  // Throws std::invalid_argument for an unknown or unsupported column, or
+  // if the key would exceed MAX_INDEX_KEY_SIZE bytes
+  IndexKeyEncoder(const Schema& schema,
+                  const std::vector<std::string>& key_columns);
+
+  uint16_t GetKeySize() const { return key_size_; }
+
+  // Encode the tuple's key into key (GetKeySize() bytes). Returns false if a
+  // key column is NULL or a string is longer than its column.
+  bool Encode(const TupleAccessor& tuple, char* key) const;
+
+  // Same for values given in key column order, for lookups
+  bool Encode(const std::vector<FieldValue>& values, char* key) const;
+
+ private:
+  struct KeyColumn {
+    DataType type;
+    size_t field_index;
+    uint16_t offset;  // in the encoded key
+    uint16_t size;
+  };
+
+  std::vector<KeyColumn> columns_;
+  uint16_t key_size_;
+
+  static bool EncodeString(const KeyColumn& column, const char* data,
+                           size_t size, char* key);
+};
+
+#endif  // STORAGEENGINE_INDEX_KEY_H
@@ -0,0 +1,39 @@
+#ifndef STORAGEENGINE_INDEX_PAGE_H
+#define STORAGEENGINE_INDEX_PAGE_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "../page/page.h"
+
+// Layout shared by the PAGE_TYPE_INDEX pages of every index structure
+// (BPlusTree, HashIndex): the PageHeader, then an IndexNodeHeader saying
+// what kind of node the page is, then the structure's own data.
+
+#pragma pack(push, 1)
+// Follows the PageHeader of every index page
+typedef struct IndexNodeHeader {
+  uint8_t kind;           // IndexNodeKind
+  uint8_t reserved;       // always zero
+  uint16_t level;         // 0 for leaves; local depth of a hash bucket
+  uint16_t size;          // entries (leaf, bucket) or children (inner node)
+  uint16_t reserved2;     // always zero
+  uint32_t next_page_id;  // right sibling (leaves only)
+} IndexNodeHeader;
+#pragma pack(pop)
+
+static_assert(sizeof(IndexNodeHeader) == 12, "IndexNodeHeader is 12 bytes");
+
+enum class IndexNodeKind : uint8_t {
+  META = 1,
+  LEAF = 2,
+  INNER = 3,
+  HASH_DIRECTORY = 4,
+  HASH_BUCKET = 5
+};
+
+// Where an index page's own data starts
+constexpr size_t INDEX_NODE_DATA_OFFSET =
+    sizeof(PageHeader) + sizeof(IndexNodeHeader);
+
+#endif  // STORAGEENGINE_INDEX_PAGE_H
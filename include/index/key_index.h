@@ -0,0 +1,31 @@
+#ifndef STORAGEENGINE_KEY_INDEX_H
+#define STORAGEENGINE_KEY_INDEX_H
+
+#include <cstdint>
+#include <vector>
+
+#include "../common/types.h"
+
+// Equality access shared by the index structures (BPlusTree, HashIndex):
+// fixed-size keys (see IndexKeyEncoder) mapped to TupleIds. TableIndex
+// drives one of these from a table's tuples.
+class KeyIndex {
+ public:
+  virtual ~KeyIndex() = default;
+
+  virtual uint16_t GetKeySize() const = 0;
+  virtual bool IsUnique() const = 0;
+
+  // Add key -> tuple_id. Fails if the entry exists, or (unique index) if the
+  // key does.
+  virtual ErrorCode Insert(const char* key, TupleId tuple_id) = 0;
+
+  // Remove key -> tuple_id. Fails if there is no such entry.
+  virtual ErrorCode Delete(const char* key, TupleId tuple_id) = 0;
+
+  // Append every TupleId stored under key to *tuple_ids
+  virtual ErrorCode Lookup(const char* key,
+                           std::vector<TupleId>* tuple_ids) const = 0;
+};
+
+#endif  // STORAGEENGINE_KEY_INDEX_H
@@ -0,0 +1,71 @@
+#ifndef STORAGEENGINE_TABLE_INDEX_H
+#define STORAGEENGINE_TABLE_INDEX_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../common/types.h"
+#include "../schema/schema.h"
+#include "../tuple/field_value.h"
+#include "index_key.h"
+#include "key_index.h"
+
+// A KeyIndex (BPlusTree, HashIndex) over key columns of a table's tuples.
+// Attach it to the table's PageManager and InsertTuple(s), UpdateTuple and
+// DeleteTuple keep it in step: tuples are indexed under their encoded key
+// columns, and tuples with a NULL (or over-long) key column are not indexed.
+// A unique index makes inserts and updates that would duplicate a key fail.
+//
+// Usage example:
+//   BPlusTree tree(&index_pool, encoder_key_size, /*unique=*/true);
+//   TableIndex by_email(schema, {"email"}, &tree);
+//   pm.AttachIndex(&by_email);
+//   pm.InsertTuple(row, size);
+//   std::vector<TupleId> matches;
+//   by_email.Lookup({FieldValue::VarChar("a@b.c")}, &matches);
+class TableIndex {
+ public:
+  // index is not owned; its key size must match the key columns'. Throws
+  // std::invalid_argument on unknown or unsupported columns or a mismatch.
+  TableIndex(const Schema& schema, const std::vector<std::string>& key_columns,
+             KeyIndex* index);
+
+  TableIndex(const TableIndex&) = delete;
+  TableIndex& operator=(const TableIndex&) = delete;
+
+  KeyIndex* GetIndex() const { return index_; }
+  const IndexKeyEncoder& GetEncoder() const { return encoder_; }
+
+  // Index a tuple just stored at tuple_id
+  ErrorCode AddTuple(const char* tuple, uint16_t size, TupleId tuple_id);
+
+  // Drop the entry of a tuple removed from tuple_id
+  ErrorCode RemoveTuple(const char* tuple, uint16_t size, TupleId tuple_id);
+
+  // First half of an update of tuple_id from old_tuple to new_tuple: index
+  // the new key if it differs from the old one. Nothing changes on failure.
+  ErrorCode BeginUpdate(const char* old_tuple, uint16_t old_size,
+                        const char* new_tuple, uint16_t new_size,
+                        TupleId tuple_id);
+
+  // Second half: drop the key the update left stale (the old one if the
+  // tuple was updated, else the one BeginUpdate() added)
+  void FinishUpdate(const char* old_tuple, uint16_t old_size,
+                    const char* new_tuple, uint16_t new_size,
+                    TupleId tuple_id, bool updated);
+
+  // TupleIds of the tuples whose key columns equal key_values
+  ErrorCode Lookup(const std::vector<FieldValue>& key_values,
+                   std::vector<TupleId>* tuple_ids) const;
+
+ private:
+  Schema schema_;
+  IndexKeyEncoder encoder_;
+  KeyIndex* index_;
+
+  // Encode tuple's key into key; false if the tuple is not indexed
+  bool EncodeKey(const char* tuple, uint16_t size, char* key) const;
+};
+
+#endif  // STORAGEENGINE_TABLE_INDEX_H
@@ -7,28 +7,72 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <shared_mutex>
 
 #include "../common/config.h"
 #include "../common/types.h"
 
 constexpr size_t SLOT_ENTRY_SIZE = 8;
 
+// On-disk page header, format version 4 (see DiskManager::FILE_FORMAT_VERSION).
+// Every field is persisted: the slot statistics are maintained on each
+// update instead of being rebuilt from the slot directory after a read, and
+// the dirty flag lives in the Page object. Older layouts put a 16-bit (v1)
+// or 32-bit (v2) page_id and 24 bytes of runtime fields in a 40-byte header,
+// and v3 ended after the checksum (24 bytes, no page_lsn); such pages are
+// rewritten in this layout when their file is opened.
 typedef struct PageHeader {
-  uint16_t page_id;     // 2
-  uint16_t slot_id;     // 2
-  uint16_t free_start;  // 2
-  uint16_t free_end;    // 2
-  uint16_t slot_count;  // 2
-  uint8_t page_type;    // 1
-  uint8_t flags;        // 1
-  uint32_t checksum;    // 4
-
-  // Runtime metadata (NOT stored on disk)
-  uint16_t deleted_tuple_count_;  // Cached count of deleted slots
-  size_t fragmented_bytes_;       // Cached sum of deleted tuple sizes
-  bool is_dirty_;                 // Has page been modified?
+  uint32_t page_id;              // 4
+  uint16_t slot_id;              // 2
+  uint16_t free_start;           // 2
+  uint16_t free_end;             // 2
+  uint16_t slot_count;           // 2
+  uint8_t page_type;             // 1
+  uint8_t flags;                 // 1
+  uint16_t deleted_tuple_count;  // 2: slots deleted since the last compaction
+  // 2: dead bytes since the last compaction, which CompactPage() reclaims:
+  // deleted tuples, the old copy of a tuple UpdateTuple() moved to
+  // free_start, and tuple bytes a forwarding stub left unused
+  uint16_t fragmented_bytes;
+  uint16_t free_slot_tail;       // 2: free-slot list tail + 1, 0 if empty
+  uint32_t checksum;             // 4
+  uint64_t page_lsn;             // 8: last write-ahead log record applied
 } PageHeader;
 
+static_assert(sizeof(PageHeader) == 32, "PageHeader must be 32 bytes");
+static_assert(PAGE_SIZE <= UINT16_MAX + 1,
+              "Page offsets and statistics are 16-bit");
+
+// Page header flags
+// bit 0: checksum is CRC32C. Pages written before CRC32C have it clear and
+// are verified with the legacy CRC32.
+constexpr uint8_t PAGE_FLAG_CRC32C = 0x01;
+// bit 1: header has page_lsn (format version 4). Set on every write, so an
+// interrupted upgrade can tell converted pages from format 3 ones.
+constexpr uint8_t PAGE_FLAG_PAGE_LSN = 0x02;
+// bit 2: the deleted slots are chained in a free-slot list, oldest deletion
+// first, so InsertTuple() reuses one in O(1). The list is circular: the
+// header's free_slot_tail names the newest, whose link names the oldest;
+// each deleted slot keeps the link in next_ptr[0..1]. Pages without the
+// flag (written before the list, or rebuilt by PageView) get their list
+// built by one directory scan on the first insert.
+constexpr uint8_t PAGE_FLAG_FREE_SLOT_LIST = 0x04;
+
+// Page types (PageHeader::page_type)
+constexpr uint8_t PAGE_TYPE_DATA = DATA_PAGE;    // slotted tuple page
+constexpr uint8_t PAGE_TYPE_INDEX = INDEX_PAGE;  // B+ tree node or meta page
+constexpr uint8_t PAGE_TYPE_FREE = FREE_PAGE;    // on a file's free-page list
+constexpr uint8_t PAGE_TYPE_OVERFLOW = OVERFLOW_PAGE;  // out-of-line value
+constexpr uint8_t PAGE_TYPE_PAX = PAX_PAGE;  // column minipages (PaxPage)
+// Free-list pages are recognized by their type, so no other page may
+// share it
+static_assert(PAGE_TYPE_FREE != PAGE_TYPE_DATA &&
+                  PAGE_TYPE_FREE != PAGE_TYPE_INDEX &&
+                  PAGE_TYPE_FREE != FSM_PAGE &&
+                  PAGE_TYPE_FREE != PAGE_TYPE_OVERFLOW &&
+                  PAGE_TYPE_FREE != PAGE_TYPE_PAX,
+              "Free pages need a page type of their own");
+
 // Slot entry flags
 constexpr uint8_t SLOT_VALID = 0x01;       // bit 0: slot is valid
 constexpr uint8_t SLOT_FORWARDED = 0x02;   // bit 1: slot is forwarded
@@ -39,27 +83,43 @@ typedef struct SlotEntry {
   uint16_t offset;      // 2 bytes: offset of data in page
   uint16_t length;      // 2 bytes: length of data
   uint8_t flags;        // 1 byte: status flags
-  uint8_t next_ptr[3];  // 3 bytes: 24-bit forwarding pointer (16-bit page_id +
-                        // 8-bit slot_id)
+  uint8_t next_ptr[3];  // 3 bytes: legacy 24-bit forwarding pointer (16-bit
+                        // page_id + 8-bit slot_id), only when length == 0
 } SlotEntry;
+
+// Forwarding target of a SLOT_FORWARDED slot, stored in the page data at the
+// slot's offset (the slot's length is FORWARD_STUB_SIZE). Slots forwarded
+// before format version 2 have length 0 and keep their target in next_ptr.
+typedef struct ForwardStub {
+  uint32_t page_id;
+  uint16_t slot_id;
+} ForwardStub;
 #pragma pack(pop)
 
+constexpr uint16_t FORWARD_STUB_SIZE = sizeof(ForwardStub);
+static_assert(FORWARD_STUB_SIZE == 6, "ForwardStub must be exactly 6 bytes");
+
 static_assert(sizeof(SlotEntry) == 8, "SlotEntry must be exactly 8 bytes");
 
 class Page {
  public:
   // Constructor
-  Page() : page_buffer_(nullptr) {}
+  Page() : page_buffer_(nullptr), is_dirty_(false) {}
 
   // Get raw buffer pointer
   char* GetRawBuffer() const { return page_buffer_.get(); }
 
   uint32_t ComputeChecksum() const;
   static std::unique_ptr<Page> CreateNew();
+  // Page over a PAGE_SIZE buffer it does not own (a FramePool frame). The
+  // buffer is left as is: reuse fills it with ResetMemory() or a read.
+  static std::unique_ptr<Page> CreateInFrame(char* buffer);
+  // Zero the buffer and reinitialize an empty page header (frame reuse)
+  void ResetMemory() const;
   bool VerifyChecksum() const;
 
   // Getters
-  uint16_t GetPageId() const;
+  page_id_t GetPageId() const;
   uint16_t GetSlotId() const;
   uint16_t GetFreeStart() const;
   uint16_t GetFreeEnd() const;
@@ -67,12 +127,15 @@ class Page {
   uint8_t GetPageType() const;
   uint8_t GetFlags() const;
   uint32_t GetChecksum() const;
-  bool IsDirty() const;
+  lsn_t GetPageLsn() const;
+  bool IsDirty() const { return is_dirty_; }
+  // Called once the buffer has been written to or freshly read from disk
+  void ClearDirty() const { is_dirty_ = false; }
   uint16_t GetDeletedTupleCount() const;
   size_t GetFragmentedBytes() const;
 
   // Setters
-  void SetPageId(uint16_t page_id) const;
+  void SetPageId(page_id_t page_id) const;
   void SetSlotId(uint16_t slot_id) const;
   void SetFreeStart(uint16_t free_start) const;
   void SetFreeEnd(uint16_t free_end) const;
@@ -80,6 +143,7 @@ class Page {
   void SetPageType(uint8_t page_type) const;
   void SetFlags(uint8_t flags) const;
   void SetChecksum(uint32_t checksum) const;
+  void SetPageLsn(lsn_t page_lsn) const;
 
   // Slot directory methods
   SlotEntry& GetSlotEntry(slot_id_t slot_id) const;
@@ -88,21 +152,50 @@ class Page {
   bool IsSlotValid(slot_id_t slot_id) const;
   bool IsSlotForwarded(slot_id_t slot_id) const;
   TupleId GetForwardingPointer(slot_id_t slot_id) const;
-  void SetForwardingPointer(slot_id_t slot_id, page_id_t page_id,
+  // Write a forwarding stub for the slot, reusing its tuple bytes when they
+  // can hold one and taking FORWARD_STUB_SIZE bytes of free space otherwise.
+  // Returns false (slot untouched) if neither is possible.
+  bool SetForwardingPointer(slot_id_t slot_id, page_id_t page_id,
                             slot_id_t target_slot_id) const;
-  slot_id_t InsertTuple(const char* tuple_data, uint16_t tuple_size) const;
+  bool IsSlotCompressed(slot_id_t slot_id) const;
+  // slot_flags may carry SLOT_COMPRESSED when tuple_data is a
+  // TupleCompressor payload; other bits are ignored. The insert fails
+  // rather than leave less than reserved_space bytes free, unless the page
+  // holds no live tuple (so any tuple still gets a page of its own).
+  slot_id_t InsertTuple(const char* tuple_data, uint16_t tuple_size,
+                        uint8_t slot_flags = 0,
+                        uint16_t reserved_space = 0) const;
   ErrorCode DeleteTuple(slot_id_t slot_id) const;
   void RecomputeFragmentationStats() const;
   bool ShouldCompact() const;
+  // Pack live tuples to the front of the page, keeping slot numbers.
+  // scratch must hold PAGE_SIZE bytes; the no-argument form uses a
+  // per-thread buffer.
   void CompactPage() const;
+  void CompactPage(char* scratch) const;
 
   // Update operations
+  // Sets or clears the slot's SLOT_COMPRESSED bit as slot_flags says
   ErrorCode UpdateTupleInPlace(slot_id_t slot_id, const char* new_data,
-                               uint16_t new_size) const;
+                               uint16_t new_size, uint8_t slot_flags = 0) const;
+  // UpdateTupleInPlace(), except that a tuple outgrowing its bytes moves
+  // into the page's free space (the last tuple before it grows in place)
+  // instead of failing. Returns -8 only when the free space is too small
+  // too; the old bytes count as fragmented until a compaction packs the
+  // page.
+  ErrorCode UpdateTuple(slot_id_t slot_id, const char* new_data,
+                        uint16_t new_size, uint8_t slot_flags = 0) const;
   ErrorCode MarkSlotForwarded(slot_id_t slot_id, page_id_t target_page_id,
                               slot_id_t target_slot_id) const;
   TupleId FollowForwardingChain(slot_id_t slot_id, int max_hops = 10) const;
 
+  // Reader/writer latch protecting the page contents while pinned.
+  // Readers share the page; a writer excludes everyone else.
+  void RLatch() const { latch_.lock_shared(); }
+  void RUnlatch() const { latch_.unlock_shared(); }
+  void WLatch() const { latch_.lock(); }
+  void WUnlatch() const { latch_.unlock(); }
+
  private:
   // RAII-managed pointer to the entire page buffer (8KB)
   // The buffer layout is:
@@ -110,6 +203,10 @@ class Page {
   // AlignedBuffer automatically frees aligned memory in destructor
   AlignedBuffer page_buffer_;
 
+  // Live with the frame, not in the 8KB buffer, so they are never persisted
+  mutable std::shared_mutex latch_;
+  mutable bool is_dirty_;  // Modified since last read or write
+
   // Helper to get header from buffer
   PageHeader* GetHeader() const;
 
@@ -117,15 +214,18 @@ class Page {
   SlotEntry* GetSlotEntryPtr(slot_id_t slot_id) const;
 
   size_t GetAvailableFreeSpace() const;
-  slot_id_t FindDeletedSlot() const;
-};
 
-struct TupleInfo {
-  slot_id_t original_slot_id;
-  uint16_t offset;
-  uint16_t length;
-  uint8_t flags;
-  uint8_t next_ptr[3];
+  // Some slot holds a tuple (or a forwarding stub)
+  bool HasLiveTuple() const;
+
+  // Free-slot list (PAGE_FLAG_FREE_SLOT_LIST). FindDeletedSlot() returns
+  // the oldest deleted slot without taking it, building the list first if
+  // the page has none; TakeFreeSlot() unlinks that slot.
+  slot_id_t FindDeletedSlot() const;
+  void TakeFreeSlot(slot_id_t slot_id) const;
+  // Append a just-deleted slot; no-op while the page has no list
+  void PushFreeSlot(slot_id_t slot_id) const;
+  void BuildFreeSlotList() const;
 };
 
 #endif  // STORAGEENGINE_PAGE_H
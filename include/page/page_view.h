@@ -37,8 +37,34 @@ class PageView {
   uint32_t ComputeChecksum() const;
   bool VerifyChecksum() const;
 
+  // Page building (bulk load). Initialize() formats an empty data page like
+  // Page::ResetMemory() but leaves the checksum to the writer.
+  // AppendTuple() adds a tuple in a new slot without reusing deleted slots
+  // or recomputing the checksum; returns INVALID_SLOT_ID if it does not fit.
+  void Initialize() const;
+  slot_id_t AppendTuple(const char* tuple_data, uint16_t tuple_size) const;
+
+  // Pages of an older file format version (1: 16-bit page_id, 2: 32-bit
+  // page_id, both with a 40-byte header and no persisted slot statistics;
+  // 3: the current header without page_lsn). IsLegacyLayout() is true if the
+  // buffer verifies under that version's checksum and, for version 3, has
+  // not been written since. ConvertFromLegacyLayout() rewrites the header in
+  // the current layout, computes the slot statistics and leaves the
+  // checksum to the writer. Version 1 and 2 data stays in place; version 3
+  // data moves up by 8 bytes, packing the page first if needed. Returns
+  // false (page possibly packed, still in the old layout) if a version 3
+  // page has no 8 bytes to spare.
+  bool IsLegacyLayout(uint32_t format_version) const;
+  bool ConvertFromLegacyLayout(uint32_t format_version) const;
+
+  // Make room in a full version 3 page: move its highest-numbered tuple
+  // longer than a forwarding stub into overflow (a page built with
+  // AppendTuple(), to be written as overflow_page_id) and leave a stub in
+  // its slot. Returns false if there is no such tuple or it does not fit.
+  bool SpillTuple(const PageView& overflow, page_id_t overflow_page_id) const;
+
   // Getters
-  uint16_t GetPageId() const;
+  page_id_t GetPageId() const;
   uint16_t GetSlotId() const;
   uint16_t GetFreeStart() const;
   uint16_t GetFreeEnd() const;
@@ -46,12 +72,12 @@ class PageView {
   uint8_t GetPageType() const;
   uint8_t GetFlags() const;
   uint32_t GetChecksum() const;
+  lsn_t GetPageLsn() const;
   uint16_t GetDeletedSlotCount() const;
-  bool IsDirty() const;
   size_t GetFragmentedBytes() const;
 
   // Setters
-  void SetPageId(uint16_t page_id) const;
+  void SetPageId(page_id_t page_id) const;
   void SetSlotId(uint16_t slot_id) const;
   void SetFreeStart(uint16_t free_start) const;
   void SetFreeEnd(uint16_t free_end) const;
@@ -59,11 +85,14 @@ class PageView {
   void SetPageType(uint8_t page_type) const;
   void SetFlags(uint8_t flags) const;
   void SetChecksum(uint32_t checksum) const;
+  void SetPageLsn(lsn_t page_lsn) const;
   void SetDeletedSlotCount(uint16_t deletedSlotCount);
 
  private:
   char* page_buffer_;  // Non-owning pointer - does NOT manage memory
 
+  bool ConvertFromV3Layout() const;
+
   // Helper to get header from buffer
   PageHeader* GetHeader() const {
     return reinterpret_cast<PageHeader*>(page_buffer_);
@@ -0,0 +1,120 @@
+#ifndef STORAGEENGINE_PAX_PAGE_H
+#define STORAGEENGINE_PAX_PAGE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "../schema/schema.h"
+#include "page.h"
+
+// PAX (Partition Attributes Across) page layout for fixed-length schemas.
+// Instead of whole rows, the page holds one minipage per column, so a scan
+// of a single column reads a dense array of its values:
+//
+//   [PageHeader][PaxPageHeader] (pad to 64)
+//   [row validity bitmap]       (pad to 64)
+//   per column: [null bitmap, nullable columns only][values]  (pad to 64)
+//
+// Bitmaps have one bit per row (bit r of byte r / 8), rounded up to whole
+// 64-bit words. Minipages start on cache-line boundaries and value arrays
+// have capacity entries of the column's fixed size, so they can be consumed
+// with wide loads. Row r of every minipage is the same tuple; the row
+// number is the tuple's slot id. A NULL value's bytes are zero.
+//
+// Rows are exchanged in the regular fixed-length tuple format (see
+// TupleSerializer), so tuples read back from a PAX page decode with
+// TupleAccessor as usual.
+
+#pragma pack(push, 1)
+// Follows the PageHeader of every PAX page
+typedef struct PaxPageHeader {
+  uint16_t capacity;      // rows the page has room for
+  uint16_t row_count;     // valid rows
+  uint16_t high_water;    // rows [0, high_water) have been used
+  uint16_t column_count;
+  uint32_t tuple_size;    // fixed-length tuple size of the schema
+  uint32_t reserved;      // always zero
+} PaxPageHeader;
+#pragma pack(pop)
+
+static_assert(sizeof(PaxPageHeader) == 16, "PaxPageHeader must be 16 bytes");
+
+constexpr size_t PAX_MINIPAGE_ALIGNMENT = 64;
+
+// Where one column lives in a PAX page
+struct PaxColumnLayout {
+  uint32_t tuple_offset;  // field offset in the row format
+  uint32_t size;          // fixed size of a value
+  uint16_t null_offset;   // null bitmap; 0 if the column is not nullable
+  uint16_t data_offset;   // value array
+};
+
+// Page layout for one schema, computed once and shared by its pages
+class PaxLayout {
+ public:
+  // Throws std::invalid_argument if the schema is not finalized, not
+  // fixed-length, or a row does not fit in a page
+  explicit PaxLayout(const Schema& schema);
+
+  uint16_t GetCapacity() const { return capacity_; }
+  uint32_t GetTupleSize() const { return tuple_size_; }
+  uint16_t GetValidOffset() const { return valid_offset_; }
+  const std::vector<PaxColumnLayout>& GetColumns() const { return columns_; }
+
+ private:
+  uint16_t capacity_;
+  uint32_t tuple_size_;
+  uint16_t valid_offset_;
+  std::vector<PaxColumnLayout> columns_;
+
+  // Lay out capacity rows; false if they do not fit in a page
+  bool Place(const Schema& schema, size_t capacity);
+};
+
+// View of a page in PAX layout. Like Page, it does no locking: hold the
+// page latch while using it.
+class PaxPage {
+ public:
+  PaxPage(const Page* page, const PaxLayout& layout)
+      : page_(page), layout_(layout) {}
+
+  // Turn the page into an empty PAX page
+  void Init() const;
+
+  // PAX page laid out as layout says
+  bool IsValidPaxPage() const;
+
+  uint16_t GetRowCount() const { return Header()->row_count; }
+  uint16_t GetHighWater() const { return Header()->high_water; }
+  bool IsFull() const { return GetRowCount() == layout_.GetCapacity(); }
+
+  bool IsRowValid(slot_id_t row) const;
+
+  // Store a tuple (GetTupleSize() bytes) in the first free row; returns it,
+  // or INVALID_SLOT_ID if the page is full
+  slot_id_t InsertRow(const char* tuple) const;
+
+  // Overwrite a valid row
+  void WriteRow(slot_id_t row, const char* tuple) const;
+
+  // Rebuild a valid row's tuple into tuple (GetTupleSize() bytes)
+  void ReadRow(slot_id_t row, char* tuple) const;
+
+  void DeleteRow(slot_id_t row) const;
+
+  // Minipages: the value array of column, its null bitmap (nullptr for a
+  // column that is not nullable) and the row validity bitmap
+  const char* GetColumnData(size_t column) const;
+  const uint8_t* GetNullBitmap(size_t column) const;
+  const uint8_t* GetValidBitmap() const;
+
+ private:
+  const Page* page_;
+  const PaxLayout& layout_;
+
+  PaxPageHeader* Header() const;
+  uint8_t* Bitmap(uint16_t offset) const;
+};
+
+#endif  // STORAGEENGINE_PAX_PAGE_H
@@ -11,7 +11,28 @@
 #include "../common/types.h"
 
 namespace alignment {
-size_t CalculateAlignment(DataType type);
+// constexpr so compile-time layouts (FixedTupleCodec) share these rules
+constexpr size_t CalculateAlignment(DataType type) {
+  switch (type) {
+    case BOOLEAN:
+    case TINYINT:
+    case CHAR:
+    case VARCHAR:
+    case TEXT:
+    case BLOB:
+      return 1;
+    case SMALLINT:
+      return 2;
+    case INTEGER:
+    case FLOAT:
+      return 4;
+    case BIGINT:
+    case DOUBLE:
+      return 8;
+  }
+  return 0;
+}
+
 size_t CalculatePadding(size_t current_offset, size_t alignment);
 size_t AlignOffset(size_t offset, DataType type);
 size_t GetFixedSize(DataType type, size_t size_param);
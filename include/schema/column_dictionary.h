@@ -0,0 +1,112 @@
+#ifndef STORAGEENGINE_COLUMN_DICTIONARY_H
+#define STORAGEENGINE_COLUMN_DICTIONARY_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "../common/config.h"
+
+// Code of a value in a ColumnDictionary
+typedef uint16_t dictionary_code_t;
+
+// Persisted bytes shared by the dictionaries of a schema. A dictionary
+// reserves an entry's bytes before handing out its code, so the codes in
+// tuples never outrun what can be persisted.
+//
+// Thread safety: every method may be called concurrently.
+class DictionaryBudget {
+ public:
+  // Bytes of a persisted entry besides its value: field index and length
+  static constexpr size_t ENTRY_OVERHEAD = 2 * sizeof(uint16_t);
+
+  explicit DictionaryBudget(size_t capacity) : capacity_(capacity), used_(0) {}
+
+  DictionaryBudget(const DictionaryBudget&) = delete;
+  DictionaryBudget& operator=(const DictionaryBudget&) = delete;
+
+  // Take the persisted bytes of an entry holding value; false, taking
+  // nothing, if they do not fit
+  bool Reserve(size_t value_size);
+
+  size_t GetCapacity() const { return capacity_; }
+  size_t GetUsed() const { return used_.load(std::memory_order_relaxed); }
+
+ private:
+  const size_t capacity_;
+  std::atomic<size_t> used_;
+};
+
+// Distinct values of one dictionary-encoded column (see
+// ColumnEncoding::DICTIONARY), numbered in the order they were first
+// encoded: the first value gets code 0, the next new one code 1, and so on.
+// A code never changes or goes away, so tuples only ever store codes and
+// the dictionary only ever grows, up to DICTIONARY_MAX_ENTRIES values and,
+// with a DictionaryBudget, as far as the budget goes. Values longer than
+// UINT16_MAX bytes cannot be persisted and are never added.
+//
+// Decoded values stay at the same address for the dictionary's lifetime,
+// so string views returned by Decode() never dangle while it exists.
+//
+// Thread safety: every method may be called concurrently. Decode() takes
+// no lock; Encode() takes a shared lock unless the value is new.
+//
+// Usage example:
+//   ColumnDictionary dictionary;
+//   dictionary_code_t code;
+//   dictionary.Encode("shipped", &code);  // code 0
+//   dictionary.Decode(code);              // "shipped"
+class ColumnDictionary {
+ public:
+  // budget, if any, may be shared with other dictionaries
+  explicit ColumnDictionary(
+      std::shared_ptr<DictionaryBudget> budget = nullptr);
+  ~ColumnDictionary();
+
+  ColumnDictionary(const ColumnDictionary&) = delete;
+  ColumnDictionary& operator=(const ColumnDictionary&) = delete;
+
+  // Code of value, which is added if new. Returns false, leaving *code
+  // alone, if the value is new and the dictionary is full, its budget spent,
+  // or the value too long.
+  bool Encode(std::string_view value, dictionary_code_t* code);
+
+  // Code of value without adding it; false if it has none
+  bool Lookup(std::string_view value, dictionary_code_t* code) const;
+
+  // Value of code. Throws std::out_of_range for a code not handed out.
+  std::string_view Decode(dictionary_code_t code) const;
+
+  // Values so far; codes are 0 .. GetSize() - 1
+  size_t GetSize() const { return size_.load(std::memory_order_acquire); }
+
+  // Append value as the next code, as Encode() would assign it (used to
+  // rebuild a persisted dictionary). Returns false if value is already
+  // present or could not be encoded.
+  bool Append(std::string_view value);
+
+ private:
+  static constexpr size_t CHUNK_ENTRIES = 256;
+  static constexpr size_t CHUNK_COUNT =
+      (DICTIONARY_MAX_ENTRIES + CHUNK_ENTRIES - 1) / CHUNK_ENTRIES;
+
+  std::shared_ptr<DictionaryBudget> budget_;  // null if unbounded
+  // Serializes additions; readers of codes_ take it shared
+  mutable std::shared_mutex mutex_;
+  // Keys point into the values below
+  std::unordered_map<std::string_view, dictionary_code_t> codes_;
+  // Values by code, in chunks allocated as the dictionary grows
+  std::unique_ptr<std::atomic<std::string*>[]> chunks_;
+  std::atomic<size_t> size_;
+
+  // Add value as code size_; mutex_ must be held exclusively
+  bool AppendLocked(std::string_view value, dictionary_code_t* code);
+};
+
+#endif  // STORAGEENGINE_COLUMN_DICTIONARY_H
@@ -5,11 +5,21 @@
 #ifndef STORAGEENGINE_SCHEMA_H
 #define STORAGEENGINE_SCHEMA_H
 
+#include <memory>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
 #include "../../include/schema/alignment.h"
+#include "column_dictionary.h"
+
+// How a column's values are stored in tuples
+//   PLAIN      - the value itself
+//   DICTIONARY - a 16-bit code into the column's ColumnDictionary, in a
+//                fixed 2-byte field; for CHAR and VARCHAR columns with few
+//                distinct values (status codes, countries, tenants)
+enum class ColumnEncoding { PLAIN, DICTIONARY };
 
 class ColumnDefinition {
  private:
@@ -20,15 +30,18 @@ class ColumnDefinition {
   size_t max_size_;
   size_t offset_;
   uint16_t field_index_;
+  ColumnEncoding encoding_;
 
  public:
   ColumnDefinition(std::string column_name, DataType data_type,
-                   bool is_nullable, size_t size_param) {
+                   bool is_nullable, size_t size_param,
+                   ColumnEncoding encoding = ColumnEncoding::PLAIN) {
     column_name_ = column_name;
     data_type_ = data_type;
     is_nullable_ = is_nullable;
     field_index_ = 0;
     offset_ = 0;
+    encoding_ = encoding;
 
     size_t determined_fixed = alignment::GetFixedSize(data_type_, size_param);
     if (determined_fixed > 0) {
@@ -40,13 +53,13 @@ class ColumnDefinition {
     }
   }
   // Getters and setters for each member
-  std::string GetColumnName();
-  DataType GetDataType();
-  bool GetIsNullable();
-  size_t GetFixedSize();
-  size_t GetMaxSize();
-  size_t GetOffset();
-  uint16_t GetFieldIndex();
+  std::string GetColumnName() const;
+  DataType GetDataType() const;
+  bool GetIsNullable() const;
+  size_t GetFixedSize() const;
+  size_t GetMaxSize() const;
+  size_t GetOffset() const;
+  uint16_t GetFieldIndex() const;
   void SetFieldIndex(uint16_t index);
   void SetOffset(size_t off);
   void SetFixedSize(size_t size);
@@ -54,7 +67,50 @@ class ColumnDefinition {
   void SetIsNullable(bool nullable);
   void SetDataType(DataType dt);
   void SetColumnName(const std::string& name);
-  bool IsFixedLength();
+  ColumnEncoding GetEncoding() const;
+  // Fixed size and max size describe the value, not its stored code
+  bool IsFixedLength() const;
+};
+
+// Serialization plan entry for one column, precomputed by
+// Schema::Finalize(). Serialized tuples are laid out as
+//   [TupleHeader][fixed fields, aligned, column order][variable section]
+// so encoders and decoders can run a flat loop over these entries instead
+// of re-deriving offsets and alignment from ColumnDefinition per tuple.
+//
+// A dictionary-encoded field is a fixed-length field of
+// sizeof(dictionary_code_t) bytes whatever its type, holding the value's
+// code in dictionary; readers decode through it.
+struct FieldLayout {
+  DataType type;
+  uint16_t field_index;  // bit in the null bitmap
+  uint16_t var_index;    // header offset slot (variable-length fields only)
+  uint32_t offset;       // from tuple start (fixed-length fields only)
+  uint32_t size;         // fixed size, 0 for variable-length fields
+  ColumnDictionary* dictionary;  // dictionary-encoded fields only
+
+  bool IsFixedLength() const { return size > 0; }
+  bool IsDictionaryEncoded() const { return dictionary != nullptr; }
+};
+
+// Column resolved once by Schema::ResolveColumn(), for per-row code that
+// would otherwise look the column up by name on every call. It carries
+// everything TupleBuilder and TupleAccessor need (index, type, serialized
+// placement, nullability), so their ColumnHandle overloads neither hash a
+// name nor touch ColumnDefinition. Valid for the schema that resolved it.
+//
+// Usage example:
+//   const ColumnHandle id = schema.ResolveColumn("id");
+//   for (const Row& row : rows) {
+//     builder.Reset();
+//     builder.SetInteger(id, row.id);
+//   }
+struct ColumnHandle {
+  FieldLayout field;
+  bool is_nullable;
+
+  uint16_t GetFieldIndex() const { return field.field_index; }
+  DataType GetDataType() const { return field.type; }
 };
 
 // table_name (string)
@@ -65,7 +121,28 @@ class ColumnDefinition {
 // tuple_size (size_t): Total size for fixed-length tuples
 // null_bitmap_size (size_t): Bytes needed for null bitmap
 // nullable_count (uint16_t): Count of nullable columns
+// var_field_count (uint16_t): Count of variable-length columns
+// var_offsets_start (size_t): Serialized offset of the first variable-length
+//   offset slot, just past the null bitmap (8 bytes per 64 columns)
+// tuple_header_size (size_t): Serialized TupleHeader size for this schema
+// fixed_section_end (size_t): Serialized offset just past the fixed fields
+// layout (vector<FieldLayout>): Serialization plan, one entry per column
+// dictionaries (vector<shared_ptr<ColumnDictionary>>): Per encoded column,
+//   created by Finalize() and shared by copies of the schema
 // column_name_to_index (map): Fast lookup by name
+//
+// Dictionary-encoded columns: tuples store a code per value, so the
+// dictionaries must outlive the table's data. Persist them with
+//   schema.AppendDictionaryEntries(&data);
+//   disk_manager.WriteSchemaData(data);
+// before the pages (or log records) holding new codes become durable, and
+// reload them into the freshly finalized schema when the table is opened:
+//   schema.LoadDictionaries(disk_manager.ReadSchemaData());
+// The persisted form only ever grows at the end, so a write interrupted by
+// a crash leaves the previous version readable.
+// Together the dictionaries of a schema hold at most DICTIONARY_BUDGET_BYTES
+// in that form, which always fits the schema area: once the budget is
+// spent, encoding a new value fails before any tuple gets its code.
 class Schema {
  private:
   std::string table_name_;
@@ -76,6 +153,12 @@ class Schema {
   size_t tuple_size_;
   size_t null_bitmap_size_;
   uint16_t nullable_count_;
+  uint16_t var_field_count_;
+  size_t var_offsets_start_;
+  size_t tuple_header_size_;
+  size_t fixed_section_end_;
+  std::vector<FieldLayout> layout_;
+  std::vector<std::shared_ptr<ColumnDictionary>> dictionaries_;
   std::unordered_map<std::string, uint16_t> column_name_to_index_;
 
  public:
@@ -87,24 +170,58 @@ class Schema {
         is_fixed_length_(true),
         tuple_size_(0),
         null_bitmap_size_(0),
-        nullable_count_(0) {}
+        nullable_count_(0),
+        var_field_count_(0),
+        var_offsets_start_(0),
+        tuple_header_size_(0),
+        fixed_section_end_(0) {}
 
   // AddColumn(name, type, nullable, size);
+  // Throws std::invalid_argument past TUPLE_MAX_FIELDS columns, and for
+  // ColumnEncoding::DICTIONARY on a column that is not CHAR or VARCHAR
   void AddColumn(const std::string& name, DataType type, bool is_nullable,
-                 size_t size_param);
+                 size_t size_param,
+                 ColumnEncoding encoding = ColumnEncoding::PLAIN);
   void Finalize();
   size_t GetAlignment(DataType type) const;
   size_t GetColumnCount() const;                   // returns columns.size()
   ColumnDefinition GetColumn(size_t index) const;  // returns columns[index]
   ColumnDefinition GetColumn(
       const std::string& name) const;  // lookup in map, return column
+  // Copy-free variants for hot paths
+  const ColumnDefinition& GetColumnRef(size_t index) const;
+  const ColumnDefinition* FindColumn(
+      const std::string& name) const;  // nullptr if not found
   bool HasColumn(const std::string& name) const;  // check map.count(name) > 0
+  // Throws std::runtime_error if not finalized or the column is missing
+  ColumnHandle ResolveColumn(const std::string& name) const;
   bool IsFixedLength() const;                     // returns is_fixed_length
   size_t GetTupleSize()
       const;  // returns tuple_size (only valid after Finalize())
   size_t GetNullBitmapSize() const;  // returns null_bitmap_size
   bool IsFinalized() const;          // returns is_finalized
+  uint16_t GetVarFieldCount() const;  // only valid after Finalize()
+  size_t GetVarOffsetsStart() const;  // only valid after Finalize()
+  size_t GetTupleHeaderSize() const;  // only valid after Finalize()
+  size_t GetFixedSectionEnd() const;  // only valid after Finalize()
+  const std::vector<FieldLayout>& GetLayout()
+      const;  // only valid after Finalize()
   uint32_t GetTableId() const;
+
+  // Dictionary of a dictionary-encoded column, nullptr for other columns.
+  // Only valid after Finalize().
+  ColumnDictionary* GetDictionary(size_t field_index) const;
+
+  // Append the dictionary entries missing from data, the persisted form of
+  // the dictionaries (empty at first), so it covers every code handed out
+  // so far. Throws std::runtime_error if data is malformed or was not
+  // produced for this schema.
+  void AppendDictionaryEntries(std::string* data) const;
+
+  // Fill the dictionaries, still empty, from their persisted form. Throws
+  // std::runtime_error if not finalized, if a dictionary already holds
+  // values, or if data is malformed.
+  void LoadDictionaries(std::string_view data);
 };
 
 #endif  // STORAGEENGINE_SCHEMA_H
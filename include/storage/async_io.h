@@ -0,0 +1,92 @@
+#ifndef STORAGEENGINE_ASYNC_IO_H
+#define STORAGEENGINE_ASYNC_IO_H
+
+#include <sys/types.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "../common/config.h"
+#include "../common/types.h"
+
+// Asynchronous positional I/O used by DiskManager for page reads/writes.
+//
+//   AsyncIOEngine::Create(IOEngineType::AUTO)
+//       -> IoUringEngine       (Linux, if the kernel allows io_uring)
+//       -> ThreadPoolIOEngine  (everywhere else / fallback)
+//
+// Submit() queues a batch of requests with one submission and returns one
+// IOHandle per request. Handles are completed from the engine's completion
+// context; Wait() blocks until the request (and its on_complete hook) ran.
+// Buffers must stay valid until the handle completes.
+//
+// Example:
+//   auto engine = AsyncIOEngine::Create();
+//   std::vector<IORequest> batch = {{IOOpType::READ, fd, buf, 8192, off}};
+//   auto handles = engine->Submit(std::move(batch));
+//   ... overlap other work ...
+//   ErrorCode result = handles[0].Wait();
+
+enum class IOOpType { READ, WRITE };
+
+enum class IOEngineType { AUTO, IO_URING, THREAD_POOL };
+
+struct IORequest {
+  IOOpType op;
+  int fd;
+  char* buffer;
+  size_t length;
+  off_t offset;
+
+  // Optional hook run in completion context with the raw result (bytes
+  // transferred or -errno). Its ErrorCode becomes the handle's result.
+  // Default: success iff the full length was transferred.
+  std::function<ErrorCode(ssize_t)> on_complete;
+};
+
+class IOHandle {
+ public:
+  struct State {
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool done = false;
+    ErrorCode result{0, ""};
+  };
+
+  IOHandle() = default;
+  explicit IOHandle(std::shared_ptr<State> state) : state_(std::move(state)) {}
+
+  // Block until the request completes; returns its result
+  ErrorCode Wait() const;
+
+  bool IsReady() const;
+  bool IsValid() const { return state_ != nullptr; }
+
+  // Engine side: run the request's hook and wake waiters
+  static void Complete(State* state, const IORequest& request, ssize_t res);
+
+ private:
+  std::shared_ptr<State> state_;
+};
+
+class AsyncIOEngine {
+ public:
+  virtual ~AsyncIOEngine() = default;
+
+  // Submit a batch; the returned handles are in request order
+  virtual std::vector<IOHandle> Submit(std::vector<IORequest> requests) = 0;
+
+  virtual const char* GetName() const = 0;
+
+  // AUTO prefers io_uring and falls back to the thread pool.
+  // Requesting IO_URING explicitly returns nullptr if it is unavailable.
+  static std::unique_ptr<AsyncIOEngine> Create(
+      IOEngineType type = IOEngineType::AUTO,
+      size_t queue_depth = DEFAULT_IO_QUEUE_DEPTH);
+};
+
+#endif  // STORAGEENGINE_ASYNC_IO_H
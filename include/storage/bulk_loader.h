@@ -0,0 +1,97 @@
+#ifndef STORAGEENGINE_BULK_LOADER_H
+#define STORAGEENGINE_BULK_LOADER_H
+
+#include <cstdint>
+#include <vector>
+
+#include "../common/config.h"
+#include "../common/types.h"
+#include "disk_manager.h"
+#include "free_space_map.h"
+
+// BulkLoader appends tuples to brand-new pages for initial loads, bypassing
+// the buffer pool, the FSM search and deleted-slot reuse:
+//   - page ids are reserved run_pages at a time with
+//     DiskManager::AllocatePages()
+//   - pages are built in a private, block-aligned run buffer through
+//     PageView, filled strictly in order
+//   - a full run is written with DiskManager::WritePages() (vectored
+//     writes, checksums stamped once per page, no per-page sync)
+//   - Finish() writes the last run, issues a single Sync() and seeds the
+//     FSM with every loaded page's free space in one step
+//
+// Pages left empty at the end of the last run are written as valid empty
+// pages and recorded as free in the FSM, so later inserts reuse them.
+//
+// The loader is single-threaded. Pages it writes must not be cached in a
+// buffer pool before Finish() returns; a PageManager sharing the
+// DiskManager only sees them afterwards.
+//
+// Usage example:
+//   DiskManager dm("data.db", DurabilityMode::BATCHED);
+//   FreeSpaceMap fsm("data.fsm");
+//   BulkLoader loader(&dm, &fsm);
+//   for (...) loader.Append(data, size);
+//   loader.Finish();
+//   PageManager pm(&dm, &fsm);
+class BulkLoader {
+ public:
+  // run_pages: pages per write run (and per id reservation)
+  BulkLoader(DiskManager* disk_manager, FreeSpaceMap* fsm,
+             size_t run_pages = DEFAULT_BULK_LOAD_RUN_PAGES);
+
+  // Calls Finish() if the caller did not
+  ~BulkLoader();
+
+  BulkLoader(const BulkLoader&) = delete;
+  BulkLoader& operator=(const BulkLoader&) = delete;
+
+  // Append a tuple to the current page, starting a new page (and run) when
+  // it does not fit. Returns {0, INVALID_SLOT_ID} for invalid tuples, on
+  // write failure, or after Finish().
+  TupleId Append(const char* tuple_data, uint16_t tuple_size);
+
+  // Write the pending run, make the load durable and seed the FSM.
+  // Further calls are no-ops.
+  ErrorCode Finish();
+
+  size_t GetTupleCount() const { return tuple_count_; }
+
+  // Number of pages written or pending in the current run
+  size_t GetPageCount() const;
+
+ private:
+  // Consecutive loaded pages and their free space, for FSM seeding
+  struct Segment {
+    page_id_t first_page_id;
+    std::vector<uint16_t> available_bytes;
+  };
+
+  DiskManager* disk_manager_;
+  FreeSpaceMap* fsm_;
+  size_t run_pages_;
+
+  // run_pages_ pages, DIRECT_IO_ALIGNMENT-aligned
+  AlignedBuffer run_buffer_;
+
+  // First page id of the open run, INVALID_PAGE_ID if none
+  page_id_t run_first_page_id_;
+  size_t current_page_;  // index of the page being filled in the run
+
+  std::vector<Segment> segments_;
+  size_t pages_written_;
+  size_t tuple_count_;
+  bool finished_;
+
+  char* PageBuffer(size_t index) const {
+    return run_buffer_.get() + index * PAGE_SIZE;
+  }
+
+  // Reserve ids for a new run and format its pages
+  void StartRun();
+
+  // Write every page of the open run and record their free space
+  void WriteRun();
+};
+
+#endif  // STORAGEENGINE_BULK_LOADER_H
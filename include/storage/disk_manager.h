@@ -12,52 +12,476 @@
 // Verify data integrity with checksums
 // Thread-safe concurrent reads
 // Error handling and retry logic
+//
+// Durability modes (when WritePage() data reaches stable storage):
+//   IMMEDIATE - fdatasync after every WritePage() (default, safest)
+//   BATCHED   - WritePage() only issues the pwrite; Sync() covers the batch
+//   PERIODIC  - a background thread calls Sync() every sync_interval_ms
+// In every mode a caller may pass defer_sync=true and follow a batch of
+// writes with a single Sync(); the buffer pool does this in FlushAllPages().
+//
+// Asynchronous I/O: ReadPageAsync()/WritePageAsync()/ReadPagesAsync() submit
+// through an AsyncIOEngine (io_uring on Linux, thread pool otherwise) that is
+// created on first use, so many reads can be in flight at once. Completion
+// runs the same post-read processing and checksum check as ReadPage().
+// Async writes are never synced individually: call Sync() once the batch's
+// handles have completed.
+//
+// Checksums: every page read is verified exactly once, here (ReadPage(), or
+// the async completion), so callers such as the buffer pool get pages that
+// are known good and never verify them again. With
+// SetTrustWrittenPages(true), a page whose current image on disk was
+// written by this DiskManager is not verified when read back: its bytes are
+// the ones just checksummed. A write clears the page's mark until it
+// succeeds, and a new DiskManager (after a crash, say) trusts nothing.
+//
+// Direct I/O (opt-in, use_direct_io=true): page reads and writes go through a
+// second O_DIRECT descriptor so pages are cached once, in the buffer pool,
+// instead of also in the kernel page cache. New files use a block-aligned
+// layout (the file header occupies the slot of reserved page 0, page p lives
+// at p * PAGE_SIZE). Direct I/O silently falls back to buffered I/O when:
+//   - the file predates the aligned layout (header sits before page 0)
+//   - the filesystem rejects O_DIRECT (e.g. tmpfs)
+//   - a caller passes a buffer that is not DIRECT_IO_ALIGNMENT-aligned
+//   - the file stores compressed pages (extents are not page-aligned)
+// IsDirectIO() reports whether the O_DIRECT path is active.
+//
+// Compressed pages at rest (opt-in when the file is created,
+// compress_pages=true; an existing file keeps the mode it was created
+// with): WritePage() compresses each 8 KB page with the LZ4 block codec of
+// TupleCompressor and stores it in an extent of 4 KB blocks, so a page that
+// compresses to under 4 KB takes half the space and half the read I/O;
+// other pages are stored as they are. ReadPage() and the async reads
+// decompress into the caller's buffer before the usual checksum check, so
+// the buffer pool only ever sees uncompressed pages. The page id -> extent
+// map lives in "<db_file_name>.pmap" and is made durable by Sync(), after
+// the data it points at (see ExtentMap). Compressed files cannot be opened
+// with OpenReadOnly(): there are no page bytes in the file to map.
+//
+// File format versions (FileHeader::version):
+//   1 - 16-bit page ids in the page header, 24-bit forwarding pointers
+//   2 - 32-bit page ids, 6-byte forwarding stubs
+//   3 - 24-byte page header with persisted slot statistics, so a read is one
+//       pread plus one checksum
+//   4 - 32-byte page header with the page LSN for write-ahead logging
+//       (FILE_FORMAT_VERSION)
+// Opening an older file upgrades it in place: every page header is
+// rewritten in the current layout before the file header is bumped, so an
+// interrupted upgrade simply resumes on the next open. Slots forwarded under
+// version 1 stay readable through their legacy pointer. A version 3 page
+// without 8 spare bytes moves tuples to a new overflow page, leaving
+// forwarding stubs behind, so tuple ids stay valid.
+//
+// Free pages: DeallocatePage() rewrites the page as an empty
+// PAGE_TYPE_FREE page linking to the previous head of the free list, whose
+// head and length live in the file header, and AllocatePage() pops the list
+// before growing the file. TruncateFreeTail() returns free pages at the end
+// of the file to the filesystem. Every list change is durable before the
+// call returns; a crash can leak a free page but never hand out a live one.
+//
+// Striped tablespaces (opt-in when the file is created, a TablespaceLayout
+// naming stripe files, ideally one per device): page ids are dealt in
+// extents of extent_pages over this file and the stripe files (see
+// Tablespace), so one table's I/O spreads over every device. Each file gets
+// its own async engine, so ReadPagesAsync() splits a batch into one
+// submission per device queue; WritePages() issues one pwritev per extent
+// run; Sync() fdatasyncs every file. Like page compression the layout is
+// fixed at creation, and the two cannot be combined. Striped files cannot
+// be opened with OpenReadOnly(): the mapping would only cover file 0.
+//
+// Schema area: WriteSchemaData() keeps up to GetSchemaCapacity() bytes of
+// table metadata (such as Schema's dictionaries) in the file header's page
+// slot, right after the header, which records their offset and length. The
+// bytes past the common prefix with the previous contents are written and
+// synced before the header is, so data that only grows at the end (as
+// dictionaries do) survives a crash in either its old or new form.
+//
+// Online backups: StartSnapshot() fixes a consistent image of the file
+// without stopping writes. While the PageSnapshot lives, every write first
+// copies the page's previous image aside (once per page), so the snapshot
+// can stream the image as of its start into a backup file; pages written
+// since the previous snapshot are tracked for incremental backups. Without
+// an active snapshot a write only sets that page's bit in memory.
+//
+// Read-only mapped mode (OpenReadOnly()): the file is opened O_RDONLY and
+// mmap'ed once, and GetPageView() hands out views straight into the mapping
+// instead of copying each page into a separate buffer. Nothing is read or
+// allocated per page at open, so opening a large file costs one mmap();
+// each page's checksum is verified on its first access and remembered in a
+// bitmap. The mapping covers the file as it was at open. Writes, allocation
+// and format upgrades are rejected in this mode.
 
 #include <unistd.h>
 
 #include <atomic>
+#include <condition_variable>
 #include <cstdint>
+#include <memory>
 #include <mutex>
+#include <shared_mutex>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
 
+#include "../common/config.h"
+#include "../common/metrics.h"
 #include "../common/types.h"
+#include "../page/page_view.h"
+#include "async_io.h"
+#include "extent_map.h"
+#include "page_bitmap.h"
+#include "page_snapshot.h"
+#include "tablespace.h"
+
+enum class DurabilityMode { IMMEDIATE, BATCHED, PERIODIC };
+
+// madvise() hint for a read-only mapping
+//   NORMAL     - kernel default readahead
+//   SEQUENTIAL - aggressive readahead, pages dropped soon after use (scans)
+//   RANDOM     - no readahead (point lookups)
+enum class AccessPattern { NORMAL, SEQUENTIAL, RANDOM };
 
 class DiskManager {
  public:
-  DiskManager(const std::string& db_file_name);
+  DiskManager(const std::string& db_file_name,
+              DurabilityMode durability_mode = DurabilityMode::IMMEDIATE,
+              uint32_t sync_interval_ms = DEFAULT_SYNC_INTERVAL_MS,
+              IOEngineType io_engine_type = IOEngineType::AUTO,
+              bool use_direct_io = false, bool compress_pages = false,
+              const TablespaceLayout& tablespace = {});
   ~DiskManager();
 
+  // Open an existing file in read-only mapped mode. Throws
+  // std::runtime_error if the file cannot be opened or mapped, is not a
+  // database file, or predates FILE_FORMAT_VERSION (upgrading needs write
+  // access).
+  static std::unique_ptr<DiskManager> OpenReadOnly(
+      const std::string& db_file_name,
+      AccessPattern access_pattern = AccessPattern::NORMAL);
+
+  // In read-only mapped mode ReadPage() copies out of the mapping
   void ReadPage(page_id_t page_id, char* page_data) const;
-  void WritePage(page_id_t page_id, const char* page_data) const;
+
+  // defer_sync: skip the IMMEDIATE-mode fdatasync; the caller promises a
+  // Sync() after the batch
+  void WritePage(page_id_t page_id, const char* page_data,
+                 bool defer_sync = false) const;
+
+  // Write pages with consecutive ids starting at first_page_id using
+  // vectored writes (one pwritev per IOV_MAX pages). Checksums are stamped
+  // here, once per page. defer_sync as for WritePage().
+  void WritePages(page_id_t first_page_id,
+                  const std::vector<const char*>& pages,
+                  bool defer_sync = false) const;
+
+  // Asynchronous variants. The buffer must stay valid until the handle
+  // completes; failures are reported through IOHandle::Wait().
+  IOHandle ReadPageAsync(page_id_t page_id, char* page_data) const;
+  IOHandle WritePageAsync(page_id_t page_id, const char* page_data) const;
+
+  // Submit all reads with a single engine submission; handles are in order
+  std::vector<IOHandle> ReadPagesAsync(const std::vector<page_id_t>& page_ids,
+                                       const std::vector<char*>& buffers) const;
+
+  // Name of the async engines in use ("io_uring" or "thread_pool")
+  const char* GetIOEngineName() const;
+
+  // fdatasync if any write is not yet durable. Throws on failure.
+  void Sync() const;
+
+  DurabilityMode GetDurabilityMode() const { return durability_mode_; }
+
+  // True if page I/O bypasses the page cache (requested and supported)
+  bool IsDirectIO() const { return direct_file_descriptor_ >= 0; }
+
+  // Number of fdatasync calls issued for page writes (observability/tests)
+  uint64_t GetSyncCount() const { return sync_count_.load(); }
+
+  // Page I/O counters and read/write/fdatasync latency histograms
+  DiskMetrics GetMetrics() const;
+
+  // Skip the checksum of pages read back after this DiskManager wrote them
+  // (off by default). Set it before sharing the DiskManager with other
+  // threads.
+  void SetTrustWrittenPages(bool trust) { trust_written_pages_ = trust; }
+
+  bool IsReadOnly() const { return read_only_; }
+
+  // True if pages are stored compressed in extents
+  bool IsPageCompressed() const { return extent_map_ != nullptr; }
+
+  // Data files pages are striped over (1 unless created striped)
+  size_t GetStripeCount() const {
+    return tablespace_ != nullptr ? tablespace_->GetFileCount() : 1;
+  }
+
+  // Bytes of the data file holding pages (compressed-page mode), including
+  // extents kept until the next Sync(); 0 otherwise
+  size_t GetStoredPageBytes() const;
+
+  // View of a page inside the read-only mapping, valid until the
+  // DiskManager is destroyed; writing through it faults. The page's checksum
+  // is verified on its first access only. Throws std::invalid_argument for
+  // a page outside the mapped file, std::runtime_error on a checksum
+  // mismatch or if the file was not opened with OpenReadOnly().
+  PageView GetPageView(page_id_t page_id) const;
+
+  // Re-apply an madvise() hint to the whole mapping (read-only mode)
+  void AdviseAccess(AccessPattern access_pattern) const;
+  // Reuses the most recently freed page if there is one
   page_id_t AllocatePage();
+
+  // Reserve count contiguous page ids in one call; returns the first.
+  // Always grows the file; the free list is left alone.
+  page_id_t AllocatePages(size_t count);
+
+  // One past the highest page id allocated so far
+  page_id_t GetNextPageId();
+
+  // Durably record the allocated page ids in the file header, which is
+  // otherwise only rewritten on close. Throws on failure.
+  void SyncFileHeader();
+
+  // Replace the schema area's contents with data, durably. Throws
+  // std::invalid_argument if data exceeds GetSchemaCapacity(),
+  // std::runtime_error on I/O failure.
+  void WriteSchemaData(std::string_view data);
+
+  // Contents of the schema area (empty if never written). Throws on I/O
+  // failure.
+  std::string ReadSchemaData();
+
+  // Most bytes the schema area holds: the rest of the header's page slot,
+  // none for files in the legacy unaligned layout
+  size_t GetSchemaCapacity() const;
+
+  // Start an online snapshot of the file for a backup (see PageSnapshot),
+  // which ends when the returned object is destroyed. Waits for
+  // synchronous writes in progress. The snapshot's epoch is recorded in
+  // the file header, so epochs keep growing across reopens. Throws
+  // std::runtime_error if the file is not open or read-only, a snapshot is
+  // already active, or the header or side file cannot be written.
+  std::unique_ptr<PageSnapshot> StartSnapshot();
+
+  // Put page_id on the free list for AllocatePage() to hand out again. The
+  // caller guarantees nothing still refers to the page: no tuple, no buffer
+  // pool frame, no write-ahead log record after the last checkpoint.
+  // Freeing a page that is already free is ignored. Throws on I/O failure.
   void DeallocatePage(page_id_t page_id);
+
+  // Number of pages on the free list
+  uint32_t GetFreePageCount();
+
+  // Drop free pages at the end of the file: lowers the next page id past
+  // them, relinks the remaining free pages in ascending order (so reuse
+  // fills the front of the file) and shrinks the file. Allocation waits
+  // while this runs; reads do not. Returns the number of pages released.
+  // Throws on I/O failure.
+  size_t TruncateFreeTail();
+
   bool IsOpen();
 
+  // FileHeader::version of the open file (FILE_FORMAT_VERSION once upgraded)
+  uint32_t GetFormatVersion() const { return file_header_.version; }
+
+  static constexpr uint32_t FILE_FORMAT_VERSION = 4;
+
   enum ErrorCode { ERROR_ALREADY_OPEN, ERROR_INVALID_FILENAME };
 
  private:
   std::string db_file_name_;
   int db_file_descriptor_;
+  int direct_file_descriptor_;  // O_DIRECT fd for page I/O, -1 when unused
+  bool use_direct_io_;
+  bool compress_pages_;  // requested for a new file
+  TablespaceLayout tablespace_layout_;  // requested for a new file
   page_id_t next_page_id_;
   std::mutex metadata_mutex_;  // Only for metadata operations (not I/O)
   std::atomic<bool> is_open_;
 
+  DurabilityMode durability_mode_;
+  uint32_t sync_interval_ms_;
+  mutable std::atomic<bool> has_unsynced_writes_;
+  mutable std::atomic<uint64_t> sync_count_;
+  mutable std::mutex sync_mutex_;  // Serializes fdatasync calls
+
+  // Metrics (GetMetrics())
+  mutable MetricCounter page_reads_;
+  mutable MetricCounter page_writes_;
+  mutable MetricCounter checksum_failures_;
+  mutable MetricCounter checksum_skips_;
+  mutable AtomicLatencyHistogram read_latency_;
+  mutable AtomicLatencyHistogram write_latency_;
+  mutable AtomicLatencyHistogram sync_latency_;
+
+  // PERIODIC mode background syncer
+  std::thread sync_thread_;
+  std::mutex sync_thread_mutex_;
+  std::condition_variable sync_thread_cv_;
+  bool stop_sync_thread_;
+
+  // Async engines, one per data file (device queue), created on first
+  // async call
+  IOEngineType io_engine_type_;
+  mutable std::vector<std::unique_ptr<AsyncIOEngine>> io_engines_;
+  mutable std::once_flag io_engine_once_;
+
+  // Read-only mapped mode: the mapping
+  bool read_only_ = false;
+  char* mapping_ = nullptr;
+  size_t mapping_size_ = 0;
+
+  // Pages whose image on disk needs no checksum check when read: verified
+  // once (read-only mapped mode, where it never changes) or written by
+  // this DiskManager (with trust_written_pages_)
+  mutable PageBitmap verified_pages_;
+  bool trust_written_pages_ = false;
+
+  // Online snapshots: writers hold snapshot_mutex_ shared from preserving
+  // a page's image until their write is issued, StartSnapshot() and
+  // ~PageSnapshot() exclusively. changed_pages_ collects the pages written
+  // since the last StartSnapshot().
+  friend class PageSnapshot;
+  mutable std::shared_mutex snapshot_mutex_;
+  PageSnapshot* snapshot_ = nullptr;
+  std::unique_ptr<PageBitmap> changed_pages_ =
+      std::make_unique<PageBitmap>();
+  // Epoch of the last snapshot started since the file was opened, 0: none
+  uint64_t tracked_epoch_ = 0;
+  mutable MetricCounter snapshot_preserved_pages_;
+
+  // Compressed-page mode: where each page's extent is
+  std::unique_ptr<ExtentMap> extent_map_;
+
+  // Striped mode: which file and offset each page has
+  std::unique_ptr<Tablespace> tablespace_;
+
+  // Used by OpenReadOnly()
+  DiskManager(const std::string& db_file_name, AccessPattern access_pattern);
+
   ErrorCode OpenDBFile();
   void CloseDBFile();
+
+  // Open and map the file for OpenReadOnly(). Throws on failure.
+  void OpenMappedFile(AccessPattern access_pattern);
+
+  // Throws std::runtime_error in read-only mapped mode
+  void RequireWritable() const;
+
+  // Write file_header_ with the current next page id and fdatasync.
+  // metadata_mutex_ must be held. Throws on failure.
+  void WriteFileHeaderLocked();
+
+  // ReadSchemaData() with metadata_mutex_ held
+  std::string ReadSchemaDataLocked() const;
+
+  // Free-list pages: write page_id as a free page linking to next_free /
+  // read a free page's link. ReadFreeLink() returns INVALID_PAGE_ID if the
+  // page cannot be read or is not a free page (*is_free set accordingly).
+  void WriteFreePage(page_id_t page_id, page_id_t next_free);
+  page_id_t ReadFreeLink(page_id_t page_id, bool* is_free) const;
+
+  // Rewrite older page headers in the current layout, then record
+  // FILE_FORMAT_VERSION in the file header. Called from OpenDBFile().
+  void UpgradeFormat();
+
+  // Make room for a version 3 page's header to grow by spilling tuples to a
+  // fresh overflow page, written (with the new next_page_id) before the
+  // caller rewrites the page. Throws if the page cannot be converted.
+  void SpillForUpgrade(page_id_t page_id, char* page_data);
+
+  // Open the O_DIRECT descriptor if the layout and filesystem allow it.
+  // Leaves direct_file_descriptor_ at -1 (buffered I/O) otherwise.
+  void OpenDirectIO();
+
+  // Data file holding page_id (always 0 unless striped)
+  size_t PageFile(page_id_t page_id) const {
+    return tablespace_ != nullptr ? tablespace_->FileOf(page_id) : 0;
+  }
+
+  // Descriptor of a data file for a page transfer: the O_DIRECT one when
+  // active and the buffer is suitably aligned, the buffered one otherwise
+  int PageFileDescriptor(size_t file, const char* page_data) const;
+  int BufferedFileDescriptor(size_t file) const;
+  void SyncThreadLoop();
+  void StopSyncThread();
+
+  // Engine queueing I/O for data file file
+  AsyncIOEngine* GetIOEngine(size_t file = 0) const;
+
+  // Verify the checksum of a page just read from disk, unless
+  // verified_pages_ vouches for it. Throws on mismatch.
+  void FinishPageRead(page_id_t page_id, char* page_data) const;
+
+  // Around every page write: the page's image is unknown from the start of
+  // the write until it succeeded
+  void BeginPageWrite(page_id_t page_id) const {
+    verified_pages_.Clear(page_id);
+  }
+  void FinishPageWrite(page_id_t page_id) const {
+    if (trust_written_pages_) {
+      verified_pages_.Set(page_id);
+    }
+  }
+
+  // Before every write to page_id, with snapshot_mutex_ held shared: note
+  // the change and let an active snapshot preserve the page's image
+  void NotePageChange(page_id_t page_id) const;
+
+  // Raw images of count consecutive pages from first_page_id, unverified,
+  // using as few reads as the layout allows. Pages never written read as
+  // zeros. Throws std::runtime_error on I/O failure.
+  void ReadPageImages(page_id_t first_page_id, size_t count,
+                      char* buffer) const;
+
+  // Record the checksum algorithm and stamp the checksum before a write
+  void PreparePageWrite(const char* page_data) const;
+
+  // Offset of page_id within PageFile(page_id)
+  off_t PageOffset(page_id_t page_id) const;
+
+  IORequest MakeReadRequest(page_id_t page_id, char* page_data) const;
+
+  // Compressed-page mode. ReadExtent() returns false if the page was never
+  // written or cannot be read or decompressed; WriteExtent() throws.
+  bool ReadExtent(page_id_t page_id, char* page_data) const;
+  void WriteExtent(page_id_t page_id, const char* page_data) const;
+  IORequest MakeExtentReadRequest(page_id_t page_id, char* page_data) const;
+  IOHandle WriteExtentAsync(page_id_t page_id, const char* page_data) const;
+
+  // fdatasync the data file, then persist the extent map's changes made
+  // before the sync. Throws on failure.
+  void SyncDataLocked() const;
   uint32_t ComputeChecksum(const char* data, size_t length);
 
   struct FileHeader {
-    char magic_number[4];     // "STOR"
-    uint32_t version;         // File format version
-    page_id_t next_page_id;   // Next available page ID
-    uint32_t reserved[125];   // Padding to make header 512 bytes
-    uint32_t table_id_;       // Unique table identifier
-    uint32_t page_size_;      // Size of each page in bytes always 8192
-    uint32_t page_count_;     // Total number of pages in the file
-    char table_name_[64];     // Name of the table null terminated
-    uint32_t schema_length_;  // Length of the schema definition
-    uint32_t schema_offset_;  // Offset to the schema definition
+    char magic_number[4];      // "STOR"
+    uint32_t version;          // File format version
+    page_id_t next_page_id;    // Next available page ID
+    uint32_t flags;            // FILE_FLAG_* bits
+    page_id_t free_list_head;  // First free page (INVALID_PAGE_ID: none)
+    uint32_t free_page_count;  // Length of the free list
+    uint32_t stripe_count;     // Data files (FILE_FLAG_STRIPED_PAGES)
+    uint32_t stripe_extent_pages;  // Pages per striping extent
+    uint64_t file_id;          // Random, set at creation (0: older file)
+    uint64_t snapshot_epoch;   // Latest StartSnapshot() (image: its own)
+    uint32_t reserved[116];    // Padding to make header 512 bytes
+    uint32_t table_id_;        // Unique table identifier
+    uint32_t page_size_;       // Size of each page in bytes always 8192
+    uint32_t page_count_;      // Total number of pages in the file
+    char table_name_[64];      // Name of the table null terminated
+    uint32_t schema_length_;   // Length of the schema definition
+    uint32_t schema_offset_;   // Offset to the schema definition
   } file_header_;
+
+  // Pages start at page_id * PAGE_SIZE; header lives in page 0's slot.
+  // Files without this flag keep pages right after the header.
+  static constexpr uint32_t FILE_FLAG_ALIGNED_PAGES = 0x1;
+  // Pages live in extents listed by the extent map
+  static constexpr uint32_t FILE_FLAG_COMPRESSED_PAGES = 0x2;
+  // Pages are striped over the files listed in "<db_file_name>.tsp"
+  static constexpr uint32_t FILE_FLAG_STRIPED_PAGES = 0x4;
 };
 
 #endif  // STORAGEENGINE_DISK_MANAGER_H
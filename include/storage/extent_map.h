@@ -0,0 +1,136 @@
+#ifndef STORAGEENGINE_EXTENT_MAP_H
+#define STORAGEENGINE_EXTENT_MAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../common/config.h"
+#include "../common/file_handle.h"
+#include "../common/types.h"
+
+// ExtentMap places the pages of a compressed-page DiskManager file: each
+// page is stored in an extent of whole PAGE_EXTENT_BLOCK_SIZE blocks
+// (one or two for 8 KB pages), wherever the map says, and the map records
+// page id -> extent in a sidecar file. The data file's first page-sized
+// slot still holds the DiskManager file header.
+//
+// Map file layout: 8-byte entries, entry p describing page p; entry 0 is the
+// header (magic, version). Pages never written have an all-zero entry.
+//
+// Copy-on-write with deferred reuse: a page whose new version needs the
+// same number of blocks is rewritten in place, like an uncompressed page.
+// One whose extent grows or shrinks moves to newly reserved blocks, and its
+// old extent is only handed out again once a Persist() has made the map
+// that no longer references it durable. Until then a crash leaves the
+// durable map pointing at intact (if stale) data, never at blocks another
+// page has overwritten.
+//
+// Sync protocol (DiskManager::Sync()):
+//   changes = map.TakeChanges();
+//   fdatasync(data file);          // the extents changes point at
+//   map.Persist(std::move(changes));
+//
+// Thread safety: every method may be called concurrently; Persist() calls
+// must be serialized by the caller.
+
+constexpr size_t PAGE_EXTENT_BLOCK_SIZE = 4096;
+constexpr uint16_t PAGE_EXTENT_MAX_BLOCKS =
+    static_cast<uint16_t>(PAGE_SIZE / PAGE_EXTENT_BLOCK_SIZE);
+static_assert(PAGE_SIZE % PAGE_EXTENT_BLOCK_SIZE == 0,
+              "Pages must be a whole number of extent blocks");
+
+#pragma pack(push, 1)
+typedef struct PageExtent {
+  uint32_t first_block;  // block index in the data file (offset / 4096)
+  uint16_t block_count;  // 0: page never written
+  uint16_t reserved;
+
+  bool operator==(const PageExtent& other) const {
+    return first_block == other.first_block &&
+           block_count == other.block_count;
+  }
+  bool operator!=(const PageExtent& other) const { return !(*this == other); }
+} PageExtent;
+#pragma pack(pop)
+
+static_assert(sizeof(PageExtent) == 8, "PageExtent must be 8 bytes");
+
+constexpr uint32_t EXTENT_MAP_MAGIC = 0x50414D50;  // "PMAP"
+constexpr uint16_t EXTENT_MAP_VERSION = 1;
+
+class ExtentMap {
+ public:
+  // Changes not yet durable, as taken by TakeChanges()
+  struct Changes {
+    std::vector<std::pair<page_id_t, PageExtent>> entries;
+    std::vector<PageExtent> freed;  // reusable once entries are durable
+  };
+
+  // Map in map_file_name for the data file open on data_fd. create starts
+  // an empty map (replacing any old one); otherwise the map is loaded and
+  // checked. Throws std::runtime_error if the map cannot be created or
+  // read, or is damaged (bad header, overlapping or out-of-range extents).
+  ExtentMap(const std::string& map_file_name, int data_fd, bool create);
+
+  ExtentMap(const ExtentMap&) = delete;
+  ExtentMap& operator=(const ExtentMap&) = delete;
+
+  PageExtent Get(page_id_t page_id) const;
+
+  // Extent to write a block_count-block version of page_id into: its
+  // current extent if that has the size, else freshly reserved blocks at
+  // the first gap that fits or the end of the file
+  PageExtent Reserve(page_id_t page_id, uint16_t block_count);
+
+  // The extent from Reserve() now holds the page. A different previous
+  // extent is freed at the next Persist().
+  void Publish(page_id_t page_id, PageExtent extent);
+
+  // The write into a reserved extent failed: unreserve it (no-op for the
+  // page's current extent)
+  void Cancel(page_id_t page_id, PageExtent extent);
+
+  // Forget pages >= first_page_id (their extents are freed at the next
+  // Persist())
+  void Release(page_id_t first_page_id);
+
+  Changes TakeChanges();
+
+  // Queue taken changes again, e.g. when the data sync before them failed
+  void Restore(Changes changes);
+
+  // Write and fdatasync the taken entries, then make the freed extents
+  // reusable and trim free blocks off the end of the data file. On failure
+  // the changes are queued again and std::runtime_error is thrown.
+  void Persist(Changes changes);
+
+  // Blocks holding pages (including extents not yet reusable)
+  size_t GetUsedBlockCount() const;
+
+ private:
+  std::string map_file_name_;
+  FileHandle map_file_;
+  int data_fd_;
+
+  mutable std::mutex mutex_;
+  std::vector<PageExtent> extents_;  // by page id
+  std::vector<bool> used_;           // by block
+  size_t used_blocks_;
+  size_t search_from_;  // next-fit cursor
+  size_t file_blocks_;  // blocks the data file spans
+  std::vector<page_id_t> dirty_;
+  std::vector<PageExtent> pending_free_;
+
+  void Load();
+  void RestoreLocked(const Changes& changes);
+
+  // Reserve block_count free blocks (mutex_ held)
+  PageExtent AllocateLocked(uint16_t block_count);
+  void MarkLocked(PageExtent extent, bool used);
+};
+
+#endif  // STORAGEENGINE_EXTENT_MAP_H
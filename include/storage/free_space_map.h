@@ -4,10 +4,10 @@
 #include <cstdint>
 #include <mutex>
 #include <string>
-#include <unordered_set>
 #include <vector>
 
 #include "../common/config.h"
+#include "../common/metrics.h"
 #include "../common/types.h"
 
 // Free Space Map (FSM) tracks available space in data pages for efficient
@@ -15,17 +15,40 @@
 // encoding where each page's free space is represented as a single byte
 // value (0-255), allowing for compact storage and fast lookups.
 //
-// FSM Page Format (8192 bytes):
-//   - Magic number: 0x46534D00 (4 bytes)
+// FSM Page Format (8192 bytes, FSM page k covers data pages
+// [k * 8184, (k + 1) * 8184)):
+//   - Magic number: 0x46534D01 (4 bytes)
 //   - Page count: number of data pages tracked (4 bytes)
 //   - Category bytes: one byte per data page (8184 bytes)
+// Only FSM pages modified since the last Flush() are rewritten. Files in
+// the original single-blob format (magic 0x46534D00) are still loaded and
+// are converted to the paged format on the next Flush().
 //
 // Category encoding: (available_bytes * 255) / 8192
-//   - 0 = no free space
+//   - 0 = no free space (also the value of pages never allocated)
 //   - 255 = completely empty page
 //
-// For tables with >8184 pages, the FSM uses a hierarchical structure
-// where multiple FSM pages are linked together.
+// Search: an in-memory max-tree sits above the category bytes. Each node
+// holds the max category of its FSM_TREE_FANOUT children, so
+// FindPageWithSpace() descends from the root to the first qualifying page in
+// O(fanout * log N) and UpdatePageFreeSpace() bubbles changes upward. Upper
+// levels are rebuilt from the leaves on load and never persisted.
+//
+// Insert streams: with SetInsertStreams(n > 1), every inserting thread is
+// mapped to one of n streams and FindInsertTarget() keeps returning that
+// stream's current target page while it still fits the request. A target is
+// claimed, i.e. hidden from the tree so other streams' searches skip it, and
+// handed back (made visible again with its real category) as soon as it can
+// no longer satisfy its stream. Concurrent inserters therefore latch
+// different pages instead of all converging on the first qualifying one.
+// Claims live only in memory; the persisted categories are never affected.
+//
+// Lazy loading: Initialize() reads only the file header, so opening costs
+// the same for any table size. Each FSM page starts unloaded, its leaves
+// holding MAX_CATEGORY placeholders that steer searches into it; the page
+// is read on the first access needing its real categories (GetCategory(),
+// an update, or a search ending on one of its leaves, which then resumes).
+// Unloaded pages are never dirty, so a flush never writes placeholders.
 
 // void CreateTable(string table_name, Schema schema) {
 //  string data_file = table_name + ".db";
@@ -53,11 +76,35 @@ class FreeSpaceMap {
   // available_bytes: number of free bytes in the page (0-8192)
   void UpdatePageFreeSpace(page_id_t page_id, uint16_t available_bytes);
 
+  // Record the free space of consecutive pages first_page_id,
+  // first_page_id + 1, ... in one step (bulk load)
+  void UpdatePagesFreeSpace(page_id_t first_page_id,
+                            const std::vector<uint16_t>& available_bytes);
+
   // Find a page with at least the required amount of free space
   // required_bytes: minimum free space needed
   // Returns: page_id of suitable page, or INVALID_PAGE_ID if none found
   page_id_t FindPageWithSpace(uint16_t required_bytes);
 
+  // Map inserting threads onto num_streams insert streams, each with its
+  // own target page. 0 or 1 turns streams off (the default); changing the
+  // count releases every claimed target.
+  void SetInsertStreams(size_t num_streams);
+
+  // Number of insert streams (0 when streams are off)
+  size_t GetInsertStreamCount() const;
+
+  // Like FindPageWithSpace(), but in stream mode returns the calling
+  // thread's target page while it has room, otherwise releases it and
+  // claims the first page not owned by another stream.
+  // Returns INVALID_PAGE_ID if the caller should allocate a new page.
+  page_id_t FindInsertTarget(uint16_t required_bytes);
+
+  // Make a freshly allocated page the calling thread's target, so new
+  // allocations spread across streams. No-op when streams are off or the
+  // page is already claimed.
+  void AssignInsertTarget(page_id_t page_id);
+
   // Get the category value for a specific page
   // page_id: the data page ID
   // Returns: category value (0-255)
@@ -71,16 +118,30 @@ class FreeSpaceMap {
   // Get the total number of pages tracked by this FSM
   page_id_t GetPageCount() const;
 
-  // Flush the in-memory FSM cache to disk
+  // Write dirty FSM pages to disk
   // Returns true on success, false on failure
   bool Flush();
 
+  // Number of FSM pages modified since the last Flush()
+  size_t GetDirtyFSMPageCount() const;
+
+  // Number of FSM pages whose categories are in memory (read from disk
+  // since Initialize() or created since)
+  size_t GetLoadedFSMPageCount() const;
+
+  // Search and on-demand load counters
+  FreeSpaceMapMetrics GetMetrics() const;
+
   // Constants for FSM page format
-  static constexpr uint32_t FSM_MAGIC_NUMBER = 0x46534D00;
+  static constexpr uint32_t FSM_MAGIC_NUMBER = 0x46534D01;         // paged
+  static constexpr uint32_t FSM_LEGACY_MAGIC_NUMBER = 0x46534D00;  // blob
   static constexpr size_t FSM_HEADER_SIZE = 8;             // magic + page_count
   static constexpr size_t FSM_CATEGORIES_PER_PAGE = 8184;  // 8192 - 8
   static constexpr size_t FSM_PAGE_SIZE = 8192;
 
+  // Children per max-tree node
+  static constexpr size_t FSM_TREE_FANOUT = 64;
+
   // Category encoding/decoding
   static constexpr uint8_t MAX_CATEGORY = 255;
 
@@ -97,15 +158,32 @@ class FreeSpaceMap {
   // File descriptor for the FSM file
   int fsm_fd_;
 
-  // In-memory cache of FSM data (category bytes)
-  // For large tables, this may contain multiple FSM pages worth of data
-  // Uses dense array for O(1) access, but only allocated pages are valid
-  std::vector<uint8_t> fsm_cache_;
+  // In-memory cache of FSM data (category bytes), the leaves of the tree.
+  // Sized in whole FSM pages. Unallocated entries are 0 and never returned.
+  // Mutable, like the tree and the loaded flags: const readers load FSM
+  // pages on demand.
+  mutable std::vector<uint8_t> fsm_cache_;
+
+  // Upper levels of the max-tree: tree_levels_[0] holds the max of each
+  // group of FSM_TREE_FANOUT leaves, tree_levels_[l + 1] the max of each
+  // group of tree_levels_[l]. The last level has at most FSM_TREE_FANOUT
+  // entries. Page 0 (INVALID_PAGE_ID) is left out of the maxima.
+  mutable std::vector<std::vector<uint8_t>> tree_levels_;
 
-  // Set of actually allocated page IDs (sparse representation)
-  // This allows non-sequential page allocation (0, 5, 17, 100)
-  // Only pages in this set are scanned by FindPageWithSpace()
-  std::unordered_set<page_id_t> allocated_pages_;
+  // One flag per FSM page: categories read from disk (or page created
+  // since open); an unloaded page's leaves are MAX_CATEGORY placeholders
+  mutable std::vector<bool> loaded_fsm_pages_;
+
+  // Current target page of each insert stream (INVALID_PAGE_ID if none).
+  // Empty when streams are off.
+  std::vector<page_id_t> stream_targets_;
+
+  // One flag per leaf: page is some stream's target and counts as 0 in the
+  // tree
+  std::vector<bool> claimed_pages_;
+
+  // One flag per FSM page: modified since the last successful flush
+  std::vector<bool> dirty_fsm_pages_;
 
   // Total number of data pages tracked (highest page_id + 1)
   // This is NOT the count of allocated pages, but the size of the dense array
@@ -114,27 +192,89 @@ class FreeSpaceMap {
   // Mutex for thread-safe access to FSM
   mutable std::mutex fsm_mutex_;
 
+  // Counters for GetMetrics(), guarded by fsm_mutex_ like the tree
+  mutable FreeSpaceMapMetrics metrics_;
+
   // Flag indicating if FSM has been modified (dirty)
   bool is_dirty_;
 
   // Flag indicating if FSM is initialized
   bool is_initialized_;
 
+  // Set after loading a legacy-format file: the next flush rewrites every
+  // FSM page and trims the old blob
+  bool truncate_on_flush_;
+
   // Helper: Open the FSM file (create if doesn't exist)
   bool OpenFSMFile();
 
   // Helper: Close the FSM file
   void CloseFSMFile();
 
-  // Helper: Load FSM data from disk into cache
+  // Helper: Read the file header and size the cache, leaving every FSM
+  // page unloaded
   bool LoadFromDisk();
 
-  // Helper: Write FSM cache to disk
+  // Helper: Read FSM page fsm_page into the cache and refresh its part of
+  // the tree. A page that cannot be read loads as all 0 (no free space).
+  void LoadFSMPage(size_t fsm_page) const;
+
+  // Helper: Load the FSM page holding page_id if it is not loaded yet
+  void EnsureLoaded(page_id_t page_id) const;
+
+  // Helper: Load a file in the original single-blob format
+  bool LoadLegacyFormat(off_t file_size);
+
+  // Helper: Write dirty FSM pages to disk
   bool WriteToDisk();
 
   // Helper: Ensure the FSM cache is large enough for the given page_id
   void EnsureCapacity(page_id_t page_id);
 
+  // Helper: Set a leaf, mark its FSM page dirty and update the tree
+  // (caller holds fsm_mutex_)
+  void SetLeaf(page_id_t page_id, uint8_t category);
+
+  // Helper: Propagate a leaf's tree value change from old_value to
+  // new_value up through the levels
+  void BubbleUp(page_id_t page_id, uint8_t old_value, uint8_t new_value);
+
+  // Helper: Category the tree sees for a leaf (0 while claimed)
+  uint8_t TreeValue(size_t page_id) const {
+    return claimed_pages_[page_id] ? 0 : fsm_cache_[page_id];
+  }
+
+  // Helper: First page with category >= threshold, skipping claimed pages
+  // and loading FSM pages the search runs into (caller holds fsm_mutex_)
+  page_id_t SearchTree(uint8_t threshold) const;
+
+  // Helper: One descent of the tree; the result may be a placeholder
+  page_id_t DescendTree(uint8_t threshold) const;
+
+  // Helper: First unclaimed leaf in [start, end) with category >= threshold,
+  // or end if none
+  size_t FindUnclaimedLeaf(size_t start, size_t end, uint8_t threshold) const;
+
+  // Helper: Claim page_id for stream / release the stream's target
+  void ClaimTarget(size_t stream, page_id_t page_id);
+  void ReleaseTarget(size_t stream);
+
+  // Helper: Insert stream of the calling thread (streams must be on)
+  size_t CurrentStream() const;
+
+  // Helper: Rebuild every tree level from the leaves
+  void RebuildTree();
+
+  // Helper: Recompute the tree nodes above leaves [first_leaf, end_leaf)
+  void RefreshTree(size_t first_leaf, size_t end_leaf) const;
+
+  // Helper: Max of group `group` of the level below `level`
+  // (level 0 = leaves)
+  uint8_t GroupMax(size_t level, size_t group) const;
+
+  // Helper: Number of FSM pages needed for page_count_ data pages
+  size_t GetFSMPageCountOnDisk() const;
+
   // Helper: Get the FSM page index for a given data page_id
   // (for hierarchical FSM support)
   size_t GetFSMPageIndex(page_id_t page_id) const;
@@ -0,0 +1,87 @@
+#ifndef STORAGEENGINE_IO_URING_ENGINE_H
+#define STORAGEENGINE_IO_URING_ENGINE_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "../common/config.h"
+#include "async_io.h"
+
+// Linux io_uring AsyncIOEngine implemented on the raw syscalls (no liburing
+// dependency). One submission ring shared by all callers:
+//
+//   Submit()  -> fill SQEs under submit_mutex_, one io_uring_enter per chunk
+//   reaper_   -> io_uring_enter(GETEVENTS), drains CQEs, completes handles
+//
+// In-flight requests are capped at the CQ size so the completion queue can
+// never overflow. Construction throws std::runtime_error when io_uring is
+// not available (old kernel, seccomp, non-Linux); use IsSupported() to probe.
+class IoUringEngine : public AsyncIOEngine {
+ public:
+  explicit IoUringEngine(size_t queue_depth = DEFAULT_IO_QUEUE_DEPTH);
+  ~IoUringEngine() override;
+
+  IoUringEngine(const IoUringEngine&) = delete;
+  IoUringEngine& operator=(const IoUringEngine&) = delete;
+
+  std::vector<IOHandle> Submit(std::vector<IORequest> requests) override;
+  const char* GetName() const override { return "io_uring"; }
+
+  static bool IsSupported();
+
+ private:
+  struct Pending {
+    IORequest request;
+    std::shared_ptr<IOHandle::State> state;
+  };
+
+  int ring_fd_;
+  uint32_t sq_entries_;
+  uint32_t cq_entries_;
+
+  // Shared ring memory
+  void* sq_ring_;
+  size_t sq_ring_size_;
+  void* cq_ring_;
+  size_t cq_ring_size_;
+  void* sqes_;
+  size_t sqes_size_;
+
+  uint32_t* sq_head_;
+  uint32_t* sq_tail_;
+  uint32_t* sq_mask_;
+  uint32_t* sq_array_;
+  uint32_t* cq_head_;
+  uint32_t* cq_tail_;
+  uint32_t* cq_mask_;
+  void* cqes_;
+
+  std::mutex submit_mutex_;
+
+  // user_data -> request; guarded by pending_mutex_
+  std::unordered_map<uint64_t, Pending> pending_;
+  uint64_t next_user_data_;
+  size_t in_flight_;
+  std::mutex pending_mutex_;
+  std::condition_variable slots_cv_;
+
+  std::thread reaper_;
+  std::atomic<bool> stopping_;
+
+  void SetupRing(size_t queue_depth);
+  void TeardownRing();
+  void ReaperLoop();
+
+  // Push one SQE (submit_mutex_ held); returns false if the SQ is full
+  bool PushSqe(uint8_t opcode, const IORequest* request, uint64_t user_data);
+  int Enter(uint32_t to_submit, uint32_t min_complete, uint32_t flags);
+};
+
+#endif  // STORAGEENGINE_IO_URING_ENGINE_H
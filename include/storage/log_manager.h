@@ -0,0 +1,208 @@
+#ifndef STORAGEENGINE_LOG_MANAGER_H
+#define STORAGEENGINE_LOG_MANAGER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "../common/config.h"
+#include "../common/file_handle.h"
+#include "../common/types.h"
+
+// Kinds of write-ahead log records. Each one names a single-page change
+// that PageManager::Recover() re-applies with the same Page call.
+enum class LogRecordType : uint8_t {
+  NEW_PAGE = 1,  // page_id was allocated and initialized empty
+  INSERT = 2,    // payload inserted at slot_id
+  UPDATE = 3,    // slot_id rewritten in place with the payload
+  DELETE = 4,    // slot_id deleted
+  FORWARD = 5,   // slot_id forwarded to the ForwardStub in the payload
+  COMPACT = 6,   // page compacted
+  CHECKPOINT = 7,
+  PAGE_IMAGE = 8,  // payload is the whole page after a change
+  // INSERT/UPDATE whose payload is a TupleCompressor stored form, so the
+  // slot is flagged SLOT_COMPRESSED
+  INSERT_COMPRESSED = 9,
+  UPDATE_COMPRESSED = 10,
+};
+
+// A record as seen by LogManager::ForEachRecord(); payload points into the
+// reader's buffer and is only valid during the callback
+struct LogRecord {
+  lsn_t lsn;
+  LogRecordType type;
+  page_id_t page_id;
+  slot_id_t slot_id;
+  const char* payload;
+  uint16_t payload_size;
+};
+
+// LogManager appends page changes to a sequential write-ahead log.
+//
+// File layout:
+//   [0, LOG_HEADER_SIZE)  header: magic "WLOG", version, checkpoint LSN
+//   then records back to back, each a 24-byte LogRecordHeader (total size,
+//   CRC32C of the record with the crc field zeroed, LSN, page_id, slot_id,
+//   type) followed by the payload.
+// A record's LSN is its byte offset in the file, so LSNs grow with the log
+// and INVALID_LSN (0) falls inside the header.
+//
+// Append() only copies the record into an in-memory buffer. Flush() makes
+// it durable with group commit: the first caller to find the log behind
+// becomes the leader and writes and fdatasyncs everything buffered so far,
+// while callers that arrive meanwhile wait and usually find their record
+// already covered, so concurrent commits share one fdatasync.
+//
+// Torn pages: the first change to a page after a checkpoint begins is
+// logged as a PAGE_IMAGE of the whole page instead of its compact record
+// (see AppendPageChange()). Every page write that a crash could tear
+// therefore has an image in the log after the replay start, and recovery
+// installs it without reading the damaged page. Data page writes need no
+// fsync of their own; checkpoints sync them once.
+//
+// Opening an existing log scans forward from the last checkpoint and cuts
+// off a torn tail (a record with a bad size, LSN or CRC), so appends resume
+// after the last complete record.
+//
+// Thread safety: every method may be called concurrently.
+//
+// Usage example:
+//   LogManager log("data.wal");
+//   lsn_t lsn = log.Append(LogRecordType::DELETE, page_id, slot_id);
+//   log.Flush(lsn);  // durable once this returns success
+class LogManager {
+ public:
+  static constexpr size_t LOG_HEADER_SIZE = 4096;
+  static constexpr uint32_t LOG_FORMAT_VERSION = 1;
+
+  // Opens or creates log_file_name. Throws std::runtime_error if the file
+  // cannot be opened or is not a log file.
+  explicit LogManager(const std::string& log_file_name);
+
+  // Flushes buffered records
+  ~LogManager();
+
+  LogManager(const LogManager&) = delete;
+  LogManager& operator=(const LogManager&) = delete;
+
+  // Buffer a record and return its LSN. payload_size must not exceed
+  // PAGE_SIZE.
+  lsn_t Append(LogRecordType type, page_id_t page_id, slot_id_t slot_id,
+               const char* payload = nullptr, uint16_t payload_size = 0);
+
+  // Log a change to a page whose LSN was page_lsn before the change.
+  // If the page has not changed since the current checkpoint began, a
+  // PAGE_IMAGE of page_image (PAGE_SIZE bytes, the page after the change)
+  // is logged instead; NEW_PAGE records never need one.
+  lsn_t AppendPageChange(LogRecordType type, page_id_t page_id,
+                         slot_id_t slot_id, lsn_t page_lsn,
+                         const char* page_image, const char* payload = nullptr,
+                         uint16_t payload_size = 0);
+
+  // Make the record at lsn and every record before it durable.
+  // INVALID_LSN is always durable.
+  ErrorCode Flush(lsn_t lsn);
+
+  // Make every record appended so far durable
+  ErrorCode FlushAll();
+
+  // LSN the next appended record will get
+  lsn_t GetNextLsn() const;
+
+  // End of the durable log: every record with a smaller LSN is on disk
+  lsn_t GetDurableLsn() const { return durable_lsn_.load(); }
+
+  // Where recovery starts replaying (LOG_HEADER_SIZE for a new log)
+  lsn_t GetCheckpointLsn() const;
+
+  // Start a checkpoint: returns the LSN to pass to SetCheckpointLsn() once
+  // every dirty page is written. From now on each page's next change is
+  // logged as a full image.
+  lsn_t BeginCheckpoint();
+
+  // Durably record lsn as the recovery start point. Records before it are
+  // never replayed again.
+  ErrorCode SetCheckpointLsn(lsn_t lsn);
+
+  // Call visitor for each durable record from from_lsn (a record boundary,
+  // at least LOG_HEADER_SIZE) to the end, in log order. Stops early when
+  // visitor returns false.
+  ErrorCode ForEachRecord(
+      lsn_t from_lsn,
+      const std::function<bool(const LogRecord&)>& visitor) const;
+
+  // fdatasync calls issued for flushes (group commit shares them)
+  uint64_t GetSyncCount() const { return sync_count_.load(); }
+
+  // PAGE_IMAGE records appended since the log was opened
+  uint64_t GetPageImageCount() const { return page_images_.load(); }
+
+  const std::string& GetFileName() const { return log_file_name_; }
+
+ private:
+  struct LogFileHeader {
+    char magic[4];
+    uint32_t version;
+    lsn_t checkpoint_lsn;
+  };
+
+#pragma pack(push, 1)
+  struct LogRecordHeader {
+    uint32_t size;  // header + payload
+    uint32_t crc;
+    lsn_t lsn;
+    page_id_t page_id;
+    slot_id_t slot_id;
+    uint8_t type;
+    uint8_t reserved;
+  };
+#pragma pack(pop)
+  static_assert(sizeof(LogRecordHeader) == 24,
+                "LogRecordHeader must be 24 bytes");
+
+  std::string log_file_name_;
+  FileHandle file_;
+
+  // Records not yet written; buffer_[0] is at LSN buffer_lsn_
+  mutable std::mutex append_mutex_;
+  std::vector<char> buffer_;
+  lsn_t buffer_lsn_;
+  lsn_t next_lsn_;
+  // Pages with a smaller LSN get a full image on their next change
+  lsn_t full_page_lsn_;
+
+  // Held by the group commit leader for its write and fdatasync.
+  // flush_buffer_ swaps with buffer_ so appends continue during the write.
+  std::mutex flush_mutex_;
+  std::vector<char> flush_buffer_;
+  std::atomic<lsn_t> durable_lsn_;
+  std::atomic<lsn_t> checkpoint_lsn_;
+  std::atomic<uint64_t> sync_count_{0};
+  std::atomic<uint64_t> page_images_{0};
+
+  // Append a record; append_mutex_ must be held
+  lsn_t AppendLocked(LogRecordType type, page_id_t page_id, slot_id_t slot_id,
+                     const char* payload, uint16_t payload_size);
+
+  bool WriteHeader(lsn_t checkpoint_lsn);
+
+  // Make every record before end_lsn durable
+  ErrorCode FlushTo(lsn_t end_lsn);
+
+  // Visit the intact records in [from_lsn, end_lsn) and return the LSN
+  // after the last one visited
+  lsn_t ScanRecords(
+      lsn_t from_lsn, lsn_t end_lsn,
+      const std::function<bool(const LogRecord&)>& visitor) const;
+
+  // Find the end of the last complete record and truncate anything after it
+  void RecoverTail();
+
+  static uint32_t RecordCrc(const char* record, size_t size);
+};
+
+#endif  // STORAGEENGINE_LOG_MANAGER_H
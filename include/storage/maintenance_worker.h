@@ -0,0 +1,88 @@
+#ifndef STORAGEENGINE_MAINTENANCE_WORKER_H
+#define STORAGEENGINE_MAINTENANCE_WORKER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "../common/config.h"
+#include "../common/types.h"
+#include "page_manager.h"
+
+// MaintenanceWorker compacts fragmented pages and shortens forwarding
+// chains on a background thread, so foreground inserts rarely have to
+// compact inline.
+//
+// Every interval_ms it runs one round:
+//   1. Pick the resident pages with Page::ShouldCompact(), most fragmented
+//      bytes first, and compact up to max_pages_per_round of them into a
+//      scratch buffer owned by the worker. Each compaction refreshes the
+//      page's FSM entry. Only cached pages are touched: compaction reads
+//      nothing, and every compacted page costs one write when it is flushed.
+//   2. Collapse forwarding chains on the next chain_pages_per_round pages,
+//      resuming where the previous round stopped (0 disables this step).
+// A round stops early once it has used max_round_ms of CPU time.
+//
+// Each page is latched exclusively only while it is compacted, so the
+// worker runs alongside foreground operations. The PageManager must outlive
+// the worker.
+//
+// Usage example:
+//   PageManager pm(&dm, &fsm);
+//   MaintenanceWorker worker(&pm);  // default budgets, starts the thread
+//   ... workload ...
+//   worker.Stop();                  // also done by the destructor
+class MaintenanceWorker {
+ public:
+  MaintenanceWorker(
+      PageManager* page_manager,
+      uint32_t interval_ms = DEFAULT_MAINTENANCE_INTERVAL_MS,
+      size_t max_pages_per_round = DEFAULT_MAINTENANCE_MAX_PAGES,
+      uint32_t max_round_ms = DEFAULT_MAINTENANCE_MAX_ROUND_MS,
+      size_t chain_pages_per_round = DEFAULT_MAINTENANCE_CHAIN_PAGES);
+
+  // Stops the thread
+  ~MaintenanceWorker();
+
+  MaintenanceWorker(const MaintenanceWorker&) = delete;
+  MaintenanceWorker& operator=(const MaintenanceWorker&) = delete;
+
+  // Run one round now on the calling thread (serialized with the
+  // background rounds)
+  void RunOnce();
+
+  // Finish the current round and join the thread. Idempotent.
+  void Stop();
+
+  uint64_t GetRoundCount() const { return rounds_.load(); }
+  uint64_t GetPagesCompacted() const { return pages_compacted_.load(); }
+  uint64_t GetChainsCollapsed() const { return chains_collapsed_.load(); }
+
+ private:
+  PageManager* page_manager_;
+  uint32_t interval_ms_;
+  size_t max_pages_per_round_;
+  uint32_t max_round_ms_;
+  size_t chain_pages_per_round_;
+
+  // Guards scratch_ and chain_cursor_
+  std::mutex round_mutex_;
+  std::unique_ptr<char[]> scratch_;  // PAGE_SIZE bytes
+  page_id_t chain_cursor_;
+
+  std::atomic<uint64_t> rounds_;
+  std::atomic<uint64_t> pages_compacted_;
+  std::atomic<uint64_t> chains_collapsed_;
+
+  std::thread thread_;
+  std::mutex thread_mutex_;
+  std::condition_variable thread_cv_;
+  bool stop_thread_;
+
+  void ThreadLoop();
+};
+
+#endif  // STORAGEENGINE_MAINTENANCE_WORKER_H
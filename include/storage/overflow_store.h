@@ -0,0 +1,87 @@
+#ifndef STORAGEENGINE_OVERFLOW_STORE_H
+#define STORAGEENGINE_OVERFLOW_STORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "../buffer/buffer_pool_manager.h"
+#include "../common/types.h"
+#include "../page/page.h"
+#include "../tuple/overflow_value.h"
+
+// OverflowValueStore keeping each value in a chain of PAGE_TYPE_OVERFLOW
+// pages of a buffer pool: every page holds an OverflowPageHeader and up to
+// OVERFLOW_PAGE_CAPACITY bytes of the value, and links to the next page.
+// Values are immutable: an update writes a new chain and frees the old one.
+//
+// Writes go through to the DiskManager before Write() returns, so a tuple
+// logged afterwards never points at pages that only existed in the buffer
+// pool; with DurabilityMode::IMMEDIATE the chain is also durable by then. A
+// crash between Write() and storing the tuple leaks the chain's pages.
+//
+// As with indexes, give the store a buffer pool and file of its own (the
+// table's "TOAST file"), so table scans never see overflow pages and the
+// table's free space map never offers them for inserts.
+//
+// Thread safety: values are written once and then only read or freed, so
+// concurrent calls on different values are safe; freeing a value while it
+// is being read is not.
+//
+// Usage example:
+//   DiskManager overflow_dm("users.ovf");
+//   BufferPoolManager overflow_pool(256, &overflow_dm);
+//   OverflowStore overflow(&overflow_pool);
+//   size_t size = TupleSerializer::SerializeVariableLength(
+//       schema, values, buffer, sizeof(buffer), &overflow);
+//   TupleAccessor row(schema, data, size, &overflow);
+//   std::string body = row.GetString("body");  // reads the chain
+
+#pragma pack(push, 1)
+// Follows the PageHeader of every overflow page
+typedef struct OverflowPageHeader {
+  uint32_t next_page_id;  // INVALID_PAGE_ID on the last page
+  uint32_t value_length;  // whole value, repeated on every page
+  uint16_t chunk_size;    // value bytes on this page
+  uint16_t reserved;
+} OverflowPageHeader;
+#pragma pack(pop)
+
+static_assert(sizeof(OverflowPageHeader) == 12,
+              "OverflowPageHeader must be 12 bytes");
+
+constexpr size_t OVERFLOW_PAGE_CAPACITY =
+    PAGE_SIZE - sizeof(PageHeader) - sizeof(OverflowPageHeader);
+
+class OverflowStore : public OverflowValueStore {
+ public:
+  // bpm is not owned; throws std::invalid_argument if it is null
+  explicit OverflowStore(BufferPoolManager* bpm);
+
+  OverflowStore(const OverflowStore&) = delete;
+  OverflowStore& operator=(const OverflowStore&) = delete;
+
+  // Fails for empty values (they are always stored inline)
+  ErrorCode Write(std::string_view value, OverflowPointer* pointer) override;
+
+  // Fails if the chain is broken, has the wrong length, or a page is not an
+  // overflow page
+  ErrorCode Read(const OverflowPointer& pointer,
+                 std::string* value) const override;
+
+  ErrorCode Free(const OverflowPointer& pointer) override;
+
+  // Pages a value of length bytes occupies
+  static size_t PagesFor(size_t length) {
+    return (length + OVERFLOW_PAGE_CAPACITY - 1) / OVERFLOW_PAGE_CAPACITY;
+  }
+
+ private:
+  BufferPoolManager* bpm_;
+
+  // Free pages [first_page_id, ...) of a chain, stopping after max_pages
+  void FreeChain(page_id_t first_page_id, size_t max_pages);
+};
+
+#endif  // STORAGEENGINE_OVERFLOW_STORE_H
@@ -0,0 +1,52 @@
+#ifndef STORAGEENGINE_PAGE_BITMAP_H
+#define STORAGEENGINE_PAGE_BITMAP_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "../common/types.h"
+
+// PageBitmap keeps one bit per page id, for ids anywhere in page_id_t's
+// range, without knowing the file size up front: the bits are stored in
+// chunks of CHUNK_PAGES ids, each allocated when one of its bits is first
+// set. A clear bit costs nothing, so a table that grows while the bitmap
+// is in use needs no resizing.
+//
+// Thread safety: every method is lock-free and may be called concurrently.
+// Set(), Clear() and Test() on one bit are ordered (release/acquire), so a
+// reader that sees a bit set also sees what the setter wrote before it.
+//
+// Usage example:
+//   PageBitmap verified;
+//   if (!verified.Test(page_id)) {
+//     Verify(page_id);
+//     verified.Set(page_id);
+//   }
+class PageBitmap {
+ public:
+  static constexpr size_t CHUNK_PAGES = size_t{1} << 20;  // 128 KB of bits
+
+  PageBitmap();
+  ~PageBitmap();
+
+  PageBitmap(const PageBitmap&) = delete;
+  PageBitmap& operator=(const PageBitmap&) = delete;
+
+  bool Test(page_id_t page_id) const;
+  void Set(page_id_t page_id);
+  void Clear(page_id_t page_id);
+
+ private:
+  static constexpr size_t CHUNK_WORDS = CHUNK_PAGES / 64;
+  static constexpr size_t CHUNK_COUNT =
+      (size_t{1} << (8 * sizeof(page_id_t))) / CHUNK_PAGES;
+
+  std::unique_ptr<std::atomic<std::atomic<uint64_t>*>[]> chunks_;
+
+  // The chunk holding page_id's bit, or null if none was allocated
+  std::atomic<uint64_t>* FindChunk(page_id_t page_id) const;
+};
+
+#endif  // STORAGEENGINE_PAGE_BITMAP_H
@@ -2,41 +2,145 @@
 #define STORAGEENGINE_PAGE_MANAGER_H
 
 #include <memory>
-#include <mutex>
-#include <unordered_map>
+#include <vector>
 
+#include "../buffer/buffer_pool_manager.h"
+#include "../buffer/page_guard.h"
+#include "../common/compression.h"
+#include "../common/metrics.h"
 #include "../common/types.h"
 #include "../page/page.h"
+#include "../schema/schema.h"
+#include "../tuple/overflow_value.h"
 #include "disk_manager.h"
 #include "free_space_map.h"
+#include "log_manager.h"
+#include "pinned_tuple.h"
+#include "zone_map.h"
+
+class TableIndex;
 
 // PageManager coordinates page operations with disk I/O and free space
 // tracking. It provides high-level CRUD operations for tuples and transparently
 // handles:
 //   - Page allocation and deallocation
-//   - Page caching for performance
+//   - Page caching through a BufferPoolManager sized by a memory budget
 //   - Free space map synchronization
 //   - Forwarding chain resolution
 //
+// Forwarding: an update that fits neither in place nor in the free space of
+// the tuple's page moves the tuple and leaves a stub in its home slot.
+// Repeat updates point the home stub straight at the newest version and
+// free the previous version and any intermediate stubs, so a lookup costs
+// at most one extra page fetch.
+// CollapseForwardingChains() does the same for chains left by older code.
+//
+// Write-ahead logging: with a LogManager, every page change is logged under
+// the page latch and stamped into the page LSN, and InsertTuple(s),
+// UpdateTuple and DeleteTuple return only once their records are durable
+// (group commit), so data pages can be written back lazily and without a
+// per-page fsync: a page torn by a crash is restored from the full-page
+// image logged on its first change after a checkpoint. Opening a
+// PageManager replays the log from the last checkpoint; Checkpoint()
+// writes the dirty pages and moves the replay start forward. Recovery is
+// redo only: an update or delete interrupted between its page steps may
+// leave an unreachable tuple version behind, but never a dangling stub or
+// a lost committed change.
+//
+// Indexes: every attached TableIndex is updated by InsertTuple(s),
+// UpdateTuple and DeleteTuple after (for updates, around) the tuple change.
+// An insert a unique index rejects is undone and reported as failed; such
+// an update leaves the tuple unchanged. The tuple and index steps are not
+// atomic, so concurrent writers to the same tuple must be serialized by the
+// caller, and like the index pages, entries are not WAL-logged.
+//
+// Compression: with a TupleCompressor set, InsertTuple(s) and UpdateTuple
+// store each tuple that actually shrinks in compressed form and flag its
+// slot SLOT_COMPRESSED (the WAL logs the stored bytes). Every read path
+// (GetTuple, GetTupleView, TableScan) hands back the original bytes, so
+// callers never see the difference; indexes are fed the original tuples.
+//
+// Out-of-line values: tuples serialized with an OverflowValueStore keep
+// only pointers to their large values. With the store set here,
+// DeleteTuple frees a tuple's values and UpdateTuple frees those the new
+// version no longer points at, once the tuple change has succeeded.
+//
+// Fill factor: below 100 (SetFillFactor()), inserts leave that share of
+// each page free and the FSM reports pages' space net of it, so an update
+// that grows a tuple finds room on the tuple's page and moves it there
+// instead of forwarding it (the forward stays the fallback for a full page).
+//
+// Zone maps: with a ZoneMap set, InsertTuple(s), UpdateTuple and
+// DeleteTuple keep the summaries of the pages they touch up to date after
+// the tuple change (on a page the map does not track yet, by summarizing
+// the whole page), and TableScans with a predicate skip the pages it rules
+// out. FlushAllPages() and Checkpoint() flush it.
+//
+// Thread safety: there is no PageManager-wide lock. Concurrency comes from
+// the buffer pool's partitioned page table and per-page latches: readers
+// (GetTuple) share a page, writers (Insert/Update/Delete/Compact) take it
+// exclusively, and operations on different pages proceed in parallel.
+//
 // Usage example:
 //   DiskManager dm("data.db");
 //   FreeSpaceMap fsm("data.fsm");
-//   PageManager pm(&dm, &fsm);
+//   PageManager pm(&dm, &fsm);                  // default 8 MB pool
+//   PageManager pm(&dm, &fsm, 256, ReplacerType::CLOCK);  // 256 MB, CLOCK
+//   LogManager log("data.wal");
+//   PageManager pm(&dm, &fsm, 8, ReplacerType::LRU_K, &log);  // with a WAL
 
 class PageManager {
  public:
   // Takes ownership of DiskManager and FreeSpaceMap pointers
   // (caller is responsible for cleanup)
-  PageManager(DiskManager* disk_manager, FreeSpaceMap* fsm);
+  // buffer_pool_size_mb: memory budget for cached pages
+  // log_manager: optional write-ahead log (not owned). The log is replayed
+  // before the constructor returns; throws std::runtime_error if that fails.
+  PageManager(DiskManager* disk_manager, FreeSpaceMap* fsm,
+              size_t buffer_pool_size_mb = DEFAULT_BUFFER_POOL_SIZE_MB,
+              ReplacerType replacer_type = ReplacerType::LRU_K,
+              LogManager* log_manager = nullptr);
 
-  // Flushes all dirty pages to disk
+  // Flushes all dirty pages to disk (a checkpoint with a log)
   ~PageManager();
 
   TupleId InsertTuple(const char* tuple_data, uint16_t tuple_size);
 
+  // Insert count tuples, packing as many as fit into each page under a
+  // single latch acquisition and updating the FSM once per page.
+  // Entry i of the result is tuples[i]'s id, or {0, INVALID_SLOT_ID} if that
+  // tuple is invalid (null, empty, too large) or a page could not be
+  // allocated. Tuples keep their order within and across pages.
+  std::vector<TupleId> InsertTuples(const TupleSlice* tuples, size_t count);
+  std::vector<TupleId> InsertTuples(const std::vector<TupleSlice>& tuples) {
+    return InsertTuples(tuples.data(), tuples.size());
+  }
+
   ErrorCode GetTuple(TupleId tuple_id, char* buffer,
                      uint16_t buffer_size) const;
 
+  // Zero-copy read: on success *tuple pins and share-latches the page that
+  // holds the tuple (after following forwarding) and points into it. Any
+  // view previously held in *tuple is released first.
+  ErrorCode GetTupleView(TupleId tuple_id, PinnedTuple* tuple) const;
+
+  // Batched GetTuple(): copy each tuple_ids[i] into *buffer and point
+  // (*tuples)[i] at it ({nullptr, 0} if it cannot be read). The ids are
+  // grouped by page, the pages pinned with one FetchPages() call (so the
+  // cache misses are read in one asynchronous submission) and each page is
+  // latched once for all of its tuples; forwarded tuples are then read one
+  // by one, like GetTuple(). Pages are pinned at most half a pool at a
+  // time. The slices stay valid until *buffer changes. Returns the number
+  // of tuples read.
+  size_t GetTuples(const TupleId* tuple_ids, size_t count,
+                   std::vector<char>* buffer,
+                   std::vector<TupleSlice>* tuples) const;
+  size_t GetTuples(const std::vector<TupleId>& tuple_ids,
+                   std::vector<char>* buffer,
+                   std::vector<TupleSlice>* tuples) const {
+    return GetTuples(tuple_ids.data(), tuple_ids.size(), buffer, tuples);
+  }
+
   ErrorCode UpdateTuple(TupleId tuple_id, const char* new_data,
                         uint16_t new_size);
 
@@ -44,36 +148,206 @@ class PageManager {
 
   ErrorCode FlushAllPages();
 
+  // Write every dirty page, then start later recoveries from the log
+  // position before the flush. Same as FlushAllPages() without a log.
+  // Safe to call alongside foreground operations.
+  ErrorCode Checkpoint();
+
   ErrorCode CompactPage(page_id_t page_id);
 
+  // Resident pages for which Page::ShouldCompact() holds, most fragmented
+  // bytes first, at most max_pages of them. Reads no pages from disk.
+  std::vector<page_id_t> FindCompactionCandidates(size_t max_pages) const;
+
+  // Compact the page into scratch (PAGE_SIZE bytes) if it is still resident
+  // and still needs it, then refresh its FSM entry. Never reads from disk.
+  // Returns true if the page was compacted.
+  bool CompactResidentPage(page_id_t page_id, char* scratch);
+
+  // Point every multi-hop forwarding chain's home slot at its final version
+  // and free the intermediate stubs. Scans every page; one page latch at a
+  // time, so it can run alongside foreground operations.
+  // Returns the number of chains collapsed.
+  size_t CollapseForwardingChains();
+
+  // Same for forwarded slots on pages [first_page_id, end_page_id), so the
+  // table can be covered in bounded steps. An intermediate stub in the range
+  // is collapsed like a home slot; its home is shortened when its own page
+  // is visited.
+  size_t CollapseForwardingChains(page_id_t first_page_id,
+                                  page_id_t end_page_id);
+
+  // Number of pages currently resident in the buffer pool
   size_t GetCacheSize() const;
   void ClearCache();
 
+  // Snapshot of the disk, buffer pool, FSM and page manager counters
+  StorageMetrics GetMetrics() const;
+
+  // Keep index up to date from now on (not owned; tuples already stored
+  // are not added). Attach indexes before sharing the PageManager with
+  // other threads.
+  void AttachIndex(TableIndex* index);
+
+  // Compress tuples written from now on with compressor (not owned; null
+  // stops compressing). Tuples stored with a dictionary can only be read
+  // back with a compressor holding the same dictionary, so set it again
+  // after reopening the table. Set it before sharing the PageManager with
+  // other threads.
+  void SetTupleCompressor(const TupleCompressor* compressor);
+
+  // The compressor reads decode with: the one set, or a dictionary-less one
+  const TupleCompressor& GetTupleCompressor() const;
+
+  // Free the out-of-line values of tuples (laid out by schema) in store
+  // when they are deleted or updated away (not owned; null stops). Set it
+  // before sharing the PageManager with other threads.
+  void SetOverflowStore(const Schema& schema, OverflowValueStore* store);
+
+  // Maintain zone_map from now on (not owned; null stops). Pages it does
+  // not track yet are summarized when next written to, or by
+  // RebuildZoneMap(). Set it before sharing the PageManager with other
+  // threads.
+  void SetZoneMap(ZoneMap* zone_map) { zone_map_ = zone_map; }
+  ZoneMap* GetZoneMap() const { return zone_map_; }
+
+  // Summarize the page from its current tuples, tracking it from now on and
+  // dropping values deleted or updated away
+  ErrorCode RebuildZoneMap(page_id_t page_id);
+
+  // Same for every page; returns the number of pages summarized
+  size_t RebuildZoneMap();
+
+  // Fill pages to percent (MIN_TABLE_FILL_FACTOR to 100) of PAGE_SIZE by
+  // inserts from now on. Pages keep the FSM entries they have until next
+  // written to. Not persisted: set it again after reopening the table, and
+  // before sharing the PageManager with other threads.
+  ErrorCode SetFillFactor(uint8_t percent);
+  uint8_t GetFillFactor() const { return fill_factor_; }
+
+  BufferPoolManager* GetBufferPool() const { return buffer_pool_.get(); }
+  DiskManager* GetDiskManager() const { return disk_manager_; }
+
  private:
   DiskManager* disk_manager_;
 
   FreeSpaceMap* fsm_;
 
-  std::unordered_map<page_id_t, std::unique_ptr<Page>> page_cache_;
+  std::unique_ptr<BufferPoolManager> buffer_pool_;
+
+  LogManager* log_manager_;
+
+  // Metrics (GetMetrics()); bumped from const lookups
+  mutable MetricCounter forwarded_lookups_;
+  mutable MetricCounter forwarding_hops_;
+  MetricCounter compactions_;
+  MetricCounter moved_updates_;
+  MetricCounter forwarded_updates_;
 
-  mutable std::mutex cache_mutex_;
+  std::vector<TableIndex*> indexes_;
 
-  static constexpr size_t MAX_CACHE_SIZE = 100;
+  const TupleCompressor* compressor_;
 
-  Page* GetPage(page_id_t page_id);
+  Schema overflow_schema_;
+  OverflowValueStore* overflow_store_;
 
-  ErrorCode FlushPage(page_id_t page_id);
+  ZoneMap* zone_map_;
 
-  page_id_t AllocateNewPage();
+  // Fill factor, and the bytes of each page inserts leave free for it
+  uint8_t fill_factor_;
+  uint16_t reserved_space_;
+
+  // What goes into the page for a tuple: its compressed form when that is
+  // smaller, else the tuple itself
+  struct StoredTuple {
+    const char* data;
+    uint16_t size;
+    uint8_t slot_flags;  // SLOT_COMPRESSED or 0
+  };
+
+  // scratch holds the compressed form (PAGE_SIZE bytes)
+  StoredTuple StoredForm(const char* tuple_data, uint16_t tuple_size,
+                         char* scratch) const;
+
+  // Pin and latch a page; the returned guard releases both when it goes out
+  // of scope. Operations hold at most one page latch at a time.
+  PageGuard GetPage(page_id_t page_id, LatchMode mode) const;
+
+  // Allocate, pin and exclusively latch a fresh page; returns an empty guard
+  // on failure
+  PageGuard AllocateNewPage();
 
   void UpdateFSM(page_id_t page_id, Page* page) const;
 
-  TupleId FollowForwardingChainFull(TupleId tuple_id) const;
+  // Log a change just made to the exclusively latched page and stamp the
+  // page with the record's LSN. No-op without a log.
+  void LogChange(const PageGuard& page, LogRecordType type, slot_id_t slot_id,
+                 const char* payload = nullptr, uint16_t payload_size = 0);
+  void LogForward(const PageGuard& page, slot_id_t slot_id, TupleId target);
+
+  // UpdateTuple/DeleteTuple without index maintenance
+  ErrorCode UpdateTupleData(TupleId tuple_id, const char* new_data,
+                            uint16_t new_size);
+  ErrorCode DeleteTupleData(TupleId tuple_id);
+
+  // Add a stored tuple to every index; on failure none keeps it
+  ErrorCode IndexNewTuple(const char* tuple_data, uint16_t tuple_size,
+                          TupleId tuple_id);
 
-  void EvictPageIfNeeded();
+  // Free the out-of-line values of old_tuple that kept_tuple (may be null)
+  // does not point at
+  void FreeOverflowValues(const std::vector<char>& old_tuple,
+                          const char* kept_tuple, uint16_t kept_size);
+
+  // Widen the zone map with a tuple just stored on page_id, or summarize the
+  // whole page if the map does not track it yet (returns true then, as the
+  // page's other new tuples are covered too). No-op without a zone map.
+  bool SummarizeNewTuple(page_id_t page_id, const char* tuple_data,
+                         uint16_t tuple_size);
+
+  // RebuildZoneMap(page_id) inside a BeginChange()/EndChange() bracket
+  ErrorCode RebuildZoneMapPage(page_id_t page_id);
+
+  // Copy of the tuple's current bytes
+  ErrorCode CopyTuple(TupleId tuple_id, std::vector<char>* out) const;
+
+  // Make the changes logged so far durable before reporting success
+  ErrorCode Commit();
+
+  // Replay the log from the last checkpoint, then checkpoint
+  ErrorCode Recover();
+
+  // Re-apply one record unless its page already reflects it
+  bool RedoRecord(const LogRecord& record);
+
+  // Replace the page with image (an empty page if null) stamped with lsn,
+  // unless a valid copy is already that recent. A torn page on disk is
+  // overwritten without being fetched.
+  bool InstallPageImage(page_id_t page_id, lsn_t lsn, const char* image);
+
+  // Resolve tuple_id to the slot holding the tuple, across pages, following
+  // at most MAX_FORWARDING_HOPS stubs. If stubs is non-null it receives the
+  // forwarded slots passed through, home first. If final_page is non-null
+  // it receives the share-latched page of the slot returned, held since the
+  // slot was found, so the slot is read before anyone can move or reuse it.
+  // Returns {0, 0} on invalid slots, over-long or circular chains.
+  TupleId FollowForwardingChainFull(TupleId tuple_id,
+                                    std::vector<TupleId>* stubs = nullptr,
+                                    PageGuard* final_page = nullptr) const;
+
+  // Delete each slot that is still valid (unreachable versions and stubs)
+  void FreeSlots(const std::vector<TupleId>& slots);
+
+  // Repoint a forwarded slot at its chain's final version and free the
+  // stubs in between. stubs is scratch space. Returns false if the chain
+  // has a single hop, is broken, or changed underneath.
+  bool CollapseChain(TupleId home, std::vector<TupleId>* stubs);
 
   page_id_t FindPageWithSpace(uint16_t required_size);
 
+  // Non-null, non-empty and small enough for an empty page
+  static bool IsInsertableTuple(const TupleSlice& tuple);
+
   ErrorCode GetTupleFromSlot(Page* page, slot_id_t slot_id, char* buffer,
                              uint16_t buffer_size) const;
 
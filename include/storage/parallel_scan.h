@@ -0,0 +1,102 @@
+#ifndef STORAGEENGINE_PARALLEL_SCAN_H
+#define STORAGEENGINE_PARALLEL_SCAN_H
+
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "../common/config.h"
+#include "../common/types.h"
+#include "../schema/schema.h"
+#include "../tuple/tuple_accessor.h"
+#include "page_manager.h"
+#include "table_scan.h"
+
+// ParallelScan runs a callback over every tuple of a table from a pool of
+// worker threads.
+//
+// The page range [1, GetNextPageId()) is split into morsels of
+// morsel_pages pages. Each worker starts with a contiguous block of
+// morsels in its own deque and scans them front to back with its own
+// TableScan (own read-ahead ring), so every worker streams sequentially.
+// A worker whose deque is empty steals from the back of another worker's
+// deque, so skewed morsels (hot resident pages, slow callbacks) do not
+// leave cores idle.
+//
+// Callbacks run concurrently on different workers, never concurrently on
+// the same worker_id. Per-thread results can be kept in a vector indexed
+// by worker_id and merged after Run() returns. Tuple order across workers
+// is unspecified. If a callback throws, the remaining morsels are skipped
+// and the first exception is rethrown from Run().
+//
+// Usage example:
+//   ParallelScan scan(&page_manager, 8);
+//   std::vector<int64_t> sums(scan.GetWorkerCount());
+//   scan.Run(schema, [&](size_t worker, TupleId, const TupleAccessor& t) {
+//     sums[worker] += t.GetBigInt("amount");
+//   });
+class ParallelScan {
+ public:
+  using TupleCallback =
+      std::function<void(size_t worker_id, const TupleView& tuple)>;
+  using AccessorCallback = std::function<void(
+      size_t worker_id, TupleId tuple_id, const TupleAccessor& accessor)>;
+
+  // num_workers: 0 means one per hardware thread
+  explicit ParallelScan(PageManager* page_manager, size_t num_workers = 0,
+                        size_t morsel_pages = DEFAULT_SCAN_MORSEL_PAGES);
+
+  // Scan every page once, calling callback for each tuple. Blocks until all
+  // workers finish.
+  void Run(const TupleCallback& callback);
+
+  // Same, decoding each tuple with a TupleAccessor built by the worker
+  void Run(const Schema& schema, const AccessorCallback& callback);
+
+  // Only call back for tuples matching predicate (not owned; nullptr: all),
+  // evaluated by each worker's TableScan on page bytes (pages the zone map
+  // rules out are not read)
+  void SetPredicate(const ScanPredicate* predicate) { predicate_ = predicate; }
+
+  size_t GetWorkerCount() const { return num_workers_; }
+
+  // Morsels taken from another worker's deque during the last Run()
+  size_t GetMorselsStolen() const { return morsels_stolen_.load(); }
+
+ private:
+  struct Morsel {
+    page_id_t first_page_id;
+    page_id_t end_page_id;
+  };
+
+  struct WorkQueue {
+    std::mutex mutex;
+    std::deque<Morsel> morsels;
+  };
+
+  PageManager* page_manager_;
+  size_t num_workers_;
+  size_t morsel_pages_;
+  const ScanPredicate* predicate_;
+
+  std::vector<std::unique_ptr<WorkQueue>> queues_;
+  std::atomic<size_t> morsels_stolen_;
+  std::atomic<bool> failed_;
+  std::exception_ptr failure_;
+  std::mutex failure_mutex_;
+
+  // Split the table into morsels and deal contiguous blocks to workers
+  void Partition();
+
+  // Pop from the front of the worker's own deque, else steal from the back
+  // of another one. Returns false when no work is left anywhere.
+  bool NextMorsel(size_t worker_id, Morsel* morsel);
+
+  void WorkerLoop(size_t worker_id, const TupleCallback& callback);
+};
+
+#endif  // STORAGEENGINE_PARALLEL_SCAN_H
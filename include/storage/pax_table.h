@@ -0,0 +1,119 @@
+#ifndef STORAGEENGINE_PAX_TABLE_H
+#define STORAGEENGINE_PAX_TABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "../buffer/buffer_pool_manager.h"
+#include "../buffer/page_guard.h"
+#include "../common/types.h"
+#include "../page/pax_page.h"
+#include "../schema/schema.h"
+#include "disk_manager.h"
+
+// One page's worth of a column, as handed to PaxTable::ScanColumn()
+// visitors. Pointers are valid only during the visitor call.
+struct PaxColumnChunk {
+  page_id_t page_id;
+  const char* values;    // rows entries of value_size bytes, 64-byte aligned
+  const uint8_t* nulls;  // bit r set: row r is NULL (nullptr: not nullable)
+  const uint8_t* valid;  // bit r set: row r holds a tuple
+  uint16_t rows;         // rows [0, rows) may hold tuples
+  uint32_t value_size;
+};
+
+// A table of a fixed-length schema stored in PAX pages (see pax_page.h),
+// for scan-heavy tables where queries read a few columns of many rows.
+//
+// Tuples go in and come out in the regular fixed-length tuple format, so
+// TupleSerializer and TupleAccessor work unchanged, and TupleIds are
+// {page id, row}. Row-at-a-time access costs one small copy per column;
+// ScanColumn() instead hands out each page's value array of one column,
+// which is what makes single-column scans and aggregates dense.
+//
+// Pages: the table owns every page of its DiskManager's file. Inserts go to
+// the page that most recently gained free rows (by allocation or a delete),
+// so deleted rows are reused before new pages are allocated. Opening an existing file reads every page once
+// to find the ones with free rows. Like the index structures, PAX pages are
+// not covered by the WAL; FlushAllPages() (also run by the destructor)
+// makes them durable.
+//
+// Thread safety: rows are read and written under their page's latch, and
+// the list of pages under a table mutex, so all methods may be called
+// concurrently.
+//
+// Usage example:
+//   DiskManager dm("metrics.pax");
+//   PaxTable table(&dm, schema);            // fixed-length schema
+//   TupleId tid = table.InsertTuple(row, size);
+//   int64_t total = 0;
+//   table.ScanColumn(schema.GetColumn("bytes").GetFieldIndex(),
+//                    [&](const PaxColumnChunk& chunk) { ... });
+class PaxTable {
+ public:
+  using ColumnVisitor = std::function<void(const PaxColumnChunk& chunk)>;
+
+  // disk_manager is not owned. Throws std::invalid_argument for a schema
+  // without a PAX layout (see PaxLayout) and std::runtime_error if a page
+  // of an existing file is not a PAX page of this schema.
+  PaxTable(DiskManager* disk_manager, const Schema& schema,
+           size_t buffer_pool_size_mb = DEFAULT_BUFFER_POOL_SIZE_MB);
+
+  // Flushes all dirty pages
+  ~PaxTable();
+
+  PaxTable(const PaxTable&) = delete;
+  PaxTable& operator=(const PaxTable&) = delete;
+
+  // tuple_size must be the schema's fixed-length tuple size. Returns
+  // {0, INVALID_SLOT_ID} if the tuple is invalid or no page could be
+  // allocated.
+  TupleId InsertTuple(const char* tuple_data, uint16_t tuple_size);
+
+  ErrorCode GetTuple(TupleId tuple_id, char* buffer,
+                     uint16_t buffer_size) const;
+
+  // In place: PAX rows never move
+  ErrorCode UpdateTuple(TupleId tuple_id, const char* new_data,
+                        uint16_t new_size);
+
+  ErrorCode DeleteTuple(TupleId tuple_id);
+
+  // Call visitor for every page, in page id order, with the page's chunk of
+  // column field_index; the page is share-latched during the call
+  ErrorCode ScanColumn(size_t field_index, const ColumnVisitor& visitor) const;
+
+  ErrorCode FlushAllPages();
+
+  const PaxLayout& GetLayout() const { return layout_; }
+  uint16_t GetRowsPerPage() const { return layout_.GetCapacity(); }
+  size_t GetPageCount() const;
+
+ private:
+  DiskManager* disk_manager_;
+  Schema schema_;
+  PaxLayout layout_;
+  std::unique_ptr<BufferPoolManager> buffer_pool_;
+
+  mutable std::mutex pages_mutex_;
+  std::vector<page_id_t> pages_;       // ascending
+  std::vector<page_id_t> with_space_;  // pages with free rows, last = next
+
+  // Find the table's pages in the file
+  void LoadPages();
+
+  PageGuard GetPage(page_id_t page_id, LatchMode mode) const;
+
+  // Latched page of tuple_id holding a valid row, or an empty guard
+  PageGuard GetRowPage(TupleId tuple_id, LatchMode mode) const;
+
+  // Exclusively latched page with a free row (new if needed), or an empty
+  // guard if none could be allocated
+  PageGuard PageWithSpace();
+};
+
+#endif  // STORAGEENGINE_PAX_TABLE_H
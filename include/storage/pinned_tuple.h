@@ -0,0 +1,94 @@
+#ifndef STORAGEENGINE_PINNED_TUPLE_H
+#define STORAGEENGINE_PINNED_TUPLE_H
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "../buffer/page_guard.h"
+#include "../common/types.h"
+
+// RAII zero-copy view of one tuple, returned by PageManager::GetTupleView.
+// Holds a pin and a shared latch on the tuple's page, so the bytes stay in
+// place (no eviction, no compaction, no concurrent update of that page)
+// until the view is released or destroyed. Keep views short-lived: writers
+// to the same page wait for them.
+//
+// Data()/Size() plug straight into TupleAccessor:
+//   PinnedTuple tuple;
+//   if (pm.GetTupleView(tid, &tuple).code == 0) {
+//     TupleAccessor accessor(schema, tuple.Data(), tuple.Size());
+//     ...
+//   }  // unlatched and unpinned here
+class PinnedTuple {
+ public:
+  PinnedTuple() = default;
+  PinnedTuple(PageGuard page, TupleId tuple_id, const char* data,
+              uint16_t size)
+      : page_(std::move(page)),
+        tuple_id_(tuple_id),
+        data_(data),
+        size_(size) {}
+
+  // View of a decompressed copy
+  PinnedTuple(TupleId tuple_id, std::vector<char> copy)
+      : tuple_id_(tuple_id),
+        copy_(std::move(copy)),
+        data_(copy_.data()),
+        size_(static_cast<uint16_t>(copy_.size())) {}
+
+  PinnedTuple(PinnedTuple&& other) noexcept
+      : page_(std::move(other.page_)),
+        tuple_id_(other.tuple_id_),
+        copy_(std::move(other.copy_)),
+        data_(other.data_),
+        size_(other.size_) {
+    other.Clear();
+  }
+
+  PinnedTuple& operator=(PinnedTuple&& other) noexcept {
+    if (this != &other) {
+      page_ = std::move(other.page_);
+      tuple_id_ = other.tuple_id_;
+      copy_ = std::move(other.copy_);
+      data_ = other.data_;
+      size_ = other.size_;
+      other.Clear();
+    }
+    return *this;
+  }
+
+  PinnedTuple(const PinnedTuple&) = delete;
+  PinnedTuple& operator=(const PinnedTuple&) = delete;
+
+  // Tuple bytes inside the page buffer or the copy (not NUL-terminated)
+  const char* Data() const { return data_; }
+  uint16_t Size() const { return size_; }
+
+  // Physical location, after following any forwarding chain
+  TupleId GetTupleId() const { return tuple_id_; }
+
+  explicit operator bool() const { return data_ != nullptr; }
+
+  // Unlatch and unpin now; the view becomes empty
+  void Release() {
+    page_.Release();
+    Clear();
+  }
+
+ private:
+  PageGuard page_;
+  TupleId tuple_id_{0, INVALID_SLOT_ID};
+  std::vector<char> copy_;  // empty unless the tuple was compressed
+  const char* data_ = nullptr;
+  uint16_t size_ = 0;
+
+  void Clear() {
+    tuple_id_ = {0, INVALID_SLOT_ID};
+    copy_.clear();
+    data_ = nullptr;
+    size_ = 0;
+  }
+};
+
+#endif  // STORAGEENGINE_PINNED_TUPLE_H
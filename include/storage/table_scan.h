@@ -0,0 +1,158 @@
+#ifndef STORAGEENGINE_TABLE_SCAN_H
+#define STORAGEENGINE_TABLE_SCAN_H
+
+#include <memory>
+#include <vector>
+
+#include "../buffer/frame_pool.h"
+#include "../buffer/page_guard.h"
+#include "../common/compression.h"
+#include "../common/config.h"
+#include "../common/types.h"
+#include "../page/page.h"
+#include "../tuple/scan_predicate.h"
+#include "async_io.h"
+#include "page_manager.h"
+
+// Zero-copy view of one tuple. data points into a page held by the scan (or,
+// for a compressed tuple, a scan-owned decompressed copy) and stays valid
+// until the next call to TableScan::Next().
+struct TupleView {
+  TupleId tuple_id;
+  const char* data;
+  uint16_t size;
+};
+
+// TableScan walks every page of a table in page id order and yields each
+// valid, non-forwarded slot (SLOT_VALID set, SLOT_FORWARDED clear). A
+// relocated tuple is yielded once, at its physical location, so the
+// returned TupleId is not necessarily the one InsertTuple() handed out.
+//
+// I/O:
+//   - Pages resident in the buffer pool are used in place (pinned and
+//     share-latched while their tuples are being viewed).
+//   - Every other page is read into a private ring of read_ahead_pages
+//     frames, using asynchronous reads submitted up to read_ahead_pages
+//     ahead of the current page, so the scan streams at sequential-read
+//     speed.
+//   - Ring frames never enter the buffer pool, so a full scan does not
+//     evict the pool's hot working set.
+//
+// The set of pages is fixed when the scan is created. Each page is seen as
+// of some moment during the scan; concurrent writers are not blocked except
+// while their page is being viewed. Pages that fail to read (never written,
+// checksum mismatch) are logged and skipped, as are compressed tuples the
+// PageManager's TupleCompressor cannot decode.
+//
+// Usage example:
+//   TableScan scan(&page_manager);
+//   TupleView tuple;
+//   while (scan.Next(&tuple)) {
+//     Consume(tuple.data, tuple.size);
+//   }
+class TableScan {
+ public:
+  explicit TableScan(PageManager* page_manager,
+                     size_t read_ahead_pages = DEFAULT_SCAN_READ_AHEAD_PAGES);
+
+  // Scan only pages [first_page_id, end_page_id)
+  TableScan(PageManager* page_manager, page_id_t first_page_id,
+            page_id_t end_page_id,
+            size_t read_ahead_pages = DEFAULT_SCAN_READ_AHEAD_PAGES);
+
+  // Waits for read-ahead still in flight
+  ~TableScan();
+
+  TableScan(const TableScan&) = delete;
+  TableScan& operator=(const TableScan&) = delete;
+
+  // Advance to the next tuple. Returns false once every page is consumed.
+  bool Next(TupleView* tuple);
+
+  // Advance to the next page holding (matching) tuples and replace *tuples
+  // (and *tuple_ids, if given) with all of them not yet returned, e.g. for
+  // BatchDecoder. They stay valid until the next call to Next() or
+  // NextPage(). Returns false once every page is consumed.
+  bool NextPage(std::vector<TupleSlice>* tuples,
+                std::vector<TupleId>* tuple_ids = nullptr);
+
+  // Return only tuples matching predicate (not owned; nullptr: all). Each
+  // page's tuples are filtered in one ScanPredicate::Filter() call on the
+  // page bytes, so Next() then walks the page's matches. Pages the
+  // PageManager's ZoneMap rules out are neither read ahead nor loaded.
+  // Applies to the tuples not returned yet.
+  void SetPredicate(const ScanPredicate* predicate) { predicate_ = predicate; }
+
+  // Restart on pages [first_page_id, end_page_id), reusing the ring
+  // (waits for read-ahead still in flight)
+  void ResetRange(page_id_t first_page_id, page_id_t end_page_id);
+
+  // Pages consumed so far, and how many of them came from the private ring
+  size_t GetPagesScanned() const { return pages_scanned_; }
+  size_t GetPagesReadFromDisk() const { return pages_read_from_disk_; }
+  // Pages passed over because the zone map ruled them out
+  size_t GetPagesSkipped() const { return pages_skipped_; }
+
+ private:
+  struct RingFrame {
+    Page* page;     // in ring_frames_
+    IOHandle read;  // valid while a read-ahead targets this frame
+  };
+
+  BufferPoolManager* buffer_pool_;
+  DiskManager* disk_manager_;
+  const TupleCompressor* compressor_;
+  const ZoneMap* zone_map_;
+  std::vector<char> decompressed_;  // current tuple, if it is compressed
+  std::vector<char> decompressed_page_;  // NextPage(): compressed tuples
+
+  // With a predicate, Next() returns the matches of the current page from
+  // here
+  const ScanPredicate* predicate_;
+  std::vector<TupleSlice> matches_;
+  std::vector<TupleId> match_ids_;
+  size_t next_match_;
+  std::vector<uint32_t> selection_;
+
+  std::unique_ptr<FramePool> ring_frames_;
+  std::vector<RingFrame> ring_;
+
+  page_id_t end_page_id_;    // one past the last page to scan
+  page_id_t next_page_id_;   // page to load after the current one
+  page_id_t next_prefetch_;  // first page not yet considered for read-ahead
+
+  // Page being iterated: a ring frame or a pinned buffer pool page
+  Page* current_page_;
+  page_id_t current_page_id_;
+  PageGuard current_guard_;
+  slot_id_t next_slot_;
+
+  size_t pages_scanned_;
+  size_t pages_read_from_disk_;
+  size_t pages_skipped_;
+
+  RingFrame& FrameFor(page_id_t page_id) {
+    return ring_[(page_id - 1) % ring_.size()];
+  }
+
+  // Submit reads for the non-resident pages among the next
+  // read_ahead_pages, starting at current_page_id, in one engine submission
+  void ReadAhead(page_id_t current_page_id);
+
+  // Whether the zone map rules the page out for the predicate
+  bool CanSkip(page_id_t page_id) const;
+
+  // Make page_id the current page. Returns false if it cannot be read.
+  bool LoadPage(page_id_t page_id);
+
+  void ReleaseCurrentPage();
+
+  // NextPage() without dropping the matches Next() has not returned yet
+  bool NextPageImpl(std::vector<TupleSlice>* tuples,
+                    std::vector<TupleId>* tuple_ids);
+
+  // Wait for every read-ahead still targeting a ring frame
+  void WaitForReadAhead();
+};
+
+#endif  // STORAGEENGINE_TABLE_SCAN_H
@@ -0,0 +1,110 @@
+#ifndef STORAGEENGINE_TABLESPACE_H
+#define STORAGEENGINE_TABLESPACE_H
+
+#include <sys/types.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../common/config.h"
+#include "../common/file_handle.h"
+#include "../common/types.h"
+
+// Tablespace stripes the pages of a DiskManager file over several data
+// files, typically one per device, so a single large table reads and
+// writes through all of them. Page ids are grouped into extents of
+// extent_pages consecutive ids, dealt round-robin over the files:
+//
+//   extent e = page_id / extent_pages   lives in file e % file_count
+//   at local page (e / file_count) * extent_pages + page_id % extent_pages
+//
+// File 0 is the DiskManager's own file, whose local page 0 (page id 0,
+// never a real page) is the file header's slot; the other files ("stripe
+// files") hold pages only. Pages of one extent are contiguous in their
+// file, so a sequential run of up to extent_pages pages is one transfer.
+//
+// The stripe file paths are kept in "<db_file_name>.tsp", one per line, in
+// stripe order; the DiskManager file header records the file count and
+// extent size. Paths are stored as given, so pass absolute ones.
+//
+// Thread safety: the mapping is immutable after construction; every method
+// may be called concurrently.
+//
+// Usage example:
+//   TablespaceLayout layout{{"/nvme1/orders.db.1", "/nvme2/orders.db.2"}};
+//   DiskManager disk_manager("/nvme0/orders.db", DurabilityMode::BATCHED,
+//                            DEFAULT_SYNC_INTERVAL_MS, IOEngineType::AUTO,
+//                            false, false, layout);
+//   disk_manager.GetStripeCount();  // 3
+
+// Stripe files requested for a new DiskManager file (none: one plain file)
+struct TablespaceLayout {
+  std::vector<std::string> stripe_files;
+  uint32_t extent_pages = DEFAULT_TABLESPACE_EXTENT_PAGES;
+};
+
+class Tablespace {
+ public:
+  // Stripe over primary_fd (file 0) and layout's stripe files. create makes
+  // empty stripe files (replacing old ones) and writes the path list;
+  // otherwise the files the list names are opened and layout.stripe_files
+  // is ignored (extent_pages still applies). Throws std::invalid_argument for
+  // an empty path or zero extent_pages, std::runtime_error if a file cannot
+  // be created, opened or read.
+  Tablespace(const std::string& db_file_name, int primary_fd,
+             const TablespaceLayout& layout, bool create);
+
+  ~Tablespace();
+
+  Tablespace(const Tablespace&) = delete;
+  Tablespace& operator=(const Tablespace&) = delete;
+
+  size_t GetFileCount() const { return stripe_files_.size() + 1; }
+  uint32_t GetExtentPages() const { return extent_pages_; }
+
+  size_t FileOf(page_id_t page_id) const {
+    return (page_id / extent_pages_) % GetFileCount();
+  }
+  off_t OffsetOf(page_id_t page_id) const;
+
+  // Page ids from page_id on that follow it in the same file (its extent)
+  size_t ContiguousPages(page_id_t page_id) const {
+    return extent_pages_ - page_id % extent_pages_;
+  }
+
+  // Buffered descriptor of file n, and its O_DIRECT one (-1 when unused)
+  int GetFileDescriptor(size_t file) const;
+  int GetDirectFileDescriptor(size_t file) const;
+
+  // Open O_DIRECT descriptors for the stripe files next to primary_direct_fd
+  // (file 0's, owned by the caller). Returns false, leaving every stripe
+  // file buffered, if any of them rejects O_DIRECT.
+  bool OpenDirectIO(int primary_direct_fd);
+  void CloseDirectIO();
+
+  // fdatasync every stripe file (not file 0). Returns false on failure.
+  bool SyncStripeFiles() const;
+
+  // Shrink every file to the local pages that ids below next_page_id use
+  // (file 0 included). Returns false if a truncate failed.
+  bool Truncate(page_id_t next_page_id) const;
+
+ private:
+  std::string list_file_name_;
+  int primary_fd_;
+  int primary_direct_fd_;
+  uint32_t extent_pages_;
+  std::vector<std::string> stripe_paths_;
+  std::vector<FileHandle> stripe_files_;
+  std::vector<int> direct_fds_;  // per stripe file, -1 when unused
+
+  void WriteList() const;
+  void ReadList();
+
+  // Local pages of file n holding ids below next_page_id
+  size_t LocalPageCount(size_t file, page_id_t next_page_id) const;
+};
+
+#endif  // STORAGEENGINE_TABLESPACE_H
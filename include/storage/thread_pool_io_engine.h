@@ -0,0 +1,41 @@
+#ifndef STORAGEENGINE_THREAD_POOL_IO_ENGINE_H
+#define STORAGEENGINE_THREAD_POOL_IO_ENGINE_H
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "../common/config.h"
+#include "async_io.h"
+
+// Portable AsyncIOEngine: a fixed set of worker threads drains a queue of
+// requests with blocking pread()/pwrite(). Up to num_workers requests are
+// in flight at once.
+class ThreadPoolIOEngine : public AsyncIOEngine {
+ public:
+  explicit ThreadPoolIOEngine(
+      size_t num_workers = DEFAULT_IO_THREAD_POOL_SIZE);
+  ~ThreadPoolIOEngine() override;
+
+  ThreadPoolIOEngine(const ThreadPoolIOEngine&) = delete;
+  ThreadPoolIOEngine& operator=(const ThreadPoolIOEngine&) = delete;
+
+  std::vector<IOHandle> Submit(std::vector<IORequest> requests) override;
+  const char* GetName() const override { return "thread_pool"; }
+
+ private:
+  using Job = std::pair<IORequest, std::shared_ptr<IOHandle::State>>;
+
+  std::vector<std::thread> workers_;
+  std::deque<Job> queue_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stopping_;
+
+  void WorkerLoop();
+};
+
+#endif  // STORAGEENGINE_THREAD_POOL_IO_ENGINE_H
@@ -0,0 +1,148 @@
+#ifndef STORAGEENGINE_VERSION_CLOCK_H
+#define STORAGEENGINE_VERSION_CLOCK_H
+
+#include <cstdint>
+#include <mutex>
+#include <set>
+#include <string>
+
+#include "../common/config.h"
+#include "../common/types.h"
+
+// Timestamp of a version that has not been superseded or deleted
+constexpr uint64_t VERSION_TS_INFINITY = UINT64_MAX;
+
+// Version flags
+constexpr uint16_t VERSION_PENDING = 0x01;  // update not linked in yet
+
+// Prefix of every tuple version a VersionedTable stores. A version is
+// visible to a snapshot at s if created_ts <= s < deleted_ts.
+#pragma pack(push, 1)
+typedef struct {
+  uint64_t created_ts;    // write that made this version
+  uint64_t deleted_ts;    // write that superseded or deleted it
+  uint32_t home_page_id;  // id the tuple was inserted under, INVALID_PAGE_ID
+  uint16_t home_slot_id;  // while the version still is the home slot
+  uint16_t flags;
+  uint32_t next_page_id;  // newer version, INVALID_PAGE_ID if none
+  uint16_t next_slot_id;
+  uint16_t reserved;
+} TupleVersionHeader;
+#pragma pack(pop)
+
+static_assert(sizeof(TupleVersionHeader) == 32,
+              "TupleVersionHeader must be 32 bytes");
+
+class VersionClock;
+
+// RAII registration of a read timestamp with a VersionClock: while it
+// lives, no version it can see is vacuumed. Move-only.
+class Snapshot {
+ public:
+  Snapshot() = default;
+  ~Snapshot() { Release(); }
+
+  Snapshot(Snapshot&& other) noexcept
+      : clock_(other.clock_), timestamp_(other.timestamp_) {
+    other.clock_ = nullptr;
+  }
+  Snapshot& operator=(Snapshot&& other) noexcept;
+
+  Snapshot(const Snapshot&) = delete;
+  Snapshot& operator=(const Snapshot&) = delete;
+
+  uint64_t GetTimestamp() const { return timestamp_; }
+
+  bool Sees(const TupleVersionHeader& version) const {
+    return version.created_ts <= timestamp_ &&
+           timestamp_ < version.deleted_ts;
+  }
+
+  explicit operator bool() const { return clock_ != nullptr; }
+
+  // Unregister now; the snapshot keeps its timestamp but no longer holds
+  // back vacuuming
+  void Release();
+
+ private:
+  friend class VersionClock;
+
+  Snapshot(VersionClock* clock, uint64_t timestamp)
+      : clock_(clock), timestamp_(timestamp) {}
+
+  VersionClock* clock_ = nullptr;
+  uint64_t timestamp_ = 0;
+};
+
+// VersionClock hands out write timestamps and read snapshots for a
+// VersionedTable.
+//
+// Every write gets the next timestamp from BeginWrite() and stamps the
+// versions it makes with it; EndWrite() ends it. A snapshot reads as of
+// the highest timestamp below every write still in progress, so it sees
+// each write either completely or not at all, and never waits for one.
+//
+// Timestamps must keep growing across restarts, as the stored versions
+// carry them: the clock reserves them in blocks of
+// VERSION_CLOCK_RESERVE_BLOCK, writing and syncing the end of the block to
+// file_name before handing out its first timestamp, and starts at the last
+// reserved one when reopened.
+//
+// Thread safety: all methods may be called concurrently (one mutex).
+//
+// Usage example:
+//   VersionClock clock("data.clock");
+//   uint64_t ts = clock.BeginWrite();
+//   ...  // write versions stamped ts
+//   clock.EndWrite(ts);
+//   Snapshot snapshot = clock.TakeSnapshot();
+class VersionClock {
+ public:
+  // Opens or creates file_name; throws std::runtime_error if it cannot be
+  // opened, read or written, or holds something else
+  explicit VersionClock(const std::string& file_name);
+  ~VersionClock();
+
+  VersionClock(const VersionClock&) = delete;
+  VersionClock& operator=(const VersionClock&) = delete;
+
+  // Start a write; returns its timestamp, or 0 if a new block of
+  // timestamps could not be reserved on disk
+  uint64_t BeginWrite();
+  void EndWrite(uint64_t timestamp);
+
+  // Register a snapshot of every write ended so far (and none in progress)
+  Snapshot TakeSnapshot();
+
+  // Versions deleted at or before this are seen by no registered snapshot,
+  // nor by any snapshot taken from now on
+  uint64_t GetOldestSnapshotTimestamp() const;
+
+  bool IsWriteActive(uint64_t timestamp) const;
+
+  // Latest timestamp handed out
+  uint64_t GetLastTimestamp() const;
+
+  static constexpr uint32_t MAGIC_NUMBER = 0x56434C4B;  // "VCLK"
+
+ private:
+  friend class Snapshot;
+
+  std::string file_name_;
+  int fd_;
+
+  mutable std::mutex mutex_;
+  uint64_t last_timestamp_;
+  uint64_t reserved_timestamp_;         // persisted upper bound
+  std::set<uint64_t> active_writes_;
+  std::multiset<uint64_t> snapshots_;
+
+  // Snapshot timestamp (caller holds mutex_)
+  uint64_t CurrentSnapshotTimestamp() const;
+
+  bool PersistReservation(uint64_t reserved_timestamp);
+
+  void ReleaseSnapshot(uint64_t timestamp);
+};
+
+#endif  // STORAGEENGINE_VERSION_CLOCK_H
@@ -0,0 +1,158 @@
+#ifndef STORAGEENGINE_VERSIONED_TABLE_H
+#define STORAGEENGINE_VERSIONED_TABLE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "../common/config.h"
+#include "../common/types.h"
+#include "page_manager.h"
+#include "table_scan.h"
+#include "version_clock.h"
+
+// VersionedTable keeps multiple versions of each tuple so that readers get
+// consistent snapshots without blocking writers or being blocked by them.
+//
+// Every stored tuple is a version: a TupleVersionHeader followed by the
+// tuple bytes, kept by the PageManager like any other tuple (so pages,
+// the WAL and forwarding apply unchanged). A version is visible to
+// snapshots in [created_ts, deleted_ts) (see VersionClock).
+//
+// Version chains: the TupleId InsertTuple() returns (the home) holds the
+// oldest version; each version points at the next newer one. UpdateTuple
+// stores the new version anywhere, then stamps the newest version's
+// deleted_ts and next pointer, in that order, so a snapshot finds exactly
+// one visible version of a tuple at any moment. DeleteTuple only stamps
+// deleted_ts. Reads walk the chain from the home to the version their
+// snapshot sees; scans (VersionedScan) check each version on its page, so
+// a tuple moved by an update is seen once, in its old or its new version.
+//
+// Vacuum() frees the versions no snapshot can see anymore: the home slot
+// becomes an empty marker version pointing at the oldest version still
+// needed, and fully deleted tuples disappear. Readers that raced a vacuum
+// restart their chain walk from the home.
+//
+// Crash safety: a new version stays flagged VERSION_PENDING (skipped by
+// scans) until the version before it is stamped, so an update interrupted
+// by a crash leaves either the old tuple or the new one visible. Vacuum()
+// frees unlinked pending versions and clears the flag of linked ones.
+//
+// Reads take only shared page latches; writers to tuples in the same lock
+// stripe are serialized (a stripe lock per VERSIONED_TABLE_LOCK_STRIPES),
+// others run in parallel.
+//
+// The PageManager must store nothing but versions, so never attach
+// indexes, a zone map or an overflow store to it: they would see the
+// version headers. Nor set a TupleCompressor: stamping a header must not
+// change a version's size, or the version could move under a scan.
+//
+// Usage example:
+//   VersionClock clock("data.clock");
+//   VersionedTable table(&page_manager, &clock);
+//   TupleId id = table.InsertTuple(data, size);
+//   Snapshot snapshot = table.TakeSnapshot();
+//   table.UpdateTuple(id, new_data, new_size);
+//   table.GetTuple(id, snapshot, &bytes);  // still the old version
+//   VersionedScan scan(&table, snapshot);
+class VersionedTable {
+ public:
+  // Neither is owned; both must outlive the table
+  VersionedTable(PageManager* page_manager, VersionClock* clock);
+
+  // Returns {0, INVALID_SLOT_ID} on failure
+  TupleId InsertTuple(const char* tuple_data, uint16_t tuple_size);
+
+  ErrorCode UpdateTuple(TupleId tuple_id, const char* new_data,
+                        uint16_t new_size);
+  ErrorCode DeleteTuple(TupleId tuple_id);
+
+  Snapshot TakeSnapshot() const { return clock_->TakeSnapshot(); }
+
+  // Copy the bytes of the version of tuple_id that snapshot sees into *out
+  ErrorCode GetTuple(TupleId tuple_id, const Snapshot& snapshot,
+                     std::vector<char>* out) const;
+
+  // Same, as of a snapshot taken now
+  ErrorCode GetTuple(TupleId tuple_id, std::vector<char>* out) const;
+
+  // Free the versions that no snapshot can see anymore (see above), one
+  // chain at a time, alongside foreground operations. Returns the number
+  // of versions freed.
+  size_t Vacuum();
+
+  PageManager* GetPageManager() const { return page_manager_; }
+  VersionClock* GetClock() const { return clock_; }
+
+  // Largest tuple InsertTuple/UpdateTuple accept
+  static constexpr uint16_t MAX_TUPLE_SIZE =
+      PAGE_SIZE - sizeof(PageHeader) - SLOT_ENTRY_SIZE -
+      sizeof(TupleVersionHeader);
+
+ private:
+  // One version of a chain: where it is stored, its physical slot and its
+  // header
+  struct Version {
+    TupleId tuple_id;
+    TupleId physical_id;
+    TupleVersionHeader header;
+  };
+
+  PageManager* page_manager_;
+  VersionClock* clock_;
+  std::array<std::mutex, VERSIONED_TABLE_LOCK_STRIPES> write_locks_;
+  std::mutex vacuum_mutex_;
+
+  std::mutex& WriteLock(TupleId home);
+
+  // Read the version stored at tuple_id (header, and the tuple bytes if
+  // data is non-null)
+  ErrorCode ReadVersion(TupleId tuple_id, Version* version,
+                        std::vector<char>* data) const;
+
+  // Walk the chain from home to the version snapshot_ts sees (to the
+  // newest one for VERSION_TS_INFINITY), recording it in *version and, if
+  // chain is non-null, every version passed in *chain. Restarts when the
+  // chain changes underneath.
+  ErrorCode FindVersion(TupleId home, uint64_t snapshot_ts, Version* version,
+                        std::vector<Version>* chain = nullptr) const;
+
+  // Rewrite the version's header in place
+  ErrorCode WriteHeader(const Version& version);
+
+  // Vacuum one chain (caller holds its write lock)
+  size_t VacuumChain(TupleId home, uint64_t oldest_ts);
+};
+
+// VersionedScan yields the tuples of a VersionedTable as of a snapshot,
+// streaming pages through a TableScan: each version is checked on its page,
+// so the scan never follows chains. TupleView::tuple_id is the id the tuple
+// was inserted under; data and size exclude the version header.
+//
+// Usage example:
+//   Snapshot snapshot = table.TakeSnapshot();
+//   VersionedScan scan(&table, snapshot);
+//   TupleView tuple;
+//   while (scan.Next(&tuple)) {
+//     Consume(tuple.data, tuple.size);
+//   }
+class VersionedScan {
+ public:
+  // table and snapshot must outlive the scan
+  VersionedScan(const VersionedTable* table, const Snapshot& snapshot,
+                size_t read_ahead_pages = DEFAULT_SCAN_READ_AHEAD_PAGES);
+
+  bool Next(TupleView* tuple);
+
+  // Versions passed over because the snapshot does not see them
+  size_t GetVersionsSkipped() const { return versions_skipped_; }
+
+ private:
+  TableScan scan_;
+  const Snapshot& snapshot_;
+  size_t versions_skipped_;
+};
+
+#endif  // STORAGEENGINE_VERSIONED_TABLE_H
@@ -0,0 +1,167 @@
+#ifndef STORAGEENGINE_ZONE_MAP_H
+#define STORAGEENGINE_ZONE_MAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "../common/config.h"
+#include "../common/types.h"
+#include "../schema/schema.h"
+#include "../tuple/scan_predicate.h"
+
+// What a zone map knows about one column of one page
+struct ZoneSummary {
+  uint32_t row_count;   // tuples on the page
+  uint32_t null_count;  // of them NULL in this column
+  bool has_values;      // some non-NULL value was seen
+  // Integer and BOOLEAN columns
+  int64_t min_int;
+  int64_t max_int;
+  // FLOAT and DOUBLE columns (a NaN widens them to -inf, +inf)
+  double min_double;
+  double max_double;
+};
+
+// ZoneMap keeps a small summary per data page for a chosen set of columns
+// (min/max, null count and, optionally, a bloom filter), so that scans with
+// a ScanPredicate can skip whole pages without reading them. Like the FSM
+// it lives in its own side file next to the table and is kept up to date by
+// the PageManager (see PageManager::SetZoneMap()).
+//
+// Summaries are conservative: inserts widen min/max and set bloom bits,
+// deletes only count down, so a summary may cover values no longer on the
+// page but never misses one that is. PageManager::RebuildZoneMap() tightens
+// them again. Row and null counts are statistics; pruning never uses them.
+//
+// A page is tracked once its summary is known to cover every tuple on it.
+// Untracked pages (written before the map was attached, by the BulkLoader,
+// or before a crash) always may match; the PageManager summarizes such a
+// page from its contents the next time it writes a tuple to it.
+//
+// Pruning (MayMatch()): a condition on a summarized column rules a page
+// out when the column is NULL in every tuple, when no range of the
+// condition overlaps [min, max] (NE: the one value is both min and max),
+// or, for EQ/IN with a bloom filter, when no value is in the filter.
+// String columns have no min/max: only EQ/IN with a bloom filter (and
+// all-NULL pages) prune. Out-of-line values fill the page's filter, since
+// they are not read.
+//
+// File format:
+//   - Header (HEADER_SIZE bytes): magic, clean flag, column count, bloom
+//     bits, entry count, then (field index, type) of each column
+//   - One fixed-size entry per page id (entry 0 unused): tracked flag, row
+//     count, then per column the null count, a has-values flag, min, max and
+//     the bloom filter
+// The whole map is held in memory; Flush() writes back the entries changed
+// since the last flush. Every change is bracketed by BeginChange() and
+// EndChange(): the first change after a flush marks the file unclean on
+// disk before any page changes, and Flush() marks it clean again when no
+// change is in progress. A file that is unclean, or was built for other
+// columns, is discarded on open and every page starts untracked.
+//
+// Thread safety: all methods may be called concurrently (one mutex).
+//
+// Usage example:
+//   ZoneMap zone_map("data.zmap", schema, {"created_at", "region"}, 256);
+//   page_manager.SetZoneMap(&zone_map);
+//   page_manager.RebuildZoneMap();  // existing pages
+//   ScanPredicate predicate(schema);
+//   predicate.Compare("created_at", CompareOp::GE, FieldValue::BigInt(t));
+//   TableScan scan(&page_manager);
+//   scan.SetPredicate(&predicate);  // skips pages the zone map rules out
+class ZoneMap {
+ public:
+  // Summarize columns of tuples laid out by schema, with a bloom filter of
+  // bloom_bits bits (a multiple of 64, at most ZONE_MAP_MAX_BLOOM_BITS; 0
+  // for none) per column and page. Opens or creates file_name. Throws
+  // std::invalid_argument for an unfinalized schema, an unknown or BLOB
+  // column, too many columns (ZONE_MAP_MAX_COLUMNS) or a bad bloom size,
+  // and std::runtime_error if the file cannot be opened or read.
+  ZoneMap(const std::string& file_name, const Schema& schema,
+          const std::vector<std::string>& columns, size_t bloom_bits = 0);
+
+  // Flushes
+  ~ZoneMap();
+
+  ZoneMap(const ZoneMap&) = delete;
+  ZoneMap& operator=(const ZoneMap&) = delete;
+
+  // Bracket a change to tuples on summarized pages (the PageManager calls
+  // these). BeginChange() returns false, and the change must not be made,
+  // if the file cannot be marked unclean; only a successful BeginChange()
+  // is paired with EndChange().
+  bool BeginChange();
+  void EndChange();
+
+  // Widen the page's summary with a tuple just stored on it. Returns false,
+  // recording nothing, if the page is not tracked.
+  bool AddTuple(page_id_t page_id, const char* tuple, uint16_t size);
+
+  // Count down a tuple removed from the page (no-op if untracked)
+  void RemoveTuple(page_id_t page_id, const char* tuple, uint16_t size);
+
+  // Replace the page's summary with one of exactly these tuples and mark
+  // it tracked
+  void ResetPage(page_id_t page_id, const TupleSlice* tuples, size_t count);
+
+  bool IsTracked(page_id_t page_id) const;
+
+  // False if no tuple on the page can match predicate (built on the same
+  // schema); true for untracked pages
+  bool MayMatch(page_id_t page_id, const ScanPredicate& predicate) const;
+
+  // Summary of column on the page; false if the page is untracked or the
+  // column is not summarized
+  bool GetSummary(page_id_t page_id, const std::string& column,
+                  ZoneSummary* summary) const;
+
+  size_t GetColumnCount() const { return columns_.size(); }
+  size_t GetTrackedPageCount() const;
+
+  // Write changed entries and, unless a change is in progress, mark the
+  // file clean. Returns false on I/O failure.
+  bool Flush();
+
+  static constexpr uint32_t MAGIC_NUMBER = 0x5A4D5031;  // "ZMP1"
+  static constexpr size_t HEADER_SIZE = 128;
+
+ private:
+  struct Column {
+    std::string name;
+    FieldLayout field;
+  };
+
+  std::string file_name_;
+  int fd_;
+  Schema schema_;
+  size_t min_tuple_size_;
+  std::vector<Column> columns_;
+  size_t bloom_bytes_;  // per column
+  size_t column_bytes_;
+  size_t entry_size_;
+
+  mutable std::mutex mutex_;
+  std::vector<char> entries_;  // entry_size_ bytes per page id
+  std::vector<bool> dirty_;    // per page id, since the last flush
+  size_t tracked_pages_;
+  size_t active_changes_;
+  bool clean_on_disk_;
+
+  // Load a matching clean file, or start over with an empty one
+  void Load();
+  bool WriteHeader(bool clean);
+
+  // Entry of page_id, growing the map if needed (caller holds mutex_)
+  char* MutableEntry(page_id_t page_id);
+  const char* Entry(page_id_t page_id) const;
+
+  // Count the tuple into (sign 1) or out of (sign -1) entry; values only
+  // widen. Tuples too short for the schema count as rows without values.
+  void Summarize(char* entry, const char* tuple, uint16_t size,
+                 int sign) const;
+};
+
+#endif  // STORAGEENGINE_ZONE_MAP_H
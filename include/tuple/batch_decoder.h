@@ -0,0 +1,146 @@
+#ifndef STORAGEENGINE_BATCH_DECODER_H
+#define STORAGEENGINE_BATCH_DECODER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "../common/types.h"
+#include "../schema/schema.h"
+#include "overflow_value.h"
+
+// Decoded values of one column for a batch of tuples.
+//
+// Fixed-length columns hold one value per row in a contiguous array, in the
+// same representation as the tuple format: Data<int32_t>() for INTEGER,
+// Data<int64_t>() for BIGINT, Data<double>() for DOUBLE, Data<bool>() for
+// BOOLEAN and so on; CHAR(n) values are GetWidth() NUL-padded bytes each.
+// The value of a NULL row is zero.
+//
+// Variable-length columns (VARCHAR, TEXT, BLOB) hold their bytes back to
+// back: row r is [GetOffsets()[r], GetOffsets()[r + 1]) of GetBytes(). A
+// NULL row is empty. Dictionary-encoded columns, CHAR ones included, are
+// decoded into this form too.
+//
+// Validity is a bitmap with bit r % 64 of word r / 64 set if row r is not
+// NULL; words past the last row are zero.
+class ColumnVector {
+ public:
+  ColumnVector(DataType type, uint32_t width);
+
+  DataType GetType() const { return type_; }
+  // Bytes per value; 0 for variable-length columns
+  uint32_t GetWidth() const { return width_; }
+  size_t GetRowCount() const { return rows_; }
+  size_t GetNullCount() const { return null_count_; }
+
+  template <typename T>
+  const T* Data() const {
+    return reinterpret_cast<const T*>(values_.data());
+  }
+  const char* GetRawData() const { return values_.data(); }
+
+  const uint32_t* GetOffsets() const { return offsets_.data(); }
+  const char* GetBytes() const { return values_.data(); }
+
+  const uint64_t* GetValidity() const { return validity_.data(); }
+  bool IsValid(size_t row) const {
+    return (validity_[row / 64] >> (row % 64)) & 1;
+  }
+
+  // String or blob value of row r (CHAR without its padding)
+  std::string_view GetString(size_t row) const;
+
+  // Drop all rows, keeping the buffers' capacity
+  void Clear();
+
+ private:
+  friend class BatchDecoder;
+
+  DataType type_;
+  uint32_t width_;
+  size_t rows_;
+  size_t null_count_;
+  std::vector<char> values_;
+  std::vector<uint32_t> offsets_;  // variable-length columns: rows_ + 1
+  std::vector<uint64_t> validity_;
+};
+
+// A batch of decoded rows: one ColumnVector per projected column, in
+// projection order
+class ColumnBatch {
+ public:
+  size_t GetRowCount() const { return rows_; }
+  size_t GetColumnCount() const { return columns_.size(); }
+  const ColumnVector& GetColumn(size_t index) const { return columns_[index]; }
+
+  // Drop all rows, keeping the columns and their capacity
+  void Clear();
+
+ private:
+  friend class BatchDecoder;
+
+  size_t rows_ = 0;
+  std::vector<ColumnVector> columns_;
+};
+
+// Decodes batches of serialized tuples (either format) into ColumnBatches,
+// column at a time. Where TupleSerializer switches on each field's type for
+// every row, the decoder picks one loop per projected column and runs it
+// over the whole batch: fixed-length columns are a strided copy with a
+// compile-time width, so the per-row work is one load and one store.
+// Columns outside the projection are never read.
+//
+// Out-of-line values (see overflow_value.h) are read from overflow; without
+// it they throw. Malformed tuples throw std::runtime_error, like
+// TupleSerializer::Deserialize(); the batch is then left with the rows
+// decoded by earlier calls.
+//
+// A decoder keeps per-batch scratch space, so one instance must not be used
+// by several threads at once.
+//
+// Usage example:
+//   BatchDecoder decoder(schema, {schema.GetColumn("bytes").GetFieldIndex()});
+//   ColumnBatch batch;
+//   std::vector<TupleSlice> tuples;
+//   while (scan.NextPage(&tuples)) {
+//     batch.Clear();
+//     decoder.Decode(tuples, &batch);
+//     Sum(batch.GetColumn(0).Data<int32_t>(), batch.GetRowCount());
+//   }
+class BatchDecoder {
+ public:
+  // projection lists field indexes, in the order the batch's columns will
+  // have. schema (and overflow) must outlive the decoder. Throws
+  // std::invalid_argument if the schema is not finalized or an index is out
+  // of range.
+  BatchDecoder(const Schema& schema, std::vector<size_t> projection,
+               const OverflowValueStore* overflow = nullptr);
+
+  // Append the tuples' projected fields to batch. An empty batch (no
+  // columns) gets this decoder's columns; any other batch must have them
+  // (std::invalid_argument otherwise).
+  void Decode(const TupleSlice* tuples, size_t count, ColumnBatch* batch);
+  void Decode(const std::vector<TupleSlice>& tuples, ColumnBatch* batch) {
+    Decode(tuples.data(), tuples.size(), batch);
+  }
+
+  const std::vector<size_t>& GetProjection() const { return projection_; }
+
+ private:
+  const Schema& schema_;
+  std::vector<size_t> projection_;
+  const OverflowValueStore* overflow_;
+
+  void PrepareBatch(ColumnBatch* batch) const;
+
+  void DecodeFixed(const FieldLayout& field, const TupleSlice* tuples,
+                   size_t count, ColumnVector* column) const;
+  void DecodeVariable(const FieldLayout& field, const TupleSlice* tuples,
+                      size_t count, ColumnVector* column) const;
+  void DecodeDictionary(const FieldLayout& field, const TupleSlice* tuples,
+                        size_t count, ColumnVector* column) const;
+};
+
+#endif  // STORAGEENGINE_BATCH_DECODER_H
@@ -0,0 +1,198 @@
+#ifndef STORAGEENGINE_FIXED_TUPLE_CODEC_H
+#define STORAGEENGINE_FIXED_TUPLE_CODEC_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+#include <tuple>
+#include <utility>
+
+#include "../schema/alignment.h"
+#include "../schema/schema.h"
+#include "tuple_header.h"
+
+// CHAR(N) column value for FixedTupleCodec: N bytes, NUL-padded, exactly as
+// TupleSerializer stores it
+template <size_t N>
+struct FixedChar {
+  char data[N];
+
+  // Throws std::invalid_argument if value is longer than N bytes
+  static FixedChar From(std::string_view value) {
+    if (value.size() > N) {
+      throw std::invalid_argument("CHAR value exceeds fixed size");
+    }
+    FixedChar result{};
+    std::memcpy(result.data, value.data(), value.size());
+    return result;
+  }
+
+  // Value up to the first NUL padding byte
+  std::string_view View() const {
+    const void* nul = std::memchr(data, '\0', N);
+    size_t length =
+        nul == nullptr ? N : static_cast<const char*>(nul) - data;
+    return std::string_view(data, length);
+  }
+};
+
+// Maps a C++ column type to its DataType. Types without a specialization
+// are rejected at compile time.
+template <typename T>
+struct FixedColumnTraits;
+
+template <>
+struct FixedColumnTraits<bool> {
+  static constexpr DataType TYPE = BOOLEAN;
+};
+template <>
+struct FixedColumnTraits<int8_t> {
+  static constexpr DataType TYPE = TINYINT;
+};
+template <>
+struct FixedColumnTraits<int16_t> {
+  static constexpr DataType TYPE = SMALLINT;
+};
+template <>
+struct FixedColumnTraits<int32_t> {
+  static constexpr DataType TYPE = INTEGER;
+};
+template <>
+struct FixedColumnTraits<int64_t> {
+  static constexpr DataType TYPE = BIGINT;
+};
+template <>
+struct FixedColumnTraits<float> {
+  static constexpr DataType TYPE = FLOAT;
+};
+template <>
+struct FixedColumnTraits<double> {
+  static constexpr DataType TYPE = DOUBLE;
+};
+template <size_t N>
+struct FixedColumnTraits<FixedChar<N>> {
+  static_assert(sizeof(FixedChar<N>) == N, "FixedChar must not be padded");
+  static constexpr DataType TYPE = CHAR;
+};
+
+namespace codec_detail {
+
+// Same walk as Schema::Finalize(): fixed fields follow the header in column
+// order, each aligned per alignment::CalculateAlignment
+template <size_t N>
+constexpr std::array<size_t, N> ComputeOffsets(
+    const std::array<DataType, N>& types, const std::array<size_t, N>& sizes,
+    size_t header_size) {
+  std::array<size_t, N> offsets{};
+  size_t offset = header_size;
+  for (size_t i = 0; i < N; i++) {
+    size_t align = alignment::CalculateAlignment(types[i]);
+    offset = (offset + align - 1) / align * align;
+    offsets[i] = offset;
+    offset += sizes[i];
+  }
+  return offsets;
+}
+
+}  // namespace codec_detail
+
+// Compile-time codec for all-fixed-length tuples.
+//
+// The layout (offsets, padding, tuple size) is computed as constexpr from
+// the column types, so Encode()/Decode() are a fixed sequence of memcpys
+// with no per-field branches and no FieldValue. Rows are byte-compatible
+// with TupleSerializer::SerializeFixedLength for a schema with the same
+// column types in the same order; MatchesSchema() checks that at runtime.
+//
+// Compiled rows never contain NULLs (the bitmap is written as zero). Rows
+// written by the runtime path may; check IsNull<I>() before trusting a
+// field, whose bytes read as zero when NULL.
+//
+// Usage example:
+//   using UserCodec = FixedTupleCodec<int32_t, double, FixedChar<8>>;
+//   char buffer[UserCodec::TUPLE_SIZE];
+//   UserCodec::Encode({42, 98.6, FixedChar<8>::From("alice")}, buffer);
+//   auto [id, score, name] = UserCodec::Decode(buffer);
+template <typename... Columns>
+class FixedTupleCodec {
+ public:
+  using Row = std::tuple<Columns...>;
+
+  static constexpr size_t COLUMN_COUNT = sizeof...(Columns);
+  static_assert(COLUMN_COUNT > 0, "FixedTupleCodec needs at least one column");
+  static_assert(COLUMN_COUNT <= TUPLE_MAX_FIELDS,
+                "Schemas hold at most TUPLE_MAX_FIELDS columns");
+
+  // TupleHeader with no variable-length slots: just the null bitmap
+  static constexpr size_t HEADER_SIZE =
+      TupleHeader::CalculateNullBitmapSize(COLUMN_COUNT);
+
+  static constexpr std::array<DataType, COLUMN_COUNT> TYPES = {
+      FixedColumnTraits<Columns>::TYPE...};
+  static constexpr std::array<size_t, COLUMN_COUNT> SIZES = {
+      sizeof(Columns)...};
+  static constexpr std::array<size_t, COLUMN_COUNT> OFFSETS =
+      codec_detail::ComputeOffsets(TYPES, SIZES, HEADER_SIZE);
+  static constexpr size_t TUPLE_SIZE =
+      OFFSETS[COLUMN_COUNT - 1] + SIZES[COLUMN_COUNT - 1];
+
+  // buffer must hold TUPLE_SIZE bytes. Returns TUPLE_SIZE.
+  static size_t Encode(const Row& row, char* buffer) {
+    // Zeroes the null bitmap and padding, like the runtime serializer
+    std::memset(buffer, 0, TUPLE_SIZE);
+    EncodeFields(row, buffer, std::index_sequence_for<Columns...>{});
+    return TUPLE_SIZE;
+  }
+
+  // buffer must hold TUPLE_SIZE bytes
+  static void Decode(const char* buffer, Row* row) {
+    DecodeFields(buffer, row, std::index_sequence_for<Columns...>{});
+  }
+
+  static Row Decode(const char* buffer) {
+    Row row;
+    Decode(buffer, &row);
+    return row;
+  }
+
+  template <size_t I>
+  static bool IsNull(const char* buffer) {
+    static_assert(I < COLUMN_COUNT, "Field index out of bounds");
+    return TupleHeader::IsNullBitSet(buffer, I);
+  }
+
+  // True if schema serializes to exactly this codec's layout
+  static bool MatchesSchema(const Schema& schema) {
+    if (!schema.IsFinalized() || !schema.IsFixedLength() ||
+        schema.GetColumnCount() != COLUMN_COUNT ||
+        schema.GetTupleHeaderSize() != HEADER_SIZE) {
+      return false;
+    }
+    const std::vector<FieldLayout>& layout = schema.GetLayout();
+    for (size_t i = 0; i < COLUMN_COUNT; i++) {
+      if (layout[i].type != TYPES[i] || layout[i].offset != OFFSETS[i] ||
+          layout[i].size != SIZES[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+ private:
+  template <size_t... I>
+  static void EncodeFields(const Row& row, char* buffer,
+                           std::index_sequence<I...>) {
+    (std::memcpy(buffer + OFFSETS[I], &std::get<I>(row), SIZES[I]), ...);
+  }
+
+  template <size_t... I>
+  static void DecodeFields(const char* buffer, Row* row,
+                           std::index_sequence<I...>) {
+    (std::memcpy(&std::get<I>(*row), buffer + OFFSETS[I], SIZES[I]), ...);
+  }
+};
+
+#endif  // STORAGEENGINE_FIXED_TUPLE_CODEC_H
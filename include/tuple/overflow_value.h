@@ -0,0 +1,62 @@
+#ifndef STORAGEENGINE_OVERFLOW_VALUE_H
+#define STORAGEENGINE_OVERFLOW_VALUE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "../common/config.h"
+#include "../common/types.h"
+
+// Out-of-line (TOAST-style) storage for large variable-length values.
+//
+// A serialized variable-length field is normally [2-byte length][bytes].
+// A value stored out of line has OVERFLOW_VALUE_MARKER as its length,
+// followed by an OverflowPointer naming the chain of pages that holds the
+// bytes. No inline value can be that long, since tuple offsets are 16-bit.
+//
+// TupleSerializer moves values longer than OVERFLOW_VALUE_THRESHOLD into an
+// OverflowValueStore when it is given one; TupleAccessor reads them back
+// through the store on first access, so scans that skip the column never
+// touch the overflow pages.
+
+#pragma pack(push, 1)
+typedef struct OverflowPointer {
+  uint32_t first_page_id;  // first page of the chain
+  uint32_t length;         // value bytes
+
+  bool operator==(const OverflowPointer& other) const {
+    return first_page_id == other.first_page_id && length == other.length;
+  }
+  bool operator!=(const OverflowPointer& other) const {
+    return !(*this == other);
+  }
+} OverflowPointer;
+#pragma pack(pop)
+
+static_assert(sizeof(OverflowPointer) == 8, "OverflowPointer must be 8 bytes");
+
+constexpr uint16_t OVERFLOW_VALUE_MARKER = 0xFFFF;
+
+// Bytes an out-of-line value takes in the tuple: marker + pointer
+constexpr size_t OVERFLOW_FIELD_SIZE =
+    sizeof(uint16_t) + sizeof(OverflowPointer);
+
+// Where out-of-line values live (see OverflowStore)
+class OverflowValueStore {
+ public:
+  virtual ~OverflowValueStore() = default;
+
+  // Store value; *pointer receives its location
+  virtual ErrorCode Write(std::string_view value, OverflowPointer* pointer) = 0;
+
+  // Replace *value with the bytes pointer refers to
+  virtual ErrorCode Read(const OverflowPointer& pointer,
+                         std::string* value) const = 0;
+
+  // Release the value's pages; the pointer must not be used again
+  virtual ErrorCode Free(const OverflowPointer& pointer) = 0;
+};
+
+#endif  // STORAGEENGINE_OVERFLOW_VALUE_H
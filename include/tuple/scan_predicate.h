@@ -0,0 +1,128 @@
+#ifndef STORAGEENGINE_SCAN_PREDICATE_H
+#define STORAGEENGINE_SCAN_PREDICATE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../common/types.h"
+#include "../schema/schema.h"
+#include "field_value.h"
+#include "overflow_value.h"
+
+enum class CompareOp { EQ, NE, LT, LE, GT, GE };
+
+// A conjunction of simple conditions evaluated directly on serialized
+// tuples, so scans can drop non-matching tuples before decoding or copying
+// them (see TableScan::SetPredicate()).
+//
+// Conditions:
+//   - Compare / Between / In on fixed-width numeric and BOOLEAN columns.
+//     Integer columns take integer literals; FLOAT and DOUBLE columns take
+//     any numeric literal. Every condition is turned into one or more
+//     inclusive ranges (In: one per value).
+//   - Compare (EQ, NE only) and In on CHAR, VARCHAR and TEXT columns,
+//     and Prefix on the same columns. CHAR values compare without their
+//     NUL padding. On a dictionary-encoded column, Compare and In whose
+//     values all have codes when the condition is added compare the
+//     tuples' codes with the integer kernels below instead of strings.
+// A NULL field fails every condition, NE included.
+//
+// Filter() works on blocks of 64 tuples: each numeric column is gathered
+// from the tuples' fixed offsets into a small array and compared with SIMD
+// kernels (AVX2 when the CPU has it), giving one bit per tuple; the
+// conditions' bitmasks are ANDed and string conditions only look at the
+// tuples still selected. Out-of-line values (see overflow_value.h) are read
+// through overflow if given, and otherwise never match.
+//
+// A predicate copies what it needs from the schema and is immutable once
+// built, so it may be shared by concurrent scans.
+//
+// Usage example:
+//   ScanPredicate predicate(schema);
+//   predicate.Between("amount", FieldValue::BigInt(100),
+//                     FieldValue::BigInt(200))
+//       .Prefix("region", "eu-");
+//   scan.SetPredicate(&predicate);
+class ScanPredicate {
+ public:
+  // overflow, if given, must outlive the predicate
+  explicit ScanPredicate(const Schema& schema,
+                         const OverflowValueStore* overflow = nullptr);
+
+  // Add a condition. Throws std::invalid_argument for an unknown column, a
+  // BLOB column, a NULL literal or a literal of the wrong kind, and for
+  // ordering comparisons on strings.
+  ScanPredicate& Compare(const std::string& column, CompareOp op,
+                         const FieldValue& value);
+  // low <= value <= high
+  ScanPredicate& Between(const std::string& column, const FieldValue& low,
+                         const FieldValue& high);
+  ScanPredicate& In(const std::string& column,
+                    const std::vector<FieldValue>& values);
+  ScanPredicate& Prefix(const std::string& column, const std::string& prefix);
+
+  size_t GetConditionCount() const { return conditions_.size(); }
+
+  // Replace *selection with the indexes of the matching tuples, ascending.
+  // Tuples too short for the schema's fixed section never match.
+  void Filter(const TupleSlice* tuples, size_t count,
+              std::vector<uint32_t>* selection) const;
+
+  bool Matches(const char* tuple, size_t size) const;
+
+  // Conditions as built, for structures that prune with them (see
+  // ZoneMap::MayMatch()). INT32 and INT64 conditions hold int_ranges,
+  // DOUBLE ones double_ranges, STRING ones the value set and PREFIX ones
+  // the prefix; negate is set for NE. A STRING condition with by_code set
+  // also holds its values' dictionary codes in int_ranges.
+  enum class Kind { INT32, INT64, DOUBLE, STRING, PREFIX };
+
+  struct IntRange {
+    int64_t low;
+    int64_t high;
+  };
+  struct DoubleRange {
+    double low;
+    double high;
+  };
+
+  struct Condition {
+    Kind kind;
+    FieldLayout field;
+    bool negate;   // match tuples outside the ranges / value set
+    bool by_code;  // STRING: evaluated on dictionary codes
+    std::vector<IntRange> int_ranges;
+    std::vector<DoubleRange> double_ranges;
+    std::vector<std::string> strings;  // equal to one of, or the prefix
+  };
+
+  const std::vector<Condition>& GetConditions() const { return conditions_; }
+
+ private:
+  Schema schema_;
+  const OverflowValueStore* overflow_;
+  size_t min_tuple_size_;
+  std::vector<char> zeros_;  // stands in for tuples that are too short
+  std::vector<Condition> conditions_;
+
+  // Empty condition on column; throws std::invalid_argument as above
+  Condition NewCondition(const std::string& column) const;
+
+  // Append the range of values satisfying "value op literal"
+  static void AddRange(Condition* condition, CompareOp op,
+                       const FieldValue& literal);
+  static void AddString(Condition* condition, const FieldValue& literal);
+  // Switch a STRING condition on a dictionary-encoded column to codes
+  static void EncodeStrings(Condition* condition);
+
+  // Bit i set: tuple i of the block (count <= 64) satisfies condition.
+  // candidates limits the tuples string conditions look at.
+  uint64_t Evaluate(const Condition& condition, const TupleSlice* tuples,
+                    size_t count, uint64_t candidates) const;
+  bool MatchesString(const Condition& condition, const char* tuple,
+                     size_t size) const;
+};
+
+#endif  // STORAGEENGINE_SCAN_PREDICATE_H
@@ -1,16 +1,41 @@
 #ifndef STORAGEENGINE_TUPLE_ACCESSOR_H
 #define STORAGEENGINE_TUPLE_ACCESSOR_H
 
+#include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "../schema/schema.h"
 #include "field_value.h"
-#include "tuple_header.h"
+#include "overflow_value.h"
 
+// Read-only view over one serialized tuple.
+//
+// Fields are decoded on demand, straight from the buffer: fixed-length
+// fields through the offsets Schema::Finalize() precomputed, variable-length
+// fields through the tuple header's offset array. Reading one column never
+// touches the others, and the view getters never allocate.
+//
+// Values stored out of line (see overflow_value.h) are read from the
+// OverflowValueStore the first time their field is accessed and kept for
+// the accessor's lifetime, so only the columns a caller reads cost overflow
+// page fetches. Without a store, reading such a field throws.
+//
+// The buffer must stay valid (and unchanged) for the accessor's lifetime;
+// string views returned by GetStringView()/GetBlobView() point into it (or
+// into the accessor's copy of an out-of-line value).
+//
+// Dictionary-encoded columns (ColumnEncoding::DICTIONARY) read like plain
+// ones: the stored code is decoded through the schema's dictionary, and
+// string views point into the dictionary.
+//
+// By-name getters look the column up on every call; code reading many
+// tuples should resolve ColumnHandles once and use those overloads.
 class TupleAccessor {
  public:
-  TupleAccessor(const Schema& schema, const char* buffer, size_t buffer_size);
+  TupleAccessor(const Schema& schema, const char* buffer, size_t buffer_size,
+                const OverflowValueStore* overflow = nullptr);
 
   TupleAccessor(const TupleAccessor&) = delete;
   TupleAccessor& operator=(const TupleAccessor&) = delete;
@@ -20,6 +45,9 @@ class TupleAccessor {
   bool IsNull(const std::string& column_name) const;
   bool IsNull(size_t field_index) const;
 
+  // Non-null variable-length field kept in overflow pages
+  bool IsStoredOutOfLine(size_t field_index) const;
+
   bool GetBoolean(const std::string& column_name) const;
   int8_t GetTinyInt(const std::string& column_name) const;
   int16_t GetSmallInt(const std::string& column_name) const;
@@ -40,22 +68,62 @@ class TupleAccessor {
   std::string GetString(size_t field_index) const;
   std::vector<uint8_t> GetBlob(size_t field_index) const;
 
+  // Zero-copy getters. CHAR/VARCHAR/TEXT for strings (CHAR stops at the
+  // first NUL padding byte), BLOB for raw bytes.
+  std::string_view GetStringView(const std::string& column_name) const;
+  std::string_view GetStringView(size_t field_index) const;
+  std::string_view GetBlobView(const std::string& column_name) const;
+  std::string_view GetBlobView(size_t field_index) const;
+
   FieldValue GetFieldValue(const std::string& column_name) const;
   FieldValue GetFieldValue(size_t field_index) const;
 
+  // Columns resolved up front (Schema::ResolveColumn()): no name lookup
+  bool IsNull(const ColumnHandle& column) const;
+  bool GetBoolean(const ColumnHandle& column) const;
+  int8_t GetTinyInt(const ColumnHandle& column) const;
+  int16_t GetSmallInt(const ColumnHandle& column) const;
+  int32_t GetInteger(const ColumnHandle& column) const;
+  int64_t GetBigInt(const ColumnHandle& column) const;
+  float GetFloat(const ColumnHandle& column) const;
+  double GetDouble(const ColumnHandle& column) const;
+  std::string GetString(const ColumnHandle& column) const;
+  std::vector<uint8_t> GetBlob(const ColumnHandle& column) const;
+  std::string_view GetStringView(const ColumnHandle& column) const;
+  std::string_view GetBlobView(const ColumnHandle& column) const;
+  FieldValue GetFieldValue(const ColumnHandle& column) const;
+
  private:
   const Schema& schema_;
   const char* buffer_;
   size_t buffer_size_;
-  TupleHeader header_;
-  mutable std::vector<FieldValue> cached_values_;
-  mutable bool is_deserialized_;
-
-  void EnsureDeserialized() const;
-  void ValidateColumnName(const std::string& name,
-                          DataType expected_type) const;
-  void ValidateFieldIndex(size_t index, DataType expected_type) const;
+  const OverflowValueStore* overflow_;
+  // Out-of-line values read so far, by variable field index
+  mutable std::vector<std::unique_ptr<std::string>> fetched_;
+
+  const FieldLayout& ValidateFieldIndex(size_t index) const;
+  const FieldLayout& ValidateHandle(const ColumnHandle& column) const;
   size_t GetFieldIndex(const std::string& column_name) const;
+
+  bool IsFieldNull(const FieldLayout& field) const;
+  // Throws if the field is NULL, so callers can read it unconditionally
+  void CheckNotNull(const FieldLayout& field) const;
+
+  // Readers below check the field's type, not its index
+  template <typename T>
+  T ReadFixed(const FieldLayout& field, DataType expected_type) const;
+
+  // Offset of a non-null variable-length field's length prefix
+  size_t VariableOffset(const FieldLayout& field) const;
+
+  // Bytes of a non-null variable-length field (length prefix stripped),
+  // fetching an out-of-line value on first use
+  std::string_view ReadVariable(const FieldLayout& field) const;
+  std::string_view FetchOutOfLine(const FieldLayout& field,
+                                  size_t offset) const;
+  std::string_view ReadString(const FieldLayout& field) const;
+  std::string_view ReadBlob(const FieldLayout& field) const;
+  FieldValue ReadFieldValue(const FieldLayout& field) const;
 };
 
 #endif
@@ -1,13 +1,25 @@
 #ifndef STORAGEENGINE_TUPLE_BUILDER_H
 #define STORAGEENGINE_TUPLE_BUILDER_H
 
-#include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "../common/arena.h"
 #include "../schema/schema.h"
 #include "field_value.h"
+#include "value_ref.h"
 
+// Collects one tuple's values. Values are kept as ValueRef with string and
+// blob bytes copied into the builder's own Arena, so a builder reused via
+// Reset() stops allocating once its arena has grown to fit a tuple.
+//
+// Build() returns owning FieldValues; BuildRefs() returns the internal
+// ValueRefs (valid until the next Reset() or setter call on that field),
+// ready for TupleSerializer::Serialize().
+//
+// By-name setters look the column up on every call; ingest loops should
+// resolve ColumnHandles once (Schema::ResolveColumn()) and set through them.
 class TupleBuilder {
  public:
   explicit TupleBuilder(const Schema& schema);
@@ -42,18 +54,40 @@ class TupleBuilder {
   TupleBuilder& SetText(size_t field_index, const std::string& value);
   TupleBuilder& SetBlob(size_t field_index, const std::vector<uint8_t>& value);
 
+  // Columns resolved up front (Schema::ResolveColumn()): no name lookup,
+  // and strings are copied into the arena straight from the view
+  TupleBuilder& SetNull(const ColumnHandle& column);
+  TupleBuilder& SetBoolean(const ColumnHandle& column, bool value);
+  TupleBuilder& SetTinyInt(const ColumnHandle& column, int8_t value);
+  TupleBuilder& SetSmallInt(const ColumnHandle& column, int16_t value);
+  TupleBuilder& SetInteger(const ColumnHandle& column, int32_t value);
+  TupleBuilder& SetBigInt(const ColumnHandle& column, int64_t value);
+  TupleBuilder& SetFloat(const ColumnHandle& column, float value);
+  TupleBuilder& SetDouble(const ColumnHandle& column, double value);
+  TupleBuilder& SetChar(const ColumnHandle& column, std::string_view value);
+  TupleBuilder& SetVarChar(const ColumnHandle& column, std::string_view value);
+  TupleBuilder& SetText(const ColumnHandle& column, std::string_view value);
+  TupleBuilder& SetBlob(const ColumnHandle& column,
+                        const std::vector<uint8_t>& value);
+
   std::vector<FieldValue> Build() const;
+  const std::vector<ValueRef>& BuildRefs() const;
   void Reset();
 
  private:
   const Schema& schema_;
-  std::vector<std::optional<FieldValue>> values_;
+  Arena arena_;
+  std::vector<ValueRef> values_;  // unset fields hold Null(type)
+  std::vector<bool> is_set_;
 
-  void ValidateColumnName(const std::string& name,
-                          DataType expected_type) const;
+  size_t ValidateColumnName(const std::string& name,
+                            DataType expected_type) const;
   void ValidateFieldIndex(size_t index, DataType expected_type) const;
+  size_t ValidateHandle(const ColumnHandle& column,
+                        DataType expected_type) const;
   void ValidateComplete() const;
   size_t GetFieldIndex(const std::string& column_name) const;
+  void Set(size_t index, const ValueRef& value);
 };
 
 #endif
@@ -3,10 +3,36 @@
 
 #include <cstddef>
 #include <cstdint>
-#include <vector>
+#include <cstring>
 
+#include "../common/config.h"
+
+// Prefix of every serialized tuple:
+//   [null bitmap][uint16_t offset per variable-length field], padded to 8
+// The null bitmap holds one bit per field in 64-bit words, at least one, so
+// tables of up to 64 fields keep an 8-byte bitmap and wider ones (up to
+// TUPLE_MAX_FIELDS) grow it a word per 64 fields.
+//
+// A TupleHeader keeps its bytes inline, already in the serialized layout:
+// building, serializing and deserializing one never allocates. Readers and
+// writers of whole tuples (TupleSerializer, TupleAccessor, ...) do not build
+// one at all and use the static helpers on the tuple bytes instead.
+//
+// Usage example:
+//   TupleHeader header(3, 1);
+//   header.SetFieldNull(2, true);
+//   header.SetVariableLengthOffset(0, 16);
+//   header.SerializeTo(buffer);
+//   bool is_null = TupleHeader::IsNullBitSet(buffer, 2);  // true
 class TupleHeader {
  public:
+  static constexpr size_t MAX_NULL_BITMAP_SIZE =
+      (TUPLE_MAX_FIELDS + 63) / 64 * sizeof(uint64_t);
+  static constexpr size_t MAX_HEADER_SIZE =
+      (MAX_NULL_BITMAP_SIZE + TUPLE_MAX_FIELDS * sizeof(uint16_t) + 7) / 8 * 8;
+
+  // field_count must not exceed TUPLE_MAX_FIELDS, var_field_count must not
+  // exceed field_count
   TupleHeader(uint16_t field_count, uint16_t var_field_count);
 
   void SetFieldNull(uint16_t field_index, bool is_null);
@@ -15,9 +41,18 @@ class TupleHeader {
   void SetVariableLengthOffset(uint16_t var_field_index, uint16_t offset);
   uint16_t GetVariableLengthOffset(uint16_t var_field_index) const;
 
+  // Bytes of the null bitmap, where the variable-length offsets start
+  static constexpr size_t CalculateNullBitmapSize(size_t field_count) {
+    return field_count <= 64 ? sizeof(uint64_t)
+                             : (field_count + 63) / 64 * sizeof(uint64_t);
+  }
+  static size_t CalculateHeaderSize(uint16_t field_count,
+                                    uint16_t var_field_count);
+  // Header of a table with at most 64 fields
   static size_t CalculateHeaderSize(uint16_t var_field_count);
   size_t GetHeaderSize() const;
 
+  // Writes GetHeaderSize() bytes
   void SerializeTo(char* buffer) const;
   static TupleHeader DeserializeFrom(const char* buffer, uint16_t field_count,
                                      uint16_t var_field_count);
@@ -25,11 +60,27 @@ class TupleHeader {
   uint16_t GetFieldCount() const { return field_count_; }
   uint16_t GetVarFieldCount() const { return var_field_count_; }
 
+  // Null bit of field_index in serialized tuple bytes
+  static bool IsNullBitSet(const char* tuple, size_t field_index) {
+    uint64_t word;
+    std::memcpy(&word, tuple + field_index / 64 * sizeof(uint64_t),
+                sizeof(word));
+    return ((word >> (field_index % 64)) & 1) != 0;
+  }
+  static void SetNullBit(char* tuple, size_t field_index, bool is_null) {
+    char* address = tuple + field_index / 64 * sizeof(uint64_t);
+    uint64_t word;
+    std::memcpy(&word, address, sizeof(word));
+    const uint64_t mask = uint64_t{1} << (field_index % 64);
+    word = is_null ? word | mask : word & ~mask;
+    std::memcpy(address, &word, sizeof(word));
+  }
+
  private:
-  uint64_t null_bitmap_;
   uint16_t field_count_;
   uint16_t var_field_count_;
-  std::vector<uint16_t> var_offsets_;
+  size_t var_offsets_start_;
+  alignas(8) char bytes_[MAX_HEADER_SIZE];
 };
 
 #endif
@@ -4,8 +4,11 @@
 #include <vector>
 
 #include "../schema/schema.h"
+#include "../common/arena.h"
 #include "field_value.h"
+#include "overflow_value.h"
 #include "tuple_header.h"
+#include "value_ref.h"
 
 class TupleSerializer {
  public:
@@ -17,13 +20,39 @@ class TupleSerializer {
                                                         const char* buffer,
                                                         size_t buffer_size);
 
-  static size_t SerializeVariableLength(const Schema& schema,
-                                        const std::vector<FieldValue>& values,
-                                        char* buffer, size_t buffer_size);
-
-  static std::vector<FieldValue> DeserializeVariableLength(const Schema& schema,
-                                                           const char* buffer,
-                                                           size_t buffer_size);
+  // With overflow, values longer than OVERFLOW_VALUE_THRESHOLD are written
+  // to it and the tuple keeps an OverflowPointer (see overflow_value.h). If
+  // serialization fails (it throws), those values are freed again.
+  static size_t SerializeVariableLength(
+      const Schema& schema, const std::vector<FieldValue>& values,
+      char* buffer, size_t buffer_size,
+      OverflowValueStore* overflow = nullptr);
+
+  // Out-of-line values are read from overflow; without it they throw
+  static std::vector<FieldValue> DeserializeVariableLength(
+      const Schema& schema, const char* buffer, size_t buffer_size,
+      const OverflowValueStore* overflow = nullptr);
+
+  // Allocation-free variants over ValueRef. Serialize() picks the fixed or
+  // variable format from the schema. Deserialize() replaces *values
+  // (keeping its capacity) and copies string/blob bytes into arena; with
+  // arena == nullptr the values point into buffer instead, which requires
+  // every value to be stored inline. overflow works as above.
+  static size_t Serialize(const Schema& schema,
+                          const std::vector<ValueRef>& values, char* buffer,
+                          size_t buffer_size,
+                          OverflowValueStore* overflow = nullptr);
+
+  static void Deserialize(const Schema& schema, const char* buffer,
+                          size_t buffer_size, Arena* arena,
+                          std::vector<ValueRef>* values,
+                          const OverflowValueStore* overflow = nullptr);
+
+  // Append the pointers of the tuple's out-of-line values, e.g. to free
+  // them when the tuple is deleted
+  static void GetOverflowPointers(const Schema& schema, const char* buffer,
+                                  size_t buffer_size,
+                                  std::vector<OverflowPointer>* pointers);
 
   static size_t CalculateSerializedSize(const Schema& schema,
                                         const std::vector<FieldValue>& values);
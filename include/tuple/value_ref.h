@@ -0,0 +1,80 @@
+#ifndef STORAGEENGINE_VALUE_REF_H
+#define STORAGEENGINE_VALUE_REF_H
+
+#include <cstdint>
+#include <string_view>
+
+#include "../common/arena.h"
+#include "../common/types.h"
+#include "field_value.h"
+
+// Compact, trivially copyable counterpart of FieldValue: 16 bytes, no
+// owned heap storage. Fixed-length values are held inline; strings and
+// blobs are a pointer + length into an Arena (or any buffer the caller
+// keeps alive), so vectors of ValueRef never allocate per field.
+//
+// A ValueRef is only valid while the memory it points to is; for
+// arena-backed values that means until the arena's next Reset().
+// Getters throw std::runtime_error on NULL or type mismatch, like
+// FieldValue.
+class ValueRef {
+ public:
+  static ValueRef Null(DataType type);
+  static ValueRef Boolean(bool value);
+  static ValueRef TinyInt(int8_t value);
+  static ValueRef SmallInt(int16_t value);
+  static ValueRef Integer(int32_t value);
+  static ValueRef BigInt(int64_t value);
+  static ValueRef Float(float value);
+  static ValueRef Double(double value);
+
+  // Copy the bytes into arena. With arena == nullptr the value borrows
+  // them instead, and the caller keeps them alive.
+  static ValueRef Char(std::string_view value, Arena* arena);
+  static ValueRef VarChar(std::string_view value, Arena* arena);
+  static ValueRef Text(std::string_view value, Arena* arena);
+  static ValueRef Blob(std::string_view bytes, Arena* arena);
+
+  // Copies string/blob data of value into arena
+  static ValueRef FromFieldValue(const FieldValue& value, Arena* arena);
+  FieldValue ToFieldValue() const;
+
+  bool IsNull() const { return is_null_; }
+  DataType GetType() const { return static_cast<DataType>(type_); }
+
+  bool GetBoolean() const;
+  int8_t GetTinyInt() const;
+  int16_t GetSmallInt() const;
+  int32_t GetInteger() const;
+  int64_t GetBigInt() const;
+  float GetFloat() const;
+  double GetDouble() const;
+  std::string_view GetString() const;  // CHAR, VARCHAR or TEXT
+  std::string_view GetBlob() const;
+
+  // Same as FieldValue::GetSerializedSize()
+  size_t GetSerializedSize() const;
+
+ private:
+  ValueRef(DataType type, bool is_null);
+  static ValueRef Bytes(DataType type, std::string_view value, Arena* arena);
+  void Check(DataType expected, const char* message) const;
+
+  union {
+    bool boolean_val;
+    int8_t tinyint_val;
+    int16_t smallint_val;
+    int32_t integer_val;
+    int64_t bigint_val;
+    float float_val;
+    double double_val;
+    const char* bytes;
+  } data_;
+  uint32_t length_;  // string/blob length
+  uint8_t type_;
+  bool is_null_;
+};
+
+static_assert(sizeof(ValueRef) == 16, "ValueRef must stay 16 bytes");
+
+#endif  // STORAGEENGINE_VALUE_REF_H
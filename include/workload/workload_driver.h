@@ -0,0 +1,126 @@
+#ifndef STORAGEENGINE_WORKLOAD_DRIVER_H
+#define STORAGEENGINE_WORKLOAD_DRIVER_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "../buffer/replacer.h"
+#include "../common/histogram.h"
+#include "../common/metrics.h"
+#include "../common/config.h"
+#include "../common/types.h"
+#include "../storage/disk_manager.h"
+
+// YCSB-style workload driver behind `storage_engine workload`.
+//
+// A run has two phases against a fresh table (data, FSM and optional WAL
+// files in WorkloadConfig::directory, removed afterwards):
+//   load - record_count tuples are inserted by `threads` threads
+//   run  - operation_count operations spread over the threads, each picked
+//          by the read/update/insert/delete proportions, on keys drawn
+//          uniformly or from a scrambled Zipfian distribution
+// Keys are dense integers mapped to TupleIds; inserts add new keys and
+// deletes retire them (a later operation on a retired key counts as
+// "not found"). Tuple sizes are uniform in [min_tuple_size,
+// max_tuple_size]. Every operation is timed and recorded in a per-thread
+// histogram; the report has throughput and p50/p99/p99.9 latency per
+// operation type, plus the engine's cache and I/O counters.
+//
+// Usage example:
+//   WorkloadConfig config;
+//   std::string error;
+//   if (!ParseWorkloadArgs({"--threads=8", "--read=0.95", "--update=0.05"},
+//                          &config, &error)) { ... }
+//   WorkloadReport report;
+//   ErrorCode result = RunWorkload(config, &report);
+//   PrintWorkloadReport(config, report, std::cout);
+
+enum class KeyDistribution { UNIFORM, ZIPFIAN };
+
+enum class WorkloadOp { READ = 0, UPDATE = 1, INSERT = 2, DELETE = 3 };
+constexpr size_t WORKLOAD_OP_COUNT = 4;
+
+struct WorkloadConfig {
+  size_t record_count = 100000;
+  size_t operation_count = 1000000;
+  // Operation mix; normalized by their sum
+  double read_proportion = 0.5;
+  double update_proportion = 0.5;
+  double insert_proportion = 0.0;
+  double delete_proportion = 0.0;
+  KeyDistribution distribution = KeyDistribution::ZIPFIAN;
+  double zipfian_theta = 0.99;
+  uint16_t min_tuple_size = 100;
+  uint16_t max_tuple_size = 100;
+  size_t threads = 1;
+  size_t cache_mb = 64;
+  ReplacerType replacer = ReplacerType::LRU_K;
+  DurabilityMode durability = DurabilityMode::BATCHED;
+  bool direct_io = false;
+  bool use_wal = false;
+  std::string directory = "/tmp";
+  uint64_t seed = 1;
+  // Trace one run-phase operation in trace_sample_rate per thread and write
+  // them to trace_file (Chrome trace JSON); needs an ENABLE_TRACING build.
+  // ParseWorkloadArgs defaults the rate to 100 when --trace is given.
+  uint32_t trace_sample_rate = 0;
+  std::string trace_file;
+};
+
+// Zipfian ranks in [0, item_count): rank 0 is the most popular. Gray et
+// al.'s method (as in YCSB): zeta(item_count) is computed once, then each
+// draw is O(1).
+class ZipfianGenerator {
+ public:
+  ZipfianGenerator(uint64_t item_count, double theta);
+
+  // Rank for a uniform random number u in [0, 1)
+  uint64_t Next(double u) const;
+
+  uint64_t GetItemCount() const { return item_count_; }
+
+ private:
+  uint64_t item_count_;
+  double theta_;
+  double alpha_;
+  double zetan_;
+  double eta_;
+};
+
+struct WorkloadOpStats {
+  uint64_t completed = 0;  // operations that succeeded
+  uint64_t not_found = 0;  // key was deleted (or never inserted)
+  uint64_t failed = 0;     // the engine returned an error
+  LatencyHistogram latency;
+};
+
+struct WorkloadReport {
+  double load_seconds = 0;
+  double run_seconds = 0;
+  std::array<WorkloadOpStats, WORKLOAD_OP_COUNT> ops;
+  StorageMetrics metrics;  // engine counters at the end of the run
+
+  uint64_t GetTotalOperations() const;
+  double GetThroughput() const;  // operations per second in the run phase
+};
+
+// Parse `--name=value` options into *config (which keeps its values for
+// options not given). Returns false with *error set on a bad option.
+bool ParseWorkloadArgs(const std::vector<std::string>& args,
+                       WorkloadConfig* config, std::string* error);
+
+// Help text for the workload subcommand
+std::string WorkloadUsage();
+
+// Load and run the workload. Fails if the configuration is invalid or the
+// table cannot be created.
+ErrorCode RunWorkload(const WorkloadConfig& config, WorkloadReport* report);
+
+void PrintWorkloadReport(const WorkloadConfig& config,
+                         const WorkloadReport& report, std::ostream& out);
+
+#endif  // STORAGEENGINE_WORKLOAD_DRIVER_H
@@ -0,0 +1,148 @@
+#include "../../include/buffer/background_flusher.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+#include <vector>
+
+#include "../../include/common/logger.h"
+
+BackgroundFlusher::BackgroundFlusher(BufferPoolManager* buffer_pool,
+                                     uint32_t interval_ms,
+                                     double clean_target,
+                                     size_t max_pages_per_round,
+                                     uint32_t checkpoint_interval_ms)
+    : buffer_pool_(buffer_pool),
+      interval_ms_(interval_ms),
+      max_dirty_pages_(0),
+      max_pages_per_round_(max_pages_per_round),
+      checkpoint_interval_ms_(checkpoint_interval_ms),
+      cursor_(INVALID_PAGE_ID),
+      pages_written_(0),
+      rounds_(0),
+      checkpoints_(0),
+      stop_thread_(false) {
+  if (buffer_pool_ == nullptr) {
+    throw std::invalid_argument("BufferPoolManager cannot be null");
+  }
+  if (interval_ms_ == 0) {
+    throw std::invalid_argument("Flush interval must be positive");
+  }
+  if (clean_target < 0.0 || clean_target > 1.0) {
+    throw std::invalid_argument("Clean target must be between 0 and 1");
+  }
+  if (max_pages_per_round_ == 0) {
+    throw std::invalid_argument("Pages per round must be positive");
+  }
+
+  max_dirty_pages_ = static_cast<size_t>(
+      static_cast<double>(buffer_pool_->GetPoolSize()) * (1.0 - clean_target));
+
+  staging_.reset(static_cast<char*>(std::aligned_alloc(
+      DIRECT_IO_ALIGNMENT, max_pages_per_round_ * PAGE_SIZE)));
+  if (!staging_) {
+    throw std::bad_alloc();
+  }
+
+  thread_ = std::thread(&BackgroundFlusher::ThreadLoop, this);
+  LOG_INFO_STREAM("BackgroundFlusher: Started (every "
+                  << interval_ms_ << " ms, at most " << max_dirty_pages_
+                  << " dirty frames, checkpoint every "
+                  << checkpoint_interval_ms_ << " ms)");
+}
+
+BackgroundFlusher::~BackgroundFlusher() { Stop(); }
+
+ErrorCode BackgroundFlusher::RunOnce() {
+  std::lock_guard<std::mutex> lock(round_mutex_);
+  rounds_++;
+
+  std::vector<page_id_t> dirty = buffer_pool_->GetDirtyPageIds();
+  if (dirty.size() <= max_dirty_pages_) {
+    return {0, "BackgroundFlusher::RunOnce: Enough clean frames"};
+  }
+  const size_t count =
+      std::min(dirty.size() - max_dirty_pages_, max_pages_per_round_);
+
+  // Take count ids starting at the cursor, wrapping around, then put them
+  // back in ascending order so adjacent pages coalesce
+  const size_t start =
+      std::lower_bound(dirty.begin(), dirty.end(), cursor_) - dirty.begin();
+  std::vector<page_id_t> batch;
+  batch.reserve(count);
+  for (size_t i = 0; i < count; i++) {
+    batch.push_back(dirty[(start + i) % dirty.size()]);
+  }
+  cursor_ = batch.back() + 1;
+  std::sort(batch.begin(), batch.end());
+
+  return WriteBatches(batch);
+}
+
+ErrorCode BackgroundFlusher::Checkpoint() {
+  std::lock_guard<std::mutex> lock(round_mutex_);
+  ErrorCode result = WriteBatches(buffer_pool_->GetDirtyPageIds());
+  if (result.code == 0) {
+    checkpoints_++;
+    LOG_INFO("BackgroundFlusher: Checkpoint complete");
+  }
+  return result;
+}
+
+ErrorCode BackgroundFlusher::WriteBatches(
+    const std::vector<page_id_t>& page_ids) {
+  for (size_t done = 0; done < page_ids.size();) {
+    const size_t batch_size =
+        std::min(max_pages_per_round_, page_ids.size() - done);
+    const std::vector<page_id_t> batch(page_ids.begin() + done,
+                                       page_ids.begin() + done + batch_size);
+
+    size_t written = 0;
+    ErrorCode result = buffer_pool_->WriteDirtyPages(
+        batch, staging_.get(), max_pages_per_round_, &written);
+    pages_written_ += written;
+    if (result.code != 0) {
+      LOG_ERROR_STREAM("BackgroundFlusher: Write failed (" << result.message
+                                                           << ")");
+      return result;
+    }
+    done += batch_size;
+  }
+  return {0, "BackgroundFlusher: Success"};
+}
+
+void BackgroundFlusher::Stop() {
+  if (!thread_.joinable()) {
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(thread_mutex_);
+    stop_thread_ = true;
+  }
+  thread_cv_.notify_all();
+  thread_.join();
+}
+
+void BackgroundFlusher::ThreadLoop() {
+  auto last_checkpoint = std::chrono::steady_clock::now();
+  std::unique_lock<std::mutex> lock(thread_mutex_);
+  while (!stop_thread_) {
+    thread_cv_.wait_for(lock, std::chrono::milliseconds(interval_ms_));
+    if (stop_thread_) {
+      break;
+    }
+
+    lock.unlock();
+    RunOnce();
+    const auto now = std::chrono::steady_clock::now();
+    if (checkpoint_interval_ms_ > 0 &&
+        now - last_checkpoint >=
+            std::chrono::milliseconds(checkpoint_interval_ms_)) {
+      Checkpoint();
+      last_checkpoint = now;
+    }
+    lock.lock();
+  }
+}
@@ -0,0 +1,869 @@
+#include "../../include/buffer/buffer_pool_manager.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+
+#include "../../include/buffer/clock_replacer.h"
+#include "../../include/buffer/lru_k_replacer.h"
+#include "../../include/common/logger.h"
+#include "../../include/common/numa.h"
+#include "../../include/common/trace.h"
+#include "../../include/storage/log_manager.h"
+
+BufferPoolManager::BufferPoolManager(size_t pool_size,
+                                     DiskManager* disk_manager,
+                                     ReplacerType replacer_type, size_t lru_k,
+                                     size_t num_partitions)
+    : pool_size_(pool_size),
+      disk_manager_(disk_manager),
+      descriptors_(pool_size),
+      num_partitions_(num_partitions) {
+  if (disk_manager_ == nullptr) {
+    LOG_ERROR("BufferPoolManager: DiskManager is null");
+    throw std::invalid_argument("DiskManager cannot be null");
+  }
+
+  if (pool_size_ == 0) {
+    LOG_ERROR("BufferPoolManager: Pool size is zero");
+    throw std::invalid_argument("Buffer pool size must be at least 1 frame");
+  }
+
+  if (num_partitions_ == 0) {
+    LOG_ERROR("BufferPoolManager: Partition count is zero");
+    throw std::invalid_argument("Buffer pool needs at least 1 partition");
+  }
+
+  partitions_ = std::make_unique<Partition[]>(num_partitions_);
+
+  // Map every frame up front; frames are recycled, never freed, until the
+  // pool is destroyed, so a miss or a new page allocates nothing.
+  // Each NUMA node gets its own range of frames and free list.
+  frames_ = std::make_unique<FramePool>(
+      pool_size_, BUFFER_POOL_USE_HUGE_PAGES,
+      BUFFER_POOL_NUMA_AWARE ? GetNumaNodeCount() : 1);
+  free_lists_ = std::make_unique<FreeList[]>(frames_->GetNodeCount());
+  for (size_t node = 0; node < frames_->GetNodeCount(); node++) {
+    // Hand out low frame ids first
+    FreeList& free_list = free_lists_[node];
+    free_list.frames.reserve(frames_->GetFirstFrame(node + 1) -
+                             frames_->GetFirstFrame(node));
+    for (size_t i = frames_->GetFirstFrame(node + 1);
+         i > frames_->GetFirstFrame(node); i--) {
+      free_list.frames.push_back(static_cast<frame_id_t>(i - 1));
+    }
+  }
+
+  if (replacer_type == ReplacerType::CLOCK) {
+    replacer_ = std::make_unique<ClockReplacer>(pool_size_);
+  } else {
+    replacer_ = std::make_unique<LRUKReplacer>(pool_size_, lru_k);
+  }
+
+  LOG_INFO_STREAM("BufferPoolManager: Initialized with "
+                  << pool_size_ << " frames ("
+                  << (pool_size_ * PAGE_SIZE) / 1024 << " KB) on "
+                  << frames_->GetNodeCount() << " NUMA nodes, "
+                  << num_partitions_ << " partitions, replacer: "
+                  << (replacer_type == ReplacerType::CLOCK ? "CLOCK" : "LRU-K"));
+}
+
+BufferPoolManager::~BufferPoolManager() {
+  LOG_INFO("BufferPoolManager: Flushing all pages before destruction");
+  FlushAllPages();
+}
+
+size_t BufferPoolManager::FramesForMemoryBudget(size_t budget_mb) {
+  const size_t frames = (budget_mb * 1024 * 1024) / PAGE_SIZE;
+  return frames > 0 ? frames : 1;
+}
+
+BufferPoolManager::Partition& BufferPoolManager::PartitionFor(
+    page_id_t page_id) const {
+  return partitions_[page_id % num_partitions_];
+}
+
+Page* BufferPoolManager::FetchPage(page_id_t page_id) {
+  Partition& partition = PartitionFor(page_id);
+
+  // Hit: pin and return without touching any other partition
+  {
+    std::unique_lock<std::mutex> lock(partition.latch, std::defer_lock);
+    {
+      TRACE_SPAN("BufferPoolManager::PartitionLatch");
+      lock.lock();
+    }
+    if (auto it = partition.page_table.find(page_id);
+        it != partition.page_table.end()) {
+      PinFrame(it->second);
+      partition.hits.fetch_add(1, std::memory_order_relaxed);
+      return frames_->GetFrame(it->second);
+    }
+  }
+
+  // Miss: find a frame first (eviction may latch another partition)
+  const frame_id_t frame_id = AcquireFrame();
+  if (frame_id == INVALID_FRAME_ID) {
+    LOG_ERROR_STREAM("BufferPoolManager::FetchPage: No free frame for page "
+                     << page_id << " (all " << pool_size_
+                     << " frames pinned)");
+    return nullptr;
+  }
+
+  std::lock_guard<std::mutex> lock(partition.latch);
+
+  // Another thread may have loaded the page while no latch was held
+  if (auto it = partition.page_table.find(page_id);
+      it != partition.page_table.end()) {
+    ReturnFrame(frame_id);
+    PinFrame(it->second);
+    partition.hits.fetch_add(1, std::memory_order_relaxed);
+    return frames_->GetFrame(it->second);
+  }
+
+  // The read only blocks this partition. ReadPage() has verified the
+  // checksum (a mismatch throws), so the page is not checked again here.
+  TRACE_SPAN("BufferPoolManager::LoadPage");
+  partition.misses.fetch_add(1, std::memory_order_relaxed);
+  Page* page = frames_->GetFrame(frame_id);
+  try {
+    disk_manager_->ReadPage(page_id, page->GetRawBuffer());
+  } catch (const std::exception& e) {
+    LOG_ERROR_STREAM("BufferPoolManager::FetchPage: Exception loading page "
+                     << page_id << ": " << e.what());
+    ReturnFrame(frame_id);
+    return nullptr;
+  }
+
+  page->ClearDirty();
+  FrameDescriptor& descriptor = descriptors_[frame_id];
+  descriptor.page_id.store(page_id, std::memory_order_relaxed);
+  descriptor.pin_count = 1;
+  descriptor.is_dirty = false;
+  partition.page_table[page_id] = frame_id;
+
+  replacer_->RecordAccess(frame_id);
+  replacer_->SetEvictable(frame_id, false);
+
+  LOG_INFO_STREAM("BufferPoolManager::FetchPage: Loaded page "
+                  << page_id << " into frame " << frame_id);
+  return page;
+}
+
+std::vector<Page*> BufferPoolManager::FetchPages(
+    const std::vector<page_id_t>& page_ids) {
+  std::vector<Page*> pages(page_ids.size(), nullptr);
+
+  // Pass 1: pin hits, group misses by page id (duplicates share one read)
+  std::vector<page_id_t> miss_ids;
+  std::unordered_map<page_id_t, std::vector<size_t>> miss_slots;
+  for (size_t i = 0; i < page_ids.size(); i++) {
+    Partition& partition = PartitionFor(page_ids[i]);
+    std::lock_guard<std::mutex> lock(partition.latch);
+    if (auto it = partition.page_table.find(page_ids[i]);
+        it != partition.page_table.end()) {
+      PinFrame(it->second);
+      partition.hits.fetch_add(1, std::memory_order_relaxed);
+      pages[i] = frames_->GetFrame(it->second);
+      continue;
+    }
+
+    auto& slots = miss_slots[page_ids[i]];
+    if (slots.empty()) {
+      miss_ids.push_back(page_ids[i]);
+    }
+    slots.push_back(i);
+  }
+
+  if (miss_ids.empty()) {
+    return pages;
+  }
+
+  // Pass 2: reserve a private frame per miss (no partition latch held)
+  std::vector<frame_id_t> miss_frames;
+  std::vector<char*> buffers;
+  miss_frames.reserve(miss_ids.size());
+  buffers.reserve(miss_ids.size());
+  for (size_t i = 0; i < miss_ids.size(); i++) {
+    const frame_id_t frame_id = AcquireFrame();
+    if (frame_id == INVALID_FRAME_ID) {
+      LOG_ERROR_STREAM("BufferPoolManager::FetchPages: No free frame for "
+                       << (miss_ids.size() - i) << " of " << miss_ids.size()
+                       << " missing pages");
+      miss_ids.resize(i);
+      break;
+    }
+    miss_frames.push_back(frame_id);
+    buffers.push_back(frames_->GetFrame(frame_id)->GetRawBuffer());
+  }
+
+  // Pass 3: one submission for every read, then wait for all of them
+  std::vector<IOHandle> handles;
+  try {
+    handles = disk_manager_->ReadPagesAsync(miss_ids, buffers);
+  } catch (const std::exception& e) {
+    LOG_ERROR_STREAM("BufferPoolManager::FetchPages: Submit failed: "
+                     << e.what());
+    for (frame_id_t frame_id : miss_frames) {
+      ReturnFrame(frame_id);
+    }
+    return pages;
+  }
+
+  // Pass 4: publish each loaded page unless another thread beat us to it.
+  // The checksum was verified by the read's completion, before any
+  // partition latch is taken.
+  for (size_t i = 0; i < miss_ids.size(); i++) {
+    const page_id_t page_id = miss_ids[i];
+    const frame_id_t frame_id = miss_frames[i];
+    const std::vector<size_t>& slots = miss_slots[page_id];
+
+    ErrorCode result = handles[i].Wait();
+    Page* page = frames_->GetFrame(frame_id);
+    if (result.code != 0) {
+      LOG_ERROR_STREAM("BufferPoolManager::FetchPages: Failed to load page "
+                       << page_id << " (" << result.message << ")");
+      ReturnFrame(frame_id);
+      continue;
+    }
+
+    Partition& partition = PartitionFor(page_id);
+    std::lock_guard<std::mutex> lock(partition.latch);
+
+    if (auto it = partition.page_table.find(page_id);
+        it != partition.page_table.end()) {
+      ReturnFrame(frame_id);
+      for (size_t slot : slots) {
+        PinFrame(it->second);
+        pages[slot] = frames_->GetFrame(it->second);
+      }
+      partition.hits.fetch_add(slots.size(), std::memory_order_relaxed);
+      continue;
+    }
+
+    // One read served every duplicate entry
+    partition.misses.fetch_add(1, std::memory_order_relaxed);
+    partition.hits.fetch_add(slots.size() - 1, std::memory_order_relaxed);
+
+    page->ClearDirty();
+    FrameDescriptor& descriptor = descriptors_[frame_id];
+    descriptor.page_id.store(page_id, std::memory_order_relaxed);
+    descriptor.pin_count = static_cast<int>(slots.size());
+    descriptor.is_dirty = false;
+    partition.page_table[page_id] = frame_id;
+
+    replacer_->RecordAccess(frame_id);
+    replacer_->SetEvictable(frame_id, false);
+
+    for (size_t slot : slots) {
+      pages[slot] = page;
+    }
+  }
+
+  LOG_INFO_STREAM("BufferPoolManager::FetchPages: Fetched "
+                  << page_ids.size() << " pages (" << miss_ids.size()
+                  << " read from disk)");
+  return pages;
+}
+
+Page* BufferPoolManager::NewPage(page_id_t* page_id) {
+  if (page_id == nullptr) {
+    LOG_ERROR("BufferPoolManager::NewPage: page_id output is null");
+    return nullptr;
+  }
+
+  // Secure a frame before consuming a page id from the DiskManager
+  const frame_id_t frame_id = AcquireFrame();
+  if (frame_id == INVALID_FRAME_ID) {
+    LOG_ERROR_STREAM("BufferPoolManager::NewPage: No free frame (all "
+                     << pool_size_ << " frames pinned)");
+    return nullptr;
+  }
+
+  page_id_t new_page_id = INVALID_PAGE_ID;
+  try {
+    new_page_id = disk_manager_->AllocatePage();
+  } catch (const std::exception& e) {
+    LOG_ERROR_STREAM("BufferPoolManager::NewPage: Failed to allocate page: "
+                     << e.what());
+    ReturnFrame(frame_id);
+    return nullptr;
+  }
+
+  if (new_page_id == INVALID_PAGE_ID) {
+    LOG_ERROR("BufferPoolManager::NewPage: Failed to allocate page ID");
+    ReturnFrame(frame_id);
+    return nullptr;
+  }
+
+  // The frame is unreachable until it is published in the page table
+  Page* page = frames_->GetFrame(frame_id);
+  page->ResetMemory();
+  page->SetPageId(new_page_id);
+
+  Partition& partition = PartitionFor(new_page_id);
+  {
+    std::lock_guard<std::mutex> lock(partition.latch);
+    FrameDescriptor& descriptor = descriptors_[frame_id];
+    descriptor.page_id.store(new_page_id, std::memory_order_relaxed);
+    descriptor.pin_count = 1;
+    descriptor.is_dirty = true;  // Not on disk yet
+    partition.page_table[new_page_id] = frame_id;
+
+    replacer_->RecordAccess(frame_id);
+    replacer_->SetEvictable(frame_id, false);
+  }
+
+  *page_id = new_page_id;
+
+  LOG_INFO_STREAM("BufferPoolManager::NewPage: Created page "
+                  << new_page_id << " in frame " << frame_id);
+  return page;
+}
+
+bool BufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty) {
+  Partition& partition = PartitionFor(page_id);
+  std::lock_guard<std::mutex> lock(partition.latch);
+
+  auto it = partition.page_table.find(page_id);
+  if (it == partition.page_table.end()) {
+    LOG_WARNING_STREAM("BufferPoolManager::UnpinPage: Page "
+                       << page_id << " is not resident");
+    return false;
+  }
+
+  const frame_id_t frame_id = it->second;
+  FrameDescriptor& descriptor = descriptors_[frame_id];
+  if (descriptor.pin_count <= 0) {
+    LOG_WARNING_STREAM("BufferPoolManager::UnpinPage: Page "
+                       << page_id << " is not pinned");
+    return false;
+  }
+
+  descriptor.is_dirty = descriptor.is_dirty || is_dirty;
+  descriptor.pin_count--;
+  if (descriptor.pin_count == 0) {
+    replacer_->SetEvictable(frame_id, true);
+  }
+
+  return true;
+}
+
+ErrorCode BufferPoolManager::FlushPage(page_id_t page_id) {
+  return FlushPinnedPage(page_id);
+}
+
+ErrorCode BufferPoolManager::FlushAllPages() {
+  size_t flushed_partitions = 0;
+
+  for (size_t i = 0; i < num_partitions_; i++) {
+    // Snapshot the partition, then flush without holding its latch
+    std::vector<page_id_t> page_ids;
+    {
+      std::lock_guard<std::mutex> lock(partitions_[i].latch);
+      page_ids.reserve(partitions_[i].page_table.size());
+      for (const auto& entry : partitions_[i].page_table) {
+        page_ids.push_back(entry.first);
+      }
+    }
+
+    for (page_id_t page_id : page_ids) {
+      ErrorCode result = FlushPinnedPage(page_id, /*defer_sync=*/true);
+      if (result.code != 0) {
+        LOG_ERROR_STREAM(
+            "BufferPoolManager::FlushAllPages: Failed to flush page "
+            << page_id << " (" << result.message << ")");
+        return result;
+      }
+    }
+    flushed_partitions++;
+  }
+
+  ErrorCode sync_result = SyncBatch();
+  if (sync_result.code != 0) {
+    return sync_result;
+  }
+
+  LOG_INFO_STREAM("BufferPoolManager::FlushAllPages: Flushed "
+                  << flushed_partitions << " partitions");
+  return {0, "BufferPoolManager::FlushAllPages: Success"};
+}
+
+std::vector<page_id_t> BufferPoolManager::GetDirtyPageIds() const {
+  std::vector<page_id_t> page_ids;
+  for (size_t i = 0; i < num_partitions_; i++) {
+    std::lock_guard<std::mutex> lock(partitions_[i].latch);
+    for (const auto& [page_id, frame_id] : partitions_[i].page_table) {
+      if (descriptors_[frame_id].is_dirty ||
+          frames_->GetFrame(frame_id)->IsDirty()) {
+        page_ids.push_back(page_id);
+      }
+    }
+  }
+  std::sort(page_ids.begin(), page_ids.end());
+  return page_ids;
+}
+
+ErrorCode BufferPoolManager::WriteDirtyPages(
+    const std::vector<page_id_t>& page_ids, char* staging,
+    size_t staging_pages, size_t* pages_written) {
+  if (pages_written != nullptr) {
+    *pages_written = 0;
+  }
+  if (page_ids.size() > staging_pages) {
+    return {-1, "BufferPoolManager::WriteDirtyPages: Staging too small"};
+  }
+
+  // Pass 1: pin each page and copy it if it is still dirty. The pin keeps
+  // the frame resident until the write lands, so nobody can re-read the
+  // old on-disk version of a page we already marked clean.
+  std::vector<page_id_t> copied;
+  std::vector<page_id_t> skipped;
+  copied.reserve(page_ids.size());
+  for (page_id_t page_id : page_ids) {
+    Partition& partition = PartitionFor(page_id);
+    frame_id_t frame_id = INVALID_FRAME_ID;
+    {
+      std::lock_guard<std::mutex> lock(partition.latch);
+      auto it = partition.page_table.find(page_id);
+      if (it == partition.page_table.end()) {
+        continue;
+      }
+      frame_id = it->second;
+      PinFrameWithoutAccess(frame_id);
+    }
+
+    Page* page = frames_->GetFrame(frame_id);
+    page->RLatch();
+    bool is_dirty = false;
+    {
+      // Claim the dirty flag under the latch, as in FlushPinnedPage()
+      std::lock_guard<std::mutex> lock(partition.latch);
+      FrameDescriptor& descriptor = descriptors_[frame_id];
+      is_dirty = descriptor.is_dirty || page->IsDirty();
+      descriptor.is_dirty = false;
+      page->ClearDirty();
+    }
+    if (is_dirty) {
+      std::memcpy(staging + copied.size() * PAGE_SIZE, page->GetRawBuffer(),
+                  PAGE_SIZE);
+      copied.push_back(page_id);
+    } else {
+      skipped.push_back(page_id);
+    }
+    page->RUnlatch();
+  }
+
+  for (page_id_t page_id : skipped) {
+    UnpinPage(page_id, false);
+  }
+
+  // One log flush covers every copied page
+  lsn_t max_page_lsn = INVALID_LSN;
+  for (size_t i = 0; i < copied.size(); i++) {
+    PageHeader header;
+    std::memcpy(&header, staging + i * PAGE_SIZE, sizeof(header));
+    max_page_lsn = std::max<lsn_t>(max_page_lsn, header.page_lsn);
+  }
+  ErrorCode log_result = FlushLogFor(max_page_lsn);
+  if (log_result.code != 0) {
+    for (page_id_t page_id : copied) {
+      UnpinPage(page_id, true);
+    }
+    return log_result;
+  }
+
+  // Pass 2: one vectored write per run of consecutive page ids
+  ErrorCode result = {0, "BufferPoolManager::WriteDirtyPages: Success"};
+  size_t written = 0;
+  for (size_t start = 0; start < copied.size();) {
+    size_t end = start + 1;
+    while (end < copied.size() && copied[end] == copied[end - 1] + 1) {
+      end++;
+    }
+
+    std::vector<const char*> run;
+    run.reserve(end - start);
+    for (size_t i = start; i < end; i++) {
+      run.push_back(staging + i * PAGE_SIZE);
+    }
+
+    bool run_failed = false;
+    try {
+      disk_manager_->WritePages(copied[start], run, /*defer_sync=*/true);
+      written += run.size();
+    } catch (const std::exception& e) {
+      LOG_ERROR_STREAM("BufferPoolManager::WriteDirtyPages: Failed to write "
+                       << "pages " << copied[start] << "-"
+                       << copied[end - 1] << ": " << e.what());
+      result = {-1, "BufferPoolManager::WriteDirtyPages: Exception: " +
+                        std::string(e.what())};
+      run_failed = true;
+    }
+
+    // A failed write leaves the pages dirty so they are retried later
+    for (size_t i = start; i < end; i++) {
+      UnpinPage(copied[i], run_failed);
+    }
+    start = end;
+  }
+
+  if (written > 0) {
+    ErrorCode sync_result = SyncBatch();
+    if (sync_result.code != 0) {
+      return sync_result;
+    }
+  }
+
+  if (pages_written != nullptr) {
+    *pages_written = written;
+  }
+  return result;
+}
+
+ErrorCode BufferPoolManager::EvictAllPages() {
+  for (size_t i = 0; i < num_partitions_; i++) {
+    Partition& partition = partitions_[i];
+    std::lock_guard<std::mutex> lock(partition.latch);
+
+    for (auto it = partition.page_table.begin();
+         it != partition.page_table.end();) {
+      const frame_id_t frame_id = it->second;
+      FrameDescriptor& descriptor = descriptors_[frame_id];
+
+      if (descriptor.pin_count > 0) {
+        ++it;
+        continue;
+      }
+
+      ErrorCode result = FlushFrame(frame_id, /*defer_sync=*/true);
+      if (result.code != 0) {
+        return result;
+      }
+
+      replacer_->Remove(frame_id);
+      descriptor.Reset();
+      ReturnFrame(frame_id);
+      it = partition.page_table.erase(it);
+    }
+  }
+
+  ErrorCode sync_result = SyncBatch();
+  if (sync_result.code != 0) {
+    return sync_result;
+  }
+
+  LOG_INFO("BufferPoolManager::EvictAllPages: Released all unpinned frames");
+  return {0, "BufferPoolManager::EvictAllPages: Success"};
+}
+
+size_t BufferPoolManager::GetResidentPageCount() const {
+  size_t count = 0;
+  for (size_t i = 0; i < num_partitions_; i++) {
+    std::lock_guard<std::mutex> lock(partitions_[i].latch);
+    count += partitions_[i].page_table.size();
+  }
+  return count;
+}
+
+BufferPoolMetrics BufferPoolManager::GetMetrics() const {
+  BufferPoolMetrics metrics;
+  for (size_t i = 0; i < num_partitions_; i++) {
+    metrics.hits += partitions_[i].hits.load(std::memory_order_relaxed);
+    metrics.misses += partitions_[i].misses.load(std::memory_order_relaxed);
+  }
+  metrics.clean_evictions = clean_evictions_.load();
+  metrics.dirty_evictions = dirty_evictions_.load();
+  metrics.pool_size = pool_size_;
+  metrics.local_frame_acquires = local_frame_acquires_.load();
+  metrics.remote_frame_acquires = remote_frame_acquires_.load();
+
+  metrics.numa_nodes.resize(frames_->GetNodeCount());
+  for (size_t node = 0; node < metrics.numa_nodes.size(); node++) {
+    metrics.numa_nodes[node].frames =
+        frames_->GetFirstFrame(node + 1) - frames_->GetFirstFrame(node);
+  }
+  for (size_t i = 0; i < num_partitions_; i++) {
+    std::lock_guard<std::mutex> lock(partitions_[i].latch);
+    for (const auto& entry : partitions_[i].page_table) {
+      metrics.numa_nodes[frames_->GetNodeOf(entry.second)].resident_pages++;
+      metrics.resident_pages++;
+    }
+  }
+  return metrics;
+}
+
+bool BufferPoolManager::DeletePage(page_id_t page_id) {
+  Partition& partition = PartitionFor(page_id);
+  {
+    std::lock_guard<std::mutex> lock(partition.latch);
+    auto it = partition.page_table.find(page_id);
+    if (it != partition.page_table.end()) {
+      const frame_id_t frame_id = it->second;
+      FrameDescriptor& descriptor = descriptors_[frame_id];
+      if (descriptor.pin_count > 0) {
+        LOG_WARNING_STREAM("BufferPoolManager::DeletePage: Page "
+                           << page_id << " is pinned");
+        return false;
+      }
+
+      // The contents are dead, so a dirty frame is dropped unwritten
+      replacer_->Remove(frame_id);
+      descriptor.Reset();
+      frames_->GetFrame(frame_id)->ClearDirty();
+      ReturnFrame(frame_id);
+      partition.page_table.erase(it);
+    }
+  }
+
+  try {
+    disk_manager_->DeallocatePage(page_id);
+  } catch (const std::exception& e) {
+    LOG_ERROR_STREAM("BufferPoolManager::DeletePage: Failed to deallocate "
+                     "page "
+                     << page_id << ": " << e.what());
+    return false;
+  }
+  return true;
+}
+
+bool BufferPoolManager::IsPageResident(page_id_t page_id) const {
+  Partition& partition = PartitionFor(page_id);
+  std::lock_guard<std::mutex> lock(partition.latch);
+  return partition.page_table.count(page_id) > 0;
+}
+
+std::vector<page_id_t> BufferPoolManager::GetResidentPageIds() const {
+  std::vector<page_id_t> page_ids;
+  page_ids.reserve(GetResidentPageCount());
+  for (size_t i = 0; i < num_partitions_; i++) {
+    std::lock_guard<std::mutex> lock(partitions_[i].latch);
+    for (const auto& entry : partitions_[i].page_table) {
+      page_ids.push_back(entry.first);
+    }
+  }
+  return page_ids;
+}
+
+Page* BufferPoolManager::FetchResidentPage(page_id_t page_id) {
+  Partition& partition = PartitionFor(page_id);
+  std::lock_guard<std::mutex> lock(partition.latch);
+
+  auto it = partition.page_table.find(page_id);
+  if (it == partition.page_table.end()) {
+    return nullptr;
+  }
+
+  PinFrameWithoutAccess(it->second);
+  return frames_->GetFrame(it->second);
+}
+
+int BufferPoolManager::GetPinCount(page_id_t page_id) const {
+  Partition& partition = PartitionFor(page_id);
+  std::lock_guard<std::mutex> lock(partition.latch);
+
+  auto it = partition.page_table.find(page_id);
+  if (it == partition.page_table.end()) {
+    return 0;
+  }
+  return descriptors_[it->second].pin_count;
+}
+
+void BufferPoolManager::PinFrame(frame_id_t frame_id) {
+  FrameDescriptor& descriptor = descriptors_[frame_id];
+  descriptor.pin_count++;
+  replacer_->RecordAccess(frame_id);
+  if (descriptor.pin_count == 1) {
+    replacer_->SetEvictable(frame_id, false);
+  }
+}
+
+void BufferPoolManager::PinFrameWithoutAccess(frame_id_t frame_id) {
+  FrameDescriptor& descriptor = descriptors_[frame_id];
+  descriptor.pin_count++;
+  if (descriptor.pin_count == 1) {
+    replacer_->SetEvictable(frame_id, false);
+  }
+}
+
+void BufferPoolManager::ReturnFrame(frame_id_t frame_id) {
+  FreeList& free_list = free_lists_[frames_->GetNodeOf(frame_id)];
+  std::lock_guard<std::mutex> lock(free_list.latch);
+  free_list.frames.push_back(frame_id);
+}
+
+frame_id_t BufferPoolManager::AcquireFrame() {
+  // Free frames of the caller's node first, then of the others
+  const size_t node_count = frames_->GetNodeCount();
+  const size_t local_node =
+      node_count > 1 ? GetCurrentNumaNode() % node_count : 0;
+  for (size_t i = 0; i < node_count; i++) {
+    FreeList& free_list = free_lists_[(local_node + i) % node_count];
+    std::lock_guard<std::mutex> lock(free_list.latch);
+    if (!free_list.frames.empty()) {
+      const frame_id_t frame_id = free_list.frames.back();
+      free_list.frames.pop_back();
+      (i == 0 ? local_frame_acquires_ : remote_frame_acquires_)++;
+      return frame_id;
+    }
+  }
+
+  frame_id_t victim = INVALID_FRAME_ID;
+  while (replacer_->Evict(&victim)) {
+    FrameDescriptor& descriptor = descriptors_[victim];
+    const page_id_t victim_page_id =
+        descriptor.page_id.load(std::memory_order_relaxed);
+
+    Partition& partition = PartitionFor(victim_page_id);
+    std::lock_guard<std::mutex> lock(partition.latch);
+
+    // Between Evict() and the latch the frame may have been released by
+    // EvictAllPages() or re-pinned by a hit. A re-pinned frame is handed
+    // back to the replacer by its final UnpinPage(), so just skip it.
+    auto it = partition.page_table.find(victim_page_id);
+    if (it == partition.page_table.end() || it->second != victim ||
+        descriptor.pin_count > 0) {
+      continue;
+    }
+
+    if (descriptor.is_dirty || frames_->GetFrame(victim)->IsDirty()) {
+      dirty_evictions_++;
+    } else {
+      clean_evictions_++;
+    }
+    ErrorCode result = FlushFrame(victim);
+    if (result.code != 0) {
+      // Keep the dirty page resident rather than lose its contents
+      LOG_ERROR_STREAM("BufferPoolManager: Failed to write back victim page "
+                       << victim_page_id << " (" << result.message << ")");
+      replacer_->RecordAccess(victim);
+      replacer_->SetEvictable(victim, true);
+      return INVALID_FRAME_ID;
+    }
+
+    // A hit + unpin between Evict() and the latch re-registered the frame
+    replacer_->Remove(victim);
+    partition.page_table.erase(it);
+    descriptor.Reset();
+
+    LOG_INFO_STREAM("BufferPoolManager: Evicted page " << victim_page_id
+                                                       << " from frame "
+                                                       << victim);
+    (frames_->GetNodeOf(victim) == local_node ? local_frame_acquires_
+                                              : remote_frame_acquires_)++;
+    return victim;
+  }
+
+  return INVALID_FRAME_ID;
+}
+
+ErrorCode BufferPoolManager::FlushFrame(frame_id_t frame_id, bool defer_sync) {
+  FrameDescriptor& descriptor = descriptors_[frame_id];
+  Page* page = frames_->GetFrame(frame_id);
+  const page_id_t page_id = descriptor.page_id.load(std::memory_order_relaxed);
+
+  if (!descriptor.is_dirty && !page->IsDirty()) {
+    return {0, "BufferPoolManager::FlushFrame: Page not dirty"};
+  }
+
+  ErrorCode log_result = FlushLogFor(page->GetPageLsn());
+  if (log_result.code != 0) {
+    return log_result;
+  }
+  defer_sync = defer_sync || log_manager_ != nullptr;
+
+  try {
+    // WritePage() stamps the checksum
+    disk_manager_->WritePage(page_id, page->GetRawBuffer(), defer_sync);
+  } catch (const std::exception& e) {
+    LOG_ERROR_STREAM("BufferPoolManager::FlushFrame: Exception flushing page "
+                     << page_id << ": " << e.what());
+    return {-1, "BufferPoolManager::FlushFrame: Exception: " +
+                    std::string(e.what())};
+  }
+
+  descriptor.is_dirty = false;
+  page->ClearDirty();
+  LOG_INFO_STREAM("BufferPoolManager::FlushFrame: Flushed page " << page_id);
+  return {0, "BufferPoolManager::FlushFrame: Success"};
+}
+
+ErrorCode BufferPoolManager::FlushPinnedPage(page_id_t page_id,
+                                             bool defer_sync) {
+  Partition& partition = PartitionFor(page_id);
+
+  frame_id_t frame_id = INVALID_FRAME_ID;
+  {
+    std::lock_guard<std::mutex> lock(partition.latch);
+    auto it = partition.page_table.find(page_id);
+    if (it == partition.page_table.end()) {
+      return {0, "BufferPoolManager::FlushPage: Page not in pool"};
+    }
+    frame_id = it->second;
+    PinFrame(frame_id);  // keeps the frame from being evicted under us
+  }
+
+  // Wait for writers to finish; the partition latch is not held here so a
+  // writer that needs it can make progress.
+  Page* page = frames_->GetFrame(frame_id);
+  page->WLatch();
+
+  bool is_dirty = false;
+  {
+    // Claim the dirty flag before writing: a writer that unpins after this
+    // point re-marks the page, so no update is lost.
+    std::lock_guard<std::mutex> lock(partition.latch);
+    FrameDescriptor& descriptor = descriptors_[frame_id];
+    is_dirty = descriptor.is_dirty || page->IsDirty();
+    descriptor.is_dirty = false;
+    page->ClearDirty();
+  }
+
+  ErrorCode result = {0, "BufferPoolManager::FlushPage: Page not dirty"};
+  if (is_dirty) {
+    result = FlushLogFor(page->GetPageLsn());
+    defer_sync = defer_sync || log_manager_ != nullptr;
+  }
+  if (is_dirty && result.code == 0) {
+    try {
+      disk_manager_->WritePage(page_id, page->GetRawBuffer(), defer_sync);
+      result = {0, "BufferPoolManager::FlushPage: Success"};
+    } catch (const std::exception& e) {
+      LOG_ERROR_STREAM("BufferPoolManager::FlushPage: Exception flushing page "
+                       << page_id << ": " << e.what());
+      result = {-1, "BufferPoolManager::FlushPage: Exception: " +
+                        std::string(e.what())};
+    }
+  }
+
+  page->WUnlatch();
+
+  // A failed write leaves the page dirty so it is retried later
+  UnpinPage(page_id, result.code != 0);
+  return result;
+}
+
+ErrorCode BufferPoolManager::FlushLogFor(lsn_t page_lsn) {
+  if (log_manager_ == nullptr) {
+    return {0, "BufferPoolManager: No write-ahead log"};
+  }
+  ErrorCode result = log_manager_->Flush(page_lsn);
+  if (result.code != 0) {
+    LOG_ERROR_STREAM("BufferPoolManager: Log flush to LSN "
+                     << page_lsn << " failed, page not written ("
+                     << result.message << ")");
+  }
+  return result;
+}
+
+ErrorCode BufferPoolManager::SyncBatch() {
+  try {
+    disk_manager_->Sync();
+  } catch (const std::exception& e) {
+    LOG_ERROR_STREAM("BufferPoolManager::SyncBatch: " << e.what());
+    return {-2, "BufferPoolManager::SyncBatch: Exception: " +
+                    std::string(e.what())};
+  }
+  return {0, "BufferPoolManager::SyncBatch: Success"};
+}
@@ -0,0 +1,91 @@
+#include "../../include/buffer/clock_replacer.h"
+
+#include <stdexcept>
+
+ClockReplacer::ClockReplacer(size_t num_frames)
+    : num_frames_(num_frames),
+      evictable_(num_frames, false),
+      referenced_(std::make_unique<std::atomic<bool>[]>(num_frames)),
+      hand_(0),
+      evictable_count_(0) {
+  if (num_frames == 0) {
+    throw std::invalid_argument("ClockReplacer requires at least one frame");
+  }
+  for (size_t i = 0; i < num_frames_; i++) {
+    referenced_[i].store(false, std::memory_order_relaxed);
+  }
+}
+
+void ClockReplacer::RecordAccess(frame_id_t frame_id) {
+  if (frame_id >= num_frames_) {
+    throw std::out_of_range("ClockReplacer: frame id out of range");
+  }
+  referenced_[frame_id].store(true, std::memory_order_relaxed);
+}
+
+void ClockReplacer::SetEvictable(frame_id_t frame_id, bool evictable) {
+  std::lock_guard<std::mutex> lock(latch_);
+  if (frame_id >= num_frames_) {
+    throw std::out_of_range("ClockReplacer: frame id out of range");
+  }
+
+  if (evictable_[frame_id] == evictable) {
+    return;
+  }
+
+  evictable_[frame_id] = evictable;
+  if (evictable) {
+    evictable_count_++;
+  } else {
+    evictable_count_--;
+  }
+}
+
+bool ClockReplacer::Evict(frame_id_t* frame_id) {
+  std::lock_guard<std::mutex> lock(latch_);
+
+  if (evictable_count_ == 0) {
+    return false;
+  }
+
+  // At most two full sweeps: the first clears reference bits, the second is
+  // guaranteed to find an evictable frame with a clear bit.
+  for (size_t step = 0; step < 2 * num_frames_; step++) {
+    const size_t current = hand_;
+    hand_ = (hand_ + 1) % num_frames_;
+
+    if (!evictable_[current]) {
+      continue;
+    }
+
+    // Second chance: clear the bit and move on
+    if (referenced_[current].exchange(false, std::memory_order_relaxed)) {
+      continue;
+    }
+
+    evictable_[current] = false;
+    evictable_count_--;
+    *frame_id = static_cast<frame_id_t>(current);
+    return true;
+  }
+
+  return false;
+}
+
+void ClockReplacer::Remove(frame_id_t frame_id) {
+  std::lock_guard<std::mutex> lock(latch_);
+  if (frame_id >= num_frames_) {
+    return;
+  }
+
+  if (evictable_[frame_id]) {
+    evictable_count_--;
+  }
+  evictable_[frame_id] = false;
+  referenced_[frame_id].store(false, std::memory_order_relaxed);
+}
+
+size_t ClockReplacer::Size() const {
+  std::lock_guard<std::mutex> lock(latch_);
+  return evictable_count_;
+}
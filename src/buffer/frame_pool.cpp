@@ -0,0 +1,101 @@
+#include "../../include/buffer/frame_pool.h"
+
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+
+#include "../../include/common/logger.h"
+#include "../../include/common/numa.h"
+
+namespace {
+
+size_t RoundUp(size_t value, size_t multiple) {
+  return (value + multiple - 1) / multiple * multiple;
+}
+
+}  // namespace
+
+FramePool::FramePool(size_t frame_count, bool use_huge_pages,
+                     size_t numa_nodes)
+    : mapping_(MAP_FAILED), mapping_size_(0), huge_tlb_(false) {
+  if (frame_count == 0) {
+    LOG_ERROR("FramePool: Frame count is zero");
+    throw std::invalid_argument("FramePool needs at least 1 frame");
+  }
+
+  const size_t bytes = frame_count * PAGE_SIZE;
+  const bool huge = use_huge_pages && bytes >= HUGE_PAGE_SIZE;
+
+#if defined(MAP_HUGETLB)
+  if (huge) {
+    mapping_size_ = RoundUp(bytes, HUGE_PAGE_SIZE);
+    mapping_ = mmap(nullptr, mapping_size_, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    huge_tlb_ = mapping_ != MAP_FAILED;
+  }
+#endif
+
+  // Over-map by the alignment wanted, so the frames can start on it
+  const size_t alignment = huge ? HUGE_PAGE_SIZE : PAGE_SIZE;
+  if (mapping_ == MAP_FAILED) {
+    mapping_size_ = bytes + alignment;
+    mapping_ = mmap(nullptr, mapping_size_, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  }
+  if (mapping_ == MAP_FAILED) {
+    LOG_ERROR_STREAM("FramePool: Failed to map " << mapping_size_
+                                                 << " bytes");
+    throw std::runtime_error("Failed to map buffer pool frames");
+  }
+
+  const uintptr_t address = reinterpret_cast<uintptr_t>(mapping_);
+  char* first_frame =
+      reinterpret_cast<char*>(RoundUp(address, huge_tlb_ ? 1 : alignment));
+#if defined(MADV_HUGEPAGE)
+  if (huge && !huge_tlb_) {
+    // Only a hint: the pool works the same if the kernel declines
+    madvise(first_frame, bytes, MADV_HUGEPAGE);
+  }
+#endif
+
+  // Bind before anything touches the frames, so they fault in locally
+  numa_nodes = std::max<size_t>(1, std::min(numa_nodes, frame_count));
+  for (size_t node = 0; node <= numa_nodes; node++) {
+    node_first_frame_.push_back(frame_count * node / numa_nodes);
+  }
+  if (numa_nodes > 1) {
+    for (size_t node = 0; node < numa_nodes; node++) {
+      const size_t first = node_first_frame_[node];
+      const size_t count = node_first_frame_[node + 1] - first;
+      if (!BindMemoryToNumaNode(first_frame + first * PAGE_SIZE,
+                                count * PAGE_SIZE, node)) {
+        LOG_WARNING_STREAM("FramePool: Failed to bind frames of node "
+                           << node << "; they are placed by first touch");
+      }
+    }
+  }
+
+  frames_.reserve(frame_count);
+  for (size_t i = 0; i < frame_count; i++) {
+    frames_.push_back(Page::CreateInFrame(first_frame + i * PAGE_SIZE));
+  }
+
+  LOG_INFO_STREAM("FramePool: Mapped " << frame_count << " frames ("
+                                        << (huge_tlb_ ? "MAP_HUGETLB"
+                                            : huge    ? "THP advised"
+                                                      : "normal pages")
+                                        << ")");
+}
+
+size_t FramePool::GetNodeOf(size_t frame_id) const {
+  const auto next = std::upper_bound(node_first_frame_.begin(),
+                                     node_first_frame_.end() - 1, frame_id);
+  return static_cast<size_t>(next - node_first_frame_.begin()) - 1;
+}
+
+FramePool::~FramePool() {
+  frames_.clear();
+  munmap(mapping_, mapping_size_);
+}
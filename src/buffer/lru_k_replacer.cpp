@@ -0,0 +1,128 @@
+#include "../../include/buffer/lru_k_replacer.h"
+
+#include <stdexcept>
+
+LRUKReplacer::LRUKReplacer(size_t num_frames, size_t k)
+    : k_(k), current_timestamp_(0), history_(num_frames) {
+  if (num_frames == 0) {
+    throw std::invalid_argument("LRUKReplacer requires at least one frame");
+  }
+  if (k_ == 0) {
+    throw std::invalid_argument("LRUKReplacer requires k >= 1");
+  }
+}
+
+LRUKReplacer::OrderKey LRUKReplacer::KeyFor(frame_id_t frame_id) const {
+  const FrameHistory& frame = history_[frame_id];
+
+  // Fewer than K accesses: order by earliest recorded access (front).
+  // K accesses: the front is exactly the K-th most recent access.
+  // Either way the front of the deque is the ordering timestamp.
+  const uint64_t timestamp =
+      frame.timestamps.empty() ? 0 : frame.timestamps.front();
+  return {timestamp, frame_id};
+}
+
+void LRUKReplacer::Unlink(frame_id_t frame_id) {
+  const FrameHistory& frame = history_[frame_id];
+  if (!frame.evictable) {
+    return;
+  }
+
+  if (frame.timestamps.size() < k_) {
+    infinite_distance_.erase(KeyFor(frame_id));
+  } else {
+    finite_distance_.erase(KeyFor(frame_id));
+  }
+}
+
+void LRUKReplacer::Link(frame_id_t frame_id) {
+  const FrameHistory& frame = history_[frame_id];
+  if (!frame.evictable) {
+    return;
+  }
+
+  if (frame.timestamps.size() < k_) {
+    infinite_distance_.insert(KeyFor(frame_id));
+  } else {
+    finite_distance_.insert(KeyFor(frame_id));
+  }
+}
+
+void LRUKReplacer::RecordAccess(frame_id_t frame_id) {
+  std::lock_guard<std::mutex> lock(latch_);
+  if (frame_id >= history_.size()) {
+    throw std::out_of_range("LRUKReplacer: frame id out of range");
+  }
+
+  // Re-key the frame: remove with the old key, update history, re-insert
+  Unlink(frame_id);
+
+  FrameHistory& frame = history_[frame_id];
+  frame.timestamps.push_back(current_timestamp_++);
+  if (frame.timestamps.size() > k_) {
+    frame.timestamps.pop_front();
+  }
+
+  Link(frame_id);
+}
+
+void LRUKReplacer::SetEvictable(frame_id_t frame_id, bool evictable) {
+  std::lock_guard<std::mutex> lock(latch_);
+  if (frame_id >= history_.size()) {
+    throw std::out_of_range("LRUKReplacer: frame id out of range");
+  }
+
+  FrameHistory& frame = history_[frame_id];
+  if (frame.evictable == evictable) {
+    return;
+  }
+
+  if (evictable) {
+    frame.evictable = true;
+    Link(frame_id);
+  } else {
+    Unlink(frame_id);
+    frame.evictable = false;
+  }
+}
+
+bool LRUKReplacer::Evict(frame_id_t* frame_id) {
+  std::lock_guard<std::mutex> lock(latch_);
+
+  std::set<OrderKey>* candidates = nullptr;
+  if (!infinite_distance_.empty()) {
+    candidates = &infinite_distance_;
+  } else if (!finite_distance_.empty()) {
+    candidates = &finite_distance_;
+  } else {
+    return false;
+  }
+
+  const frame_id_t victim = candidates->begin()->second;
+  candidates->erase(candidates->begin());
+
+  FrameHistory& frame = history_[victim];
+  frame.timestamps.clear();
+  frame.evictable = false;
+
+  *frame_id = victim;
+  return true;
+}
+
+void LRUKReplacer::Remove(frame_id_t frame_id) {
+  std::lock_guard<std::mutex> lock(latch_);
+  if (frame_id >= history_.size()) {
+    return;
+  }
+
+  Unlink(frame_id);
+  FrameHistory& frame = history_[frame_id];
+  frame.timestamps.clear();
+  frame.evictable = false;
+}
+
+size_t LRUKReplacer::Size() const {
+  std::lock_guard<std::mutex> lock(latch_);
+  return infinite_distance_.size() + finite_distance_.size();
+}
@@ -0,0 +1,69 @@
+#include "../../include/buffer/page_guard.h"
+
+#include "../../include/buffer/buffer_pool_manager.h"
+#include "../../include/common/trace.h"
+
+PageGuard::PageGuard(BufferPoolManager* bpm, page_id_t page_id, Page* page,
+                     LatchMode mode)
+    : bpm_(bpm), page_id_(page_id), page_(page), mode_(mode), is_dirty_(false) {
+  if (page_ == nullptr) {
+    return;
+  }
+
+  TRACE_SPAN("PageGuard::Latch");
+
+  if (mode_ == LatchMode::SHARED) {
+    page_->RLatch();
+  } else if (mode_ == LatchMode::EXCLUSIVE) {
+    page_->WLatch();
+  }
+}
+
+PageGuard::~PageGuard() { Release(); }
+
+PageGuard::PageGuard(PageGuard&& other) noexcept
+    : bpm_(other.bpm_),
+      page_id_(other.page_id_),
+      page_(other.page_),
+      mode_(other.mode_),
+      is_dirty_(other.is_dirty_) {
+  other.bpm_ = nullptr;
+  other.page_ = nullptr;
+  other.mode_ = LatchMode::NONE;
+  other.is_dirty_ = false;
+}
+
+PageGuard& PageGuard::operator=(PageGuard&& other) noexcept {
+  if (this != &other) {
+    Release();
+    bpm_ = other.bpm_;
+    page_id_ = other.page_id_;
+    page_ = other.page_;
+    mode_ = other.mode_;
+    is_dirty_ = other.is_dirty_;
+    other.bpm_ = nullptr;
+    other.page_ = nullptr;
+    other.mode_ = LatchMode::NONE;
+    other.is_dirty_ = false;
+  }
+  return *this;
+}
+
+void PageGuard::Release() {
+  if (page_ != nullptr) {
+    // Unlatch before unpinning: a pin of zero must imply no latch holders
+    if (mode_ == LatchMode::SHARED) {
+      page_->RUnlatch();
+    } else if (mode_ == LatchMode::EXCLUSIVE) {
+      page_->WUnlatch();
+    }
+
+    if (bpm_ != nullptr) {
+      bpm_->UnpinPage(page_id_, is_dirty_);
+    }
+  }
+  bpm_ = nullptr;
+  page_ = nullptr;
+  mode_ = LatchMode::NONE;
+  is_dirty_ = false;
+}
@@ -0,0 +1,62 @@
+#include "../../include/common/arena.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+Arena::Arena(size_t block_size)
+    : block_size_(block_size),
+      current_block_(0),
+      block_offset_(0),
+      bytes_used_(0),
+      capacity_(0) {
+  if (block_size_ == 0) {
+    throw std::invalid_argument("Arena block size must be positive");
+  }
+}
+
+Arena& Arena::ForThread() {
+  thread_local Arena arena;
+  return arena;
+}
+
+char* Arena::Allocate(size_t size, size_t align) {
+  // Walk forward through retained blocks until one fits; blocks skipped
+  // here are reused again after the next Reset()
+  while (current_block_ < blocks_.size()) {
+    Block& block = blocks_[current_block_];
+    uintptr_t base = reinterpret_cast<uintptr_t>(block.data.get());
+    size_t aligned = ((base + block_offset_ + align - 1) & ~(align - 1)) - base;
+    if (aligned + size <= block.size) {
+      block_offset_ = aligned + size;
+      bytes_used_ += size;
+      return block.data.get() + aligned;
+    }
+    current_block_++;
+    block_offset_ = 0;
+  }
+
+  // Oversized requests get a block of their own
+  size_t new_size = std::max(block_size_, size + align);
+  blocks_.push_back(Block{std::make_unique<char[]>(new_size), new_size});
+  capacity_ += new_size;
+  current_block_ = blocks_.size() - 1;
+  block_offset_ = 0;
+  return Allocate(size, align);
+}
+
+const char* Arena::Copy(const void* data, size_t size) {
+  if (size == 0) {
+    return nullptr;
+  }
+  char* dest = Allocate(size, 1);
+  std::memcpy(dest, data, size);
+  return dest;
+}
+
+void Arena::Reset() {
+  current_block_ = 0;
+  block_offset_ = 0;
+  bytes_used_ = 0;
+}
@@ -4,49 +4,196 @@
 
 #include "../../include/common/checksum.h"
 
-// Static member definitions
-uint32_t checksum::lookup_table_[256];
-std::once_flag checksum::init_flag_;
+#include <array>
+#include <cstring>
 
-void checksum::BuildLookupTable() {
-  for (int i = 0; i < 256; i++) {
-    uint32_t crc_value = static_cast<uint32_t>(i) << 24;
+#if defined(__x86_64__) || defined(__i386__)
+#include <nmmintrin.h>
+#define STORAGEENGINE_CRC32C_SSE42 1
+#elif defined(__aarch64__) && defined(__linux__)
+#include <arm_acle.h>
+#include <asm/hwcap.h>
+#include <sys/auxv.h>
+#define STORAGEENGINE_CRC32C_ARMV8 1
+#endif
+
+namespace {
+
+// Tables are built at compile time, so no lazy initialization on the hot path
+
+// MSB-first CRC32 table
+constexpr std::array<uint32_t, 256> BuildCrc32Table() {
+  std::array<uint32_t, 256> table{};
+  for (uint32_t i = 0; i < 256; i++) {
+    uint32_t crc_value = i << 24;
     for (int j = 0; j < 8; j++) {
       if (crc_value & 0x80000000) {
-        crc_value = (crc_value << 1) ^ POLYNOMIAL;
+        crc_value = (crc_value << 1) ^ checksum::POLYNOMIAL;
       } else {
         crc_value = crc_value << 1;
       }
     }
-    lookup_table_[i] = crc_value;
+    table[i] = crc_value;
+  }
+  return table;
+}
+
+// Slicing-by-8 tables for reflected CRC32C: tables[k][b] is the CRC of byte b
+// followed by k zero bytes
+using Crc32cTables = std::array<std::array<uint32_t, 256>, 8>;
+
+constexpr Crc32cTables BuildCrc32cTables() {
+  Crc32cTables tables{};
+  for (uint32_t i = 0; i < 256; i++) {
+    uint32_t crc_value = i;
+    for (int j = 0; j < 8; j++) {
+      crc_value = (crc_value >> 1) ^
+                  ((crc_value & 1) ? checksum::CRC32C_POLYNOMIAL : 0);
+    }
+    tables[0][i] = crc_value;
+  }
+  for (size_t k = 1; k < 8; k++) {
+    for (uint32_t i = 0; i < 256; i++) {
+      const uint32_t prev = tables[k - 1][i];
+      tables[k][i] = (prev >> 8) ^ tables[0][prev & 0xFF];
+    }
+  }
+  return tables;
+}
+
+constexpr std::array<uint32_t, 256> kCrc32Table = BuildCrc32Table();
+constexpr Crc32cTables kCrc32cTables = BuildCrc32cTables();
+
+using Crc32cUpdateFn = uint32_t (*)(uint32_t, const uint8_t*, std::size_t);
+
+#if defined(STORAGEENGINE_CRC32C_SSE42)
+__attribute__((target("sse4.2"))) uint32_t UpdateCrc32cSse42(
+    uint32_t crc, const uint8_t* data, std::size_t length) {
+#if defined(__x86_64__)
+  uint64_t crc64 = crc;
+  while (length >= 8) {
+    uint64_t word;
+    std::memcpy(&word, data, sizeof(word));
+    crc64 = _mm_crc32_u64(crc64, word);
+    data += 8;
+    length -= 8;
+  }
+  crc = static_cast<uint32_t>(crc64);
+#endif
+  while (length >= 4) {
+    uint32_t word;
+    std::memcpy(&word, data, sizeof(word));
+    crc = _mm_crc32_u32(crc, word);
+    data += 4;
+    length -= 4;
+  }
+  while (length > 0) {
+    crc = _mm_crc32_u8(crc, *data++);
+    length--;
+  }
+  return crc;
+}
+#endif
+
+#if defined(STORAGEENGINE_CRC32C_ARMV8)
+__attribute__((target("+crc"))) uint32_t UpdateCrc32cArmv8(
+    uint32_t crc, const uint8_t* data, std::size_t length) {
+  while (length >= 8) {
+    uint64_t word;
+    std::memcpy(&word, data, sizeof(word));
+    crc = __crc32cd(crc, word);
+    data += 8;
+    length -= 8;
   }
+  while (length > 0) {
+    crc = __crc32cb(crc, *data++);
+    length--;
+  }
+  return crc;
 }
+#endif
+
+struct Crc32cDispatch {
+  Crc32cUpdateFn update;
+  const char* name;
+};
 
-void checksum::EnsureTableInitialized() {
-  std::call_once(init_flag_, BuildLookupTable);
+Crc32cDispatch ResolveCrc32c() {
+#if defined(STORAGEENGINE_CRC32C_SSE42)
+  if (__builtin_cpu_supports("sse4.2")) {
+    return {UpdateCrc32cSse42, "sse4.2"};
+  }
+#elif defined(STORAGEENGINE_CRC32C_ARMV8)
+  if (getauxval(AT_HWCAP) & HWCAP_CRC32) {
+    return {UpdateCrc32cArmv8, "armv8-crc"};
+  }
+#endif
+  return {checksum::UpdateCrc32cPortable, "slicing-by-8"};
 }
 
+const Crc32cDispatch& GetCrc32cDispatch() {
+  static const Crc32cDispatch dispatch = ResolveCrc32c();
+  return dispatch;
+}
+
+}  // namespace
+
 uint32_t checksum::Compute(const uint8_t* data, const std::size_t length) {
+  return Compute(Algorithm::CRC32, data, length);
+}
+
+uint32_t checksum::Compute(const Algorithm algorithm, const uint8_t* data,
+                           const std::size_t length) {
   uint32_t result_crc = Init();
-  result_crc = Update(result_crc, data, length);
+  result_crc = Update(algorithm, result_crc, data, length);
   return Finalize(result_crc);
 }
 
-uint32_t checksum::Init() {
-  EnsureTableInitialized();
-  return INITIAL_CRC;
-}
+uint32_t checksum::Init() { return INITIAL_CRC; }
 
 uint32_t checksum::Update(uint32_t crc, const uint8_t* data,
                           const std::size_t length) {
-  EnsureTableInitialized();
-
   for (size_t i = 0; i < length; i++) {
     const uint8_t table_index = ((crc >> 24) ^ data[i]) & 0xFF;
-    crc = (crc << 8) ^ lookup_table_[table_index];
+    crc = (crc << 8) ^ kCrc32Table[table_index];
   }
 
   return crc;
 }
 
-uint32_t checksum::Finalize(const uint32_t crc) { return ~crc; }
\ No newline at end of file
+uint32_t checksum::Update(const Algorithm algorithm, const uint32_t crc,
+                          const uint8_t* data, const std::size_t length) {
+  if (algorithm == Algorithm::CRC32C) {
+    return GetCrc32cDispatch().update(crc, data, length);
+  }
+  return Update(crc, data, length);
+}
+
+uint32_t checksum::UpdateCrc32cPortable(uint32_t crc, const uint8_t* data,
+                                        std::size_t length) {
+  const auto& t = kCrc32cTables;
+  while (length >= 8) {
+    // Assemble explicitly so the result does not depend on host byte order
+    const uint32_t low = static_cast<uint32_t>(data[0]) |
+                         static_cast<uint32_t>(data[1]) << 8 |
+                         static_cast<uint32_t>(data[2]) << 16 |
+                         static_cast<uint32_t>(data[3]) << 24;
+    crc ^= low;
+    crc = t[7][crc & 0xFF] ^ t[6][(crc >> 8) & 0xFF] ^
+          t[5][(crc >> 16) & 0xFF] ^ t[4][crc >> 24] ^ t[3][data[4]] ^
+          t[2][data[5]] ^ t[1][data[6]] ^ t[0][data[7]];
+    data += 8;
+    length -= 8;
+  }
+  while (length > 0) {
+    crc = (crc >> 8) ^ t[0][(crc ^ *data++) & 0xFF];
+    length--;
+  }
+  return crc;
+}
+
+const char* checksum::Crc32cImplementation() {
+  return GetCrc32cDispatch().name;
+}
+
+uint32_t checksum::Finalize(const uint32_t crc) { return ~crc; }
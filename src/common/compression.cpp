@@ -0,0 +1,356 @@
+#include "../../include/common/compression.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+#include "../../include/common/checksum.h"
+
+namespace {
+
+// LZ4 block format limits: a match needs 4 bytes, the last 5 bytes are
+// literals, and the last match starts at least 12 bytes before the end
+constexpr size_t MIN_MATCH = 4;
+constexpr size_t LAST_LITERALS = 5;
+constexpr size_t MATCH_FIND_LIMIT = 12;
+constexpr size_t MAX_OFFSET = 65535;
+
+uint32_t Load32(const char* p) {
+  uint32_t value;
+  std::memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+size_t HashPosition(const char* p, size_t bits) {
+  return (Load32(p) * 2654435761u) >> (32 - bits);
+}
+
+// Bytes a length field takes beyond the token's 4 bits
+size_t LengthBytes(size_t length) {
+  return length < 15 ? 0 : (length - 15) / 255 + 1;
+}
+
+char* WriteLength(size_t length, char* op) {
+  for (length -= 15; length >= 255; length -= 255) {
+    *op++ = static_cast<char>(255);
+  }
+  *op++ = static_cast<char>(length);
+  return op;
+}
+
+// Read a length extension; false if it runs past end
+bool ReadLength(const char** ip, const char* end, size_t* length) {
+  uint8_t byte;
+  do {
+    if (*ip >= end) {
+      return false;
+    }
+    byte = static_cast<uint8_t>(*(*ip)++);
+    *length += byte;
+  } while (byte == 255);
+  return true;
+}
+
+// Window that holds the dictionary followed by the tuple being compressed
+char* Window(size_t size) {
+  thread_local std::vector<char> window;
+  if (window.size() < size) {
+    window.resize(size);
+  }
+  return window.data();
+}
+
+}  // namespace
+
+TupleCompressor::TupleCompressor(std::string dictionary)
+    : dictionary_(std::move(dictionary)),
+      dictionary_id_(0),
+      dictionary_table_(size_t{1} << HASH_BITS, 0) {
+  if (dictionary_.size() > MAX_COMPRESSION_DICTIONARY_SIZE) {
+    throw std::invalid_argument(
+        "Compression dictionary exceeds " +
+        std::to_string(MAX_COMPRESSION_DICTIONARY_SIZE) + " bytes");
+  }
+  if (dictionary_.empty()) {
+    return;
+  }
+
+  const uint32_t crc = checksum::Compute(
+      checksum::Algorithm::CRC32C,
+      reinterpret_cast<const uint8_t*>(dictionary_.data()),
+      dictionary_.size());
+  dictionary_id_ = static_cast<uint16_t>(crc ^ (crc >> 16));
+  if (dictionary_id_ == 0) {
+    dictionary_id_ = 1;
+  }
+  for (size_t i = 0; i + MIN_MATCH <= dictionary_.size(); i++) {
+    dictionary_table_[HashPosition(dictionary_.data() + i, HASH_BITS)] =
+        static_cast<uint16_t>(i + 1);
+  }
+}
+
+uint16_t TupleCompressor::Compress(const char* data, uint16_t size, char* out,
+                                   size_t capacity) const {
+  if (data == nullptr || out == nullptr || size < MIN_COMPRESSIBLE_TUPLE_SIZE) {
+    return 0;
+  }
+  // Larger than the tuple is no use
+  const size_t limit = std::min<size_t>(capacity, size - 1);
+  if (limit <= COMPRESSED_TUPLE_HEADER_SIZE) {
+    return 0;
+  }
+
+  const size_t base = dictionary_.size();
+  const size_t end = base + size;
+  char* window = Window(end);
+  std::memcpy(window, dictionary_.data(), base);
+  std::memcpy(window + base, data, size);
+
+  uint16_t table[size_t{1} << HASH_BITS];
+  std::memcpy(table, dictionary_table_.data(), sizeof(table));
+
+  char* op = out + COMPRESSED_TUPLE_HEADER_SIZE;
+  char* const out_end = out + limit;
+  const size_t match_limit = end - MATCH_FIND_LIMIT;
+  const size_t match_end_limit = end - LAST_LITERALS;
+  size_t anchor = base;
+  size_t ip = base;
+
+  while (ip < match_limit) {
+    const size_t hash = HashPosition(window + ip, HASH_BITS);
+    const size_t candidate = table[hash];
+    table[hash] = static_cast<uint16_t>(ip + 1);
+    if (candidate == 0 || ip - (candidate - 1) > MAX_OFFSET ||
+        Load32(window + candidate - 1) != Load32(window + ip)) {
+      ip++;
+      continue;
+    }
+
+    size_t match = candidate - 1;
+    while (ip > anchor && match > 0 && window[ip - 1] == window[match - 1]) {
+      ip--;
+      match--;
+    }
+    size_t length = MIN_MATCH;
+    while (ip + length < match_end_limit &&
+           window[ip + length] == window[match + length]) {
+      length++;
+    }
+
+    const size_t literals = ip - anchor;
+    const size_t needed = 1 + LengthBytes(literals) + literals + 2 +
+                          LengthBytes(length - MIN_MATCH);
+    if (static_cast<size_t>(out_end - op) < needed) {
+      return 0;
+    }
+
+    char* token = op++;
+    *token = static_cast<char>(std::min<size_t>(literals, 15) << 4);
+    if (literals >= 15) {
+      op = WriteLength(literals, op);
+    }
+    std::memcpy(op, window + anchor, literals);
+    op += literals;
+
+    const size_t offset = ip - match;
+    *op++ = static_cast<char>(offset);
+    *op++ = static_cast<char>(offset >> 8);
+    *token = static_cast<char>(*token |
+                               std::min<size_t>(length - MIN_MATCH, 15));
+    if (length - MIN_MATCH >= 15) {
+      op = WriteLength(length - MIN_MATCH, op);
+    }
+
+    ip += length;
+    anchor = ip;
+  }
+
+  const size_t literals = end - anchor;
+  if (static_cast<size_t>(out_end - op) <
+      1 + LengthBytes(literals) + literals) {
+    return 0;
+  }
+  *op++ = static_cast<char>(std::min<size_t>(literals, 15) << 4);
+  if (literals >= 15) {
+    op = WriteLength(literals, op);
+  }
+  std::memcpy(op, window + anchor, literals);
+  op += literals;
+
+  const CompressedTupleHeader header{size, dictionary_id_};
+  std::memcpy(out, &header, sizeof(header));
+  return static_cast<uint16_t>(op - out);
+}
+
+uint16_t TupleCompressor::RawSize(const char* stored, uint16_t stored_size) {
+  if (stored == nullptr || stored_size < COMPRESSED_TUPLE_HEADER_SIZE) {
+    return 0;
+  }
+  CompressedTupleHeader header;
+  std::memcpy(&header, stored, sizeof(header));
+  return header.raw_size;
+}
+
+ErrorCode TupleCompressor::Decompress(const char* stored, uint16_t stored_size,
+                                      char* out, size_t capacity,
+                                      uint16_t* size) const {
+  if (stored == nullptr || out == nullptr ||
+      stored_size < COMPRESSED_TUPLE_HEADER_SIZE) {
+    return {-1, "TupleCompressor::Decompress: Corrupt payload"};
+  }
+  CompressedTupleHeader header;
+  std::memcpy(&header, stored, sizeof(header));
+  if (header.dictionary_id != 0 && header.dictionary_id != dictionary_id_) {
+    return {-2, "TupleCompressor::Decompress: Tuple was compressed with "
+                "another dictionary"};
+  }
+  if (header.raw_size > capacity) {
+    return {-3, "TupleCompressor::Decompress: Buffer too small"};
+  }
+
+  const char* dictionary = dictionary_.data();
+  const size_t dictionary_size =
+      header.dictionary_id != 0 ? dictionary_.size() : 0;
+  const char* ip = stored + COMPRESSED_TUPLE_HEADER_SIZE;
+  const char* const in_end = stored + stored_size;
+  const size_t out_end = header.raw_size;
+  size_t op = 0;
+
+  for (;;) {
+    if (ip >= in_end) {
+      return {-1, "TupleCompressor::Decompress: Corrupt payload"};
+    }
+    const uint8_t token = static_cast<uint8_t>(*ip++);
+
+    size_t literals = token >> 4;
+    if (literals == 15 && !ReadLength(&ip, in_end, &literals)) {
+      return {-1, "TupleCompressor::Decompress: Corrupt payload"};
+    }
+    if (literals > static_cast<size_t>(in_end - ip) ||
+        literals > out_end - op) {
+      return {-1, "TupleCompressor::Decompress: Corrupt payload"};
+    }
+    std::memcpy(out + op, ip, literals);
+    op += literals;
+    ip += literals;
+    if (ip == in_end) {
+      break;  // the last sequence has no match
+    }
+
+    if (in_end - ip < 2) {
+      return {-1, "TupleCompressor::Decompress: Corrupt payload"};
+    }
+    const size_t offset = static_cast<uint8_t>(ip[0]) |
+                          (static_cast<size_t>(static_cast<uint8_t>(ip[1]))
+                           << 8);
+    ip += 2;
+    size_t length = token & 15;
+    if (length == 15 && !ReadLength(&ip, in_end, &length)) {
+      return {-1, "TupleCompressor::Decompress: Corrupt payload"};
+    }
+    length += MIN_MATCH;
+    if (offset == 0 || offset > op + dictionary_size ||
+        length > out_end - op) {
+      return {-1, "TupleCompressor::Decompress: Corrupt payload"};
+    }
+
+    if (offset <= op && offset >= length) {
+      std::memcpy(out + op, out + op - offset, length);
+      op += length;
+    } else {
+      // Overlapping or reaching into the dictionary
+      for (size_t i = 0; i < length; i++, op++) {
+        out[op] = offset <= op ? out[op - offset]
+                               : dictionary[dictionary_size - (offset - op)];
+      }
+    }
+  }
+
+  if (op != out_end) {
+    return {-1, "TupleCompressor::Decompress: Corrupt payload"};
+  }
+  *size = header.raw_size;
+  return {0, "TupleCompressor::Decompress: Success"};
+}
+
+std::string TupleCompressor::TrainDictionary(
+    const std::vector<std::string>& samples, size_t max_size) {
+  constexpr size_t GRAM = 8;
+  constexpr size_t SEGMENT = 32;
+  max_size = std::min(max_size, MAX_COMPRESSION_DICTIONARY_SIZE);
+
+  auto gram_at = [](const std::string& sample, size_t i) {
+    uint64_t gram;
+    std::memcpy(&gram, sample.data() + i, sizeof(gram));
+    return gram;
+  };
+
+  // Number of samples each 8-byte substring occurs in
+  std::unordered_map<uint64_t, uint32_t> frequency;
+  for (const std::string& sample : samples) {
+    std::unordered_set<uint64_t> seen;
+    for (size_t i = 0; i + GRAM <= sample.size(); i++) {
+      if (seen.insert(gram_at(sample, i)).second) {
+        frequency[gram_at(sample, i)]++;
+      }
+    }
+  }
+
+  // Candidate segments at half-segment strides, scored by how many other
+  // samples share their substrings
+  struct Segment {
+    size_t sample;
+    size_t offset;
+    size_t length;
+    uint64_t score;
+  };
+  std::vector<Segment> segments;
+  for (size_t s = 0; s < samples.size(); s++) {
+    const std::string& sample = samples[s];
+    for (size_t offset = 0; offset + GRAM <= sample.size();
+         offset += SEGMENT / 2) {
+      const size_t length = std::min(SEGMENT, sample.size() - offset);
+      uint64_t score = 0;
+      for (size_t i = offset; i + GRAM <= offset + length; i++) {
+        score += frequency[gram_at(sample, i)] - 1;
+      }
+      if (score > 0) {
+        segments.push_back({s, offset, length, score});
+      }
+    }
+  }
+  std::stable_sort(segments.begin(), segments.end(),
+                   [](const Segment& a, const Segment& b) {
+                     return a.score > b.score;
+                   });
+
+  // Take the best segments that still add substrings not yet covered
+  std::unordered_set<uint64_t> covered;
+  std::vector<const Segment*> chosen;
+  size_t total = 0;
+  for (const Segment& segment : segments) {
+    if (total + segment.length > max_size) {
+      continue;
+    }
+    const std::string& sample = samples[segment.sample];
+    bool adds = false;
+    for (size_t i = segment.offset; i + GRAM <= segment.offset + segment.length;
+         i++) {
+      adds = covered.insert(gram_at(sample, i)).second || adds;
+    }
+    if (adds) {
+      chosen.push_back(&segment);
+      total += segment.length;
+    }
+  }
+
+  std::string dictionary;
+  dictionary.reserve(total);
+  for (auto it = chosen.rbegin(); it != chosen.rend(); ++it) {
+    dictionary.append(samples[(*it)->sample], (*it)->offset, (*it)->length);
+  }
+  return dictionary;
+}
@@ -0,0 +1,95 @@
+#include "../../include/common/histogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+LatencyHistogram::LatencyHistogram()
+    : buckets_(BUCKET_COUNT, 0), count_(0), max_(0), sum_(0) {}
+
+size_t LatencyHistogram::BucketFor(uint64_t nanos) {
+  if (nanos < SUB_BUCKETS) {
+    return static_cast<size_t>(nanos);
+  }
+  size_t msb = 63 - static_cast<size_t>(__builtin_clzll(nanos));
+  size_t shift = msb - SUB_BUCKET_BITS;
+  size_t sub = static_cast<size_t>(nanos >> shift) & (SUB_BUCKETS - 1);
+  return (shift + 1) * SUB_BUCKETS + sub;
+}
+
+uint64_t LatencyHistogram::BucketUpperBound(size_t bucket) {
+  if (bucket < SUB_BUCKETS) {
+    return bucket;
+  }
+  size_t shift = bucket / SUB_BUCKETS - 1;
+  uint64_t lower = static_cast<uint64_t>(SUB_BUCKETS + bucket % SUB_BUCKETS)
+                   << shift;
+  return lower + ((uint64_t{1} << shift) - 1);
+}
+
+void LatencyHistogram::Record(uint64_t nanos) {
+  buckets_[BucketFor(nanos)]++;
+  count_++;
+  max_ = std::max(max_, nanos);
+  sum_ += static_cast<double>(nanos);
+}
+
+void LatencyHistogram::Merge(const LatencyHistogram& other) {
+  for (size_t i = 0; i < BUCKET_COUNT; i++) {
+    buckets_[i] += other.buckets_[i];
+  }
+  count_ += other.count_;
+  max_ = std::max(max_, other.max_);
+  sum_ += other.sum_;
+}
+
+double LatencyHistogram::GetMean() const {
+  return count_ == 0 ? 0 : sum_ / static_cast<double>(count_);
+}
+
+uint64_t LatencyHistogram::GetPercentile(double fraction) const {
+  if (count_ == 0) {
+    return 0;
+  }
+  uint64_t target = static_cast<uint64_t>(
+      std::ceil(std::clamp(fraction, 0.0, 1.0) * static_cast<double>(count_)));
+  target = std::max<uint64_t>(target, 1);
+  uint64_t seen = 0;
+  for (size_t i = 0; i < BUCKET_COUNT; i++) {
+    seen += buckets_[i];
+    if (seen >= target) {
+      return std::min(BucketUpperBound(i), max_);
+    }
+  }
+  return max_;
+}
+
+
+AtomicLatencyHistogram::AtomicLatencyHistogram()
+    : buckets_(new std::atomic<uint64_t>[LatencyHistogram::BUCKET_COUNT]) {
+  for (size_t i = 0; i < LatencyHistogram::BUCKET_COUNT; i++) {
+    buckets_[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+void AtomicLatencyHistogram::Record(uint64_t nanos) {
+  buckets_[LatencyHistogram::BucketFor(nanos)].fetch_add(
+      1, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+  sum_.fetch_add(nanos, std::memory_order_relaxed);
+  uint64_t max = max_.load(std::memory_order_relaxed);
+  while (nanos > max &&
+         !max_.compare_exchange_weak(max, nanos, std::memory_order_relaxed)) {
+  }
+}
+
+LatencyHistogram AtomicLatencyHistogram::Snapshot() const {
+  LatencyHistogram snapshot;
+  // Count from the copied buckets, so percentiles stay consistent with them
+  for (size_t i = 0; i < LatencyHistogram::BUCKET_COUNT; i++) {
+    snapshot.buckets_[i] = buckets_[i].load(std::memory_order_relaxed);
+    snapshot.count_ += snapshot.buckets_[i];
+  }
+  snapshot.max_ = max_.load(std::memory_order_relaxed);
+  snapshot.sum_ = static_cast<double>(sum_.load(std::memory_order_relaxed));
+  return snapshot;
+}
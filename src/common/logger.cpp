@@ -1,13 +1,27 @@
 #include "common/logger.h"
 
+#include <algorithm>
 #include <chrono>
+#include <cstdarg>
+#include <cstdio>
 #include <filesystem>
 #include <iomanip>
 #include <iostream>
+#include <vector>
 
 namespace storage {
 
-Logger::Logger() : debugMode_(false), logDirectory_("logs"), currentDate_("") {
+Logger::Logger()
+    : debugMode_(false),
+      logDirectory_("logs"),
+      currentDate_(""),
+      async_(false),
+      activeProducers_(0),
+      overflowPolicy_(LogOverflowPolicy::DROP),
+      enqueuedCount_(0),
+      writtenCount_(0),
+      droppedCount_(0),
+      stopWriter_(false) {
   // Read log directory from environment variable, fallback to "logs"
   const char* envLogDir = std::getenv("STORAGE_ENGINE_LOG_DIR");
   if (envLogDir != nullptr && envLogDir[0] != '\0') {
@@ -20,6 +34,8 @@ Logger::Logger() : debugMode_(false), logDirectory_("logs"), currentDate_("") {
 }
 
 Logger::~Logger() {
+  disableAsync();  // flush-on-shutdown: drains every accepted record
+
   std::lock_guard<std::mutex> lock(mutex_);
   if (logFile_.is_open()) {
     logFile_.close();
@@ -31,15 +47,9 @@ Logger& Logger::getInstance() {
   return instance;
 }
 
-void Logger::setDebugMode(bool debug) {
-  std::lock_guard<std::mutex> lock(mutex_);
-  debugMode_ = debug;
-}
+void Logger::setDebugMode(bool debug) { debugMode_.store(debug); }
 
-bool Logger::isDebugMode() const {
-  std::lock_guard<std::mutex> lock(mutex_);
-  return debugMode_;
-}
+bool Logger::isDebugMode() const { return debugMode_.load(); }
 
 void Logger::setLogDirectory(const std::string& dir) {
   std::lock_guard<std::mutex> lock(mutex_);
@@ -65,10 +75,36 @@ void Logger::error(const std::string& message) {
 }
 
 void Logger::log(LogLevel level, const std::string& message) {
+  if (!shouldLog(level)) {
+    return;
+  }
+  if (async_.load() && enqueueAsync(level, message)) {
+    return;
+  }
   std::lock_guard<std::mutex> lock(mutex_);
   logInternal(level, message);
 }
 
+void Logger::logf(LogLevel level, const char* format, ...) {
+  if (!shouldLog(level)) {
+    return;
+  }
+
+  char buffer[512];
+  va_list args;
+  va_start(args, format);
+  int length = std::vsnprintf(buffer, sizeof(buffer), format, args);
+  va_end(args);
+  if (length < 0) {
+    return;
+  }
+
+  // Longer messages are truncated rather than allocating a bigger buffer
+  const size_t written =
+      std::min(static_cast<size_t>(length), sizeof(buffer) - 1);
+  log(level, std::string(buffer, written));
+}
+
 void Logger::logInternal(LogLevel level, const std::string& message) {
   // Check if we should log this level
   if (!shouldLog(level)) {
@@ -78,20 +114,153 @@ void Logger::logInternal(LogLevel level, const std::string& message) {
   // Rotate log file if needed (new day)
   rotateLogFileIfNeeded();
 
+  writeRecord({level, formatRecord(level, message)});
+  if (logFile_.is_open()) {
+    logFile_.flush();  // Ensure immediate write
+  }
+}
+
+std::string Logger::formatRecord(LogLevel level,
+                                 const std::string& message) const {
   // Format: [TIMESTAMP] [LEVEL] message
-  std::string logEntry = "[" + getCurrentTimestamp() + "] " + "[" +
-                         logLevelToString(level) + "] " + message + "\n";
+  return "[" + getCurrentTimestamp() + "] " + "[" + logLevelToString(level) +
+         "] " + message + "\n";
+}
 
+void Logger::writeRecord(const Record& record) {
   // Write to file
   if (logFile_.is_open()) {
-    logFile_ << logEntry;
-    logFile_.flush();  // Ensure immediate write
+    logFile_ << record.text;
   }
 
   // Also output to console for errors and warnings
-  if (level == LogLevel::ERROR || level == LogLevel::WARNING) {
-    std::cerr << logEntry;
+  if (record.level == LogLevel::ERROR || record.level == LogLevel::WARNING) {
+    std::cerr << record.text;
+  }
+}
+
+void Logger::enableAsync(size_t capacity, LogOverflowPolicy policy) {
+  std::lock_guard<std::mutex> config_lock(asyncConfigMutex_);
+  overflowPolicy_.store(policy);
+  if (async_.load()) {
+    return;
+  }
+
+  // Not async and disableAsync() waited out all producers: safe to replace
+  ring_ = std::make_unique<MpscRingBuffer<Record>>(capacity);
+  {
+    std::lock_guard<std::mutex> lock(writerMutex_);
+    stopWriter_ = false;
   }
+  writerThread_ = std::thread(&Logger::writerLoop, this);
+  async_.store(true);
+}
+
+void Logger::disableAsync() {
+  std::lock_guard<std::mutex> config_lock(asyncConfigMutex_);
+  if (!async_.exchange(false)) {
+    return;
+  }
+
+  // New callers now log synchronously; wait for pushes already under way
+  while (activeProducers_.load() != 0) {
+    std::this_thread::yield();
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(writerMutex_);
+    stopWriter_ = true;
+  }
+  writerCv_.notify_one();
+  writerThread_.join();  // the writer drains the ring before exiting
+}
+
+void Logger::flush() {
+  if (!async_.load()) {
+    return;  // synchronous writes are flushed as they happen
+  }
+
+  const uint64_t target = enqueuedCount_.load();
+  std::unique_lock<std::mutex> lock(writerMutex_);
+  writerCv_.notify_one();
+  flushCv_.wait(lock, [this, target]() {
+    return writtenCount_.load() >= target || stopWriter_;
+  });
+}
+
+bool Logger::enqueueAsync(LogLevel level, const std::string& message) {
+  // Announce ourselves before re-checking async_, so disableAsync() either
+  // sees us and waits, or we see it and fall back to the synchronous path
+  activeProducers_.fetch_add(1);
+  if (!async_.load()) {
+    activeProducers_.fetch_sub(1);
+    return false;
+  }
+
+  Record record{level, formatRecord(level, message)};
+  bool pushed = ring_->TryPush(std::move(record));
+  if (!pushed && overflowPolicy_.load() == LogOverflowPolicy::BLOCK) {
+    writerCv_.notify_one();
+    while (!(pushed = ring_->TryPush(std::move(record)))) {
+      std::this_thread::yield();
+    }
+  }
+
+  if (pushed) {
+    enqueuedCount_.fetch_add(1);
+  } else {
+    droppedCount_.fetch_add(1);
+  }
+  activeProducers_.fetch_sub(1);
+  return true;
+}
+
+void Logger::writerLoop() {
+  constexpr size_t kMaxBatch = 256;
+  std::vector<Record> batch;
+  batch.reserve(kMaxBatch);
+
+  for (;;) {
+    Record record;
+    while (batch.size() < kMaxBatch && ring_->TryPop(&record)) {
+      batch.push_back(std::move(record));
+    }
+
+    if (!batch.empty()) {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        rotateLogFileIfNeeded();
+        for (const Record& entry : batch) {
+          writeRecord(entry);
+        }
+        if (logFile_.is_open()) {
+          logFile_.flush();  // one flush per batch
+        }
+      }
+      writtenCount_.fetch_add(batch.size());
+      batch.clear();
+      {
+        // Pairs with flush()'s predicate check so the wakeup is not lost
+        std::lock_guard<std::mutex> lock(writerMutex_);
+      }
+      flushCv_.notify_all();
+      continue;
+    }
+
+    // Empty: sleep briefly. Producers do not notify on every push (that
+    // would need the mutex), so a short timeout bounds the write delay.
+    std::unique_lock<std::mutex> lock(writerMutex_);
+    if (stopWriter_) {
+      // disableAsync() already waited out producers, so this is final
+      if (!ring_->TryPop(&record)) {
+        break;
+      }
+      batch.push_back(std::move(record));
+      continue;
+    }
+    writerCv_.wait_for(lock, std::chrono::milliseconds(5));
+  }
+  flushCv_.notify_all();
 }
 
 void Logger::rotateLogFileIfNeeded() {
@@ -150,13 +319,8 @@ std::string Logger::logLevelToString(LogLevel level) const {
 }
 
 bool Logger::shouldLog(LogLevel level) const {
-  // In debug mode, log everything
-  if (debugMode_) {
-    return true;
-  }
-
-  // In non-debug mode, only log WARNING and ERROR
-  return level == LogLevel::WARNING || level == LogLevel::ERROR;
+  // In debug mode, log everything; otherwise only WARNING and ERROR
+  return isEnabled(level);
 }
 
 void Logger::openLogFile() {
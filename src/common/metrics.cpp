@@ -0,0 +1,135 @@
+#include "../../include/common/metrics.h"
+
+#include <sstream>
+
+namespace {
+
+void AppendCounter(std::ostringstream& out, const char* name,
+                   const char* help, uint64_t value) {
+  out << "# HELP storage_" << name << "_total " << help << "\n"
+      << "# TYPE storage_" << name << "_total counter\n"
+      << "storage_" << name << "_total " << value << "\n";
+}
+
+void AppendGauge(std::ostringstream& out, const char* name, const char* help,
+                 double value) {
+  out << "# HELP storage_" << name << " " << help << "\n"
+      << "# TYPE storage_" << name << " gauge\n"
+      << "storage_" << name << " " << value << "\n";
+}
+
+// One sample per NUMA node, labelled node="<n>"
+void AppendNodeGauge(std::ostringstream& out, const char* name,
+                     const char* help,
+                     const std::vector<BufferPoolNodeMetrics>& nodes,
+                     size_t BufferPoolNodeMetrics::*field) {
+  out << "# HELP storage_" << name << " " << help << "\n"
+      << "# TYPE storage_" << name << " gauge\n";
+  for (size_t node = 0; node < nodes.size(); node++) {
+    out << "storage_" << name << "{node=\"" << node << "\"} "
+        << nodes[node].*field << "\n";
+  }
+}
+
+void AppendLatency(std::ostringstream& out, const char* name,
+                   const char* help, const LatencyHistogram& histogram) {
+  out << "# HELP storage_" << name << "_ns " << help << "\n"
+      << "# TYPE storage_" << name << "_ns summary\n";
+  const char* const labels[] = {"0.5", "0.99", "0.999"};
+  const double fractions[] = {0.5, 0.99, 0.999};
+  for (size_t i = 0; i < 3; i++) {
+    out << "storage_" << name << "_ns{quantile=\"" << labels[i] << "\"} "
+        << histogram.GetPercentile(fractions[i]) << "\n";
+  }
+  out << "storage_" << name << "_ns_sum "
+      << static_cast<uint64_t>(histogram.GetSum()) << "\n"
+      << "storage_" << name << "_ns_count " << histogram.GetCount() << "\n";
+}
+
+}  // namespace
+
+double BufferPoolMetrics::GetHitRate() const {
+  const uint64_t fetches = hits + misses;
+  return fetches == 0 ? 0
+                      : static_cast<double>(hits) /
+                            static_cast<double>(fetches);
+}
+
+std::string FormatMetrics(const StorageMetrics& metrics) {
+  std::ostringstream out;
+
+  const DiskMetrics& disk = metrics.disk;
+  AppendCounter(out, "disk_page_reads", "Pages read from the data file",
+                disk.page_reads);
+  AppendCounter(out, "disk_page_writes", "Pages written to the data file",
+                disk.page_writes);
+  AppendCounter(out, "disk_syncs", "fdatasync calls on the data file",
+                disk.syncs);
+  AppendCounter(out, "disk_checksum_failures",
+                "Pages rejected by checksum verification on read",
+                disk.checksum_failures);
+  AppendCounter(out, "disk_checksum_skips",
+                "Page reads of known-good images, not verified again",
+                disk.checksum_skips);
+  AppendCounter(out, "disk_snapshot_preserved_pages",
+                "Page images copied aside before a write during a snapshot",
+                disk.snapshot_preserved_pages);
+  AppendLatency(out, "disk_read_latency", "Page read latency",
+                disk.read_latency);
+  AppendLatency(out, "disk_write_latency", "Page write call latency",
+                disk.write_latency);
+  AppendLatency(out, "disk_sync_latency", "fdatasync latency",
+                disk.sync_latency);
+
+  const BufferPoolMetrics& pool = metrics.buffer_pool;
+  AppendCounter(out, "buffer_pool_hits", "Fetches served from memory",
+                pool.hits);
+  AppendCounter(out, "buffer_pool_misses", "Fetches that read from disk",
+                pool.misses);
+  AppendCounter(out, "buffer_pool_clean_evictions",
+                "Evicted pages that needed no write", pool.clean_evictions);
+  AppendCounter(out, "buffer_pool_dirty_evictions",
+                "Evicted pages written back before reuse",
+                pool.dirty_evictions);
+  AppendGauge(out, "buffer_pool_hit_rate", "Hits / (hits + misses)",
+              pool.GetHitRate());
+  AppendGauge(out, "buffer_pool_frames", "Frames in the pool",
+              static_cast<double>(pool.pool_size));
+  AppendGauge(out, "buffer_pool_resident_pages", "Frames holding a page",
+              static_cast<double>(pool.resident_pages));
+  AppendCounter(out, "buffer_pool_local_frame_acquires",
+                "Frames taken on the faulting thread's NUMA node",
+                pool.local_frame_acquires);
+  AppendCounter(out, "buffer_pool_remote_frame_acquires",
+                "Frames taken on another NUMA node",
+                pool.remote_frame_acquires);
+  AppendNodeGauge(out, "buffer_pool_node_frames", "Frames on a NUMA node",
+                  pool.numa_nodes, &BufferPoolNodeMetrics::frames);
+  AppendNodeGauge(out, "buffer_pool_node_resident_pages",
+                  "Frames on a NUMA node holding a page", pool.numa_nodes,
+                  &BufferPoolNodeMetrics::resident_pages);
+
+  const FreeSpaceMapMetrics& fsm = metrics.fsm;
+  AppendCounter(out, "fsm_searches", "Free space searches", fsm.searches);
+  AppendCounter(out, "fsm_search_misses",
+                "Free space searches that found no page", fsm.search_misses);
+  AppendCounter(out, "fsm_search_steps", "Tree node scans by searches",
+                fsm.search_steps);
+  AppendCounter(out, "fsm_page_loads", "FSM pages loaded on demand",
+                fsm.page_loads);
+
+  const PageManagerMetrics& pm = metrics.page_manager;
+  AppendCounter(out, "forwarded_lookups",
+                "Tuple lookups that followed a forwarding chain",
+                pm.forwarded_lookups);
+  AppendCounter(out, "forwarding_hops", "Forwarding hops followed",
+                pm.forwarding_hops);
+  AppendCounter(out, "compactions", "Data pages compacted", pm.compactions);
+  AppendCounter(out, "moved_updates",
+                "Updates that grew a tuple within its page", pm.moved_updates);
+  AppendCounter(out, "forwarded_updates",
+                "Updates that moved a tuple to another page",
+                pm.forwarded_updates);
+
+  return out.str();
+}
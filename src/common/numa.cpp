@@ -0,0 +1,78 @@
+#include "../../include/common/numa.h"
+
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <string>
+
+namespace {
+
+// From <linux/mempolicy.h>
+constexpr int MPOL_PREFERRED_POLICY = 1;
+
+constexpr size_t MAX_NUMA_NODES = 64;
+
+// Highest node in a sysfs list such as "0-1,3", plus one
+size_t ReadNodeCount() {
+  std::ifstream online("/sys/devices/system/node/online");
+  std::string list;
+  if (!online || !std::getline(online, list)) {
+    return 1;
+  }
+
+  size_t highest = 0;
+  size_t value = 0;
+  bool in_number = false;
+  for (const char c : list) {
+    if (c >= '0' && c <= '9') {
+      value = value * 10 + static_cast<size_t>(c - '0');
+      in_number = true;
+    } else {
+      if (in_number && value > highest) {
+        highest = value;
+      }
+      value = 0;
+      in_number = false;
+    }
+  }
+  if (in_number && value > highest) {
+    highest = value;
+  }
+  return highest + 1 < MAX_NUMA_NODES ? highest + 1 : MAX_NUMA_NODES;
+}
+
+}  // namespace
+
+size_t GetNumaNodeCount() {
+  static const size_t node_count = ReadNodeCount();
+  return node_count;
+}
+
+size_t GetCurrentNumaNode() {
+#if defined(SYS_getcpu)
+  unsigned cpu = 0;
+  unsigned node = 0;
+  if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0 &&
+      node < GetNumaNodeCount()) {
+    return node;
+  }
+#endif
+  return 0;
+}
+
+bool BindMemoryToNumaNode(void* address, size_t size, size_t node) {
+  if (node >= GetNumaNodeCount()) {
+    return false;
+  }
+#if defined(SYS_mbind)
+  const unsigned long node_mask = 1UL << node;
+  // maxnode counts one past the last bit of the mask
+  return syscall(SYS_mbind, address, size, MPOL_PREFERRED_POLICY, &node_mask,
+                 sizeof(node_mask) * 8 + 1, 0) == 0;
+#else
+  (void)address;
+  (void)size;
+  return false;
+#endif
+}
@@ -0,0 +1,159 @@
+#include "../../include/common/trace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+uint64_t SteadyNanos() {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now().time_since_epoch())
+          .count());
+}
+
+// Span names are identifiers chosen in code, but keep the JSON valid
+void AppendJsonString(std::ostringstream& out, const char* text) {
+  out << '"';
+  for (const char* c = text; *c != '\0'; c++) {
+    if (*c == '"' || *c == '\\') {
+      out << '\\' << *c;
+    } else if (static_cast<unsigned char>(*c) >= 0x20) {
+      out << *c;
+    }
+  }
+  out << '"';
+}
+
+}  // namespace
+
+Tracer& Tracer::Instance() {
+  static Tracer instance;
+  return instance;
+}
+
+Tracer::Tracer() : epoch_ns_(SteadyNanos()) {}
+
+Tracer::ThreadState& Tracer::State() {
+  thread_local ThreadState state;
+  return state;
+}
+
+uint64_t Tracer::NowNanos() const { return SteadyNanos() - epoch_ns_; }
+
+void Tracer::SetSampleRate(uint32_t one_in_n) {
+  sample_rate_.store(one_in_n, std::memory_order_relaxed);
+}
+
+bool Tracer::SampleRoot(ThreadState* state) {
+  const uint32_t rate = sample_rate_.load(std::memory_order_relaxed);
+  if (rate == 0) {
+    return false;
+  }
+  // Every rate-th root per thread: deterministic and free of shared state
+  if (++state->roots < rate) {
+    return false;
+  }
+  state->roots = 0;
+  return true;
+}
+
+void Tracer::Record(ThreadState* state, const char* name, uint64_t start_ns,
+                    uint64_t end_ns) {
+  if (state->buffer == nullptr) {
+    std::lock_guard<std::mutex> lock(buffers_mutex_);
+    buffers_.push_back(std::make_unique<ThreadBuffer>(
+        static_cast<uint32_t>(buffers_.size() + 1)));
+    state->buffer = buffers_.back().get();
+  }
+
+  ThreadBuffer* buffer = state->buffer;
+  std::lock_guard<std::mutex> lock(buffer->mutex);
+  buffer->events[buffer->next % buffer->events.size()] = {
+      name, start_ns, end_ns - start_ns, buffer->thread_id, state->depth};
+  buffer->next++;
+}
+
+void Tracer::Clear() {
+  std::lock_guard<std::mutex> lock(buffers_mutex_);
+  for (const auto& buffer : buffers_) {
+    std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+    buffer->next = 0;
+  }
+}
+
+std::vector<TraceEvent> Tracer::Collect() const {
+  std::vector<TraceEvent> events;
+  {
+    std::lock_guard<std::mutex> lock(buffers_mutex_);
+    for (const auto& buffer : buffers_) {
+      std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+      const size_t count = std::min(buffer->next, buffer->events.size());
+      events.insert(events.end(), buffer->events.begin(),
+                    buffer->events.begin() + count);
+    }
+  }
+  // Ties: the enclosing (shallower) span first, as trace viewers expect
+  std::sort(events.begin(), events.end(),
+            [](const TraceEvent& a, const TraceEvent& b) {
+              if (a.start_ns != b.start_ns) {
+                return a.start_ns < b.start_ns;
+              }
+              return a.depth < b.depth;
+            });
+  return events;
+}
+
+std::string Tracer::ExportChromeTrace() const {
+  std::ostringstream out;
+  out << "{\"traceEvents\":[";
+  bool first = true;
+  for (const TraceEvent& event : Collect()) {
+    if (!first) {
+      out << ",";
+    }
+    first = false;
+    // Timestamps are microseconds; keep nanosecond resolution as decimals
+    out << "\n{\"name\":";
+    AppendJsonString(out, event.name);
+    out << ",\"cat\":\"storage\",\"ph\":\"X\",\"ts\":" << event.start_ns / 1000
+        << "." << std::to_string(1000 + event.start_ns % 1000).substr(1)
+        << ",\"dur\":" << event.duration_ns / 1000 << "."
+        << std::to_string(1000 + event.duration_ns % 1000).substr(1)
+        << ",\"pid\":1,\"tid\":" << event.thread_id << "}";
+  }
+  out << "\n],\"displayTimeUnit\":\"ns\"}\n";
+  return out.str();
+}
+
+bool Tracer::WriteChromeTrace(const std::string& path) const {
+  std::ofstream file(path, std::ios::trunc);
+  if (!file) {
+    return false;
+  }
+  file << ExportChromeTrace();
+  return static_cast<bool>(file);
+}
+
+TraceSpan::TraceSpan(const char* name) : name_(name) {
+  Tracer::ThreadState& state = Tracer::State();
+  if (state.depth == 0) {
+    state.sampled = Tracer::Instance().SampleRoot(&state);
+  }
+  state.depth++;
+  active_ = state.sampled;
+  if (active_) {
+    start_ns_ = Tracer::Instance().NowNanos();
+  }
+}
+
+TraceSpan::~TraceSpan() {
+  Tracer::ThreadState& state = Tracer::State();
+  state.depth--;
+  if (active_) {
+    Tracer& tracer = Tracer::Instance();
+    tracer.Record(&state, name_, start_ns_, tracer.NowNanos());
+  }
+}
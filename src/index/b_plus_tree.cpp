@@ -0,0 +1,1031 @@
+#include "../../include/index/b_plus_tree.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include "../../include/common/logger.h"
+
+namespace {
+
+constexpr size_t NODE_DATA_OFFSET = INDEX_NODE_DATA_OFFSET;
+constexpr size_t TUPLE_ID_SIZE = sizeof(page_id_t) + sizeof(slot_id_t);
+
+size_t LeafCapacity(size_t entry_size) {
+  return (PAGE_SIZE - NODE_DATA_OFFSET) / entry_size;
+}
+
+size_t InnerCapacity(size_t entry_size) {
+  return (PAGE_SIZE - NODE_DATA_OFFSET) / (entry_size + sizeof(page_id_t));
+}
+
+// Typed access to a node page. Leaves store entries from NODE_DATA_OFFSET;
+// inner nodes store separators there (slot 0 unused) followed by the child
+// array, placed for the largest node an entry size allows.
+class NodeRef {
+ public:
+  NodeRef(const PageGuard& guard, size_t entry_size)
+      : page_(guard->GetRawBuffer()),
+        entry_size_(entry_size),
+        children_offset_(NODE_DATA_OFFSET +
+                         InnerCapacity(entry_size) * entry_size) {}
+
+  IndexNodeHeader* Header() const {
+    return reinterpret_cast<IndexNodeHeader*>(page_ + sizeof(PageHeader));
+  }
+
+  IndexNodeKind Kind() const {
+    return static_cast<IndexNodeKind>(Header()->kind);
+  }
+  bool IsLeaf() const { return Kind() == IndexNodeKind::LEAF; }
+  size_t Level() const { return Header()->level; }
+  size_t Size() const { return Header()->size; }
+  void SetSize(size_t size) const {
+    Header()->size = static_cast<uint16_t>(size);
+  }
+  page_id_t Next() const { return Header()->next_page_id; }
+  void SetNext(page_id_t page_id) const { Header()->next_page_id = page_id; }
+
+  char* Entry(size_t i) const {
+    return page_ + NODE_DATA_OFFSET + i * entry_size_;
+  }
+
+  page_id_t Child(size_t i) const {
+    page_id_t child;
+    std::memcpy(&child, ChildSlot(i), sizeof(child));
+    return child;
+  }
+  void SetChild(size_t i, page_id_t child) const {
+    std::memcpy(ChildSlot(i), &child, sizeof(child));
+  }
+
+  // Shift leaf entries [from, Size()) to position to
+  void MoveEntries(size_t from, size_t to) const {
+    std::memmove(Entry(to), Entry(from), (Size() - from) * entry_size_);
+  }
+
+  // Shift inner separators and children [from, Size()) to position to
+  void MoveChildren(size_t from, size_t to) const {
+    const size_t count = Size() - from;
+    std::memmove(ChildSlot(to), ChildSlot(from), count * sizeof(page_id_t));
+    std::memmove(Entry(to), Entry(from), count * entry_size_);
+  }
+
+  IndexMetaData* Meta() const {
+    return reinterpret_cast<IndexMetaData*>(page_ + NODE_DATA_OFFSET);
+  }
+
+ private:
+  char* ChildSlot(size_t i) const {
+    return page_ + children_offset_ + i * sizeof(page_id_t);
+  }
+
+  char* page_;
+  size_t entry_size_;
+  size_t children_offset_;
+};
+
+void EncodeTupleId(TupleId tuple_id, char* out) {
+  for (size_t i = 0; i < sizeof(page_id_t); i++) {
+    out[i] = static_cast<char>(tuple_id.page_id >> (8 * (3 - i)));
+  }
+  out[4] = static_cast<char>(tuple_id.slot_id >> 8);
+  out[5] = static_cast<char>(tuple_id.slot_id);
+}
+
+TupleId DecodeTupleId(const char* in) {
+  const auto* bytes = reinterpret_cast<const uint8_t*>(in);
+  TupleId tuple_id;
+  tuple_id.page_id = 0;
+  for (size_t i = 0; i < sizeof(page_id_t); i++) {
+    tuple_id.page_id = (tuple_id.page_id << 8) | bytes[i];
+  }
+  tuple_id.slot_id = static_cast<slot_id_t>((bytes[4] << 8) | bytes[5]);
+  return tuple_id;
+}
+
+// Node count for a level of count items, each node taking about per_node
+// and at least min_per_node of them (a single node may take fewer)
+size_t NodesForLevel(size_t count, size_t per_node, size_t min_per_node) {
+  size_t nodes = (count + per_node - 1) / per_node;
+  return std::max<size_t>(1, std::min(nodes, count / min_per_node));
+}
+
+}  // namespace
+
+BPlusTree::BPlusTree(BufferPoolManager* bpm, uint16_t key_size, bool unique,
+                     page_id_t meta_page_id, size_t max_node_entries)
+    : bpm_(bpm),
+      key_size_(key_size),
+      unique_(unique),
+      entry_size_(key_size + TUPLE_ID_SIZE),
+      compare_size_(unique ? key_size : key_size + TUPLE_ID_SIZE),
+      max_leaf_entries_(0),
+      max_inner_children_(0),
+      meta_page_id_(meta_page_id),
+      root_page_id_(INVALID_PAGE_ID),
+      height_(0) {
+  if (bpm_ == nullptr) {
+    throw std::invalid_argument("BPlusTree needs a buffer pool");
+  }
+  if (key_size == 0 || key_size > MAX_INDEX_KEY_SIZE) {
+    throw std::invalid_argument("Index key size must be 1 to " +
+                                std::to_string(MAX_INDEX_KEY_SIZE));
+  }
+  if (max_node_entries != 0 && max_node_entries < 4) {
+    throw std::invalid_argument("Index nodes need at least 4 entries");
+  }
+
+  if (meta_page_id_ == INVALID_PAGE_ID) {
+    CreateMetaPage(max_node_entries);
+  } else {
+    OpenMetaPage();
+  }
+}
+
+size_t BPlusTree::GetHeight() const {
+  std::shared_lock<std::shared_mutex> lock(root_latch_);
+  return height_;
+}
+
+void BPlusTree::CreateMetaPage(size_t max_node_entries) {
+  max_leaf_entries_ = LeafCapacity(entry_size_);
+  max_inner_children_ = InnerCapacity(entry_size_);
+  if (max_node_entries != 0) {
+    max_leaf_entries_ = std::min(max_leaf_entries_, max_node_entries);
+    max_inner_children_ = std::min(max_inner_children_, max_node_entries);
+  }
+
+  PageGuard meta = NewNode(IndexNodeKind::META, 0);
+  PageGuard root = NewNode(IndexNodeKind::LEAF, 0);
+  if (!meta || !root) {
+    throw std::runtime_error("BPlusTree: Failed to allocate the meta page");
+  }
+  meta_page_id_ = meta.GetPageId();
+  root_page_id_ = root.GetPageId();
+  height_ = 1;
+
+  IndexMetaData* data = NodeRef(meta, entry_size_).Meta();
+  data->magic = INDEX_META_MAGIC;
+  data->key_size = key_size_;
+  data->unique = unique_ ? 1 : 0;
+  data->root_page_id = root_page_id_;
+  data->height = static_cast<uint32_t>(height_);
+  data->max_leaf_entries = static_cast<uint16_t>(max_leaf_entries_);
+  data->max_inner_children = static_cast<uint16_t>(max_inner_children_);
+}
+
+void BPlusTree::OpenMetaPage() {
+  PageGuard meta = FetchNode(meta_page_id_, LatchMode::SHARED);
+  if (!meta) {
+    throw std::runtime_error("BPlusTree: Failed to read the meta page");
+  }
+
+  NodeRef node(meta, entry_size_);
+  const IndexMetaData* data = node.Meta();
+  if (meta->GetPageType() != PAGE_TYPE_INDEX ||
+      node.Kind() != IndexNodeKind::META || data->magic != INDEX_META_MAGIC) {
+    throw std::runtime_error("BPlusTree: Page " +
+                             std::to_string(meta_page_id_) +
+                             " is not an index meta page");
+  }
+  if (data->key_size != key_size_ || (data->unique != 0) != unique_) {
+    throw std::runtime_error("BPlusTree: Index was created with a different "
+                             "key size or uniqueness");
+  }
+
+  root_page_id_ = data->root_page_id;
+  height_ = data->height;
+  max_leaf_entries_ = data->max_leaf_entries;
+  max_inner_children_ = data->max_inner_children;
+}
+
+void BPlusTree::WriteMetaPage() {
+  PageGuard meta = FetchNode(meta_page_id_, LatchMode::EXCLUSIVE);
+  if (!meta) {
+    // The in-memory root stays right; only a reopen would miss the change
+    LOG_ERROR_STREAM("BPlusTree::WriteMetaPage: Failed to fetch meta page "
+                     << meta_page_id_);
+    return;
+  }
+  IndexMetaData* data = NodeRef(meta, entry_size_).Meta();
+  data->root_page_id = root_page_id_;
+  data->height = static_cast<uint32_t>(height_);
+  meta.MarkDirty();
+}
+
+PageGuard BPlusTree::FetchNode(page_id_t page_id, LatchMode mode) const {
+  Page* page = bpm_->FetchPage(page_id);
+  if (page == nullptr) {
+    LOG_ERROR_STREAM("BPlusTree::FetchNode: Failed to fetch page " << page_id);
+    return PageGuard();
+  }
+  return PageGuard(bpm_, page_id, page, mode);
+}
+
+PageGuard BPlusTree::NewNode(IndexNodeKind kind, uint16_t level) {
+  page_id_t page_id = INVALID_PAGE_ID;
+  Page* page = bpm_->NewPage(&page_id);
+  if (page == nullptr) {
+    LOG_ERROR("BPlusTree::NewNode: Failed to allocate page");
+    return PageGuard();
+  }
+
+  PageGuard guard(bpm_, page_id, page, LatchMode::EXCLUSIVE);
+  page->SetPageType(PAGE_TYPE_INDEX);
+  NodeRef node(guard, entry_size_);
+  node.Header()->kind = static_cast<uint8_t>(kind);
+  node.Header()->level = level;
+  node.SetSize(0);
+  node.SetNext(INVALID_PAGE_ID);
+  guard.MarkDirty();
+  return guard;
+}
+
+void BPlusTree::FreeNode(PageGuard* node) {
+  const page_id_t page_id = node->GetPageId();
+  node->Release();
+  if (!bpm_->DeletePage(page_id)) {
+    LOG_WARNING_STREAM("BPlusTree::FreeNode: Leaking page " << page_id);
+  }
+}
+
+void BPlusTree::MakeEntry(const char* key, TupleId tuple_id,
+                          char* entry) const {
+  std::memcpy(entry, key, key_size_);
+  EncodeTupleId(tuple_id, entry + key_size_);
+}
+
+int BPlusTree::CompareEntries(const char* a, const char* b) const {
+  return std::memcmp(a, b, compare_size_);
+}
+
+size_t BPlusTree::FindChild(const PageGuard& node, const char* entry) const {
+  NodeRef ref(node, entry_size_);
+  size_t low = 1;
+  size_t high = ref.Size();
+  while (low < high) {
+    const size_t mid = low + (high - low) / 2;
+    if (CompareEntries(ref.Entry(mid), entry) <= 0) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return low - 1;
+}
+
+size_t BPlusTree::FindInLeaf(const PageGuard& node, const char* entry,
+                             bool strict) const {
+  NodeRef ref(node, entry_size_);
+  size_t low = 0;
+  size_t high = ref.Size();
+  while (low < high) {
+    const size_t mid = low + (high - low) / 2;
+    const int cmp = CompareEntries(ref.Entry(mid), entry);
+    if (cmp < 0 || (strict && cmp == 0)) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return low;
+}
+
+size_t BPlusTree::MinLeafEntries() const { return max_leaf_entries_ / 2; }
+
+size_t BPlusTree::MinInnerChildren() const { return max_inner_children_ / 2; }
+
+bool BPlusTree::IsSafe(const PageGuard& node, WriteOp op,
+                       bool is_root) const {
+  NodeRef ref(node, entry_size_);
+  const bool is_leaf = ref.IsLeaf();
+  if (op == WriteOp::INSERT) {
+    return ref.Size() < (is_leaf ? max_leaf_entries_ : max_inner_children_);
+  }
+  if (is_root) {
+    return is_leaf || ref.Size() > 2;
+  }
+  return ref.Size() > (is_leaf ? MinLeafEntries() : MinInnerChildren());
+}
+
+ErrorCode BPlusTree::Insert(const char* key, TupleId tuple_id) {
+  if (key == nullptr) {
+    return {-1, "BPlusTree::Insert: Key is null"};
+  }
+
+  std::vector<char> entry(entry_size_);
+  MakeEntry(key, tuple_id, entry.data());
+
+  ErrorCode result;
+  if (TryOptimisticWrite(WriteOp::INSERT, entry.data(), &result)) {
+    return result;
+  }
+  return PessimisticWrite(WriteOp::INSERT, entry.data());
+}
+
+ErrorCode BPlusTree::Delete(const char* key, TupleId tuple_id) {
+  if (key == nullptr) {
+    return {-1, "BPlusTree::Delete: Key is null"};
+  }
+
+  std::vector<char> entry(entry_size_);
+  MakeEntry(key, tuple_id, entry.data());
+
+  ErrorCode result;
+  if (TryOptimisticWrite(WriteOp::DELETE, entry.data(), &result)) {
+    return result;
+  }
+  return PessimisticWrite(WriteOp::DELETE, entry.data());
+}
+
+ErrorCode BPlusTree::Lookup(const char* key,
+                            std::vector<TupleId>* tuple_ids) const {
+  if (key == nullptr || tuple_ids == nullptr) {
+    return {-1, "BPlusTree::Lookup: Key or output is null"};
+  }
+
+  BPlusTreeScan scan(this, key, key);
+  TupleId tuple_id;
+  while (scan.Next(&tuple_id)) {
+    tuple_ids->push_back(tuple_id);
+  }
+  return scan.GetStatus();
+}
+
+bool BPlusTree::TryOptimisticWrite(WriteOp op, const char* entry,
+                                   ErrorCode* result) {
+  std::shared_lock<std::shared_mutex> root_lock(root_latch_);
+  size_t level = height_ - 1;
+  PageGuard node = FetchNode(
+      root_page_id_, level == 0 ? LatchMode::EXCLUSIVE : LatchMode::SHARED);
+  if (!node) {
+    *result = {-3, "BPlusTree: Failed to fetch the root"};
+    return true;
+  }
+  // A new root needs this page's exclusive latch, so it stays the root
+  root_lock.unlock();
+
+  bool is_root = true;
+  while (level > 0) {
+    const page_id_t child = NodeRef(node, entry_size_).Child(
+        FindChild(node, entry));
+    level--;
+    // Assigning releases the parent only after the child is latched
+    PageGuard next = FetchNode(
+        child, level == 0 ? LatchMode::EXCLUSIVE : LatchMode::SHARED);
+    if (!next) {
+      *result = {-3, "BPlusTree: Failed to fetch a node"};
+      return true;
+    }
+    node = std::move(next);
+    is_root = false;
+  }
+
+  if (!IsSafe(node, op, is_root)) {
+    return false;
+  }
+  *result = op == WriteOp::INSERT ? InsertIntoLeaf(&node, entry)
+                                  : DeleteFromLeaf(&node, entry);
+  return true;
+}
+
+ErrorCode BPlusTree::PessimisticWrite(WriteOp op, const char* entry) {
+  std::unique_lock<std::shared_mutex> root_lock(root_latch_);
+  WritePath path;
+  path.starts_at_root = true;
+
+  size_t level = height_ - 1;
+  PageGuard root = FetchNode(root_page_id_, LatchMode::EXCLUSIVE);
+  if (!root) {
+    return {-3, "BPlusTree: Failed to fetch the root"};
+  }
+  if (IsSafe(root, op, /*is_root=*/true)) {
+    root_lock.unlock();
+  }
+  path.nodes.push_back(std::move(root));
+
+  while (level > 0) {
+    const PageGuard& parent = path.nodes.back();
+    const size_t index = FindChild(parent, entry);
+    PageGuard child = FetchNode(NodeRef(parent, entry_size_).Child(index),
+                                LatchMode::EXCLUSIVE);
+    if (!child) {
+      return {-3, "BPlusTree: Failed to fetch a node"};
+    }
+    level--;
+
+    if (IsSafe(child, op, /*is_root=*/false)) {
+      // Nothing above a safe node can change
+      path.nodes.clear();
+      path.child_index.clear();
+      path.starts_at_root = false;
+      if (root_lock.owns_lock()) {
+        root_lock.unlock();
+      }
+    } else {
+      path.child_index.push_back(index);
+    }
+    path.nodes.push_back(std::move(child));
+  }
+
+  PageGuard& leaf = path.nodes.back();
+  const bool leaf_is_root = path.starts_at_root && path.nodes.size() == 1;
+  if (op == WriteOp::INSERT) {
+    if (IsSafe(leaf, op, leaf_is_root)) {
+      return InsertIntoLeaf(&leaf, entry);
+    }
+    const size_t position = FindInLeaf(leaf, entry, /*strict=*/false);
+    NodeRef node(leaf, entry_size_);
+    if (position < node.Size() &&
+        CompareEntries(node.Entry(position), entry) == 0) {
+      return {-2, "BPlusTree::Insert: Key already exists"};
+    }
+    return InsertWithSplit(&path, entry);
+  }
+
+  ErrorCode result = DeleteFromLeaf(&leaf, entry);
+  if (result.code != 0 || leaf_is_root) {
+    return result;
+  }
+  return FixUnderflow(&path);
+}
+
+ErrorCode BPlusTree::InsertIntoLeaf(PageGuard* leaf, const char* entry) {
+  NodeRef node(*leaf, entry_size_);
+  const size_t position = FindInLeaf(*leaf, entry, /*strict=*/false);
+  if (position < node.Size() &&
+      CompareEntries(node.Entry(position), entry) == 0) {
+    return {-2, "BPlusTree::Insert: Key already exists"};
+  }
+
+  node.MoveEntries(position, position + 1);
+  std::memcpy(node.Entry(position), entry, entry_size_);
+  node.SetSize(node.Size() + 1);
+  leaf->MarkDirty();
+  return {0, "BPlusTree::Insert: Success"};
+}
+
+ErrorCode BPlusTree::DeleteFromLeaf(PageGuard* leaf, const char* entry) {
+  NodeRef node(*leaf, entry_size_);
+  const size_t position = FindInLeaf(*leaf, entry, /*strict=*/false);
+  // A unique index compares keys only, so check the TupleId too
+  if (position >= node.Size() ||
+      std::memcmp(node.Entry(position), entry, entry_size_) != 0) {
+    return {-2, "BPlusTree::Delete: Entry not found"};
+  }
+
+  node.MoveEntries(position + 1, position);
+  node.SetSize(node.Size() - 1);
+  leaf->MarkDirty();
+  return {0, "BPlusTree::Delete: Success"};
+}
+
+ErrorCode BPlusTree::InsertWithSplit(WritePath* path, const char* entry) {
+  const size_t entry_size = entry_size_;
+  std::vector<char> separator(entry_size);
+  page_id_t new_child = INVALID_PAGE_ID;
+  page_id_t split_page_id = INVALID_PAGE_ID;
+
+  {
+    PageGuard& leaf = path->nodes.back();
+    NodeRef node(leaf, entry_size);
+    const size_t size = node.Size();
+    const size_t position = FindInLeaf(leaf, entry, /*strict=*/false);
+
+    std::vector<char> entries((size + 1) * entry_size);
+    std::memcpy(entries.data(), node.Entry(0), position * entry_size);
+    std::memcpy(entries.data() + position * entry_size, entry, entry_size);
+    std::memcpy(entries.data() + (position + 1) * entry_size,
+                node.Entry(position), (size - position) * entry_size);
+
+    PageGuard right = NewNode(IndexNodeKind::LEAF, 0);
+    if (!right) {
+      return {-4, "BPlusTree::Insert: Failed to allocate a node"};
+    }
+    NodeRef right_node(right, entry_size);
+    const size_t left_size = (size + 2) / 2;
+    const size_t right_size = size + 1 - left_size;
+    std::memcpy(node.Entry(0), entries.data(), left_size * entry_size);
+    std::memcpy(right_node.Entry(0), entries.data() + left_size * entry_size,
+                right_size * entry_size);
+    node.SetSize(left_size);
+    right_node.SetSize(right_size);
+    right_node.SetNext(node.Next());
+    node.SetNext(right.GetPageId());
+    leaf.MarkDirty();
+
+    std::memcpy(separator.data(), right_node.Entry(0), entry_size);
+    new_child = right.GetPageId();
+    split_page_id = leaf.GetPageId();
+    path->nodes.pop_back();
+  }
+
+  while (!path->nodes.empty()) {
+    PageGuard& parent = path->nodes.back();
+    NodeRef node(parent, entry_size);
+    const size_t size = node.Size();
+    const size_t position = path->child_index.back() + 1;
+    path->child_index.pop_back();
+
+    if (size < max_inner_children_) {
+      node.MoveChildren(position, position + 1);
+      std::memcpy(node.Entry(position), separator.data(), entry_size);
+      node.SetChild(position, new_child);
+      node.SetSize(size + 1);
+      parent.MarkDirty();
+      return {0, "BPlusTree::Insert: Success"};
+    }
+
+    // Split: children [0, left_size) stay, the separator in front of the
+    // first moved child goes up to the grandparent
+    std::vector<char> keys((size + 1) * entry_size);
+    std::vector<page_id_t> children(size + 1);
+    for (size_t i = 0, j = 0; i <= size; i++) {
+      if (i == position) {
+        std::memcpy(keys.data() + i * entry_size, separator.data(),
+                    entry_size);
+        children[i] = new_child;
+      } else {
+        std::memcpy(keys.data() + i * entry_size, node.Entry(j), entry_size);
+        children[i] = node.Child(j);
+        j++;
+      }
+    }
+
+    PageGuard right =
+        NewNode(IndexNodeKind::INNER, static_cast<uint16_t>(node.Level()));
+    if (!right) {
+      return {-4, "BPlusTree::Insert: Failed to allocate a node"};
+    }
+    NodeRef right_node(right, entry_size);
+    const size_t left_size = (size + 2) / 2;
+    const size_t right_size = size + 1 - left_size;
+    for (size_t i = 0; i < left_size; i++) {
+      std::memcpy(node.Entry(i), keys.data() + i * entry_size, entry_size);
+      node.SetChild(i, children[i]);
+    }
+    for (size_t i = 0; i < right_size; i++) {
+      std::memcpy(right_node.Entry(i),
+                  keys.data() + (left_size + i) * entry_size, entry_size);
+      right_node.SetChild(i, children[left_size + i]);
+    }
+    node.SetSize(left_size);
+    right_node.SetSize(right_size);
+    parent.MarkDirty();
+
+    std::memcpy(separator.data(), keys.data() + left_size * entry_size,
+                entry_size);
+    new_child = right.GetPageId();
+    split_page_id = parent.GetPageId();
+    path->nodes.pop_back();
+  }
+
+  if (!path->starts_at_root) {
+    // The top of the path was safe, so it cannot have split
+    return {-5, "BPlusTree::Insert: Split passed a safe node"};
+  }
+
+  // The root split (root_latch_ is still held): grow a level
+  PageGuard root =
+      NewNode(IndexNodeKind::INNER, static_cast<uint16_t>(height_));
+  if (!root) {
+    return {-4, "BPlusTree::Insert: Failed to allocate a node"};
+  }
+  NodeRef node(root, entry_size);
+  node.SetChild(0, split_page_id);
+  std::memcpy(node.Entry(1), separator.data(), entry_size);
+  node.SetChild(1, new_child);
+  node.SetSize(2);
+  root_page_id_ = root.GetPageId();
+  height_++;
+  WriteMetaPage();
+  return {0, "BPlusTree::Insert: Success"};
+}
+
+ErrorCode BPlusTree::FixUnderflow(WritePath* path) {
+  const size_t entry_size = entry_size_;
+
+  while (true) {
+    const size_t depth = path->nodes.size() - 1;
+    PageGuard& guard = path->nodes.back();
+    NodeRef node(guard, entry_size);
+
+    if (path->starts_at_root && depth == 0) {
+      // root_latch_ is still held. An inner root left with one child
+      // hands the root to it.
+      if (!node.IsLeaf() && node.Size() == 1) {
+        root_page_id_ = node.Child(0);
+        height_--;
+        WriteMetaPage();
+        FreeNode(&guard);
+      }
+      return {0, "BPlusTree::Delete: Success"};
+    }
+
+    const size_t min_size =
+        node.IsLeaf() ? MinLeafEntries() : MinInnerChildren();
+    if (node.Size() >= min_size || depth == 0) {
+      return {0, "BPlusTree::Delete: Success"};
+    }
+
+    PageGuard& parent = path->nodes[depth - 1];
+    NodeRef parent_node(parent, entry_size);
+    const size_t index = path->child_index.back();
+
+    // Latch the sibling pair left to right, the order scans use. The
+    // parent's exclusive latch keeps every other writer out meanwhile.
+    PageGuard left;
+    PageGuard right;
+    const bool node_is_right = index > 0;
+    if (node_is_right) {
+      const page_id_t node_id = guard.GetPageId();
+      guard.Release();
+      left = FetchNode(parent_node.Child(index - 1), LatchMode::EXCLUSIVE);
+      right = FetchNode(node_id, LatchMode::EXCLUSIVE);
+    } else {
+      left = std::move(guard);
+      right = FetchNode(parent_node.Child(1), LatchMode::EXCLUSIVE);
+    }
+    path->nodes.pop_back();
+    path->child_index.pop_back();
+    if (!left || !right) {
+      return {-3, "BPlusTree: Failed to fetch a node"};
+    }
+
+    const size_t right_index = node_is_right ? index : 1;
+    NodeRef left_node(left, entry_size);
+    NodeRef right_node(right, entry_size);
+    const size_t left_size = left_node.Size();
+    const size_t right_size = right_node.Size();
+    const bool is_leaf = left_node.IsLeaf();
+    const size_t max_size =
+        is_leaf ? max_leaf_entries_ : max_inner_children_;
+
+    if (left_size + right_size <= max_size) {
+      // Merge right into left and drop right from the parent
+      if (is_leaf) {
+        std::memcpy(left_node.Entry(left_size), right_node.Entry(0),
+                    right_size * entry_size);
+        left_node.SetNext(right_node.Next());
+      } else {
+        // The parent's separator becomes the key of right's first child
+        std::memcpy(left_node.Entry(left_size),
+                    parent_node.Entry(right_index), entry_size);
+        left_node.SetChild(left_size, right_node.Child(0));
+        for (size_t i = 1; i < right_size; i++) {
+          std::memcpy(left_node.Entry(left_size + i), right_node.Entry(i),
+                      entry_size);
+          left_node.SetChild(left_size + i, right_node.Child(i));
+        }
+      }
+      left_node.SetSize(left_size + right_size);
+      left.MarkDirty();
+
+      parent_node.MoveChildren(right_index + 1, right_index);
+      parent_node.SetSize(parent_node.Size() - 1);
+      parent.MarkDirty();
+
+      left.Release();
+      FreeNode(&right);
+      continue;  // the parent may be under half full now
+    }
+
+    // Borrow one entry (or child) from the sibling
+    if (node_is_right) {
+      if (is_leaf) {
+        right_node.MoveEntries(0, 1);
+        std::memcpy(right_node.Entry(0), left_node.Entry(left_size - 1),
+                    entry_size);
+        std::memcpy(parent_node.Entry(right_index), right_node.Entry(0),
+                    entry_size);
+      } else {
+        right_node.MoveChildren(0, 1);
+        right_node.SetChild(0, left_node.Child(left_size - 1));
+        std::memcpy(right_node.Entry(1), parent_node.Entry(right_index),
+                    entry_size);
+        std::memcpy(parent_node.Entry(right_index),
+                    left_node.Entry(left_size - 1), entry_size);
+      }
+      left_node.SetSize(left_size - 1);
+      right_node.SetSize(right_size + 1);
+    } else {
+      if (is_leaf) {
+        std::memcpy(left_node.Entry(left_size), right_node.Entry(0),
+                    entry_size);
+        right_node.MoveEntries(1, 0);
+        std::memcpy(parent_node.Entry(right_index), right_node.Entry(0),
+                    entry_size);
+      } else {
+        std::memcpy(left_node.Entry(left_size),
+                    parent_node.Entry(right_index), entry_size);
+        left_node.SetChild(left_size, right_node.Child(0));
+        std::memcpy(parent_node.Entry(right_index), right_node.Entry(1),
+                    entry_size);
+        right_node.MoveChildren(1, 0);
+      }
+      left_node.SetSize(left_size + 1);
+      right_node.SetSize(right_size - 1);
+    }
+    left.MarkDirty();
+    right.MarkDirty();
+    parent.MarkDirty();
+    return {0, "BPlusTree::Delete: Success"};
+  }
+}
+
+ErrorCode BPlusTree::ReadLeafEntries(const char* from, bool strict,
+                                     const char* high_key,
+                                     std::vector<char>* out,
+                                     bool* more) const {
+  out->clear();
+  *more = false;
+
+  std::shared_lock<std::shared_mutex> root_lock(root_latch_);
+  size_t level = height_ - 1;
+  PageGuard node = FetchNode(root_page_id_, LatchMode::SHARED);
+  if (!node) {
+    return {-3, "BPlusTree: Failed to fetch the root"};
+  }
+  root_lock.unlock();
+
+  while (level > 0) {
+    const size_t index = from != nullptr ? FindChild(node, from) : 0;
+    PageGuard child = FetchNode(NodeRef(node, entry_size_).Child(index),
+                                LatchMode::SHARED);
+    if (!child) {
+      return {-3, "BPlusTree: Failed to fetch a node"};
+    }
+    node = std::move(child);
+    level--;
+  }
+
+  size_t position = from != nullptr ? FindInLeaf(node, from, strict) : 0;
+  while (position >= NodeRef(node, entry_size_).Size()) {
+    const page_id_t next = NodeRef(node, entry_size_).Next();
+    if (next == INVALID_PAGE_ID) {
+      return {0, "BPlusTree: Success"};
+    }
+    PageGuard next_leaf = FetchNode(next, LatchMode::SHARED);
+    if (!next_leaf) {
+      return {-3, "BPlusTree: Failed to fetch a node"};
+    }
+    node = std::move(next_leaf);
+    position = 0;
+  }
+
+  NodeRef leaf(node, entry_size_);
+  for (; position < leaf.Size(); position++) {
+    const char* entry = leaf.Entry(position);
+    if (high_key != nullptr && std::memcmp(entry, high_key, key_size_) > 0) {
+      return {0, "BPlusTree: Success"};
+    }
+    out->insert(out->end(), entry, entry + entry_size_);
+  }
+  *more = leaf.Next() != INVALID_PAGE_ID;
+  return {0, "BPlusTree: Success"};
+}
+
+ErrorCode BPlusTree::BulkLoad(const std::vector<IndexEntry>& entries,
+                              double fill_factor) {
+  if (fill_factor <= 0 || fill_factor > 1) {
+    return {-1, "BPlusTree::BulkLoad: Fill factor must be in (0, 1]"};
+  }
+
+  std::unique_lock<std::shared_mutex> root_lock(root_latch_);
+  PageGuard first_leaf = FetchNode(root_page_id_, LatchMode::EXCLUSIVE);
+  if (!first_leaf) {
+    return {-3, "BPlusTree: Failed to fetch the root"};
+  }
+  if (height_ != 1 || NodeRef(first_leaf, entry_size_).Size() != 0) {
+    return {-2, "BPlusTree::BulkLoad: Tree is not empty"};
+  }
+
+  const size_t count = entries.size();
+  std::vector<char> encoded(count * entry_size_);
+  for (size_t i = 0; i < count; i++) {
+    if (entries[i].key.size() != key_size_) {
+      return {-6, "BPlusTree::BulkLoad: Key size mismatch"};
+    }
+    char* entry = encoded.data() + i * entry_size_;
+    MakeEntry(entries[i].key.data(), entries[i].tuple_id, entry);
+    if (i > 0 && CompareEntries(entry - entry_size_, entry) >= 0) {
+      return {-7, "BPlusTree::BulkLoad: Entries are not sorted or repeat a "
+                  "key"};
+    }
+  }
+  if (count == 0) {
+    return {0, "BPlusTree::BulkLoad: Success"};
+  }
+
+  // Leaf level: spread the entries evenly so no leaf is under half full
+  const size_t per_leaf = std::max<size_t>(
+      1, static_cast<size_t>(max_leaf_entries_ * fill_factor));
+  const size_t leaf_count =
+      NodesForLevel(count, per_leaf, std::max<size_t>(1, MinLeafEntries()));
+  std::vector<page_id_t> level_pages;
+  std::vector<char> level_firsts;  // first entry under each node
+  level_pages.reserve(leaf_count);
+  level_firsts.reserve(leaf_count * entry_size_);
+
+  PageGuard previous;
+  size_t consumed = 0;
+  for (size_t i = 0; i < leaf_count; i++) {
+    PageGuard leaf = i == 0 ? std::move(first_leaf)
+                            : NewNode(IndexNodeKind::LEAF, 0);
+    if (!leaf) {
+      return {-4, "BPlusTree::BulkLoad: Failed to allocate a node"};
+    }
+    const size_t take = (count - consumed) / (leaf_count - i);
+    NodeRef node(leaf, entry_size_);
+    const char* source = encoded.data() + consumed * entry_size_;
+    std::memcpy(node.Entry(0), source, take * entry_size_);
+    node.SetSize(take);
+    node.SetNext(INVALID_PAGE_ID);
+    leaf.MarkDirty();
+    consumed += take;
+
+    if (previous) {
+      NodeRef(previous, entry_size_).SetNext(leaf.GetPageId());
+    }
+    level_pages.push_back(leaf.GetPageId());
+    level_firsts.insert(level_firsts.end(), source, source + entry_size_);
+    previous = std::move(leaf);
+  }
+  previous.Release();
+
+  // Inner levels, bottom-up, until one node is left
+  const size_t per_inner = std::max<size_t>(
+      2, static_cast<size_t>(max_inner_children_ * fill_factor));
+  uint16_t level = 0;
+  while (level_pages.size() > 1) {
+    level++;
+    const size_t children = level_pages.size();
+    const size_t nodes =
+        NodesForLevel(children, per_inner, MinInnerChildren());
+    std::vector<page_id_t> parent_pages;
+    std::vector<char> parent_firsts;
+    parent_pages.reserve(nodes);
+    parent_firsts.reserve(nodes * entry_size_);
+
+    size_t used = 0;
+    for (size_t i = 0; i < nodes; i++) {
+      PageGuard inner = NewNode(IndexNodeKind::INNER, level);
+      if (!inner) {
+        return {-4, "BPlusTree::BulkLoad: Failed to allocate a node"};
+      }
+      const size_t take = (children - used) / (nodes - i);
+      NodeRef node(inner, entry_size_);
+      for (size_t j = 0; j < take; j++) {
+        node.SetChild(j, level_pages[used + j]);
+        if (j > 0) {
+          std::memcpy(node.Entry(j),
+                      level_firsts.data() + (used + j) * entry_size_,
+                      entry_size_);
+        }
+      }
+      node.SetSize(take);
+      parent_pages.push_back(inner.GetPageId());
+      const char* first = level_firsts.data() + used * entry_size_;
+      parent_firsts.insert(parent_firsts.end(), first, first + entry_size_);
+      used += take;
+    }
+    level_pages.swap(parent_pages);
+    level_firsts.swap(parent_firsts);
+  }
+
+  root_page_id_ = level_pages[0];
+  height_ = level + 1;
+  WriteMetaPage();
+
+  LOG_INFO_STREAM("BPlusTree::BulkLoad: Loaded " << count << " entries, "
+                                                 << leaf_count << " leaves, "
+                                                 << "height " << height_);
+  return {0, "BPlusTree::BulkLoad: Success"};
+}
+
+ErrorCode BPlusTree::CheckIntegrity() const {
+  std::shared_lock<std::shared_mutex> root_lock(root_latch_);
+  std::vector<page_id_t> leaves;
+  ErrorCode result = CheckSubtree(root_page_id_, height_ - 1, nullptr,
+                                  nullptr, /*is_root=*/true, &leaves);
+  if (result.code != 0) {
+    return result;
+  }
+
+  // The sibling chain must visit the leaves in key order
+  for (size_t i = 0; i < leaves.size(); i++) {
+    PageGuard leaf = FetchNode(leaves[i], LatchMode::SHARED);
+    if (!leaf) {
+      return {-3, "BPlusTree: Failed to fetch a node"};
+    }
+    const page_id_t expected =
+        i + 1 < leaves.size() ? leaves[i + 1] : INVALID_PAGE_ID;
+    if (NodeRef(leaf, entry_size_).Next() != expected) {
+      return {-8, "BPlusTree::CheckIntegrity: Broken leaf chain at page " +
+                      std::to_string(leaves[i])};
+    }
+  }
+  return {0, "BPlusTree::CheckIntegrity: Success"};
+}
+
+ErrorCode BPlusTree::CheckSubtree(page_id_t page_id, size_t level,
+                                  const char* low, const char* high,
+                                  bool is_root,
+                                  std::vector<page_id_t>* leaves) const {
+  const std::string where = " at page " + std::to_string(page_id);
+  PageGuard guard = FetchNode(page_id, LatchMode::SHARED);
+  if (!guard) {
+    return {-3, "BPlusTree: Failed to fetch a node"};
+  }
+
+  NodeRef node(guard, entry_size_);
+  const bool is_leaf = level == 0;
+  if (guard->GetPageType() != PAGE_TYPE_INDEX || node.Level() != level ||
+      node.Kind() != (is_leaf ? IndexNodeKind::LEAF : IndexNodeKind::INNER)) {
+    return {-8, "BPlusTree::CheckIntegrity: Unexpected node" + where};
+  }
+
+  const size_t size = node.Size();
+  const size_t max_size = is_leaf ? max_leaf_entries_ : max_inner_children_;
+  const size_t min_size = is_root ? (is_leaf ? 0 : 2)
+                                  : (is_leaf ? MinLeafEntries()
+                                             : MinInnerChildren());
+  if (size > max_size || size < min_size) {
+    return {-8, "BPlusTree::CheckIntegrity: Node size " +
+                    std::to_string(size) + " out of bounds" + where};
+  }
+
+  // Entries (a leaf's, or an inner node's separators from 1) must be
+  // strictly increasing and inside [low, high)
+  const char* previous = low;
+  for (size_t i = is_leaf ? 0 : 1; i < size; i++) {
+    const char* entry = node.Entry(i);
+    // Only the lower bound itself may be equal
+    const int cmp = previous == nullptr ? -1 : CompareEntries(previous, entry);
+    const bool ordered = cmp < 0 || (cmp == 0 && previous == low);
+    if (!ordered || (high != nullptr && CompareEntries(entry, high) >= 0)) {
+      return {-8, "BPlusTree::CheckIntegrity: Entry out of order" + where};
+    }
+    previous = entry;
+  }
+
+  if (is_leaf) {
+    leaves->push_back(page_id);
+    return {0, "BPlusTree::CheckIntegrity: Success"};
+  }
+
+  for (size_t i = 0; i < size; i++) {
+    const char* child_low = i == 0 ? low : node.Entry(i);
+    const char* child_high = i + 1 < size ? node.Entry(i + 1) : high;
+    ErrorCode result = CheckSubtree(node.Child(i), level - 1, child_low,
+                                    child_high, /*is_root=*/false, leaves);
+    if (result.code != 0) {
+      return result;
+    }
+  }
+  return {0, "BPlusTree::CheckIntegrity: Success"};
+}
+
+BPlusTreeScan::BPlusTreeScan(const BPlusTree* tree, const char* low_key,
+                             const char* high_key)
+    : tree_(tree),
+      has_low_(low_key != nullptr),
+      has_high_(high_key != nullptr) {
+  const size_t key_size = tree_->GetKeySize();
+  if (has_low_) {
+    // The smallest entry with this key
+    low_entry_.resize(tree_->entry_size_);
+    tree_->MakeEntry(low_key, TupleId{0, 0}, low_entry_.data());
+  }
+  if (has_high_) {
+    high_key_.assign(high_key, high_key + key_size);
+  }
+}
+
+bool BPlusTreeScan::Next(TupleId* tuple_id) {
+  const size_t entry_size = tree_->entry_size_;
+  while (position_ * entry_size >= batch_.size()) {
+    if (!more_ || status_.code != 0) {
+      return false;
+    }
+
+    // Resume strictly after the last entry returned, wherever it is now
+    const bool resume = !current_.empty();
+    const char* from = resume ? current_.data()
+                              : (has_low_ ? low_entry_.data() : nullptr);
+    status_ = tree_->ReadLeafEntries(from, /*strict=*/resume,
+                                     has_high_ ? high_key_.data() : nullptr,
+                                     &batch_, &more_);
+    position_ = 0;
+    if (status_.code != 0) {
+      return false;
+    }
+  }
+
+  const char* entry = batch_.data() + position_ * entry_size;
+  current_.assign(entry, entry + entry_size);
+  position_++;
+  *tuple_id = DecodeTupleId(entry + tree_->GetKeySize());
+  return true;
+}
@@ -0,0 +1,698 @@
+#include "../../include/index/hash_index.h"
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "../../include/common/logger.h"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define STORAGEENGINE_HASH_PROBE_X86 1
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define STORAGEENGINE_HASH_PROBE_NEON 1
+#endif
+
+namespace {
+
+constexpr size_t TUPLE_ID_SIZE = sizeof(page_id_t) + sizeof(slot_id_t);
+constexpr size_t DIRECTORY_SLOTS_PER_PAGE =
+    (PAGE_SIZE - INDEX_NODE_DATA_OFFSET) / sizeof(page_id_t);
+constexpr size_t MAX_DIRECTORY_PAGES =
+    (PAGE_SIZE - INDEX_NODE_DATA_OFFSET - sizeof(HashIndexMetaData)) /
+    sizeof(page_id_t);
+
+static_assert(((size_t{1} << HASH_INDEX_MAX_GLOBAL_DEPTH) +
+               DIRECTORY_SLOTS_PER_PAGE - 1) /
+                      DIRECTORY_SLOTS_PER_PAGE <=
+                  MAX_DIRECTORY_PAGES,
+              "The meta page must list every directory page");
+
+// Fingerprint bytes are padded so the probe can load whole vectors
+size_t PaddedFingerprints(size_t capacity) { return (capacity + 15) / 16 * 16; }
+
+size_t MaxBucketCapacity(size_t entry_size) {
+  return (PAGE_SIZE - INDEX_NODE_DATA_OFFSET - 15) / (entry_size + 1);
+}
+
+// FNV-1a over the key, then the murmur3 finalizer so that the low bits
+// (the directory slot) and the top byte (the fingerprint) both depend on
+// every key byte. Stored in the index layout: do not change.
+uint64_t HashKey(const char* key, size_t size) {
+  uint64_t hash = 14695981039346656037ull;
+  for (size_t i = 0; i < size; i++) {
+    hash ^= static_cast<uint8_t>(key[i]);
+    hash *= 1099511628211ull;
+  }
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdull;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ull;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+uint8_t FingerprintOf(uint64_t hash) {
+  return static_cast<uint8_t>(hash >> 56);
+}
+
+uint64_t LowBits(size_t bits) { return (uint64_t{1} << bits) - 1; }
+
+// Index of the first byte equal to value in data[0, length), or length
+size_t FindByteScalar(const uint8_t* data, size_t length, uint8_t value) {
+  for (size_t i = 0; i < length; i++) {
+    if (data[i] == value) {
+      return i;
+    }
+  }
+  return length;
+}
+
+#if defined(STORAGEENGINE_HASH_PROBE_X86)
+// SSE2 is part of the x86-64 baseline
+size_t FindByteSse2(const uint8_t* data, size_t length, uint8_t value) {
+  const __m128i probe = _mm_set1_epi8(static_cast<char>(value));
+  size_t i = 0;
+  for (; i + 16 <= length; i += 16) {
+    const __m128i v =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+    const int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(v, probe));
+    if (mask != 0) {
+      return i + __builtin_ctz(static_cast<unsigned>(mask));
+    }
+  }
+  return i + FindByteScalar(data + i, length - i, value);
+}
+
+__attribute__((target("avx2"))) size_t FindByteAvx2(const uint8_t* data,
+                                                     size_t length,
+                                                     uint8_t value) {
+  const __m256i probe = _mm256_set1_epi8(static_cast<char>(value));
+  size_t i = 0;
+  for (; i + 32 <= length; i += 32) {
+    const __m256i v =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+    const uint32_t mask = static_cast<uint32_t>(
+        _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, probe)));
+    if (mask != 0) {
+      return i + __builtin_ctz(mask);
+    }
+  }
+  return i + FindByteSse2(data + i, length - i, value);
+}
+#endif
+
+#if defined(STORAGEENGINE_HASH_PROBE_NEON)
+size_t FindByteNeon(const uint8_t* data, size_t length, uint8_t value) {
+  const uint8x16_t probe = vdupq_n_u8(value);
+  size_t i = 0;
+  for (; i + 16 <= length; i += 16) {
+    const uint8x16_t eq = vceqq_u8(vld1q_u8(data + i), probe);
+    if (vmaxvq_u8(eq) != 0) {
+      return i + FindByteScalar(data + i, 16, value);
+    }
+  }
+  return i + FindByteScalar(data + i, length - i, value);
+}
+#endif
+
+using FindByteFn = size_t (*)(const uint8_t*, size_t, uint8_t);
+
+FindByteFn ResolveFindByte() {
+#if defined(STORAGEENGINE_HASH_PROBE_X86)
+  if (__builtin_cpu_supports("avx2")) {
+    return FindByteAvx2;
+  }
+  return FindByteSse2;
+#elif defined(STORAGEENGINE_HASH_PROBE_NEON)
+  return FindByteNeon;
+#else
+  return FindByteScalar;
+#endif
+}
+
+size_t FindByte(const uint8_t* data, size_t length, uint8_t value) {
+  static const FindByteFn impl = ResolveFindByte();
+  return impl(data, length, value);
+}
+
+IndexNodeHeader* NodeHeader(const PageGuard& page) {
+  return reinterpret_cast<IndexNodeHeader*>(page->GetRawBuffer() +
+                                            sizeof(PageHeader));
+}
+
+IndexNodeKind KindOf(const PageGuard& page) {
+  return static_cast<IndexNodeKind>(NodeHeader(page)->kind);
+}
+
+HashIndexMetaData* MetaData(const PageGuard& page) {
+  return reinterpret_cast<HashIndexMetaData*>(page->GetRawBuffer() +
+                                              INDEX_NODE_DATA_OFFSET);
+}
+
+// Page ids listed in a meta or directory page
+char* PageIdSlot(const PageGuard& page, size_t offset, size_t i) {
+  return page->GetRawBuffer() + offset + i * sizeof(page_id_t);
+}
+
+page_id_t LoadPageId(const char* slot) {
+  page_id_t page_id;
+  std::memcpy(&page_id, slot, sizeof(page_id));
+  return page_id;
+}
+
+void StorePageId(char* slot, page_id_t page_id) {
+  std::memcpy(slot, &page_id, sizeof(page_id));
+}
+
+constexpr size_t META_DIRECTORY_OFFSET =
+    INDEX_NODE_DATA_OFFSET + sizeof(HashIndexMetaData);
+
+TupleId DecodeTupleId(const char* in) {
+  TupleId tuple_id;
+  std::memcpy(&tuple_id.page_id, in, sizeof(page_id_t));
+  std::memcpy(&tuple_id.slot_id, in + sizeof(page_id_t), sizeof(slot_id_t));
+  return tuple_id;
+}
+
+}  // namespace
+
+HashIndex::HashIndex(BufferPoolManager* bpm, uint16_t key_size, bool unique,
+                     page_id_t meta_page_id, size_t bucket_capacity)
+    : bpm_(bpm),
+      key_size_(key_size),
+      unique_(unique),
+      entry_size_(key_size + TUPLE_ID_SIZE),
+      compare_size_(unique ? key_size : key_size + TUPLE_ID_SIZE),
+      bucket_capacity_(0),
+      entries_offset_(0),
+      meta_page_id_(meta_page_id),
+      global_depth_(0) {
+  if (bpm_ == nullptr) {
+    throw std::invalid_argument("HashIndex needs a buffer pool");
+  }
+  if (key_size == 0 || key_size > MAX_INDEX_KEY_SIZE) {
+    throw std::invalid_argument("Index key size must be 1 to " +
+                                std::to_string(MAX_INDEX_KEY_SIZE));
+  }
+  if (bucket_capacity == 1) {
+    throw std::invalid_argument("Hash buckets need at least 2 entries");
+  }
+
+  if (meta_page_id_ == INVALID_PAGE_ID) {
+    CreateIndex(bucket_capacity);
+  } else {
+    OpenIndex();
+  }
+}
+
+size_t HashIndex::GetGlobalDepth() const {
+  std::shared_lock<std::shared_mutex> lock(directory_latch_);
+  return global_depth_;
+}
+
+size_t HashIndex::GetBucketCount() const {
+  std::shared_lock<std::shared_mutex> lock(directory_latch_);
+  return std::unordered_set<page_id_t>(directory_.begin(), directory_.end())
+      .size();
+}
+
+void HashIndex::CreateIndex(size_t bucket_capacity) {
+  bucket_capacity_ = MaxBucketCapacity(entry_size_);
+  if (bucket_capacity != 0) {
+    bucket_capacity_ = std::min(bucket_capacity_, bucket_capacity);
+  }
+  entries_offset_ =
+      INDEX_NODE_DATA_OFFSET + PaddedFingerprints(bucket_capacity_);
+
+  {
+    PageGuard meta = NewIndexPage(IndexNodeKind::META, 0);
+    PageGuard directory = NewIndexPage(IndexNodeKind::HASH_DIRECTORY, 0);
+    PageGuard bucket = NewIndexPage(IndexNodeKind::HASH_BUCKET, 0);
+    if (!meta || !directory || !bucket) {
+      throw std::runtime_error("HashIndex: Failed to allocate the index");
+    }
+    meta_page_id_ = meta.GetPageId();
+    directory_page_ids_.push_back(directory.GetPageId());
+    directory_.push_back(bucket.GetPageId());
+
+    HashIndexMetaData* data = MetaData(meta);
+    data->magic = HASH_INDEX_META_MAGIC;
+    data->key_size = key_size_;
+    data->unique = unique_ ? 1 : 0;
+    data->bucket_capacity = static_cast<uint16_t>(bucket_capacity_);
+  }
+
+  if (WriteMetaPage().code != 0 || WriteDirectory(0, 1).code != 0) {
+    throw std::runtime_error("HashIndex: Failed to write the directory");
+  }
+}
+
+void HashIndex::OpenIndex() {
+  {
+    PageGuard meta = FetchIndexPage(meta_page_id_, LatchMode::SHARED);
+    if (!meta) {
+      throw std::runtime_error("HashIndex: Failed to read the meta page");
+    }
+
+    const HashIndexMetaData* data = MetaData(meta);
+    if (meta->GetPageType() != PAGE_TYPE_INDEX ||
+        KindOf(meta) != IndexNodeKind::META ||
+        data->magic != HASH_INDEX_META_MAGIC) {
+      throw std::runtime_error("HashIndex: Page " +
+                               std::to_string(meta_page_id_) +
+                               " is not a hash index meta page");
+    }
+    if (data->key_size != key_size_ || (data->unique != 0) != unique_) {
+      throw std::runtime_error("HashIndex: Index was created with a "
+                               "different key size or uniqueness");
+    }
+    if (data->global_depth > HASH_INDEX_MAX_GLOBAL_DEPTH ||
+        data->directory_page_count > MAX_DIRECTORY_PAGES ||
+        data->bucket_capacity < 2 ||
+        data->bucket_capacity > MaxBucketCapacity(entry_size_)) {
+      throw std::runtime_error("HashIndex: Corrupt meta page");
+    }
+
+    global_depth_ = data->global_depth;
+    bucket_capacity_ = data->bucket_capacity;
+    for (size_t i = 0; i < data->directory_page_count; i++) {
+      directory_page_ids_.push_back(
+          LoadPageId(PageIdSlot(meta, META_DIRECTORY_OFFSET, i)));
+    }
+  }
+  entries_offset_ =
+      INDEX_NODE_DATA_OFFSET + PaddedFingerprints(bucket_capacity_);
+
+  directory_.resize(size_t{1} << global_depth_);
+  if (directory_page_ids_.size() * DIRECTORY_SLOTS_PER_PAGE <
+      directory_.size()) {
+    throw std::runtime_error("HashIndex: Directory pages are missing");
+  }
+  for (size_t slot = 0; slot < directory_.size();
+       slot += DIRECTORY_SLOTS_PER_PAGE) {
+    const page_id_t page_id =
+        directory_page_ids_[slot / DIRECTORY_SLOTS_PER_PAGE];
+    PageGuard page = FetchIndexPage(page_id, LatchMode::SHARED);
+    if (!page || KindOf(page) != IndexNodeKind::HASH_DIRECTORY) {
+      throw std::runtime_error("HashIndex: Failed to read directory page " +
+                               std::to_string(page_id));
+    }
+    const size_t end =
+        std::min(directory_.size(), slot + DIRECTORY_SLOTS_PER_PAGE);
+    for (size_t i = slot; i < end; i++) {
+      directory_[i] = LoadPageId(
+          PageIdSlot(page, INDEX_NODE_DATA_OFFSET, i - slot));
+    }
+  }
+}
+
+ErrorCode HashIndex::WriteMetaPage() {
+  PageGuard meta = FetchIndexPage(meta_page_id_, LatchMode::EXCLUSIVE);
+  if (!meta) {
+    return {-1, "HashIndex::WriteMetaPage: Failed to fetch meta page"};
+  }
+  HashIndexMetaData* data = MetaData(meta);
+  data->global_depth = global_depth_;
+  data->directory_page_count =
+      static_cast<uint16_t>(directory_page_ids_.size());
+  for (size_t i = 0; i < directory_page_ids_.size(); i++) {
+    StorePageId(PageIdSlot(meta, META_DIRECTORY_OFFSET, i),
+                directory_page_ids_[i]);
+  }
+  meta.MarkDirty();
+  return {0, "HashIndex::WriteMetaPage: Success"};
+}
+
+ErrorCode HashIndex::WriteDirectory(size_t begin, size_t end) {
+  std::vector<size_t> slots;
+  slots.reserve(end - begin);
+  for (size_t i = begin; i < end; i++) {
+    slots.push_back(i);
+  }
+  return WriteDirectorySlots(slots);
+}
+
+ErrorCode HashIndex::WriteDirectorySlots(const std::vector<size_t>& slots) {
+  PageGuard page;
+  size_t page_index = 0;
+  for (size_t slot : slots) {
+    if (!page || slot / DIRECTORY_SLOTS_PER_PAGE != page_index) {
+      page_index = slot / DIRECTORY_SLOTS_PER_PAGE;
+      page = FetchIndexPage(directory_page_ids_[page_index],
+                            LatchMode::EXCLUSIVE);
+      if (!page) {
+        return {-1, "HashIndex::WriteDirectory: Failed to fetch directory "
+                    "page"};
+      }
+      page.MarkDirty();
+    }
+    StorePageId(PageIdSlot(page, INDEX_NODE_DATA_OFFSET,
+                           slot % DIRECTORY_SLOTS_PER_PAGE),
+                directory_[slot]);
+  }
+  return {0, "HashIndex::WriteDirectory: Success"};
+}
+
+PageGuard HashIndex::FetchIndexPage(page_id_t page_id, LatchMode mode) const {
+  Page* page = bpm_->FetchPage(page_id);
+  if (page == nullptr) {
+    LOG_ERROR_STREAM("HashIndex::FetchIndexPage: Failed to fetch page "
+                     << page_id);
+    return PageGuard();
+  }
+  return PageGuard(bpm_, page_id, page, mode);
+}
+
+PageGuard HashIndex::NewIndexPage(IndexNodeKind kind, uint16_t level) {
+  page_id_t page_id = INVALID_PAGE_ID;
+  Page* page = bpm_->NewPage(&page_id);
+  if (page == nullptr) {
+    LOG_ERROR("HashIndex::NewIndexPage: Failed to allocate page");
+    return PageGuard();
+  }
+
+  PageGuard guard(bpm_, page_id, page, LatchMode::EXCLUSIVE);
+  page->SetPageType(PAGE_TYPE_INDEX);
+  IndexNodeHeader* header = NodeHeader(guard);
+  header->kind = static_cast<uint8_t>(kind);
+  header->level = level;
+  header->size = 0;
+  header->next_page_id = INVALID_PAGE_ID;
+  guard.MarkDirty();
+  return guard;
+}
+
+uint8_t* HashIndex::Fingerprints(const PageGuard& bucket) const {
+  return reinterpret_cast<uint8_t*>(bucket->GetRawBuffer() +
+                                    INDEX_NODE_DATA_OFFSET);
+}
+
+char* HashIndex::Entry(const PageGuard& bucket, size_t i) const {
+  return bucket->GetRawBuffer() + entries_offset_ + i * entry_size_;
+}
+
+void HashIndex::MakeEntry(const char* key, TupleId tuple_id,
+                          char* entry) const {
+  std::memcpy(entry, key, key_size_);
+  std::memcpy(entry + key_size_, &tuple_id.page_id, sizeof(page_id_t));
+  std::memcpy(entry + key_size_ + sizeof(page_id_t), &tuple_id.slot_id,
+              sizeof(slot_id_t));
+}
+
+size_t HashIndex::FindEntry(const PageGuard& bucket, const char* entry,
+                            size_t compare_size, uint8_t fingerprint,
+                            size_t from) const {
+  const uint8_t* fingerprints = Fingerprints(bucket);
+  const size_t size = NodeHeader(bucket)->size;
+  for (size_t i = from; i < size; i++) {
+    i += FindByte(fingerprints + i, size - i, fingerprint);
+    if (i < size && std::memcmp(Entry(bucket, i), entry, compare_size) == 0) {
+      return i;
+    }
+  }
+  return size;
+}
+
+ErrorCode HashIndex::Insert(const char* key, TupleId tuple_id) {
+  if (key == nullptr) {
+    return {-1, "HashIndex::Insert: Key is null"};
+  }
+
+  char entry[MAX_INDEX_KEY_SIZE + TUPLE_ID_SIZE];
+  MakeEntry(key, tuple_id, entry);
+  const uint64_t hash = HashKey(key, key_size_);
+  const uint8_t fingerprint = FingerprintOf(hash);
+
+  for (;;) {
+    {
+      std::shared_lock<std::shared_mutex> lock(directory_latch_);
+      PageGuard bucket = FetchIndexPage(BucketFor(hash), LatchMode::EXCLUSIVE);
+      // Splitting this bucket needs its latch, so the directory may move on
+      lock.unlock();
+      if (!bucket) {
+        return {-2, "HashIndex::Insert: Failed to fetch bucket"};
+      }
+
+      IndexNodeHeader* header = NodeHeader(bucket);
+      if (FindEntry(bucket, entry, compare_size_, fingerprint, 0) <
+          header->size) {
+        return {-3, unique_ ? "HashIndex::Insert: Key already exists"
+                            : "HashIndex::Insert: Entry already exists"};
+      }
+      if (header->size < bucket_capacity_) {
+        Fingerprints(bucket)[header->size] = fingerprint;
+        std::memcpy(Entry(bucket, header->size), entry, entry_size_);
+        header->size++;
+        bucket.MarkDirty();
+        return {0, "HashIndex::Insert: Success"};
+      }
+    }
+
+    ErrorCode result = SplitBucket(hash);
+    if (result.code != 0) {
+      return result;
+    }
+  }
+}
+
+ErrorCode HashIndex::SplitBucket(uint64_t hash) {
+  std::unique_lock<std::shared_mutex> lock(directory_latch_);
+  const size_t slot = hash & LowBits(global_depth_);
+  PageGuard bucket = FetchIndexPage(directory_[slot], LatchMode::EXCLUSIVE);
+  if (!bucket) {
+    return {-4, "HashIndex::Insert: Failed to fetch bucket"};
+  }
+
+  IndexNodeHeader* header = NodeHeader(bucket);
+  const size_t size = header->size;
+  if (size < bucket_capacity_) {
+    return {0, "HashIndex::SplitBucket: Split meanwhile"};
+  }
+
+  const size_t depth = header->level;
+  if (depth >= HASH_INDEX_MAX_GLOBAL_DEPTH) {
+    return {-5, "HashIndex::Insert: Bucket is full at the maximum depth"};
+  }
+  // Splitting helps only if some entry can part ways with the new one
+  const uint64_t reachable = LowBits(HASH_INDEX_MAX_GLOBAL_DEPTH);
+  bool separable = false;
+  for (size_t i = 0; i < size && !separable; i++) {
+    separable = ((HashKey(Entry(bucket, i), key_size_) ^ hash) & reachable) !=
+                0;
+  }
+  if (!separable) {
+    return {-6, "HashIndex::Insert: Bucket is full of entries that hash "
+                "alike"};
+  }
+
+  if (depth == global_depth_) {
+    ErrorCode grown = GrowDirectory();
+    if (grown.code != 0) {
+      return grown;
+    }
+  }
+
+  PageGuard sibling = NewIndexPage(IndexNodeKind::HASH_BUCKET,
+                                   static_cast<uint16_t>(depth + 1));
+  if (!sibling) {
+    return {-7, "HashIndex::Insert: Failed to allocate bucket"};
+  }
+
+  // Entries whose hash has bit depth set move to the sibling, the rest are
+  // packed down in place
+  uint8_t* fingerprints = Fingerprints(bucket);
+  uint8_t* sibling_fingerprints = Fingerprints(sibling);
+  size_t kept = 0;
+  size_t moved = 0;
+  for (size_t i = 0; i < size; i++) {
+    const char* current = Entry(bucket, i);
+    if (((HashKey(current, key_size_) >> depth) & 1) != 0) {
+      sibling_fingerprints[moved] = fingerprints[i];
+      std::memcpy(Entry(sibling, moved), current, entry_size_);
+      moved++;
+    } else {
+      if (kept != i) {
+        fingerprints[kept] = fingerprints[i];
+        std::memcpy(Entry(bucket, kept), current, entry_size_);
+      }
+      kept++;
+    }
+  }
+  header->size = static_cast<uint16_t>(kept);
+  header->level = static_cast<uint16_t>(depth + 1);
+  NodeHeader(sibling)->size = static_cast<uint16_t>(moved);
+  bucket.MarkDirty();
+
+  // Repoint the slots that now belong to the sibling: those sharing the
+  // bucket's low depth bits and having bit depth set
+  const page_id_t sibling_id = sibling.GetPageId();
+  std::vector<size_t> changed;
+  for (size_t i = (slot & LowBits(depth)) | (size_t{1} << depth);
+       i < directory_.size(); i += size_t{2} << depth) {
+    directory_[i] = sibling_id;
+    changed.push_back(i);
+  }
+  bucket.Release();
+  sibling.Release();
+  return WriteDirectorySlots(changed);
+}
+
+ErrorCode HashIndex::GrowDirectory() {
+  if (global_depth_ >= HASH_INDEX_MAX_GLOBAL_DEPTH) {
+    return {-8, "HashIndex::Insert: Directory is at the maximum depth"};
+  }
+
+  const size_t old_size = directory_.size();
+  const size_t pages_needed =
+      (2 * old_size + DIRECTORY_SLOTS_PER_PAGE - 1) / DIRECTORY_SLOTS_PER_PAGE;
+  while (directory_page_ids_.size() < pages_needed) {
+    PageGuard page = NewIndexPage(IndexNodeKind::HASH_DIRECTORY, 0);
+    if (!page) {
+      return {-9, "HashIndex::Insert: Failed to allocate directory page"};
+    }
+    directory_page_ids_.push_back(page.GetPageId());
+  }
+
+  // The new half mirrors the old one: each bucket gains slots, none moves
+  directory_.resize(2 * old_size);
+  std::copy(directory_.begin(), directory_.begin() + old_size,
+            directory_.begin() + old_size);
+  global_depth_++;
+
+  ErrorCode result = WriteDirectory(old_size, 2 * old_size);
+  if (result.code != 0) {
+    return result;
+  }
+  return WriteMetaPage();
+}
+
+ErrorCode HashIndex::Delete(const char* key, TupleId tuple_id) {
+  if (key == nullptr) {
+    return {-1, "HashIndex::Delete: Key is null"};
+  }
+
+  char entry[MAX_INDEX_KEY_SIZE + TUPLE_ID_SIZE];
+  MakeEntry(key, tuple_id, entry);
+  const uint64_t hash = HashKey(key, key_size_);
+
+  std::shared_lock<std::shared_mutex> lock(directory_latch_);
+  PageGuard bucket = FetchIndexPage(BucketFor(hash), LatchMode::EXCLUSIVE);
+  lock.unlock();
+  if (!bucket) {
+    return {-2, "HashIndex::Delete: Failed to fetch bucket"};
+  }
+
+  IndexNodeHeader* header = NodeHeader(bucket);
+  const size_t position =
+      FindEntry(bucket, entry, entry_size_, FingerprintOf(hash), 0);
+  if (position == header->size) {
+    return {-3, "HashIndex::Delete: Entry not found"};
+  }
+
+  // Entries are unordered: fill the hole with the last one
+  const size_t last = header->size - 1;
+  if (position != last) {
+    Fingerprints(bucket)[position] = Fingerprints(bucket)[last];
+    std::memcpy(Entry(bucket, position), Entry(bucket, last), entry_size_);
+  }
+  header->size = static_cast<uint16_t>(last);
+  bucket.MarkDirty();
+  return {0, "HashIndex::Delete: Success"};
+}
+
+ErrorCode HashIndex::Lookup(const char* key,
+                            std::vector<TupleId>* tuple_ids) const {
+  if (key == nullptr || tuple_ids == nullptr) {
+    return {-1, "HashIndex::Lookup: Key or output is null"};
+  }
+
+  const uint64_t hash = HashKey(key, key_size_);
+  const uint8_t fingerprint = FingerprintOf(hash);
+
+  std::shared_lock<std::shared_mutex> lock(directory_latch_);
+  PageGuard bucket = FetchIndexPage(BucketFor(hash), LatchMode::SHARED);
+  lock.unlock();
+  if (!bucket) {
+    return {-2, "HashIndex::Lookup: Failed to fetch bucket"};
+  }
+
+  const size_t size = NodeHeader(bucket)->size;
+  for (size_t i = FindEntry(bucket, key, key_size_, fingerprint, 0); i < size;
+       i = FindEntry(bucket, key, key_size_, fingerprint, i + 1)) {
+    tuple_ids->push_back(DecodeTupleId(Entry(bucket, i) + key_size_));
+    if (unique_) {
+      break;
+    }
+  }
+  return {0, "HashIndex::Lookup: Success"};
+}
+
+ErrorCode HashIndex::CheckIntegrity() const {
+  std::shared_lock<std::shared_mutex> lock(directory_latch_);
+  if (directory_.size() != size_t{1} << global_depth_) {
+    return {-1, "HashIndex::CheckIntegrity: Directory size does not match "
+                "the global depth"};
+  }
+
+  // Slot count and first slot of every bucket
+  std::unordered_map<page_id_t, std::pair<size_t, size_t>> buckets;
+  for (size_t i = 0; i < directory_.size(); i++) {
+    auto inserted = buckets.emplace(directory_[i], std::make_pair(0, i));
+    inserted.first->second.first++;
+  }
+
+  for (const auto& bucket_slots : buckets) {
+    const page_id_t page_id = bucket_slots.first;
+    const size_t slots = bucket_slots.second.first;
+    const size_t first_slot = bucket_slots.second.second;
+    const std::string where = " (bucket " + std::to_string(page_id) + ")";
+
+    PageGuard bucket = FetchIndexPage(page_id, LatchMode::SHARED);
+    if (!bucket) {
+      return {-2, "HashIndex::CheckIntegrity: Failed to fetch bucket" + where};
+    }
+    const IndexNodeHeader* header = NodeHeader(bucket);
+    const size_t depth = header->level;
+    if (KindOf(bucket) != IndexNodeKind::HASH_BUCKET ||
+        depth > global_depth_ || header->size > bucket_capacity_) {
+      return {-3, "HashIndex::CheckIntegrity: Bad bucket header" + where};
+    }
+    if (slots != size_t{1} << (global_depth_ - depth)) {
+      return {-4, "HashIndex::CheckIntegrity: Slot count does not match "
+                  "the local depth" +
+                      where};
+    }
+    for (size_t i = first_slot; i < directory_.size();
+         i += size_t{1} << depth) {
+      if (directory_[i] != page_id) {
+        return {-5, "HashIndex::CheckIntegrity: Slots sharing a suffix "
+                    "point at different buckets" +
+                        where};
+      }
+    }
+
+    std::set<std::string> seen;
+    for (size_t i = 0; i < header->size; i++) {
+      const char* entry = Entry(bucket, i);
+      const uint64_t hash = HashKey(entry, key_size_);
+      if (((hash ^ first_slot) & LowBits(depth)) != 0) {
+        return {-6, "HashIndex::CheckIntegrity: Entry in the wrong bucket" +
+                        where};
+      }
+      if (Fingerprints(bucket)[i] != FingerprintOf(hash)) {
+        return {-7, "HashIndex::CheckIntegrity: Wrong fingerprint" + where};
+      }
+      if (!seen.emplace(entry, compare_size_).second) {
+        return {-8, "HashIndex::CheckIntegrity: Duplicate entry" + where};
+      }
+    }
+  }
+  return {0, "HashIndex::CheckIntegrity: Success"};
+}
@@ -0,0 +1,183 @@
+#include "../../include/index/index_key.h"
+
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+// Big-endian, so memcmp() compares the most significant byte first
+void StoreBigEndian(uint64_t value, size_t size, char* out) {
+  for (size_t i = 0; i < size; i++) {
+    out[i] = static_cast<char>(value >> (8 * (size - 1 - i)));
+  }
+}
+
+void EncodeSigned(int64_t value, size_t size, char* out) {
+  const uint64_t sign_bit = uint64_t{1} << (8 * size - 1);
+  StoreBigEndian(static_cast<uint64_t>(value) ^ sign_bit, size, out);
+}
+
+void EncodeFloat(float value, char* out) {
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  bits = (bits & 0x80000000u) != 0 ? ~bits : bits ^ 0x80000000u;
+  StoreBigEndian(bits, sizeof(bits), out);
+}
+
+void EncodeDouble(double value, char* out) {
+  uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  const uint64_t sign_bit = uint64_t{1} << 63;
+  bits = (bits & sign_bit) != 0 ? ~bits : bits ^ sign_bit;
+  StoreBigEndian(bits, sizeof(bits), out);
+}
+
+bool IsStringKey(DataType type) {
+  return type == CHAR || type == VARCHAR || type == TEXT;
+}
+
+}  // namespace
+
+IndexKeyEncoder::IndexKeyEncoder(const Schema& schema,
+                                 const std::vector<std::string>& key_columns)
+    : key_size_(0) {
+  if (key_columns.empty()) {
+    throw std::invalid_argument("Index key needs at least one column");
+  }
+
+  size_t key_size = 0;
+  for (const std::string& name : key_columns) {
+    const ColumnDefinition* column = schema.FindColumn(name);
+    if (column == nullptr) {
+      throw std::invalid_argument("Index key column not found: " + name);
+    }
+
+    const DataType type = column->GetDataType();
+    size_t size = column->GetFixedSize();
+    if (IsStringKey(type)) {
+      size = column->GetMaxSize();
+    } else if (type == BLOB) {
+      size = 0;
+    }
+    if (size == 0) {
+      throw std::invalid_argument("Index key column has no fixed or max "
+                                  "size: " +
+                                  name);
+    }
+
+    columns_.push_back({type, column->GetFieldIndex(),
+                        static_cast<uint16_t>(key_size),
+                        static_cast<uint16_t>(size)});
+    key_size += size;
+    if (key_size > MAX_INDEX_KEY_SIZE) {
+      throw std::invalid_argument("Index key exceeds MAX_INDEX_KEY_SIZE");
+    }
+  }
+  key_size_ = static_cast<uint16_t>(key_size);
+}
+
+bool IndexKeyEncoder::Encode(const TupleAccessor& tuple, char* key) const {
+  for (const KeyColumn& column : columns_) {
+    if (tuple.IsNull(column.field_index)) {
+      return false;
+    }
+
+    char* out = key + column.offset;
+    switch (column.type) {
+      case BOOLEAN:
+        *out = tuple.GetBoolean(column.field_index) ? 1 : 0;
+        break;
+      case TINYINT:
+        EncodeSigned(tuple.GetTinyInt(column.field_index), 1, out);
+        break;
+      case SMALLINT:
+        EncodeSigned(tuple.GetSmallInt(column.field_index), 2, out);
+        break;
+      case INTEGER:
+        EncodeSigned(tuple.GetInteger(column.field_index), 4, out);
+        break;
+      case BIGINT:
+        EncodeSigned(tuple.GetBigInt(column.field_index), 8, out);
+        break;
+      case FLOAT:
+        EncodeFloat(tuple.GetFloat(column.field_index), out);
+        break;
+      case DOUBLE:
+        EncodeDouble(tuple.GetDouble(column.field_index), out);
+        break;
+      default: {
+        // Out-of-line values are longer than any key
+        if (tuple.IsStoredOutOfLine(column.field_index)) {
+          return false;
+        }
+        std::string_view value = tuple.GetStringView(column.field_index);
+        if (!EncodeString(column, value.data(), value.size(), key)) {
+          return false;
+        }
+        break;
+      }
+    }
+  }
+  return true;
+}
+
+bool IndexKeyEncoder::Encode(const std::vector<FieldValue>& values,
+                             char* key) const {
+  if (values.size() != columns_.size()) {
+    return false;
+  }
+
+  for (size_t i = 0; i < columns_.size(); i++) {
+    const KeyColumn& column = columns_[i];
+    const FieldValue& value = values[i];
+    if (value.IsNull() || value.GetType() != column.type) {
+      return false;
+    }
+
+    char* out = key + column.offset;
+    switch (column.type) {
+      case BOOLEAN:
+        *out = value.GetBoolean() ? 1 : 0;
+        break;
+      case TINYINT:
+        EncodeSigned(value.GetTinyInt(), 1, out);
+        break;
+      case SMALLINT:
+        EncodeSigned(value.GetSmallInt(), 2, out);
+        break;
+      case INTEGER:
+        EncodeSigned(value.GetInteger(), 4, out);
+        break;
+      case BIGINT:
+        EncodeSigned(value.GetBigInt(), 8, out);
+        break;
+      case FLOAT:
+        EncodeFloat(value.GetFloat(), out);
+        break;
+      case DOUBLE:
+        EncodeDouble(value.GetDouble(), out);
+        break;
+      default: {
+        const std::string& text = value.GetString();
+        if (!EncodeString(column, text.data(), text.size(), key)) {
+          return false;
+        }
+        break;
+      }
+    }
+  }
+  return true;
+}
+
+bool IndexKeyEncoder::EncodeString(const KeyColumn& column, const char* data,
+                                   size_t size, char* key) {
+  if (size > column.size) {
+    return false;
+  }
+  char* out = key + column.offset;
+  if (size > 0) {
+    std::memcpy(out, data, size);
+  }
+  std::memset(out + size, 0, column.size - size);
+  return true;
+}
@@ -0,0 +1,83 @@
+#include "../../include/index/table_index.h"
+
+#include <cstring>
+#include <stdexcept>
+
+#include "../../include/tuple/tuple_accessor.h"
+
+TableIndex::TableIndex(const Schema& schema,
+                       const std::vector<std::string>& key_columns,
+                       KeyIndex* index)
+    : schema_(schema), encoder_(schema_, key_columns), index_(index) {
+  if (index_ == nullptr) {
+    throw std::invalid_argument("TableIndex needs an index");
+  }
+  if (index_->GetKeySize() != encoder_.GetKeySize()) {
+    throw std::invalid_argument("Index key size does not match the key "
+                                "columns");
+  }
+}
+
+bool TableIndex::EncodeKey(const char* tuple, uint16_t size,
+                           char* key) const {
+  TupleAccessor accessor(schema_, tuple, size);
+  return encoder_.Encode(accessor, key);
+}
+
+ErrorCode TableIndex::AddTuple(const char* tuple, uint16_t size,
+                               TupleId tuple_id) {
+  char key[MAX_INDEX_KEY_SIZE];
+  if (!EncodeKey(tuple, size, key)) {
+    return {0, "TableIndex::AddTuple: Tuple has no key"};
+  }
+  return index_->Insert(key, tuple_id);
+}
+
+ErrorCode TableIndex::RemoveTuple(const char* tuple, uint16_t size,
+                                  TupleId tuple_id) {
+  char key[MAX_INDEX_KEY_SIZE];
+  if (!EncodeKey(tuple, size, key)) {
+    return {0, "TableIndex::RemoveTuple: Tuple has no key"};
+  }
+  return index_->Delete(key, tuple_id);
+}
+
+ErrorCode TableIndex::BeginUpdate(const char* old_tuple, uint16_t old_size,
+                                  const char* new_tuple, uint16_t new_size,
+                                  TupleId tuple_id) {
+  char old_key[MAX_INDEX_KEY_SIZE];
+  char new_key[MAX_INDEX_KEY_SIZE];
+  const bool has_old = EncodeKey(old_tuple, old_size, old_key);
+  if (!EncodeKey(new_tuple, new_size, new_key) ||
+      (has_old && std::memcmp(old_key, new_key, encoder_.GetKeySize()) == 0)) {
+    return {0, "TableIndex::BeginUpdate: Key unchanged"};
+  }
+  return index_->Insert(new_key, tuple_id);
+}
+
+void TableIndex::FinishUpdate(const char* old_tuple, uint16_t old_size,
+                              const char* new_tuple, uint16_t new_size,
+                              TupleId tuple_id, bool updated) {
+  char old_key[MAX_INDEX_KEY_SIZE];
+  char new_key[MAX_INDEX_KEY_SIZE];
+  const bool has_old = EncodeKey(old_tuple, old_size, old_key);
+  const bool has_new = EncodeKey(new_tuple, new_size, new_key);
+  if (has_old && has_new &&
+      std::memcmp(old_key, new_key, encoder_.GetKeySize()) == 0) {
+    return;
+  }
+  if (updated && has_old) {
+    index_->Delete(old_key, tuple_id);
+  } else if (!updated && has_new) {
+    index_->Delete(new_key, tuple_id);
+  }
+}
+
+ErrorCode TableIndex::Lookup(const std::vector<FieldValue>& key_values,
+                             std::vector<TupleId>* tuple_ids) const {
+  char key[MAX_INDEX_KEY_SIZE];
+  if (!encoder_.Encode(key_values, key)) {
+    return {-1, "TableIndex::Lookup: Values do not match the key columns"};
+  }
+  return index_->Lookup(key, tuple_ids);
+}
@@ -1,22 +1,70 @@
 #include <iostream>
+#include <string>
+#include <vector>
 
-#include "cli/cli_repl.h"
 #include "common/logger.h"
+#include "workload/workload_driver.h"
 
-int main() {
-  // Initialize logger
-  // auto& logger = storage::Logger::getInstance();
-  // logger.setDebugMode(false);  // Set to false for cleaner CLI output
-  //
-  // try {
-  //   CLIRepl repl;
-  //   repl.Run();
-  // } catch (const std::exception& e) {
-  //   LOG_ERROR_STREAM("Fatal error: " << e.what());
-  //   std::cerr << "Fatal error: " << e.what() << std::endl;
-  //   return 1;
-  // }
+namespace {
 
+void PrintUsage() {
+  std::cerr << "Usage: storage_engine <command> [options]\n"
+            << "\n"
+            << "Commands:\n"
+            << "  workload    run a YCSB-style mixed workload and report "
+               "throughput and latency\n"
+            << "\n"
+            << "Run 'storage_engine workload --help' for its options.\n";
+}
 
+int RunWorkloadCommand(const std::vector<std::string>& args) {
+  for (const std::string& arg : args) {
+    if (arg == "--help" || arg == "-h") {
+      std::cout << WorkloadUsage();
+      return 0;
+    }
+  }
+
+  WorkloadConfig config;
+  std::string error;
+  if (!ParseWorkloadArgs(args, &config, &error)) {
+    std::cerr << "storage_engine workload: " << error << "\n\n"
+              << WorkloadUsage();
+    return 2;
+  }
+
+  WorkloadReport report;
+  ErrorCode result = RunWorkload(config, &report);
+  if (result.code != 0) {
+    std::cerr << result.message << std::endl;
+    return 1;
+  }
+  PrintWorkloadReport(config, report, std::cout);
   return 0;
-}
\ No newline at end of file
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  // Keep INFO logs out of the benchmark output
+  storage::Logger::getInstance().setDebugMode(false);
+
+  if (argc < 2) {
+    PrintUsage();
+    return 2;
+  }
+
+  std::string command = argv[1];
+  std::vector<std::string> args(argv + 2, argv + argc);
+  if (command == "workload") {
+    return RunWorkloadCommand(args);
+  }
+  if (command == "--help" || command == "-h") {
+    PrintUsage();
+    return 0;
+  }
+
+  std::cerr << "storage_engine: unknown command '" << command << "'\n\n";
+  PrintUsage();
+  return 2;
+}
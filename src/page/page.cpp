@@ -8,9 +8,26 @@
 
 #include <cstdlib>
 #include <cstring>
+#include <vector>
 
 #include "../include/common/checksum.h"
 #include "../include/common/logger.h"
+#include "../include/common/trace.h"
+
+namespace {
+
+// Free-slot list link of a deleted slot
+slot_id_t GetFreeSlotLink(const SlotEntry* slot) {
+  slot_id_t next;
+  std::memcpy(&next, slot->next_ptr, sizeof(next));
+  return next;
+}
+
+void SetFreeSlotLink(SlotEntry* slot, slot_id_t next) {
+  std::memcpy(slot->next_ptr, &next, sizeof(next));
+}
+
+}  // namespace
 
 PageHeader* Page::GetHeader() const {
   return reinterpret_cast<PageHeader*>(page_buffer_.get());
@@ -24,50 +41,53 @@ uint32_t Page::ComputeChecksum() const {
   // ========================================================================
   // Checksum Computation Strategy
   // ========================================================================
-  // PageHeader layout (total size: 40 bytes):
-  //   Bytes  0-11: On-disk persistent fields (page_id, slot_id, free_start,
-  //   etc.) Bytes 12-15: checksum field (excluded from checksum calculation)
-  //   Bytes 16-39: Runtime metadata (deleted_tuple_count_, fragmented_bytes_,
-  //   is_dirty_) Bytes 40-8191: Page data (tuple data, free space, slot
-  //   directory)
+  // PageHeader layout (total size: 32 bytes):
+  //   Bytes  0-19: On-disk header fields (page_id, slot_id, free_start,
+  //   slot statistics, etc.) Bytes 20-23: checksum field (excluded from
+  //   checksum calculation) Bytes 24-31: page_lsn. Bytes 32-8191: Page
+  //   data (tuple data, free space, slot directory)
   //
   // Checksum coverage:
-  //   ✓ Part 1: Bytes  0-11   (on-disk persistent header fields)
-  //   ✗ Part 2: Bytes 12-15   (checksum field itself - treated as zeros)
-  //   ✗ Part 3: Bytes 16-39   (EXCLUDED - runtime fields not persisted)
-  //   ✓ Part 4: Bytes 40-8191 (page data area)
+  //   ✓ Part 1: Bytes  0-19   (on-disk header fields)
+  //   ✗ Part 2: Bytes 20-23   (checksum field itself - treated as zeros)
+  //   ✓ Part 3: Bytes 24-8191 (page_lsn and page data area)
   //
   // Rationale:
-  //   Runtime fields (deleted_tuple_count_, fragmented_bytes_, is_dirty_)
-  //   are computed at runtime and should NOT affect the checksum. They are
-  //   zeroed before WritePage() and recomputed after ReadPage().
+  //   Every header field is persisted, so only the checksum itself is
+  //   skipped. The dirty flag is frame state kept outside the buffer.
   // ========================================================================
 
   const auto* page_data = reinterpret_cast<const uint8_t*>(page_buffer_.get());
   const size_t checksum_offset = offsetof(PageHeader, checksum);
   const size_t checksum_size = sizeof(PageHeader::checksum);
 
+  // Algorithm recorded in the header flags (covered by the checksum)
+  const checksum::Algorithm algorithm =
+      (reinterpret_cast<const PageHeader*>(page_data)->flags &
+       PAGE_FLAG_CRC32C)
+          ? checksum::Algorithm::CRC32C
+          : checksum::Algorithm::CRC32;
+
   // Initialize CRC
   uint32_t result_crc = checksum::Init();
 
-  // Part 1: Checksum persistent header fields (bytes 0-11)
-  result_crc = checksum::Update(result_crc, page_data, checksum_offset);
+  // Part 1: Checksum header fields (bytes 0-19)
+  result_crc = checksum::Update(algorithm, result_crc, page_data,
+                                checksum_offset);
 
-  // Part 2: Skip checksum field (bytes 12-15) - treat as zeros to avoid
+  // Part 2: Skip checksum field (bytes 20-23) - treat as zeros to avoid
   // circular dependency
   const uint32_t zero_checksum = 0;
   result_crc = checksum::Update(
-      result_crc, reinterpret_cast<const uint8_t*>(&zero_checksum),
-      checksum_size);
+      algorithm, result_crc,
+      reinterpret_cast<const uint8_t*>(&zero_checksum), checksum_size);
 
-  // Part 3: Skip runtime metadata fields (bytes 16-39)
-  // Part 4: Checksum page data area (bytes 40-8191)
-  const size_t remaining_offset =
-      sizeof(PageHeader);  // Start after entire PageHeader (40 bytes)
+  // Part 3: Checksum page_lsn and the page data area (bytes 24-8191)
+  const size_t remaining_offset = checksum_offset + checksum_size;
   const size_t remaining_size =
-      PAGE_SIZE - remaining_offset;  // 8192 - 40 = 8152 bytes
-  result_crc = checksum::Update(result_crc, page_data + remaining_offset,
-                                remaining_size);
+      PAGE_SIZE - remaining_offset;  // 8192 - 24 = 8168 bytes
+  result_crc = checksum::Update(algorithm, result_crc,
+                                page_data + remaining_offset, remaining_size);
 
   // Finalize CRC
   return checksum::Finalize(result_crc);
@@ -81,9 +101,6 @@ std::unique_ptr<Page> Page::CreateNew() {
     return nullptr;
   }
 
-  // Zero out the page data
-  std::memset(raw_page_data, 0, PAGE_SIZE);
-
   // Create Page object with unique_ptr
   auto new_page = std::make_unique<Page>();
 
@@ -92,27 +109,44 @@ std::unique_ptr<Page> Page::CreateNew() {
   new_page->page_buffer_ =
       AlignedBuffer(reinterpret_cast<char*>(raw_page_data), AlignedDeleter());
 
+  new_page->ResetMemory();
+
+  LOG_INFO_STREAM("Page::CreateNew: Created new page with ID "
+                  << new_page->GetPageId());
+  return new_page;
+}
+
+std::unique_ptr<Page> Page::CreateInFrame(char* buffer) {
+  auto new_page = std::make_unique<Page>();
+  new_page->page_buffer_ = AlignedBuffer(buffer, AlignedDeleter{false});
+  return new_page;
+}
+
+void Page::ResetMemory() const {
+  if (page_buffer_.get() == nullptr) {
+    return;
+  }
+
+  // Zero out the page data
+  std::memset(page_buffer_.get(), 0, PAGE_SIZE);
+
   // Initialize header fields
-  PageHeader* header = new_page->GetHeader();
+  PageHeader* header = GetHeader();
   header->page_id = 0;
   header->slot_id = 0;
   header->free_start = sizeof(PageHeader);
   header->free_end = PAGE_SIZE;
   header->slot_count = 0;
   header->page_type = 0;
-  header->flags = 0;
+  header->flags = PAGE_FLAG_CRC32C;
+  header->deleted_tuple_count = 0;
+  header->fragmented_bytes = 0;
+  header->free_slot_tail = 0;
   header->checksum = 0;
+  header->page_lsn = INVALID_LSN;
+  is_dirty_ = true;  // New page is dirty until written to disk
 
-  // Initialize runtime metadata (not stored on disk)
-  header->deleted_tuple_count_ = 0;
-  header->fragmented_bytes_ = 0;
-  header->is_dirty_ = true;  // New page is dirty until written to disk
-
-  header->checksum = new_page->ComputeChecksum();
-
-  LOG_INFO_STREAM("Page::CreateNew: Created new page with ID "
-                  << header->page_id);
-  return new_page;
+  header->checksum = ComputeChecksum();
 }
 
 bool Page::VerifyChecksum() const {
@@ -135,7 +169,7 @@ bool Page::VerifyChecksum() const {
 }
 
 // Getters
-uint16_t Page::GetPageId() const {
+page_id_t Page::GetPageId() const {
   return page_buffer_.get() ? GetHeader()->page_id : 0;
 }
 
@@ -167,8 +201,12 @@ uint32_t Page::GetChecksum() const {
   return page_buffer_.get() ? GetHeader()->checksum : 0;
 }
 
+lsn_t Page::GetPageLsn() const {
+  return page_buffer_.get() ? GetHeader()->page_lsn : INVALID_LSN;
+}
+
 // Setters
-void Page::SetPageId(uint16_t page_id) const {
+void Page::SetPageId(page_id_t page_id) const {
   if (page_buffer_.get()) {
     GetHeader()->page_id = page_id;
   }
@@ -216,16 +254,18 @@ void Page::SetChecksum(const uint32_t checksum) const {
   }
 }
 
-bool Page::IsDirty() const {
-  return page_buffer_.get() ? GetHeader()->is_dirty_ : false;
+void Page::SetPageLsn(const lsn_t page_lsn) const {
+  if (page_buffer_.get()) {
+    GetHeader()->page_lsn = page_lsn;
+  }
 }
 
 uint16_t Page::GetDeletedTupleCount() const {
-  return page_buffer_.get() ? GetHeader()->deleted_tuple_count_ : 0;
+  return page_buffer_.get() ? GetHeader()->deleted_tuple_count : 0;
 }
 
 size_t Page::GetFragmentedBytes() const {
-  return page_buffer_.get() ? GetHeader()->fragmented_bytes_ : 0;
+  return page_buffer_.get() ? GetHeader()->fragmented_bytes : 0;
 }
 
 // Slot directory methods
@@ -308,8 +348,10 @@ void Page::MarkSlotDeleted(slot_id_t slot_id) const {
     return;
   }
 
-  if (SlotEntry* slot_entry = GetSlotEntryPtr(slot_id)) {
+  SlotEntry* slot_entry = GetSlotEntryPtr(slot_id);
+  if (slot_entry != nullptr && (slot_entry->flags & SLOT_VALID)) {
     slot_entry->flags &= ~SLOT_VALID;  // Clear VALID flag
+    PushFreeSlot(slot_id);
   }
 }
 
@@ -351,48 +393,78 @@ TupleId Page::GetForwardingPointer(const slot_id_t slot_id) const {
     return result;
   }
 
-  // Decode 24-bit pointer: 16-bit page_id + 8-bit slot_id
-  // next_ptr[0] = low byte of page_id
-  // next_ptr[1] = high byte of page_id
-  // next_ptr[2] = slot_id
-  // Example: next_ptr = [0xD2, 0x04, 0x2A] (1234 in decimal for page_id, 42 for
-  // slot_id)
-  //   page_id = 0xD2 | (0x04 << 8) = 0xD2 | 0x400 = 0x04D2 = 1234
-  //   slot_id = 0x2A = 42
-  result.page_id = static_cast<page_id_t>(slot_entry->next_ptr[0]) |
-                   (static_cast<page_id_t>(slot_entry->next_ptr[1]) << 8);
-  result.slot_id = static_cast<slot_id_t>(slot_entry->next_ptr[2]);
+  if (slot_entry->length == 0) {
+    // Legacy 24-bit pointer: 16-bit page_id + 8-bit slot_id
+    // next_ptr[0] = low byte of page_id
+    // next_ptr[1] = high byte of page_id
+    // next_ptr[2] = slot_id
+    result.page_id = static_cast<page_id_t>(slot_entry->next_ptr[0]) |
+                     (static_cast<page_id_t>(slot_entry->next_ptr[1]) << 8);
+    result.slot_id = static_cast<slot_id_t>(slot_entry->next_ptr[2]);
+    return result;
+  }
+
+  if (slot_entry->length != FORWARD_STUB_SIZE ||
+      static_cast<size_t>(slot_entry->offset) + FORWARD_STUB_SIZE > PAGE_SIZE) {
+    LOG_ERROR_STREAM("Page::GetForwardingPointer: Malformed forwarding stub "
+                     << "in slot " << slot_id);
+    return result;
+  }
 
+  ForwardStub stub;
+  std::memcpy(&stub, page_buffer_.get() + slot_entry->offset, sizeof(stub));
+  result.page_id = stub.page_id;
+  result.slot_id = stub.slot_id;
   return result;
 }
 
-void Page::SetForwardingPointer(const slot_id_t slot_id,
+bool Page::SetForwardingPointer(const slot_id_t slot_id,
                                 const page_id_t target_page_id,
                                 const slot_id_t target_slot_id) const {
   if (page_buffer_ == nullptr || slot_id >= GetHeader()->slot_count) {
-    return;
+    return false;
   }
 
   SlotEntry* slot_entry = GetSlotEntryPtr(slot_id);
   if (slot_entry == nullptr) {
-    return;
+    return false;
+  }
+
+  // The stub overwrites the head of the old tuple when it fits; forwarded
+  // tuples are never read again, so the old bytes are dead either way
+  if (slot_entry->length < FORWARD_STUB_SIZE) {
+    if (GetAvailableFreeSpace() < FORWARD_STUB_SIZE) {
+      LOG_WARNING_STREAM("Page::SetForwardingPointer: No space for a "
+                         << "forwarding stub for slot " << slot_id);
+      return false;
+    }
+    PageHeader* header = GetHeader();
+    slot_entry->offset = header->free_start;
+    header->free_start += FORWARD_STUB_SIZE;
   }
 
-  // Encode 24-bit pointer: 16-bit page_id + 8-bit slot_id
-  // Example: target_page_id = 1234 (0x04D2), target_slot_id = 42 (0x2A)
-  //   next_ptr[0] = 0x04D2 & 0xFF = 0xD2 (low byte)
-  //   next_ptr[1] = (0x04D2 >> 8) & 0xFF = 0x04 (high byte)
-  //   next_ptr[2] = 0x2A & 0xFF = 0x2A
-  //   Result: [0xD2, 0x04, 0x2A]
-  slot_entry->next_ptr[0] = static_cast<uint8_t>(target_page_id & 0xFF);
-  slot_entry->next_ptr[1] = static_cast<uint8_t>((target_page_id >> 8) & 0xFF);
-  slot_entry->next_ptr[2] = static_cast<uint8_t>(target_slot_id & 0xFF);
+  const ForwardStub stub{target_page_id, target_slot_id};
+  std::memcpy(page_buffer_.get() + slot_entry->offset, &stub, sizeof(stub));
+  slot_entry->length = FORWARD_STUB_SIZE;
+  std::memset(slot_entry->next_ptr, 0, sizeof(slot_entry->next_ptr));
 
-  // Set FORWARDED flag
+  // Set FORWARDED flag; the stub itself is never compressed
   slot_entry->flags |= SLOT_FORWARDED;
+  slot_entry->flags &= ~SLOT_COMPRESSED;
+  return true;
+}
+
+bool Page::IsSlotCompressed(const slot_id_t slot_id) const {
+  if (page_buffer_ == nullptr || slot_id >= GetHeader()->slot_count) {
+    return false;
+  }
+  const SlotEntry* slot_entry = GetSlotEntryPtr(slot_id);
+  return slot_entry != nullptr && (slot_entry->flags & SLOT_COMPRESSED) != 0;
 }
 
-slot_id_t Page::InsertTuple(const char* tuple_data, uint16_t tuple_size) const {
+slot_id_t Page::InsertTuple(const char* tuple_data, uint16_t tuple_size,
+                            uint8_t slot_flags,
+                            uint16_t reserved_space) const {
   // Input validation
   if (page_buffer_.get() == nullptr) {
     LOG_ERROR("Page::InsertTuple: Page buffer is null");
@@ -425,6 +497,11 @@ slot_id_t Page::InsertTuple(const char* tuple_data, uint16_t tuple_size) const {
     required_space = tuple_size + SLOT_ENTRY_SIZE;
   }
 
+  // The reserve is kept for tuples already here to grow into
+  if (reserved_space > 0 && HasLiveTuple()) {
+    required_space += reserved_space;
+  }
+
   // Check if we have enough space
   if (size_t available_space = GetAvailableFreeSpace();
       available_space < required_space) {
@@ -455,9 +532,13 @@ slot_id_t Page::InsertTuple(const char* tuple_data, uint16_t tuple_size) const {
       return INVALID_SLOT_ID;
     }
 
+    // Unlink before the entry (and its link) is overwritten
+    TakeFreeSlot(slot_id);
+
     // Save old length BEFORE overwriting - needed to decrement fragmentation
     // stats
     uint16_t old_length = slot_entry->length;
+    uint16_t old_offset = slot_entry->offset;
 
     // Update the slot entry for reuse
     slot_entry->offset = tuple_offset;
@@ -467,11 +548,17 @@ slot_id_t Page::InsertTuple(const char* tuple_data, uint16_t tuple_size) const {
     slot_entry->next_ptr[1] = 0;
     slot_entry->next_ptr[2] = 0;
 
-    // Decrement fragmentation counters - we're reclaiming a deleted slot
-    header->deleted_tuple_count_--;
-    header->fragmented_bytes_ -= old_length;
+    // Decrement fragmentation counters - we're reclaiming a deleted slot.
+    // Slots cleared by CompactPage (zero offset and length) were already
+    // taken out of the counters.
+    if (old_offset != 0 || old_length != 0) {
+      header->deleted_tuple_count--;
+      header->fragmented_bytes -= old_length;
+    }
   }
 
+  GetSlotEntryPtr(slot_id)->flags |= slot_flags & SLOT_COMPRESSED;
+
   // Write tuple data to page
   auto* page_data = reinterpret_cast<uint8_t*>(page_buffer_.get());
   std::memcpy(page_data + tuple_offset, tuple_data, tuple_size);
@@ -493,97 +580,77 @@ slot_id_t Page::InsertTuple(const char* tuple_data, uint16_t tuple_size) const {
 }
 
 void Page::CompactPage() const {
+  // One page of scratch per thread, reused across compactions
+  thread_local std::unique_ptr<char[]> scratch;
+  if (!scratch) {
+    scratch = std::make_unique<char[]>(PAGE_SIZE);
+  }
+  CompactPage(scratch.get());
+}
+
+void Page::CompactPage(char* scratch) const {
+  TRACE_SPAN("Page::CompactPage");
   // validate compaction
-  if (GetHeader()->deleted_tuple_count_ == 0) {
+  if (GetHeader()->deleted_tuple_count == 0 &&
+      GetHeader()->fragmented_bytes == 0) {
     return;  // Nothing to compact
   }
 
-  if (GetHeader()->slot_count == GetHeader()->deleted_tuple_count_) {
+  if (GetHeader()->slot_count == GetHeader()->deleted_tuple_count &&
+      GetHeader()->slot_count > 0) {
     // All tuples deleted
     GetHeader()->free_start = sizeof(PageHeader);
     GetHeader()->slot_count = 0;
-    GetHeader()->deleted_tuple_count_ = 0;
-    GetHeader()->fragmented_bytes_ = 0;
+    GetHeader()->deleted_tuple_count = 0;
+    GetHeader()->fragmented_bytes = 0;
+    GetHeader()->flags |= PAGE_FLAG_FREE_SLOT_LIST;
+    GetHeader()->free_slot_tail = 0;
     const uint32_t checksum = ComputeChecksum();
     GetHeader()->checksum = checksum;
     return;  // All space reclaimed
   }
 
-  std::vector<TupleInfo> valid_tuples;
-  uint16_t expected_valid =
-      GetHeader()->slot_count > GetHeader()->deleted_tuple_count_
-          ? GetHeader()->slot_count - GetHeader()->deleted_tuple_count_
-          : 0;
-  valid_tuples.reserve(expected_valid);
-
-  for (slot_id_t i = 0; i < GetHeader()->slot_count; i++) {
-    SlotEntry slot = GetSlotEntry(i);
-
-    if (slot.flags & SLOT_VALID) {
-      TupleInfo info{};
-      info.original_slot_id = i;
-      info.offset = slot.offset;
-      info.length = slot.length;
-      info.flags = slot.flags;
-      info.next_ptr[0] = slot.next_ptr[0];
-      info.next_ptr[1] = slot.next_ptr[1];
-      info.next_ptr[2] = slot.next_ptr[2];
-
-      valid_tuples.push_back(info);
-    }
-  }
-
-  // Allocate temporary buffer for compacted data
   const size_t header_size = sizeof(PageHeader);
-  const size_t buffer_size = GetHeader()->free_start - header_size;
-  const auto temp_buffer = std::make_unique<uint8_t[]>(buffer_size);
-  memset(temp_buffer.get(), 0, buffer_size);
-
-  size_t new_offset = 0;  // Offset in temp buffer
+  const size_t used_bytes = GetHeader()->free_start - header_size;
   auto* page_data = reinterpret_cast<uint8_t*>(page_buffer_.get());
 
-  for (auto& info : valid_tuples) {
-    // Copy tuple data
-    memcpy(temp_buffer.get() + new_offset, page_data + info.offset,
-           info.length);
-
-    // Update offset in info structure
-    info.offset =
-        header_size +
-        new_offset;  // Offset relative to start of page (after header)
-
-    // Advance offset
-    new_offset += info.length;
-  }
-
-  // Copy compacted data back to page (after page header)
-  memcpy(page_data + header_size, temp_buffer.get(), new_offset);
-
-  // Update slot offsets WITHOUT renumbering (preserves external forwarding
-  // pointers)
-  for (const auto& info : valid_tuples) {
-    SlotEntry& slot = GetSlotEntry(info.original_slot_id);
-    slot.offset = info.offset;
-    slot.length = info.length;
-  }
-
-  // Clear deleted slots by marking them invalid
+  // Pack live tuples into scratch in slot order and point each slot at its
+  // new offset. Slots keep their numbers so external forwarding pointers
+  // stay valid; deleted slots are cleared for reuse and relinked in slot
+  // order.
+  GetHeader()->flags |= PAGE_FLAG_FREE_SLOT_LIST;
+  GetHeader()->free_slot_tail = 0;
+  size_t new_offset = 0;
   for (slot_id_t i = 0; i < GetHeader()->slot_count; i++) {
     SlotEntry* slot = GetSlotEntryPtr(i);
-    if (slot && !(slot->flags & SLOT_VALID)) {
+    if (slot == nullptr) {
+      continue;
+    }
+
+    if (slot->flags & SLOT_VALID) {
+      memcpy(scratch + new_offset, page_data + slot->offset, slot->length);
+      slot->offset = static_cast<uint16_t>(header_size + new_offset);
+      new_offset += slot->length;
+    } else {
       slot->offset = 0;
       slot->length = 0;
       slot->flags = 0;
       slot->next_ptr[0] = 0;
       slot->next_ptr[1] = 0;
       slot->next_ptr[2] = 0;
+      PushFreeSlot(i);
     }
   }
 
-  // Update page header
+  // Copy compacted data back to page (after page header)
+  memcpy(page_data + header_size, scratch, new_offset);
+
+  // Update page header. Cleared slots no longer hold reclaimable bytes, so
+  // they leave the deleted count (InsertTuple does not count them on reuse).
   GetHeader()->free_start = header_size + new_offset;
-  GetHeader()->deleted_tuple_count_ = 0;
-  GetHeader()->fragmented_bytes_ = 0;
+  GetHeader()->deleted_tuple_count = 0;
+  GetHeader()->fragmented_bytes = 0;
+  is_dirty_ = true;
 
   // Recompute checksum
   const uint32_t checksum = ComputeChecksum();
@@ -591,7 +658,7 @@ void Page::CompactPage() const {
 
   LOG_INFO_STREAM("Page::CompactPage: Compacted page "
                   << GetHeader()->page_id << ", reclaimed "
-                  << (buffer_size - new_offset) << " bytes, "
+                  << (used_bytes - new_offset) << " bytes, "
                   << "new free_start: " << GetHeader()->free_start);
 }
 
@@ -611,31 +678,102 @@ size_t Page::GetAvailableFreeSpace() const {
 }
 
 slot_id_t Page::FindDeletedSlot() const {
-  const PageHeader* header = GetHeader();
-  const slot_id_t slot_count = header->slot_count;
-
-  // Iterate through all existing slots to find an invalid (deleted) one
-  for (slot_id_t slot_id = 0; slot_id < slot_count; ++slot_id) {
-    if (!IsSlotValid(slot_id)) {
-      LOG_INFO_STREAM("Page::FindDeletedSlot: Found deleted slot "
-                      << slot_id << " on page " << header->page_id);
-      return slot_id;
+  PageHeader* header = GetHeader();
+  if (!(header->flags & PAGE_FLAG_FREE_SLOT_LIST)) {
+    BuildFreeSlotList();
+  }
+  if (header->free_slot_tail == 0) {
+    return INVALID_SLOT_ID;  // No deleted slots
+  }
+
+  // The tail links to the oldest deleted slot
+  slot_id_t slot_id = GetFreeSlotLink(GetSlotEntryPtr(
+      static_cast<slot_id_t>(header->free_slot_tail - 1)));
+  if (header->free_slot_tail > header->slot_count ||
+      slot_id >= header->slot_count || IsSlotValid(slot_id)) {
+    // A list that does not match the directory is rebuilt, never followed
+    LOG_WARNING_STREAM("Page::FindDeletedSlot: Rebuilding free-slot list of "
+                       << "page " << header->page_id);
+    BuildFreeSlotList();
+    if (header->free_slot_tail == 0) {
+      return INVALID_SLOT_ID;
+    }
+    slot_id = GetFreeSlotLink(GetSlotEntryPtr(
+        static_cast<slot_id_t>(header->free_slot_tail - 1)));
+  }
+
+  LOG_INFO_STREAM("Page::FindDeletedSlot: Found deleted slot "
+                  << slot_id << " on page " << header->page_id);
+  return slot_id;
+}
+
+void Page::TakeFreeSlot(slot_id_t slot_id) const {
+  PageHeader* header = GetHeader();
+  const auto tail = static_cast<slot_id_t>(header->free_slot_tail - 1);
+  if (slot_id == tail) {
+    header->free_slot_tail = 0;  // It was the only one
+  } else {
+    SetFreeSlotLink(GetSlotEntryPtr(tail),
+                    GetFreeSlotLink(GetSlotEntryPtr(slot_id)));
+  }
+}
+
+void Page::PushFreeSlot(slot_id_t slot_id) const {
+  PageHeader* header = GetHeader();
+  if (!(header->flags & PAGE_FLAG_FREE_SLOT_LIST)) {
+    return;  // Built on the next insert
+  }
+
+  SlotEntry* slot = GetSlotEntryPtr(slot_id);
+  if (header->free_slot_tail == 0) {
+    SetFreeSlotLink(slot, slot_id);
+  } else {
+    SlotEntry* tail =
+        GetSlotEntryPtr(static_cast<slot_id_t>(header->free_slot_tail - 1));
+    SetFreeSlotLink(slot, GetFreeSlotLink(tail));
+    SetFreeSlotLink(tail, slot_id);
+  }
+  header->free_slot_tail = static_cast<uint16_t>(slot_id + 1);
+}
+
+void Page::BuildFreeSlotList() const {
+  PageHeader* header = GetHeader();
+  header->flags |= PAGE_FLAG_FREE_SLOT_LIST;
+  header->free_slot_tail = 0;
+  for (slot_id_t slot_id = 0; slot_id < header->slot_count; ++slot_id) {
+    if (!(GetSlotEntryPtr(slot_id)->flags & SLOT_VALID)) {
+      PushFreeSlot(slot_id);
     }
   }
 
-  // No deleted slots found
-  return INVALID_SLOT_ID;
+  // The header changed even if the insert that needed the list then fails
+  header->checksum = ComputeChecksum();
+}
+
+bool Page::HasLiveTuple() const {
+  const PageHeader* header = GetHeader();
+  // Slots CompactPage() cleared are in neither count, so the counts alone
+  // only tell that every slot is deleted
+  if (header->slot_count == header->deleted_tuple_count) {
+    return false;
+  }
+  for (slot_id_t i = 0; i < header->slot_count; i++) {
+    if (GetSlotEntryPtr(i)->flags & SLOT_VALID) {
+      return true;
+    }
+  }
+  return false;
 }
 
 void Page::RecomputeFragmentationStats() const {
-  GetHeader()->deleted_tuple_count_ = 0;
-  GetHeader()->fragmented_bytes_ = 0;
+  GetHeader()->deleted_tuple_count = 0;
+  GetHeader()->fragmented_bytes = 0;
 
   // Scan slot directory
   for (slot_id_t i = 0; i < GetHeader()->slot_count; i++) {
     if (const SlotEntry slot = GetSlotEntry(i); !(slot.flags & SLOT_VALID)) {
-      GetHeader()->deleted_tuple_count_++;
-      GetHeader()->fragmented_bytes_ += slot.length;
+      GetHeader()->deleted_tuple_count++;
+      GetHeader()->fragmented_bytes += slot.length;
     }
   }
 }
@@ -659,9 +797,10 @@ ErrorCode Page::DeleteTuple(uint16_t slot_id) const {
   }
 
   slot_entry->flags &= ~SLOT_VALID;
-  GetHeader()->deleted_tuple_count_++;
-  GetHeader()->fragmented_bytes_ += slot_entry->length;
-  GetHeader()->is_dirty_ = true;
+  PushFreeSlot(slot_id);
+  GetHeader()->deleted_tuple_count++;
+  GetHeader()->fragmented_bytes += slot_entry->length;
+  is_dirty_ = true;
 
   // Recompute checksum after modifying page
   const uint32_t checksum = ComputeChecksum();
@@ -671,27 +810,28 @@ ErrorCode Page::DeleteTuple(uint16_t slot_id) const {
 }
 
 bool Page::ShouldCompact() const {
-  // No point compacting if no deletions
-  if (GetHeader()->deleted_tuple_count_ == 0) {
+  // No point compacting without deletions or bytes left behind by moves
+  if (GetHeader()->deleted_tuple_count == 0 &&
+      GetHeader()->fragmented_bytes == 0) {
     return false;
   }
 
   // High fragmentation ratio (>= 50%)
   if (const size_t used_space = GetHeader()->free_start - sizeof(PageHeader);
       used_space > 0 &&
-      GetHeader()->fragmented_bytes_ * 100 / used_space >= 50) {
+      GetHeader()->fragmented_bytes * 100 / used_space >= 50) {
     return true;
   }
 
   // Many deleted slots (>= 50%)
-  if (GetHeader()->deleted_tuple_count_ * 2 >= GetHeader()->slot_count) {
+  if (GetHeader()->deleted_tuple_count * 2 >= GetHeader()->slot_count) {
     return true;
   }
 
   // Insertion would fail but compaction would help
   const size_t available = GetHeader()->free_end - GetHeader()->free_start;
   const size_t potentially_available =
-      available + GetHeader()->fragmented_bytes_;
+      available + GetHeader()->fragmented_bytes;
 
   if (available < 100 && potentially_available >= 100) {
     // Can't fit small tuple now, but could after compaction
@@ -702,7 +842,8 @@ bool Page::ShouldCompact() const {
 }
 
 ErrorCode Page::UpdateTupleInPlace(slot_id_t slot_id, const char* new_data,
-                                   uint16_t new_size) const {
+                                   uint16_t new_size,
+                                   uint8_t slot_flags) const {
   if (page_buffer_.get() == nullptr) {
     LOG_ERROR("Page::UpdateTupleInPlace: Page buffer is null");
     return ErrorCode{-1, "Page::UpdateTupleInPlace: Page buffer is null"};
@@ -762,7 +903,9 @@ ErrorCode Page::UpdateTupleInPlace(slot_id_t slot_id, const char* new_data,
   std::memcpy(page_data + slot_entry->offset, new_data, new_size);
 
   slot_entry->length = new_size;
-  header->is_dirty_ = true;
+  slot_entry->flags = static_cast<uint8_t>(
+      (slot_entry->flags & ~SLOT_COMPRESSED) | (slot_flags & SLOT_COMPRESSED));
+  is_dirty_ = true;
   const uint32_t new_checksum = ComputeChecksum();
   header->checksum = new_checksum;
 
@@ -774,6 +917,59 @@ ErrorCode Page::UpdateTupleInPlace(slot_id_t slot_id, const char* new_data,
   return ErrorCode{0, "Page::UpdateTupleInPlace: Success"};
 }
 
+ErrorCode Page::UpdateTuple(slot_id_t slot_id, const char* new_data,
+                            uint16_t new_size, uint8_t slot_flags) const {
+  // Everything but growth is UpdateTupleInPlace()'s, errors included
+  SlotEntry* slot_entry = page_buffer_ != nullptr && new_data != nullptr &&
+                                  slot_id < GetHeader()->slot_count
+                              ? GetSlotEntryPtr(slot_id)
+                              : nullptr;
+  if (slot_entry == nullptr ||
+      (slot_entry->flags & (SLOT_VALID | SLOT_FORWARDED)) != SLOT_VALID ||
+      new_size <= slot_entry->length) {
+    return UpdateTupleInPlace(slot_id, new_data, new_size, slot_flags);
+  }
+
+  // The tuple right before the free space only needs the added bytes
+  PageHeader* header = GetHeader();
+  const bool at_free_start =
+      slot_entry->offset + slot_entry->length == header->free_start;
+  const size_t required_space =
+      at_free_start ? new_size - slot_entry->length : new_size;
+  if (const size_t available_space = GetAvailableFreeSpace();
+      available_space < required_space) {
+    LOG_WARNING_STREAM("Page::UpdateTuple: New size "
+                       << new_size << " exceeds the free space of page "
+                       << header->page_id << " (required: " << required_space
+                       << ", available: " << available_space << ")");
+    return ErrorCode{-8, "Page::UpdateTuple: New size exceeds free space"};
+  }
+
+  const uint16_t tuple_offset =
+      at_free_start ? slot_entry->offset : header->free_start;
+  std::memcpy(page_buffer_.get() + tuple_offset, new_data, new_size);
+  header->free_start = static_cast<uint16_t>(tuple_offset + new_size);
+  // The bytes left behind are reclaimed during compaction
+  if (!at_free_start) {
+    header->fragmented_bytes += slot_entry->length;
+  }
+
+  slot_entry->offset = tuple_offset;
+  slot_entry->length = new_size;
+  slot_entry->flags = static_cast<uint8_t>(
+      (slot_entry->flags & ~SLOT_COMPRESSED) | (slot_flags & SLOT_COMPRESSED));
+  is_dirty_ = true;
+  const uint32_t new_checksum = ComputeChecksum();
+  header->checksum = new_checksum;
+
+  LOG_INFO_STREAM("Page::UpdateTuple: Moved tuple at slot "
+                  << slot_id << " on page " << header->page_id
+                  << " to offset " << tuple_offset
+                  << " (new size: " << new_size << ")");
+
+  return ErrorCode{0, "Page::UpdateTuple: Success"};
+}
+
 ErrorCode Page::MarkSlotForwarded(slot_id_t slot_id, page_id_t target_page_id,
                                   slot_id_t target_slot_id) const {
   if (page_buffer_.get() == nullptr) {
@@ -803,13 +999,17 @@ ErrorCode Page::MarkSlotForwarded(slot_id_t slot_id, page_id_t target_page_id,
     return ErrorCode{-4, "Page::MarkSlotForwarded: Slot is not valid"};
   }
 
-  // Mark the tuple data as reclaimed since it's forwarded
-  // This allows the space to be reclaimed during compaction
+  // Tuple bytes not reused by the stub are reclaimed during compaction
+  const uint16_t old_offset = slot_entry->offset;
   const uint16_t old_length = slot_entry->length;
-  slot_entry->length = 0;
-  SetForwardingPointer(slot_id, target_page_id, target_slot_id);
-  header->fragmented_bytes_ += old_length;
-  header->is_dirty_ = true;
+  if (!SetForwardingPointer(slot_id, target_page_id, target_slot_id)) {
+    return ErrorCode{-5, "Page::MarkSlotForwarded: No space for stub"};
+  }
+  const bool stub_in_place =
+      slot_entry->offset == old_offset && old_length >= FORWARD_STUB_SIZE;
+  header->fragmented_bytes +=
+      stub_in_place ? old_length - FORWARD_STUB_SIZE : old_length;
+  is_dirty_ = true;
 
   const uint32_t new_checksum = ComputeChecksum();
   header->checksum = new_checksum;
@@ -1,6 +1,7 @@
 #include "../../include/page/page_view.h"
 
 #include <cstring>
+#include <vector>
 
 #include "../../include/common/checksum.h"
 #include "../../include/common/config.h"
@@ -11,40 +12,42 @@ uint32_t PageView::ComputeChecksum() const {
     return 0;
   }
 
-  // PageHeader layout (total size: 40 bytes):
-  //   Bytes  0-11: On-disk persistent fields (included)  Bytes  0-11
-  //   Bytes 12-15: checksum field (excluded) Bytes 12-15
-  //   Bytes 16-39: Runtime metadata (excluded) Bytes 16-39
-  //   Bytes 40-8191: Page data (included) Bytes 40-8191
-  //
-  //   Runtime fields (deleted_tuple_count_, fragmented_bytes_, is_dirty_)
-  //   are computed at runtime and should NOT affect the checksum. They are
-  //   zeroed before WritePage() and recomputed after ReadPage().
+  // PageHeader layout (total size: 32 bytes):
+  //   Bytes  0-19: On-disk header fields (included)
+  //   Bytes 20-23: checksum field (excluded)
+  //   Bytes 24-31: page_lsn (included)
+  //   Bytes 32-8191: Page data (included)
   const auto* page_data = reinterpret_cast<const uint8_t*>(page_buffer_);
   const size_t checksum_offset = offsetof(PageHeader, checksum);
   const size_t checksum_size = sizeof(PageHeader::checksum);
 
+  // Algorithm recorded in the header flags (covered by the checksum)
+  const checksum::Algorithm algorithm =
+      (reinterpret_cast<const PageHeader*>(page_data)->flags &
+       PAGE_FLAG_CRC32C)
+          ? checksum::Algorithm::CRC32C
+          : checksum::Algorithm::CRC32;
+
   // Initialize CRC
   uint32_t result_crc = checksum::Init();
 
-  // Checksum persistent header fields (bytes 0-11)
-  result_crc = checksum::Update(result_crc, page_data, checksum_offset);
+  // Checksum header fields (bytes 0-19)
+  result_crc = checksum::Update(algorithm, result_crc, page_data,
+                                checksum_offset);
 
-  // Skip checksum field (bytes 12-15) - treat as zeros to avoid circular
+  // Skip checksum field (bytes 20-23) - treat as zeros to avoid circular
   // dependency
   const uint32_t zero_checksum = 0;
   result_crc = checksum::Update(
-      result_crc, reinterpret_cast<const uint8_t*>(&zero_checksum),
-      checksum_size);
-
-  // Skip runtime metadata fields (bytes 16-39)
-  // Checksum page data area (bytes 40-8191)
-  constexpr size_t remaining_offset =
-      sizeof(PageHeader);  // Start after entire PageHeader (40 bytes)
-  constexpr size_t remaining_size =
-      PAGE_SIZE - remaining_offset;  // 8192 - 40 = 8152 bytes
-  result_crc = checksum::Update(result_crc, page_data + remaining_offset,
-                                remaining_size);
+      algorithm, result_crc,
+      reinterpret_cast<const uint8_t*>(&zero_checksum), checksum_size);
+
+  // Checksum page_lsn and the page data area (bytes 24-8191)
+  const size_t remaining_offset = checksum_offset + checksum_size;
+  const size_t remaining_size =
+      PAGE_SIZE - remaining_offset;  // 8192 - 24 = 8168 bytes
+  result_crc = checksum::Update(algorithm, result_crc,
+                                page_data + remaining_offset, remaining_size);
 
   // Finalize CRC
   return checksum::Finalize(result_crc);
@@ -69,8 +72,259 @@ bool PageView::VerifyChecksum() const {
   return valid;
 }
 
+void PageView::Initialize() const {
+  if (page_buffer_ == nullptr) {
+    return;
+  }
+
+  std::memset(page_buffer_, 0, PAGE_SIZE);
+  PageHeader* header = GetHeader();
+  header->free_start = sizeof(PageHeader);
+  header->free_end = PAGE_SIZE;
+  header->flags = PAGE_FLAG_CRC32C;
+}
+
+slot_id_t PageView::AppendTuple(const char* tuple_data,
+                                uint16_t tuple_size) const {
+  if (page_buffer_ == nullptr || tuple_data == nullptr || tuple_size == 0) {
+    return INVALID_SLOT_ID;
+  }
+
+  PageHeader* header = GetHeader();
+  if (header->free_end < header->free_start ||
+      static_cast<size_t>(header->free_end - header->free_start) <
+          static_cast<size_t>(tuple_size) + SLOT_ENTRY_SIZE) {
+    return INVALID_SLOT_ID;
+  }
+
+  // Slots grow down from the end of the page, tuple data up from the header
+  const slot_id_t slot_id = header->slot_count;
+  header->free_end -= SLOT_ENTRY_SIZE;
+  SlotEntry slot_entry{header->free_start, tuple_size, SLOT_VALID, {0, 0, 0}};
+  std::memcpy(page_buffer_ + header->free_end, &slot_entry, sizeof(slot_entry));
+  std::memcpy(page_buffer_ + header->free_start, tuple_data, tuple_size);
+
+  header->free_start += tuple_size;
+  header->slot_count++;
+  return slot_id;
+}
+
+namespace {
+
+// Persistent prefixes of the format version 1 and 2 page headers. Both
+// reserved 40 bytes (the rest held runtime-only fields) before page data.
+#pragma pack(push, 1)
+struct PageHeaderV1 {
+  uint16_t page_id;
+  uint16_t slot_id;
+  uint16_t free_start;
+  uint16_t free_end;
+  uint16_t slot_count;
+  uint8_t page_type;
+  uint8_t flags;
+  uint32_t checksum;
+};
+
+struct PageHeaderV2 {
+  uint32_t page_id;
+  uint16_t slot_id;
+  uint16_t free_start;
+  uint16_t free_end;
+  uint16_t slot_count;
+  uint8_t page_type;
+  uint8_t flags;
+  uint16_t reserved;
+  uint32_t checksum;
+};
+#pragma pack(pop)
+
+constexpr size_t LEGACY_HEADER_SIZE = 40;
+
+// Format version 3: the current header without page_lsn
+constexpr size_t V3_HEADER_SIZE = 24;
+
+SlotEntry* SlotAt(char* page, slot_id_t slot_id) {
+  return reinterpret_cast<SlotEntry*>(page + PAGE_SIZE -
+                                      (slot_id + 1) * SLOT_ENTRY_SIZE);
+}
+
+// Move live tuples and stubs together from data_start, keeping slot numbers,
+// and clear deleted slots (as Page::CompactPage does)
+void PackLiveTuples(char* page, size_t data_start) {
+  auto* header = reinterpret_cast<PageHeader*>(page);
+  std::vector<char> scratch(PAGE_SIZE);
+  size_t used = 0;
+  for (slot_id_t i = 0; i < header->slot_count; i++) {
+    SlotEntry* slot = SlotAt(page, i);
+    if (slot->flags & SLOT_VALID) {
+      std::memcpy(scratch.data() + used, page + slot->offset, slot->length);
+      slot->offset = static_cast<uint16_t>(data_start + used);
+      used += slot->length;
+    } else {
+      std::memset(slot, 0, sizeof(SlotEntry));
+    }
+  }
+  std::memcpy(page + data_start, scratch.data(), used);
+  header->free_start = static_cast<uint16_t>(data_start + used);
+  header->deleted_tuple_count = 0;
+  header->fragmented_bytes = 0;
+  // Cleared slots lost their links: Page rebuilds the list on insert
+  header->flags &= ~PAGE_FLAG_FREE_SLOT_LIST;
+  header->free_slot_tail = 0;
+}
+
+// Copy the legacy header fields shared by both versions into the current one
+template <typename LegacyHeader>
+void CopyLegacyFields(const LegacyHeader& legacy, PageHeader* header) {
+  header->page_id = legacy.page_id;
+  header->slot_id = legacy.slot_id;
+  header->free_start = legacy.free_start;
+  header->free_end = legacy.free_end;
+  header->slot_count = legacy.slot_count;
+  header->page_type = legacy.page_type;
+  header->flags = legacy.flags;
+}
+
+// Same coverage as PageView::ComputeChecksum() with the legacy offsets
+template <typename LegacyHeader>
+bool VerifiesAsLegacy(const char* buffer) {
+  LegacyHeader legacy;
+  std::memcpy(&legacy, buffer, sizeof(legacy));
+  const checksum::Algorithm algorithm = (legacy.flags & PAGE_FLAG_CRC32C)
+                                            ? checksum::Algorithm::CRC32C
+                                            : checksum::Algorithm::CRC32;
+
+  const auto* page_data = reinterpret_cast<const uint8_t*>(buffer);
+  const uint32_t zero_checksum = 0;
+  uint32_t crc = checksum::Init();
+  crc = checksum::Update(algorithm, crc, page_data,
+                         offsetof(LegacyHeader, checksum));
+  crc = checksum::Update(algorithm, crc,
+                         reinterpret_cast<const uint8_t*>(&zero_checksum),
+                         sizeof(zero_checksum));
+  crc = checksum::Update(algorithm, crc, page_data + LEGACY_HEADER_SIZE,
+                         PAGE_SIZE - LEGACY_HEADER_SIZE);
+  return checksum::Finalize(crc) == legacy.checksum;
+}
+
+}  // namespace
+
+bool PageView::IsLegacyLayout(uint32_t format_version) const {
+  if (page_buffer_ == nullptr) {
+    return false;
+  }
+  switch (format_version) {
+    case 1:
+      return VerifiesAsLegacy<PageHeaderV1>(page_buffer_);
+    case 2:
+      return VerifiesAsLegacy<PageHeaderV2>(page_buffer_);
+    case 3:
+      // Same checksum coverage as now; only writes since v4 set the flag
+      return !(GetHeader()->flags & PAGE_FLAG_PAGE_LSN) && VerifyChecksum();
+    default:
+      return false;
+  }
+}
+
+bool PageView::ConvertFromLegacyLayout(uint32_t format_version) const {
+  if (page_buffer_ == nullptr || format_version < 1 || format_version > 3) {
+    return false;
+  }
+
+  if (format_version == 3) {
+    return ConvertFromV3Layout();
+  }
+
+  PageHeader header{};
+  if (format_version == 1) {
+    PageHeaderV1 v1;
+    std::memcpy(&v1, page_buffer_, sizeof(v1));
+    CopyLegacyFields(v1, &header);
+  } else {
+    PageHeaderV2 v2;
+    std::memcpy(&v2, page_buffer_, sizeof(v2));
+    CopyLegacyFields(v2, &header);
+  }
+
+  // Legacy slot statistics were runtime-only; compute them once here
+  for (slot_id_t i = 0; i < header.slot_count; i++) {
+    SlotEntry slot_entry;
+    const size_t slot_offset = PAGE_SIZE - (i + 1) * SLOT_ENTRY_SIZE;
+    std::memcpy(&slot_entry, page_buffer_ + slot_offset, sizeof(slot_entry));
+    if (!(slot_entry.flags & SLOT_VALID)) {
+      header.deleted_tuple_count++;
+      header.fragmented_bytes += slot_entry.length;
+    }
+  }
+
+  // Bytes between the new and the legacy header size stay unused until the
+  // page is compacted
+  std::memset(page_buffer_, 0, LEGACY_HEADER_SIZE);
+  std::memcpy(page_buffer_, &header, sizeof(header));
+  return true;
+}
+
+bool PageView::ConvertFromV3Layout() const {
+  constexpr size_t growth = sizeof(PageHeader) - V3_HEADER_SIZE;
+  PageHeader* header = GetHeader();
+  if (header->free_end < header->free_start ||
+      header->free_start < V3_HEADER_SIZE) {
+    return false;
+  }
+
+  if (static_cast<size_t>(header->free_end - header->free_start) < growth) {
+    PackLiveTuples(page_buffer_, V3_HEADER_SIZE);
+    if (static_cast<size_t>(header->free_end - header->free_start) < growth) {
+      return false;
+    }
+  }
+
+  // Shift page data up to make room for page_lsn
+  std::memmove(page_buffer_ + sizeof(PageHeader),
+               page_buffer_ + V3_HEADER_SIZE,
+               header->free_start - V3_HEADER_SIZE);
+  for (slot_id_t i = 0; i < header->slot_count; i++) {
+    SlotEntry* slot = SlotAt(page_buffer_, i);
+    if (slot->offset >= V3_HEADER_SIZE) {
+      slot->offset += growth;
+    }
+  }
+  header->free_start += growth;
+  header->page_lsn = INVALID_LSN;
+  return true;
+}
+
+bool PageView::SpillTuple(const PageView& overflow,
+                          page_id_t overflow_page_id) const {
+  if (page_buffer_ == nullptr) {
+    return false;
+  }
+
+  for (slot_id_t i = GetHeader()->slot_count; i-- > 0;) {
+    SlotEntry* slot = SlotAt(page_buffer_, i);
+    if (!(slot->flags & SLOT_VALID) || (slot->flags & SLOT_FORWARDED) ||
+        slot->length <= FORWARD_STUB_SIZE) {
+      continue;
+    }
+
+    const slot_id_t target =
+        overflow.AppendTuple(page_buffer_ + slot->offset, slot->length);
+    if (target == INVALID_SLOT_ID) {
+      return false;
+    }
+
+    // Same encoding as Page::SetForwardingPointer()
+    const ForwardStub stub{overflow_page_id, target};
+    std::memcpy(page_buffer_ + slot->offset, &stub, sizeof(stub));
+    slot->length = FORWARD_STUB_SIZE;
+    slot->flags |= SLOT_FORWARDED;
+    return true;
+  }
+  return false;
+}
+
 // Getters
-uint16_t PageView::GetPageId() const {
+page_id_t PageView::GetPageId() const {
   return page_buffer_ ? GetHeader()->page_id : 0;
 }
 
@@ -102,16 +356,16 @@ uint32_t PageView::GetChecksum() const {
   return page_buffer_ ? GetHeader()->checksum : 0;
 }
 
-bool PageView::IsDirty() const {
-  return page_buffer_ ? GetHeader()->is_dirty_ : false;
+lsn_t PageView::GetPageLsn() const {
+  return page_buffer_ ? GetHeader()->page_lsn : INVALID_LSN;
 }
 
 size_t PageView::GetFragmentedBytes() const {
-  return page_buffer_ ? GetHeader()->fragmented_bytes_ : 0;
+  return page_buffer_ ? GetHeader()->fragmented_bytes : 0;
 }
 
 // Setters
-void PageView::SetPageId(uint16_t page_id) const {
+void PageView::SetPageId(page_id_t page_id) const {
   if (page_buffer_) {
     GetHeader()->page_id = page_id;
   }
@@ -158,3 +412,9 @@ void PageView::SetChecksum(const uint32_t checksum) const {
     GetHeader()->checksum = checksum;
   }
 }
+
+void PageView::SetPageLsn(const lsn_t page_lsn) const {
+  if (page_buffer_) {
+    GetHeader()->page_lsn = page_lsn;
+  }
+}
@@ -0,0 +1,213 @@
+#include "../../include/page/pax_page.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+size_t AlignUp(size_t value) {
+  return (value + PAX_MINIPAGE_ALIGNMENT - 1) / PAX_MINIPAGE_ALIGNMENT *
+         PAX_MINIPAGE_ALIGNMENT;
+}
+
+// One bit per row, in whole 64-bit words
+size_t BitmapBytes(size_t rows) { return (rows + 63) / 64 * 8; }
+
+bool TestBit(const uint8_t* bitmap, size_t bit) {
+  return (bitmap[bit / 8] >> (bit % 8)) & 1;
+}
+
+void SetBit(uint8_t* bitmap, size_t bit, bool value) {
+  const unsigned mask = 1u << (bit % 8);
+  if (value) {
+    bitmap[bit / 8] = static_cast<uint8_t>(bitmap[bit / 8] | mask);
+  } else {
+    bitmap[bit / 8] = static_cast<uint8_t>(bitmap[bit / 8] & ~mask);
+  }
+}
+
+}  // namespace
+
+PaxLayout::PaxLayout(const Schema& schema)
+    : capacity_(0), tuple_size_(0), valid_offset_(0) {
+  if (!schema.IsFinalized() || !schema.IsFixedLength()) {
+    throw std::invalid_argument(
+        "PAX pages need a finalized fixed-length schema");
+  }
+  tuple_size_ = static_cast<uint32_t>(schema.GetFixedSectionEnd());
+
+  size_t row_bits = 1;  // validity
+  for (size_t i = 0; i < schema.GetColumnCount(); i++) {
+    row_bits += schema.GetLayout()[i].size * 8;
+    row_bits += schema.GetColumnRef(i).GetIsNullable() ? 1 : 0;
+  }
+
+  // Start from the bound ignoring padding and shrink until the minipages,
+  // padded to cache lines, fit
+  size_t capacity = std::min<size_t>((PAGE_SIZE * 8) / row_bits,
+                                     INVALID_SLOT_ID - 1);
+  while (capacity > 0 && !Place(schema, capacity)) {
+    capacity--;
+  }
+  if (capacity == 0) {
+    throw std::invalid_argument("PAX page cannot hold a row of this schema");
+  }
+}
+
+bool PaxLayout::Place(const Schema& schema, size_t capacity) {
+  std::vector<PaxColumnLayout> columns;
+  columns.reserve(schema.GetColumnCount());
+
+  size_t offset = AlignUp(sizeof(PageHeader) + sizeof(PaxPageHeader));
+  const size_t valid_offset = offset;
+  offset = AlignUp(offset + BitmapBytes(capacity));
+  for (size_t i = 0; i < schema.GetColumnCount(); i++) {
+    const FieldLayout& field = schema.GetLayout()[i];
+    PaxColumnLayout column{field.offset, field.size, 0, 0};
+    if (schema.GetColumnRef(i).GetIsNullable()) {
+      column.null_offset = static_cast<uint16_t>(offset);
+      offset += BitmapBytes(capacity);
+    }
+    column.data_offset = static_cast<uint16_t>(offset);
+    offset = AlignUp(offset + size_t{field.size} * capacity);
+    if (offset > PAGE_SIZE) {
+      return false;
+    }
+    columns.push_back(column);
+  }
+
+  capacity_ = static_cast<uint16_t>(capacity);
+  valid_offset_ = static_cast<uint16_t>(valid_offset);
+  columns_ = std::move(columns);
+  return true;
+}
+
+PaxPageHeader* PaxPage::Header() const {
+  return reinterpret_cast<PaxPageHeader*>(page_->GetRawBuffer() +
+                                          sizeof(PageHeader));
+}
+
+uint8_t* PaxPage::Bitmap(uint16_t offset) const {
+  return reinterpret_cast<uint8_t*>(page_->GetRawBuffer() + offset);
+}
+
+void PaxPage::Init() const {
+  std::memset(page_->GetRawBuffer() + sizeof(PageHeader), 0,
+              PAGE_SIZE - sizeof(PageHeader));
+  page_->SetPageType(PAGE_TYPE_PAX);
+  page_->SetSlotCount(0);
+  PaxPageHeader* header = Header();
+  header->capacity = layout_.GetCapacity();
+  header->column_count = static_cast<uint16_t>(layout_.GetColumns().size());
+  header->tuple_size = layout_.GetTupleSize();
+}
+
+bool PaxPage::IsValidPaxPage() const {
+  const PaxPageHeader* header = Header();
+  return page_->GetPageType() == PAGE_TYPE_PAX &&
+         header->capacity == layout_.GetCapacity() &&
+         header->column_count == layout_.GetColumns().size() &&
+         header->tuple_size == layout_.GetTupleSize() &&
+         header->high_water <= header->capacity &&
+         header->row_count <= header->high_water;
+}
+
+bool PaxPage::IsRowValid(slot_id_t row) const {
+  return row < GetHighWater() && TestBit(GetValidBitmap(), row);
+}
+
+slot_id_t PaxPage::InsertRow(const char* tuple) const {
+  PaxPageHeader* header = Header();
+  if (header->row_count == header->capacity) {
+    return INVALID_SLOT_ID;
+  }
+
+  // Reuse the first deleted row below the high-water mark
+  const uint8_t* valid = GetValidBitmap();
+  slot_id_t row = header->high_water;
+  for (size_t word = 0; word * 64 < header->high_water; word++) {
+    uint64_t bits;
+    std::memcpy(&bits, valid + word * 8, sizeof(bits));
+    if (bits != ~uint64_t{0}) {
+      const size_t candidate = word * 64 + __builtin_ctzll(~bits);
+      if (candidate < header->high_water) {
+        row = static_cast<slot_id_t>(candidate);
+      }
+      break;
+    }
+  }
+  if (row == header->high_water) {
+    header->high_water++;
+  }
+
+  SetBit(Bitmap(layout_.GetValidOffset()), row, true);
+  header->row_count++;
+  WriteRow(row, tuple);
+  return row;
+}
+
+void PaxPage::WriteRow(slot_id_t row, const char* tuple) const {
+  uint64_t null_bitmap;
+  std::memcpy(&null_bitmap, tuple, sizeof(null_bitmap));
+  const std::vector<PaxColumnLayout>& columns = layout_.GetColumns();
+  for (size_t i = 0; i < columns.size(); i++) {
+    const PaxColumnLayout& column = columns[i];
+    char* value = page_->GetRawBuffer() + column.data_offset +
+                  size_t{row} * column.size;
+    const bool is_null = (null_bitmap >> i) & 1;
+    if (column.null_offset != 0) {
+      SetBit(Bitmap(column.null_offset), row, is_null);
+    }
+    if (is_null) {
+      std::memset(value, 0, column.size);
+    } else {
+      std::memcpy(value, tuple + column.tuple_offset, column.size);
+    }
+  }
+}
+
+void PaxPage::ReadRow(slot_id_t row, char* tuple) const {
+  std::memset(tuple, 0, layout_.GetTupleSize());
+  uint64_t null_bitmap = 0;
+  const std::vector<PaxColumnLayout>& columns = layout_.GetColumns();
+  for (size_t i = 0; i < columns.size(); i++) {
+    const PaxColumnLayout& column = columns[i];
+    if (column.null_offset != 0 && TestBit(Bitmap(column.null_offset), row)) {
+      null_bitmap |= 1ULL << i;
+      continue;
+    }
+    std::memcpy(tuple + column.tuple_offset,
+                page_->GetRawBuffer() + column.data_offset +
+                    size_t{row} * column.size,
+                column.size);
+  }
+  std::memcpy(tuple, &null_bitmap, sizeof(null_bitmap));
+}
+
+void PaxPage::DeleteRow(slot_id_t row) const {
+  PaxPageHeader* header = Header();
+  SetBit(Bitmap(layout_.GetValidOffset()), row, false);
+  header->row_count--;
+  if (row + 1 == header->high_water) {
+    // Let trailing free rows drop below the high-water mark
+    while (header->high_water > 0 &&
+           !TestBit(GetValidBitmap(), header->high_water - 1)) {
+      header->high_water--;
+    }
+  }
+}
+
+const char* PaxPage::GetColumnData(size_t column) const {
+  return page_->GetRawBuffer() + layout_.GetColumns()[column].data_offset;
+}
+
+const uint8_t* PaxPage::GetNullBitmap(size_t column) const {
+  const uint16_t offset = layout_.GetColumns()[column].null_offset;
+  return offset != 0 ? Bitmap(offset) : nullptr;
+}
+
+const uint8_t* PaxPage::GetValidBitmap() const {
+  return Bitmap(layout_.GetValidOffset());
+}
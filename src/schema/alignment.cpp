@@ -6,27 +6,6 @@
 
 namespace alignment {
 
-size_t CalculateAlignment(const DataType type) {
-  switch (type) {
-    case BOOLEAN:
-    case TINYINT:
-    case CHAR:
-    case VARCHAR:
-    case TEXT:
-    case BLOB:
-      return 1;
-    case SMALLINT:
-      return 2;
-    case INTEGER:
-    case FLOAT:
-      return 4;
-    case BIGINT:
-    case DOUBLE:
-      return 8;
-  }
-  return 0;
-}
-
 size_t CalculatePadding(size_t current_offset, size_t alignment_value) {
   // Handle edge case: avoid division by zero
   if (alignment_value == 0) {
@@ -0,0 +1,105 @@
+#include "../../include/schema/column_dictionary.h"
+
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+bool DictionaryBudget::Reserve(size_t value_size) {
+  const size_t bytes = ENTRY_OVERHEAD + value_size;
+  size_t used = used_.load(std::memory_order_relaxed);
+  do {
+    if (bytes > capacity_ - used) {
+      return false;
+    }
+  } while (!used_.compare_exchange_weak(used, used + bytes,
+                                        std::memory_order_relaxed));
+  return true;
+}
+
+ColumnDictionary::ColumnDictionary(std::shared_ptr<DictionaryBudget> budget)
+    : budget_(std::move(budget)),
+      chunks_(new std::atomic<std::string*>[CHUNK_COUNT]()), size_(0) {}
+
+ColumnDictionary::~ColumnDictionary() {
+  for (size_t i = 0; i < CHUNK_COUNT; i++) {
+    delete[] chunks_[i].load(std::memory_order_relaxed);
+  }
+}
+
+bool ColumnDictionary::Encode(std::string_view value,
+                              dictionary_code_t* code) {
+  {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = codes_.find(value);
+    if (it != codes_.end()) {
+      *code = it->second;
+      return true;
+    }
+  }
+
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  // Another writer may have added it in between
+  auto it = codes_.find(value);
+  if (it != codes_.end()) {
+    *code = it->second;
+    return true;
+  }
+  return AppendLocked(value, code);
+}
+
+bool ColumnDictionary::Lookup(std::string_view value,
+                              dictionary_code_t* code) const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  auto it = codes_.find(value);
+  if (it == codes_.end()) {
+    return false;
+  }
+  *code = it->second;
+  return true;
+}
+
+std::string_view ColumnDictionary::Decode(dictionary_code_t code) const {
+  if (code >= size_.load(std::memory_order_acquire)) {
+    throw std::out_of_range("Dictionary code " + std::to_string(code) +
+                            " was never assigned");
+  }
+  // The size is published after the value, so its chunk is in place
+  const std::string* chunk =
+      chunks_[code / CHUNK_ENTRIES].load(std::memory_order_acquire);
+  return chunk[code % CHUNK_ENTRIES];
+}
+
+bool ColumnDictionary::Append(std::string_view value) {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  if (codes_.count(value) > 0) {
+    return false;
+  }
+  dictionary_code_t code;
+  return AppendLocked(value, &code);
+}
+
+bool ColumnDictionary::AppendLocked(std::string_view value,
+                                    dictionary_code_t* code) {
+  const size_t next = size_.load(std::memory_order_relaxed);
+  if (next >= DICTIONARY_MAX_ENTRIES || value.size() > UINT16_MAX) {
+    return false;
+  }
+  if (budget_ != nullptr && !budget_->Reserve(value.size())) {
+    return false;
+  }
+
+  std::atomic<std::string*>& slot = chunks_[next / CHUNK_ENTRIES];
+  std::string* chunk = slot.load(std::memory_order_relaxed);
+  if (chunk == nullptr) {
+    chunk = new std::string[CHUNK_ENTRIES];
+    slot.store(chunk, std::memory_order_release);
+  }
+  std::string& stored = chunk[next % CHUNK_ENTRIES];
+  stored.assign(value.data(), value.size());
+  codes_.emplace(std::string_view(stored),
+                 static_cast<dictionary_code_t>(next));
+  size_.store(next + 1, std::memory_order_release);
+
+  *code = static_cast<dictionary_code_t>(next);
+  return true;
+}
@@ -4,21 +4,26 @@
 
 #include "../../include/schema/schema.h"
 
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
 #include "../../include/schema/alignment.h"
+#include "../../include/tuple/tuple_header.h"
 
-std::string ColumnDefinition::GetColumnName() { return column_name_; }
+std::string ColumnDefinition::GetColumnName() const { return column_name_; }
 
-DataType ColumnDefinition::GetDataType() { return data_type_; }
+DataType ColumnDefinition::GetDataType() const { return data_type_; }
 
-bool ColumnDefinition::GetIsNullable() { return is_nullable_; }
+bool ColumnDefinition::GetIsNullable() const { return is_nullable_; }
 
-size_t ColumnDefinition::GetFixedSize() { return fixed_size_; }
+size_t ColumnDefinition::GetFixedSize() const { return fixed_size_; }
 
-size_t ColumnDefinition::GetMaxSize() { return max_size_; }
+size_t ColumnDefinition::GetMaxSize() const { return max_size_; }
 
-size_t ColumnDefinition::GetOffset() { return offset_; }
+size_t ColumnDefinition::GetOffset() const { return offset_; }
 
-uint16_t ColumnDefinition::GetFieldIndex() { return field_index_; }
+uint16_t ColumnDefinition::GetFieldIndex() const { return field_index_; }
 
 void ColumnDefinition::SetFieldIndex(uint16_t index) { field_index_ = index; }
 
@@ -36,12 +41,75 @@ void ColumnDefinition::SetColumnName(const std::string& name) {
   column_name_ = name;
 }
 
-bool ColumnDefinition::IsFixedLength() { return this->fixed_size_ > 0; }
+ColumnEncoding ColumnDefinition::GetEncoding() const { return encoding_; }
+
+bool ColumnDefinition::IsFixedLength() const { return this->fixed_size_ > 0; }
+
+namespace {
+
+// Persisted dictionaries: one record per value, in code order per column,
+// so appending the newest values extends the data in place:
+//   [uint16_t field_index][uint16_t length][value bytes]
+constexpr size_t DICTIONARY_RECORD_HEADER = 2 * sizeof(uint16_t);
+
+// A dictionary-encoded field is aligned like this 2-byte type
+constexpr DataType DICTIONARY_CODE_TYPE = DataType::SMALLINT;
+
+bool StoredFixedLength(const ColumnDefinition& col) {
+  return col.IsFixedLength() ||
+         col.GetEncoding() == ColumnEncoding::DICTIONARY;
+}
+
+size_t StoredSize(const ColumnDefinition& col) {
+  return col.GetEncoding() == ColumnEncoding::DICTIONARY
+             ? sizeof(dictionary_code_t)
+             : col.GetFixedSize();
+}
+
+DataType StoredAlignmentType(const ColumnDefinition& col) {
+  return col.GetEncoding() == ColumnEncoding::DICTIONARY
+             ? DICTIONARY_CODE_TYPE
+             : col.GetDataType();
+}
+
+// Call visit(field_index, value) for every record of data, in order
+template <typename Visit>
+void ForEachDictionaryRecord(std::string_view data, Visit visit) {
+  size_t offset = 0;
+  while (offset < data.size()) {
+    if (offset + DICTIONARY_RECORD_HEADER > data.size()) {
+      throw std::runtime_error("Truncated dictionary record");
+    }
+    uint16_t field_index;
+    uint16_t length;
+    std::memcpy(&field_index, data.data() + offset, sizeof(uint16_t));
+    std::memcpy(&length, data.data() + offset + sizeof(uint16_t),
+                sizeof(uint16_t));
+    offset += DICTIONARY_RECORD_HEADER;
+    if (offset + length > data.size()) {
+      throw std::runtime_error("Truncated dictionary record");
+    }
+    visit(field_index, data.substr(offset, length));
+    offset += length;
+  }
+}
+
+}  // namespace
 
 void Schema::AddColumn(const std::string& name, DataType type, bool is_nullable,
-                       size_t size_param) {
+                       size_t size_param, ColumnEncoding encoding) {
+  if (columns_.size() >= TUPLE_MAX_FIELDS) {
+    throw std::invalid_argument("Schema holds at most " +
+                                std::to_string(TUPLE_MAX_FIELDS) + " columns");
+  }
+  if (encoding == ColumnEncoding::DICTIONARY && type != DataType::CHAR &&
+      type != DataType::VARCHAR) {
+    throw std::invalid_argument(
+        "Only CHAR and VARCHAR columns can be dictionary-encoded: " + name);
+  }
+
   // Create a new ColumnDefinition
-  ColumnDefinition col(name, type, is_nullable, size_param);
+  ColumnDefinition col(name, type, is_nullable, size_param, encoding);
   col.SetFieldIndex(columns_.size());
 
   // Add to columns vector
@@ -77,14 +145,16 @@ void Schema::Finalize() {
   // INT (4 bytes, align 4) → offset 4, next offset 8
   // DOUBLE (8 bytes, align 8) → offset 8, next offset 16
   // VARCHAR (0 bytes, variable) → offset 16, next offset 16
+  // A dictionary-encoded column counts as its 2-byte code
   for (auto& col : columns_) {
     // Align the offset for this column
-    current_offset = alignment::AlignOffset(current_offset, col.GetDataType());
+    current_offset =
+        alignment::AlignOffset(current_offset, StoredAlignmentType(col));
 
     col.SetOffset(current_offset);
 
     // Update the offset for the next column
-    size_t col_size = col.GetFixedSize();
+    size_t col_size = StoredSize(col);
     if (col_size == 0) {
       // Variable length column
       all_fixed_length = false;
@@ -95,6 +165,50 @@ void Schema::Finalize() {
 
   is_fixed_length_ = all_fixed_length;
   tuple_size_ = current_offset;
+
+  // Serialization plan used by TupleSerializer and TupleAccessor:
+  // [TupleHeader][fixed fields, each aligned, in column order][variable
+  // section]. Recording it here lets readers jump straight to one field
+  // and lets encoders loop without touching ColumnDefinition.
+  var_field_count_ = 0;
+  for (auto& col : columns_) {
+    if (!StoredFixedLength(col)) {
+      var_field_count_++;
+    }
+  }
+  const uint16_t field_count = static_cast<uint16_t>(columns_.size());
+  var_offsets_start_ = TupleHeader::CalculateNullBitmapSize(field_count);
+  tuple_header_size_ =
+      TupleHeader::CalculateHeaderSize(field_count, var_field_count_);
+
+  layout_.clear();
+  layout_.reserve(columns_.size());
+  dictionaries_.clear();
+  // Shared so that together the dictionaries fit in the schema area
+  auto budget = std::make_shared<DictionaryBudget>(DICTIONARY_BUDGET_BYTES);
+  size_t tuple_offset = tuple_header_size_;
+  uint16_t var_index = 0;
+  for (auto& col : columns_) {
+    FieldLayout field{};
+    field.type = col.GetDataType();
+    field.field_index = col.GetFieldIndex();
+    if (col.GetEncoding() == ColumnEncoding::DICTIONARY) {
+      dictionaries_.push_back(std::make_shared<ColumnDictionary>(budget));
+      field.dictionary = dictionaries_.back().get();
+    }
+    if (StoredFixedLength(col)) {
+      tuple_offset =
+          alignment::AlignOffset(tuple_offset, StoredAlignmentType(col));
+      field.offset = static_cast<uint32_t>(tuple_offset);
+      field.size = static_cast<uint32_t>(StoredSize(col));
+      tuple_offset += field.size;
+    } else {
+      field.var_index = var_index++;
+    }
+    layout_.push_back(field);
+  }
+  fixed_section_end_ = tuple_offset;
+
   is_finalized_ = true;
 }
 
@@ -118,6 +232,29 @@ ColumnDefinition Schema::GetColumn(const std::string& name) const {
   return ColumnDefinition("", BOOLEAN, false, 0);
 }
 
+const ColumnDefinition& Schema::GetColumnRef(size_t index) const {
+  return columns_[index];
+}
+
+const ColumnDefinition* Schema::FindColumn(const std::string& name) const {
+  auto it = column_name_to_index_.find(name);
+  if (it == column_name_to_index_.end()) {
+    return nullptr;
+  }
+  return &columns_[it->second];
+}
+
+ColumnHandle Schema::ResolveColumn(const std::string& name) const {
+  if (!is_finalized_) {
+    throw std::runtime_error("Schema must be finalized");
+  }
+  const ColumnDefinition* col = FindColumn(name);
+  if (col == nullptr) {
+    throw std::runtime_error("Column not found: " + name);
+  }
+  return ColumnHandle{layout_[col->GetFieldIndex()], col->GetIsNullable()};
+}
+
 bool Schema::HasColumn(const std::string& name) const {
   return column_name_to_index_.count(name) > 0;
 }
@@ -131,3 +268,77 @@ size_t Schema::GetNullBitmapSize() const { return null_bitmap_size_; }
 bool Schema::IsFinalized() const { return is_finalized_; }
 
 uint32_t Schema::GetTableId() const { return table_id_; }
+
+uint16_t Schema::GetVarFieldCount() const { return var_field_count_; }
+
+size_t Schema::GetVarOffsetsStart() const { return var_offsets_start_; }
+
+size_t Schema::GetTupleHeaderSize() const { return tuple_header_size_; }
+
+size_t Schema::GetFixedSectionEnd() const { return fixed_section_end_; }
+
+const std::vector<FieldLayout>& Schema::GetLayout() const { return layout_; }
+
+ColumnDictionary* Schema::GetDictionary(size_t field_index) const {
+  return field_index < layout_.size() ? layout_[field_index].dictionary
+                                      : nullptr;
+}
+
+void Schema::AppendDictionaryEntries(std::string* data) const {
+  // Values each dictionary already has in data
+  std::vector<size_t> persisted(layout_.size(), 0);
+  ForEachDictionaryRecord(*data, [&](uint16_t field_index,
+                                     std::string_view /*value*/) {
+    if (GetDictionary(field_index) == nullptr) {
+      throw std::runtime_error("Dictionary record for a column that is not "
+                               "dictionary-encoded");
+    }
+    persisted[field_index]++;
+  });
+
+  for (const FieldLayout& field : layout_) {
+    if (!field.IsDictionaryEncoded()) {
+      continue;
+    }
+    const size_t size = field.dictionary->GetSize();
+    if (persisted[field.field_index] > size) {
+      throw std::runtime_error("Persisted dictionary holds codes this "
+                               "schema never handed out");
+    }
+    for (size_t code = persisted[field.field_index]; code < size; code++) {
+      std::string_view value =
+          field.dictionary->Decode(static_cast<dictionary_code_t>(code));
+      if (value.size() > UINT16_MAX) {
+        throw std::runtime_error("Dictionary value too long to persist");
+      }
+      const uint16_t length = static_cast<uint16_t>(value.size());
+      data->append(reinterpret_cast<const char*>(&field.field_index),
+                   sizeof(uint16_t));
+      data->append(reinterpret_cast<const char*>(&length), sizeof(uint16_t));
+      data->append(value.data(), value.size());
+    }
+  }
+}
+
+void Schema::LoadDictionaries(std::string_view data) {
+  if (!is_finalized_) {
+    throw std::runtime_error("Schema must be finalized");
+  }
+  for (const std::shared_ptr<ColumnDictionary>& dictionary : dictionaries_) {
+    if (dictionary->GetSize() > 0) {
+      throw std::runtime_error("Dictionaries already hold values");
+    }
+  }
+
+  ForEachDictionaryRecord(data, [&](uint16_t field_index,
+                                    std::string_view value) {
+    ColumnDictionary* dictionary = GetDictionary(field_index);
+    if (dictionary == nullptr) {
+      throw std::runtime_error("Dictionary record for a column that is not "
+                               "dictionary-encoded");
+    }
+    if (!dictionary->Append(value)) {
+      throw std::runtime_error("Duplicate or excess dictionary value");
+    }
+  });
+}
@@ -0,0 +1,64 @@
+#include "../../include/storage/async_io.h"
+
+#include <stdexcept>
+#include <string>
+
+#include "../../include/common/logger.h"
+#include "../../include/storage/io_uring_engine.h"
+#include "../../include/storage/thread_pool_io_engine.h"
+
+ErrorCode IOHandle::Wait() const {
+  if (state_ == nullptr) {
+    return {-1, "IOHandle::Wait: Invalid handle"};
+  }
+
+  std::unique_lock<std::mutex> lock(state_->mutex);
+  state_->cv.wait(lock, [this]() { return state_->done; });
+  return state_->result;
+}
+
+bool IOHandle::IsReady() const {
+  if (state_ == nullptr) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  return state_->done;
+}
+
+void IOHandle::Complete(State* state, const IORequest& request, ssize_t res) {
+  ErrorCode result{0, "IOHandle: Success"};
+  if (request.on_complete) {
+    result = request.on_complete(res);
+  } else if (res != static_cast<ssize_t>(request.length)) {
+    result = {-1, "IOHandle: Short or failed I/O (result " +
+                      std::to_string(res) + ")"};
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    state->result = std::move(result);
+    state->done = true;
+  }
+  state->cv.notify_all();
+}
+
+std::unique_ptr<AsyncIOEngine> AsyncIOEngine::Create(IOEngineType type,
+                                                     size_t queue_depth) {
+  if (type == IOEngineType::THREAD_POOL) {
+    return std::make_unique<ThreadPoolIOEngine>();
+  }
+
+  try {
+    return std::make_unique<IoUringEngine>(queue_depth);
+  } catch (const std::exception& e) {
+    if (type == IOEngineType::IO_URING) {
+      LOG_ERROR_STREAM("AsyncIOEngine: io_uring unavailable: " << e.what());
+      return nullptr;
+    }
+    LOG_WARNING_STREAM("AsyncIOEngine: io_uring unavailable ("
+                       << e.what() << "), using thread pool");
+  }
+
+  return std::make_unique<ThreadPoolIOEngine>();
+}
@@ -1,28 +1,138 @@
 #include "../../include/storage/disk_manager.h"
 
 #include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstdlib>
 #include <cstring>
+#include <new>
+#include <random>
 #include <stdexcept>
+#include <utility>
 
 #include "../../include/common/checksum.h"
+#include "../../include/common/compression.h"
 #include "../../include/common/logger.h"
+#include "../../include/common/trace.h"
 #include "../../include/page/page.h"
 #include "../../include/page/page_view.h"
 
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+uint64_t NanosSince(Clock::time_point start) {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() -
+                                                           start)
+          .count());
+}
+
+// A compressed extent: [uint16_t stored size][TupleCompressor stored form],
+// zero-padded to whole blocks. An extent of PAGE_EXTENT_MAX_BLOCKS blocks
+// holds the page as it is.
+constexpr size_t EXTENT_SIZE_PREFIX = sizeof(uint16_t);
+
+const TupleCompressor& PageCompressor() {
+  static const TupleCompressor compressor;
+  return compressor;
+}
+
+off_t ExtentOffset(PageExtent extent) {
+  return static_cast<off_t>(extent.first_block) *
+         static_cast<off_t>(PAGE_EXTENT_BLOCK_SIZE);
+}
+
+size_t ExtentBytes(PageExtent extent) {
+  return size_t{extent.block_count} * PAGE_EXTENT_BLOCK_SIZE;
+}
+
+// Compress page_data into out (PAGE_SIZE bytes). Returns the blocks the
+// extent takes, PAGE_EXTENT_MAX_BLOCKS if the page does not shrink by at
+// least a block (out is then unused).
+uint16_t EncodePage(const char* page_data, char* out) {
+  const size_t capacity =
+      (PAGE_EXTENT_MAX_BLOCKS - 1) * PAGE_EXTENT_BLOCK_SIZE -
+      EXTENT_SIZE_PREFIX;
+  const uint16_t size = PageCompressor().Compress(
+      page_data, PAGE_SIZE, out + EXTENT_SIZE_PREFIX, capacity);
+  if (size == 0) {
+    return PAGE_EXTENT_MAX_BLOCKS;
+  }
+  std::memcpy(out, &size, sizeof(size));
+  const size_t used = EXTENT_SIZE_PREFIX + size;
+  const size_t blocks =
+      (used + PAGE_EXTENT_BLOCK_SIZE - 1) / PAGE_EXTENT_BLOCK_SIZE;
+  std::memset(out + used, 0, blocks * PAGE_EXTENT_BLOCK_SIZE - used);
+  return static_cast<uint16_t>(blocks);
+}
+
+bool DecodePage(const char* extent, size_t extent_size, char* page_data) {
+  uint16_t size;
+  std::memcpy(&size, extent, sizeof(size));
+  if (EXTENT_SIZE_PREFIX + size > extent_size) {
+    return false;
+  }
+  uint16_t raw_size = 0;
+  return PageCompressor()
+                 .Decompress(extent + EXTENT_SIZE_PREFIX, size, page_data,
+                             PAGE_SIZE, &raw_size)
+                 .code == 0 &&
+         raw_size == PAGE_SIZE;
+}
+
+// Staging for synchronous extent transfers
+char* ExtentBuffer() {
+  thread_local std::vector<char> buffer(PAGE_SIZE);
+  return buffer.data();
+}
+
+// Identity of a new file, so backups of different files never mix
+uint64_t NewFileId() {
+  std::random_device device;
+  uint64_t id = 0;
+  while (id == 0) {
+    id = (static_cast<uint64_t>(device()) << 32) | device();
+  }
+  return id;
+}
+
+}  // namespace
+
 //  - ReadPage() - NO LOCK (pread is thread-safe)
 //  - WritePage() - NO LOCK (pwrite is thread-safe)
 //  mutex for metadata operations only:
 //   - OpenDBFile() / CloseDBFile() - File descriptor and state changes
 //   - AllocatePage() - Updates next_page_id_ and page count
 //   - DeallocatePage() - no-op for now
-DiskManager::DiskManager(const std::string& db_file_name)
+//  sync_mutex_ only serializes fdatasync(); writers never wait on it
+DiskManager::DiskManager(const std::string& db_file_name,
+                         DurabilityMode durability_mode,
+                         uint32_t sync_interval_ms,
+                         IOEngineType io_engine_type, bool use_direct_io,
+                         bool compress_pages,
+                         const TablespaceLayout& tablespace)
     : db_file_name_(db_file_name),
       db_file_descriptor_(-1),
+      direct_file_descriptor_(-1),
+      use_direct_io_(use_direct_io),
+      compress_pages_(compress_pages),
+      tablespace_layout_(tablespace),
       next_page_id_(0),
-      is_open_(false) {
+      is_open_(false),
+      durability_mode_(durability_mode),
+      sync_interval_ms_(sync_interval_ms),
+      has_unsynced_writes_(false),
+      sync_count_(0),
+      stop_sync_thread_(false),
+      io_engine_type_(io_engine_type) {
   LOG_INFO_STREAM("DiskManager: Initializing with file: " << db_file_name);
   ErrorCode errorCode = OpenDBFile();
   if (errorCode != ERROR_ALREADY_OPEN) {
@@ -32,11 +142,50 @@ DiskManager::DiskManager(const std::string& db_file_name)
     LOG_WARNING_STREAM(
         "DiskManager: Database file already open: " << db_file_name);
   }
+
+  if (durability_mode_ == DurabilityMode::PERIODIC) {
+    if (sync_interval_ms_ == 0) {
+      LOG_ERROR("DiskManager: Periodic sync interval must be positive");
+      CloseDBFile();
+      throw std::invalid_argument("Periodic sync interval must be positive");
+    }
+    sync_thread_ = std::thread(&DiskManager::SyncThreadLoop, this);
+    LOG_INFO_STREAM("DiskManager: Periodic sync every " << sync_interval_ms_
+                                                        << " ms");
+  }
+}
+
+DiskManager::DiskManager(const std::string& db_file_name,
+                         AccessPattern access_pattern)
+    : db_file_name_(db_file_name),
+      db_file_descriptor_(-1),
+      direct_file_descriptor_(-1),
+      use_direct_io_(false),
+      compress_pages_(false),
+      next_page_id_(0),
+      is_open_(false),
+      durability_mode_(DurabilityMode::IMMEDIATE),
+      sync_interval_ms_(0),
+      has_unsynced_writes_(false),
+      sync_count_(0),
+      stop_sync_thread_(false),
+      io_engine_type_(IOEngineType::AUTO),
+      read_only_(true) {
+  LOG_INFO_STREAM("DiskManager: Mapping read-only file: " << db_file_name);
+  OpenMappedFile(access_pattern);
+}
+
+std::unique_ptr<DiskManager> DiskManager::OpenReadOnly(
+    const std::string& db_file_name, AccessPattern access_pattern) {
+  return std::unique_ptr<DiskManager>(
+      new DiskManager(db_file_name, access_pattern));
 }
 
 DiskManager::~DiskManager() {
   LOG_INFO_STREAM(
       "DiskManager: Destroying disk manager for file: " << db_file_name_);
+  StopSyncThread();
+  io_engines_.clear();  // drains in-flight async I/O before the fds close
   CloseDBFile();
 }
 
@@ -57,6 +206,13 @@ DiskManager::ErrorCode DiskManager::OpenDBFile() {
   struct stat buffer;
   bool file_exists = (stat(db_file_name_.c_str(), &buffer) == 0);
 
+  const bool striped = !tablespace_layout_.stripe_files.empty();
+  if (!file_exists && striped && compress_pages_) {
+    LOG_ERROR_STREAM("DiskManager: Compressed pages cannot be striped: "
+                     << db_file_name_);
+    throw std::invalid_argument("Compressed pages cannot be striped");
+  }
+
   // Open file with read/write permissions, create if doesn't exist
   db_file_descriptor_ =
       open(db_file_name_.c_str(), O_RDWR | O_CREAT, S_IRUSR | S_IWUSR);
@@ -74,12 +230,35 @@ DiskManager::ErrorCode DiskManager::OpenDBFile() {
 
     memset(&file_header_, 0, sizeof(FileHeader));
     memcpy(file_header_.magic_number, "STOR", 4);
-    file_header_.version = 1;
+    file_header_.version = FILE_FORMAT_VERSION;
     file_header_.next_page_id = 1;  // Start from 1 (0 is INVALID_PAGE_ID)
     file_header_.page_size_ = PAGE_SIZE;
     file_header_.page_count_ = 0;
+    file_header_.flags = FILE_FLAG_ALIGNED_PAGES;
+    if (compress_pages_) {
+      file_header_.flags |= FILE_FLAG_COMPRESSED_PAGES;
+    }
+    file_header_.file_id = NewFileId();
     next_page_id_ = 1;  // Initialize next_page_id_
 
+    // Stripe files exist before a header can point at them
+    if (striped) {
+      try {
+        tablespace_ = std::make_unique<Tablespace>(
+            db_file_name_, db_file_descriptor_, tablespace_layout_,
+            /*create=*/true);
+      } catch (...) {
+        close(db_file_descriptor_);
+        db_file_descriptor_ = -1;
+        unlink(db_file_name_.c_str());
+        throw;
+      }
+      file_header_.flags |= FILE_FLAG_STRIPED_PAGES;
+      file_header_.stripe_count =
+          static_cast<uint32_t>(tablespace_->GetFileCount());
+      file_header_.stripe_extent_pages = tablespace_->GetExtentPages();
+    }
+
     // Write header to file using pwrite()
     ssize_t bytes_written =
         pwrite(db_file_descriptor_, &file_header_, sizeof(FileHeader), 0);
@@ -92,6 +271,11 @@ DiskManager::ErrorCode DiskManager::OpenDBFile() {
 
     // Sync to disk
     fsync(db_file_descriptor_);
+
+    if (compress_pages_) {
+      extent_map_ = std::make_unique<ExtentMap>(
+          db_file_name_ + ".pmap", db_file_descriptor_, /*create=*/true);
+    }
   } else {
     // Existing file - read header using pread()
     LOG_INFO_STREAM(
@@ -114,15 +298,280 @@ DiskManager::ErrorCode DiskManager::OpenDBFile() {
       throw std::runtime_error("Invalid database file format");
     }
 
+    if (file_header_.version == 0 ||
+        file_header_.version > FILE_FORMAT_VERSION) {
+      LOG_ERROR_STREAM("DiskManager: Unsupported file format version "
+                       << file_header_.version);
+      close(db_file_descriptor_);
+      db_file_descriptor_ = -1;
+      throw std::runtime_error("Unsupported database file format version");
+    }
+
     next_page_id_ = file_header_.next_page_id;
     LOG_INFO_STREAM(
         "DiskManager: Loaded existing file, next_page_id: " << next_page_id_);
+
+    if (file_header_.flags & FILE_FLAG_COMPRESSED_PAGES) {
+      try {
+        extent_map_ = std::make_unique<ExtentMap>(
+            db_file_name_ + ".pmap", db_file_descriptor_, /*create=*/false);
+      } catch (...) {
+        close(db_file_descriptor_);
+        db_file_descriptor_ = -1;
+        throw;
+      }
+    } else if (compress_pages_) {
+      LOG_WARNING_STREAM("DiskManager: " << db_file_name_
+                                         << " was created without page "
+                                            "compression, storing pages as "
+                                            "they are");
+    }
+
+    if (file_header_.flags & FILE_FLAG_STRIPED_PAGES) {
+      try {
+        TablespaceLayout layout;
+        layout.extent_pages = file_header_.stripe_extent_pages;
+        tablespace_ = std::make_unique<Tablespace>(
+            db_file_name_, db_file_descriptor_, layout, /*create=*/false);
+        if (tablespace_->GetFileCount() != file_header_.stripe_count) {
+          LOG_ERROR_STREAM("DiskManager: " << db_file_name_ << " has "
+                                           << file_header_.stripe_count
+                                           << " stripes, its list names "
+                                           << tablespace_->GetFileCount());
+          throw std::runtime_error("Tablespace does not match file header");
+        }
+      } catch (...) {
+        tablespace_.reset();
+        close(db_file_descriptor_);
+        db_file_descriptor_ = -1;
+        throw;
+      }
+    } else if (striped) {
+      LOG_WARNING_STREAM("DiskManager: " << db_file_name_
+                                         << " was created unstriped, "
+                                            "ignoring the stripe files");
+    }
+
+    if (file_header_.version < FILE_FORMAT_VERSION) {
+      UpgradeFormat();
+    }
+  }
+
+  if (use_direct_io_ && extent_map_ != nullptr) {
+    LOG_WARNING_STREAM("DiskManager: " << db_file_name_
+                                       << " stores compressed pages, "
+                                          "falling back to buffered I/O");
+  } else if (use_direct_io_) {
+    OpenDirectIO();
   }
 
   is_open_ = true;
   return static_cast<ErrorCode>(0);  // Success
 }
 
+void DiskManager::UpgradeFormat() {
+  LOG_INFO_STREAM("DiskManager: Upgrading " << db_file_name_
+                                            << " from format version "
+                                            << file_header_.version);
+
+  std::vector<char> page_data(PAGE_SIZE);
+  size_t converted = 0;
+  for (page_id_t page_id = 1; page_id < next_page_id_; page_id++) {
+    // Allocated pages that were never written are simply absent
+    if (pread(db_file_descriptor_, page_data.data(), PAGE_SIZE,
+              PageOffset(page_id)) != static_cast<ssize_t>(PAGE_SIZE)) {
+      continue;
+    }
+
+    // Pages converted before an interrupted upgrade verify in the new layout
+    PageView page_view(page_data.data());
+    if (!page_view.IsLegacyLayout(file_header_.version)) {
+      if (!page_view.VerifyChecksum()) {
+        LOG_WARNING_STREAM("DiskManager: Page " << page_id
+                                                << " verifies in neither "
+                                                   "layout, left unchanged");
+      }
+      continue;
+    }
+
+    if (!page_view.ConvertFromLegacyLayout(file_header_.version)) {
+      SpillForUpgrade(page_id, page_data.data());
+    }
+    PreparePageWrite(page_data.data());
+    if (pwrite(db_file_descriptor_, page_data.data(), PAGE_SIZE,
+               PageOffset(page_id)) != static_cast<ssize_t>(PAGE_SIZE)) {
+      LOG_ERROR_STREAM("DiskManager: Failed to rewrite page " << page_id
+                                                              << " during "
+                                                                 "upgrade");
+      close(db_file_descriptor_);
+      db_file_descriptor_ = -1;
+      throw std::runtime_error("Failed to upgrade database file");
+    }
+    converted++;
+  }
+
+  // Pages must be durable before the header claims the new format
+  fsync(db_file_descriptor_);
+  file_header_.version = FILE_FORMAT_VERSION;
+  if (pwrite(db_file_descriptor_, &file_header_, sizeof(FileHeader), 0) !=
+      static_cast<ssize_t>(sizeof(FileHeader))) {
+    LOG_ERROR_STREAM("DiskManager: Failed to write upgraded file header");
+    close(db_file_descriptor_);
+    db_file_descriptor_ = -1;
+    throw std::runtime_error("Failed to upgrade database file");
+  }
+  fsync(db_file_descriptor_);
+
+  LOG_INFO_STREAM("DiskManager: Upgraded " << converted << " pages to format "
+                                           << "version "
+                                           << FILE_FORMAT_VERSION);
+}
+
+void DiskManager::SpillForUpgrade(page_id_t page_id, char* page_data) {
+  const page_id_t overflow_page_id = next_page_id_;
+  std::vector<char> overflow_data(PAGE_SIZE);
+  PageView overflow(overflow_data.data());
+  overflow.Initialize();
+  overflow.SetPageId(overflow_page_id);
+
+  PageView page_view(page_data);
+  do {
+    if (!page_view.SpillTuple(overflow, overflow_page_id)) {
+      LOG_ERROR_STREAM("DiskManager: Page " << page_id
+                                            << " is too full to upgrade");
+      close(db_file_descriptor_);
+      db_file_descriptor_ = -1;
+      throw std::runtime_error("Failed to upgrade database file");
+    }
+  } while (!page_view.ConvertFromLegacyLayout(file_header_.version));
+
+  // The overflow page and the id that covers it must be durable before any
+  // stub pointing at it is written
+  next_page_id_++;
+  file_header_.next_page_id = next_page_id_;
+  PreparePageWrite(overflow_data.data());
+  if (pwrite(db_file_descriptor_, overflow_data.data(), PAGE_SIZE,
+             PageOffset(overflow_page_id)) !=
+          static_cast<ssize_t>(PAGE_SIZE) ||
+      pwrite(db_file_descriptor_, &file_header_, sizeof(FileHeader), 0) !=
+          static_cast<ssize_t>(sizeof(FileHeader))) {
+    LOG_ERROR_STREAM("DiskManager: Failed to write overflow page "
+                     << overflow_page_id << " during upgrade");
+    close(db_file_descriptor_);
+    db_file_descriptor_ = -1;
+    throw std::runtime_error("Failed to upgrade database file");
+  }
+  fsync(db_file_descriptor_);
+
+  LOG_INFO_STREAM("DiskManager: Moved " << overflow.GetSlotCount()
+                                        << " tuples of page " << page_id
+                                        << " to overflow page "
+                                        << overflow_page_id);
+}
+
+void DiskManager::OpenMappedFile(AccessPattern access_pattern) {
+  std::lock_guard<std::mutex> lock(metadata_mutex_);
+
+  db_file_descriptor_ = open(db_file_name_.c_str(), O_RDONLY);
+  if (db_file_descriptor_ < 0) {
+    LOG_ERROR_STREAM("DiskManager: Failed to open file: "
+                     << db_file_name_ << " errno: " << errno);
+    throw std::runtime_error("Failed to open database file: " + db_file_name_);
+  }
+
+  const char* error = nullptr;
+  struct stat file_stat;
+  if (fstat(db_file_descriptor_, &file_stat) != 0 ||
+      static_cast<size_t>(file_stat.st_size) < sizeof(FileHeader)) {
+    error = "Failed to read database file header";
+  } else {
+    mapping_size_ = static_cast<size_t>(file_stat.st_size);
+    void* mapping = mmap(nullptr, mapping_size_, PROT_READ, MAP_SHARED,
+                         db_file_descriptor_, 0);
+    if (mapping == MAP_FAILED) {
+      error = "Failed to map database file";
+    } else {
+      mapping_ = static_cast<char*>(mapping);
+      memcpy(&file_header_, mapping_, sizeof(FileHeader));
+      if (memcmp(file_header_.magic_number, "STOR", 4) != 0) {
+        error = "Invalid database file format";
+      } else if (file_header_.version != FILE_FORMAT_VERSION) {
+        error = "Unsupported database file format version for read-only open";
+      } else if (file_header_.flags & FILE_FLAG_COMPRESSED_PAGES) {
+        error = "Compressed-page files cannot be mapped read-only";
+      } else if (file_header_.flags & FILE_FLAG_STRIPED_PAGES) {
+        error = "Striped files cannot be mapped read-only";
+      }
+    }
+  }
+
+  if (error != nullptr) {
+    LOG_ERROR_STREAM("DiskManager: " << error << ": " << db_file_name_
+                                     << " errno: " << errno);
+    if (mapping_ != nullptr) {
+      munmap(mapping_, mapping_size_);
+      mapping_ = nullptr;
+    }
+    close(db_file_descriptor_);
+    db_file_descriptor_ = -1;
+    throw std::runtime_error(error);
+  }
+
+  next_page_id_ = file_header_.next_page_id;
+  is_open_ = true;
+
+  AdviseAccess(access_pattern);
+  LOG_INFO_STREAM("DiskManager: Mapped " << mapping_size_ << " bytes, "
+                                         << "next_page_id: " << next_page_id_);
+}
+
+PageView DiskManager::GetPageView(page_id_t page_id) const {
+  if (!read_only_ || !is_open_) {
+    LOG_ERROR_STREAM("DiskManager: Page views need a read-only mapped file");
+    throw std::runtime_error("Database file not opened read-only");
+  }
+
+  const off_t offset = PageOffset(page_id);
+  if (page_id >= next_page_id_ ||
+      static_cast<size_t>(offset) + PAGE_SIZE > mapping_size_) {
+    LOG_ERROR_STREAM("DiskManager: Page " << page_id
+                                          << " is outside the mapped file");
+    throw std::invalid_argument("Page is outside the mapped file");
+  }
+
+  // Verified on the first access only; racing first readers both verify
+  char* page_data = mapping_ + offset;
+  if (!verified_pages_.Test(page_id)) {
+    FinishPageRead(page_id, page_data);
+    verified_pages_.Set(page_id);
+  }
+  return PageView(page_data);
+}
+
+void DiskManager::AdviseAccess(AccessPattern access_pattern) const {
+  if (mapping_ == nullptr) {
+    return;
+  }
+
+  int advice = MADV_NORMAL;
+  if (access_pattern == AccessPattern::SEQUENTIAL) {
+    advice = MADV_SEQUENTIAL;
+  } else if (access_pattern == AccessPattern::RANDOM) {
+    advice = MADV_RANDOM;
+  }
+  // Only a hint: failure costs performance, never correctness
+  if (madvise(mapping_, mapping_size_, advice) != 0) {
+    LOG_WARNING_STREAM("DiskManager: madvise failed, errno: " << errno);
+  }
+}
+
+void DiskManager::RequireWritable() const {
+  if (read_only_) {
+    LOG_ERROR_STREAM("DiskManager: File is open read-only: " << db_file_name_);
+    throw std::runtime_error("Database file is open read-only");
+  }
+}
+
 void DiskManager::CloseDBFile() {
   std::lock_guard<std::mutex> lock(metadata_mutex_);
 
@@ -130,12 +579,41 @@ void DiskManager::CloseDBFile() {
     return;
   }
 
+  if (read_only_) {
+    munmap(mapping_, mapping_size_);
+    mapping_ = nullptr;
+    close(db_file_descriptor_);
+    db_file_descriptor_ = -1;
+    is_open_ = false;
+    LOG_INFO_STREAM("DiskManager: Unmapped database file: " << db_file_name_);
+    return;
+  }
+
   // Update header with current next_page_id
   file_header_.next_page_id = next_page_id_;
   pwrite(db_file_descriptor_, &file_header_, sizeof(FileHeader), 0);
 
   // Sync and close
-  fsync(db_file_descriptor_);
+  if (extent_map_ != nullptr) {
+    ExtentMap::Changes changes = extent_map_->TakeChanges();
+    fsync(db_file_descriptor_);
+    try {
+      extent_map_->Persist(std::move(changes));
+    } catch (const std::exception& e) {
+      LOG_ERROR_STREAM("DiskManager: " << e.what());
+    }
+    extent_map_.reset();
+  } else {
+    if (tablespace_ != nullptr) {
+      tablespace_->SyncStripeFiles();
+    }
+    fsync(db_file_descriptor_);
+  }
+  tablespace_.reset();
+  if (direct_file_descriptor_ >= 0) {
+    close(direct_file_descriptor_);
+    direct_file_descriptor_ = -1;
+  }
   close(db_file_descriptor_);
 
   db_file_descriptor_ = -1;
@@ -144,7 +622,72 @@ void DiskManager::CloseDBFile() {
   LOG_INFO_STREAM("DiskManager: Closed database file: " << db_file_name_);
 }
 
+void DiskManager::OpenDirectIO() {
+#ifdef O_DIRECT
+  if (!(file_header_.flags & FILE_FLAG_ALIGNED_PAGES)) {
+    LOG_WARNING_STREAM("DiskManager: " << db_file_name_
+                                       << " uses the unaligned page layout, "
+                                          "falling back to buffered I/O");
+    return;
+  }
+
+  static_assert(PAGE_SIZE % DIRECT_IO_ALIGNMENT == 0,
+                "Page offsets must be direct I/O aligned");
+
+  int fd = open(db_file_name_.c_str(), O_RDWR | O_DIRECT);
+  if (fd < 0) {
+    LOG_WARNING_STREAM("DiskManager: O_DIRECT open rejected (errno: "
+                       << errno << "), falling back to buffered I/O");
+    return;
+  }
+
+  // Some filesystems accept the flag at open() but fail the first transfer
+  char* probe = static_cast<char*>(std::aligned_alloc(PAGE_SIZE, PAGE_SIZE));
+  if (probe == nullptr) {
+    close(fd);
+    throw std::bad_alloc();
+  }
+  ssize_t probe_result = pread(fd, probe, PAGE_SIZE, 0);
+  int probe_errno = errno;
+  std::free(probe);
+  if (probe_result < 0) {
+    LOG_WARNING_STREAM("DiskManager: O_DIRECT read rejected (errno: "
+                       << probe_errno << "), falling back to buffered I/O");
+    close(fd);
+    return;
+  }
+
+  if (tablespace_ != nullptr && !tablespace_->OpenDirectIO(fd)) {
+    LOG_WARNING("DiskManager: A stripe file rejected O_DIRECT, falling back "
+                "to buffered I/O");
+    close(fd);
+    return;
+  }
+
+  direct_file_descriptor_ = fd;
+  LOG_INFO_STREAM("DiskManager: Direct I/O enabled for " << db_file_name_);
+#else
+  LOG_WARNING("DiskManager: O_DIRECT not supported, using buffered I/O");
+#endif
+}
+
+int DiskManager::PageFileDescriptor(size_t file,
+                                    const char* page_data) const {
+  if (direct_file_descriptor_ >= 0 &&
+      reinterpret_cast<uintptr_t>(page_data) % DIRECT_IO_ALIGNMENT == 0) {
+    return tablespace_ != nullptr ? tablespace_->GetDirectFileDescriptor(file)
+                                  : direct_file_descriptor_;
+  }
+  return BufferedFileDescriptor(file);
+}
+
+int DiskManager::BufferedFileDescriptor(size_t file) const {
+  return tablespace_ != nullptr ? tablespace_->GetFileDescriptor(file)
+                                : db_file_descriptor_;
+}
+
 void DiskManager::ReadPage(page_id_t page_id, char* page_data) const {
+  TRACE_SPAN("DiskManager::ReadPage");
   // No lock needed - pread() is thread-safe!
 
   if (!is_open_ || db_file_descriptor_ < 0) {
@@ -157,68 +700,423 @@ void DiskManager::ReadPage(page_id_t page_id, char* page_data) const {
     throw std::invalid_argument("page_data cannot be nullptr");
   }
 
-  // Calculate offset: skip file header, then page_id * PAGE_SIZE
-  off_t offset = sizeof(FileHeader) + (page_id * PAGE_SIZE);
+  const Clock::time_point start = Clock::now();
+  if (read_only_) {
+    memcpy(page_data, GetPageView(page_id).GetRawBuffer(), PAGE_SIZE);
+    page_reads_.Add();
+    read_latency_.Record(NanosSince(start));
+    return;
+  }
+
+  if (extent_map_ != nullptr) {
+    if (!ReadExtent(page_id, page_data)) {
+      LOG_ERROR_STREAM("DiskManager: Failed to read page "
+                       << page_id << " from its extent");
+      throw std::runtime_error("Failed to read page from disk");
+    }
+    page_reads_.Add();
+    read_latency_.Record(NanosSince(start));
+    FinishPageRead(page_id, page_data);
+    return;
+  }
 
   // pread() is thread-safe - atomically reads at offset without modifying fd
   // position
-  ssize_t bytes_read = pread(db_file_descriptor_, page_data, PAGE_SIZE, offset);
+  ssize_t bytes_read =
+      pread(PageFileDescriptor(PageFile(page_id), page_data), page_data,
+            PAGE_SIZE, PageOffset(page_id));
   if (bytes_read != PAGE_SIZE) {
     LOG_ERROR_STREAM("DiskManager: Failed to read page "
                      << page_id << ", bytes_read: " << bytes_read);
     throw std::runtime_error("Failed to read page from disk");
   }
 
-  // Initialize runtime metadata after reading from disk
-  auto* page_header = reinterpret_cast<PageHeader*>(page_data);
-  page_header->deleted_tuple_count_ = 0;
-  page_header->fragmented_bytes_ = 0;
-  page_header->is_dirty_ = false;  // Just loaded from disk, not modified yet
+  page_reads_.Add();
+  read_latency_.Record(NanosSince(start));
+  FinishPageRead(page_id, page_data);
+
+  LOG_INFO_F("DiskManager: Successfully read page %u",
+             static_cast<unsigned>(page_id));
+}
+
+void DiskManager::WritePage(page_id_t page_id, const char* page_data,
+                            bool defer_sync) const {
+  if (!is_open_ || db_file_descriptor_ < 0) {
+    LOG_ERROR_STREAM("DiskManager: Cannot write page, file not open");
+    throw std::runtime_error("Database file not open");
+  }
+  RequireWritable();
+
+  if (page_data == nullptr) {
+    LOG_ERROR_STREAM("DiskManager: Invalid page_data pointer (nullptr)");
+    throw std::invalid_argument("page_data cannot be nullptr");
+  }
+
+  PreparePageWrite(page_data);
+  // Held until the write is done, so a snapshot starts before or after it
+  std::shared_lock<std::shared_mutex> snapshot_lock(snapshot_mutex_);
+  NotePageChange(page_id);
+  BeginPageWrite(page_id);
+
+  // pwrite() is thread-safe  atomically writes at offset without modifying fd
+  // position
+  const Clock::time_point start = Clock::now();
+  if (extent_map_ != nullptr) {
+    WriteExtent(page_id, page_data);
+  } else {
+    ssize_t bytes_written =
+        pwrite(PageFileDescriptor(PageFile(page_id), page_data), page_data,
+               PAGE_SIZE, PageOffset(page_id));
+    if (bytes_written != PAGE_SIZE) {
+      LOG_ERROR_STREAM("DiskManager: Failed to write page "
+                       << page_id << ", bytes_written: " << bytes_written);
+      throw std::runtime_error("Failed to write page to disk");
+    }
+  }
+  page_writes_.Add();
+  write_latency_.Record(NanosSince(start));
+  FinishPageWrite(page_id);
+  snapshot_lock.unlock();
+
+  has_unsynced_writes_.store(true);
+  if (durability_mode_ == DurabilityMode::IMMEDIATE && !defer_sync) {
+    Sync();
+  }
+
+  LOG_INFO_F("DiskManager: Successfully wrote page %u",
+             static_cast<unsigned>(page_id));
+}
+
+void DiskManager::WritePages(page_id_t first_page_id,
+                             const std::vector<const char*>& pages,
+                             bool defer_sync) const {
+  if (!is_open_ || db_file_descriptor_ < 0) {
+    LOG_ERROR_STREAM("DiskManager: Cannot write pages, file not open");
+    throw std::runtime_error("Database file not open");
+  }
+  RequireWritable();
+
+  if (pages.empty()) {
+    return;
+  }
+
+  // O_DIRECT only if every buffer qualifies: one descriptor per pwritev
+  bool all_aligned = true;
+  for (const char* page_data : pages) {
+    if (page_data == nullptr) {
+      LOG_ERROR_STREAM("DiskManager: Invalid page_data pointer (nullptr)");
+      throw std::invalid_argument("page_data cannot be nullptr");
+    }
+    all_aligned = all_aligned &&
+                  PageFileDescriptor(0, page_data) != db_file_descriptor_;
+    PreparePageWrite(page_data);
+  }
+  std::shared_lock<std::shared_mutex> snapshot_lock(snapshot_mutex_);
+  for (size_t i = 0; i < pages.size(); i++) {
+    NotePageChange(first_page_id + static_cast<page_id_t>(i));
+    BeginPageWrite(first_page_id + static_cast<page_id_t>(i));
+  }
+
+  // Extents are not contiguous: one write per page
+  for (size_t i = 0; extent_map_ != nullptr && i < pages.size(); i++) {
+    const Clock::time_point start = Clock::now();
+    WriteExtent(first_page_id + static_cast<page_id_t>(i), pages[i]);
+    page_writes_.Add();
+    write_latency_.Record(NanosSince(start));
+    FinishPageWrite(first_page_id + static_cast<page_id_t>(i));
+  }
 
-  // Recompute fragmentation stats by scanning slot directory
-  uint16_t slot_count = page_header->slot_count;
-  for (slot_id_t i = 0; i < slot_count; i++) {
-    size_t slot_offset = PAGE_SIZE - (i + 1) * SLOT_ENTRY_SIZE;
-    auto* slot_entry = reinterpret_cast<SlotEntry*>(
-        reinterpret_cast<uint8_t*>(page_data) + slot_offset);
+  std::vector<iovec> iov(std::min<size_t>(pages.size(), IOV_MAX));
+  for (size_t done = extent_map_ != nullptr ? pages.size() : 0;
+       done < pages.size();) {
+    const page_id_t page_id = first_page_id + static_cast<page_id_t>(done);
+    const size_t file = PageFile(page_id);
+    const int fd = all_aligned ? PageFileDescriptor(file, pages[done])
+                               : BufferedFileDescriptor(file);
 
-    if (!(slot_entry->flags & SLOT_VALID)) {
-      page_header->deleted_tuple_count_++;
-      page_header->fragmented_bytes_ += slot_entry->length;
+    // Striped pages are contiguous only within an extent
+    size_t batch = std::min(iov.size(), pages.size() - done);
+    if (tablespace_ != nullptr) {
+      batch = std::min(batch, tablespace_->ContiguousPages(page_id));
+    }
+    for (size_t i = 0; i < batch; i++) {
+      iov[i].iov_base = const_cast<char*>(pages[done + i]);
+      iov[i].iov_len = PAGE_SIZE;
+    }
+
+    const ssize_t expected = static_cast<ssize_t>(batch * PAGE_SIZE);
+    const Clock::time_point start = Clock::now();
+    const ssize_t bytes_written = pwritev(
+        fd, iov.data(), static_cast<int>(batch), PageOffset(page_id));
+    if (bytes_written != expected) {
+      LOG_ERROR_STREAM("DiskManager: Failed to write pages "
+                       << page_id << "-" << page_id + batch - 1
+                       << ", bytes_written: " << bytes_written);
+      throw std::runtime_error("Failed to write pages to disk");
+    }
+    page_writes_.Add(batch);
+    write_latency_.Record(NanosSince(start));
+    for (size_t i = 0; i < batch; i++) {
+      FinishPageWrite(page_id + static_cast<page_id_t>(i));
     }
+    done += batch;
   }
+  snapshot_lock.unlock();
+
+  has_unsynced_writes_.store(true);
+  if (durability_mode_ == DurabilityMode::IMMEDIATE && !defer_sync) {
+    Sync();
+  }
+
+  LOG_INFO_F("DiskManager: Successfully wrote %zu pages starting at %u",
+             pages.size(), static_cast<unsigned>(first_page_id));
+}
+
+IOHandle DiskManager::ReadPageAsync(page_id_t page_id, char* page_data) const {
+  return ReadPagesAsync({page_id}, {page_data}).front();
+}
+
+std::vector<IOHandle> DiskManager::ReadPagesAsync(
+    const std::vector<page_id_t>& page_ids,
+    const std::vector<char*>& buffers) const {
+  if (!is_open_ || db_file_descriptor_ < 0) {
+    LOG_ERROR_STREAM("DiskManager: Cannot read pages, file not open");
+    throw std::runtime_error("Database file not open");
+  }
+
+  if (page_ids.size() != buffers.size()) {
+    throw std::invalid_argument("page_ids and buffers must have equal sizes");
+  }
+
+  // One submission per device queue; handles go back in request order
+  std::vector<std::vector<IORequest>> requests(GetStripeCount());
+  std::vector<std::vector<size_t>> positions(GetStripeCount());
+  for (size_t i = 0; i < page_ids.size(); i++) {
+    if (buffers[i] == nullptr) {
+      LOG_ERROR_STREAM("DiskManager: Invalid page_data pointer (nullptr)");
+      throw std::invalid_argument("page_data cannot be nullptr");
+    }
+    const size_t file = PageFile(page_ids[i]);
+    requests[file].push_back(MakeReadRequest(page_ids[i], buffers[i]));
+    positions[file].push_back(i);
+  }
+
+  std::vector<IOHandle> handles(page_ids.size());
+  for (size_t file = 0; file < requests.size(); file++) {
+    if (requests[file].empty()) {
+      continue;
+    }
+    std::vector<IOHandle> submitted =
+        GetIOEngine(file)->Submit(std::move(requests[file]));
+    for (size_t i = 0; i < submitted.size(); i++) {
+      handles[positions[file][i]] = std::move(submitted[i]);
+    }
+  }
+  return handles;
+}
 
-  // Verify checksum using PageView (non-owning access to external buffer)
+IOHandle DiskManager::WritePageAsync(page_id_t page_id,
+                                     const char* page_data) const {
+  if (!is_open_ || db_file_descriptor_ < 0) {
+    LOG_ERROR_STREAM("DiskManager: Cannot write page, file not open");
+    throw std::runtime_error("Database file not open");
+  }
+  RequireWritable();
+
+  if (page_data == nullptr) {
+    LOG_ERROR_STREAM("DiskManager: Invalid page_data pointer (nullptr)");
+    throw std::invalid_argument("page_data cannot be nullptr");
+  }
+
+  PreparePageWrite(page_data);
+  // Only until the write is queued: see PageSnapshot on in-flight writes
+  std::shared_lock<std::shared_mutex> snapshot_lock(snapshot_mutex_);
+  NotePageChange(page_id);
+  BeginPageWrite(page_id);
+  if (extent_map_ != nullptr) {
+    return WriteExtentAsync(page_id, page_data);
+  }
+
+  const size_t file = PageFile(page_id);
+  IORequest request{IOOpType::WRITE, PageFileDescriptor(file, page_data),
+                    const_cast<char*>(page_data), PAGE_SIZE,
+                    PageOffset(page_id), nullptr};
+  request.on_complete = [this, page_id,
+                         start = Clock::now()](ssize_t res) -> ::ErrorCode {
+    if (res != static_cast<ssize_t>(PAGE_SIZE)) {
+      LOG_ERROR_STREAM("DiskManager: Failed to write page "
+                       << page_id << " asynchronously, result: " << res);
+      return {-1, "DiskManager::WritePageAsync: Failed to write page"};
+    }
+    page_writes_.Add();
+    write_latency_.Record(NanosSince(start));
+    FinishPageWrite(page_id);
+    has_unsynced_writes_.store(true);
+    return {0, "DiskManager::WritePageAsync: Success"};
+  };
+
+  std::vector<IORequest> requests;
+  requests.push_back(std::move(request));
+  return GetIOEngine(file)->Submit(std::move(requests)).front();
+}
+
+const char* DiskManager::GetIOEngineName() const {
+  return GetIOEngine()->GetName();
+}
+
+AsyncIOEngine* DiskManager::GetIOEngine(size_t file) const {
+  std::call_once(io_engine_once_, [this]() {
+    // One queue per device, so a slow device never holds up another's I/O
+    for (size_t i = 0; i < GetStripeCount(); i++) {
+      std::unique_ptr<AsyncIOEngine> engine =
+          AsyncIOEngine::Create(io_engine_type_);
+      if (engine == nullptr) {
+        // Explicit IO_URING request on a system without it
+        LOG_WARNING("DiskManager: Requested I/O engine unavailable, using "
+                    "thread pool");
+        engine = AsyncIOEngine::Create(IOEngineType::THREAD_POOL);
+      }
+      io_engines_.push_back(std::move(engine));
+    }
+    LOG_INFO_STREAM("DiskManager: Async I/O engine: "
+                    << io_engines_.front()->GetName() << " x "
+                    << io_engines_.size());
+  });
+  return io_engines_[file].get();
+}
+
+IORequest DiskManager::MakeReadRequest(page_id_t page_id,
+                                       char* page_data) const {
+  if (extent_map_ != nullptr) {
+    return MakeExtentReadRequest(page_id, page_data);
+  }
+  IORequest request{IOOpType::READ,
+                    PageFileDescriptor(PageFile(page_id), page_data),
+                    page_data, PAGE_SIZE, PageOffset(page_id), nullptr};
+  request.on_complete = [this, page_id, page_data,
+                         start = Clock::now()](ssize_t res) -> ::ErrorCode {
+    if (res != static_cast<ssize_t>(PAGE_SIZE)) {
+      LOG_ERROR_STREAM("DiskManager: Failed to read page "
+                       << page_id << " asynchronously, result: " << res);
+      return {-1, "DiskManager::ReadPageAsync: Failed to read page"};
+    }
+    page_reads_.Add();
+    read_latency_.Record(NanosSince(start));
+    try {
+      FinishPageRead(page_id, page_data);
+    } catch (const std::exception& e) {
+      return {-2, "DiskManager::ReadPageAsync: " + std::string(e.what())};
+    }
+    return {0, "DiskManager::ReadPageAsync: Success"};
+  };
+  return request;
+}
+
+off_t DiskManager::PageOffset(page_id_t page_id) const {
+  if (file_header_.flags & FILE_FLAG_ALIGNED_PAGES) {
+    // Page 0's slot holds the file header
+    if (page_id == INVALID_PAGE_ID) {
+      LOG_ERROR_STREAM("DiskManager: Page 0 is reserved for the file header");
+      throw std::invalid_argument("Page 0 is reserved for the file header");
+    }
+    if (tablespace_ != nullptr) {
+      return tablespace_->OffsetOf(page_id);
+    }
+    return static_cast<off_t>(page_id) * static_cast<off_t>(PAGE_SIZE);
+  }
+
+  // Legacy layout: skip file header, then page_id * PAGE_SIZE
+  return static_cast<off_t>(sizeof(FileHeader)) +
+         static_cast<off_t>(page_id) * static_cast<off_t>(PAGE_SIZE);
+}
+
+void DiskManager::FinishPageRead(page_id_t page_id, char* page_data) const {
+  // Every header field is persisted, so the page is usable as read
+  if (trust_written_pages_ && verified_pages_.Test(page_id)) {
+    checksum_skips_.Add();
+    return;
+  }
+
+  TRACE_SPAN("DiskManager::VerifyChecksum");
   PageView page_view(page_data);
   if (!page_view.VerifyChecksum()) {
+    checksum_failures_.Add();
     LOG_ERROR_STREAM("DiskManager: Checksum verification failed for page "
                      << page_id);
     throw std::runtime_error("Page checksum verification failed");
   }
+}
 
-  LOG_INFO_STREAM("DiskManager: Successfully read page " << page_id);
+void DiskManager::NotePageChange(page_id_t page_id) const {
+  changed_pages_->Set(page_id);
+  if (snapshot_ != nullptr) {
+    snapshot_->Preserve(page_id);
+  }
 }
 
-void DiskManager::WritePage(page_id_t page_id, const char* page_data) const {
+void DiskManager::ReadPageImages(page_id_t first_page_id, size_t count,
+                                 char* buffer) const {
   if (!is_open_ || db_file_descriptor_ < 0) {
-    LOG_ERROR_STREAM("DiskManager: Cannot write page, file not open");
+    LOG_ERROR_STREAM("DiskManager: Cannot read pages, file not open");
     throw std::runtime_error("Database file not open");
   }
 
-  if (page_data == nullptr) {
-    LOG_ERROR_STREAM("DiskManager: Invalid page_data pointer (nullptr)");
-    throw std::invalid_argument("page_data cannot be nullptr");
+  for (size_t done = 0; done < count;) {
+    const page_id_t page_id = first_page_id + static_cast<page_id_t>(done);
+    char* data = buffer + done * PAGE_SIZE;
+
+    // Extents are not contiguous: one read per page
+    if (extent_map_ != nullptr) {
+      if (extent_map_->Get(page_id).block_count == 0) {
+        std::memset(data, 0, PAGE_SIZE);
+      } else if (!ReadExtent(page_id, data)) {
+        LOG_ERROR_STREAM("DiskManager: Failed to read page "
+                         << page_id << " from its extent");
+        throw std::runtime_error("Failed to read page from disk");
+      }
+      done++;
+      continue;
+    }
+
+    size_t batch = count - done;
+    if (tablespace_ != nullptr) {
+      batch = std::min(batch, tablespace_->ContiguousPages(page_id));
+    }
+    const size_t length = batch * PAGE_SIZE;
+    const int fd = BufferedFileDescriptor(PageFile(page_id));
+    const off_t offset = PageOffset(page_id);
+    size_t bytes_read = 0;
+    while (bytes_read < length) {
+      const ssize_t result =
+          pread(fd, data + bytes_read, length - bytes_read,
+                offset + static_cast<off_t>(bytes_read));
+      if (result < 0 && errno == EINTR) {
+        continue;
+      }
+      if (result < 0) {
+        LOG_ERROR_STREAM("DiskManager: Failed to read pages "
+                         << page_id << "-" << page_id + batch - 1
+                         << ", errno: " << errno);
+        throw std::runtime_error("Failed to read pages from disk");
+      }
+      if (result == 0) {
+        break;  // end of file
+      }
+      bytes_read += static_cast<size_t>(result);
+    }
+    // Allocated pages past the end of the file were never written
+    std::memset(data + bytes_read, 0, length - bytes_read);
+    done += batch;
   }
+}
 
-  // The PageHeader contains runtime only fields that should not be persisted:
-  //   - deleted_tuple_count_ (bytes 16-17)
-  //   - fragmented_bytes_ (bytes 24-31)
-  //   - is_dirty_ (byte  32)
+void DiskManager::PreparePageWrite(const char* page_data) const {
   PageHeader* page_header =
       reinterpret_cast<PageHeader*>(const_cast<char*>(page_data));
-  page_header->deleted_tuple_count_ = 0;
-  page_header->fragmented_bytes_ = 0;
-  page_header->is_dirty_ = false;
+
+  // Pages loaded with the legacy CRC32 are upgraded when written back; the
+  // page_lsn flag marks the page as written in format version 4
+  page_header->flags |= PAGE_FLAG_CRC32C | PAGE_FLAG_PAGE_LSN;
 
   // Update checksum before writing
   // We need to cast away const to update the checksum in the buffer
@@ -226,23 +1124,213 @@ void DiskManager::WritePage(page_id_t page_id, const char* page_data) const {
   PageView page_view(mutable_page_data);
   uint32_t checksum = page_view.ComputeChecksum();
   page_view.SetChecksum(checksum);
+}
 
-  // Calculate offset: skip file header, then page_id * PAGE_SIZE
-  off_t offset = sizeof(FileHeader) + (page_id * PAGE_SIZE);
+void DiskManager::Sync() const {
+  std::lock_guard<std::mutex> lock(sync_mutex_);
 
-  // pwrite() is thread-safe  atomically writes at offset without modifying fd
-  // position
-  ssize_t bytes_written =
-      pwrite(db_file_descriptor_, page_data, PAGE_SIZE, offset);
-  if (bytes_written != PAGE_SIZE) {
+  // Clear before syncing: a write that lands during fdatasync sets the flag
+  // again and is picked up by the next Sync()
+  if (!has_unsynced_writes_.exchange(false)) {
+    return;
+  }
+
+  if (!is_open_ || db_file_descriptor_ < 0) {
+    LOG_ERROR_STREAM("DiskManager: Cannot sync, file not open");
+    throw std::runtime_error("Database file not open");
+  }
+
+  const Clock::time_point start = Clock::now();
+  try {
+    SyncDataLocked();
+  } catch (...) {
+    has_unsynced_writes_.store(true);
+    throw;
+  }
+  sync_latency_.Record(NanosSince(start));
+
+  sync_count_++;
+}
+
+void DiskManager::SyncDataLocked() const {
+  ExtentMap::Changes changes;
+  if (extent_map_ != nullptr) {
+    changes = extent_map_->TakeChanges();
+  }
+  const bool stripes_synced =
+      tablespace_ == nullptr || tablespace_->SyncStripeFiles();
+  if (fdatasync(db_file_descriptor_) != 0 || !stripes_synced) {
+    LOG_ERROR_STREAM("DiskManager: fdatasync failed, errno: " << errno);
+    if (extent_map_ != nullptr) {
+      // Their data is not known to be durable
+      extent_map_->Restore(std::move(changes));
+    }
+    throw std::runtime_error("Failed to sync database file");
+  }
+  if (extent_map_ != nullptr) {
+    extent_map_->Persist(std::move(changes));
+  }
+}
+
+size_t DiskManager::GetStoredPageBytes() const {
+  return extent_map_ != nullptr
+             ? extent_map_->GetUsedBlockCount() * PAGE_EXTENT_BLOCK_SIZE
+             : 0;
+}
+
+bool DiskManager::ReadExtent(page_id_t page_id, char* page_data) const {
+  const PageExtent extent = extent_map_->Get(page_id);
+  if (extent.block_count == 0) {
+    return false;  // never written
+  }
+  const ssize_t length = static_cast<ssize_t>(ExtentBytes(extent));
+  if (extent.block_count == PAGE_EXTENT_MAX_BLOCKS) {
+    return pread(db_file_descriptor_, page_data, length,
+                 ExtentOffset(extent)) == length;
+  }
+  char* staging = ExtentBuffer();
+  if (pread(db_file_descriptor_, staging, length, ExtentOffset(extent)) !=
+      length) {
+    return false;
+  }
+  if (!DecodePage(staging, static_cast<size_t>(length), page_data)) {
+    checksum_failures_.Add();
+    LOG_ERROR_STREAM("DiskManager: Cannot decompress page " << page_id);
+    return false;
+  }
+  return true;
+}
+
+void DiskManager::WriteExtent(page_id_t page_id, const char* page_data) const {
+  char* staging = ExtentBuffer();
+  const uint16_t blocks = EncodePage(page_data, staging);
+  const char* data = blocks < PAGE_EXTENT_MAX_BLOCKS ? staging : page_data;
+
+  const PageExtent extent = extent_map_->Reserve(page_id, blocks);
+  const ssize_t length = static_cast<ssize_t>(ExtentBytes(extent));
+  if (pwrite(db_file_descriptor_, data, length, ExtentOffset(extent)) !=
+      length) {
+    extent_map_->Cancel(page_id, extent);
     LOG_ERROR_STREAM("DiskManager: Failed to write page "
-                     << page_id << ", bytes_written: " << bytes_written);
+                     << page_id << " to blocks " << extent.first_block << "+"
+                     << extent.block_count << ", errno: " << errno);
     throw std::runtime_error("Failed to write page to disk");
   }
+  // Only now may a Sync() record the move
+  extent_map_->Publish(page_id, extent);
+}
+
+IORequest DiskManager::MakeExtentReadRequest(page_id_t page_id,
+                                             char* page_data) const {
+  const PageExtent extent = extent_map_->Get(page_id);
+  std::shared_ptr<std::vector<char>> staging;
+  if (extent.block_count != 0 && extent.block_count < PAGE_EXTENT_MAX_BLOCKS) {
+    staging = std::make_shared<std::vector<char>>(ExtentBytes(extent));
+  }
 
-  fsync(db_file_descriptor_);
+  IORequest request{IOOpType::READ, db_file_descriptor_,
+                    staging != nullptr ? staging->data() : page_data,
+                    ExtentBytes(extent), ExtentOffset(extent), nullptr};
+  request.on_complete = [this, page_id, page_data, extent, staging,
+                         start = Clock::now()](ssize_t res) -> ::ErrorCode {
+    if (extent.block_count == 0 ||
+        res != static_cast<ssize_t>(ExtentBytes(extent))) {
+      LOG_ERROR_STREAM("DiskManager: Failed to read page "
+                       << page_id << " asynchronously, result: " << res);
+      return {-1, "DiskManager::ReadPageAsync: Failed to read page"};
+    }
+    if (staging != nullptr &&
+        !DecodePage(staging->data(), staging->size(), page_data)) {
+      checksum_failures_.Add();
+      LOG_ERROR_STREAM("DiskManager: Cannot decompress page " << page_id);
+      return {-2, "DiskManager::ReadPageAsync: Cannot decompress page"};
+    }
+    page_reads_.Add();
+    read_latency_.Record(NanosSince(start));
+    try {
+      FinishPageRead(page_id, page_data);
+    } catch (const std::exception& e) {
+      return {-2, "DiskManager::ReadPageAsync: " + std::string(e.what())};
+    }
+    return {0, "DiskManager::ReadPageAsync: Success"};
+  };
+  return request;
+}
+
+IOHandle DiskManager::WriteExtentAsync(page_id_t page_id,
+                                       const char* page_data) const {
+  auto staging = std::make_shared<std::vector<char>>(PAGE_SIZE);
+  const uint16_t blocks = EncodePage(page_data, staging->data());
+  if (blocks == PAGE_EXTENT_MAX_BLOCKS) {
+    std::memcpy(staging->data(), page_data, PAGE_SIZE);
+  }
+  const PageExtent extent = extent_map_->Reserve(page_id, blocks);
+
+  IORequest request{IOOpType::WRITE, db_file_descriptor_, staging->data(),
+                    ExtentBytes(extent), ExtentOffset(extent), nullptr};
+  request.on_complete = [this, page_id, extent, staging,
+                         start = Clock::now()](ssize_t res) -> ::ErrorCode {
+    if (res != static_cast<ssize_t>(ExtentBytes(extent))) {
+      extent_map_->Cancel(page_id, extent);
+      LOG_ERROR_STREAM("DiskManager: Failed to write page "
+                       << page_id << " asynchronously, result: " << res);
+      return {-1, "DiskManager::WritePageAsync: Failed to write page"};
+    }
+    extent_map_->Publish(page_id, extent);
+    page_writes_.Add();
+    write_latency_.Record(NanosSince(start));
+    FinishPageWrite(page_id);
+    has_unsynced_writes_.store(true);
+    return {0, "DiskManager::WritePageAsync: Success"};
+  };
+
+  std::vector<IORequest> requests;
+  requests.push_back(std::move(request));
+  return GetIOEngine()->Submit(std::move(requests)).front();
+}
 
-  LOG_INFO_STREAM("DiskManager: Successfully wrote page " << page_id);
+DiskMetrics DiskManager::GetMetrics() const {
+  DiskMetrics metrics;
+  metrics.page_reads = page_reads_.Get();
+  metrics.page_writes = page_writes_.Get();
+  metrics.syncs = sync_count_.load();
+  metrics.checksum_failures = checksum_failures_.Get();
+  metrics.checksum_skips = checksum_skips_.Get();
+  metrics.snapshot_preserved_pages = snapshot_preserved_pages_.Get();
+  metrics.read_latency = read_latency_.Snapshot();
+  metrics.write_latency = write_latency_.Snapshot();
+  metrics.sync_latency = sync_latency_.Snapshot();
+  return metrics;
+}
+
+void DiskManager::SyncThreadLoop() {
+  std::unique_lock<std::mutex> lock(sync_thread_mutex_);
+  while (!stop_sync_thread_) {
+    sync_thread_cv_.wait_for(lock,
+                             std::chrono::milliseconds(sync_interval_ms_));
+    if (stop_sync_thread_) {
+      break;
+    }
+
+    try {
+      Sync();
+    } catch (const std::exception& e) {
+      LOG_ERROR_STREAM("DiskManager: Periodic sync failed: " << e.what());
+    }
+  }
+}
+
+void DiskManager::StopSyncThread() {
+  if (!sync_thread_.joinable()) {
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(sync_thread_mutex_);
+    stop_sync_thread_ = true;
+  }
+  sync_thread_cv_.notify_all();
+  sync_thread_.join();
 }
 
 page_id_t DiskManager::AllocatePage() {
@@ -252,6 +1340,36 @@ page_id_t DiskManager::AllocatePage() {
     LOG_ERROR_STREAM("DiskManager: Cannot allocate page, file not open");
     throw std::runtime_error("Database file not open");
   }
+  RequireWritable();
+
+  const page_id_t head = file_header_.free_list_head;
+  if (head != INVALID_PAGE_ID) {
+    bool is_free = false;
+    const page_id_t next_free = ReadFreeLink(head, &is_free);
+    if (is_free) {
+      // The header must stop listing the page before anyone can use it
+      const uint32_t free_page_count = file_header_.free_page_count;
+      file_header_.free_list_head = next_free;
+      file_header_.free_page_count =
+          free_page_count > 0 ? free_page_count - 1 : 0;
+      try {
+        WriteFileHeaderLocked();
+      } catch (...) {
+        file_header_.free_list_head = head;
+        file_header_.free_page_count = free_page_count;
+        throw;
+      }
+      file_header_.page_count_++;
+      LOG_INFO_STREAM("DiskManager: Reused free page " << head);
+      return head;
+    }
+
+    // Leaking the list is safe; following a damaged one is not
+    LOG_ERROR_STREAM("DiskManager: Free list head "
+                     << head << " is not a free page, dropping the list");
+    file_header_.free_list_head = INVALID_PAGE_ID;
+    file_header_.free_page_count = 0;
+  }
 
   page_id_t new_page_id = next_page_id_++;
   file_header_.page_count_++;
@@ -261,6 +1379,197 @@ page_id_t DiskManager::AllocatePage() {
   return new_page_id;
 }
 
+page_id_t DiskManager::AllocatePages(size_t count) {
+  std::lock_guard<std::mutex> lock(metadata_mutex_);
+
+  if (!is_open_) {
+    LOG_ERROR_STREAM("DiskManager: Cannot allocate pages, file not open");
+    throw std::runtime_error("Database file not open");
+  }
+  RequireWritable();
+
+  if (count == 0) {
+    throw std::invalid_argument("Page count must be positive");
+  }
+
+  const page_id_t first_page_id = next_page_id_;
+  next_page_id_ += static_cast<page_id_t>(count);
+  file_header_.page_count_ += static_cast<uint32_t>(count);
+
+  LOG_INFO_STREAM("DiskManager: Allocated pages " << first_page_id << "-"
+                                                  << next_page_id_ - 1);
+
+  return first_page_id;
+}
+
+page_id_t DiskManager::GetNextPageId() {
+  std::lock_guard<std::mutex> lock(metadata_mutex_);
+  return next_page_id_;
+}
+
+void DiskManager::SyncFileHeader() {
+  std::lock_guard<std::mutex> lock(metadata_mutex_);
+
+  if (!is_open_ || db_file_descriptor_ < 0) {
+    LOG_ERROR_STREAM("DiskManager: Cannot sync header, file not open");
+    throw std::runtime_error("Database file not open");
+  }
+  RequireWritable();
+
+  WriteFileHeaderLocked();
+}
+
+void DiskManager::WriteFileHeaderLocked() {
+  file_header_.next_page_id = next_page_id_;
+  if (pwrite(db_file_descriptor_, &file_header_, sizeof(FileHeader), 0) !=
+          static_cast<ssize_t>(sizeof(FileHeader)) ||
+      fdatasync(db_file_descriptor_) != 0) {
+    LOG_ERROR_STREAM("DiskManager: Failed to sync file header, errno: "
+                     << errno);
+    throw std::runtime_error("Failed to sync database file header");
+  }
+}
+
+size_t DiskManager::GetSchemaCapacity() const {
+  return (file_header_.flags & FILE_FLAG_ALIGNED_PAGES)
+             ? PAGE_SIZE - sizeof(FileHeader)
+             : 0;
+}
+
+std::string DiskManager::ReadSchemaData() {
+  std::lock_guard<std::mutex> lock(metadata_mutex_);
+  return ReadSchemaDataLocked();
+}
+
+std::string DiskManager::ReadSchemaDataLocked() const {
+  if (!is_open_ || db_file_descriptor_ < 0) {
+    LOG_ERROR_STREAM("DiskManager: Cannot read schema data, file not open");
+    throw std::runtime_error("Database file not open");
+  }
+
+  std::string data(file_header_.schema_length_, '\0');
+  if (data.empty()) {
+    return data;
+  }
+  if (file_header_.schema_length_ > GetSchemaCapacity()) {
+    LOG_ERROR_STREAM("DiskManager: Schema area of "
+                     << file_header_.schema_length_ << " bytes is corrupt");
+    throw std::runtime_error("Corrupt schema area in file header");
+  }
+  if (read_only_) {
+    std::memcpy(data.data(), mapping_ + file_header_.schema_offset_,
+                data.size());
+    return data;
+  }
+  if (pread(db_file_descriptor_, data.data(), data.size(),
+            file_header_.schema_offset_) !=
+      static_cast<ssize_t>(data.size())) {
+    LOG_ERROR_STREAM("DiskManager: Failed to read schema data, errno: "
+                     << errno);
+    throw std::runtime_error("Failed to read schema data");
+  }
+  return data;
+}
+
+void DiskManager::WriteSchemaData(std::string_view data) {
+  if (data.size() > GetSchemaCapacity()) {
+    LOG_ERROR_STREAM("DiskManager: " << data.size()
+                                     << " bytes of schema data exceed the "
+                                     << GetSchemaCapacity()
+                                     << "-byte schema area");
+    throw std::invalid_argument("Schema data exceeds the schema area");
+  }
+
+  std::lock_guard<std::mutex> lock(metadata_mutex_);
+  const std::string previous = ReadSchemaDataLocked();
+  RequireWritable();
+
+  // Only the bytes after the common prefix change; they are durable before
+  // the header covers them
+  size_t keep = 0;
+  while (keep < previous.size() && keep < data.size() &&
+         previous[keep] == data[keep]) {
+    keep++;
+  }
+  const off_t offset = static_cast<off_t>(sizeof(FileHeader) + keep);
+  const size_t length = data.size() - keep;
+  if (length > 0 &&
+      (pwrite(db_file_descriptor_, data.data() + keep, length, offset) !=
+           static_cast<ssize_t>(length) ||
+       fdatasync(db_file_descriptor_) != 0)) {
+    LOG_ERROR_STREAM("DiskManager: Failed to write schema data, errno: "
+                     << errno);
+    throw std::runtime_error("Failed to write schema data");
+  }
+
+  file_header_.schema_offset_ = static_cast<uint32_t>(sizeof(FileHeader));
+  file_header_.schema_length_ = static_cast<uint32_t>(data.size());
+  WriteFileHeaderLocked();
+}
+
+std::unique_ptr<PageSnapshot> DiskManager::StartSnapshot() {
+  std::lock_guard<std::mutex> lock(metadata_mutex_);
+  const std::string schema_data = ReadSchemaDataLocked();
+  RequireWritable();
+
+  // Waits for synchronous writes in progress; later ones see the snapshot
+  std::unique_lock<std::shared_mutex> snapshot_lock(snapshot_mutex_);
+  if (snapshot_ != nullptr) {
+    LOG_ERROR_STREAM("DiskManager: A snapshot of " << db_file_name_
+                                                    << " is already active");
+    throw std::runtime_error("A snapshot is already active");
+  }
+
+  // The epoch is durable before any backup can carry it. Files created
+  // before file ids get theirs now.
+  const uint64_t file_id = file_header_.file_id;
+  const uint64_t epoch = file_header_.snapshot_epoch + 1;
+  if (file_id == 0) {
+    file_header_.file_id = NewFileId();
+  }
+  file_header_.snapshot_epoch = epoch;
+  try {
+    WriteFileHeaderLocked();
+  } catch (...) {
+    file_header_.file_id = file_id;
+    file_header_.snapshot_epoch = epoch - 1;
+    throw;
+  }
+
+  // The image is a plain file: aligned, unstriped, uncompressed
+  FileHeader header = file_header_;
+  header.next_page_id = next_page_id_;
+  header.flags = FILE_FLAG_ALIGNED_PAGES;
+  header.stripe_count = 0;
+  header.stripe_extent_pages = 0;
+  header.schema_offset_ = static_cast<uint32_t>(sizeof(FileHeader));
+  header.schema_length_ = static_cast<uint32_t>(schema_data.size());
+  std::vector<char> header_slot(PAGE_SIZE, '\0');
+  std::memcpy(header_slot.data(), &header, sizeof(FileHeader));
+  std::memcpy(header_slot.data() + sizeof(FileHeader), schema_data.data(),
+              schema_data.size());
+
+  std::unique_ptr<PageSnapshot> snapshot(
+      new PageSnapshot(this, file_header_.file_id, epoch, tracked_epoch_,
+                       next_page_id_, std::move(header_slot)));
+
+  // Changes from here on count towards the next snapshot. The first one
+  // since the file was opened has nothing to be incremental to.
+  std::unique_ptr<PageBitmap> changed_pages = std::move(changed_pages_);
+  changed_pages_ = std::make_unique<PageBitmap>();
+  if (tracked_epoch_ > 0) {
+    snapshot->changed_pages_ = std::move(changed_pages);
+  }
+  tracked_epoch_ = epoch;
+  snapshot_ = snapshot.get();
+
+  LOG_INFO_STREAM("DiskManager: Started snapshot " << epoch
+                                                   << " of " << db_file_name_
+                                                   << " at " << next_page_id_
+                                                   << " pages");
+  return snapshot;
+}
+
 void DiskManager::DeallocatePage(page_id_t page_id) {
   std::lock_guard<std::mutex> lock(metadata_mutex_);
 
@@ -268,14 +1577,180 @@ void DiskManager::DeallocatePage(page_id_t page_id) {
     LOG_ERROR_STREAM("DiskManager: Cannot deallocate page, file not open");
     throw std::runtime_error("Database file not open");
   }
+  RequireWritable();
 
-  // This is a no-op. In a real implementation, we would:
-  // - Add page_id to a free page list
-  // - Update file header to track free pages
-  // - Reuse deallocated pages in AllocatePage()
+  if (page_id == INVALID_PAGE_ID || page_id >= next_page_id_) {
+    LOG_ERROR_STREAM("DiskManager: Cannot deallocate unallocated page "
+                     << page_id);
+    throw std::invalid_argument("Page was never allocated");
+  }
+
+  bool is_free = false;
+  ReadFreeLink(page_id, &is_free);
+  if (is_free) {
+    LOG_WARNING_STREAM("DiskManager: Page " << page_id << " is already free");
+    return;
+  }
+
+  // The link is durable before the header points at it, so a crash in
+  // between only leaks the page
+  const page_id_t head = file_header_.free_list_head;
+  const uint32_t free_page_count = file_header_.free_page_count;
+  WriteFreePage(page_id, head);
+  Sync();
+
+  file_header_.free_list_head = page_id;
+  file_header_.free_page_count = free_page_count + 1;
+  try {
+    WriteFileHeaderLocked();
+  } catch (...) {
+    file_header_.free_list_head = head;
+    file_header_.free_page_count = free_page_count;
+    throw;
+  }
+  if (file_header_.page_count_ > 0) {
+    file_header_.page_count_--;
+  }
+
+  LOG_INFO_STREAM("DiskManager: Deallocated page " << page_id);
+}
+
+uint32_t DiskManager::GetFreePageCount() {
+  std::lock_guard<std::mutex> lock(metadata_mutex_);
+  return file_header_.free_page_count;
+}
+
+size_t DiskManager::TruncateFreeTail() {
+  std::lock_guard<std::mutex> lock(metadata_mutex_);
+
+  if (!is_open_ || db_file_descriptor_ < 0) {
+    LOG_ERROR_STREAM("DiskManager: Cannot truncate, file not open");
+    throw std::runtime_error("Database file not open");
+  }
+  RequireWritable();
+
+  // Walk the list: (page, current link). The length bound guards against a
+  // damaged list with a cycle.
+  std::vector<std::pair<page_id_t, page_id_t>> free_pages;
+  for (page_id_t page_id = file_header_.free_list_head;
+       page_id != INVALID_PAGE_ID && free_pages.size() < next_page_id_;) {
+    bool is_free = false;
+    const page_id_t next_free = ReadFreeLink(page_id, &is_free);
+    if (!is_free) {
+      LOG_WARNING_STREAM("DiskManager: Free list ends at non-free page "
+                         << page_id);
+      break;
+    }
+    free_pages.emplace_back(page_id, next_free);
+    page_id = next_free;
+  }
+  std::sort(free_pages.begin(), free_pages.end());
+  free_pages.erase(std::unique(free_pages.begin(), free_pages.end(),
+                               [](const auto& a, const auto& b) {
+                                 return a.first == b.first;
+                               }),
+                   free_pages.end());
+
+  page_id_t new_next_page_id = next_page_id_;
+  while (!free_pages.empty() &&
+         free_pages.back().first == new_next_page_id - 1) {
+    free_pages.pop_back();
+    new_next_page_id--;
+  }
+  const size_t released = next_page_id_ - new_next_page_id;
+  if (released == 0) {
+    return 0;
+  }
+
+  // Relink what is left in ascending order, rewriting only changed links.
+  // Until the header moves, the old head still leads to free pages only.
+  for (size_t i = 0; i < free_pages.size(); i++) {
+    const page_id_t next_free =
+        i + 1 < free_pages.size() ? free_pages[i + 1].first : INVALID_PAGE_ID;
+    if (free_pages[i].second != next_free) {
+      WriteFreePage(free_pages[i].first, next_free);
+    }
+  }
+  Sync();
+
+  // A snapshot keeps the dropped pages' images before they vanish
+  std::shared_lock<std::shared_mutex> snapshot_lock(snapshot_mutex_);
+  for (page_id_t page_id = new_next_page_id; page_id < next_page_id_;
+       page_id++) {
+    NotePageChange(page_id);
+  }
+
+  const page_id_t old_head = file_header_.free_list_head;
+  const uint32_t old_free_page_count = file_header_.free_page_count;
+  const page_id_t old_next_page_id = next_page_id_;
+  file_header_.free_list_head =
+      free_pages.empty() ? INVALID_PAGE_ID : free_pages.front().first;
+  file_header_.free_page_count = static_cast<uint32_t>(free_pages.size());
+  next_page_id_ = new_next_page_id;
+  try {
+    WriteFileHeaderLocked();
+  } catch (...) {
+    file_header_.free_list_head = old_head;
+    file_header_.free_page_count = old_free_page_count;
+    next_page_id_ = old_next_page_id;
+    throw;
+  }
+
+  // Pages past next_page_id are dead now; a failed truncate only wastes
+  // space until they are allocated again. Their extents are trimmed once
+  // the map no longer lists them.
+  if (extent_map_ != nullptr) {
+    extent_map_->Release(new_next_page_id);
+    has_unsynced_writes_.store(true);
+    Sync();
+  } else if (tablespace_ != nullptr) {
+    tablespace_->Truncate(new_next_page_id);
+  } else if (ftruncate(db_file_descriptor_, PageOffset(new_next_page_id)) !=
+             0) {
+    LOG_WARNING_STREAM("DiskManager: Failed to truncate file, errno: "
+                       << errno);
+  }
+
+  LOG_INFO_STREAM("DiskManager: Released " << released
+                                           << " free pages at end of file");
+  return released;
+}
+
+void DiskManager::WriteFreePage(page_id_t page_id, page_id_t next_free) {
+  std::vector<char> buffer(PAGE_SIZE);
+  PageView page(buffer.data());
+  page.Initialize();
+  page.SetPageId(page_id);
+  page.SetPageType(PAGE_TYPE_FREE);
+  // The link sits in the free space, so the page reads as empty
+  memcpy(buffer.data() + sizeof(PageHeader), &next_free, sizeof(next_free));
+  WritePage(page_id, buffer.data(), /*defer_sync=*/true);
+}
+
+page_id_t DiskManager::ReadFreeLink(page_id_t page_id, bool* is_free) const {
+  *is_free = false;
+
+  std::vector<char> buffer(PAGE_SIZE);
+  const bool read =
+      extent_map_ != nullptr
+          ? ReadExtent(page_id, buffer.data())
+          : pread(BufferedFileDescriptor(PageFile(page_id)), buffer.data(),
+                  PAGE_SIZE,
+                  PageOffset(page_id)) == static_cast<ssize_t>(PAGE_SIZE);
+  if (!read) {
+    return INVALID_PAGE_ID;  // never written
+  }
+
+  // Type first: a live or never-written page needs no checksum work
+  PageView page(buffer.data());
+  if (page.GetPageType() != PAGE_TYPE_FREE || !page.VerifyChecksum()) {
+    return INVALID_PAGE_ID;
+  }
 
-  LOG_INFO_STREAM("DiskManager: Deallocated page " << page_id
-                                                   << " (no-op for now)");
+  *is_free = true;
+  page_id_t next_free;
+  memcpy(&next_free, buffer.data() + sizeof(PageHeader), sizeof(next_free));
+  return next_free;
 }
 
 bool DiskManager::IsOpen() {
@@ -0,0 +1,279 @@
+#include "../../include/storage/extent_map.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include "../../include/common/logger.h"
+
+namespace {
+
+// Blocks of the slot that holds the DiskManager file header
+constexpr size_t FIRST_DATA_BLOCK = PAGE_EXTENT_MAX_BLOCKS;
+
+off_t EntryOffset(page_id_t page_id) {
+  return static_cast<off_t>(page_id) * static_cast<off_t>(sizeof(PageExtent));
+}
+
+PageExtent HeaderEntry() {
+  PageExtent header{};
+  header.first_block = EXTENT_MAP_MAGIC;
+  header.block_count = EXTENT_MAP_VERSION;
+  return header;
+}
+
+}  // namespace
+
+ExtentMap::ExtentMap(const std::string& map_file_name, int data_fd,
+                     bool create)
+    : map_file_name_(map_file_name),
+      map_file_(map_file_name, O_RDWR | O_CREAT | (create ? O_TRUNC : 0)),
+      data_fd_(data_fd),
+      used_(FIRST_DATA_BLOCK, true),
+      used_blocks_(0),
+      search_from_(FIRST_DATA_BLOCK),
+      file_blocks_(FIRST_DATA_BLOCK) {
+  if (create) {
+    const PageExtent header = HeaderEntry();
+    if (pwrite(map_file_.get(), &header, sizeof(header), 0) !=
+            static_cast<ssize_t>(sizeof(header)) ||
+        fdatasync(map_file_.get()) != 0) {
+      LOG_ERROR_STREAM("ExtentMap: Failed to create " << map_file_name_);
+      throw std::runtime_error("Failed to create extent map: " +
+                               map_file_name_);
+    }
+    extents_.resize(1);
+    LOG_INFO_STREAM("ExtentMap: Created " << map_file_name_);
+    return;
+  }
+  Load();
+}
+
+void ExtentMap::Load() {
+  struct stat map_stat {};
+  struct stat data_stat {};
+  if (fstat(map_file_.get(), &map_stat) != 0 ||
+      fstat(data_fd_, &data_stat) != 0) {
+    throw std::runtime_error("Failed to stat extent map: " + map_file_name_);
+  }
+
+  const size_t entries =
+      static_cast<size_t>(map_stat.st_size) / sizeof(PageExtent);
+  extents_.resize(std::max<size_t>(entries, 1));
+  const ssize_t expected =
+      static_cast<ssize_t>(entries * sizeof(PageExtent));
+  if (entries == 0 ||
+      pread(map_file_.get(), extents_.data(), expected, 0) != expected) {
+    LOG_ERROR_STREAM("ExtentMap: Failed to read " << map_file_name_);
+    throw std::runtime_error("Failed to read extent map: " + map_file_name_);
+  }
+  if (extents_[0] != HeaderEntry()) {
+    LOG_ERROR_STREAM("ExtentMap: Bad header in " << map_file_name_);
+    throw std::runtime_error("Invalid extent map: " + map_file_name_);
+  }
+  extents_[0] = PageExtent{};
+
+  file_blocks_ = std::max<size_t>(
+      FIRST_DATA_BLOCK,
+      (static_cast<size_t>(data_stat.st_size) + PAGE_EXTENT_BLOCK_SIZE - 1) /
+          PAGE_EXTENT_BLOCK_SIZE);
+  used_.assign(file_blocks_, false);
+  std::fill(used_.begin(), used_.begin() + FIRST_DATA_BLOCK, true);
+
+  for (page_id_t page_id = 1; page_id < extents_.size(); page_id++) {
+    const PageExtent extent = extents_[page_id];
+    if (extent.block_count == 0) {
+      continue;
+    }
+    const size_t end = size_t{extent.first_block} + extent.block_count;
+    bool valid = extent.block_count <= PAGE_EXTENT_MAX_BLOCKS &&
+                 extent.first_block >= FIRST_DATA_BLOCK && end <= file_blocks_;
+    for (size_t block = extent.first_block; valid && block < end; block++) {
+      valid = !used_[block];
+    }
+    if (!valid) {
+      LOG_ERROR_STREAM("ExtentMap: Page " << page_id << " has a bad extent ("
+                                          << extent.first_block << ", "
+                                          << extent.block_count << ") in "
+                                          << map_file_name_);
+      throw std::runtime_error("Damaged extent map: " + map_file_name_);
+    }
+    MarkLocked(extent, true);
+  }
+
+  LOG_INFO_STREAM("ExtentMap: Loaded " << extents_.size() - 1
+                                       << " entries, " << used_blocks_
+                                       << " blocks in use");
+}
+
+PageExtent ExtentMap::Get(page_id_t page_id) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return page_id < extents_.size() ? extents_[page_id] : PageExtent{};
+}
+
+PageExtent ExtentMap::Reserve(page_id_t page_id, uint16_t block_count) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (page_id < extents_.size() &&
+      extents_[page_id].block_count == block_count) {
+    return extents_[page_id];
+  }
+  return AllocateLocked(block_count);
+}
+
+void ExtentMap::Publish(page_id_t page_id, PageExtent extent) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (page_id >= extents_.size()) {
+    extents_.resize(page_id + 1);
+  }
+  const PageExtent old = extents_[page_id];
+  if (old == extent) {
+    return;
+  }
+  extents_[page_id] = extent;
+  dirty_.push_back(page_id);
+  if (old.block_count != 0) {
+    pending_free_.push_back(old);
+  }
+}
+
+void ExtentMap::Cancel(page_id_t page_id, PageExtent extent) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (page_id >= extents_.size() || extents_[page_id] != extent) {
+    MarkLocked(extent, false);
+  }
+}
+
+void ExtentMap::Release(page_id_t first_page_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (size_t page_id = std::max<page_id_t>(first_page_id, 1);
+       page_id < extents_.size(); page_id++) {
+    if (extents_[page_id].block_count != 0) {
+      pending_free_.push_back(extents_[page_id]);
+      extents_[page_id] = PageExtent{};
+      dirty_.push_back(static_cast<page_id_t>(page_id));
+    }
+  }
+}
+
+ExtentMap::Changes ExtentMap::TakeChanges() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Changes changes;
+  std::sort(dirty_.begin(), dirty_.end());
+  dirty_.erase(std::unique(dirty_.begin(), dirty_.end()), dirty_.end());
+  changes.entries.reserve(dirty_.size());
+  for (page_id_t page_id : dirty_) {
+    changes.entries.emplace_back(page_id, extents_[page_id]);
+  }
+  dirty_.clear();
+  changes.freed.swap(pending_free_);
+  return changes;
+}
+
+void ExtentMap::Restore(Changes changes) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  RestoreLocked(changes);
+}
+
+void ExtentMap::RestoreLocked(const Changes& changes) {
+  for (const auto& entry : changes.entries) {
+    dirty_.push_back(entry.first);
+  }
+  pending_free_.insert(pending_free_.end(), changes.freed.begin(),
+                       changes.freed.end());
+}
+
+void ExtentMap::Persist(Changes changes) {
+  bool written = true;
+  for (const auto& [page_id, extent] : changes.entries) {
+    if (pwrite(map_file_.get(), &extent, sizeof(extent),
+               EntryOffset(page_id)) != static_cast<ssize_t>(sizeof(extent))) {
+      written = false;
+      break;
+    }
+  }
+  if (written && !changes.entries.empty()) {
+    written = fdatasync(map_file_.get()) == 0;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!written) {
+    RestoreLocked(changes);
+    LOG_ERROR_STREAM("ExtentMap: Failed to write " << map_file_name_
+                                                   << ", errno: " << errno);
+    throw std::runtime_error("Failed to write extent map: " + map_file_name_);
+  }
+
+  for (const PageExtent& extent : changes.freed) {
+    MarkLocked(extent, false);
+  }
+
+  // Reserved blocks are marked used, so nothing being written is cut off
+  size_t end = file_blocks_;
+  while (end > FIRST_DATA_BLOCK && !used_[end - 1]) {
+    end--;
+  }
+  if (end < file_blocks_) {
+    if (ftruncate(data_fd_, static_cast<off_t>(end * PAGE_EXTENT_BLOCK_SIZE)) ==
+        0) {
+      file_blocks_ = end;
+      used_.resize(end);
+      search_from_ = std::min(search_from_, end);
+    } else {
+      LOG_WARNING_STREAM("ExtentMap: Failed to trim data file, errno: "
+                         << errno);
+    }
+  }
+}
+
+size_t ExtentMap::GetUsedBlockCount() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return used_blocks_;
+}
+
+PageExtent ExtentMap::AllocateLocked(uint16_t block_count) {
+  const size_t free_blocks = file_blocks_ - FIRST_DATA_BLOCK - used_blocks_;
+  if (free_blocks >= block_count) {
+    // Next fit: resume after the last allocation, wrapping once
+    for (size_t pass = 0; pass < 2; pass++) {
+      const size_t begin = pass == 0 ? search_from_ : FIRST_DATA_BLOCK;
+      const size_t limit = pass == 0 ? file_blocks_ : search_from_;
+      size_t run = 0;
+      for (size_t block = begin; block < limit; block++) {
+        run = used_[block] ? 0 : run + 1;
+        if (run == block_count) {
+          const PageExtent extent{
+              static_cast<uint32_t>(block + 1 - block_count), block_count, 0};
+          MarkLocked(extent, true);
+          search_from_ = block + 1;
+          return extent;
+        }
+      }
+    }
+  }
+
+  const PageExtent extent{static_cast<uint32_t>(file_blocks_), block_count,
+                          0};
+  file_blocks_ += block_count;
+  used_.resize(file_blocks_, false);
+  MarkLocked(extent, true);
+  search_from_ = file_blocks_;
+  return extent;
+}
+
+void ExtentMap::MarkLocked(PageExtent extent, bool used) {
+  for (size_t block = extent.first_block;
+       block < size_t{extent.first_block} + extent.block_count; block++) {
+    if (block < used_.size() && used_[block] != used) {
+      used_[block] = used;
+      if (used) {
+        used_blocks_++;
+      } else {
+        used_blocks_--;
+      }
+    }
+  }
+}
@@ -4,16 +4,122 @@
 #include <unistd.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <iostream>
 
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define STORAGEENGINE_FSM_SEARCH_X86 1
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define STORAGEENGINE_FSM_SEARCH_NEON 1
+#endif
+
+namespace {
+
+// Index of the first byte >= threshold in data[0, length), or length if none.
+// Unsigned >= is computed as max(v, threshold) == v.
+size_t FindFirstAtLeastScalar(const uint8_t* data, size_t length,
+                              uint8_t threshold) {
+  for (size_t i = 0; i < length; i++) {
+    if (data[i] >= threshold) {
+      return i;
+    }
+  }
+  return length;
+}
+
+#if defined(STORAGEENGINE_FSM_SEARCH_X86)
+// SSE2 is part of the x86-64 baseline
+size_t FindFirstAtLeastSse2(const uint8_t* data, size_t length,
+                            uint8_t threshold) {
+  const __m128i limit = _mm_set1_epi8(static_cast<char>(threshold));
+  size_t i = 0;
+  for (; i + 16 <= length; i += 16) {
+    const __m128i v =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+    const int mask =
+        _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(v, limit), v));
+    if (mask != 0) {
+      return i + __builtin_ctz(static_cast<unsigned>(mask));
+    }
+  }
+  return i + FindFirstAtLeastScalar(data + i, length - i, threshold);
+}
+
+__attribute__((target("avx2"))) size_t FindFirstAtLeastAvx2(
+    const uint8_t* data, size_t length, uint8_t threshold) {
+  const __m256i limit = _mm256_set1_epi8(static_cast<char>(threshold));
+  size_t i = 0;
+  for (; i + 32 <= length; i += 32) {
+    const __m256i v =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+    const uint32_t mask = static_cast<uint32_t>(
+        _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_max_epu8(v, limit), v)));
+    if (mask != 0) {
+      return i + __builtin_ctz(mask);
+    }
+  }
+  return i + FindFirstAtLeastSse2(data + i, length - i, threshold);
+}
+#endif
+
+#if defined(STORAGEENGINE_FSM_SEARCH_NEON)
+size_t FindFirstAtLeastNeon(const uint8_t* data, size_t length,
+                            uint8_t threshold) {
+  const uint8x16_t limit = vdupq_n_u8(threshold);
+  size_t i = 0;
+  for (; i + 16 <= length; i += 16) {
+    const uint8x16_t ge = vcgeq_u8(vld1q_u8(data + i), limit);
+    if (vmaxvq_u8(ge) != 0) {
+      return i + FindFirstAtLeastScalar(data + i, 16, threshold);
+    }
+  }
+  return i + FindFirstAtLeastScalar(data + i, length - i, threshold);
+}
+#endif
+
+using FindFirstAtLeastFn = size_t (*)(const uint8_t*, size_t, uint8_t);
+
+FindFirstAtLeastFn ResolveFindFirstAtLeast() {
+#if defined(STORAGEENGINE_FSM_SEARCH_X86)
+  if (__builtin_cpu_supports("avx2")) {
+    return FindFirstAtLeastAvx2;
+  }
+  return FindFirstAtLeastSse2;
+#elif defined(STORAGEENGINE_FSM_SEARCH_NEON)
+  return FindFirstAtLeastNeon;
+#else
+  return FindFirstAtLeastScalar;
+#endif
+}
+
+size_t FindFirstAtLeast(const uint8_t* data, size_t length,
+                        uint8_t threshold) {
+  static const FindFirstAtLeastFn impl = ResolveFindFirstAtLeast();
+  return impl(data, length, threshold);
+}
+
+// Dense per-process thread number, assigned on a thread's first insert so
+// consecutive threads land on different streams
+size_t CurrentThreadNumber() {
+  static std::atomic<size_t> next_thread_number{0};
+  thread_local const size_t thread_number =
+      next_thread_number.fetch_add(1, std::memory_order_relaxed);
+  return thread_number;
+}
+
+}  // namespace
+
 // Constructor
 FreeSpaceMap::FreeSpaceMap(const std::string& fsm_file_name)
     : fsm_file_name_(fsm_file_name),
       fsm_fd_(-1),
       page_count_(0),
       is_dirty_(false),
-      is_initialized_(false) {}
+      is_initialized_(false),
+      truncate_on_flush_(false) {}
 
 // Destructor
 FreeSpaceMap::~FreeSpaceMap() {
@@ -41,7 +147,9 @@ bool FreeSpaceMap::Initialize() {
     // If load fails, it might be a new file - initialize with empty FSM
     page_count_ = 0;
     fsm_cache_.clear();
-    allocated_pages_.clear();
+    dirty_fsm_pages_.clear();
+    loaded_fsm_pages_.clear();
+    RebuildTree();
     is_dirty_ = true;
   }
 
@@ -57,17 +165,22 @@ void FreeSpaceMap::UpdatePageFreeSpace(page_id_t page_id,
   // Ensure cache has space for this page
   EnsureCapacity(page_id);
 
-  uint8_t category = BytesToCategory(available_bytes);
+  SetLeaf(page_id, BytesToCategory(available_bytes));
+}
 
-  if (page_id < fsm_cache_.size()) {
-    fsm_cache_[page_id] = category;
-    // Track this page as allocated
-    allocated_pages_.insert(page_id);
-    is_dirty_ = true;
+void FreeSpaceMap::UpdatePagesFreeSpace(
+    page_id_t first_page_id, const std::vector<uint16_t>& available_bytes) {
+  if (available_bytes.empty()) {
+    return;
+  }
 
-    if (page_id >= page_count_) {
-      page_count_ = page_id + 1;
-    }
+  std::lock_guard<std::mutex> lock(fsm_mutex_);
+
+  EnsureCapacity(first_page_id +
+                 static_cast<page_id_t>(available_bytes.size() - 1));
+  for (size_t i = 0; i < available_bytes.size(); i++) {
+    SetLeaf(first_page_id + static_cast<page_id_t>(i),
+            BytesToCategory(available_bytes[i]));
   }
 }
 
@@ -75,38 +188,74 @@ void FreeSpaceMap::UpdatePageFreeSpace(page_id_t page_id,
 page_id_t FreeSpaceMap::FindPageWithSpace(uint16_t required_bytes) {
   std::lock_guard<std::mutex> lock(fsm_mutex_);
 
-  // Convert required bytes to minimum category
-  uint8_t min_category = BytesToCategory(required_bytes);
+  // A page qualifies with category >= min_category, and never with
+  // category 0 (full, or not allocated at all)
+  return SearchTree(std::max<uint8_t>(BytesToCategory(required_bytes), 1));
+}
 
-  // Scan ONLY allocated pages (handles sparse allocation)
-  for (page_id_t page_id : allocated_pages_) {
-    if (page_id < fsm_cache_.size()) {
-      uint8_t page_category = fsm_cache_[page_id];
+void FreeSpaceMap::SetInsertStreams(size_t num_streams) {
+  std::lock_guard<std::mutex> lock(fsm_mutex_);
 
-      if (page_category > min_category) {
-        return page_id;
-      }
+  for (size_t stream = 0; stream < stream_targets_.size(); stream++) {
+    ReleaseTarget(stream);
+  }
+  stream_targets_.assign(num_streams > 1 ? num_streams : 0, INVALID_PAGE_ID);
+}
 
-      if (page_category == min_category && page_category > 0) {
-        return page_id;
-      }
+size_t FreeSpaceMap::GetInsertStreamCount() const {
+  std::lock_guard<std::mutex> lock(fsm_mutex_);
+  return stream_targets_.size();
+}
+
+page_id_t FreeSpaceMap::FindInsertTarget(uint16_t required_bytes) {
+  std::lock_guard<std::mutex> lock(fsm_mutex_);
+
+  const uint8_t threshold =
+      std::max<uint8_t>(BytesToCategory(required_bytes), 1);
+  if (stream_targets_.empty()) {
+    return SearchTree(threshold);
+  }
+
+  const size_t stream = CurrentStream();
+  const page_id_t target = stream_targets_[stream];
+  if (target != INVALID_PAGE_ID) {
+    if (fsm_cache_[target] >= threshold) {
+      return target;
     }
+    // Full for this stream; smaller tuples from other streams may still fit
+    ReleaseTarget(stream);
   }
 
-  // No suitable page found - caller should allocate a new page
-  return INVALID_PAGE_ID;
+  const page_id_t page_id = SearchTree(threshold);
+  if (page_id != INVALID_PAGE_ID) {
+    ClaimTarget(stream, page_id);
+  }
+  return page_id;
 }
 
-// Get category for a specific page
-uint8_t FreeSpaceMap::GetCategory(page_id_t page_id) const {
+void FreeSpaceMap::AssignInsertTarget(page_id_t page_id) {
   std::lock_guard<std::mutex> lock(fsm_mutex_);
 
-  // Check if page is actually allocated
-  if (allocated_pages_.find(page_id) == allocated_pages_.end()) {
-    return 0;  // Page not allocated
+  if (stream_targets_.empty() || page_id == INVALID_PAGE_ID) {
+    return;
   }
 
+  EnsureCapacity(page_id);
+  if (claimed_pages_[page_id]) {
+    return;  // already this or another stream's target
+  }
+
+  const size_t stream = CurrentStream();
+  ReleaseTarget(stream);
+  ClaimTarget(stream, page_id);
+}
+
+// Get category for a specific page
+uint8_t FreeSpaceMap::GetCategory(page_id_t page_id) const {
+  std::lock_guard<std::mutex> lock(fsm_mutex_);
+
   if (page_id < fsm_cache_.size()) {
+    EnsureLoaded(page_id);
     return fsm_cache_[page_id];
   }
   return 0;  // Page not tracked or no free space
@@ -118,15 +267,7 @@ void FreeSpaceMap::SetCategory(page_id_t page_id, uint8_t category) {
 
   EnsureCapacity(page_id);
 
-  if (page_id < fsm_cache_.size()) {
-    fsm_cache_[page_id] = category;
-    allocated_pages_.insert(page_id);  // Mark as allocated
-    is_dirty_ = true;
-
-    if (page_id >= page_count_) {
-      page_count_ = page_id + 1;
-    }
-  }
+  SetLeaf(page_id, category);
 }
 
 // Get total page count
@@ -150,6 +291,21 @@ bool FreeSpaceMap::Flush() {
   return success;
 }
 
+size_t FreeSpaceMap::GetDirtyFSMPageCount() const {
+  std::lock_guard<std::mutex> lock(fsm_mutex_);
+  return std::count(dirty_fsm_pages_.begin(), dirty_fsm_pages_.end(), true);
+}
+
+FreeSpaceMapMetrics FreeSpaceMap::GetMetrics() const {
+  std::lock_guard<std::mutex> lock(fsm_mutex_);
+  return metrics_;
+}
+
+size_t FreeSpaceMap::GetLoadedFSMPageCount() const {
+  std::lock_guard<std::mutex> lock(fsm_mutex_);
+  return std::count(loaded_fsm_pages_.begin(), loaded_fsm_pages_.end(), true);
+}
+
 // Convert bytes to category
 uint8_t FreeSpaceMap::BytesToCategory(uint16_t available_bytes) {
   // Clamp to PAGE_SIZE
@@ -206,135 +362,159 @@ bool FreeSpaceMap::LoadFromDisk() {
   }
 
   // If file is empty or too small, it's a new FSM
-  if (file_size < static_cast<off_t>(FSM_HEADER_SIZE + sizeof(uint32_t))) {
-    return false;  // Need at least magic + page_count + allocated_count
+  if (file_size < static_cast<off_t>(FSM_HEADER_SIZE)) {
+    return false;
   }
 
   // Read header using pread() - thread-safe, no lseek needed
-  off_t offset = 0;
-
-  // Read magic number
-  uint32_t magic = 0;
-  if (pread(fsm_fd_, &magic, sizeof(magic), offset) != sizeof(magic)) {
+  uint32_t header[2] = {0, 0};  // magic, page count
+  if (pread(fsm_fd_, header, sizeof(header), 0) != sizeof(header)) {
     return false;
   }
-  offset += sizeof(magic);
 
-  // Verify magic number
-  if (magic != FSM_MAGIC_NUMBER) {
-    std::cerr << "Invalid FSM magic number: " << std::hex << magic << std::endl;
-    return false;
+  if (header[0] == FSM_LEGACY_MAGIC_NUMBER) {
+    return LoadLegacyFormat(file_size);
   }
 
-  // Read page count
-  uint32_t stored_page_count = 0;
-  if (pread(fsm_fd_, &stored_page_count, sizeof(stored_page_count), offset) !=
-      sizeof(stored_page_count)) {
+  // Verify magic number
+  if (header[0] != FSM_MAGIC_NUMBER) {
+    std::cerr << "Invalid FSM magic number: " << std::hex << header[0]
+              << std::endl;
     return false;
   }
-  offset += sizeof(stored_page_count);
-  page_count_ = stored_page_count;
 
-  // Read allocated pages count
-  uint32_t allocated_count = 0;
-  if (pread(fsm_fd_, &allocated_count, sizeof(allocated_count), offset) !=
-      sizeof(allocated_count)) {
-    return false;
-  }
-  offset += sizeof(allocated_count);
+  page_count_ = header[1];
+  const size_t fsm_pages = GetFSMPageCountOnDisk();
+  fsm_cache_.assign(fsm_pages * FSM_CATEGORIES_PER_PAGE, MAX_CATEGORY);
+  dirty_fsm_pages_.assign(fsm_pages, false);
+  loaded_fsm_pages_.assign(fsm_pages, false);
 
-  if (allocated_count == 0) {
-    return true;  // Empty FSM is valid
+  // Every leaf is a placeholder, so every node is MAX_CATEGORY; no need to
+  // scan the leaves
+  claimed_pages_.assign(fsm_cache_.size(), false);
+  tree_levels_.clear();
+  for (size_t level_size = fsm_cache_.size(); level_size > FSM_TREE_FANOUT;) {
+    level_size = (level_size + FSM_TREE_FANOUT - 1) / FSM_TREE_FANOUT;
+    tree_levels_.emplace_back(level_size, MAX_CATEGORY);
   }
 
-  // Read allocated page IDs
-  std::vector<page_id_t> allocated_page_ids(allocated_count);
-  size_t ids_size = allocated_count * sizeof(page_id_t);
-  if (pread(fsm_fd_, allocated_page_ids.data(), ids_size, offset) !=
-      static_cast<ssize_t>(ids_size)) {
-    std::cerr << "Failed to read allocated page IDs" << std::endl;
-    return false;
-  }
-  offset += ids_size;
-
-  // Populate allocated_pages_ set
-  allocated_pages_.clear();
-  for (page_id_t page_id : allocated_page_ids) {
-    allocated_pages_.insert(page_id);
-  }
+  is_dirty_ = false;
+  return true;
+}
 
-  // Read category data for all pages (dense array)
-  if (page_count_ > 0) {
-    fsm_cache_.resize(page_count_);
-    if (pread(fsm_fd_, fsm_cache_.data(), page_count_, offset) !=
-        static_cast<ssize_t>(page_count_)) {
-      std::cerr << "Failed to read FSM categories" << std::endl;
-      return false;
+void FreeSpaceMap::LoadFSMPage(size_t fsm_page) const {
+  metrics_.page_loads++;
+  uint8_t* leaves = fsm_cache_.data() + fsm_page * FSM_CATEGORIES_PER_PAGE;
+  std::memset(leaves, 0, FSM_CATEGORIES_PER_PAGE);
+
+  std::vector<uint8_t> buffer(FSM_PAGE_SIZE);
+  ssize_t bytes_read = pread(fsm_fd_, buffer.data(), FSM_PAGE_SIZE,
+                             static_cast<off_t>(fsm_page * FSM_PAGE_SIZE));
+  if (bytes_read == static_cast<ssize_t>(FSM_PAGE_SIZE)) {
+    uint32_t magic;
+    std::memcpy(&magic, buffer.data(), sizeof(magic));
+    if (magic == FSM_MAGIC_NUMBER) {
+      std::memcpy(leaves, buffer.data() + FSM_HEADER_SIZE,
+                  FSM_CATEGORIES_PER_PAGE);
+    } else if (magic != 0) {  // 0: file hole, FSM page never written
+      std::cerr << "Invalid magic number in FSM page " << fsm_page
+                << std::endl;
     }
+  } else if (bytes_read > 0) {  // 0: never written
+    std::cerr << "Short read of FSM page " << fsm_page << std::endl;
   }
 
-  is_dirty_ = false;
-  return true;
+  // Pages of an unreadable FSM page look full: inserts go elsewhere and
+  // the next update rewrites it
+  loaded_fsm_pages_[fsm_page] = true;
+  RefreshTree(fsm_page * FSM_CATEGORIES_PER_PAGE,
+              (fsm_page + 1) * FSM_CATEGORIES_PER_PAGE);
 }
 
-// Write to disk using pwrite()
-bool FreeSpaceMap::WriteToDisk() {
-  if (fsm_fd_ < 0) {
-    return false;
+void FreeSpaceMap::EnsureLoaded(page_id_t page_id) const {
+  const size_t fsm_page = GetFSMPageIndex(page_id);
+  if (!loaded_fsm_pages_[fsm_page]) {
+    LoadFSMPage(fsm_page);
   }
+}
 
-  off_t offset = 0;
+// Original layout: magic, page_count, allocated_count, allocated ids,
+// then page_count category bytes
+bool FreeSpaceMap::LoadLegacyFormat(off_t file_size) {
+  if (file_size < static_cast<off_t>(FSM_HEADER_SIZE + sizeof(uint32_t))) {
+    return false;  // Need at least magic + page_count + allocated_count
+  }
 
-  // Write magic number using pwrite() - thread-safe
-  uint32_t magic = FSM_MAGIC_NUMBER;
-  if (pwrite(fsm_fd_, &magic, sizeof(magic), offset) != sizeof(magic)) {
+  uint32_t header[3] = {0, 0, 0};  // magic, page count, allocated count
+  if (pread(fsm_fd_, header, sizeof(header), 0) != sizeof(header)) {
     return false;
   }
-  offset += sizeof(magic);
+  page_count_ = header[1];
 
-  // Write page count
-  uint32_t stored_page_count = page_count_;
-  if (pwrite(fsm_fd_, &stored_page_count, sizeof(stored_page_count), offset) !=
-      sizeof(stored_page_count)) {
+  // Allocated ids are implied by non-zero categories now; skip them
+  const off_t offset = static_cast<off_t>(
+      sizeof(header) + static_cast<size_t>(header[2]) * sizeof(page_id_t));
+
+  const size_t fsm_pages = GetFSMPageCountOnDisk();
+  fsm_cache_.assign(fsm_pages * FSM_CATEGORIES_PER_PAGE, 0);
+  loaded_fsm_pages_.assign(fsm_pages, true);
+  if (page_count_ > 0 && pread(fsm_fd_, fsm_cache_.data(), page_count_,
+                               offset) != static_cast<ssize_t>(page_count_)) {
+    std::cerr << "Failed to read FSM categories" << std::endl;
     return false;
   }
-  offset += sizeof(stored_page_count);
 
-  // Write allocated pages count
-  uint32_t allocated_count = static_cast<uint32_t>(allocated_pages_.size());
-  if (pwrite(fsm_fd_, &allocated_count, sizeof(allocated_count), offset) !=
-      sizeof(allocated_count)) {
+  // Rewrite everything in the paged format on the next flush
+  dirty_fsm_pages_.assign(fsm_pages, true);
+  truncate_on_flush_ = true;
+  RebuildTree();
+  is_dirty_ = true;
+  return true;
+}
+
+// Write dirty FSM pages using pwrite()
+bool FreeSpaceMap::WriteToDisk() {
+  if (fsm_fd_ < 0) {
     return false;
   }
-  offset += sizeof(allocated_count);
 
-  // Write allocated page IDs
-  if (allocated_count > 0) {
-    std::vector<page_id_t> allocated_page_ids(allocated_pages_.begin(),
-                                              allocated_pages_.end());
-    size_t ids_size = allocated_count * sizeof(page_id_t);
-    if (pwrite(fsm_fd_, allocated_page_ids.data(), ids_size, offset) !=
-        static_cast<ssize_t>(ids_size)) {
+  const size_t fsm_pages = GetFSMPageCountOnDisk();
+  std::vector<uint8_t> buffer(FSM_PAGE_SIZE);
+  const uint32_t header[2] = {FSM_MAGIC_NUMBER,
+                              static_cast<uint32_t>(page_count_)};
+  std::memcpy(buffer.data(), header, sizeof(header));
+
+  size_t pages_written = 0;
+  for (size_t k = 0; k < fsm_pages; k++) {
+    if (!dirty_fsm_pages_[k]) {
+      continue;
+    }
+
+    std::memcpy(buffer.data() + FSM_HEADER_SIZE,
+                fsm_cache_.data() + k * FSM_CATEGORIES_PER_PAGE,
+                FSM_CATEGORIES_PER_PAGE);
+    // pwrite() - thread-safe, no lseek needed
+    if (pwrite(fsm_fd_, buffer.data(), FSM_PAGE_SIZE,
+               static_cast<off_t>(k * FSM_PAGE_SIZE)) !=
+        static_cast<ssize_t>(FSM_PAGE_SIZE)) {
       return false;
     }
-    offset += ids_size;
+    dirty_fsm_pages_[k] = false;
+    pages_written++;
   }
 
-  // Write category data (dense array)
-  if (page_count_ > 0 && !fsm_cache_.empty()) {
-    size_t bytes_to_write =
-        std::min(static_cast<size_t>(page_count_), fsm_cache_.size());
-    if (pwrite(fsm_fd_, fsm_cache_.data(), bytes_to_write, offset) !=
-        static_cast<ssize_t>(bytes_to_write)) {
-      return false;
+  if (truncate_on_flush_) {
+    // Converted from the legacy format: drop any leftover blob bytes
+    if (ftruncate(fsm_fd_, static_cast<off_t>(fsm_pages * FSM_PAGE_SIZE)) <
+        0) {
+      std::cerr << "Failed to truncate FSM file" << std::endl;
+      // Not fatal, continue
     }
-    offset += bytes_to_write;
+    truncate_on_flush_ = false;
   }
 
-  // Truncate file to exact size (remove any old data)
-  if (ftruncate(fsm_fd_, offset) < 0) {
-    std::cerr << "Failed to truncate FSM file" << std::endl;
-    // Not fatal, continue
+  if (pages_written == 0) {
+    return true;
   }
 
   // Sync to disk
@@ -347,19 +527,218 @@ bool FreeSpaceMap::WriteToDisk() {
 
 // Ensure cache capacity
 void FreeSpaceMap::EnsureCapacity(page_id_t page_id) {
-  // Expand cache if necessary
-  if (page_id >= fsm_cache_.size()) {
-    // Grow cache with some headroom to reduce reallocations
-    size_t new_size =
-        std::max(static_cast<size_t>(page_id + 1), fsm_cache_.size() * 2);
-
-    // Limit growth to reasonable size (support hierarchical FSM later)
-    if (new_size > FSM_CATEGORIES_PER_PAGE * 100) {
-      new_size = page_id + 1;
+  if (page_id < fsm_cache_.size()) {
+    return;
+  }
+
+  // Grow geometrically, in whole FSM pages, so the tree rebuild below is
+  // amortized O(1) per tracked page
+  size_t new_size =
+      std::max(static_cast<size_t>(page_id) + 1, fsm_cache_.size() * 2);
+  new_size = (new_size + FSM_CATEGORIES_PER_PAGE - 1) /
+             FSM_CATEGORIES_PER_PAGE * FSM_CATEGORIES_PER_PAGE;
+
+  fsm_cache_.resize(new_size, 0);  // Initialize new entries to 0 (no space)
+  dirty_fsm_pages_.resize(new_size / FSM_CATEGORIES_PER_PAGE, false);
+  loaded_fsm_pages_.resize(new_size / FSM_CATEGORIES_PER_PAGE, true);
+  RebuildTree();
+}
+
+void FreeSpaceMap::SetLeaf(page_id_t page_id, uint8_t category) {
+  EnsureLoaded(page_id);
+  const uint8_t old_value = TreeValue(page_id);
+  fsm_cache_[page_id] = category;
+  dirty_fsm_pages_[GetFSMPageIndex(page_id)] = true;
+  is_dirty_ = true;
+
+  if (page_id >= page_count_) {
+    page_count_ = page_id + 1;
+    EnsureLoaded(INVALID_PAGE_ID);  // FSM page 0 is about to be rewritten
+    dirty_fsm_pages_[0] = true;  // page count lives in the FSM page header
+  }
+
+  BubbleUp(page_id, old_value, TreeValue(page_id));
+}
+
+void FreeSpaceMap::BubbleUp(page_id_t page_id, uint8_t old_value,
+                            uint8_t new_value) {
+  if (page_id == INVALID_PAGE_ID || old_value == new_value) {
+    return;  // page 0 is not part of the tree
+  }
+
+  // Bubble up while the parent's max changes
+  size_t index = page_id;
+  for (size_t level = 0; level < tree_levels_.size(); level++) {
+    const size_t group = index / FSM_TREE_FANOUT;
+    uint8_t& parent = tree_levels_[level][group];
+    const uint8_t old_parent = parent;
+
+    if (new_value >= parent) {
+      parent = new_value;
+    } else if (old_value == parent) {
+      parent = GroupMax(level, group);  // the max may have shrunk
     }
 
-    fsm_cache_.resize(new_size, 0);  // Initialize new entries to 0 (no space)
+    if (parent == old_parent) {
+      break;
+    }
+    old_value = old_parent;
+    new_value = parent;
+    index = group;
+  }
+}
+
+page_id_t FreeSpaceMap::SearchTree(uint8_t threshold) const {
+  metrics_.searches++;
+  // A leaf on an unloaded FSM page is only a placeholder: load the page and
+  // search again. Each round loads a page, so the loop terminates.
+  for (;;) {
+    const page_id_t page_id = DescendTree(threshold);
+    if (page_id == INVALID_PAGE_ID) {
+      metrics_.search_misses++;
+      return page_id;
+    }
+    if (loaded_fsm_pages_[GetFSMPageIndex(page_id)]) {
+      return page_id;
+    }
+    LoadFSMPage(GetFSMPageIndex(page_id));
+  }
+}
+
+page_id_t FreeSpaceMap::DescendTree(uint8_t threshold) const {
+  if (fsm_cache_.size() <= 1) {
+    return INVALID_PAGE_ID;
+  }
+  metrics_.search_steps += tree_levels_.size() + 1;
+
+  // Small map: the leaves are the root level
+  if (tree_levels_.empty()) {
+    const size_t index = FindUnclaimedLeaf(1, fsm_cache_.size(), threshold);
+    return index < fsm_cache_.size() ? static_cast<page_id_t>(index)
+                                     : INVALID_PAGE_ID;
+  }
+
+  // Root: find the first subtree whose max qualifies
+  const std::vector<uint8_t>& root = tree_levels_.back();
+  size_t index = FindFirstAtLeast(root.data(), root.size(), threshold);
+  if (index == root.size()) {
+    // No suitable page found - caller should allocate a new page
+    return INVALID_PAGE_ID;
+  }
+
+  // Descend: the first qualifying child always exists below a node whose
+  // max qualifies, so every level costs one fanout-wide vector scan
+  for (size_t level = tree_levels_.size(); level-- > 0;) {
+    const size_t start = index * FSM_TREE_FANOUT;
+    if (level == 0) {
+      const size_t end = std::min(start + FSM_TREE_FANOUT, fsm_cache_.size());
+      // start == 0 skips INVALID_PAGE_ID
+      index = FindUnclaimedLeaf(std::max<size_t>(start, 1), end, threshold);
+      if (index >= end) {
+        std::cerr << "FSM tree inconsistent at leaf level" << std::endl;
+        return INVALID_PAGE_ID;
+      }
+      break;
+    }
+
+    const std::vector<uint8_t>& children = tree_levels_[level - 1];
+    const size_t end = std::min(start + FSM_TREE_FANOUT, children.size());
+    index = start + FindFirstAtLeast(children.data() + start, end - start,
+                                     threshold);
+    if (index >= end) {
+      std::cerr << "FSM tree inconsistent at level " << level << std::endl;
+      return INVALID_PAGE_ID;
+    }
+  }
+
+  return static_cast<page_id_t>(index);
+}
+
+size_t FreeSpaceMap::FindUnclaimedLeaf(size_t start, size_t end,
+                                       uint8_t threshold) const {
+  // Claimed leaves keep their real category, so skip past them; there are
+  // at most as many as there are streams
+  while (start < end) {
+    const size_t index =
+        start + FindFirstAtLeast(fsm_cache_.data() + start, end - start,
+                                 threshold);
+    if (index >= end || !claimed_pages_[index]) {
+      return index;
+    }
+    start = index + 1;
+  }
+  return end;
+}
+
+void FreeSpaceMap::ClaimTarget(size_t stream, page_id_t page_id) {
+  EnsureLoaded(page_id);
+  stream_targets_[stream] = page_id;
+  claimed_pages_[page_id] = true;
+  BubbleUp(page_id, fsm_cache_[page_id], 0);
+}
+
+void FreeSpaceMap::ReleaseTarget(size_t stream) {
+  const page_id_t page_id = stream_targets_[stream];
+  if (page_id == INVALID_PAGE_ID) {
+    return;
+  }
+  stream_targets_[stream] = INVALID_PAGE_ID;
+  claimed_pages_[page_id] = false;
+  BubbleUp(page_id, 0, fsm_cache_[page_id]);
+}
+
+size_t FreeSpaceMap::CurrentStream() const {
+  return CurrentThreadNumber() % stream_targets_.size();
+}
+
+void FreeSpaceMap::RebuildTree() {
+  claimed_pages_.resize(fsm_cache_.size(), false);
+  tree_levels_.clear();
+
+  size_t level_size = fsm_cache_.size();
+  while (level_size > FSM_TREE_FANOUT) {
+    const size_t groups = (level_size + FSM_TREE_FANOUT - 1) / FSM_TREE_FANOUT;
+    tree_levels_.emplace_back(groups, 0);
+    const size_t level = tree_levels_.size() - 1;
+    for (size_t group = 0; group < groups; group++) {
+      tree_levels_[level][group] = GroupMax(level, group);
+    }
+    level_size = groups;
+  }
+}
+
+void FreeSpaceMap::RefreshTree(size_t first_leaf, size_t end_leaf) const {
+  size_t first_group = first_leaf;
+  size_t last_group = end_leaf - 1;
+  for (size_t level = 0; level < tree_levels_.size(); level++) {
+    first_group /= FSM_TREE_FANOUT;
+    last_group /= FSM_TREE_FANOUT;
+    for (size_t group = first_group; group <= last_group; group++) {
+      tree_levels_[level][group] = GroupMax(level, group);
+    }
+  }
+}
+
+uint8_t FreeSpaceMap::GroupMax(size_t level, size_t group) const {
+  const std::vector<uint8_t>& children =
+      level == 0 ? fsm_cache_ : tree_levels_[level - 1];
+  size_t start = group * FSM_TREE_FANOUT;
+  if (level == 0 && start == 0) {
+    start = 1;  // INVALID_PAGE_ID never qualifies
+  }
+  const size_t end =
+      std::min(group * FSM_TREE_FANOUT + FSM_TREE_FANOUT, children.size());
+
+  uint8_t max_value = 0;
+  for (size_t i = start; i < end; i++) {
+    max_value = std::max(max_value, level == 0 ? TreeValue(i) : children[i]);
   }
+  return max_value;
+}
+
+size_t FreeSpaceMap::GetFSMPageCountOnDisk() const {
+  return (static_cast<size_t>(page_count_) + FSM_CATEGORIES_PER_PAGE - 1) /
+         FSM_CATEGORIES_PER_PAGE;
 }
 
 // Get FSM page index (for hierarchical FSM)
@@ -0,0 +1,368 @@
+#include "../../include/storage/io_uring_engine.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include "../../include/common/logger.h"
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define STORAGEENGINE_HAVE_IO_URING 1
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#ifdef STORAGEENGINE_HAVE_IO_URING
+
+namespace {
+
+// user_data of the NOP that tells the reaper to exit
+constexpr uint64_t kShutdownUserData = ~0ULL;
+
+}  // namespace
+
+IoUringEngine::IoUringEngine(size_t queue_depth)
+    : ring_fd_(-1),
+      sq_entries_(0),
+      cq_entries_(0),
+      sq_ring_(nullptr),
+      sq_ring_size_(0),
+      cq_ring_(nullptr),
+      cq_ring_size_(0),
+      sqes_(nullptr),
+      sqes_size_(0),
+      next_user_data_(0),
+      in_flight_(0),
+      stopping_(false) {
+  if (queue_depth == 0) {
+    throw std::invalid_argument("IoUringEngine requires queue depth >= 1");
+  }
+
+  SetupRing(queue_depth);
+  reaper_ = std::thread(&IoUringEngine::ReaperLoop, this);
+
+  LOG_INFO_STREAM("IoUringEngine: Initialized with " << sq_entries_
+                                                     << " SQ / " << cq_entries_
+                                                     << " CQ entries");
+}
+
+IoUringEngine::~IoUringEngine() {
+  {
+    // Let in-flight requests finish so no buffer is written after we return
+    std::unique_lock<std::mutex> lock(pending_mutex_);
+    slots_cv_.wait(lock, [this]() { return in_flight_ == 0; });
+  }
+  stopping_ = true;
+
+  {
+    // Wake the reaper with a NOP; the CQ always has a slot in reserve for it
+    std::lock_guard<std::mutex> lock(submit_mutex_);
+    if (PushSqe(IORING_OP_NOP, nullptr, kShutdownUserData)) {
+      Enter(1, 0, 0);
+    }
+  }
+  slots_cv_.notify_all();
+  reaper_.join();
+
+  // Anything still pending never produced a completion
+  for (auto& [user_data, pending] : pending_) {
+    IOHandle::Complete(pending.state.get(), pending.request, -ECANCELED);
+  }
+  pending_.clear();
+
+  TeardownRing();
+}
+
+bool IoUringEngine::IsSupported() {
+  static const bool supported = []() {
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    const int fd = static_cast<int>(syscall(__NR_io_uring_setup, 1, &params));
+    if (fd < 0) {
+      return false;
+    }
+    close(fd);
+    return true;
+  }();
+  return supported;
+}
+
+void IoUringEngine::SetupRing(size_t queue_depth) {
+  io_uring_params params;
+  memset(&params, 0, sizeof(params));
+
+  ring_fd_ = static_cast<int>(
+      syscall(__NR_io_uring_setup, static_cast<unsigned>(queue_depth), &params));
+  if (ring_fd_ < 0) {
+    throw std::runtime_error("io_uring_setup failed: " +
+                             std::string(strerror(errno)));
+  }
+
+  sq_entries_ = params.sq_entries;
+  cq_entries_ = params.cq_entries;
+
+  sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+  cq_ring_size_ =
+      params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+  const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (single_mmap) {
+    sq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+    cq_ring_size_ = sq_ring_size_;
+  }
+
+  sq_ring_ = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE,
+                  MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+  if (sq_ring_ == MAP_FAILED) {
+    sq_ring_ = nullptr;
+    TeardownRing();
+    throw std::runtime_error("io_uring SQ ring mmap failed");
+  }
+
+  if (single_mmap) {
+    cq_ring_ = sq_ring_;
+  } else {
+    cq_ring_ = mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_CQ_RING);
+    if (cq_ring_ == MAP_FAILED) {
+      cq_ring_ = nullptr;
+      TeardownRing();
+      throw std::runtime_error("io_uring CQ ring mmap failed");
+    }
+  }
+
+  sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+  sqes_ = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE,
+               MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES);
+  if (sqes_ == MAP_FAILED) {
+    sqes_ = nullptr;
+    TeardownRing();
+    throw std::runtime_error("io_uring SQE array mmap failed");
+  }
+
+  auto* sq = static_cast<uint8_t*>(sq_ring_);
+  sq_head_ = reinterpret_cast<uint32_t*>(sq + params.sq_off.head);
+  sq_tail_ = reinterpret_cast<uint32_t*>(sq + params.sq_off.tail);
+  sq_mask_ = reinterpret_cast<uint32_t*>(sq + params.sq_off.ring_mask);
+  sq_array_ = reinterpret_cast<uint32_t*>(sq + params.sq_off.array);
+
+  auto* cq = static_cast<uint8_t*>(cq_ring_);
+  cq_head_ = reinterpret_cast<uint32_t*>(cq + params.cq_off.head);
+  cq_tail_ = reinterpret_cast<uint32_t*>(cq + params.cq_off.tail);
+  cq_mask_ = reinterpret_cast<uint32_t*>(cq + params.cq_off.ring_mask);
+  cqes_ = cq + params.cq_off.cqes;
+}
+
+void IoUringEngine::TeardownRing() {
+  if (sqes_ != nullptr) {
+    munmap(sqes_, sqes_size_);
+    sqes_ = nullptr;
+  }
+  if (cq_ring_ != nullptr && cq_ring_ != sq_ring_) {
+    munmap(cq_ring_, cq_ring_size_);
+  }
+  cq_ring_ = nullptr;
+  if (sq_ring_ != nullptr) {
+    munmap(sq_ring_, sq_ring_size_);
+    sq_ring_ = nullptr;
+  }
+  if (ring_fd_ >= 0) {
+    close(ring_fd_);
+    ring_fd_ = -1;
+  }
+}
+
+int IoUringEngine::Enter(uint32_t to_submit, uint32_t min_complete,
+                         uint32_t flags) {
+  return static_cast<int>(syscall(__NR_io_uring_enter, ring_fd_, to_submit,
+                                  min_complete, flags, nullptr, 0));
+}
+
+bool IoUringEngine::PushSqe(uint8_t opcode, const IORequest* request,
+                            uint64_t user_data) {
+  const uint32_t tail = *sq_tail_;
+  const uint32_t head = __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+  if (tail - head >= sq_entries_) {
+    return false;
+  }
+
+  const uint32_t index = tail & *sq_mask_;
+  auto* sqe = static_cast<io_uring_sqe*>(sqes_) + index;
+  memset(sqe, 0, sizeof(*sqe));
+  sqe->opcode = opcode;
+  sqe->fd = -1;
+  if (request != nullptr) {
+    sqe->fd = request->fd;
+    sqe->addr = reinterpret_cast<uint64_t>(request->buffer);
+    sqe->len = static_cast<uint32_t>(request->length);
+    sqe->off = static_cast<uint64_t>(request->offset);
+  }
+  sqe->user_data = user_data;
+
+  sq_array_[index] = index;
+  __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+  return true;
+}
+
+std::vector<IOHandle> IoUringEngine::Submit(std::vector<IORequest> requests) {
+  std::vector<IOHandle> handles;
+  handles.reserve(requests.size());
+
+  std::vector<std::shared_ptr<IOHandle::State>> states;
+  states.reserve(requests.size());
+  for (size_t i = 0; i < requests.size(); i++) {
+    states.push_back(std::make_shared<IOHandle::State>());
+    handles.emplace_back(states.back());
+  }
+
+  std::lock_guard<std::mutex> submit_lock(submit_mutex_);
+
+  // One CQ slot stays reserved for the shutdown NOP
+  const size_t max_in_flight = cq_entries_ - 1;
+
+  size_t next = 0;
+  while (next < requests.size()) {
+    size_t chunk = 0;
+    std::vector<uint64_t> ids;
+    {
+      std::unique_lock<std::mutex> lock(pending_mutex_);
+      slots_cv_.wait(lock, [&]() {
+        return in_flight_ < max_in_flight || stopping_.load();
+      });
+      if (stopping_) {
+        break;
+      }
+
+      chunk = std::min({requests.size() - next, max_in_flight - in_flight_,
+                        static_cast<size_t>(sq_entries_)});
+      ids.reserve(chunk);
+      for (size_t i = 0; i < chunk; i++) {
+        const uint64_t user_data = next_user_data_++;
+        pending_.emplace(user_data,
+                         Pending{requests[next + i], states[next + i]});
+        ids.push_back(user_data);
+      }
+      in_flight_ += chunk;
+    }
+
+    for (size_t i = 0; i < chunk; i++) {
+      const IORequest& request = requests[next + i];
+      const uint8_t opcode =
+          request.op == IOOpType::READ ? IORING_OP_READ : IORING_OP_WRITE;
+      PushSqe(opcode, &request, ids[i]);  // chunk <= sq_entries_, cannot fail
+    }
+
+    // Without SQPOLL the kernel consumes SQEs only inside io_uring_enter
+    uint32_t submitted = 0;
+    int error = 0;
+    while (submitted < chunk) {
+      const int ret = Enter(static_cast<uint32_t>(chunk - submitted), 0, 0);
+      if (ret < 0) {
+        if (errno == EINTR || errno == EAGAIN) {
+          continue;
+        }
+        error = errno;
+        break;
+      }
+      submitted += static_cast<uint32_t>(ret);
+    }
+
+    if (submitted < chunk) {
+      // Withdraw the SQEs the kernel never saw and fail their requests
+      __atomic_store_n(sq_tail_, __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE),
+                       __ATOMIC_RELEASE);
+      LOG_ERROR_STREAM("IoUringEngine::Submit: io_uring_enter failed: "
+                       << strerror(error));
+
+      std::vector<Pending> failed;
+      {
+        std::lock_guard<std::mutex> lock(pending_mutex_);
+        for (size_t i = submitted; i < chunk; i++) {
+          auto it = pending_.find(ids[i]);
+          failed.push_back(std::move(it->second));
+          pending_.erase(it);
+        }
+        in_flight_ -= chunk - submitted;
+      }
+      for (auto& pending : failed) {
+        IOHandle::Complete(pending.state.get(), pending.request, -error);
+      }
+    }
+
+    next += chunk;
+  }
+
+  // Engine shutting down: fail whatever was not queued
+  for (size_t i = next; i < requests.size(); i++) {
+    IOHandle::Complete(states[i].get(), requests[i], -ECANCELED);
+  }
+
+  return handles;
+}
+
+void IoUringEngine::ReaperLoop() {
+  bool shutdown = false;
+  while (!shutdown) {
+    const int ret = Enter(0, 1, IORING_ENTER_GETEVENTS);
+    if (ret < 0 && errno != EINTR) {
+      LOG_ERROR_STREAM("IoUringEngine: Waiting for completions failed: "
+                       << strerror(errno));
+      if (stopping_) {
+        break;
+      }
+      continue;
+    }
+
+    uint32_t head = *cq_head_;
+    const uint32_t tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+
+    std::vector<std::pair<Pending, ssize_t>> completed;
+    {
+      std::lock_guard<std::mutex> lock(pending_mutex_);
+      while (head != tail) {
+        const auto* cqe = static_cast<io_uring_cqe*>(cqes_) + (head & *cq_mask_);
+        head++;
+
+        if (cqe->user_data == kShutdownUserData) {
+          shutdown = true;
+          continue;
+        }
+
+        auto it = pending_.find(cqe->user_data);
+        if (it == pending_.end()) {
+          continue;
+        }
+        completed.emplace_back(std::move(it->second), cqe->res);
+        pending_.erase(it);
+        in_flight_--;
+      }
+    }
+    __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+    slots_cv_.notify_all();
+
+    for (auto& [pending, res] : completed) {
+      IOHandle::Complete(pending.state.get(), pending.request, res);
+    }
+  }
+}
+
+#else  // !STORAGEENGINE_HAVE_IO_URING
+
+IoUringEngine::IoUringEngine(size_t /*queue_depth*/) {
+  throw std::runtime_error("io_uring is not supported on this platform");
+}
+
+IoUringEngine::~IoUringEngine() = default;
+
+bool IoUringEngine::IsSupported() { return false; }
+
+std::vector<IOHandle> IoUringEngine::Submit(
+    std::vector<IORequest> /*requests*/) {
+  return {};
+}
+
+#endif  // STORAGEENGINE_HAVE_IO_URING
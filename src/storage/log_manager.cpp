@@ -0,0 +1,355 @@
+#include "../../include/storage/log_manager.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include "../../include/common/checksum.h"
+#include "../../include/common/logger.h"
+
+namespace {
+
+// 24-byte LogRecordHeader plus at most a page of payload
+constexpr size_t MAX_RECORD_SIZE = 24 + PAGE_SIZE;
+
+// Records are read in chunks of this size during recovery (at least two of
+// the largest record, so a refill always makes progress)
+constexpr size_t LOG_READ_CHUNK_SIZE = 64 * 1024;
+static_assert(LOG_READ_CHUNK_SIZE >= 2 * MAX_RECORD_SIZE,
+              "Log read chunk too small");
+
+bool WriteFully(int fd, const char* data, size_t size, off_t offset) {
+  while (size > 0) {
+    const ssize_t written = pwrite(fd, data, size, offset);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    data += written;
+    size -= static_cast<size_t>(written);
+    offset += written;
+  }
+  return true;
+}
+
+}  // namespace
+
+LogManager::LogManager(const std::string& log_file_name)
+    : log_file_name_(log_file_name),
+      file_(log_file_name, O_RDWR | O_CREAT),
+      buffer_lsn_(LOG_HEADER_SIZE),
+      next_lsn_(LOG_HEADER_SIZE),
+      full_page_lsn_(LOG_HEADER_SIZE),
+      durable_lsn_(LOG_HEADER_SIZE),
+      checkpoint_lsn_(LOG_HEADER_SIZE) {
+  struct stat file_stat {};
+  if (fstat(file_.get(), &file_stat) != 0) {
+    LOG_ERROR_STREAM("LogManager: Failed to stat " << log_file_name_);
+    throw std::runtime_error("Failed to open log file: " + log_file_name_);
+  }
+
+  if (file_stat.st_size == 0) {
+    if (!WriteHeader(LOG_HEADER_SIZE)) {
+      throw std::runtime_error("Failed to initialize log file: " +
+                               log_file_name_);
+    }
+    LOG_INFO_STREAM("LogManager: Created log file " << log_file_name_);
+  } else {
+    LogFileHeader header{};
+    if (file_stat.st_size < static_cast<off_t>(LOG_HEADER_SIZE) ||
+        pread(file_.get(), &header, sizeof(header), 0) !=
+            static_cast<ssize_t>(sizeof(header)) ||
+        memcmp(header.magic, "WLOG", 4) != 0 ||
+        header.version != LOG_FORMAT_VERSION ||
+        header.checkpoint_lsn < LOG_HEADER_SIZE) {
+      LOG_ERROR_STREAM("LogManager: " << log_file_name_
+                                      << " is not a valid log file");
+      throw std::runtime_error("Invalid log file format");
+    }
+    checkpoint_lsn_ = header.checkpoint_lsn;
+    full_page_lsn_ = header.checkpoint_lsn;
+    RecoverTail();
+  }
+
+  buffer_.reserve(DEFAULT_LOG_BUFFER_SIZE);
+  flush_buffer_.reserve(DEFAULT_LOG_BUFFER_SIZE);
+}
+
+LogManager::~LogManager() {
+  ErrorCode result = FlushAll();
+  if (result.code != 0) {
+    LOG_ERROR_STREAM("LogManager: Failed to flush on close ("
+                     << result.message << ")");
+  }
+}
+
+lsn_t LogManager::Append(LogRecordType type, page_id_t page_id,
+                         slot_id_t slot_id, const char* payload,
+                         uint16_t payload_size) {
+  if (payload_size > PAGE_SIZE || (payload == nullptr && payload_size > 0)) {
+    LOG_ERROR_STREAM("LogManager::Append: Invalid payload ("
+                     << payload_size << " bytes)");
+    return INVALID_LSN;
+  }
+
+  std::lock_guard<std::mutex> lock(append_mutex_);
+  return AppendLocked(type, page_id, slot_id, payload, payload_size);
+}
+
+lsn_t LogManager::AppendPageChange(LogRecordType type, page_id_t page_id,
+                                   slot_id_t slot_id, lsn_t page_lsn,
+                                   const char* page_image, const char* payload,
+                                   uint16_t payload_size) {
+  if (page_image == nullptr || payload_size > PAGE_SIZE ||
+      (payload == nullptr && payload_size > 0)) {
+    LOG_ERROR_STREAM("LogManager::AppendPageChange: Invalid record for page "
+                     << page_id);
+    return INVALID_LSN;
+  }
+
+  // Decided under the append latch, so a checkpoint that begins
+  // concurrently either sees this record or makes the next change an image
+  std::lock_guard<std::mutex> lock(append_mutex_);
+  if (type != LogRecordType::NEW_PAGE && page_lsn < full_page_lsn_) {
+    page_images_++;
+    return AppendLocked(LogRecordType::PAGE_IMAGE, page_id, INVALID_SLOT_ID,
+                        page_image, PAGE_SIZE);
+  }
+  return AppendLocked(type, page_id, slot_id, payload, payload_size);
+}
+
+lsn_t LogManager::AppendLocked(LogRecordType type, page_id_t page_id,
+                               slot_id_t slot_id, const char* payload,
+                               uint16_t payload_size) {
+  const uint32_t size =
+      static_cast<uint32_t>(sizeof(LogRecordHeader) + payload_size);
+  const lsn_t lsn = next_lsn_;
+  LogRecordHeader header{size, 0, lsn, page_id, slot_id,
+                         static_cast<uint8_t>(type), 0};
+
+  const size_t offset = buffer_.size();
+  buffer_.resize(offset + size);
+  char* record = buffer_.data() + offset;
+  memcpy(record, &header, sizeof(header));
+  if (payload_size > 0) {
+    memcpy(record + sizeof(header), payload, payload_size);
+  }
+  header.crc = RecordCrc(record, size);
+  memcpy(record + offsetof(LogRecordHeader, crc), &header.crc,
+         sizeof(header.crc));
+
+  next_lsn_ += size;
+  return lsn;
+}
+
+ErrorCode LogManager::Flush(lsn_t lsn) {
+  if (lsn == INVALID_LSN) {
+    return {0, "LogManager::Flush: Nothing to flush"};
+  }
+  return FlushTo(lsn + 1);
+}
+
+ErrorCode LogManager::FlushAll() { return FlushTo(GetNextLsn()); }
+
+ErrorCode LogManager::FlushTo(lsn_t end_lsn) {
+  if (durable_lsn_.load() >= end_lsn) {
+    return {0, "LogManager::Flush: Already durable"};
+  }
+
+  std::lock_guard<std::mutex> flush_lock(flush_mutex_);
+  // The previous leader may have covered us while we waited
+  if (durable_lsn_.load() >= end_lsn) {
+    return {0, "LogManager::Flush: Already durable"};
+  }
+
+  lsn_t start_lsn;
+  {
+    std::lock_guard<std::mutex> lock(append_mutex_);
+    flush_buffer_.swap(buffer_);
+    start_lsn = buffer_lsn_;
+    buffer_lsn_ = next_lsn_;
+  }
+  if (flush_buffer_.empty()) {
+    return {0, "LogManager::Flush: Nothing to flush"};
+  }
+
+  if (!WriteFully(file_.get(), flush_buffer_.data(), flush_buffer_.size(),
+                  static_cast<off_t>(start_lsn)) ||
+      fdatasync(file_.get()) != 0) {
+    LOG_ERROR_STREAM("LogManager::Flush: Failed to write log at LSN "
+                     << start_lsn << " (errno " << errno << ")");
+    // Put the records back in front of anything appended since
+    std::lock_guard<std::mutex> lock(append_mutex_);
+    flush_buffer_.insert(flush_buffer_.end(), buffer_.begin(), buffer_.end());
+    flush_buffer_.swap(buffer_);
+    flush_buffer_.clear();
+    buffer_lsn_ = start_lsn;
+    return {-1, "LogManager::Flush: Failed to write log"};
+  }
+
+  sync_count_++;
+  durable_lsn_ = start_lsn + flush_buffer_.size();
+  flush_buffer_.clear();
+  return {0, "LogManager::Flush: Success"};
+}
+
+lsn_t LogManager::GetNextLsn() const {
+  std::lock_guard<std::mutex> lock(append_mutex_);
+  return next_lsn_;
+}
+
+lsn_t LogManager::BeginCheckpoint() {
+  std::lock_guard<std::mutex> lock(append_mutex_);
+  full_page_lsn_ = next_lsn_;
+  return next_lsn_;
+}
+
+lsn_t LogManager::GetCheckpointLsn() const { return checkpoint_lsn_.load(); }
+
+ErrorCode LogManager::SetCheckpointLsn(lsn_t lsn) {
+  if (lsn < LOG_HEADER_SIZE || lsn > GetDurableLsn()) {
+    LOG_ERROR_STREAM("LogManager::SetCheckpointLsn: LSN " << lsn
+                                                          << " is not in "
+                                                             "the durable log");
+    return {-1, "LogManager::SetCheckpointLsn: LSN not in durable log"};
+  }
+
+  std::lock_guard<std::mutex> flush_lock(flush_mutex_);
+  if (!WriteHeader(lsn)) {
+    return {-2, "LogManager::SetCheckpointLsn: Failed to write header"};
+  }
+  checkpoint_lsn_ = lsn;
+  LOG_INFO_STREAM("LogManager: Checkpoint at LSN " << lsn);
+  return {0, "LogManager::SetCheckpointLsn: Success"};
+}
+
+ErrorCode LogManager::ForEachRecord(
+    lsn_t from_lsn,
+    const std::function<bool(const LogRecord&)>& visitor) const {
+  if (from_lsn < LOG_HEADER_SIZE) {
+    LOG_ERROR_STREAM("LogManager::ForEachRecord: LSN " << from_lsn
+                                                       << " is in the header");
+    return {-1, "LogManager::ForEachRecord: LSN is in the header"};
+  }
+  ScanRecords(from_lsn, GetDurableLsn(), visitor);
+  return {0, "LogManager::ForEachRecord: Success"};
+}
+
+bool LogManager::WriteHeader(lsn_t checkpoint_lsn) {
+  char block[LOG_HEADER_SIZE] = {};
+  LogFileHeader header{{'W', 'L', 'O', 'G'}, LOG_FORMAT_VERSION,
+                       checkpoint_lsn};
+  memcpy(block, &header, sizeof(header));
+  if (!WriteFully(file_.get(), block, sizeof(block), 0) ||
+      fdatasync(file_.get()) != 0) {
+    LOG_ERROR_STREAM("LogManager: Failed to write header of "
+                     << log_file_name_ << " (errno " << errno << ")");
+    return false;
+  }
+  return true;
+}
+
+lsn_t LogManager::ScanRecords(
+    lsn_t from_lsn, lsn_t end_lsn,
+    const std::function<bool(const LogRecord&)>& visitor) const {
+  std::vector<char> chunk(LOG_READ_CHUNK_SIZE);
+  lsn_t chunk_lsn = from_lsn;
+  size_t chunk_size = 0;
+
+  lsn_t lsn = from_lsn;
+  while (lsn + sizeof(LogRecordHeader) <= end_lsn) {
+    // Refill so the chunk holds a whole record, unless it already reaches
+    // the end of the log
+    if (lsn + MAX_RECORD_SIZE > chunk_lsn + chunk_size &&
+        chunk_lsn + chunk_size < end_lsn) {
+      const size_t wanted = std::min<size_t>(chunk.size(), end_lsn - lsn);
+      const ssize_t bytes_read = pread(file_.get(), chunk.data(), wanted,
+                                       static_cast<off_t>(lsn));
+      if (bytes_read < static_cast<ssize_t>(sizeof(LogRecordHeader))) {
+        break;
+      }
+      chunk_lsn = lsn;
+      chunk_size = static_cast<size_t>(bytes_read);
+    }
+
+    const char* record = chunk.data() + (lsn - chunk_lsn);
+    const size_t available = chunk_lsn + chunk_size - lsn;
+    LogRecordHeader header;
+    memcpy(&header, record, sizeof(header));
+    if (header.size < sizeof(LogRecordHeader) ||
+        header.size > MAX_RECORD_SIZE || header.size > available ||
+        header.lsn != lsn || RecordCrc(record, header.size) != header.crc) {
+      break;
+    }
+
+    const LogRecord log_record{
+        lsn,
+        static_cast<LogRecordType>(header.type),
+        header.page_id,
+        header.slot_id,
+        record + sizeof(LogRecordHeader),
+        static_cast<uint16_t>(header.size - sizeof(LogRecordHeader))};
+    lsn += header.size;
+    if (!visitor(log_record)) {
+      break;
+    }
+  }
+  return lsn;
+}
+
+void LogManager::RecoverTail() {
+  struct stat file_stat {};
+  if (fstat(file_.get(), &file_stat) != 0) {
+    throw std::runtime_error("Failed to open log file: " + log_file_name_);
+  }
+  const lsn_t file_end = static_cast<lsn_t>(file_stat.st_size);
+
+  size_t records = 0;
+  const lsn_t end_lsn =
+      ScanRecords(checkpoint_lsn_.load(), file_end, [&](const LogRecord&) {
+        records++;
+        return true;
+      });
+
+  if (end_lsn < file_end) {
+    LOG_WARNING_STREAM("LogManager: Truncating torn log tail at LSN "
+                       << end_lsn << " (" << file_end - end_lsn
+                       << " bytes)");
+    if (ftruncate(file_.get(), static_cast<off_t>(end_lsn)) != 0 ||
+        fdatasync(file_.get()) != 0) {
+      throw std::runtime_error("Failed to truncate log file: " +
+                               log_file_name_);
+    }
+  }
+
+  buffer_lsn_ = end_lsn;
+  next_lsn_ = end_lsn;
+  durable_lsn_ = end_lsn;
+  LOG_INFO_STREAM("LogManager: Opened " << log_file_name_ << " with "
+                                        << records
+                                        << " records after the checkpoint");
+}
+
+uint32_t LogManager::RecordCrc(const char* record, size_t size) {
+  // Same as the page checksum: the crc field counts as zero
+  const auto* data = reinterpret_cast<const uint8_t*>(record);
+  const size_t crc_offset = offsetof(LogRecordHeader, crc);
+  const uint32_t zero_crc = 0;
+
+  uint32_t crc = checksum::Init();
+  crc = checksum::Update(checksum::Algorithm::CRC32C, crc, data, crc_offset);
+  crc = checksum::Update(checksum::Algorithm::CRC32C, crc,
+                         reinterpret_cast<const uint8_t*>(&zero_crc),
+                         sizeof(zero_crc));
+  crc = checksum::Update(checksum::Algorithm::CRC32C, crc,
+                         data + crc_offset + sizeof(zero_crc),
+                         size - crc_offset - sizeof(zero_crc));
+  return checksum::Finalize(crc);
+}
@@ -0,0 +1,120 @@
+#include "../../include/storage/maintenance_worker.h"
+
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <stdexcept>
+
+#include "../../include/common/logger.h"
+
+namespace {
+
+// CPU time used by the calling thread, in milliseconds
+double ThreadCpuMillis() {
+  timespec ts{};
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+}  // namespace
+
+MaintenanceWorker::MaintenanceWorker(PageManager* page_manager,
+                                     uint32_t interval_ms,
+                                     size_t max_pages_per_round,
+                                     uint32_t max_round_ms,
+                                     size_t chain_pages_per_round)
+    : page_manager_(page_manager),
+      interval_ms_(interval_ms),
+      max_pages_per_round_(max_pages_per_round),
+      max_round_ms_(max_round_ms),
+      chain_pages_per_round_(chain_pages_per_round),
+      scratch_(std::make_unique<char[]>(PAGE_SIZE)),
+      chain_cursor_(1),
+      rounds_(0),
+      pages_compacted_(0),
+      chains_collapsed_(0),
+      stop_thread_(false) {
+  if (page_manager_ == nullptr) {
+    throw std::invalid_argument("PageManager cannot be null");
+  }
+  if (interval_ms_ == 0) {
+    throw std::invalid_argument("Maintenance interval must be positive");
+  }
+
+  thread_ = std::thread(&MaintenanceWorker::ThreadLoop, this);
+  LOG_INFO_STREAM("MaintenanceWorker: Started (every "
+                  << interval_ms_ << " ms, up to " << max_pages_per_round_
+                  << " pages / " << max_round_ms_ << " ms per round)");
+}
+
+MaintenanceWorker::~MaintenanceWorker() { Stop(); }
+
+void MaintenanceWorker::RunOnce() {
+  std::lock_guard<std::mutex> lock(round_mutex_);
+  const double deadline = ThreadCpuMillis() + max_round_ms_;
+
+  size_t compacted = 0;
+  for (page_id_t page_id :
+       page_manager_->FindCompactionCandidates(max_pages_per_round_)) {
+    if (ThreadCpuMillis() >= deadline) {
+      break;
+    }
+    if (page_manager_->CompactResidentPage(page_id, scratch_.get())) {
+      compacted++;
+    }
+  }
+
+  size_t collapsed = 0;
+  if (chain_pages_per_round_ > 0 && ThreadCpuMillis() < deadline) {
+    const page_id_t end_page_id =
+        page_manager_->GetDiskManager()->GetNextPageId();
+    if (chain_cursor_ >= end_page_id) {
+      chain_cursor_ = 1;  // wrap around to the first data page
+    }
+    const page_id_t stop_page_id = static_cast<page_id_t>(std::min<size_t>(
+        chain_cursor_ + chain_pages_per_round_, end_page_id));
+    collapsed =
+        page_manager_->CollapseForwardingChains(chain_cursor_, stop_page_id);
+    chain_cursor_ = stop_page_id;
+  }
+
+  rounds_++;
+  pages_compacted_ += compacted;
+  chains_collapsed_ += collapsed;
+  if (compacted > 0 || collapsed > 0) {
+    LOG_INFO_STREAM("MaintenanceWorker: Compacted "
+                    << compacted << " pages, collapsed " << collapsed
+                    << " chains");
+  }
+}
+
+void MaintenanceWorker::Stop() {
+  if (!thread_.joinable()) {
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(thread_mutex_);
+    stop_thread_ = true;
+  }
+  thread_cv_.notify_all();
+  thread_.join();
+}
+
+void MaintenanceWorker::ThreadLoop() {
+  std::unique_lock<std::mutex> lock(thread_mutex_);
+  while (!stop_thread_) {
+    thread_cv_.wait_for(lock, std::chrono::milliseconds(interval_ms_));
+    if (stop_thread_) {
+      break;
+    }
+
+    lock.unlock();
+    try {
+      RunOnce();
+    } catch (const std::exception& e) {
+      LOG_ERROR_STREAM("MaintenanceWorker: Round failed: " << e.what());
+    }
+    lock.lock();
+  }
+}
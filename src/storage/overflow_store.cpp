@@ -0,0 +1,159 @@
+#include "../../include/storage/overflow_store.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include "../../include/buffer/page_guard.h"
+#include "../../include/common/logger.h"
+
+namespace {
+
+OverflowPageHeader* ChainHeader(const Page* page) {
+  return reinterpret_cast<OverflowPageHeader*>(page->GetRawBuffer() +
+                                               sizeof(PageHeader));
+}
+
+char* ChunkData(const Page* page) {
+  return page->GetRawBuffer() + sizeof(PageHeader) +
+         sizeof(OverflowPageHeader);
+}
+
+}  // namespace
+
+OverflowStore::OverflowStore(BufferPoolManager* bpm) : bpm_(bpm) {
+  if (bpm_ == nullptr) {
+    throw std::invalid_argument("OverflowStore needs a buffer pool");
+  }
+}
+
+ErrorCode OverflowStore::Write(std::string_view value,
+                               OverflowPointer* pointer) {
+  if (pointer == nullptr) {
+    return {-1, "OverflowStore::Write: Pointer is null"};
+  }
+  if (value.empty() || value.size() > UINT32_MAX) {
+    return {-2, "OverflowStore::Write: Value is empty or too large"};
+  }
+
+  // Last chunk first, so each page can link to the one written before it
+  const size_t page_count = PagesFor(value.size());
+  std::vector<page_id_t> written;
+  written.reserve(page_count);
+  page_id_t next_page_id = INVALID_PAGE_ID;
+  for (size_t i = page_count; i-- > 0;) {
+    page_id_t page_id = INVALID_PAGE_ID;
+    Page* page = bpm_->NewPage(&page_id);
+    if (page == nullptr) {
+      LOG_ERROR_STREAM("OverflowStore::Write: Failed to allocate page "
+                       << page_count - i << " of " << page_count);
+      FreeChain(next_page_id, written.size());
+      return {-3, "OverflowStore::Write: Failed to allocate a page"};
+    }
+
+    PageGuard guard(bpm_, page_id, page, LatchMode::EXCLUSIVE);
+    const size_t begin = i * OVERFLOW_PAGE_CAPACITY;
+    const size_t chunk =
+        std::min(OVERFLOW_PAGE_CAPACITY, value.size() - begin);
+    page->SetPageType(PAGE_TYPE_OVERFLOW);
+    OverflowPageHeader* header = ChainHeader(page);
+    header->next_page_id = next_page_id;
+    header->value_length = static_cast<uint32_t>(value.size());
+    header->chunk_size = static_cast<uint16_t>(chunk);
+    header->reserved = 0;
+    std::memcpy(ChunkData(page), value.data() + begin, chunk);
+    guard.MarkDirty();
+
+    written.push_back(page_id);
+    next_page_id = page_id;
+  }
+
+  for (page_id_t page_id : written) {
+    ErrorCode flushed = bpm_->FlushPage(page_id);
+    if (flushed.code != 0) {
+      LOG_ERROR_STREAM("OverflowStore::Write: Failed to write page "
+                       << page_id << " (" << flushed.message << ")");
+      FreeChain(next_page_id, written.size());
+      return {-4, "OverflowStore::Write: Failed to write a page (" +
+                      flushed.message + ")"};
+    }
+  }
+
+  pointer->first_page_id = next_page_id;
+  pointer->length = static_cast<uint32_t>(value.size());
+  return {0, "OverflowStore::Write: Success"};
+}
+
+ErrorCode OverflowStore::Read(const OverflowPointer& pointer,
+                              std::string* value) const {
+  if (value == nullptr) {
+    return {-1, "OverflowStore::Read: Value is null"};
+  }
+
+  value->clear();
+  value->reserve(pointer.length);
+  const size_t page_count = PagesFor(pointer.length);
+  page_id_t page_id = pointer.first_page_id;
+  for (size_t i = 0; i < page_count; i++) {
+    if (page_id == INVALID_PAGE_ID) {
+      return {-2, "OverflowStore::Read: Chain ends early"};
+    }
+    PageGuard page(bpm_, page_id, bpm_->FetchPage(page_id), LatchMode::SHARED);
+    if (!page) {
+      LOG_ERROR_STREAM("OverflowStore::Read: Failed to fetch page "
+                       << page_id);
+      return {-3, "OverflowStore::Read: Failed to fetch page " +
+                      std::to_string(page_id)};
+    }
+
+    const OverflowPageHeader* header = ChainHeader(page.GetPage());
+    if (page->GetPageType() != PAGE_TYPE_OVERFLOW ||
+        header->value_length != pointer.length ||
+        header->chunk_size > OVERFLOW_PAGE_CAPACITY ||
+        header->chunk_size > pointer.length - value->size()) {
+      LOG_ERROR_STREAM("OverflowStore::Read: Page " << page_id
+                       << " is not part of a " << pointer.length
+                       << "-byte value");
+      return {-4, "OverflowStore::Read: Damaged chain at page " +
+                      std::to_string(page_id)};
+    }
+    value->append(ChunkData(page.GetPage()), header->chunk_size);
+    page_id = header->next_page_id;
+  }
+
+  if (value->size() != pointer.length || page_id != INVALID_PAGE_ID) {
+    return {-4, "OverflowStore::Read: Damaged chain at page " +
+                    std::to_string(pointer.first_page_id)};
+  }
+  return {0, "OverflowStore::Read: Success"};
+}
+
+ErrorCode OverflowStore::Free(const OverflowPointer& pointer) {
+  if (pointer.first_page_id == INVALID_PAGE_ID) {
+    return {-1, "OverflowStore::Free: Invalid pointer"};
+  }
+  FreeChain(pointer.first_page_id, PagesFor(pointer.length));
+  return {0, "OverflowStore::Free: Success"};
+}
+
+void OverflowStore::FreeChain(page_id_t first_page_id, size_t max_pages) {
+  page_id_t page_id = first_page_id;
+  for (size_t i = 0; i < max_pages && page_id != INVALID_PAGE_ID; i++) {
+    page_id_t next_page_id = INVALID_PAGE_ID;
+    {
+      PageGuard page(bpm_, page_id, bpm_->FetchPage(page_id),
+                     LatchMode::SHARED);
+      if (!page || page->GetPageType() != PAGE_TYPE_OVERFLOW) {
+        LOG_WARNING_STREAM("OverflowStore: Leaking chain at page "
+                           << page_id);
+        return;
+      }
+      next_page_id = ChainHeader(page.GetPage())->next_page_id;
+    }
+    if (!bpm_->DeletePage(page_id)) {
+      LOG_WARNING_STREAM("OverflowStore: Leaking page " << page_id);
+    }
+    page_id = next_page_id;
+  }
+}
@@ -0,0 +1,49 @@
+#include "../../include/storage/page_bitmap.h"
+
+PageBitmap::PageBitmap()
+    : chunks_(new std::atomic<std::atomic<uint64_t>*>[CHUNK_COUNT]()) {}
+
+PageBitmap::~PageBitmap() {
+  for (size_t i = 0; i < CHUNK_COUNT; i++) {
+    delete[] chunks_[i].load(std::memory_order_relaxed);
+  }
+}
+
+std::atomic<uint64_t>* PageBitmap::FindChunk(page_id_t page_id) const {
+  return chunks_[page_id / CHUNK_PAGES].load(std::memory_order_acquire);
+}
+
+bool PageBitmap::Test(page_id_t page_id) const {
+  const std::atomic<uint64_t>* chunk = FindChunk(page_id);
+  if (chunk == nullptr) {
+    return false;
+  }
+  const uint64_t bit = uint64_t{1} << (page_id % 64);
+  return (chunk[page_id % CHUNK_PAGES / 64].load(std::memory_order_acquire) &
+          bit) != 0;
+}
+
+void PageBitmap::Set(page_id_t page_id) {
+  std::atomic<std::atomic<uint64_t>*>& slot = chunks_[page_id / CHUNK_PAGES];
+  std::atomic<uint64_t>* chunk = slot.load(std::memory_order_acquire);
+  if (chunk == nullptr) {
+    // Racing first setters both allocate; the loser frees its chunk
+    auto* fresh = new std::atomic<uint64_t>[CHUNK_WORDS]();
+    if (slot.compare_exchange_strong(chunk, fresh,
+                                     std::memory_order_acq_rel)) {
+      chunk = fresh;
+    } else {
+      delete[] fresh;
+    }
+  }
+  chunk[page_id % CHUNK_PAGES / 64].fetch_or(uint64_t{1} << (page_id % 64),
+                                             std::memory_order_release);
+}
+
+void PageBitmap::Clear(page_id_t page_id) {
+  std::atomic<uint64_t>* chunk = FindChunk(page_id);
+  if (chunk != nullptr) {
+    chunk[page_id % CHUNK_PAGES / 64].fetch_and(
+        ~(uint64_t{1} << (page_id % 64)), std::memory_order_release);
+  }
+}
@@ -1,11 +1,74 @@
 #include "../../include/storage/page_manager.h"
 
+#include <algorithm>
 #include <cstring>
+#include <utility>
 
 #include "../../include/common/logger.h"
+#include "../../include/common/trace.h"
+#include "../../include/index/table_index.h"
+#include "../../include/tuple/tuple_serializer.h"
 
-PageManager::PageManager(DiskManager* disk_manager, FreeSpaceMap* fsm)
-    : disk_manager_(disk_manager), fsm_(fsm) {
+namespace {
+
+LogRecordType InsertRecordType(uint8_t slot_flags) {
+  return (slot_flags & SLOT_COMPRESSED) ? LogRecordType::INSERT_COMPRESSED
+                                        : LogRecordType::INSERT;
+}
+
+LogRecordType UpdateRecordType(uint8_t slot_flags) {
+  return (slot_flags & SLOT_COMPRESSED) ? LogRecordType::UPDATE_COMPRESSED
+                                        : LogRecordType::UPDATE;
+}
+
+uint8_t SlotFlagsFor(LogRecordType type) {
+  return type == LogRecordType::INSERT_COMPRESSED ||
+                 type == LogRecordType::UPDATE_COMPRESSED
+             ? SLOT_COMPRESSED
+             : 0;
+}
+
+// Compressed forms of single-tuple writes, per thread
+char* CompressionScratch() {
+  thread_local std::vector<char> scratch(PAGE_SIZE);
+  return scratch.data();
+}
+
+// Brackets a tuple change for the zone map (see ZoneMap::BeginChange())
+class ZoneMapChange {
+ public:
+  explicit ZoneMapChange(ZoneMap* zone_map)
+      : zone_map_(zone_map),
+        ok_(zone_map_ == nullptr || zone_map_->BeginChange()) {}
+  ~ZoneMapChange() {
+    if (zone_map_ != nullptr && ok_) {
+      zone_map_->EndChange();
+    }
+  }
+
+  ZoneMapChange(const ZoneMapChange&) = delete;
+  ZoneMapChange& operator=(const ZoneMapChange&) = delete;
+
+  bool ok() const { return ok_; }
+
+ private:
+  ZoneMap* zone_map_;
+  bool ok_;
+};
+
+}  // namespace
+
+PageManager::PageManager(DiskManager* disk_manager, FreeSpaceMap* fsm,
+                         size_t buffer_pool_size_mb,
+                         ReplacerType replacer_type, LogManager* log_manager)
+    : disk_manager_(disk_manager),
+      fsm_(fsm),
+      log_manager_(log_manager),
+      compressor_(nullptr),
+      overflow_store_(nullptr),
+      zone_map_(nullptr),
+      fill_factor_(DEFAULT_TABLE_FILL_FACTOR),
+      reserved_space_(0) {
   if (disk_manager_ == nullptr) {
     LOG_ERROR("PageManager: DiskManager is null");
     throw std::invalid_argument("DiskManager cannot be null");
@@ -22,17 +85,30 @@ PageManager::PageManager(DiskManager* disk_manager, FreeSpaceMap* fsm)
     throw std::runtime_error("Failed to initialize FreeSpaceMap");
   }
 
+  buffer_pool_ = std::make_unique<BufferPoolManager>(
+      BufferPoolManager::FramesForMemoryBudget(buffer_pool_size_mb),
+      disk_manager_, replacer_type);
+
+  if (log_manager_ != nullptr) {
+    buffer_pool_->SetLogManager(log_manager_);
+    ErrorCode result = Recover();
+    if (result.code != 0) {
+      LOG_ERROR_STREAM("PageManager: Recovery failed (" << result.message
+                                                        << ")");
+      throw std::runtime_error("Failed to recover from write-ahead log");
+    }
+  }
+
   LOG_INFO("PageManager: Initialized successfully");
 }
 
 PageManager::~PageManager() {
   LOG_INFO("PageManager: Flushing all pages before destruction");
-  FlushAllPages();
+  Checkpoint();
 }
 
 TupleId PageManager::InsertTuple(const char* tuple_data, uint16_t tuple_size) {
-  std::lock_guard<std::mutex> lock(cache_mutex_);
-
+  TRACE_SPAN("PageManager::InsertTuple");
   if (tuple_data == nullptr) {
     LOG_ERROR("PageManager::InsertTuple: Tuple data is null");
     return {0, INVALID_SLOT_ID};
@@ -49,33 +125,50 @@ TupleId PageManager::InsertTuple(const char* tuple_data, uint16_t tuple_size) {
     return {0, INVALID_SLOT_ID};
   }
 
-  uint16_t required_space = tuple_size + SLOT_ENTRY_SIZE;
+  ZoneMapChange change(zone_map_);
+  if (!change.ok()) {
+    return {0, INVALID_SLOT_ID};
+  }
+
+  const StoredTuple stored =
+      StoredForm(tuple_data, tuple_size, CompressionScratch());
+  uint16_t required_space = stored.size + SLOT_ENTRY_SIZE;
 
-  Page* page = nullptr;
+  PageGuard page;
   page_id_t page_id = INVALID_PAGE_ID;
   slot_id_t slot_id = INVALID_SLOT_ID;
 
-  // Try up to 3 times to find a page with space
-  // FSM approximation may return pages without enough actual space
-  for (int attempt = 0; attempt < 3 && slot_id == INVALID_SLOT_ID; attempt++) {
-    page_id = FindPageWithSpace(required_space);
+  // Try up to 3 times to find a page with space.
+  // FSM approximation may return pages without enough actual space, and
+  // concurrent inserters may race for the same candidate, so the last
+  // attempt always goes to a fresh page.
+  const int max_attempts = 3;
+  for (int attempt = 0; attempt < max_attempts && slot_id == INVALID_SLOT_ID;
+       attempt++) {
+    // Drop the previous candidate before latching the next one
+    page.Release();
+    page_id = attempt + 1 < max_attempts ? FindPageWithSpace(required_space)
+                                         : INVALID_PAGE_ID;
 
     if (page_id == INVALID_PAGE_ID) {
-      page_id = AllocateNewPage();
-      if (page_id == INVALID_PAGE_ID) {
+      page = AllocateNewPage();
+      if (!page) {
         LOG_ERROR("PageManager::InsertTuple: Failed to allocate new page");
         return {0, INVALID_SLOT_ID};
       }
+      page_id = page.GetPageId();
+    } else {
+      page = GetPage(page_id, LatchMode::EXCLUSIVE);
     }
 
-    page = GetPage(page_id);
-    if (page == nullptr) {
+    if (!page) {
       LOG_ERROR_STREAM("PageManager::InsertTuple: Failed to get page "
                        << page_id);
       return {0, INVALID_SLOT_ID};
     }
 
-    slot_id = page->InsertTuple(tuple_data, tuple_size);
+    slot_id = page->InsertTuple(stored.data, stored.size, stored.slot_flags,
+                                reserved_space_);
 
     if (slot_id == INVALID_SLOT_ID) {
       // Try compacting if the page has fragmentation
@@ -83,9 +176,13 @@ TupleId PageManager::InsertTuple(const char* tuple_data, uint16_t tuple_size) {
         LOG_INFO_STREAM("PageManager::InsertTuple: Compacting page "
                         << page_id << " to reclaim fragmented space");
         page->CompactPage();
+        compactions_.Add();
+        page.MarkDirty();
+        LogChange(page, LogRecordType::COMPACT, INVALID_SLOT_ID);
 
         // Try inserting again after compaction
-        slot_id = page->InsertTuple(tuple_data, tuple_size);
+        slot_id = page->InsertTuple(stored.data, stored.size,
+                                    stored.slot_flags, reserved_space_);
 
         if (slot_id != INVALID_SLOT_ID) {
           LOG_INFO_STREAM(
@@ -107,18 +204,185 @@ TupleId PageManager::InsertTuple(const char* tuple_data, uint16_t tuple_size) {
     return {0, INVALID_SLOT_ID};
   }
 
-  UpdateFSM(page_id, page);
+  page.MarkDirty();
+  LogChange(page, InsertRecordType(stored.slot_flags), slot_id, stored.data,
+            stored.size);
+  UpdateFSM(page_id, page.GetPage());
+  page.Release();
+
+  if (Commit().code != 0) {
+    return {0, INVALID_SLOT_ID};
+  }
+
+  const TupleId tuple_id{page_id, slot_id};
+  ErrorCode indexed = IndexNewTuple(tuple_data, tuple_size, tuple_id);
+  if (indexed.code != 0) {
+    LOG_ERROR_STREAM("PageManager::InsertTuple: Not indexed ("
+                     << indexed.message << "), removing the tuple");
+    DeleteTupleData(tuple_id);
+    return {0, INVALID_SLOT_ID};
+  }
+  SummarizeNewTuple(page_id, tuple_data, tuple_size);
 
   LOG_INFO_STREAM("PageManager::InsertTuple: Inserted tuple at page "
                   << page_id << ", slot " << slot_id);
 
-  return {page_id, slot_id};
+  return tuple_id;
+}
+
+std::vector<TupleId> PageManager::InsertTuples(const TupleSlice* tuples,
+                                               size_t count) {
+  std::vector<TupleId> tuple_ids(count, TupleId{0, INVALID_SLOT_ID});
+  if (tuples == nullptr) {
+    if (count > 0) {
+      LOG_ERROR("PageManager::InsertTuples: Tuple array is null");
+    }
+    return tuple_ids;
+  }
+
+  ZoneMapChange change(zone_map_);
+  if (!change.ok()) {
+    return tuple_ids;
+  }
+
+  // Compressed forms of the whole batch, in an arena that never reallocates
+  // (no form is larger than its tuple)
+  std::vector<char> arena;
+  std::vector<StoredTuple> stored(count);
+  if (compressor_ != nullptr) {
+    size_t arena_size = 0;
+    for (size_t i = 0; i < count; i++) {
+      if (IsInsertableTuple(tuples[i])) {
+        arena_size += tuples[i].size;
+      }
+    }
+    arena.resize(arena_size);
+  }
+  size_t arena_used = 0;
+  for (size_t i = 0; i < count; i++) {
+    stored[i] = {tuples[i].data, tuples[i].size, 0};
+    if (compressor_ != nullptr && IsInsertableTuple(tuples[i])) {
+      stored[i] = StoredForm(tuples[i].data, tuples[i].size,
+                             arena.data() + arena_used);
+      if (stored[i].slot_flags & SLOT_COMPRESSED) {
+        arena_used += stored[i].size;
+      }
+    }
+  }
+
+  // FSM candidates that took no tuple at all (approximate categories, or a
+  // concurrent inserter got there first). After two, go to a fresh page.
+  const int max_failed_candidates = 2;
+  int failed_candidates = 0;
+  size_t next = 0;
+
+  while (true) {
+    while (next < count && !IsInsertableTuple(tuples[next])) {
+      LOG_ERROR_F("PageManager::InsertTuples: Skipping invalid tuple %zu "
+                  "(%u bytes)",
+                  next, static_cast<unsigned>(tuples[next].size));
+      next++;
+    }
+    if (next == count) {
+      break;
+    }
+
+    const uint16_t required_space = stored[next].size + SLOT_ENTRY_SIZE;
+    page_id_t page_id = failed_candidates < max_failed_candidates
+                            ? FindPageWithSpace(required_space)
+                            : INVALID_PAGE_ID;
+    PageGuard page = page_id == INVALID_PAGE_ID
+                         ? AllocateNewPage()
+                         : GetPage(page_id, LatchMode::EXCLUSIVE);
+    if (!page) {
+      LOG_ERROR("PageManager::InsertTuples: Failed to get a page");
+      return tuple_ids;
+    }
+    page_id = page.GetPageId();
+
+    // Fill this page until the next tuple does not fit
+    size_t inserted = 0;
+    bool compacted = false;
+    while (next < count) {
+      if (!IsInsertableTuple(tuples[next])) {
+        break;  // reported by the skip loop above
+      }
+      const StoredTuple& tuple = stored[next];
+
+      slot_id_t slot_id = page->InsertTuple(tuple.data, tuple.size,
+                                            tuple.slot_flags, reserved_space_);
+      if (slot_id == INVALID_SLOT_ID && !compacted && page->ShouldCompact()) {
+        page->CompactPage();
+        compactions_.Add();
+        page.MarkDirty();
+        LogChange(page, LogRecordType::COMPACT, INVALID_SLOT_ID);
+        compacted = true;
+        slot_id = page->InsertTuple(tuple.data, tuple.size, tuple.slot_flags,
+                                    reserved_space_);
+      }
+      if (slot_id == INVALID_SLOT_ID) {
+        break;
+      }
+
+      LogChange(page, InsertRecordType(tuple.slot_flags), slot_id, tuple.data,
+                tuple.size);
+      tuple_ids[next] = {page_id, slot_id};
+      next++;
+      inserted++;
+    }
+
+    if (inserted > 0) {
+      page.MarkDirty();
+      failed_candidates = 0;
+    } else {
+      failed_candidates++;
+    }
+    // One FSM update per page, with its real free space
+    UpdateFSM(page_id, page.GetPage());
+
+    LOG_INFO_F("PageManager::InsertTuples: Inserted %zu tuples into page %u",
+               inserted, static_cast<unsigned>(page_id));
+  }
+
+  // One group commit for the whole batch
+  if (Commit().code != 0) {
+    std::fill(tuple_ids.begin(), tuple_ids.end(),
+              TupleId{0, INVALID_SLOT_ID});
+    return tuple_ids;
+  }
+
+  for (size_t i = 0; i < count && !indexes_.empty(); i++) {
+    if (tuple_ids[i].slot_id == INVALID_SLOT_ID) {
+      continue;
+    }
+    ErrorCode indexed =
+        IndexNewTuple(tuples[i].data, tuples[i].size, tuple_ids[i]);
+    if (indexed.code != 0) {
+      LOG_ERROR_STREAM("PageManager::InsertTuples: Tuple " << i
+                       << " not indexed (" << indexed.message
+                       << "), removing it");
+      DeleteTupleData(tuple_ids[i]);
+      tuple_ids[i] = {0, INVALID_SLOT_ID};
+    }
+  }
+  // A page summarized whole already covers the rest of its batch tuples
+  page_id_t summarized_page_id = INVALID_PAGE_ID;
+  for (size_t i = 0; i < count && zone_map_ != nullptr; i++) {
+    const page_id_t page_id = tuple_ids[i].page_id;
+    if (tuple_ids[i].slot_id == INVALID_SLOT_ID ||
+        page_id == summarized_page_id) {
+      continue;
+    }
+    if (SummarizeNewTuple(page_id, tuples[i].data, tuples[i].size)) {
+      summarized_page_id = page_id;
+    }
+  }
+  return tuple_ids;
 }
 
 ErrorCode PageManager::GetTuple(TupleId tuple_id, char* buffer,
                                 uint16_t buffer_size) const {
-  std::lock_guard<std::mutex> lock(cache_mutex_);
-
+  TRACE_SPAN("PageManager::GetTuple");
   if (buffer == nullptr) {
     LOG_ERROR("PageManager::GetTuple: Buffer is null");
     return {-1, "PageManager::GetTuple: Buffer is null"};
@@ -129,7 +393,8 @@ ErrorCode PageManager::GetTuple(TupleId tuple_id, char* buffer,
     return {-2, "PageManager::GetTuple: Buffer size is zero"};
   }
 
-  TupleId final_tuple_id = FollowForwardingChainFull(tuple_id);
+  PageGuard page;
+  TupleId final_tuple_id = FollowForwardingChainFull(tuple_id, nullptr, &page);
 
   if (final_tuple_id.page_id == 0 && final_tuple_id.slot_id == 0) {
     LOG_ERROR_STREAM("PageManager::GetTuple: Invalid tuple or circular chain "
@@ -140,21 +405,236 @@ ErrorCode PageManager::GetTuple(TupleId tuple_id, char* buffer,
             "chain"};
   }
 
-  Page* page = const_cast<PageManager*>(this)->GetPage(final_tuple_id.page_id);
+  return GetTupleFromSlot(page.GetPage(), final_tuple_id.slot_id, buffer,
+                          buffer_size);
+}
 
-  if (page == nullptr) {
-    LOG_ERROR_STREAM("PageManager::GetTuple: Failed to get page "
-                     << final_tuple_id.page_id);
-    return {-4, "PageManager::GetTuple: Failed to get page"};
+ErrorCode PageManager::GetTupleView(TupleId tuple_id,
+                                    PinnedTuple* tuple) const {
+  if (tuple == nullptr) {
+    LOG_ERROR("PageManager::GetTupleView: Output view is null");
+    return {-1, "PageManager::GetTupleView: Output view is null"};
+  }
+  tuple->Release();
+
+  PageGuard page;
+  TupleId final_tuple_id = FollowForwardingChainFull(tuple_id, nullptr, &page);
+
+  if (final_tuple_id.page_id == 0 && final_tuple_id.slot_id == 0) {
+    LOG_ERROR_STREAM("PageManager::GetTupleView: Invalid tuple or circular "
+                     << "chain at page " << tuple_id.page_id << ", slot "
+                     << tuple_id.slot_id);
+    return {-3,
+            "PageManager::GetTupleView: Invalid tuple ID or circular "
+            "forwarding chain"};
+  }
+
+  if (!page->IsSlotValid(final_tuple_id.slot_id)) {
+    LOG_ERROR_STREAM("PageManager::GetTupleView: Slot "
+                     << final_tuple_id.slot_id << " is not valid");
+    return {-2, "PageManager::GetTupleView: Slot is not valid"};
+  }
+
+  const SlotEntry& slot_entry = page->GetSlotEntry(final_tuple_id.slot_id);
+  const char* data = page->GetRawBuffer() + slot_entry.offset;
+
+  if (slot_entry.flags & SLOT_COMPRESSED) {
+    // No bytes to point at: hand out a decompressed copy instead
+    std::vector<char> copy(TupleCompressor::RawSize(data, slot_entry.length));
+    uint16_t size = 0;
+    ErrorCode result = GetTupleCompressor().Decompress(
+        data, slot_entry.length, copy.data(), copy.size(), &size);
+    if (result.code != 0) {
+      LOG_ERROR_STREAM("PageManager::GetTupleView: Cannot decompress slot "
+                       << final_tuple_id.slot_id << " (" << result.message
+                       << ")");
+      return {-5, "PageManager::GetTupleView: Cannot decompress tuple (" +
+                      result.message + ")"};
+    }
+    *tuple = PinnedTuple(final_tuple_id, std::move(copy));
+    return {0, "PageManager::GetTupleView: Success (decompressed)"};
   }
 
-  return GetTupleFromSlot(page, final_tuple_id.slot_id, buffer, buffer_size);
+  *tuple = PinnedTuple(std::move(page), final_tuple_id, data,
+                       slot_entry.length);
+
+  return {0, "PageManager::GetTupleView: Success"};
+}
+
+size_t PageManager::GetTuples(const TupleId* tuple_ids, size_t count,
+                              std::vector<char>* buffer,
+                              std::vector<TupleSlice>* tuples) const {
+  TRACE_SPAN("PageManager::GetTuples");
+  if (buffer == nullptr || tuples == nullptr) {
+    LOG_ERROR("PageManager::GetTuples: Output is null");
+    return 0;
+  }
+  buffer->clear();
+  tuples->assign(count, TupleSlice{nullptr, 0});
+  if (tuple_ids == nullptr) {
+    return 0;
+  }
+
+  std::vector<size_t> pending;  // into tuple_ids
+  pending.reserve(count);
+  for (size_t i = 0; i < count; i++) {
+    if (tuple_ids[i].page_id != INVALID_PAGE_ID &&
+        tuple_ids[i].slot_id != INVALID_SLOT_ID) {
+      pending.push_back(i);
+    }
+  }
+  std::sort(pending.begin(), pending.end(), [&](size_t a, size_t b) {
+    return tuple_ids[a].page_id != tuple_ids[b].page_id
+               ? tuple_ids[a].page_id < tuple_ids[b].page_id
+               : tuple_ids[a].slot_id < tuple_ids[b].slot_id;
+  });
+
+  // Offsets into *buffer; the slices point there once it stops growing
+  std::vector<size_t> offsets(count, 0);
+  size_t found = 0;
+  // Append the tuple in slot_id of the latched page as tuple index's
+  auto copy_slot = [&](size_t index, const Page* page, slot_id_t slot_id) {
+    const SlotEntry& entry = page->GetSlotEntry(slot_id);
+    const char* data = page->GetRawBuffer() + entry.offset;
+    const size_t offset = buffer->size();
+    uint16_t size = entry.length;
+    if (entry.flags & SLOT_COMPRESSED) {
+      buffer->resize(offset + TupleCompressor::RawSize(data, entry.length));
+      ErrorCode result = GetTupleCompressor().Decompress(
+          data, entry.length, buffer->data() + offset,
+          buffer->size() - offset, &size);
+      if (result.code != 0) {
+        LOG_ERROR_STREAM("PageManager::GetTuples: Cannot decompress slot "
+                         << slot_id << " (" << result.message << ")");
+        buffer->resize(offset);
+        return;
+      }
+    } else {
+      buffer->insert(buffer->end(), data, data + size);
+    }
+    offsets[index] = offset;
+    (*tuples)[index].size = size;
+    found++;
+  };
+
+  // Forwarded tuples, resolved one by one once the batch is read
+  std::vector<size_t> forwarded;
+  const size_t max_pages =
+      std::max<size_t>(1, buffer_pool_->GetPoolSize() / 2);
+  for (size_t begin = 0; begin < pending.size();) {
+    // Up to max_pages distinct pages per batch
+    std::vector<page_id_t> page_ids;
+    size_t end = begin;
+    for (; end < pending.size(); end++) {
+      const page_id_t page_id = tuple_ids[pending[end]].page_id;
+      if (page_ids.empty() || page_ids.back() != page_id) {
+        if (page_ids.size() == max_pages) {
+          break;
+        }
+        page_ids.push_back(page_id);
+      }
+    }
+
+    std::vector<Page*> pages = buffer_pool_->FetchPages(page_ids);
+    size_t next = begin;
+    for (size_t p = 0; p < page_ids.size(); p++) {
+      // Already pinned (or null): latch one page at a time
+      PageGuard page(buffer_pool_.get(), page_ids[p], pages[p],
+                     LatchMode::SHARED);
+      for (; next < end && tuple_ids[pending[next]].page_id == page_ids[p];
+           next++) {
+        const size_t index = pending[next];
+        const slot_id_t slot_id = tuple_ids[index].slot_id;
+        if (!page || !page->IsSlotValid(slot_id)) {
+          LOG_ERROR_STREAM("PageManager::GetTuples: No tuple at page "
+                           << page_ids[p] << ", slot " << slot_id);
+          continue;
+        }
+        if (page->IsSlotForwarded(slot_id)) {
+          forwarded.push_back(index);
+          continue;
+        }
+        copy_slot(index, page.GetPage(), slot_id);
+      }
+    }
+    begin = end;
+  }
+
+  // A stub read in one batch could be repointed and its target freed and
+  // reused before a later batch got to the target, so each forwarded
+  // tuple is read at the end of its chain while the chain is latched
+  for (size_t index : forwarded) {
+    PageGuard page;
+    const TupleId final_tuple_id =
+        FollowForwardingChainFull(tuple_ids[index], nullptr, &page);
+    if (final_tuple_id.page_id != INVALID_PAGE_ID) {
+      copy_slot(index, page.GetPage(), final_tuple_id.slot_id);
+    }
+  }
+
+  for (size_t i = 0; i < count; i++) {
+    if ((*tuples)[i].size != 0) {
+      (*tuples)[i].data = buffer->data() + offsets[i];
+    }
+  }
+  return found;
 }
 
 ErrorCode PageManager::UpdateTuple(TupleId tuple_id, const char* new_data,
                                    uint16_t new_size) {
-  std::lock_guard<std::mutex> lock(cache_mutex_);
+  if ((indexes_.empty() && overflow_store_ == nullptr &&
+       zone_map_ == nullptr) ||
+      new_data == nullptr || new_size == 0) {
+    return UpdateTupleData(tuple_id, new_data, new_size);
+  }
+
+  ZoneMapChange change(zone_map_);
+  if (!change.ok()) {
+    return {-13, "PageManager::UpdateTuple: Failed to prepare the zone map"};
+  }
+
+  std::vector<char> old_tuple;
+  ErrorCode read = CopyTuple(tuple_id, &old_tuple);
+  if (read.code != 0) {
+    return {-11, "PageManager::UpdateTuple: Failed to read the tuple (" +
+                     read.message + ")"};
+  }
+  const uint16_t old_size = static_cast<uint16_t>(old_tuple.size());
+  const page_id_t old_page_id = FollowForwardingChainFull(tuple_id).page_id;
+
+  // Index the new key first so a unique index can still refuse it
+  for (size_t i = 0; i < indexes_.size(); i++) {
+    ErrorCode result = indexes_[i]->BeginUpdate(
+        old_tuple.data(), old_size, new_data, new_size, tuple_id);
+    if (result.code != 0) {
+      while (i-- > 0) {
+        indexes_[i]->FinishUpdate(old_tuple.data(), old_size, new_data,
+                                  new_size, tuple_id, false);
+      }
+      return {-12, "PageManager::UpdateTuple: Index rejected the new key (" +
+                       result.message + ")"};
+    }
+  }
+
+  ErrorCode result = UpdateTupleData(tuple_id, new_data, new_size);
+  for (TableIndex* index : indexes_) {
+    index->FinishUpdate(old_tuple.data(), old_size, new_data, new_size,
+                        tuple_id, result.code == 0);
+  }
+  if (result.code == 0) {
+    FreeOverflowValues(old_tuple, new_data, new_size);
+    if (zone_map_ != nullptr) {
+      zone_map_->RemoveTuple(old_page_id, old_tuple.data(), old_size);
+      SummarizeNewTuple(FollowForwardingChainFull(tuple_id).page_id,
+                        new_data, new_size);
+    }
+  }
+  return result;
+}
 
+ErrorCode PageManager::UpdateTupleData(TupleId tuple_id, const char* new_data,
+                                       uint16_t new_size) {
+  TRACE_SPAN("PageManager::UpdateTuple");
   if (new_data == nullptr) {
     LOG_ERROR("PageManager::UpdateTuple: New data is null");
     return {-1, "PageManager::UpdateTuple: New data is null"};
@@ -165,7 +645,11 @@ ErrorCode PageManager::UpdateTuple(TupleId tuple_id, const char* new_data,
     return {-2, "PageManager::UpdateTuple: New size is zero"};
   }
 
-  TupleId current_tuple_id = FollowForwardingChainFull(tuple_id);
+  const StoredTuple stored =
+      StoredForm(new_data, new_size, CompressionScratch());
+
+  std::vector<TupleId> stubs;
+  TupleId current_tuple_id = FollowForwardingChainFull(tuple_id, &stubs);
 
   if (current_tuple_id.page_id == 0 && current_tuple_id.slot_id == 0) {
     LOG_ERROR_STREAM("PageManager::UpdateTuple: Invalid tuple or circular "
@@ -176,55 +660,123 @@ ErrorCode PageManager::UpdateTuple(TupleId tuple_id, const char* new_data,
             "forwarding chain"};
   }
 
-  Page* current_page = GetPage(current_tuple_id.page_id);
+  PageGuard current_page =
+      GetPage(current_tuple_id.page_id, LatchMode::EXCLUSIVE);
 
-  if (current_page == nullptr) {
+  if (!current_page) {
     LOG_ERROR_STREAM("PageManager::UpdateTuple: Failed to get page "
                      << current_tuple_id.page_id);
     return {-4, "PageManager::UpdateTuple: Failed to get page"};
   }
 
-  ErrorCode result = current_page->UpdateTupleInPlace(current_tuple_id.slot_id,
-                                                      new_data, new_size);
+  // A tuple that grows stays on its page while the free space (the fill
+  // factor's reserve, above all) holds it; only growth moves free_start
+  const uint16_t free_start = current_page->GetFreeStart();
+  ErrorCode result = current_page->UpdateTuple(
+      current_tuple_id.slot_id, stored.data, stored.size, stored.slot_flags);
+  if (result.code == -8 && current_page->ShouldCompact()) {
+    current_page->CompactPage();
+    compactions_.Add();
+    current_page.MarkDirty();
+    LogChange(current_page, LogRecordType::COMPACT, INVALID_SLOT_ID);
+    result = current_page->UpdateTuple(current_tuple_id.slot_id, stored.data,
+                                       stored.size, stored.slot_flags);
+  }
 
   if (result.code == 0) {
-    UpdateFSM(current_tuple_id.page_id, current_page);
+    if (current_page->GetFreeStart() > free_start) {
+      moved_updates_.Add();
+    }
+    current_page.MarkDirty();
+    LogChange(current_page, UpdateRecordType(stored.slot_flags),
+              current_tuple_id.slot_id, stored.data, stored.size);
+    UpdateFSM(current_tuple_id.page_id, current_page.GetPage());
+    current_page.Release();
     LOG_INFO_STREAM("PageManager::UpdateTuple: Updated tuple in-place at page "
                     << current_tuple_id.page_id << ", slot "
                     << current_tuple_id.slot_id);
+
+    // A multi-hop chain left by older code: point home at the tuple
+    if (stubs.size() > 1) {
+      PageGuard home_page = GetPage(tuple_id.page_id, LatchMode::EXCLUSIVE);
+      if (home_page && home_page->MarkSlotForwarded(
+                           tuple_id.slot_id, current_tuple_id.page_id,
+                           current_tuple_id.slot_id)
+                               .code == 0) {
+        home_page.MarkDirty();
+        LogForward(home_page, tuple_id.slot_id, current_tuple_id);
+        UpdateFSM(tuple_id.page_id, home_page.GetPage());
+        home_page.Release();
+        FreeSlots(std::vector<TupleId>(stubs.begin() + 1, stubs.end()));
+      }
+    }
+    if (Commit().code != 0) {
+      return {-10, "PageManager::UpdateTuple: Failed to commit"};
+    }
     return {0, "PageManager::UpdateTuple: Success (in-place)"};
   }
 
   LOG_INFO_STREAM("PageManager::UpdateTuple: In-place update failed ("
                   << result.message << "), creating forwarding chain");
+  current_page.Release();
+  forwarded_updates_.Add();
 
-  uint16_t required_space = new_size + SLOT_ENTRY_SIZE;
+  uint16_t required_space = stored.size + SLOT_ENTRY_SIZE;
   page_id_t new_page_id = FindPageWithSpace(required_space);
+  const bool from_fsm = new_page_id != INVALID_PAGE_ID;
 
-  if (new_page_id == INVALID_PAGE_ID) {
-    new_page_id = AllocateNewPage();
-    if (new_page_id == INVALID_PAGE_ID) {
+  PageGuard new_page;
+  if (!from_fsm) {
+    new_page = AllocateNewPage();
+    if (!new_page) {
       LOG_ERROR("PageManager::UpdateTuple: Failed to allocate new page");
       return {-5, "PageManager::UpdateTuple: Failed to allocate new page"};
     }
+    new_page_id = new_page.GetPageId();
+  } else {
+    new_page = GetPage(new_page_id, LatchMode::EXCLUSIVE);
   }
 
-  Page* new_page = GetPage(new_page_id);
-  if (new_page == nullptr) {
+  if (!new_page) {
     LOG_ERROR_STREAM("PageManager::UpdateTuple: Failed to get new page "
                      << new_page_id);
     return {-6, "PageManager::UpdateTuple: Failed to get new page"};
   }
 
-  slot_id_t new_slot_id = new_page->InsertTuple(new_data, new_size);
+  slot_id_t new_slot_id = new_page->InsertTuple(
+      stored.data, stored.size, stored.slot_flags, reserved_space_);
+
+  // The FSM is approximate and concurrent writers may have filled the
+  // candidate since the lookup: mark it full and retry on a fresh page
+  if (new_slot_id == INVALID_SLOT_ID && from_fsm) {
+    fsm_->UpdatePageFreeSpace(new_page_id, 0);
+    new_page.Release();
+    new_page = AllocateNewPage();
+    if (!new_page) {
+      LOG_ERROR("PageManager::UpdateTuple: Failed to allocate new page");
+      return {-5, "PageManager::UpdateTuple: Failed to allocate new page"};
+    }
+    new_page_id = new_page.GetPageId();
+    new_slot_id = new_page->InsertTuple(stored.data, stored.size,
+                                        stored.slot_flags, reserved_space_);
+  }
 
   if (new_slot_id == INVALID_SLOT_ID) {
     LOG_ERROR("PageManager::UpdateTuple: Failed to insert new version");
     return {-7, "PageManager::UpdateTuple: Failed to insert new version"};
   }
-
-  Page* original_page = GetPage(tuple_id.page_id);
-  if (original_page == nullptr) {
+  new_page.MarkDirty();
+  LogChange(new_page, InsertRecordType(stored.slot_flags), new_slot_id,
+            stored.data, stored.size);
+  UpdateFSM(new_page_id, new_page.GetPage());
+
+  // Never hold two page latches at once: two updates forwarding in opposite
+  // directions would otherwise deadlock. Readers of the original slot keep
+  // seeing the old version until it is forwarded below.
+  new_page.Release();
+
+  PageGuard original_page = GetPage(tuple_id.page_id, LatchMode::EXCLUSIVE);
+  if (!original_page) {
     LOG_ERROR_STREAM("PageManager::UpdateTuple: Failed to get original page "
                      << tuple_id.page_id);
     return {-8, "PageManager::UpdateTuple: Failed to get original page"};
@@ -236,24 +788,85 @@ ErrorCode PageManager::UpdateTuple(TupleId tuple_id, const char* new_data,
   if (forward_result.code != 0) {
     LOG_ERROR_STREAM("PageManager::UpdateTuple: Failed to mark slot forwarded ("
                      << forward_result.message << ")");
+    // Drop the new version so the tuple is not visible twice
+    original_page.Release();
+    if (PageGuard orphan = GetPage(new_page_id, LatchMode::EXCLUSIVE)) {
+      if (orphan->DeleteTuple(new_slot_id).code == 0) {
+        LogChange(orphan, LogRecordType::DELETE, new_slot_id);
+      }
+      orphan.MarkDirty();
+      UpdateFSM(new_page_id, orphan.GetPage());
+    }
     return {-9, "PageManager::UpdateTuple: Failed to mark slot forwarded"};
   }
-
-  UpdateFSM(tuple_id.page_id, original_page);
-  UpdateFSM(new_page_id, new_page);
+  original_page.MarkDirty();
+  LogForward(original_page, tuple_id.slot_id, {new_page_id, new_slot_id});
+
+  UpdateFSM(tuple_id.page_id, original_page.GetPage());
+  original_page.Release();
+
+  // Home now points straight at the new version: the previous version and
+  // any stubs between them are unreachable
+  if (current_tuple_id != tuple_id) {
+    std::vector<TupleId> unreachable(stubs.begin() + 1, stubs.end());
+    unreachable.push_back(current_tuple_id);
+    FreeSlots(unreachable);
+  }
 
   LOG_INFO_STREAM(
       "PageManager::UpdateTuple: Created forwarding chain from page "
       << tuple_id.page_id << ", slot " << tuple_id.slot_id << " to page "
       << new_page_id << ", slot " << new_slot_id);
 
+  if (Commit().code != 0) {
+    return {-10, "PageManager::UpdateTuple: Failed to commit"};
+  }
   return {0, "PageManager::UpdateTuple: Success (forwarding chain created)"};
 }
 
 ErrorCode PageManager::DeleteTuple(TupleId tuple_id) {
-  std::lock_guard<std::mutex> lock(cache_mutex_);
+  if (indexes_.empty() && overflow_store_ == nullptr &&
+      zone_map_ == nullptr) {
+    return DeleteTupleData(tuple_id);
+  }
+
+  ZoneMapChange change(zone_map_);
+  if (!change.ok()) {
+    return {-5, "PageManager::DeleteTuple: Failed to prepare the zone map"};
+  }
 
-  TupleId current_tuple_id = FollowForwardingChainFull(tuple_id);
+  std::vector<char> old_tuple;
+  ErrorCode read = CopyTuple(tuple_id, &old_tuple);
+  if (read.code != 0) {
+    return {-4, "PageManager::DeleteTuple: Failed to read the tuple (" +
+                    read.message + ")"};
+  }
+  const page_id_t old_page_id = FollowForwardingChainFull(tuple_id).page_id;
+
+  ErrorCode result = DeleteTupleData(tuple_id);
+  if (result.code != 0) {
+    return result;
+  }
+  for (TableIndex* index : indexes_) {
+    ErrorCode removed = index->RemoveTuple(
+        old_tuple.data(), static_cast<uint16_t>(old_tuple.size()), tuple_id);
+    if (removed.code != 0) {
+      LOG_WARNING_STREAM("PageManager::DeleteTuple: Stale index entry ("
+                         << removed.message << ")");
+    }
+  }
+  FreeOverflowValues(old_tuple, nullptr, 0);
+  if (zone_map_ != nullptr) {
+    zone_map_->RemoveTuple(old_page_id, old_tuple.data(),
+                           static_cast<uint16_t>(old_tuple.size()));
+  }
+  return result;
+}
+
+ErrorCode PageManager::DeleteTupleData(TupleId tuple_id) {
+  TRACE_SPAN("PageManager::DeleteTuple");
+  std::vector<TupleId> stubs;
+  TupleId current_tuple_id = FollowForwardingChainFull(tuple_id, &stubs);
 
   if (current_tuple_id.page_id == 0 && current_tuple_id.slot_id == 0) {
     LOG_ERROR_STREAM("PageManager::DeleteTuple: Invalid tuple or circular "
@@ -264,9 +877,9 @@ ErrorCode PageManager::DeleteTuple(TupleId tuple_id) {
             "forwarding chain"};
   }
 
-  Page* page = GetPage(current_tuple_id.page_id);
+  PageGuard page = GetPage(current_tuple_id.page_id, LatchMode::EXCLUSIVE);
 
-  if (page == nullptr) {
+  if (!page) {
     LOG_ERROR_STREAM("PageManager::DeleteTuple: Failed to get page "
                      << current_tuple_id.page_id);
     return {-2, "PageManager::DeleteTuple: Failed to get page"};
@@ -280,7 +893,17 @@ ErrorCode PageManager::DeleteTuple(TupleId tuple_id) {
     return result;
   }
 
-  UpdateFSM(current_tuple_id.page_id, page);
+  page.MarkDirty();
+  LogChange(page, LogRecordType::DELETE, current_tuple_id.slot_id);
+  UpdateFSM(current_tuple_id.page_id, page.GetPage());
+  page.Release();
+
+  // Free the stubs too, or the home slot would dangle
+  FreeSlots(stubs);
+
+  if (Commit().code != 0) {
+    return {-3, "PageManager::DeleteTuple: Failed to commit"};
+  }
 
   LOG_INFO_STREAM("PageManager::DeleteTuple: Deleted tuple at page "
                   << current_tuple_id.page_id << ", slot "
@@ -289,19 +912,199 @@ ErrorCode PageManager::DeleteTuple(TupleId tuple_id) {
   return {0, "PageManager::DeleteTuple: Success"};
 }
 
-ErrorCode PageManager::FlushAllPagesInternal() {
-  LOG_INFO_STREAM("PageManager::FlushAllPages: Flushing " << page_cache_.size()
-                                                          << " pages");
+void PageManager::AttachIndex(TableIndex* index) {
+  if (index == nullptr) {
+    LOG_ERROR("PageManager::AttachIndex: Index is null");
+    return;
+  }
+  indexes_.push_back(index);
+}
+
+void PageManager::SetTupleCompressor(const TupleCompressor* compressor) {
+  compressor_ = compressor;
+}
+
+ErrorCode PageManager::SetFillFactor(uint8_t percent) {
+  if (percent < MIN_TABLE_FILL_FACTOR || percent > 100) {
+    LOG_ERROR_STREAM("PageManager::SetFillFactor: Fill factor "
+                     << static_cast<unsigned>(percent) << " out of range");
+    return {-1, "PageManager::SetFillFactor: Fill factor out of range"};
+  }
+  fill_factor_ = percent;
+  reserved_space_ = static_cast<uint16_t>(PAGE_SIZE * (100 - percent) / 100);
+  return {0, "PageManager::SetFillFactor: Success"};
+}
+
+const TupleCompressor& PageManager::GetTupleCompressor() const {
+  // Decodes dictionary-less stored forms, e.g. after the compressor is unset
+  static const TupleCompressor plain;
+  return compressor_ != nullptr ? *compressor_ : plain;
+}
+
+void PageManager::SetOverflowStore(const Schema& schema,
+                                   OverflowValueStore* store) {
+  overflow_schema_ = schema;
+  overflow_store_ = store;
+}
+
+void PageManager::FreeOverflowValues(const std::vector<char>& old_tuple,
+                                     const char* kept_tuple,
+                                     uint16_t kept_size) {
+  if (overflow_store_ == nullptr) {
+    return;
+  }
+
+  std::vector<OverflowPointer> old_values;
+  std::vector<OverflowPointer> kept_values;
+  try {
+    TupleSerializer::GetOverflowPointers(overflow_schema_, old_tuple.data(),
+                                         old_tuple.size(), &old_values);
+    if (kept_tuple != nullptr && !old_values.empty()) {
+      TupleSerializer::GetOverflowPointers(overflow_schema_, kept_tuple,
+                                           kept_size, &kept_values);
+    }
+  } catch (const std::runtime_error& e) {
+    LOG_WARNING_STREAM("PageManager: Not freeing out-of-line values of a "
+                       << "malformed tuple (" << e.what() << ")");
+    return;
+  }
+
+  for (const OverflowPointer& pointer : old_values) {
+    if (std::find(kept_values.begin(), kept_values.end(), pointer) !=
+        kept_values.end()) {
+      continue;
+    }
+    ErrorCode freed = overflow_store_->Free(pointer);
+    if (freed.code != 0) {
+      LOG_WARNING_STREAM("PageManager: Leaking an out-of-line value ("
+                         << freed.message << ")");
+    }
+  }
+}
+
+PageManager::StoredTuple PageManager::StoredForm(const char* tuple_data,
+                                                 uint16_t tuple_size,
+                                                 char* scratch) const {
+  if (compressor_ != nullptr) {
+    const uint16_t size =
+        compressor_->Compress(tuple_data, tuple_size, scratch, PAGE_SIZE);
+    if (size != 0) {
+      return {scratch, size, SLOT_COMPRESSED};
+    }
+  }
+  return {tuple_data, tuple_size, 0};
+}
+
+ErrorCode PageManager::IndexNewTuple(const char* tuple_data,
+                                     uint16_t tuple_size, TupleId tuple_id) {
+  for (size_t i = 0; i < indexes_.size(); i++) {
+    ErrorCode result = indexes_[i]->AddTuple(tuple_data, tuple_size, tuple_id);
+    if (result.code != 0) {
+      while (i-- > 0) {
+        indexes_[i]->RemoveTuple(tuple_data, tuple_size, tuple_id);
+      }
+      return result;
+    }
+  }
+  return {0, "PageManager::IndexNewTuple: Success"};
+}
+
+bool PageManager::SummarizeNewTuple(page_id_t page_id,
+                                    const char* tuple_data,
+                                    uint16_t tuple_size) {
+  if (zone_map_ == nullptr ||
+      zone_map_->AddTuple(page_id, tuple_data, tuple_size)) {
+    return false;
+  }
+  ErrorCode result = RebuildZoneMapPage(page_id);
+  if (result.code != 0) {
+    LOG_WARNING_STREAM("PageManager: Page " << page_id
+                       << " left out of the zone map (" << result.message
+                       << ")");
+  }
+  return true;
+}
 
-  for (auto& [page_id, page] : page_cache_) {
-    if (page != nullptr && page->IsDirty()) {
-      ErrorCode result = FlushPage(page_id);
+ErrorCode PageManager::RebuildZoneMap(page_id_t page_id) {
+  if (zone_map_ == nullptr) {
+    return {-1, "PageManager::RebuildZoneMap: No zone map set"};
+  }
+  ZoneMapChange change(zone_map_);
+  if (!change.ok()) {
+    return {-2, "PageManager::RebuildZoneMap: Failed to prepare the zone map"};
+  }
+  return RebuildZoneMapPage(page_id);
+}
+
+size_t PageManager::RebuildZoneMap() {
+  size_t rebuilt = 0;
+  const page_id_t end_page_id = disk_manager_->GetNextPageId();
+  for (page_id_t page_id = 1; page_id < end_page_id; page_id++) {
+    if (RebuildZoneMap(page_id).code == 0) {
+      rebuilt++;
+    }
+  }
+  return rebuilt;
+}
+
+ErrorCode PageManager::RebuildZoneMapPage(page_id_t page_id) {
+  PageGuard page = GetPage(page_id, LatchMode::SHARED);
+  if (!page) {
+    return {-3, "PageManager::RebuildZoneMap: Failed to get page"};
+  }
+
+  // Compressed tuples are decoded into one buffer; their data pointers are
+  // filled in once it stops growing
+  std::vector<TupleSlice> tuples;
+  std::vector<std::pair<size_t, size_t>> decompressed;  // index, offset
+  std::vector<char> buffer;
+  const TupleCompressor& compressor = GetTupleCompressor();
+  for (slot_id_t slot_id = 0; slot_id < page->GetSlotCount(); slot_id++) {
+    const SlotEntry& entry = page->GetSlotEntry(slot_id);
+    if (!(entry.flags & SLOT_VALID) || (entry.flags & SLOT_FORWARDED)) {
+      continue;
+    }
+    TupleSlice tuple{page->GetRawBuffer() + entry.offset, entry.length};
+    if (entry.flags & SLOT_COMPRESSED) {
+      const size_t offset = buffer.size();
+      buffer.resize(offset + PAGE_SIZE);
+      ErrorCode result =
+          compressor.Decompress(tuple.data, tuple.size, buffer.data() + offset,
+                                PAGE_SIZE, &tuple.size);
       if (result.code != 0) {
-        LOG_ERROR_STREAM("PageManager::FlushAllPages: Failed to flush page "
-                         << page_id << " (" << result.message << ")");
-        return result;
+        return {-4, "PageManager::RebuildZoneMap: Failed to decompress (" +
+                        result.message + ")"};
       }
+      buffer.resize(offset + tuple.size);
+      decompressed.emplace_back(tuples.size(), offset);
     }
+    tuples.push_back(tuple);
+  }
+  for (const auto& [index, offset] : decompressed) {
+    tuples[index].data = buffer.data() + offset;
+  }
+
+  // Still under the latch, so no write to the page slips in between
+  zone_map_->ResetPage(page_id, tuples.data(), tuples.size());
+  return {0, "PageManager::RebuildZoneMap: Success"};
+}
+
+ErrorCode PageManager::CopyTuple(TupleId tuple_id,
+                                 std::vector<char>* out) const {
+  PinnedTuple tuple;
+  ErrorCode result = GetTupleView(tuple_id, &tuple);
+  if (result.code == 0) {
+    out->assign(tuple.Data(), tuple.Data() + tuple.Size());
+  }
+  return result;
+}
+
+ErrorCode PageManager::FlushAllPagesInternal() {
+  ErrorCode result = buffer_pool_->FlushAllPages();
+  if (result.code != 0) {
+    LOG_ERROR_STREAM("PageManager::FlushAllPages: Failed to flush pages ("
+                     << result.message << ")");
+    return result;
   }
 
   if (!fsm_->Flush()) {
@@ -309,20 +1112,22 @@ ErrorCode PageManager::FlushAllPagesInternal() {
     return {-1, "PageManager::FlushAllPages: Failed to flush FSM"};
   }
 
+  if (zone_map_ != nullptr && !zone_map_->Flush()) {
+    LOG_ERROR("PageManager::FlushAllPages: Failed to flush the zone map");
+    return {-1, "PageManager::FlushAllPages: Failed to flush the zone map"};
+  }
+
   LOG_INFO("PageManager::FlushAllPages: All pages flushed successfully");
   return {0, "PageManager::FlushAllPages: Success"};
 }
 
 ErrorCode PageManager::FlushAllPages() {
-  std::lock_guard<std::mutex> lock(cache_mutex_);
   return FlushAllPagesInternal();
 }
 
 ErrorCode PageManager::CompactPage(page_id_t page_id) {
-  std::lock_guard<std::mutex> lock(cache_mutex_);
-
-  Page* page = GetPage(page_id);
-  if (page == nullptr) {
+  PageGuard page = GetPage(page_id, LatchMode::EXCLUSIVE);
+  if (!page) {
     LOG_ERROR_STREAM("PageManager::CompactPage: Failed to get page "
                      << page_id);
     return {-1, "PageManager::CompactPage: Failed to get page"};
@@ -335,7 +1140,10 @@ ErrorCode PageManager::CompactPage(page_id_t page_id) {
   }
 
   page->CompactPage();
-  UpdateFSM(page_id, page);
+  compactions_.Add();
+  page.MarkDirty();
+  LogChange(page, LogRecordType::COMPACT, INVALID_SLOT_ID);
+  UpdateFSM(page_id, page.GetPage());
 
   LOG_INFO_STREAM("PageManager::CompactPage: Successfully compacted page "
                   << page_id);
@@ -343,130 +1151,304 @@ ErrorCode PageManager::CompactPage(page_id_t page_id) {
 }
 
 size_t PageManager::GetCacheSize() const {
-  std::lock_guard<std::mutex> lock(cache_mutex_);
-  return page_cache_.size();
+  return buffer_pool_->GetResidentPageCount();
+}
+
+StorageMetrics PageManager::GetMetrics() const {
+  StorageMetrics metrics;
+  metrics.disk = disk_manager_->GetMetrics();
+  metrics.buffer_pool = buffer_pool_->GetMetrics();
+  metrics.fsm = fsm_->GetMetrics();
+  metrics.page_manager.forwarded_lookups = forwarded_lookups_.Get();
+  metrics.page_manager.forwarding_hops = forwarding_hops_.Get();
+  metrics.page_manager.compactions = compactions_.Get();
+  metrics.page_manager.moved_updates = moved_updates_.Get();
+  metrics.page_manager.forwarded_updates = forwarded_updates_.Get();
+  return metrics;
 }
 
 void PageManager::ClearCache() {
-  std::lock_guard<std::mutex> lock(cache_mutex_);
   FlushAllPagesInternal();
-  page_cache_.clear();
+  buffer_pool_->EvictAllPages();
   LOG_INFO("PageManager::ClearCache: Cache cleared");
 }
 
-Page* PageManager::GetPage(page_id_t page_id) {
-  // Check cache first
-  auto it = page_cache_.find(page_id);
-  if (it != page_cache_.end()) {
-    return it->second.get();
+PageGuard PageManager::GetPage(page_id_t page_id, LatchMode mode) const {
+  TRACE_SPAN("PageManager::GetPage");
+  Page* page = buffer_pool_->FetchPage(page_id);
+  if (page == nullptr) {
+    LOG_ERROR_STREAM("PageManager::GetPage: Failed to fetch page " << page_id);
+    return PageGuard();
   }
 
-  auto new_page = Page::CreateNew();
-  if (new_page == nullptr) {
-    LOG_ERROR_STREAM("PageManager::GetPage: Failed to create page object for "
-                     << page_id);
-    return nullptr;
+  return PageGuard(buffer_pool_.get(), page_id, page, mode);
+}
+
+PageGuard PageManager::AllocateNewPage() {
+  page_id_t page_id = INVALID_PAGE_ID;
+  Page* page = buffer_pool_->NewPage(&page_id);
+
+  if (page == nullptr) {
+    LOG_ERROR("PageManager::AllocateNewPage: Failed to allocate page");
+    return PageGuard();
   }
 
-  try {
-    disk_manager_->ReadPage(page_id, new_page->GetRawBuffer());
+  PageGuard guard(buffer_pool_.get(), page_id, page, LatchMode::EXCLUSIVE);
+  LogChange(guard, LogRecordType::NEW_PAGE, INVALID_SLOT_ID);
+  // Claim before publishing the free space so no other stream grabs it
+  fsm_->AssignInsertTarget(page_id);
+  UpdateFSM(page_id, page);
 
-    if (!new_page->VerifyChecksum()) {
-      LOG_ERROR_STREAM(
-          "PageManager::GetPage: Checksum verification failed for page "
-          << page_id);
-      return nullptr;
-    }
+  LOG_INFO_STREAM("PageManager::AllocateNewPage: Allocated new page "
+                  << page_id);
 
-    EvictPageIfNeeded();
+  return guard;
+}
 
-    Page* page_ptr = new_page.get();
-    page_cache_[page_id] = std::move(new_page);
+void PageManager::UpdateFSM(page_id_t page_id, Page* page) const {
+  if (page == nullptr) {
+    return;
+  }
+
+  // Net of the fill factor's reserve, which inserts cannot use
+  const uint16_t page_free_space = page->GetFreeEnd() - page->GetFreeStart();
+  const uint16_t free_space = page_free_space > reserved_space_
+                                  ? page_free_space - reserved_space_
+                                  : 0;
+  fsm_->UpdatePageFreeSpace(page_id, free_space);
 
-    LOG_INFO_STREAM("PageManager::GetPage: Loaded page " << page_id
-                                                         << " from disk");
-    return page_ptr;
+  LOG_INFO_F("PageManager::UpdateFSM: Updated FSM for page %u (free space: "
+             "%u bytes)",
+             static_cast<unsigned>(page_id), static_cast<unsigned>(free_space));
+}
 
-  } catch (const std::exception& e) {
-    LOG_ERROR_STREAM("PageManager::GetPage: Exception loading page "
-                     << page_id << ": " << e.what());
-    return nullptr;
+void PageManager::LogChange(const PageGuard& page, LogRecordType type,
+                            slot_id_t slot_id, const char* payload,
+                            uint16_t payload_size) {
+  if (log_manager_ == nullptr) {
+    return;
   }
+  const lsn_t lsn = log_manager_->AppendPageChange(
+      type, page.GetPageId(), slot_id, page->GetPageLsn(),
+      page->GetRawBuffer(), payload, payload_size);
+  page->SetPageLsn(lsn);
+}
+
+void PageManager::LogForward(const PageGuard& page, slot_id_t slot_id,
+                             TupleId target) {
+  const ForwardStub stub{target.page_id, target.slot_id};
+  LogChange(page, LogRecordType::FORWARD, slot_id,
+            reinterpret_cast<const char*>(&stub), sizeof(stub));
 }
 
-ErrorCode PageManager::FlushPage(page_id_t page_id) {
-  auto it = page_cache_.find(page_id);
-  if (it == page_cache_.end()) {
-    return {0, "PageManager::FlushPage: Page not in cache"};
+ErrorCode PageManager::Commit() {
+  if (log_manager_ == nullptr) {
+    return {0, "PageManager::Commit: No write-ahead log"};
+  }
+  ErrorCode result = log_manager_->FlushAll();
+  if (result.code != 0) {
+    LOG_ERROR_STREAM("PageManager::Commit: Log flush failed ("
+                     << result.message << ")");
   }
+  return result;
+}
 
-  Page* page = it->second.get();
-  if (page == nullptr) {
-    return {-1, "PageManager::FlushPage: Page is null"};
+ErrorCode PageManager::Checkpoint() {
+  if (log_manager_ == nullptr) {
+    return FlushAllPagesInternal();
   }
 
-  if (!page->IsDirty()) {
-    return {0, "PageManager::FlushPage: Page not dirty"};
+  // Changes logged before redo_lsn are on a page that is dirty now and is
+  // written below; anything later is replayed
+  const lsn_t redo_lsn = log_manager_->BeginCheckpoint();
+  ErrorCode result = FlushAllPagesInternal();
+  if (result.code != 0) {
+    return result;
   }
 
+  // Pages allocated since the last checkpoint have no NEW_PAGE record left
+  // to replay, so their ids must be durable in the file header
   try {
-    uint32_t checksum = page->ComputeChecksum();
-    page->SetChecksum(checksum);
-
-    disk_manager_->WritePage(page_id, page->GetRawBuffer());
-
-    LOG_INFO_STREAM("PageManager::FlushPage: Flushed page " << page_id);
-    return {0, "PageManager::FlushPage: Success"};
-
+    disk_manager_->SyncFileHeader();
   } catch (const std::exception& e) {
-    LOG_ERROR_STREAM("PageManager::FlushPage: Exception flushing page "
-                     << page_id << ": " << e.what());
-    return {-2, "PageManager::FlushPage: Exception: " + std::string(e.what())};
+    LOG_ERROR_STREAM("PageManager::Checkpoint: " << e.what());
+    return {-2, "PageManager::Checkpoint: Failed to sync file header"};
   }
+
+  log_manager_->Append(LogRecordType::CHECKPOINT, INVALID_PAGE_ID,
+                       INVALID_SLOT_ID);
+  result = log_manager_->FlushAll();
+  if (result.code != 0) {
+    return result;
+  }
+  return log_manager_->SetCheckpointLsn(redo_lsn);
 }
 
-page_id_t PageManager::AllocateNewPage() {
-  page_id_t page_id = disk_manager_->AllocatePage();
+ErrorCode PageManager::Recover() {
+  size_t replayed = 0;
+  bool failed = false;
+  ErrorCode result = log_manager_->ForEachRecord(
+      log_manager_->GetCheckpointLsn(), [&](const LogRecord& record) {
+        if (record.type == LogRecordType::CHECKPOINT) {
+          return true;
+        }
+        if (!RedoRecord(record)) {
+          LOG_ERROR_STREAM("PageManager::Recover: Cannot replay record at LSN "
+                           << record.lsn << " for page " << record.page_id);
+          failed = true;
+          return false;
+        }
+        replayed++;
+        return true;
+      });
+  if (result.code != 0) {
+    return result;
+  }
+  if (failed) {
+    return {-1, "PageManager::Recover: Log record could not be replayed"};
+  }
+
+  LOG_INFO_STREAM("PageManager::Recover: Replayed " << replayed
+                                                    << " log records");
+  return Checkpoint();
+}
 
+bool PageManager::RedoRecord(const LogRecord& record) {
+  const page_id_t page_id = record.page_id;
   if (page_id == INVALID_PAGE_ID) {
-    LOG_ERROR("PageManager::AllocateNewPage: Failed to allocate page ID");
-    return INVALID_PAGE_ID;
+    return false;
   }
 
-  auto new_page = Page::CreateNew();
-  if (new_page == nullptr) {
-    LOG_ERROR("PageManager::AllocateNewPage: Failed to create page object");
-    return INVALID_PAGE_ID;
+  // Pages allocated after the file header was last made durable
+  const page_id_t next_page_id = disk_manager_->GetNextPageId();
+  if (page_id >= next_page_id) {
+    disk_manager_->AllocatePages(page_id + 1 - next_page_id);
   }
 
-  new_page->SetPageId(page_id);
-
-  EvictPageIfNeeded();
-
-  page_cache_[page_id] = std::move(new_page);
+  // Whole-page records never fetch the page: it may be torn, or a new page
+  // that never reached the disk
+  if (record.type == LogRecordType::NEW_PAGE) {
+    return InstallPageImage(page_id, record.lsn, nullptr);
+  }
+  if (record.type == LogRecordType::PAGE_IMAGE) {
+    return record.payload_size == PAGE_SIZE &&
+           InstallPageImage(page_id, record.lsn, record.payload);
+  }
 
-  Page* page = page_cache_[page_id].get();
-  UpdateFSM(page_id, page);
+  PageGuard page = GetPage(page_id, LatchMode::EXCLUSIVE);
+  if (!page) {
+    return false;
+  }
+  if (page->GetPageLsn() >= record.lsn) {
+    return true;  // written back after this change
+  }
 
-  LOG_INFO_STREAM("PageManager::AllocateNewPage: Allocated new page "
-                  << page_id);
+  switch (record.type) {
+    case LogRecordType::INSERT:
+    case LogRecordType::INSERT_COMPRESSED:
+      // Slot choice depends only on the page, so it repeats exactly
+      if (page->InsertTuple(record.payload, record.payload_size,
+                            SlotFlagsFor(record.type)) != record.slot_id) {
+        return false;
+      }
+      break;
+    case LogRecordType::UPDATE:
+    case LogRecordType::UPDATE_COMPRESSED:
+      // In place or moved within the page, as the logged update was
+      if (page->UpdateTuple(record.slot_id, record.payload,
+                            record.payload_size, SlotFlagsFor(record.type))
+              .code != 0) {
+        return false;
+      }
+      break;
+    case LogRecordType::DELETE:
+      if (page->DeleteTuple(record.slot_id).code != 0) {
+        return false;
+      }
+      break;
+    case LogRecordType::FORWARD: {
+      ForwardStub stub{};
+      if (record.payload_size != sizeof(stub)) {
+        return false;
+      }
+      std::memcpy(&stub, record.payload, sizeof(stub));
+      if (page->MarkSlotForwarded(record.slot_id, stub.page_id, stub.slot_id)
+              .code != 0) {
+        return false;
+      }
+      break;
+    }
+    case LogRecordType::COMPACT:
+      page->CompactPage();
+      break;
+    default:
+      return false;
+  }
 
-  return page_id;
+  page->SetPageLsn(record.lsn);
+  page.MarkDirty();
+  UpdateFSM(page_id, page.GetPage());
+  return true;
 }
 
-void PageManager::UpdateFSM(page_id_t page_id, Page* page) const {
-  if (page == nullptr) {
-    return;
+bool PageManager::InstallPageImage(page_id_t page_id, lsn_t lsn,
+                                   const char* image) {
+  auto install = [&](Page* page) {
+    if (image != nullptr) {
+      std::memcpy(page->GetRawBuffer(), image, PAGE_SIZE);
+    } else {
+      page->ResetMemory();
+      page->SetPageId(page_id);
+    }
+    page->SetPageLsn(lsn);
+  };
+
+  // Already loaded by an earlier record of this recovery
+  if (buffer_pool_->IsPageResident(page_id)) {
+    PageGuard page = GetPage(page_id, LatchMode::EXCLUSIVE);
+    if (!page) {
+      return false;
+    }
+    if (page->GetPageLsn() < lsn) {
+      install(page.GetPage());
+      page.MarkDirty();
+      UpdateFSM(page_id, page.GetPage());
+    }
+    return true;
   }
 
-  uint16_t free_space = page->GetFreeEnd() - page->GetFreeStart();
-  fsm_->UpdatePageFreeSpace(page_id, free_space);
+  auto page = Page::CreateNew();
+  try {
+    // Throws on a short read (never written) or a checksum mismatch (torn)
+    disk_manager_->ReadPage(page_id, page->GetRawBuffer());
+    if (page->GetPageLsn() >= lsn) {
+      return true;
+    }
+  } catch (const std::exception& e) {
+    if (image != nullptr) {
+      LOG_WARNING_STREAM("PageManager::Recover: Page "
+                         << page_id << " cannot be read (" << e.what()
+                         << "), restoring it from the log");
+    }
+  }
 
-  LOG_INFO_STREAM("PageManager::UpdateFSM: Updated FSM for page "
-                  << page_id << " (free space: " << free_space << " bytes)");
+  install(page.get());
+  try {
+    // The checkpoint that ends recovery syncs it
+    disk_manager_->WritePage(page_id, page->GetRawBuffer(),
+                             /*defer_sync=*/true);
+  } catch (const std::exception& e) {
+    LOG_ERROR_STREAM("PageManager::RedoRecord: " << e.what());
+    return false;
+  }
+  UpdateFSM(page_id, page.get());
+  return true;
 }
 
-TupleId PageManager::FollowForwardingChainFull(TupleId tuple_id) const {
+TupleId PageManager::FollowForwardingChainFull(
+    TupleId tuple_id, std::vector<TupleId>* stubs,
+    PageGuard* final_page) const {
+  TRACE_SPAN("PageManager::FollowForwardingChainFull");
   if (tuple_id.page_id == 0 || tuple_id.slot_id == INVALID_SLOT_ID) {
     LOG_ERROR_STREAM(
         "PageManager::FollowForwardingChainFull: Invalid input TupleId ("
@@ -474,58 +1456,234 @@ TupleId PageManager::FollowForwardingChainFull(TupleId tuple_id) const {
     return {0, 0};
   }
 
-  Page* page = const_cast<PageManager*>(this)->GetPage(tuple_id.page_id);
+  if (stubs != nullptr) {
+    stubs->clear();
+  }
 
-  if (page == nullptr) {
-    LOG_ERROR_STREAM(
-        "PageManager::FollowForwardingChainFull: Failed to get page "
-        << tuple_id.page_id);
-    return {0, 0};
+  // Consecutive hops on one page share a single latch acquisition. The
+  // next page is latched before the current one is released, so no writer
+  // can repoint the stub just read and free the slot it names in between.
+  // Writers never hold two page latches, and readers take them in chain
+  // order, so this cannot deadlock.
+  PageGuard page;
+  TupleId current = tuple_id;
+  for (int hop = 0; hop <= MAX_FORWARDING_HOPS; hop++) {
+    if (!page || page.GetPageId() != current.page_id) {
+      PageGuard next = GetPage(current.page_id, LatchMode::SHARED);
+      page = std::move(next);
+      if (!page) {
+        LOG_ERROR_STREAM(
+            "PageManager::FollowForwardingChainFull: Failed to get page "
+            << current.page_id);
+        return {0, 0};
+      }
+    }
+
+    if (!page->IsSlotValid(current.slot_id)) {
+      LOG_ERROR_STREAM("PageManager::FollowForwardingChainFull: Slot "
+                       << current.slot_id << " on page " << current.page_id
+                       << " is not a valid tuple");
+      return {0, 0};
+    }
+
+    if (!page->IsSlotForwarded(current.slot_id)) {
+      if (hop > 0) {
+        forwarded_lookups_.Add();
+        forwarding_hops_.Add(static_cast<uint64_t>(hop));
+      }
+      LOG_INFO_F(
+          "PageManager::FollowForwardingChainFull: Followed chain from "
+          "(%u, %u) to (%u, %u)",
+          static_cast<unsigned>(tuple_id.page_id),
+          static_cast<unsigned>(tuple_id.slot_id),
+          static_cast<unsigned>(current.page_id),
+          static_cast<unsigned>(current.slot_id));
+      if (final_page != nullptr) {
+        *final_page = std::move(page);
+      }
+      return current;
+    }
+
+    if (stubs != nullptr) {
+      stubs->push_back(current);
+    }
+    current = page->GetForwardingPointer(current.slot_id);
+    if (current.page_id == INVALID_PAGE_ID) {
+      break;
+    }
   }
 
-  if (tuple_id.slot_id >= page->GetSlotCount()) {
-    LOG_ERROR_STREAM("PageManager::FollowForwardingChainFull: Slot ID "
-                     << tuple_id.slot_id << " out of range (slot_count: "
-                     << page->GetSlotCount() << ")");
-    return {0, 0};
+  LOG_WARNING_STREAM("PageManager::FollowForwardingChainFull: Chain from page "
+                     << tuple_id.page_id << ", slot " << tuple_id.slot_id
+                     << " is broken, circular or longer than "
+                     << MAX_FORWARDING_HOPS << " hops");
+  return {0, 0};
+}
+
+void PageManager::FreeSlots(const std::vector<TupleId>& slots) {
+  PageGuard page;
+  for (const TupleId& slot : slots) {
+    if (!page || page.GetPageId() != slot.page_id) {
+      if (page) {
+        UpdateFSM(page.GetPageId(), page.GetPage());
+      }
+      page.Release();
+      page = GetPage(slot.page_id, LatchMode::EXCLUSIVE);
+      if (!page) {
+        LOG_WARNING_STREAM("PageManager::FreeSlots: Failed to get page "
+                           << slot.page_id);
+        continue;
+      }
+    }
+
+    if (page->IsSlotValid(slot.slot_id) &&
+        page->DeleteTuple(slot.slot_id).code == 0) {
+      page.MarkDirty();
+      LogChange(page, LogRecordType::DELETE, slot.slot_id);
+    }
+  }
+  if (page) {
+    UpdateFSM(page.GetPageId(), page.GetPage());
   }
+}
 
-  TupleId result = page->FollowForwardingChain(tuple_id.slot_id);
+size_t PageManager::CollapseForwardingChains() {
+  // Pass 1: every forwarded slot and its target. A stub that is some other
+  // stub's target is an intermediate hop; the rest are home slots.
+  std::vector<TupleId> forwarded;
+  std::vector<uint64_t> targets;
+  const page_id_t end_page_id = disk_manager_->GetNextPageId();
+  for (page_id_t page_id = 1; page_id < end_page_id; page_id++) {
+    PageGuard page = GetPage(page_id, LatchMode::SHARED);
+    if (!page) {
+      continue;
+    }
+    for (slot_id_t slot = 0; slot < page->GetSlotCount(); slot++) {
+      if (page->IsSlotValid(slot) && page->IsSlotForwarded(slot)) {
+        forwarded.push_back({page_id, slot});
+        const TupleId target = page->GetForwardingPointer(slot);
+        targets.push_back(static_cast<uint64_t>(target.page_id) << 16 |
+                          target.slot_id);
+      }
+    }
+  }
+  std::sort(targets.begin(), targets.end());
+
+  // Pass 2: re-resolve each home (the table may have changed since pass 1)
+  // and collapse chains of more than one hop
+  size_t collapsed = 0;
+  std::vector<TupleId> stubs;
+  for (const TupleId& home : forwarded) {
+    const uint64_t key = static_cast<uint64_t>(home.page_id) << 16 |
+                         home.slot_id;
+    if (!std::binary_search(targets.begin(), targets.end(), key) &&
+        CollapseChain(home, &stubs)) {
+      collapsed++;
+    }
+  }
 
-  LOG_INFO_STREAM(
-      "PageManager::FollowForwardingChainFull: Followed chain from ("
-      << tuple_id.page_id << ", " << tuple_id.slot_id << ") to ("
-      << result.page_id << ", " << result.slot_id << ")");
+  LOG_INFO_STREAM("PageManager::CollapseForwardingChains: Collapsed "
+                  << collapsed << " chains");
+  return collapsed;
+}
 
-  return result;
+size_t PageManager::CollapseForwardingChains(page_id_t first_page_id,
+                                             page_id_t end_page_id) {
+  size_t collapsed = 0;
+  std::vector<slot_id_t> forwarded;
+  std::vector<TupleId> stubs;
+  for (page_id_t page_id = first_page_id; page_id < end_page_id; page_id++) {
+    forwarded.clear();
+    {
+      PageGuard page = GetPage(page_id, LatchMode::SHARED);
+      if (!page) {
+        continue;
+      }
+      for (slot_id_t slot = 0; slot < page->GetSlotCount(); slot++) {
+        if (page->IsSlotValid(slot) && page->IsSlotForwarded(slot)) {
+          forwarded.push_back(slot);
+        }
+      }
+    }
+
+    for (slot_id_t slot : forwarded) {
+      if (CollapseChain({page_id, slot}, &stubs)) {
+        collapsed++;
+      }
+    }
+  }
+  return collapsed;
 }
 
-void PageManager::EvictPageIfNeeded() {
-  if (page_cache_.size() < MAX_CACHE_SIZE) {
-    return;
+bool PageManager::CollapseChain(TupleId home, std::vector<TupleId>* stubs) {
+  const TupleId final_tuple_id = FollowForwardingChainFull(home, stubs);
+  if (final_tuple_id.page_id == INVALID_PAGE_ID || stubs->size() < 2) {
+    return false;
+  }
+
+  {
+    PageGuard page = GetPage(home.page_id, LatchMode::EXCLUSIVE);
+    if (!page || !page->IsSlotValid(home.slot_id) ||
+        !page->IsSlotForwarded(home.slot_id) ||
+        page->GetForwardingPointer(home.slot_id) != (*stubs)[1] ||
+        page->MarkSlotForwarded(home.slot_id, final_tuple_id.page_id,
+                                final_tuple_id.slot_id)
+                .code != 0) {
+      return false;
+    }
+    page.MarkDirty();
+    LogForward(page, home.slot_id, final_tuple_id);
   }
 
-  for (auto it = page_cache_.begin(); it != page_cache_.end(); ++it) {
-    if (it->second != nullptr && !it->second->IsDirty()) {
-      LOG_INFO_STREAM("PageManager::EvictPageIfNeeded: Evicting page "
-                      << it->first);
-      page_cache_.erase(it);
-      return;
+  stubs->erase(stubs->begin());
+  FreeSlots(*stubs);
+  return true;
+}
+
+std::vector<page_id_t> PageManager::FindCompactionCandidates(
+    size_t max_pages) const {
+  std::vector<std::pair<size_t, page_id_t>> fragmented;
+  for (page_id_t page_id : buffer_pool_->GetResidentPageIds()) {
+    PageGuard page(buffer_pool_.get(), page_id,
+                   buffer_pool_->FetchResidentPage(page_id),
+                   LatchMode::SHARED);
+    if (page && page->ShouldCompact()) {
+      fragmented.emplace_back(page->GetFragmentedBytes(), page_id);
     }
   }
 
-  auto it = page_cache_.begin();
-  if (it != page_cache_.end()) {
-    page_id_t page_id = it->first;
-    FlushPage(page_id);
-    LOG_INFO_STREAM("PageManager::EvictPageIfNeeded: Flushed and evicted page "
-                    << page_id);
-    page_cache_.erase(it);
+  const size_t count = std::min(max_pages, fragmented.size());
+  std::partial_sort(fragmented.begin(), fragmented.begin() + count,
+                    fragmented.end(),
+                    [](const auto& a, const auto& b) { return a > b; });
+
+  std::vector<page_id_t> page_ids;
+  page_ids.reserve(count);
+  for (size_t i = 0; i < count; i++) {
+    page_ids.push_back(fragmented[i].second);
   }
+  return page_ids;
+}
+
+bool PageManager::CompactResidentPage(page_id_t page_id, char* scratch) {
+  PageGuard page(buffer_pool_.get(), page_id,
+                 buffer_pool_->FetchResidentPage(page_id),
+                 LatchMode::EXCLUSIVE);
+  if (!page || !page->ShouldCompact()) {
+    return false;
+  }
+
+  page->CompactPage(scratch);
+  compactions_.Add();
+  page.MarkDirty();
+  LogChange(page, LogRecordType::COMPACT, INVALID_SLOT_ID);
+  UpdateFSM(page_id, page.GetPage());
+  return true;
 }
 
 page_id_t PageManager::FindPageWithSpace(uint16_t required_size) {
-  page_id_t page_id = fsm_->FindPageWithSpace(required_size);
+  // Per-thread target page when the FSM has insert streams enabled
+  page_id_t page_id = fsm_->FindInsertTarget(required_size);
 
   if (page_id != INVALID_PAGE_ID) {
     LOG_INFO_STREAM("PageManager::FindPageWithSpace: Found page "
@@ -535,6 +1693,11 @@ page_id_t PageManager::FindPageWithSpace(uint16_t required_size) {
   return page_id;
 }
 
+bool PageManager::IsInsertableTuple(const TupleSlice& tuple) {
+  return tuple.data != nullptr && tuple.size > 0 &&
+         tuple.size <= PAGE_SIZE - sizeof(PageHeader) - SLOT_ENTRY_SIZE;
+}
+
 ErrorCode PageManager::GetTupleFromSlot(Page* page, slot_id_t slot_id,
                                         char* buffer,
                                         uint16_t buffer_size) const {
@@ -549,6 +1712,33 @@ ErrorCode PageManager::GetTupleFromSlot(Page* page, slot_id_t slot_id,
   }
 
   SlotEntry slot_entry = page->GetSlotEntry(slot_id);
+  const char* page_data = page->GetRawBuffer();
+
+  if (slot_entry.flags & SLOT_COMPRESSED) {
+    uint16_t size = 0;
+    ErrorCode result = GetTupleCompressor().Decompress(
+        page_data + slot_entry.offset, slot_entry.length, buffer, buffer_size,
+        &size);
+    if (result.code == -3) {
+      LOG_ERROR_STREAM("PageManager::GetTupleFromSlot: Buffer too small ("
+                       << buffer_size << " < "
+                       << TupleCompressor::RawSize(
+                              page_data + slot_entry.offset,
+                              slot_entry.length)
+                       << ")");
+      return {-3, "PageManager::GetTupleFromSlot: Buffer too small"};
+    }
+    if (result.code != 0) {
+      LOG_ERROR_STREAM("PageManager::GetTupleFromSlot: Cannot decompress slot "
+                       << slot_id << " (" << result.message << ")");
+      return {-4, "PageManager::GetTupleFromSlot: Cannot decompress tuple (" +
+                      result.message + ")"};
+    }
+    if (buffer_size > size) {
+      buffer[size] = '\0';
+    }
+    return {0, "PageManager::GetTupleFromSlot: Success"};
+  }
 
   if (buffer_size < slot_entry.length) {
     LOG_ERROR_STREAM("PageManager::GetTupleFromSlot: Buffer too small ("
@@ -556,15 +1746,16 @@ ErrorCode PageManager::GetTupleFromSlot(Page* page, slot_id_t slot_id,
     return {-3, "PageManager::GetTupleFromSlot: Buffer too small"};
   }
 
-  const char* page_data = page->GetRawBuffer();
   std::memcpy(buffer, page_data + slot_entry.offset, slot_entry.length);
 
   if (buffer_size > slot_entry.length) {
     buffer[slot_entry.length] = '\0';
   }
 
-  LOG_INFO_STREAM("PageManager::GetTupleFromSlot: Retrieved tuple from slot "
-                  << slot_id << " (size: " << slot_entry.length << " bytes)");
+  LOG_INFO_F("PageManager::GetTupleFromSlot: Retrieved tuple from slot %u "
+             "(size: %u bytes)",
+             static_cast<unsigned>(slot_id),
+             static_cast<unsigned>(slot_entry.length));
 
   return {0, "PageManager::GetTupleFromSlot: Success"};
 }
@@ -0,0 +1,139 @@
+#include "../../include/storage/parallel_scan.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+
+#include "../../include/common/logger.h"
+
+ParallelScan::ParallelScan(PageManager* page_manager, size_t num_workers,
+                           size_t morsel_pages)
+    : page_manager_(page_manager),
+      num_workers_(num_workers),
+      morsel_pages_(morsel_pages),
+      predicate_(nullptr),
+      morsels_stolen_(0),
+      failed_(false) {
+  if (page_manager_ == nullptr) {
+    LOG_ERROR("ParallelScan: PageManager is null");
+    throw std::invalid_argument("PageManager cannot be null");
+  }
+
+  if (morsel_pages_ == 0) {
+    LOG_ERROR("ParallelScan: Morsel size must be positive");
+    throw std::invalid_argument("Morsel size must be positive");
+  }
+
+  if (num_workers_ == 0) {
+    num_workers_ = std::max(1u, std::thread::hardware_concurrency());
+  }
+
+  for (size_t i = 0; i < num_workers_; i++) {
+    queues_.push_back(std::make_unique<WorkQueue>());
+  }
+}
+
+void ParallelScan::Run(const TupleCallback& callback) {
+  Partition();
+  morsels_stolen_.store(0);
+  failed_.store(false);
+  failure_ = nullptr;
+
+  std::vector<std::thread> workers;
+  workers.reserve(num_workers_);
+  for (size_t worker_id = 0; worker_id < num_workers_; worker_id++) {
+    workers.emplace_back(&ParallelScan::WorkerLoop, this, worker_id,
+                         std::cref(callback));
+  }
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+
+  LOG_INFO_F("ParallelScan: Finished with %zu workers (%zu morsels stolen)",
+             num_workers_, morsels_stolen_.load());
+
+  if (failure_) {
+    std::rethrow_exception(failure_);
+  }
+}
+
+void ParallelScan::Run(const Schema& schema,
+                       const AccessorCallback& callback) {
+  Run([&schema, &callback](size_t worker_id, const TupleView& tuple) {
+    const TupleAccessor accessor(schema, tuple.data, tuple.size);
+    callback(worker_id, tuple.tuple_id, accessor);
+  });
+}
+
+void ParallelScan::Partition() {
+  const page_id_t end_page_id =
+      page_manager_->GetDiskManager()->GetNextPageId();
+
+  std::vector<Morsel> morsels;
+  for (page_id_t first = 1; first < end_page_id;) {
+    const page_id_t end = static_cast<page_id_t>(
+        std::min<size_t>(first + morsel_pages_, end_page_id));
+    morsels.push_back({first, end});
+    first = end;
+  }
+
+  // Worker w gets the w-th contiguous block, keeping its reads sequential
+  const size_t per_worker = (morsels.size() + num_workers_ - 1) / num_workers_;
+  for (size_t worker_id = 0; worker_id < num_workers_; worker_id++) {
+    WorkQueue& queue = *queues_[worker_id];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.morsels.clear();
+    const size_t begin = std::min(worker_id * per_worker, morsels.size());
+    const size_t end = std::min(begin + per_worker, morsels.size());
+    queue.morsels.assign(morsels.begin() + begin, morsels.begin() + end);
+  }
+}
+
+bool ParallelScan::NextMorsel(size_t worker_id, Morsel* morsel) {
+  {
+    WorkQueue& own = *queues_[worker_id];
+    std::lock_guard<std::mutex> lock(own.mutex);
+    if (!own.morsels.empty()) {
+      *morsel = own.morsels.front();
+      own.morsels.pop_front();
+      return true;
+    }
+  }
+
+  // Steal the victim's last morsel: farthest from what it is reading now
+  for (size_t i = 1; i < num_workers_; i++) {
+    WorkQueue& victim = *queues_[(worker_id + i) % num_workers_];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (!victim.morsels.empty()) {
+      *morsel = victim.morsels.back();
+      victim.morsels.pop_back();
+      morsels_stolen_++;
+      return true;
+    }
+  }
+  return false;
+}
+
+void ParallelScan::WorkerLoop(size_t worker_id,
+                              const TupleCallback& callback) {
+  try {
+    TableScan scan(page_manager_, 1, 1,
+                   std::min(DEFAULT_SCAN_READ_AHEAD_PAGES, morsel_pages_));
+    scan.SetPredicate(predicate_);
+    Morsel morsel{};
+    TupleView tuple{};
+    while (!failed_.load(std::memory_order_relaxed) &&
+           NextMorsel(worker_id, &morsel)) {
+      scan.ResetRange(morsel.first_page_id, morsel.end_page_id);
+      while (scan.Next(&tuple)) {
+        callback(worker_id, tuple);
+      }
+    }
+  } catch (...) {
+    std::lock_guard<std::mutex> lock(failure_mutex_);
+    if (!failure_) {
+      failure_ = std::current_exception();
+    }
+    failed_.store(true);
+  }
+}
@@ -0,0 +1,235 @@
+#include "../../include/storage/pax_table.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include "../../include/common/logger.h"
+
+PaxTable::PaxTable(DiskManager* disk_manager, const Schema& schema,
+                   size_t buffer_pool_size_mb)
+    : disk_manager_(disk_manager), schema_(schema), layout_(schema_) {
+  if (disk_manager_ == nullptr) {
+    LOG_ERROR("PaxTable: DiskManager is null");
+    throw std::invalid_argument("DiskManager cannot be null");
+  }
+  buffer_pool_ = std::make_unique<BufferPoolManager>(
+      BufferPoolManager::FramesForMemoryBudget(buffer_pool_size_mb),
+      disk_manager_);
+  LoadPages();
+  LOG_INFO_STREAM("PaxTable: Opened with " << pages_.size() << " pages, "
+                                           << layout_.GetCapacity()
+                                           << " rows per page");
+}
+
+PaxTable::~PaxTable() {
+  ErrorCode result = FlushAllPages();
+  if (result.code != 0) {
+    LOG_ERROR_STREAM("PaxTable: Failed to flush on close ("
+                     << result.message << ")");
+  }
+}
+
+void PaxTable::LoadPages() {
+  const page_id_t end = disk_manager_->GetNextPageId();
+  for (page_id_t page_id = 1; page_id < end; page_id++) {
+    PageGuard page = GetPage(page_id, LatchMode::SHARED);
+    if (!page) {
+      LOG_WARNING_STREAM("PaxTable: Skipping unreadable page " << page_id);
+      continue;
+    }
+    if (page->GetPageType() == PAGE_TYPE_FREE) {
+      continue;
+    }
+    const PaxPage pax(page.GetPage(), layout_);
+    if (!pax.IsValidPaxPage()) {
+      LOG_ERROR_STREAM("PaxTable: Page " << page_id
+                                         << " is not a PAX page of this "
+                                            "schema");
+      throw std::runtime_error("Not a PAX page of this schema: page " +
+                               std::to_string(page_id));
+    }
+    pages_.push_back(page_id);
+    if (!pax.IsFull()) {
+      with_space_.push_back(page_id);
+    }
+  }
+  // Fill the lowest pages first
+  std::reverse(with_space_.begin(), with_space_.end());
+}
+
+PageGuard PaxTable::GetPage(page_id_t page_id, LatchMode mode) const {
+  Page* page = buffer_pool_->FetchPage(page_id);
+  if (page == nullptr) {
+    return PageGuard();
+  }
+  return PageGuard(buffer_pool_.get(), page_id, page, mode);
+}
+
+PageGuard PaxTable::GetRowPage(TupleId tuple_id, LatchMode mode) const {
+  {
+    std::lock_guard<std::mutex> lock(pages_mutex_);
+    if (!std::binary_search(pages_.begin(), pages_.end(), tuple_id.page_id)) {
+      return PageGuard();
+    }
+  }
+  PageGuard page = GetPage(tuple_id.page_id, mode);
+  if (!page || !PaxPage(page.GetPage(), layout_).IsRowValid(tuple_id.slot_id)) {
+    return PageGuard();
+  }
+  return page;
+}
+
+PageGuard PaxTable::PageWithSpace() {
+  for (;;) {
+    page_id_t page_id = INVALID_PAGE_ID;
+    {
+      std::lock_guard<std::mutex> lock(pages_mutex_);
+      if (!with_space_.empty()) {
+        page_id = with_space_.back();
+      }
+    }
+
+    if (page_id != INVALID_PAGE_ID) {
+      PageGuard page = GetPage(page_id, LatchMode::EXCLUSIVE);
+      if (!page) {
+        return PageGuard();
+      }
+      if (!PaxPage(page.GetPage(), layout_).IsFull()) {
+        return page;
+      }
+      // Filled by a concurrent insert
+      std::lock_guard<std::mutex> lock(pages_mutex_);
+      auto it = std::find(with_space_.rbegin(), with_space_.rend(), page_id);
+      if (it != with_space_.rend()) {
+        with_space_.erase(std::next(it).base());
+      }
+      continue;
+    }
+
+    Page* new_page = buffer_pool_->NewPage(&page_id);
+    if (new_page == nullptr) {
+      LOG_ERROR("PaxTable: Failed to allocate a page");
+      return PageGuard();
+    }
+    PageGuard page(buffer_pool_.get(), page_id, new_page,
+                   LatchMode::EXCLUSIVE);
+    PaxPage(page.GetPage(), layout_).Init();
+    page.MarkDirty();
+
+    std::lock_guard<std::mutex> lock(pages_mutex_);
+    pages_.insert(std::lower_bound(pages_.begin(), pages_.end(), page_id),
+                  page_id);
+    with_space_.push_back(page_id);
+    return page;
+  }
+}
+
+TupleId PaxTable::InsertTuple(const char* tuple_data, uint16_t tuple_size) {
+  if (tuple_data == nullptr || tuple_size != layout_.GetTupleSize()) {
+    LOG_ERROR_STREAM("PaxTable::InsertTuple: Expected a "
+                     << layout_.GetTupleSize() << "-byte tuple, got "
+                     << tuple_size);
+    return {0, INVALID_SLOT_ID};
+  }
+
+  PageGuard page = PageWithSpace();
+  if (!page) {
+    return {0, INVALID_SLOT_ID};
+  }
+  const PaxPage pax(page.GetPage(), layout_);
+  const slot_id_t row = pax.InsertRow(tuple_data);
+  page.MarkDirty();
+
+  if (pax.IsFull()) {
+    std::lock_guard<std::mutex> lock(pages_mutex_);
+    auto it = std::find(with_space_.rbegin(), with_space_.rend(),
+                        page.GetPageId());
+    if (it != with_space_.rend()) {
+      with_space_.erase(std::next(it).base());
+    }
+  }
+  return {page.GetPageId(), row};
+}
+
+ErrorCode PaxTable::GetTuple(TupleId tuple_id, char* buffer,
+                             uint16_t buffer_size) const {
+  if (buffer == nullptr || buffer_size < layout_.GetTupleSize()) {
+    return {-1, "PaxTable::GetTuple: Buffer too small"};
+  }
+  PageGuard page = GetRowPage(tuple_id, LatchMode::SHARED);
+  if (!page) {
+    return {-2, "PaxTable::GetTuple: No such tuple"};
+  }
+  PaxPage(page.GetPage(), layout_).ReadRow(tuple_id.slot_id, buffer);
+  return {0, "PaxTable::GetTuple: Success"};
+}
+
+ErrorCode PaxTable::UpdateTuple(TupleId tuple_id, const char* new_data,
+                                uint16_t new_size) {
+  if (new_data == nullptr || new_size != layout_.GetTupleSize()) {
+    return {-1, "PaxTable::UpdateTuple: Tuple does not match the schema"};
+  }
+  PageGuard page = GetRowPage(tuple_id, LatchMode::EXCLUSIVE);
+  if (!page) {
+    return {-2, "PaxTable::UpdateTuple: No such tuple"};
+  }
+  PaxPage(page.GetPage(), layout_).WriteRow(tuple_id.slot_id, new_data);
+  page.MarkDirty();
+  return {0, "PaxTable::UpdateTuple: Success"};
+}
+
+ErrorCode PaxTable::DeleteTuple(TupleId tuple_id) {
+  PageGuard page = GetRowPage(tuple_id, LatchMode::EXCLUSIVE);
+  if (!page) {
+    return {-1, "PaxTable::DeleteTuple: No such tuple"};
+  }
+  const PaxPage pax(page.GetPage(), layout_);
+  const bool was_full = pax.IsFull();
+  pax.DeleteRow(tuple_id.slot_id);
+  page.MarkDirty();
+
+  if (was_full) {
+    std::lock_guard<std::mutex> lock(pages_mutex_);
+    with_space_.push_back(tuple_id.page_id);
+  }
+  return {0, "PaxTable::DeleteTuple: Success"};
+}
+
+ErrorCode PaxTable::ScanColumn(size_t field_index,
+                               const ColumnVisitor& visitor) const {
+  if (field_index >= layout_.GetColumns().size()) {
+    return {-1, "PaxTable::ScanColumn: Field index out of bounds"};
+  }
+
+  std::vector<page_id_t> pages;
+  {
+    std::lock_guard<std::mutex> lock(pages_mutex_);
+    pages = pages_;
+  }
+  for (page_id_t page_id : pages) {
+    PageGuard page = GetPage(page_id, LatchMode::SHARED);
+    if (!page) {
+      LOG_ERROR_STREAM("PaxTable::ScanColumn: Failed to fetch page "
+                       << page_id);
+      return {-2, "PaxTable::ScanColumn: Failed to fetch page " +
+                      std::to_string(page_id)};
+    }
+    const PaxPage pax(page.GetPage(), layout_);
+    const PaxColumnChunk chunk{page_id,
+                               pax.GetColumnData(field_index),
+                               pax.GetNullBitmap(field_index),
+                               pax.GetValidBitmap(),
+                               pax.GetHighWater(),
+                               layout_.GetColumns()[field_index].size};
+    visitor(chunk);
+  }
+  return {0, "PaxTable::ScanColumn: Success"};
+}
+
+ErrorCode PaxTable::FlushAllPages() { return buffer_pool_->FlushAllPages(); }
+
+size_t PaxTable::GetPageCount() const {
+  std::lock_guard<std::mutex> lock(pages_mutex_);
+  return pages_.size();
+}
@@ -0,0 +1,337 @@
+#include "../../include/storage/table_scan.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+#include "../../include/common/logger.h"
+
+namespace {
+
+DiskManager* DiskManagerOf(PageManager* page_manager) {
+  if (page_manager == nullptr) {
+    LOG_ERROR("TableScan: PageManager is null");
+    throw std::invalid_argument("PageManager cannot be null");
+  }
+  return page_manager->GetDiskManager();
+}
+
+}  // namespace
+
+TableScan::TableScan(PageManager* page_manager, size_t read_ahead_pages)
+    : TableScan(page_manager, 1, DiskManagerOf(page_manager)->GetNextPageId(),
+                read_ahead_pages) {}
+
+TableScan::TableScan(PageManager* page_manager, page_id_t first_page_id,
+                     page_id_t end_page_id, size_t read_ahead_pages)
+    : buffer_pool_(nullptr),
+      disk_manager_(DiskManagerOf(page_manager)),
+      compressor_(&page_manager->GetTupleCompressor()),
+      zone_map_(page_manager->GetZoneMap()),
+      decompressed_(PAGE_SIZE),
+      predicate_(nullptr),
+      next_match_(0),
+      end_page_id_(end_page_id),
+      next_page_id_(std::max<page_id_t>(first_page_id, 1)),
+      next_prefetch_(next_page_id_),
+      current_page_(nullptr),
+      current_page_id_(INVALID_PAGE_ID),
+      next_slot_(0),
+      pages_scanned_(0),
+      pages_read_from_disk_(0),
+      pages_skipped_(0) {
+  if (read_ahead_pages == 0) {
+    LOG_ERROR("TableScan: Read-ahead window must be positive");
+    throw std::invalid_argument("Read-ahead window must be positive");
+  }
+
+  buffer_pool_ = page_manager->GetBufferPool();
+
+  ring_frames_ = std::make_unique<FramePool>(read_ahead_pages);
+  ring_.resize(read_ahead_pages);
+  for (size_t i = 0; i < ring_.size(); i++) {
+    ring_[i].page = ring_frames_->GetFrame(i);
+  }
+}
+
+TableScan::~TableScan() {
+  ReleaseCurrentPage();
+  WaitForReadAhead();
+}
+
+void TableScan::ResetRange(page_id_t first_page_id, page_id_t end_page_id) {
+  ReleaseCurrentPage();
+  WaitForReadAhead();
+  matches_.clear();
+  next_match_ = 0;
+  end_page_id_ = end_page_id;
+  next_page_id_ = std::max<page_id_t>(first_page_id, 1);
+  next_prefetch_ = next_page_id_;
+}
+
+bool TableScan::Next(TupleView* tuple) {
+  if (tuple == nullptr) {
+    LOG_ERROR("TableScan::Next: Output tuple is null");
+    return false;
+  }
+
+  if (predicate_ != nullptr) {
+    while (next_match_ == matches_.size()) {
+      next_match_ = 0;
+      if (!NextPageImpl(&matches_, &match_ids_)) {
+        return false;
+      }
+    }
+    const TupleSlice& match = matches_[next_match_];
+    *tuple = {match_ids_[next_match_], match.data, match.size};
+    next_match_++;
+    return true;
+  }
+
+  while (true) {
+    if (current_page_ != nullptr) {
+      const slot_id_t slot_count = current_page_->GetSlotCount();
+      while (next_slot_ < slot_count) {
+        const slot_id_t slot_id = next_slot_++;
+        const SlotEntry& entry = current_page_->GetSlotEntry(slot_id);
+        if (!(entry.flags & SLOT_VALID) || (entry.flags & SLOT_FORWARDED)) {
+          continue;
+        }
+        tuple->tuple_id = {current_page_id_, slot_id};
+        tuple->data = current_page_->GetRawBuffer() + entry.offset;
+        tuple->size = entry.length;
+        if (entry.flags & SLOT_COMPRESSED) {
+          ErrorCode result = compressor_->Decompress(
+              tuple->data, tuple->size, decompressed_.data(),
+              decompressed_.size(), &tuple->size);
+          if (result.code != 0) {
+            LOG_ERROR_STREAM("TableScan::Next: Skipping page "
+                             << current_page_id_ << ", slot " << slot_id
+                             << " (" << result.message << ")");
+            continue;
+          }
+          tuple->data = decompressed_.data();
+        }
+        return true;
+      }
+      ReleaseCurrentPage();
+    }
+
+    if (next_page_id_ >= end_page_id_) {
+      return false;
+    }
+
+    const page_id_t page_id = next_page_id_++;
+    ReadAhead(page_id);
+    LoadPage(page_id);
+  }
+}
+
+bool TableScan::NextPage(std::vector<TupleSlice>* tuples,
+                         std::vector<TupleId>* tuple_ids) {
+  if (tuples == nullptr) {
+    LOG_ERROR("TableScan::NextPage: Output tuples is null");
+    return false;
+  }
+  matches_.clear();
+  next_match_ = 0;
+  return NextPageImpl(tuples, tuple_ids);
+}
+
+bool TableScan::NextPageImpl(std::vector<TupleSlice>* tuples,
+                             std::vector<TupleId>* tuple_ids) {
+  tuples->clear();
+  if (tuple_ids != nullptr) {
+    tuple_ids->clear();
+  }
+
+  while (true) {
+    if (current_page_ != nullptr) {
+      // Decompressed tuples are packed into decompressed_page_, which may
+      // grow; their data pointers are filled in once the page is done
+      std::vector<std::pair<size_t, size_t>> decompressed;  // index, offset
+      size_t decompressed_bytes = 0;
+      const slot_id_t slot_count = current_page_->GetSlotCount();
+      while (next_slot_ < slot_count) {
+        const slot_id_t slot_id = next_slot_++;
+        const SlotEntry& entry = current_page_->GetSlotEntry(slot_id);
+        if (!(entry.flags & SLOT_VALID) || (entry.flags & SLOT_FORWARDED)) {
+          continue;
+        }
+        TupleSlice tuple{current_page_->GetRawBuffer() + entry.offset,
+                         entry.length};
+        if (entry.flags & SLOT_COMPRESSED) {
+          if (decompressed_page_.size() < decompressed_bytes + PAGE_SIZE) {
+            decompressed_page_.resize(decompressed_bytes + PAGE_SIZE);
+          }
+          ErrorCode result = compressor_->Decompress(
+              tuple.data, tuple.size,
+              decompressed_page_.data() + decompressed_bytes, PAGE_SIZE,
+              &tuple.size);
+          if (result.code != 0) {
+            LOG_ERROR_STREAM("TableScan::NextPage: Skipping page "
+                             << current_page_id_ << ", slot " << slot_id
+                             << " (" << result.message << ")");
+            continue;
+          }
+          decompressed.emplace_back(tuples->size(), decompressed_bytes);
+          decompressed_bytes += tuple.size;
+        }
+        tuples->push_back(tuple);
+        if (tuple_ids != nullptr) {
+          tuple_ids->push_back({current_page_id_, slot_id});
+        }
+      }
+      for (const auto& [index, offset] : decompressed) {
+        (*tuples)[index].data = decompressed_page_.data() + offset;
+      }
+      if (predicate_ != nullptr && !tuples->empty()) {
+        predicate_->Filter(tuples->data(), tuples->size(), &selection_);
+        for (size_t i = 0; i < selection_.size(); i++) {
+          (*tuples)[i] = (*tuples)[selection_[i]];
+          if (tuple_ids != nullptr) {
+            (*tuple_ids)[i] = (*tuple_ids)[selection_[i]];
+          }
+        }
+        tuples->resize(selection_.size());
+        if (tuple_ids != nullptr) {
+          tuple_ids->resize(selection_.size());
+        }
+      }
+      if (!tuples->empty()) {
+        return true;
+      }
+      ReleaseCurrentPage();
+    }
+
+    if (next_page_id_ >= end_page_id_) {
+      return false;
+    }
+
+    const page_id_t page_id = next_page_id_++;
+    if (CanSkip(page_id)) {
+      // Drop a read issued before the page was ruled out (a rebuild can
+      // narrow its summary); the next page on its frame needs the frame
+      RingFrame& frame = FrameFor(page_id);
+      if (frame.read.IsValid()) {
+        frame.read.Wait();
+        frame.read = IOHandle();
+      }
+      pages_skipped_++;
+      continue;
+    }
+    ReadAhead(page_id);
+    LoadPage(page_id);
+  }
+}
+
+bool TableScan::CanSkip(page_id_t page_id) const {
+  return predicate_ != nullptr && zone_map_ != nullptr &&
+         !zone_map_->MayMatch(page_id, *predicate_);
+}
+
+void TableScan::ReadAhead(page_id_t current_page_id) {
+  // The window is [current, current + ring size): those pages map to
+  // distinct frames, and the frame of current - 1 has just been released.
+  const page_id_t window_begin = std::max(next_prefetch_, current_page_id);
+  const page_id_t window_end = std::min<page_id_t>(
+      end_page_id_, current_page_id + static_cast<page_id_t>(ring_.size()));
+  if (window_begin >= window_end) {
+    return;
+  }
+  // Refill once half the window is free so submissions stay batched
+  if (window_begin > current_page_id &&
+      window_end - window_begin < (ring_.size() + 1) / 2) {
+    return;
+  }
+
+  std::vector<page_id_t> page_ids;
+  std::vector<char*> buffers;
+  for (next_prefetch_ = window_begin; next_prefetch_ < window_end;
+       next_prefetch_++) {
+    if (buffer_pool_->IsPageResident(next_prefetch_) ||
+        CanSkip(next_prefetch_)) {
+      continue;  // served from the pool, or skipped, when reached
+    }
+    RingFrame& frame = FrameFor(next_prefetch_);
+    page_ids.push_back(next_prefetch_);
+    buffers.push_back(frame.page->GetRawBuffer());
+  }
+  if (page_ids.empty()) {
+    return;
+  }
+
+  try {
+    std::vector<IOHandle> handles =
+        disk_manager_->ReadPagesAsync(page_ids, buffers);
+    for (size_t i = 0; i < handles.size(); i++) {
+      FrameFor(page_ids[i]).read = std::move(handles[i]);
+    }
+  } catch (const std::exception& e) {
+    LOG_WARNING_STREAM("TableScan: Read-ahead failed: " << e.what());
+  }
+}
+
+bool TableScan::LoadPage(page_id_t page_id) {
+  RingFrame& frame = FrameFor(page_id);
+  IOHandle read = std::move(frame.read);
+  frame.read = IOHandle();
+
+  // A resident copy may be newer than what was read ahead
+  if (buffer_pool_->IsPageResident(page_id)) {
+    if (read.IsValid()) {
+      read.Wait();
+    }
+    current_guard_ = PageGuard(buffer_pool_, page_id,
+                               buffer_pool_->FetchPage(page_id),
+                               LatchMode::SHARED);
+    if (current_guard_) {
+      current_page_ = current_guard_.GetPage();
+      current_page_id_ = page_id;
+      next_slot_ = 0;
+      pages_scanned_++;
+      return true;
+    }
+  }
+
+  ErrorCode result{0, ""};
+  if (read.IsValid()) {
+    result = read.Wait();
+  } else {
+    // Not read ahead (it was resident then) or evicted since: read it now
+    try {
+      disk_manager_->ReadPage(page_id, frame.page->GetRawBuffer());
+    } catch (const std::exception& e) {
+      result = {-1, e.what()};
+    }
+  }
+
+  if (result.code != 0) {
+    LOG_WARNING_STREAM("TableScan: Skipping page " << page_id << ": "
+                                                   << result.message);
+    return false;
+  }
+
+  current_page_ = frame.page;
+  current_page_id_ = page_id;
+  next_slot_ = 0;
+  pages_scanned_++;
+  pages_read_from_disk_++;
+  return true;
+}
+
+void TableScan::WaitForReadAhead() {
+  for (RingFrame& frame : ring_) {
+    if (frame.read.IsValid()) {
+      frame.read.Wait();
+      frame.read = IOHandle();
+    }
+  }
+}
+
+void TableScan::ReleaseCurrentPage() {
+  current_guard_.Release();
+  current_page_ = nullptr;
+  current_page_id_ = INVALID_PAGE_ID;
+  next_slot_ = 0;
+}
@@ -0,0 +1,173 @@
+#include "../../include/storage/tablespace.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+#include "../../include/common/logger.h"
+
+Tablespace::Tablespace(const std::string& db_file_name, int primary_fd,
+                       const TablespaceLayout& layout, bool create)
+    : list_file_name_(db_file_name + ".tsp"),
+      primary_fd_(primary_fd),
+      primary_direct_fd_(-1),
+      extent_pages_(layout.extent_pages) {
+  if (extent_pages_ == 0) {
+    LOG_ERROR("Tablespace: Extent size is zero pages");
+    throw std::invalid_argument("Tablespace extents need at least 1 page");
+  }
+
+  if (create) {
+    stripe_paths_ = layout.stripe_files;
+  } else {
+    ReadList();
+  }
+  for (const std::string& path : stripe_paths_) {
+    if (path.empty()) {
+      LOG_ERROR("Tablespace: Empty stripe file name");
+      throw std::invalid_argument("Stripe file name cannot be empty");
+    }
+    stripe_files_.emplace_back(path, O_RDWR | (create ? O_CREAT | O_TRUNC : 0),
+                               S_IRUSR | S_IWUSR);
+  }
+  direct_fds_.assign(stripe_files_.size(), -1);
+
+  if (create) {
+    WriteList();
+  }
+  LOG_INFO_STREAM("Tablespace: " << GetFileCount() << " files, extents of "
+                                 << extent_pages_ << " pages");
+}
+
+Tablespace::~Tablespace() { CloseDirectIO(); }
+
+void Tablespace::WriteList() const {
+  // Written to a temporary name and renamed, so the list is never partial
+  const std::string temp_name = list_file_name_ + ".tmp";
+  {
+    std::ofstream out(temp_name, std::ios::trunc);
+    for (const std::string& path : stripe_paths_) {
+      out << path << '\n';
+    }
+    out.flush();
+    if (!out) {
+      LOG_ERROR_STREAM("Tablespace: Failed to write " << temp_name);
+      throw std::runtime_error("Failed to write tablespace: " +
+                               list_file_name_);
+    }
+  }
+
+  FileHandle temp(temp_name, O_RDWR);
+  if (fsync(temp.get()) != 0 ||
+      rename(temp_name.c_str(), list_file_name_.c_str()) != 0) {
+    LOG_ERROR_STREAM("Tablespace: Failed to persist " << list_file_name_
+                                                      << " errno: " << errno);
+    throw std::runtime_error("Failed to write tablespace: " +
+                             list_file_name_);
+  }
+}
+
+void Tablespace::ReadList() {
+  std::ifstream in(list_file_name_);
+  if (!in) {
+    LOG_ERROR_STREAM("Tablespace: Failed to open " << list_file_name_);
+    throw std::runtime_error("Failed to read tablespace: " + list_file_name_);
+  }
+  std::string path;
+  while (std::getline(in, path)) {
+    stripe_paths_.push_back(path);
+  }
+}
+
+off_t Tablespace::OffsetOf(page_id_t page_id) const {
+  const size_t extent = page_id / extent_pages_;
+  const size_t local_page =
+      extent / GetFileCount() * extent_pages_ + page_id % extent_pages_;
+  return static_cast<off_t>(local_page) * static_cast<off_t>(PAGE_SIZE);
+}
+
+int Tablespace::GetFileDescriptor(size_t file) const {
+  return file == 0 ? primary_fd_ : stripe_files_[file - 1].get();
+}
+
+int Tablespace::GetDirectFileDescriptor(size_t file) const {
+  return file == 0 ? primary_direct_fd_ : direct_fds_[file - 1];
+}
+
+bool Tablespace::OpenDirectIO(int primary_direct_fd) {
+#ifdef O_DIRECT
+  for (size_t i = 0; i < stripe_paths_.size(); i++) {
+    direct_fds_[i] = open(stripe_paths_[i].c_str(), O_RDWR | O_DIRECT);
+    if (direct_fds_[i] < 0) {
+      LOG_WARNING_STREAM("Tablespace: O_DIRECT open of "
+                         << stripe_paths_[i] << " rejected (errno: " << errno
+                         << ")");
+      CloseDirectIO();
+      return false;
+    }
+  }
+  primary_direct_fd_ = primary_direct_fd;
+  return true;
+#else
+  (void)primary_direct_fd;
+  return false;
+#endif
+}
+
+void Tablespace::CloseDirectIO() {
+  for (int& fd : direct_fds_) {
+    if (fd >= 0) {
+      close(fd);
+      fd = -1;
+    }
+  }
+  primary_direct_fd_ = -1;
+}
+
+bool Tablespace::SyncStripeFiles() const {
+  bool synced = true;
+  for (const FileHandle& file : stripe_files_) {
+    if (fdatasync(file.get()) != 0) {
+      LOG_ERROR_STREAM("Tablespace: fdatasync failed, errno: " << errno);
+      synced = false;
+    }
+  }
+  return synced;
+}
+
+size_t Tablespace::LocalPageCount(size_t file,
+                                  page_id_t next_page_id) const {
+  // Whole extents dealt to the file, plus its share of a partial last one
+  const size_t file_count = GetFileCount();
+  const size_t full_extents = next_page_id / extent_pages_;
+  const size_t partial_pages = next_page_id % extent_pages_;
+  const size_t file_extents =
+      full_extents > file ? (full_extents - file + file_count - 1) / file_count
+                          : 0;
+  return file_extents * extent_pages_ +
+         (full_extents % file_count == file ? partial_pages : 0);
+}
+
+bool Tablespace::Truncate(page_id_t next_page_id) const {
+  bool truncated = true;
+  for (size_t file = 0; file < GetFileCount(); file++) {
+    // File 0 keeps at least the header's slot
+    size_t pages = LocalPageCount(file, next_page_id);
+    if (file == 0 && pages == 0) {
+      pages = 1;
+    }
+    if (ftruncate(GetFileDescriptor(file),
+                  static_cast<off_t>(pages) * static_cast<off_t>(PAGE_SIZE)) !=
+        0) {
+      LOG_WARNING_STREAM("Tablespace: Failed to truncate file "
+                         << file << ", errno: " << errno);
+      truncated = false;
+    }
+  }
+  return truncated;
+}
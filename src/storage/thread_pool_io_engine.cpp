@@ -0,0 +1,81 @@
+#include "../../include/storage/thread_pool_io_engine.h"
+
+#include <unistd.h>
+
+#include <cerrno>
+#include <stdexcept>
+
+#include "../../include/common/logger.h"
+
+ThreadPoolIOEngine::ThreadPoolIOEngine(size_t num_workers) : stopping_(false) {
+  if (num_workers == 0) {
+    throw std::invalid_argument("ThreadPoolIOEngine requires >= 1 worker");
+  }
+
+  workers_.reserve(num_workers);
+  for (size_t i = 0; i < num_workers; i++) {
+    workers_.emplace_back(&ThreadPoolIOEngine::WorkerLoop, this);
+  }
+
+  LOG_INFO_STREAM("ThreadPoolIOEngine: Started " << num_workers
+                                                 << " I/O workers");
+}
+
+ThreadPoolIOEngine::~ThreadPoolIOEngine() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  cv_.notify_all();
+
+  // Workers drain the queue before exiting
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+std::vector<IOHandle> ThreadPoolIOEngine::Submit(
+    std::vector<IORequest> requests) {
+  std::vector<IOHandle> handles;
+  handles.reserve(requests.size());
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& request : requests) {
+      auto state = std::make_shared<IOHandle::State>();
+      handles.emplace_back(state);
+      queue_.emplace_back(std::move(request), std::move(state));
+    }
+  }
+  cv_.notify_all();
+
+  return handles;
+}
+
+void ThreadPoolIOEngine::WorkerLoop() {
+  while (true) {
+    Job job;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this]() { return stopping_ || !queue_.empty(); });
+      if (queue_.empty()) {
+        return;  // stopping and drained
+      }
+      job = std::move(queue_.front());
+      queue_.pop_front();
+    }
+
+    const IORequest& request = job.first;
+    ssize_t res;
+    if (request.op == IOOpType::READ) {
+      res = pread(request.fd, request.buffer, request.length, request.offset);
+    } else {
+      res = pwrite(request.fd, request.buffer, request.length, request.offset);
+    }
+    if (res < 0) {
+      res = -errno;
+    }
+
+    IOHandle::Complete(job.second.get(), request, res);
+  }
+}
@@ -0,0 +1,144 @@
+#include "../../include/storage/version_clock.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <stdexcept>
+
+#include "../../include/common/logger.h"
+
+namespace {
+
+#pragma pack(push, 1)
+typedef struct {
+  uint32_t magic;
+  uint32_t reserved;
+  uint64_t reserved_timestamp;
+} VersionClockFile;
+#pragma pack(pop)
+
+static_assert(sizeof(VersionClockFile) == 16,
+              "VersionClockFile must be 16 bytes");
+
+}  // namespace
+
+Snapshot& Snapshot::operator=(Snapshot&& other) noexcept {
+  if (this != &other) {
+    Release();
+    clock_ = other.clock_;
+    timestamp_ = other.timestamp_;
+    other.clock_ = nullptr;
+  }
+  return *this;
+}
+
+void Snapshot::Release() {
+  if (clock_ != nullptr) {
+    clock_->ReleaseSnapshot(timestamp_);
+    clock_ = nullptr;
+  }
+}
+
+VersionClock::VersionClock(const std::string& file_name)
+    : file_name_(file_name),
+      fd_(-1),
+      last_timestamp_(0),
+      reserved_timestamp_(0) {
+  fd_ = open(file_name_.c_str(), O_RDWR | O_CREAT, 0644);
+  if (fd_ < 0) {
+    throw std::runtime_error("VersionClock: Failed to open " + file_name_);
+  }
+
+  VersionClockFile file{};
+  const ssize_t read_bytes = pread(fd_, &file, sizeof(file), 0);
+  if (read_bytes == static_cast<ssize_t>(sizeof(file))) {
+    if (file.magic != MAGIC_NUMBER) {
+      close(fd_);
+      throw std::runtime_error("VersionClock: Not a clock file: " +
+                               file_name_);
+    }
+    // Timestamps up to the reservation may have been handed out
+    last_timestamp_ = file.reserved_timestamp;
+    reserved_timestamp_ = file.reserved_timestamp;
+  } else if (read_bytes != 0) {
+    close(fd_);
+    throw std::runtime_error("VersionClock: Failed to read " + file_name_);
+  } else if (!PersistReservation(0)) {
+    close(fd_);
+    throw std::runtime_error("VersionClock: Failed to write " + file_name_);
+  }
+}
+
+VersionClock::~VersionClock() {
+  if (fd_ >= 0) {
+    close(fd_);
+  }
+}
+
+uint64_t VersionClock::BeginWrite() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (last_timestamp_ == reserved_timestamp_ &&
+      !PersistReservation(reserved_timestamp_ + VERSION_CLOCK_RESERVE_BLOCK)) {
+    LOG_ERROR("VersionClock::BeginWrite: Failed to reserve timestamps");
+    return 0;
+  }
+  const uint64_t timestamp = ++last_timestamp_;
+  active_writes_.insert(timestamp);
+  return timestamp;
+}
+
+void VersionClock::EndWrite(uint64_t timestamp) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  active_writes_.erase(timestamp);
+}
+
+Snapshot VersionClock::TakeSnapshot() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const uint64_t timestamp = CurrentSnapshotTimestamp();
+  snapshots_.insert(timestamp);
+  return Snapshot(this, timestamp);
+}
+
+uint64_t VersionClock::GetOldestSnapshotTimestamp() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return snapshots_.empty() ? CurrentSnapshotTimestamp() : *snapshots_.begin();
+}
+
+bool VersionClock::IsWriteActive(uint64_t timestamp) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return active_writes_.count(timestamp) != 0;
+}
+
+uint64_t VersionClock::GetLastTimestamp() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return last_timestamp_;
+}
+
+uint64_t VersionClock::CurrentSnapshotTimestamp() const {
+  // Timestamps only grow, so this never moves backwards
+  return active_writes_.empty() ? last_timestamp_
+                                : *active_writes_.begin() - 1;
+}
+
+bool VersionClock::PersistReservation(uint64_t reserved_timestamp) {
+  VersionClockFile file{};
+  file.magic = MAGIC_NUMBER;
+  file.reserved_timestamp = reserved_timestamp;
+  if (pwrite(fd_, &file, sizeof(file), 0) !=
+          static_cast<ssize_t>(sizeof(file)) ||
+      fsync(fd_) != 0) {
+    LOG_ERROR_STREAM("VersionClock::PersistReservation: Failed to write "
+                     << file_name_);
+    return false;
+  }
+  reserved_timestamp_ = reserved_timestamp;
+  return true;
+}
+
+void VersionClock::ReleaseSnapshot(uint64_t timestamp) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = snapshots_.find(timestamp);
+  if (it != snapshots_.end()) {
+    snapshots_.erase(it);
+  }
+}
@@ -0,0 +1,474 @@
+#include "../../include/storage/versioned_table.h"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+
+#include "../../include/common/logger.h"
+#include "../../include/storage/pinned_tuple.h"
+
+namespace {
+
+constexpr size_t VERSION_HEADER_SIZE = sizeof(TupleVersionHeader);
+
+// Brackets a write with VersionClock::BeginWrite()/EndWrite()
+class WriteTimestamp {
+ public:
+  explicit WriteTimestamp(VersionClock* clock)
+      : clock_(clock), timestamp_(clock->BeginWrite()) {}
+  ~WriteTimestamp() {
+    if (timestamp_ != 0) {
+      clock_->EndWrite(timestamp_);
+    }
+  }
+
+  WriteTimestamp(const WriteTimestamp&) = delete;
+  WriteTimestamp& operator=(const WriteTimestamp&) = delete;
+
+  uint64_t Get() const { return timestamp_; }
+
+ private:
+  VersionClock* clock_;
+  uint64_t timestamp_;
+};
+
+TupleVersionHeader NewHeader(uint64_t created_ts, TupleId home,
+                             uint16_t flags) {
+  TupleVersionHeader header{};
+  header.created_ts = created_ts;
+  header.deleted_ts = VERSION_TS_INFINITY;
+  header.home_page_id = home.page_id;
+  header.home_slot_id = home.slot_id;
+  header.flags = flags;
+  header.next_page_id = INVALID_PAGE_ID;
+  header.next_slot_id = INVALID_SLOT_ID;
+  return header;
+}
+
+std::vector<char> MakeVersion(const TupleVersionHeader& header,
+                              const char* data, size_t size) {
+  std::vector<char> bytes(VERSION_HEADER_SIZE + size);
+  std::memcpy(bytes.data(), &header, VERSION_HEADER_SIZE);
+  if (size > 0) {
+    std::memcpy(bytes.data() + VERSION_HEADER_SIZE, data, size);
+  }
+  return bytes;
+}
+
+// Home recorded in the header of the version stored at tuple_id
+TupleId HomeOf(const TupleVersionHeader& header, TupleId tuple_id) {
+  return header.home_page_id == INVALID_PAGE_ID
+             ? tuple_id
+             : TupleId{header.home_page_id, header.home_slot_id};
+}
+
+TupleId NextOf(const TupleVersionHeader& header) {
+  return {header.next_page_id, header.next_slot_id};
+}
+
+// Empty version left in a vacuumed home slot; no snapshot sees it
+bool IsMarker(const TupleVersionHeader& header) {
+  return header.deleted_ts == 0;
+}
+
+bool IsInvalid(TupleId tuple_id) {
+  return tuple_id.page_id == INVALID_PAGE_ID;
+}
+
+bool TupleIdLess(TupleId a, TupleId b) {
+  return a.page_id != b.page_id ? a.page_id < b.page_id
+                                : a.slot_id < b.slot_id;
+}
+
+}  // namespace
+
+VersionedTable::VersionedTable(PageManager* page_manager, VersionClock* clock)
+    : page_manager_(page_manager), clock_(clock) {
+  if (page_manager_ == nullptr || clock_ == nullptr) {
+    throw std::invalid_argument(
+        "VersionedTable: PageManager and VersionClock must not be null");
+  }
+}
+
+TupleId VersionedTable::InsertTuple(const char* tuple_data,
+                                    uint16_t tuple_size) {
+  if (tuple_data == nullptr || tuple_size == 0 ||
+      tuple_size > MAX_TUPLE_SIZE) {
+    LOG_ERROR_STREAM("VersionedTable::InsertTuple: Invalid tuple of "
+                     << tuple_size << " bytes");
+    return {0, INVALID_SLOT_ID};
+  }
+
+  WriteTimestamp write(clock_);
+  if (write.Get() == 0) {
+    return {0, INVALID_SLOT_ID};
+  }
+
+  // The home of a first version is the slot it lands in
+  const std::vector<char> bytes =
+      MakeVersion(NewHeader(write.Get(), {INVALID_PAGE_ID, INVALID_SLOT_ID}, 0),
+                  tuple_data, tuple_size);
+  return page_manager_->InsertTuple(bytes.data(),
+                                    static_cast<uint16_t>(bytes.size()));
+}
+
+ErrorCode VersionedTable::UpdateTuple(TupleId tuple_id, const char* new_data,
+                                      uint16_t new_size) {
+  if (new_data == nullptr || new_size == 0 || new_size > MAX_TUPLE_SIZE) {
+    LOG_ERROR_STREAM("VersionedTable::UpdateTuple: Invalid tuple of "
+                     << new_size << " bytes");
+    return {-1, "VersionedTable::UpdateTuple: Invalid tuple"};
+  }
+
+  std::lock_guard<std::mutex> lock(WriteLock(tuple_id));
+  WriteTimestamp write(clock_);
+  if (write.Get() == 0) {
+    return {-2, "VersionedTable::UpdateTuple: Failed to begin write"};
+  }
+
+  Version newest;
+  ErrorCode result = FindVersion(tuple_id, VERSION_TS_INFINITY, &newest);
+  if (result.code != 0) {
+    return result;
+  }
+  if (newest.header.deleted_ts != VERSION_TS_INFINITY) {
+    return {-3, "VersionedTable::UpdateTuple: Tuple is deleted"};
+  }
+
+  // 1. The new version, invisible to scans until it is linked in
+  std::vector<char> bytes =
+      MakeVersion(NewHeader(write.Get(), tuple_id, VERSION_PENDING),
+                  new_data, new_size);
+  const TupleId new_id = page_manager_->InsertTuple(
+      bytes.data(), static_cast<uint16_t>(bytes.size()));
+  if (IsInvalid(new_id)) {
+    return {-4, "VersionedTable::UpdateTuple: Failed to store new version"};
+  }
+
+  // 2. Supersede the newest version: from here on snapshots at or after
+  // this write see the new version only
+  newest.header.deleted_ts = write.Get();
+  newest.header.next_page_id = new_id.page_id;
+  newest.header.next_slot_id = new_id.slot_id;
+  newest.header.home_page_id = tuple_id.page_id;
+  newest.header.home_slot_id = tuple_id.slot_id;
+  result = WriteHeader(newest);
+  if (result.code != 0) {
+    page_manager_->DeleteTuple(new_id);
+    return {-5, "VersionedTable::UpdateTuple: Failed to supersede version (" +
+                    result.message + ")"};
+  }
+
+  // 3. Linked in: let scans see it
+  reinterpret_cast<TupleVersionHeader*>(bytes.data())->flags = 0;
+  if (page_manager_->UpdateTuple(new_id, bytes.data(),
+                                 static_cast<uint16_t>(bytes.size()))
+          .code != 0) {
+    LOG_WARNING_STREAM("VersionedTable::UpdateTuple: Version at page "
+                       << new_id.page_id << ", slot " << new_id.slot_id
+                       << " stays pending until Vacuum()");
+  }
+  return {0, "VersionedTable::UpdateTuple: Success"};
+}
+
+ErrorCode VersionedTable::DeleteTuple(TupleId tuple_id) {
+  std::lock_guard<std::mutex> lock(WriteLock(tuple_id));
+  WriteTimestamp write(clock_);
+  if (write.Get() == 0) {
+    return {-1, "VersionedTable::DeleteTuple: Failed to begin write"};
+  }
+
+  Version newest;
+  ErrorCode result = FindVersion(tuple_id, VERSION_TS_INFINITY, &newest);
+  if (result.code != 0) {
+    return result;
+  }
+  if (newest.header.deleted_ts != VERSION_TS_INFINITY) {
+    return {-2, "VersionedTable::DeleteTuple: Tuple is deleted"};
+  }
+
+  newest.header.deleted_ts = write.Get();
+  newest.header.home_page_id = tuple_id.page_id;
+  newest.header.home_slot_id = tuple_id.slot_id;
+  result = WriteHeader(newest);
+  if (result.code != 0) {
+    return {-3, "VersionedTable::DeleteTuple: Failed to stamp version (" +
+                    result.message + ")"};
+  }
+  return {0, "VersionedTable::DeleteTuple: Success"};
+}
+
+ErrorCode VersionedTable::GetTuple(TupleId tuple_id, const Snapshot& snapshot,
+                                   std::vector<char>* out) const {
+  for (int attempt = 0; attempt < MAX_VERSION_CHAIN_RETRIES; ++attempt) {
+    Version version;
+    ErrorCode result =
+        FindVersion(tuple_id, snapshot.GetTimestamp(), &version);
+    if (result.code != 0) {
+      return result;
+    }
+
+    // The slot may have been vacuumed since if the snapshot was released
+    Version copied;
+    if (ReadVersion(version.tuple_id, &copied, out).code == 0 &&
+        copied.header.created_ts == version.header.created_ts &&
+        HomeOf(copied.header, version.tuple_id) == tuple_id) {
+      return {0, "VersionedTable::GetTuple: Success"};
+    }
+  }
+  return {-5, "VersionedTable::GetTuple: Version chain kept changing"};
+}
+
+ErrorCode VersionedTable::GetTuple(TupleId tuple_id,
+                                   std::vector<char>* out) const {
+  const Snapshot snapshot = clock_->TakeSnapshot();
+  return GetTuple(tuple_id, snapshot, out);
+}
+
+size_t VersionedTable::Vacuum() {
+  std::lock_guard<std::mutex> vacuum_lock(vacuum_mutex_);
+  const uint64_t oldest_ts = clock_->GetOldestSnapshotTimestamp();
+
+  // Find the chains, and the pending versions, from the page bytes first:
+  // the scan holds page latches the chain steps need
+  std::vector<TupleId> homes;
+  std::vector<Version> pending;
+  {
+    TableScan scan(page_manager_);
+    TupleView tuple;
+    while (scan.Next(&tuple)) {
+      if (tuple.size < VERSION_HEADER_SIZE) {
+        continue;
+      }
+      TupleVersionHeader header;
+      std::memcpy(&header, tuple.data, VERSION_HEADER_SIZE);
+      homes.push_back(HomeOf(header, tuple.tuple_id));
+      if (header.flags & VERSION_PENDING) {
+        pending.push_back({tuple.tuple_id, tuple.tuple_id, header});
+      }
+    }
+  }
+  std::sort(homes.begin(), homes.end(), TupleIdLess);
+  homes.erase(std::unique(homes.begin(), homes.end()), homes.end());
+
+  size_t freed = 0;
+  for (const TupleId& home : homes) {
+    std::lock_guard<std::mutex> lock(WriteLock(home));
+    freed += VacuumChain(home, oldest_ts);
+  }
+
+  // Pending versions no chain links to were left by an update that failed
+  // or was interrupted by a crash
+  for (const Version& version : pending) {
+    if (clock_->IsWriteActive(version.header.created_ts)) {
+      continue;
+    }
+    const TupleId home = HomeOf(version.header, version.tuple_id);
+    std::lock_guard<std::mutex> lock(WriteLock(home));
+
+    Version newest;
+    std::vector<Version> chain;
+    if (FindVersion(home, VERSION_TS_INFINITY, &newest, &chain).code == 0 &&
+        std::any_of(chain.begin(), chain.end(), [&](const Version& linked) {
+          return linked.physical_id == version.physical_id;
+        })) {
+      continue;
+    }
+
+    // Under the write lock no one else can free and reuse the slot
+    Version stored;
+    if (ReadVersion(version.tuple_id, &stored, nullptr).code == 0 &&
+        (stored.header.flags & VERSION_PENDING) &&
+        stored.header.created_ts == version.header.created_ts &&
+        page_manager_->DeleteTuple(version.tuple_id).code == 0) {
+      ++freed;
+    }
+  }
+  return freed;
+}
+
+std::mutex& VersionedTable::WriteLock(TupleId home) {
+  const size_t hash = std::hash<uint64_t>{}(
+      (static_cast<uint64_t>(home.page_id) << 16) | home.slot_id);
+  return write_locks_[hash % write_locks_.size()];
+}
+
+ErrorCode VersionedTable::ReadVersion(TupleId tuple_id, Version* version,
+                                      std::vector<char>* data) const {
+  PinnedTuple tuple;
+  ErrorCode result = page_manager_->GetTupleView(tuple_id, &tuple);
+  if (result.code != 0) {
+    return result;
+  }
+  if (tuple.Size() < VERSION_HEADER_SIZE) {
+    return {-1, "VersionedTable::ReadVersion: Tuple has no version header"};
+  }
+
+  version->tuple_id = tuple_id;
+  version->physical_id = tuple.GetTupleId();
+  std::memcpy(&version->header, tuple.Data(), VERSION_HEADER_SIZE);
+  if (data != nullptr) {
+    data->assign(tuple.Data() + VERSION_HEADER_SIZE,
+                 tuple.Data() + tuple.Size());
+  }
+  return {0, "VersionedTable::ReadVersion: Success"};
+}
+
+ErrorCode VersionedTable::FindVersion(TupleId home, uint64_t snapshot_ts,
+                                      Version* version,
+                                      std::vector<Version>* chain) const {
+  const bool newest = snapshot_ts == VERSION_TS_INFINITY;
+  for (int attempt = 0; attempt < MAX_VERSION_CHAIN_RETRIES; ++attempt) {
+    if (chain != nullptr) {
+      chain->clear();
+    }
+
+    Version current;
+    if (ReadVersion(home, &current, nullptr).code != 0) {
+      return {-1, "VersionedTable::FindVersion: Tuple not found"};
+    }
+    if (HomeOf(current.header, home) != home) {
+      return {-2, "VersionedTable::FindVersion: Not the id of a tuple"};
+    }
+
+    while (true) {
+      if (chain != nullptr) {
+        chain->push_back(current);
+      }
+      const TupleVersionHeader& header = current.header;
+      const TupleId next_id = NextOf(header);
+      if (!IsMarker(header)) {
+        if (newest ? IsInvalid(next_id)
+                   : header.created_ts <= snapshot_ts &&
+                         snapshot_ts < header.deleted_ts) {
+          *version = current;
+          return {0, "VersionedTable::FindVersion: Success"};
+        }
+        // Versions only get newer along the chain
+        if (header.created_ts > snapshot_ts) {
+          return {-3, "VersionedTable::FindVersion: Tuple not visible"};
+        }
+      }
+      if (IsInvalid(next_id)) {
+        return {-3, "VersionedTable::FindVersion: Tuple not visible"};
+      }
+
+      // A vacuum may have freed (and another write reused) the next slot
+      Version next;
+      if (ReadVersion(next_id, &next, nullptr).code != 0 ||
+          HomeOf(next.header, next_id) != home || IsMarker(next.header) ||
+          (!IsMarker(header) &&
+           next.header.created_ts != header.deleted_ts)) {
+        break;
+      }
+      current = next;
+    }
+  }
+
+  LOG_WARNING_STREAM("VersionedTable::FindVersion: Chain at page "
+                     << home.page_id << ", slot " << home.slot_id
+                     << " kept changing");
+  return {-4, "VersionedTable::FindVersion: Version chain kept changing"};
+}
+
+ErrorCode VersionedTable::WriteHeader(const Version& version) {
+  Version stored;
+  std::vector<char> data;
+  ErrorCode result = ReadVersion(version.tuple_id, &stored, &data);
+  if (result.code != 0) {
+    return result;
+  }
+  const std::vector<char> bytes =
+      MakeVersion(version.header, data.data(), data.size());
+  return page_manager_->UpdateTuple(version.tuple_id, bytes.data(),
+                                    static_cast<uint16_t>(bytes.size()));
+}
+
+size_t VersionedTable::VacuumChain(TupleId home, uint64_t oldest_ts) {
+  Version newest;
+  std::vector<Version> chain;
+  if (FindVersion(home, VERSION_TS_INFINITY, &newest, &chain).code != 0) {
+    return 0;
+  }
+
+  // Linked in by an update a crash interrupted before it could say so
+  for (Version& version : chain) {
+    if (version.header.flags & VERSION_PENDING) {
+      version.header.flags &= ~VERSION_PENDING;
+      WriteHeader(version);
+    }
+  }
+
+  size_t first_live = 0;
+  while (first_live < chain.size() &&
+         chain[first_live].header.deleted_ts <= oldest_ts) {
+    ++first_live;
+  }
+
+  size_t freed = 0;
+  if (first_live == chain.size()) {
+    // Deleted, and no snapshot sees any version: readers entering at the
+    // home find nothing from here on
+    for (size_t i = 0; i < chain.size(); ++i) {
+      if (page_manager_->DeleteTuple(chain[i].tuple_id).code == 0 &&
+          !IsMarker(chain[i].header)) {
+        ++freed;
+      }
+    }
+    return freed;
+  }
+  if (first_live == 0 ||
+      (first_live == 1 && IsMarker(chain[0].header))) {
+    return 0;
+  }
+
+  // Point the home straight at the oldest version still seen, then free
+  // the ones in between
+  TupleVersionHeader marker{};
+  marker.home_page_id = home.page_id;
+  marker.home_slot_id = home.slot_id;
+  marker.next_page_id = chain[first_live].tuple_id.page_id;
+  marker.next_slot_id = chain[first_live].tuple_id.slot_id;
+  if (page_manager_->UpdateTuple(home, reinterpret_cast<const char*>(&marker),
+                                 VERSION_HEADER_SIZE)
+          .code != 0) {
+    return 0;
+  }
+  if (!IsMarker(chain[0].header)) {
+    ++freed;
+  }
+  for (size_t i = 1; i < first_live; ++i) {
+    if (page_manager_->DeleteTuple(chain[i].tuple_id).code == 0) {
+      ++freed;
+    }
+  }
+  return freed;
+}
+
+VersionedScan::VersionedScan(const VersionedTable* table,
+                             const Snapshot& snapshot,
+                             size_t read_ahead_pages)
+    : scan_(table->GetPageManager(), read_ahead_pages),
+      snapshot_(snapshot),
+      versions_skipped_(0) {}
+
+bool VersionedScan::Next(TupleView* tuple) {
+  while (scan_.Next(tuple)) {
+    TupleVersionHeader header;
+    if (tuple->size < VERSION_HEADER_SIZE) {
+      ++versions_skipped_;
+      continue;
+    }
+    std::memcpy(&header, tuple->data, VERSION_HEADER_SIZE);
+    if ((header.flags & VERSION_PENDING) || !snapshot_.Sees(header)) {
+      ++versions_skipped_;
+      continue;
+    }
+    tuple->tuple_id = HomeOf(header, tuple->tuple_id);
+    tuple->data += VERSION_HEADER_SIZE;
+    tuple->size = static_cast<uint16_t>(tuple->size - VERSION_HEADER_SIZE);
+    return true;
+  }
+  return false;
+}
@@ -0,0 +1,698 @@
+#include "../../include/storage/zone_map.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+
+#include "../../include/common/logger.h"
+#include "../../include/tuple/overflow_value.h"
+#include "../../include/tuple/tuple_header.h"
+
+namespace {
+
+// Marker stored in a header offset slot for a NULL variable-length field
+constexpr uint16_t NULL_VAR_OFFSET = 0xFFFF;
+
+constexpr size_t BLOOM_HASHES = 3;
+
+#pragma pack(push, 1)
+typedef struct {
+  uint16_t field_index;
+  uint8_t type;
+  uint8_t reserved;
+} ZoneMapFileColumn;
+
+typedef struct {
+  uint32_t magic;
+  uint32_t clean;
+  uint32_t column_count;
+  uint32_t bloom_bits;
+  uint32_t entry_count;
+  ZoneMapFileColumn columns[ZONE_MAP_MAX_COLUMNS];
+} ZoneMapFileHeader;
+
+typedef struct {
+  uint32_t tracked;
+  uint32_t row_count;
+} ZonePageEntry;
+
+// min/max hold the bit patterns of doubles for FLOAT and DOUBLE columns
+typedef struct {
+  uint32_t null_count;
+  uint32_t has_values;
+  int64_t min;
+  int64_t max;
+} ZoneColumnEntry;
+#pragma pack(pop)
+
+static_assert(sizeof(ZoneMapFileHeader) <= ZoneMap::HEADER_SIZE,
+              "Zone map header must fit HEADER_SIZE");
+static_assert(sizeof(ZonePageEntry) == 8, "ZonePageEntry must be 8 bytes");
+static_assert(sizeof(ZoneColumnEntry) == 24,
+              "ZoneColumnEntry must be 24 bytes");
+
+bool IsFloatingType(DataType type) {
+  return type == DataType::FLOAT || type == DataType::DOUBLE;
+}
+
+bool IsStringType(DataType type) {
+  return type == DataType::CHAR || type == DataType::VARCHAR ||
+         type == DataType::TEXT;
+}
+
+// FNV-1a, then the murmur3 finalizer. Stored in bloom filters: do not
+// change.
+uint64_t HashBytes(const void* data, size_t size) {
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  uint64_t hash = 14695981039346656037ull;
+  for (size_t i = 0; i < size; i++) {
+    hash ^= bytes[i];
+    hash *= 1099511628211ull;
+  }
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdull;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ull;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+uint64_t HashInt(int64_t value) { return HashBytes(&value, sizeof(value)); }
+
+uint64_t HashDouble(double value) {
+  if (value == 0) {
+    value = 0;  // -0.0 == 0.0
+  }
+  return HashBytes(&value, sizeof(value));
+}
+
+// Bit i of BLOOM_HASHES derived from hash by double hashing
+size_t BloomBit(uint64_t hash, size_t i, size_t bits) {
+  const uint64_t step = (hash >> 32) | 1;
+  return static_cast<size_t>((hash + i * step) % bits);
+}
+
+void BloomAdd(char* bloom, size_t bytes, uint64_t hash) {
+  for (size_t i = 0; i < BLOOM_HASHES; i++) {
+    const size_t bit = BloomBit(hash, i, bytes * 8);
+    bloom[bit / 8] = static_cast<char>(bloom[bit / 8] | (1 << (bit % 8)));
+  }
+}
+
+bool BloomMayContain(const char* bloom, size_t bytes, uint64_t hash) {
+  for (size_t i = 0; i < BLOOM_HASHES; i++) {
+    const size_t bit = BloomBit(hash, i, bytes * 8);
+    if (!((bloom[bit / 8] >> (bit % 8)) & 1)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+double ToDouble(int64_t bits) {
+  double value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+int64_t FromDouble(double value) {
+  int64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+// Integer field (BOOLEAN through BIGINT) widened to int64_t
+int64_t ReadInteger(const FieldLayout& field, const char* tuple) {
+  const char* at = tuple + field.offset;
+  switch (field.type) {
+    case DataType::BOOLEAN: {
+      uint8_t value;
+      std::memcpy(&value, at, sizeof(value));
+      return value;
+    }
+    case DataType::TINYINT: {
+      int8_t value;
+      std::memcpy(&value, at, sizeof(value));
+      return value;
+    }
+    case DataType::SMALLINT: {
+      int16_t value;
+      std::memcpy(&value, at, sizeof(value));
+      return value;
+    }
+    case DataType::INTEGER: {
+      int32_t value;
+      std::memcpy(&value, at, sizeof(value));
+      return value;
+    }
+    default: {
+      int64_t value;
+      std::memcpy(&value, at, sizeof(value));
+      return value;
+    }
+  }
+}
+
+double ReadFloating(const FieldLayout& field, const char* tuple) {
+  if (field.type == DataType::FLOAT) {
+    float value;
+    std::memcpy(&value, tuple + field.offset, sizeof(value));
+    return value;
+  }
+  double value;
+  std::memcpy(&value, tuple + field.offset, sizeof(value));
+  return value;
+}
+
+enum class StringField { VALUE, OUT_OF_LINE, NONE };
+
+// String field as ScanPredicate compares it (CHAR without its padding).
+// NONE for a missing or malformed value, which never matches.
+// var_offsets_start is Schema::GetVarOffsetsStart()
+StringField ReadString(const FieldLayout& field, size_t var_offsets_start,
+                       const char* tuple, size_t size,
+                       std::string_view* value) {
+  if (field.IsDictionaryEncoded()) {
+    dictionary_code_t code;
+    std::memcpy(&code, tuple + field.offset, sizeof(code));
+    if (code >= field.dictionary->GetSize()) {
+      return StringField::NONE;
+    }
+    *value = field.dictionary->Decode(code);
+    return StringField::VALUE;
+  }
+  if (field.IsFixedLength()) {
+    *value = std::string_view(tuple + field.offset, field.size);
+    *value = value->substr(0, value->find('\0'));
+    return StringField::VALUE;
+  }
+  uint16_t offset;
+  std::memcpy(&offset,
+              tuple + var_offsets_start + field.var_index * sizeof(uint16_t),
+              sizeof(uint16_t));
+  if (offset == NULL_VAR_OFFSET ||
+      static_cast<size_t>(offset) + sizeof(uint16_t) > size) {
+    return StringField::NONE;
+  }
+  uint16_t length;
+  std::memcpy(&length, tuple + offset, sizeof(uint16_t));
+  if (length == OVERFLOW_VALUE_MARKER) {
+    return StringField::OUT_OF_LINE;
+  }
+  if (offset + sizeof(uint16_t) + length > size) {
+    return StringField::NONE;
+  }
+  *value = std::string_view(tuple + offset + sizeof(uint16_t), length);
+  return StringField::VALUE;
+}
+
+// Whether a value in [min, max] can satisfy the condition's ranges
+template <typename Range, typename T>
+bool RangesMayMatch(const std::vector<Range>& ranges, bool negate, T min,
+                    T max) {
+  if (negate) {
+    // Only a range covering every value rules the page out
+    for (const Range& range : ranges) {
+      if (range.low <= min && max <= range.high) {
+        return false;
+      }
+    }
+    return true;
+  }
+  for (const Range& range : ranges) {
+    if (range.low <= max && min <= range.high) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// EQ/IN: every range is a single value, few enough to probe
+template <typename Range>
+bool IsPointSet(const std::vector<Range>& ranges) {
+  if (ranges.size() > ZONE_MAP_MAX_BLOOM_PROBES) {
+    return false;
+  }
+  for (const Range& range : ranges) {
+    if (range.low != range.high) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+ZoneMap::ZoneMap(const std::string& file_name, const Schema& schema,
+                 const std::vector<std::string>& columns, size_t bloom_bits)
+    : file_name_(file_name),
+      fd_(-1),
+      schema_(schema),
+      min_tuple_size_(0),
+      bloom_bytes_(bloom_bits / 8),
+      column_bytes_(0),
+      entry_size_(0),
+      tracked_pages_(0),
+      active_changes_(0),
+      clean_on_disk_(false) {
+  if (!schema_.IsFinalized()) {
+    throw std::invalid_argument("Schema must be finalized for zone maps");
+  }
+  if (columns.empty() || columns.size() > ZONE_MAP_MAX_COLUMNS) {
+    throw std::invalid_argument("Zone maps summarize 1 to " +
+                                std::to_string(ZONE_MAP_MAX_COLUMNS) +
+                                " columns");
+  }
+  if (bloom_bits % 64 != 0 || bloom_bits > ZONE_MAP_MAX_BLOOM_BITS) {
+    throw std::invalid_argument("Bloom filter bits must be a multiple of 64 "
+                                "up to " +
+                                std::to_string(ZONE_MAP_MAX_BLOOM_BITS));
+  }
+  for (const std::string& name : columns) {
+    const ColumnDefinition* definition = schema_.FindColumn(name);
+    if (definition == nullptr) {
+      throw std::invalid_argument("Unknown column: " + name);
+    }
+    if (definition->GetDataType() == DataType::BLOB) {
+      throw std::invalid_argument("Zone maps do not summarize BLOB columns: " +
+                                  name);
+    }
+    columns_.push_back(
+        {name, schema_.GetLayout()[definition->GetFieldIndex()]});
+  }
+  min_tuple_size_ =
+      std::max(schema_.GetTupleHeaderSize(), schema_.GetFixedSectionEnd());
+  column_bytes_ = sizeof(ZoneColumnEntry) + bloom_bytes_;
+  entry_size_ = sizeof(ZonePageEntry) + columns_.size() * column_bytes_;
+
+  fd_ = open(file_name_.c_str(), O_RDWR | O_CREAT, 0644);
+  if (fd_ < 0) {
+    LOG_ERROR_STREAM("ZoneMap: Failed to open " << file_name_);
+    throw std::runtime_error("Failed to open zone map file: " + file_name_);
+  }
+  Load();
+}
+
+ZoneMap::~ZoneMap() {
+  if (!Flush()) {
+    LOG_ERROR_STREAM("ZoneMap: Failed to flush " << file_name_);
+  }
+  if (fd_ >= 0) {
+    close(fd_);
+  }
+}
+
+void ZoneMap::Load() {
+  const off_t file_size = lseek(fd_, 0, SEEK_END);
+  if (file_size < 0) {
+    close(fd_);
+    fd_ = -1;
+    throw std::runtime_error("Failed to read zone map file: " + file_name_);
+  }
+
+  ZoneMapFileHeader header{};
+  bool usable = static_cast<size_t>(file_size) >= HEADER_SIZE &&
+                pread(fd_, &header, sizeof(header), 0) ==
+                    static_cast<ssize_t>(sizeof(header)) &&
+                header.magic == MAGIC_NUMBER && header.clean == 1 &&
+                header.column_count == columns_.size() &&
+                header.bloom_bits == bloom_bytes_ * 8 &&
+                static_cast<size_t>(file_size) >=
+                    HEADER_SIZE + header.entry_count * entry_size_;
+  for (size_t c = 0; usable && c < columns_.size(); c++) {
+    usable = header.columns[c].field_index == columns_[c].field.field_index &&
+             header.columns[c].type ==
+                 static_cast<uint8_t>(columns_[c].field.type);
+  }
+
+  if (usable) {
+    entries_.resize(header.entry_count * entry_size_);
+    usable = entries_.empty() ||
+             pread(fd_, entries_.data(), entries_.size(), HEADER_SIZE) ==
+                 static_cast<ssize_t>(entries_.size());
+  }
+  if (!usable) {
+    if (file_size > 0) {
+      LOG_WARNING_STREAM("ZoneMap: Discarding " << file_name_
+                         << " (unclean or built for other columns)");
+    }
+    entries_.clear();
+    if (ftruncate(fd_, 0) < 0 || !WriteHeader(true)) {
+      close(fd_);
+      fd_ = -1;
+      throw std::runtime_error("Failed to write zone map file: " +
+                               file_name_);
+    }
+  }
+
+  dirty_.assign(entries_.size() / entry_size_, false);
+  tracked_pages_ = 0;
+  for (size_t page = 0; page < dirty_.size(); page++) {
+    ZonePageEntry page_entry;
+    std::memcpy(&page_entry, entries_.data() + page * entry_size_,
+                sizeof(page_entry));
+    tracked_pages_ += page_entry.tracked != 0;
+  }
+  clean_on_disk_ = true;
+}
+
+bool ZoneMap::WriteHeader(bool clean) {
+  std::vector<char> buffer(HEADER_SIZE, 0);
+  ZoneMapFileHeader header{};
+  header.magic = MAGIC_NUMBER;
+  header.clean = clean ? 1 : 0;
+  header.column_count = static_cast<uint32_t>(columns_.size());
+  header.bloom_bits = static_cast<uint32_t>(bloom_bytes_ * 8);
+  header.entry_count = static_cast<uint32_t>(entries_.size() / entry_size_);
+  for (size_t c = 0; c < columns_.size(); c++) {
+    header.columns[c].field_index = columns_[c].field.field_index;
+    header.columns[c].type = static_cast<uint8_t>(columns_[c].field.type);
+  }
+  std::memcpy(buffer.data(), &header, sizeof(header));
+  return pwrite(fd_, buffer.data(), HEADER_SIZE, 0) ==
+             static_cast<ssize_t>(HEADER_SIZE) &&
+         fsync(fd_) == 0;
+}
+
+bool ZoneMap::BeginChange() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (clean_on_disk_) {
+    if (fd_ < 0 || !WriteHeader(false)) {
+      LOG_ERROR_STREAM("ZoneMap::BeginChange: Failed to mark "
+                       << file_name_ << " unclean");
+      return false;
+    }
+    clean_on_disk_ = false;
+  }
+  active_changes_++;
+  return true;
+}
+
+void ZoneMap::EndChange() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (active_changes_ > 0) {
+    active_changes_--;
+  }
+}
+
+char* ZoneMap::MutableEntry(page_id_t page_id) {
+  if (page_id >= dirty_.size()) {
+    entries_.resize((static_cast<size_t>(page_id) + 1) * entry_size_, 0);
+    dirty_.resize(static_cast<size_t>(page_id) + 1, false);
+  }
+  dirty_[page_id] = true;
+  return entries_.data() + page_id * entry_size_;
+}
+
+const char* ZoneMap::Entry(page_id_t page_id) const {
+  if (page_id >= dirty_.size()) {
+    return nullptr;
+  }
+  const char* entry = entries_.data() + page_id * entry_size_;
+  ZonePageEntry page_entry;
+  std::memcpy(&page_entry, entry, sizeof(page_entry));
+  return page_entry.tracked != 0 ? entry : nullptr;
+}
+
+void ZoneMap::Summarize(char* entry, const char* tuple, uint16_t size,
+                        int sign) const {
+  ZonePageEntry page_entry;
+  std::memcpy(&page_entry, entry, sizeof(page_entry));
+  if (sign > 0) {
+    page_entry.row_count++;
+  } else if (page_entry.row_count > 0) {
+    page_entry.row_count--;
+  }
+  std::memcpy(entry, &page_entry, sizeof(page_entry));
+  if (tuple == nullptr || size < min_tuple_size_) {
+    return;
+  }
+
+  for (size_t c = 0; c < columns_.size(); c++) {
+    const FieldLayout& field = columns_[c].field;
+    char* at = entry + sizeof(ZonePageEntry) + c * column_bytes_;
+    char* bloom = at + sizeof(ZoneColumnEntry);
+    ZoneColumnEntry stats;
+    std::memcpy(&stats, at, sizeof(stats));
+
+    if (TupleHeader::IsNullBitSet(tuple, field.field_index)) {
+      if (sign > 0) {
+        stats.null_count++;
+      } else if (stats.null_count > 0) {
+        stats.null_count--;
+      }
+      std::memcpy(at, &stats, sizeof(stats));
+      continue;
+    }
+    if (sign < 0) {
+      continue;  // values only widen
+    }
+
+    if (IsStringType(field.type)) {
+      std::string_view value;
+      switch (ReadString(field, schema_.GetVarOffsetsStart(), tuple, size,
+                         &value)) {
+        case StringField::VALUE:
+          if (bloom_bytes_ > 0) {
+            BloomAdd(bloom, bloom_bytes_,
+                     HashBytes(value.data(), value.size()));
+          }
+          break;
+        case StringField::OUT_OF_LINE:
+          std::memset(bloom, 0xFF, bloom_bytes_);
+          break;
+        case StringField::NONE:
+          continue;
+      }
+      stats.has_values = 1;
+    } else if (IsFloatingType(field.type)) {
+      double value = ReadFloating(field, tuple);
+      double low = value;
+      double high = value;
+      if (std::isnan(value)) {
+        low = -std::numeric_limits<double>::infinity();
+        high = std::numeric_limits<double>::infinity();
+      } else if (bloom_bytes_ > 0) {
+        BloomAdd(bloom, bloom_bytes_, HashDouble(value));
+      }
+      if (stats.has_values) {
+        low = std::min(low, ToDouble(stats.min));
+        high = std::max(high, ToDouble(stats.max));
+      }
+      stats.min = FromDouble(low);
+      stats.max = FromDouble(high);
+      stats.has_values = 1;
+    } else {
+      const int64_t value = ReadInteger(field, tuple);
+      if (bloom_bytes_ > 0) {
+        BloomAdd(bloom, bloom_bytes_, HashInt(value));
+      }
+      stats.min = stats.has_values ? std::min(stats.min, value) : value;
+      stats.max = stats.has_values ? std::max(stats.max, value) : value;
+      stats.has_values = 1;
+    }
+    std::memcpy(at, &stats, sizeof(stats));
+  }
+}
+
+bool ZoneMap::AddTuple(page_id_t page_id, const char* tuple, uint16_t size) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (Entry(page_id) == nullptr) {
+    return false;
+  }
+  Summarize(MutableEntry(page_id), tuple, size, 1);
+  return true;
+}
+
+void ZoneMap::RemoveTuple(page_id_t page_id, const char* tuple,
+                          uint16_t size) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (Entry(page_id) != nullptr) {
+    Summarize(MutableEntry(page_id), tuple, size, -1);
+  }
+}
+
+void ZoneMap::ResetPage(page_id_t page_id, const TupleSlice* tuples,
+                        size_t count) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (Entry(page_id) == nullptr) {
+    tracked_pages_++;
+  }
+  char* entry = MutableEntry(page_id);
+  std::memset(entry, 0, entry_size_);
+  const ZonePageEntry page_entry{1, 0};
+  std::memcpy(entry, &page_entry, sizeof(page_entry));
+  for (size_t i = 0; i < count; i++) {
+    Summarize(entry, tuples[i].data, tuples[i].size, 1);
+  }
+}
+
+bool ZoneMap::IsTracked(page_id_t page_id) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return Entry(page_id) != nullptr;
+}
+
+size_t ZoneMap::GetTrackedPageCount() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return tracked_pages_;
+}
+
+bool ZoneMap::MayMatch(page_id_t page_id,
+                       const ScanPredicate& predicate) const {
+  using Kind = ScanPredicate::Kind;
+  std::lock_guard<std::mutex> lock(mutex_);
+  const char* entry = Entry(page_id);
+  if (entry == nullptr) {
+    return true;
+  }
+
+  for (const ScanPredicate::Condition& condition : predicate.GetConditions()) {
+    size_t c = 0;
+    while (c < columns_.size() &&
+           (columns_[c].field.field_index != condition.field.field_index ||
+            columns_[c].field.type != condition.field.type)) {
+      c++;
+    }
+    if (c == columns_.size()) {
+      continue;  // not summarized
+    }
+    const char* at = entry + sizeof(ZonePageEntry) + c * column_bytes_;
+    const char* bloom = at + sizeof(ZoneColumnEntry);
+    ZoneColumnEntry stats;
+    std::memcpy(&stats, at, sizeof(stats));
+    if (!stats.has_values) {
+      return false;  // NULL fails every condition
+    }
+    const bool probe = bloom_bytes_ > 0 && !condition.negate;
+
+    switch (condition.kind) {
+      case Kind::INT32:
+      case Kind::INT64: {
+        if (!RangesMayMatch(condition.int_ranges, condition.negate,
+                            stats.min, stats.max)) {
+          return false;
+        }
+        if (probe && IsPointSet(condition.int_ranges) &&
+            std::none_of(condition.int_ranges.begin(),
+                         condition.int_ranges.end(),
+                         [&](const ScanPredicate::IntRange& range) {
+                           return BloomMayContain(bloom, bloom_bytes_,
+                                                  HashInt(range.low));
+                         })) {
+          return false;
+        }
+        break;
+      }
+      case Kind::DOUBLE: {
+        if (!RangesMayMatch(condition.double_ranges, condition.negate,
+                            ToDouble(stats.min), ToDouble(stats.max))) {
+          return false;
+        }
+        if (probe && IsPointSet(condition.double_ranges) &&
+            std::none_of(condition.double_ranges.begin(),
+                         condition.double_ranges.end(),
+                         [&](const ScanPredicate::DoubleRange& range) {
+                           return BloomMayContain(bloom, bloom_bytes_,
+                                                  HashDouble(range.low));
+                         })) {
+          return false;
+        }
+        break;
+      }
+      case Kind::STRING:
+        if (probe &&
+            condition.strings.size() <= ZONE_MAP_MAX_BLOOM_PROBES &&
+            std::none_of(condition.strings.begin(), condition.strings.end(),
+                         [&](const std::string& value) {
+                           return BloomMayContain(
+                               bloom, bloom_bytes_,
+                               HashBytes(value.data(), value.size()));
+                         })) {
+          return false;
+        }
+        break;
+      case Kind::PREFIX:
+        break;
+    }
+  }
+  return true;
+}
+
+bool ZoneMap::GetSummary(page_id_t page_id, const std::string& column,
+                         ZoneSummary* summary) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const char* entry = Entry(page_id);
+  size_t c = 0;
+  while (c < columns_.size() && columns_[c].name != column) {
+    c++;
+  }
+  if (entry == nullptr || c == columns_.size() || summary == nullptr) {
+    return false;
+  }
+
+  ZonePageEntry page_entry;
+  std::memcpy(&page_entry, entry, sizeof(page_entry));
+  ZoneColumnEntry stats;
+  std::memcpy(&stats, entry + sizeof(ZonePageEntry) + c * column_bytes_,
+              sizeof(stats));
+  *summary = ZoneSummary{};
+  summary->row_count = page_entry.row_count;
+  summary->null_count = stats.null_count;
+  summary->has_values = stats.has_values != 0;
+  if (!summary->has_values || IsStringType(columns_[c].field.type)) {
+    return true;
+  }
+  if (IsFloatingType(columns_[c].field.type)) {
+    summary->min_double = ToDouble(stats.min);
+    summary->max_double = ToDouble(stats.max);
+  } else {
+    summary->min_int = stats.min;
+    summary->max_int = stats.max;
+  }
+  return true;
+}
+
+bool ZoneMap::Flush() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (fd_ < 0) {
+    return false;
+  }
+
+  // Write runs of consecutive dirty entries
+  bool wrote = false;
+  for (size_t page = 0; page < dirty_.size();) {
+    if (!dirty_[page]) {
+      page++;
+      continue;
+    }
+    size_t end = page;
+    while (end < dirty_.size() && dirty_[end]) {
+      dirty_[end++] = false;
+    }
+    const size_t bytes = (end - page) * entry_size_;
+    if (pwrite(fd_, entries_.data() + page * entry_size_, bytes,
+               static_cast<off_t>(HEADER_SIZE + page * entry_size_)) !=
+        static_cast<ssize_t>(bytes)) {
+      std::fill(dirty_.begin() + page, dirty_.begin() + end, true);
+      return false;
+    }
+    wrote = true;
+    page = end;
+  }
+
+  // Mid-change entries may be out of date: stay unclean until none is
+  if (active_changes_ > 0 || (clean_on_disk_ && !wrote)) {
+    return true;
+  }
+  if (fsync(fd_) != 0 || !WriteHeader(true)) {
+    return false;
+  }
+  clean_on_disk_ = true;
+  return true;
+}
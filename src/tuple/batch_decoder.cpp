@@ -0,0 +1,299 @@
+#include "../../include/tuple/batch_decoder.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "../../include/tuple/tuple_header.h"
+
+namespace {
+
+// Marker stored in a header offset slot for a NULL variable-length field
+constexpr uint16_t NULL_VAR_OFFSET = 0xFFFF;
+
+size_t ValidityWords(size_t rows) { return (rows + 63) / 64; }
+
+// Values of every tuple's field at offset, Width bytes each. Width is a
+// compile-time constant so each copy is a single load and store.
+template <size_t Width>
+void CopyFixed(const TupleSlice* tuples, size_t count, uint32_t offset,
+               char* out) {
+  for (size_t i = 0; i < count; i++) {
+    std::memcpy(out + i * Width, tuples[i].data + offset, Width);
+  }
+}
+
+void CopyFixed(const TupleSlice* tuples, size_t count, uint32_t offset,
+               uint32_t width, char* out) {
+  for (size_t i = 0; i < count; i++) {
+    std::memcpy(out + i * width, tuples[i].data + offset, width);
+  }
+}
+
+// Bytes per value of field in a ColumnVector
+uint32_t ColumnWidth(const FieldLayout& field) {
+  return field.IsDictionaryEncoded() ? 0 : field.size;
+}
+
+}  // namespace
+
+ColumnVector::ColumnVector(DataType type, uint32_t width)
+    : type_(type), width_(width), rows_(0), null_count_(0) {
+  if (width_ == 0) {
+    offsets_.push_back(0);
+  }
+}
+
+std::string_view ColumnVector::GetString(size_t row) const {
+  if (type_ == DataType::CHAR && width_ != 0) {
+    const char* value = values_.data() + row * width_;
+    const void* nul = std::memchr(value, '\0', width_);
+    return std::string_view(
+        value, nul != nullptr ? static_cast<const char*>(nul) - value : width_);
+  }
+  if (width_ != 0) {
+    throw std::runtime_error("Type mismatch: expected string type");
+  }
+  return std::string_view(values_.data() + offsets_[row],
+                          offsets_[row + 1] - offsets_[row]);
+}
+
+void ColumnVector::Clear() {
+  rows_ = 0;
+  null_count_ = 0;
+  values_.clear();
+  validity_.clear();
+  if (width_ == 0) {
+    offsets_.assign(1, 0);
+  }
+}
+
+void ColumnBatch::Clear() {
+  rows_ = 0;
+  for (ColumnVector& column : columns_) {
+    column.Clear();
+  }
+}
+
+BatchDecoder::BatchDecoder(const Schema& schema,
+                           std::vector<size_t> projection,
+                           const OverflowValueStore* overflow)
+    : schema_(schema), projection_(std::move(projection)), overflow_(overflow) {
+  if (!schema_.IsFinalized()) {
+    throw std::invalid_argument("Schema must be finalized before decoding");
+  }
+  for (size_t field_index : projection_) {
+    if (field_index >= schema_.GetColumnCount()) {
+      throw std::invalid_argument("Projected field index out of range: " +
+                                  std::to_string(field_index));
+    }
+  }
+}
+
+void BatchDecoder::PrepareBatch(ColumnBatch* batch) const {
+  const std::vector<FieldLayout>& layout = schema_.GetLayout();
+  if (batch->columns_.empty() && batch->rows_ == 0) {
+    batch->columns_.reserve(projection_.size());
+    for (size_t field_index : projection_) {
+      const FieldLayout& field = layout[field_index];
+      batch->columns_.emplace_back(field.type, ColumnWidth(field));
+    }
+    return;
+  }
+
+  bool matches = batch->columns_.size() == projection_.size();
+  for (size_t i = 0; matches && i < projection_.size(); i++) {
+    const FieldLayout& field = layout[projection_[i]];
+    matches = batch->columns_[i].type_ == field.type &&
+              batch->columns_[i].width_ == ColumnWidth(field);
+  }
+  if (!matches) {
+    throw std::invalid_argument(
+        "ColumnBatch columns do not match the decoder's projection");
+  }
+}
+
+void BatchDecoder::Decode(const TupleSlice* tuples, size_t count,
+                          ColumnBatch* batch) {
+  if (batch == nullptr || (tuples == nullptr && count > 0)) {
+    throw std::invalid_argument("BatchDecoder::Decode: null argument");
+  }
+  PrepareBatch(batch);
+
+  // One pass over the sizes; every column loop below may rely on the
+  // header and fixed section being present
+  const size_t min_size =
+      std::max(schema_.GetTupleHeaderSize(), schema_.GetFixedSectionEnd());
+  for (size_t i = 0; i < count; i++) {
+    if (tuples[i].data == nullptr || tuples[i].size < min_size) {
+      throw std::runtime_error("Buffer too small for fixed-length data");
+    }
+  }
+
+  const std::vector<FieldLayout>& layout = schema_.GetLayout();
+  std::vector<std::pair<size_t, size_t>> saved;  // rows, nulls per column
+  saved.reserve(batch->columns_.size());
+  for (const ColumnVector& column : batch->columns_) {
+    saved.emplace_back(column.rows_, column.null_count_);
+  }
+
+  try {
+    for (size_t i = 0; i < projection_.size(); i++) {
+      const FieldLayout& field = layout[projection_[i]];
+      ColumnVector* column = &batch->columns_[i];
+      if (field.IsDictionaryEncoded()) {
+        DecodeDictionary(field, tuples, count, column);
+      } else if (field.IsFixedLength()) {
+        DecodeFixed(field, tuples, count, column);
+      } else {
+        DecodeVariable(field, tuples, count, column);
+      }
+    }
+  } catch (...) {
+    for (size_t i = 0; i < batch->columns_.size(); i++) {
+      ColumnVector& column = batch->columns_[i];
+      column.rows_ = saved[i].first;
+      column.null_count_ = saved[i].second;
+      if (column.width_ == 0) {
+        column.offsets_.resize(column.rows_ + 1);
+        column.values_.resize(column.offsets_.back());
+      } else {
+        column.values_.resize(column.rows_ * column.width_);
+      }
+      column.validity_.resize(ValidityWords(column.rows_));
+      if (column.rows_ % 64 != 0) {
+        column.validity_.back() &= (uint64_t{1} << (column.rows_ % 64)) - 1;
+      }
+    }
+    throw;
+  }
+  batch->rows_ += count;
+}
+
+void BatchDecoder::DecodeFixed(const FieldLayout& field,
+                               const TupleSlice* tuples, size_t count,
+                               ColumnVector* column) const {
+  const size_t base = column->rows_;
+  column->values_.resize((base + count) * field.size);
+  char* out = column->values_.data() + base * field.size;
+  switch (field.size) {
+    case 1:
+      CopyFixed<1>(tuples, count, field.offset, out);
+      break;
+    case 2:
+      CopyFixed<2>(tuples, count, field.offset, out);
+      break;
+    case 4:
+      CopyFixed<4>(tuples, count, field.offset, out);
+      break;
+    case 8:
+      CopyFixed<8>(tuples, count, field.offset, out);
+      break;
+    default:
+      CopyFixed(tuples, count, field.offset, field.size, out);
+      break;
+  }
+
+  column->validity_.resize(ValidityWords(base + count), 0);
+  size_t nulls = 0;
+  for (size_t i = 0; i < count; i++) {
+    const uint64_t is_null =
+        TupleHeader::IsNullBitSet(tuples[i].data, field.field_index) ? 1 : 0;
+    const size_t row = base + i;
+    column->validity_[row / 64] |= (is_null ^ 1) << (row % 64);
+    if (is_null != 0) {
+      std::memset(out + i * field.size, 0, field.size);
+      nulls++;
+    }
+  }
+  column->null_count_ += nulls;
+  column->rows_ = base + count;
+}
+
+void BatchDecoder::DecodeVariable(const FieldLayout& field,
+                                  const TupleSlice* tuples, size_t count,
+                                  ColumnVector* column) const {
+  const size_t base = column->rows_;
+  const size_t slot =
+      schema_.GetVarOffsetsStart() + field.var_index * sizeof(uint16_t);
+  column->offsets_.reserve(base + count + 1);
+  column->validity_.resize(ValidityWords(base + count), 0);
+  std::string out_of_line;
+
+  for (size_t i = 0; i < count; i++) {
+    const char* buffer = tuples[i].data;
+    const size_t buffer_size = tuples[i].size;
+    const size_t row = base + i;
+
+    uint16_t offset;
+    std::memcpy(&offset, buffer + slot, sizeof(uint16_t));
+    if (TupleHeader::IsNullBitSet(buffer, field.field_index) ||
+        offset == NULL_VAR_OFFSET) {
+      column->offsets_.push_back(column->offsets_.back());
+      column->null_count_++;
+      continue;
+    }
+    if (static_cast<size_t>(offset) + sizeof(uint16_t) > buffer_size) {
+      throw std::runtime_error("Variable-length field past end of buffer");
+    }
+
+    uint16_t length;
+    std::memcpy(&length, buffer + offset, sizeof(uint16_t));
+    std::string_view bytes;
+    if (length == OVERFLOW_VALUE_MARKER) {
+      if (offset + OVERFLOW_FIELD_SIZE > buffer_size) {
+        throw std::runtime_error("Variable-length field past end of buffer");
+      }
+      if (overflow_ == nullptr) {
+        throw std::runtime_error("Value is stored out of line; an "
+                                 "OverflowValueStore is needed to read it");
+      }
+      OverflowPointer pointer;
+      std::memcpy(&pointer, buffer + offset + sizeof(uint16_t),
+                  sizeof(pointer));
+      ErrorCode result = overflow_->Read(pointer, &out_of_line);
+      if (result.code != 0) {
+        throw std::runtime_error("Failed to read out-of-line value: " +
+                                 result.message);
+      }
+      bytes = out_of_line;
+    } else {
+      if (offset + sizeof(uint16_t) + length > buffer_size) {
+        throw std::runtime_error("Variable-length field past end of buffer");
+      }
+      bytes = std::string_view(buffer + offset + sizeof(uint16_t), length);
+    }
+
+    column->values_.insert(column->values_.end(), bytes.begin(), bytes.end());
+    column->offsets_.push_back(static_cast<uint32_t>(column->values_.size()));
+    column->validity_[row / 64] |= uint64_t{1} << (row % 64);
+  }
+  column->rows_ = base + count;
+}
+
+void BatchDecoder::DecodeDictionary(const FieldLayout& field,
+                                    const TupleSlice* tuples, size_t count,
+                                    ColumnVector* column) const {
+  const size_t base = column->rows_;
+  column->offsets_.reserve(base + count + 1);
+  column->validity_.resize(ValidityWords(base + count), 0);
+
+  for (size_t i = 0; i < count; i++) {
+    const size_t row = base + i;
+    if (TupleHeader::IsNullBitSet(tuples[i].data, field.field_index)) {
+      column->offsets_.push_back(column->offsets_.back());
+      column->null_count_++;
+      continue;
+    }
+
+    dictionary_code_t code;
+    std::memcpy(&code, tuples[i].data + field.offset, sizeof(code));
+    std::string_view bytes = field.dictionary->Decode(code);
+    column->values_.insert(column->values_.end(), bytes.begin(), bytes.end());
+    column->offsets_.push_back(static_cast<uint32_t>(column->values_.size()));
+    column->validity_[row / 64] |= uint64_t{1} << (row % 64);
+  }
+  column->rows_ = base + count;
+}
@@ -0,0 +1,620 @@
+#include "../../include/tuple/scan_predicate.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+#include "../../include/tuple/tuple_header.h"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define STORAGEENGINE_PREDICATE_X86 1
+#endif
+
+namespace {
+
+// Marker stored in a header offset slot for a NULL variable-length field
+constexpr uint16_t NULL_VAR_OFFSET = 0xFFFF;
+
+constexpr size_t BLOCK_SIZE = 64;
+
+uint64_t BlockMask(size_t count) {
+  return count == BLOCK_SIZE ? ~uint64_t{0} : (uint64_t{1} << count) - 1;
+}
+
+bool IsStringType(DataType type) {
+  return type == DataType::CHAR || type == DataType::VARCHAR ||
+         type == DataType::TEXT;
+}
+
+bool IntegerLiteral(const FieldValue& value, int64_t* out) {
+  switch (value.GetType()) {
+    case DataType::BOOLEAN:
+      *out = value.GetBoolean() ? 1 : 0;
+      return true;
+    case DataType::TINYINT:
+      *out = value.GetTinyInt();
+      return true;
+    case DataType::SMALLINT:
+      *out = value.GetSmallInt();
+      return true;
+    case DataType::INTEGER:
+      *out = value.GetInteger();
+      return true;
+    case DataType::BIGINT:
+      *out = value.GetBigInt();
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool DoubleLiteral(const FieldValue& value, double* out) {
+  int64_t integer;
+  if (IntegerLiteral(value, &integer)) {
+    *out = static_cast<double>(integer);
+    return true;
+  }
+  if (value.GetType() == DataType::FLOAT) {
+    *out = value.GetFloat();
+    return true;
+  }
+  if (value.GetType() == DataType::DOUBLE) {
+    *out = value.GetDouble();
+    return true;
+  }
+  return false;
+}
+
+// Values v with "v op literal"; false if there are none
+bool IntRangeFor(CompareOp op, int64_t literal, int64_t* low, int64_t* high) {
+  constexpr int64_t MIN = std::numeric_limits<int64_t>::min();
+  constexpr int64_t MAX = std::numeric_limits<int64_t>::max();
+  *low = MIN;
+  *high = MAX;
+  switch (op) {
+    case CompareOp::EQ:
+    case CompareOp::NE:
+      *low = *high = literal;
+      return true;
+    case CompareOp::LT:
+      *high = literal - 1;
+      return literal != MIN;
+    case CompareOp::LE:
+      *high = literal;
+      return true;
+    case CompareOp::GT:
+      *low = literal + 1;
+      return literal != MAX;
+    case CompareOp::GE:
+      *low = literal;
+      return true;
+  }
+  return false;
+}
+
+bool DoubleRangeFor(CompareOp op, double literal, double* low, double* high) {
+  constexpr double INF = std::numeric_limits<double>::infinity();
+  *low = -INF;
+  *high = INF;
+  if (std::isnan(literal)) {
+    return false;
+  }
+  switch (op) {
+    case CompareOp::EQ:
+    case CompareOp::NE:
+      *low = *high = literal;
+      return true;
+    case CompareOp::LT:
+      *high = std::nextafter(literal, -INF);
+      return literal != -INF;
+    case CompareOp::LE:
+      *high = literal;
+      return true;
+    case CompareOp::GT:
+      *low = std::nextafter(literal, INF);
+      return literal != INF;
+    case CompareOp::GE:
+      *low = literal;
+      return true;
+  }
+  return false;
+}
+
+// Every tuple's field at offset, widened to Dst
+template <typename Src, typename Dst>
+void Gather(const TupleSlice* tuples, size_t count, uint32_t offset,
+            Dst* out) {
+  for (size_t i = 0; i < count; i++) {
+    Src value;
+    std::memcpy(&value, tuples[i].data + offset, sizeof(Src));
+    out[i] = static_cast<Dst>(value);
+  }
+}
+
+// Range kernels: bit i set if low <= values[i] <= high, for count <= 64
+
+template <typename T>
+uint64_t RangeMaskScalar(const T* values, size_t count, T low, T high) {
+  uint64_t mask = 0;
+  for (size_t i = 0; i < count; i++) {
+    mask |= static_cast<uint64_t>(values[i] >= low && values[i] <= high) << i;
+  }
+  return mask;
+}
+
+uint64_t RangeMaskInt32Scalar(const int32_t* values, size_t count,
+                              int32_t low, int32_t high) {
+  return RangeMaskScalar(values, count, low, high);
+}
+
+uint64_t RangeMaskInt64Scalar(const int64_t* values, size_t count,
+                              int64_t low, int64_t high) {
+  return RangeMaskScalar(values, count, low, high);
+}
+
+uint64_t RangeMaskDoubleScalar(const double* values, size_t count,
+                               double low, double high) {
+  return RangeMaskScalar(values, count, low, high);
+}
+
+#if defined(STORAGEENGINE_PREDICATE_X86)
+__attribute__((target("avx2"))) uint64_t RangeMaskInt32Avx2(
+    const int32_t* values, size_t count, int32_t low, int32_t high) {
+  const __m256i lo = _mm256_set1_epi32(low);
+  const __m256i hi = _mm256_set1_epi32(high);
+  uint64_t mask = 0;
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    const __m256i v =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+    const __m256i out =
+        _mm256_or_si256(_mm256_cmpgt_epi32(lo, v), _mm256_cmpgt_epi32(v, hi));
+    const uint64_t bits = static_cast<uint64_t>(
+        ~_mm256_movemask_ps(_mm256_castsi256_ps(out)) & 0xFF);
+    mask |= bits << i;
+  }
+  if (i < count) {
+    mask |= RangeMaskScalar(values + i, count - i, low, high) << i;
+  }
+  return mask;
+}
+
+__attribute__((target("avx2"))) uint64_t RangeMaskInt64Avx2(
+    const int64_t* values, size_t count, int64_t low, int64_t high) {
+  const __m256i lo = _mm256_set1_epi64x(low);
+  const __m256i hi = _mm256_set1_epi64x(high);
+  uint64_t mask = 0;
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    const __m256i v =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+    const __m256i out =
+        _mm256_or_si256(_mm256_cmpgt_epi64(lo, v), _mm256_cmpgt_epi64(v, hi));
+    const uint64_t bits = static_cast<uint64_t>(
+        ~_mm256_movemask_pd(_mm256_castsi256_pd(out)) & 0xF);
+    mask |= bits << i;
+  }
+  if (i < count) {
+    mask |= RangeMaskScalar(values + i, count - i, low, high) << i;
+  }
+  return mask;
+}
+
+__attribute__((target("avx2"))) uint64_t RangeMaskDoubleAvx2(
+    const double* values, size_t count, double low, double high) {
+  const __m256d lo = _mm256_set1_pd(low);
+  const __m256d hi = _mm256_set1_pd(high);
+  uint64_t mask = 0;
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    const __m256d v = _mm256_loadu_pd(values + i);
+    const __m256d in = _mm256_and_pd(_mm256_cmp_pd(v, lo, _CMP_GE_OQ),
+                                     _mm256_cmp_pd(v, hi, _CMP_LE_OQ));
+    mask |= static_cast<uint64_t>(_mm256_movemask_pd(in)) << i;
+  }
+  if (i < count) {
+    mask |= RangeMaskScalar(values + i, count - i, low, high) << i;
+  }
+  return mask;
+}
+#endif
+
+struct RangeKernels {
+  uint64_t (*int32)(const int32_t*, size_t, int32_t, int32_t);
+  uint64_t (*int64)(const int64_t*, size_t, int64_t, int64_t);
+  uint64_t (*dbl)(const double*, size_t, double, double);
+};
+
+RangeKernels ResolveRangeKernels() {
+#if defined(STORAGEENGINE_PREDICATE_X86)
+  if (__builtin_cpu_supports("avx2")) {
+    return {RangeMaskInt32Avx2, RangeMaskInt64Avx2, RangeMaskDoubleAvx2};
+  }
+#endif
+  return {RangeMaskInt32Scalar, RangeMaskInt64Scalar, RangeMaskDoubleScalar};
+}
+
+const RangeKernels& Kernels() {
+  static const RangeKernels kernels = ResolveRangeKernels();
+  return kernels;
+}
+
+}  // namespace
+
+ScanPredicate::ScanPredicate(const Schema& schema,
+                             const OverflowValueStore* overflow)
+    : schema_(schema), overflow_(overflow), min_tuple_size_(0) {
+  if (!schema_.IsFinalized()) {
+    throw std::invalid_argument("Schema must be finalized for predicates");
+  }
+  min_tuple_size_ =
+      std::max(schema_.GetTupleHeaderSize(), schema_.GetFixedSectionEnd());
+  zeros_.assign(min_tuple_size_, 0);
+}
+
+ScanPredicate::Condition ScanPredicate::NewCondition(
+    const std::string& column) const {
+  const ColumnDefinition* definition = schema_.FindColumn(column);
+  if (definition == nullptr) {
+    throw std::invalid_argument("Unknown column: " + column);
+  }
+  Condition condition{};
+  condition.field = schema_.GetLayout()[definition->GetFieldIndex()];
+  switch (condition.field.type) {
+    case DataType::BOOLEAN:
+    case DataType::TINYINT:
+    case DataType::SMALLINT:
+    case DataType::INTEGER:
+      condition.kind = Kind::INT32;
+      break;
+    case DataType::BIGINT:
+      condition.kind = Kind::INT64;
+      break;
+    case DataType::FLOAT:
+    case DataType::DOUBLE:
+      condition.kind = Kind::DOUBLE;
+      break;
+    case DataType::CHAR:
+    case DataType::VARCHAR:
+    case DataType::TEXT:
+      condition.kind = Kind::STRING;
+      break;
+    case DataType::BLOB:
+      throw std::invalid_argument("Predicates on BLOB columns are not "
+                                  "supported: " + column);
+  }
+  return condition;
+}
+
+void ScanPredicate::AddRange(Condition* condition, CompareOp op,
+                             const FieldValue& literal) {
+  if (literal.IsNull()) {
+    throw std::invalid_argument("Predicate literal cannot be NULL");
+  }
+
+  if (condition->kind == Kind::DOUBLE) {
+    double value;
+    if (!DoubleLiteral(literal, &value)) {
+      throw std::invalid_argument("Expected a numeric literal");
+    }
+    DoubleRange range;
+    if (DoubleRangeFor(op, value, &range.low, &range.high)) {
+      condition->double_ranges.push_back(range);
+    }
+    return;
+  }
+
+  int64_t value;
+  if (!IntegerLiteral(literal, &value)) {
+    throw std::invalid_argument("Expected an integer literal");
+  }
+  IntRange range;
+  if (!IntRangeFor(op, value, &range.low, &range.high)) {
+    return;
+  }
+  if (condition->kind == Kind::INT32) {
+    // Clamp to what the column can hold
+    constexpr int64_t MIN = std::numeric_limits<int32_t>::min();
+    constexpr int64_t MAX = std::numeric_limits<int32_t>::max();
+    if (range.high < MIN || range.low > MAX) {
+      return;
+    }
+    range.low = std::max(range.low, MIN);
+    range.high = std::min(range.high, MAX);
+  }
+  condition->int_ranges.push_back(range);
+}
+
+void ScanPredicate::AddString(Condition* condition,
+                              const FieldValue& literal) {
+  if (literal.IsNull() || !IsStringType(literal.GetType())) {
+    throw std::invalid_argument("Expected a string literal");
+  }
+  condition->strings.push_back(literal.GetString());
+}
+
+void ScanPredicate::EncodeStrings(Condition* condition) {
+  const ColumnDictionary* dictionary = condition->field.dictionary;
+  if (dictionary == nullptr) {
+    return;
+  }
+  // A value without a code yet may get one later, so only a condition
+  // whose values all have codes can compare codes alone
+  std::vector<IntRange> codes;
+  for (const std::string& value : condition->strings) {
+    dictionary_code_t code;
+    if (!dictionary->Lookup(value, &code)) {
+      return;
+    }
+    codes.push_back({code, code});
+  }
+  condition->int_ranges = std::move(codes);
+  condition->by_code = true;
+}
+
+ScanPredicate& ScanPredicate::Compare(const std::string& column,
+                                      CompareOp op, const FieldValue& value) {
+  Condition condition = NewCondition(column);
+  condition.negate = op == CompareOp::NE;
+  if (condition.kind == Kind::STRING) {
+    if (op != CompareOp::EQ && op != CompareOp::NE) {
+      throw std::invalid_argument("Only EQ and NE compare strings: " +
+                                  column);
+    }
+    AddString(&condition, value);
+    EncodeStrings(&condition);
+  } else {
+    AddRange(&condition, op, value);
+  }
+  conditions_.push_back(std::move(condition));
+  return *this;
+}
+
+ScanPredicate& ScanPredicate::Between(const std::string& column,
+                                      const FieldValue& low,
+                                      const FieldValue& high) {
+  Condition condition = NewCondition(column);
+  if (condition.kind == Kind::STRING) {
+    throw std::invalid_argument("Between does not apply to strings: " +
+                                column);
+  }
+  Condition upper = condition;
+  AddRange(&condition, CompareOp::GE, low);
+  AddRange(&upper, CompareOp::LE, high);
+
+  // Intersect; an empty bound leaves no range
+  if (condition.kind == Kind::DOUBLE) {
+    if (!condition.double_ranges.empty() && !upper.double_ranges.empty()) {
+      condition.double_ranges[0].high = upper.double_ranges[0].high;
+    } else {
+      condition.double_ranges.clear();
+    }
+  } else if (!condition.int_ranges.empty() && !upper.int_ranges.empty()) {
+    condition.int_ranges[0].high = upper.int_ranges[0].high;
+  } else {
+    condition.int_ranges.clear();
+  }
+  conditions_.push_back(std::move(condition));
+  return *this;
+}
+
+ScanPredicate& ScanPredicate::In(const std::string& column,
+                                 const std::vector<FieldValue>& values) {
+  Condition condition = NewCondition(column);
+  for (const FieldValue& value : values) {
+    if (condition.kind == Kind::STRING) {
+      AddString(&condition, value);
+    } else {
+      AddRange(&condition, CompareOp::EQ, value);
+    }
+  }
+  if (condition.kind == Kind::STRING) {
+    EncodeStrings(&condition);
+  }
+  conditions_.push_back(std::move(condition));
+  return *this;
+}
+
+ScanPredicate& ScanPredicate::Prefix(const std::string& column,
+                                     const std::string& prefix) {
+  Condition condition = NewCondition(column);
+  if (condition.kind != Kind::STRING) {
+    throw std::invalid_argument("Prefix needs a string column: " + column);
+  }
+  condition.kind = Kind::PREFIX;
+  condition.strings.push_back(prefix);
+  conditions_.push_back(std::move(condition));
+  return *this;
+}
+
+bool ScanPredicate::MatchesString(const Condition& condition,
+                                  const char* tuple, size_t size) const {
+  const FieldLayout& field = condition.field;
+  std::string_view value;
+  std::string out_of_line;
+
+  if (field.IsDictionaryEncoded()) {
+    dictionary_code_t code;
+    std::memcpy(&code, tuple + field.offset, sizeof(code));
+    if (code >= field.dictionary->GetSize()) {
+      return false;
+    }
+    value = field.dictionary->Decode(code);
+  } else if (field.IsFixedLength()) {
+    // CHAR(n): padded with NULs up to n bytes
+    value = std::string_view(tuple + field.offset, field.size);
+    value = value.substr(0, value.find('\0'));
+  } else {
+    uint16_t offset;
+    std::memcpy(&offset,
+                tuple + schema_.GetVarOffsetsStart() +
+                    field.var_index * sizeof(uint16_t),
+                sizeof(uint16_t));
+    if (offset == NULL_VAR_OFFSET ||
+        static_cast<size_t>(offset) + sizeof(uint16_t) > size) {
+      return false;
+    }
+    uint16_t length;
+    std::memcpy(&length, tuple + offset, sizeof(uint16_t));
+    if (length == OVERFLOW_VALUE_MARKER) {
+      if (overflow_ == nullptr || offset + OVERFLOW_FIELD_SIZE > size) {
+        return false;
+      }
+      OverflowPointer pointer;
+      std::memcpy(&pointer, tuple + offset + sizeof(uint16_t),
+                  sizeof(pointer));
+      if (overflow_->Read(pointer, &out_of_line).code != 0) {
+        return false;
+      }
+      value = out_of_line;
+    } else {
+      if (offset + sizeof(uint16_t) + length > size) {
+        return false;
+      }
+      value = std::string_view(tuple + offset + sizeof(uint16_t), length);
+    }
+  }
+
+  if (condition.kind == Kind::PREFIX) {
+    return value.substr(0, condition.strings[0].size()) ==
+           condition.strings[0];
+  }
+  const bool found = std::find(condition.strings.begin(),
+                               condition.strings.end(),
+                               value) != condition.strings.end();
+  return found != condition.negate;
+}
+
+uint64_t ScanPredicate::Evaluate(const Condition& condition,
+                                 const TupleSlice* tuples, size_t count,
+                                 uint64_t candidates) const {
+  const FieldLayout& field = condition.field;
+  uint64_t nulls = 0;
+  for (size_t i = 0; i < count; i++) {
+    nulls |= static_cast<uint64_t>(
+                 TupleHeader::IsNullBitSet(tuples[i].data, field.field_index))
+             << i;
+  }
+
+  if ((condition.kind == Kind::STRING && !condition.by_code) ||
+      condition.kind == Kind::PREFIX) {
+    uint64_t mask = 0;
+    for (uint64_t left = candidates & ~nulls; left != 0; left &= left - 1) {
+      const size_t i = static_cast<size_t>(__builtin_ctzll(left));
+      if (MatchesString(condition, tuples[i].data, tuples[i].size)) {
+        mask |= uint64_t{1} << i;
+      }
+    }
+    return mask;
+  }
+
+  const RangeKernels& kernels = Kernels();
+  uint64_t mask = 0;
+  switch (condition.kind) {
+    case Kind::STRING: {
+      // Dictionary codes, compared as integers
+      alignas(32) int32_t values[BLOCK_SIZE];
+      Gather<dictionary_code_t>(tuples, count, field.offset, values);
+      for (const IntRange& range : condition.int_ranges) {
+        mask |= kernels.int32(values, count, static_cast<int32_t>(range.low),
+                              static_cast<int32_t>(range.high));
+      }
+      break;
+    }
+    case Kind::INT32: {
+      alignas(32) int32_t values[BLOCK_SIZE];
+      switch (field.type) {
+        case DataType::BOOLEAN:
+          Gather<uint8_t>(tuples, count, field.offset, values);
+          break;
+        case DataType::TINYINT:
+          Gather<int8_t>(tuples, count, field.offset, values);
+          break;
+        case DataType::SMALLINT:
+          Gather<int16_t>(tuples, count, field.offset, values);
+          break;
+        default:
+          Gather<int32_t>(tuples, count, field.offset, values);
+          break;
+      }
+      for (const IntRange& range : condition.int_ranges) {
+        mask |= kernels.int32(values, count, static_cast<int32_t>(range.low),
+                              static_cast<int32_t>(range.high));
+      }
+      break;
+    }
+    case Kind::INT64: {
+      alignas(32) int64_t values[BLOCK_SIZE];
+      Gather<int64_t>(tuples, count, field.offset, values);
+      for (const IntRange& range : condition.int_ranges) {
+        mask |= kernels.int64(values, count, range.low, range.high);
+      }
+      break;
+    }
+    default: {
+      alignas(32) double values[BLOCK_SIZE];
+      if (field.type == DataType::FLOAT) {
+        Gather<float>(tuples, count, field.offset, values);
+      } else {
+        Gather<double>(tuples, count, field.offset, values);
+      }
+      for (const DoubleRange& range : condition.double_ranges) {
+        mask |= kernels.dbl(values, count, range.low, range.high);
+      }
+      break;
+    }
+  }
+  if (condition.negate) {
+    mask = ~mask & BlockMask(count);
+  }
+  return mask & ~nulls;
+}
+
+void ScanPredicate::Filter(const TupleSlice* tuples, size_t count,
+                           std::vector<uint32_t>* selection) const {
+  selection->clear();
+  TupleSlice block[BLOCK_SIZE];
+
+  for (size_t start = 0; start < count; start += BLOCK_SIZE) {
+    const size_t n = std::min(BLOCK_SIZE, count - start);
+    uint64_t mask = 0;
+    for (size_t i = 0; i < n; i++) {
+      const TupleSlice& tuple = tuples[start + i];
+      if (tuple.data != nullptr && tuple.size >= min_tuple_size_) {
+        block[i] = tuple;
+        mask |= uint64_t{1} << i;
+      } else {
+        block[i] = {zeros_.data(), static_cast<uint16_t>(zeros_.size())};
+      }
+    }
+
+    for (const Condition& condition : conditions_) {
+      if (mask == 0) {
+        break;
+      }
+      mask &= Evaluate(condition, block, n, mask);
+    }
+    for (; mask != 0; mask &= mask - 1) {
+      selection->push_back(
+          static_cast<uint32_t>(start + __builtin_ctzll(mask)));
+    }
+  }
+}
+
+bool ScanPredicate::Matches(const char* tuple, size_t size) const {
+  if (tuple == nullptr || size < min_tuple_size_) {
+    return false;
+  }
+  const TupleSlice slice{tuple, static_cast<uint16_t>(size)};
+  for (const Condition& condition : conditions_) {
+    if (Evaluate(condition, &slice, 1, 1) == 0) {
+      return false;
+    }
+  }
+  return true;
+}
@@ -1,216 +1,403 @@
 #include "../../include/tuple/tuple_accessor.h"
 
+#include <cstring>
 #include <stdexcept>
 
-#include "../../include/tuple/tuple_serializer.h"
+#include "../../include/tuple/tuple_header.h"
+
+namespace {
+
+// Marker the serializer stores in the header for a NULL variable field
+constexpr uint16_t NULL_VAR_OFFSET = 0xFFFF;
+
+bool IsStringType(DataType type) {
+  return type == DataType::CHAR || type == DataType::VARCHAR ||
+         type == DataType::TEXT;
+}
+
+}  // namespace
 
 TupleAccessor::TupleAccessor(const Schema& schema, const char* buffer,
-                             size_t buffer_size)
+                             size_t buffer_size,
+                             const OverflowValueStore* overflow)
     : schema_(schema),
       buffer_(buffer),
       buffer_size_(buffer_size),
-      header_(0, 0),
-      is_deserialized_(false) {
+      overflow_(overflow) {
   if (!schema_.IsFinalized()) {
     throw std::runtime_error("Schema must be finalized");
   }
+  if (buffer_size_ < schema_.GetTupleHeaderSize()) {
+    throw std::runtime_error("Buffer too small for tuple header");
+  }
+}
 
-  uint16_t var_field_count = 0;
-  for (size_t i = 0; i < schema_.GetColumnCount(); i++) {
-    if (!schema_.GetColumn(i).IsFixedLength()) {
-      var_field_count++;
-    }
+size_t TupleAccessor::GetFieldIndex(const std::string& column_name) const {
+  const ColumnDefinition* col = schema_.FindColumn(column_name);
+  if (col == nullptr) {
+    throw std::runtime_error("Column not found: " + column_name);
   }
+  return col->GetFieldIndex();
+}
 
-  header_ = TupleHeader::DeserializeFrom(buffer, schema_.GetColumnCount(),
-                                         var_field_count);
+const FieldLayout& TupleAccessor::ValidateFieldIndex(size_t index) const {
+  if (index >= schema_.GetColumnCount()) {
+    throw std::runtime_error("Field index out of bounds");
+  }
+  return schema_.GetLayout()[index];
 }
 
-void TupleAccessor::EnsureDeserialized() const {
-  if (!is_deserialized_) {
-    if (schema_.IsFixedLength()) {
-      cached_values_ = TupleSerializer::DeserializeFixedLength(schema_, buffer_,
-                                                               buffer_size_);
-    } else {
-      cached_values_ = TupleSerializer::DeserializeVariableLength(
-          schema_, buffer_, buffer_size_);
-    }
-    is_deserialized_ = true;
+const FieldLayout& TupleAccessor::ValidateHandle(
+    const ColumnHandle& column) const {
+  const size_t index = column.field.field_index;
+  if (index >= schema_.GetColumnCount() ||
+      schema_.GetLayout()[index].type != column.field.type) {
+    throw std::runtime_error("Column handle does not match the schema");
   }
+  return column.field;
 }
 
-size_t TupleAccessor::GetFieldIndex(const std::string& column_name) const {
-  if (!schema_.HasColumn(column_name)) {
-    throw std::runtime_error("Column not found: " + column_name);
+bool TupleAccessor::IsNull(const std::string& column_name) const {
+  return IsNull(GetFieldIndex(column_name));
+}
+
+bool TupleAccessor::IsNull(size_t field_index) const {
+  return IsFieldNull(ValidateFieldIndex(field_index));
+}
+
+bool TupleAccessor::IsNull(const ColumnHandle& column) const {
+  return IsFieldNull(ValidateHandle(column));
+}
+
+bool TupleAccessor::IsFieldNull(const FieldLayout& field) const {
+  if (TupleHeader::IsNullBitSet(buffer_, field.field_index)) {
+    return true;
+  }
+  if (field.IsFixedLength()) {
+    return false;
   }
-  return schema_.GetColumn(column_name).GetFieldIndex();
+
+  uint16_t offset;
+  std::memcpy(&offset,
+              buffer_ + schema_.GetVarOffsetsStart() +
+                  field.var_index * sizeof(uint16_t),
+              sizeof(offset));
+  return offset == NULL_VAR_OFFSET;
 }
 
-void TupleAccessor::ValidateColumnName(const std::string& name,
-                                       DataType expected_type) const {
-  if (!schema_.HasColumn(name)) {
-    throw std::runtime_error("Column not found: " + name);
+bool TupleAccessor::IsStoredOutOfLine(size_t field_index) const {
+  if (IsNull(field_index)) {
+    return false;
   }
-  ColumnDefinition col = schema_.GetColumn(name);
-  if (col.GetDataType() != expected_type) {
-    throw std::runtime_error("Type mismatch for column: " + name);
+  const FieldLayout& field = schema_.GetLayout()[field_index];
+  if (field.IsFixedLength()) {
+    return false;
   }
+  uint16_t length;
+  std::memcpy(&length, buffer_ + VariableOffset(field), sizeof(length));
+  return length == OVERFLOW_VALUE_MARKER;
 }
 
-void TupleAccessor::ValidateFieldIndex(size_t index,
-                                       DataType expected_type) const {
-  if (index >= schema_.GetColumnCount()) {
-    throw std::runtime_error("Field index out of bounds");
+void TupleAccessor::CheckNotNull(const FieldLayout& field) const {
+  if (IsFieldNull(field)) {
+    throw std::runtime_error("Cannot read NULL value");
   }
-  ColumnDefinition col = schema_.GetColumn(index);
-  if (col.GetDataType() != expected_type) {
+}
+
+template <typename T>
+T TupleAccessor::ReadFixed(const FieldLayout& field,
+                           DataType expected_type) const {
+  if (field.type != expected_type) {
     throw std::runtime_error("Type mismatch for field index");
   }
+  CheckNotNull(field);
+
+  size_t offset = field.offset;
+  if (offset + sizeof(T) > buffer_size_) {
+    throw std::runtime_error("Field extends past end of tuple");
+  }
+  T value;
+  std::memcpy(&value, buffer_ + offset, sizeof(T));
+  return value;
 }
 
-bool TupleAccessor::IsNull(const std::string& column_name) const {
-  size_t index = GetFieldIndex(column_name);
-  return header_.IsFieldNull(index);
+size_t TupleAccessor::VariableOffset(const FieldLayout& field) const {
+  uint16_t offset;
+  std::memcpy(&offset,
+              buffer_ + schema_.GetVarOffsetsStart() +
+                  field.var_index * sizeof(uint16_t),
+              sizeof(offset));
+  if (static_cast<size_t>(offset) + sizeof(uint16_t) > buffer_size_) {
+    throw std::runtime_error("Field extends past end of tuple");
+  }
+  return offset;
 }
 
-bool TupleAccessor::IsNull(size_t field_index) const {
-  if (field_index >= schema_.GetColumnCount()) {
-    throw std::runtime_error("Field index out of bounds");
+std::string_view TupleAccessor::ReadVariable(
+    const FieldLayout& field) const {
+  // Layout at the field offset: [2-byte length][data bytes], or
+  // [OVERFLOW_VALUE_MARKER][OverflowPointer] out of line
+  const size_t offset = VariableOffset(field);
+  uint16_t length;
+  std::memcpy(&length, buffer_ + offset, sizeof(length));
+  if (length == OVERFLOW_VALUE_MARKER) {
+    return FetchOutOfLine(field, offset);
+  }
+  size_t data_offset = offset + sizeof(uint16_t);
+  if (data_offset + length > buffer_size_) {
+    throw std::runtime_error("Field extends past end of tuple");
   }
-  return header_.IsFieldNull(field_index);
+  return std::string_view(buffer_ + data_offset, length);
+}
+
+std::string_view TupleAccessor::FetchOutOfLine(const FieldLayout& field,
+                                               size_t offset) const {
+  if (fetched_.size() > field.var_index && fetched_[field.var_index]) {
+    return *fetched_[field.var_index];
+  }
+  if (offset + OVERFLOW_FIELD_SIZE > buffer_size_) {
+    throw std::runtime_error("Field extends past end of tuple");
+  }
+  if (overflow_ == nullptr) {
+    throw std::runtime_error(
+        "Field is stored out of line and no OverflowValueStore was given");
+  }
+
+  OverflowPointer pointer;
+  std::memcpy(&pointer, buffer_ + offset + sizeof(uint16_t), sizeof(pointer));
+  auto value = std::make_unique<std::string>();
+  ErrorCode result = overflow_->Read(pointer, value.get());
+  if (result.code != 0) {
+    throw std::runtime_error("Failed to read out-of-line field: " +
+                             result.message);
+  }
+  if (fetched_.size() <= field.var_index) {
+    fetched_.resize(schema_.GetVarFieldCount());
+  }
+  fetched_[field.var_index] = std::move(value);
+  return *fetched_[field.var_index];
+}
+
+std::string_view TupleAccessor::ReadString(const FieldLayout& field) const {
+  if (!IsStringType(field.type)) {
+    throw std::runtime_error("Type mismatch: expected string type");
+  }
+  CheckNotNull(field);
+
+  if (!field.IsFixedLength()) {
+    return ReadVariable(field);
+  }
+
+  size_t offset = field.offset;
+  size_t size = field.size;
+  if (offset + size > buffer_size_) {
+    throw std::runtime_error("Field extends past end of tuple");
+  }
+  if (field.IsDictionaryEncoded()) {
+    dictionary_code_t code;
+    std::memcpy(&code, buffer_ + offset, sizeof(code));
+    return field.dictionary->Decode(code);
+  }
+
+  // Fixed CHAR(n): padded with NULs up to n bytes
+  const char* src = buffer_ + offset;
+  const void* nul = std::memchr(src, '\0', size);
+  if (nul != nullptr) {
+    size = static_cast<const char*>(nul) - src;
+  }
+  return std::string_view(src, size);
 }
 
 bool TupleAccessor::GetBoolean(const std::string& column_name) const {
-  ValidateColumnName(column_name, DataType::BOOLEAN);
-  size_t index = GetFieldIndex(column_name);
-  return GetBoolean(index);
+  return GetBoolean(GetFieldIndex(column_name));
 }
 
 bool TupleAccessor::GetBoolean(size_t field_index) const {
-  ValidateFieldIndex(field_index, DataType::BOOLEAN);
-  EnsureDeserialized();
-  return cached_values_[field_index].GetBoolean();
+  return ReadFixed<bool>(ValidateFieldIndex(field_index), DataType::BOOLEAN);
+}
+
+bool TupleAccessor::GetBoolean(const ColumnHandle& column) const {
+  return ReadFixed<bool>(ValidateHandle(column), DataType::BOOLEAN);
 }
 
 int8_t TupleAccessor::GetTinyInt(const std::string& column_name) const {
-  ValidateColumnName(column_name, DataType::TINYINT);
-  size_t index = GetFieldIndex(column_name);
-  return GetTinyInt(index);
+  return GetTinyInt(GetFieldIndex(column_name));
 }
 
 int8_t TupleAccessor::GetTinyInt(size_t field_index) const {
-  ValidateFieldIndex(field_index, DataType::TINYINT);
-  EnsureDeserialized();
-  return cached_values_[field_index].GetTinyInt();
+  return ReadFixed<int8_t>(ValidateFieldIndex(field_index), DataType::TINYINT);
+}
+
+int8_t TupleAccessor::GetTinyInt(const ColumnHandle& column) const {
+  return ReadFixed<int8_t>(ValidateHandle(column), DataType::TINYINT);
 }
 
 int16_t TupleAccessor::GetSmallInt(const std::string& column_name) const {
-  ValidateColumnName(column_name, DataType::SMALLINT);
-  size_t index = GetFieldIndex(column_name);
-  return GetSmallInt(index);
+  return GetSmallInt(GetFieldIndex(column_name));
 }
 
 int16_t TupleAccessor::GetSmallInt(size_t field_index) const {
-  ValidateFieldIndex(field_index, DataType::SMALLINT);
-  EnsureDeserialized();
-  return cached_values_[field_index].GetSmallInt();
+  return ReadFixed<int16_t>(ValidateFieldIndex(field_index),
+                            DataType::SMALLINT);
+}
+
+int16_t TupleAccessor::GetSmallInt(const ColumnHandle& column) const {
+  return ReadFixed<int16_t>(ValidateHandle(column), DataType::SMALLINT);
 }
 
 int32_t TupleAccessor::GetInteger(const std::string& column_name) const {
-  ValidateColumnName(column_name, DataType::INTEGER);
-  size_t index = GetFieldIndex(column_name);
-  return GetInteger(index);
+  return GetInteger(GetFieldIndex(column_name));
 }
 
 int32_t TupleAccessor::GetInteger(size_t field_index) const {
-  ValidateFieldIndex(field_index, DataType::INTEGER);
-  EnsureDeserialized();
-  return cached_values_[field_index].GetInteger();
+  return ReadFixed<int32_t>(ValidateFieldIndex(field_index), DataType::INTEGER);
+}
+
+int32_t TupleAccessor::GetInteger(const ColumnHandle& column) const {
+  return ReadFixed<int32_t>(ValidateHandle(column), DataType::INTEGER);
 }
 
 int64_t TupleAccessor::GetBigInt(const std::string& column_name) const {
-  ValidateColumnName(column_name, DataType::BIGINT);
-  size_t index = GetFieldIndex(column_name);
-  return GetBigInt(index);
+  return GetBigInt(GetFieldIndex(column_name));
 }
 
 int64_t TupleAccessor::GetBigInt(size_t field_index) const {
-  ValidateFieldIndex(field_index, DataType::BIGINT);
-  EnsureDeserialized();
-  return cached_values_[field_index].GetBigInt();
+  return ReadFixed<int64_t>(ValidateFieldIndex(field_index), DataType::BIGINT);
+}
+
+int64_t TupleAccessor::GetBigInt(const ColumnHandle& column) const {
+  return ReadFixed<int64_t>(ValidateHandle(column), DataType::BIGINT);
 }
 
 float TupleAccessor::GetFloat(const std::string& column_name) const {
-  ValidateColumnName(column_name, DataType::FLOAT);
-  size_t index = GetFieldIndex(column_name);
-  return GetFloat(index);
+  return GetFloat(GetFieldIndex(column_name));
 }
 
 float TupleAccessor::GetFloat(size_t field_index) const {
-  ValidateFieldIndex(field_index, DataType::FLOAT);
-  EnsureDeserialized();
-  return cached_values_[field_index].GetFloat();
+  return ReadFixed<float>(ValidateFieldIndex(field_index), DataType::FLOAT);
+}
+
+float TupleAccessor::GetFloat(const ColumnHandle& column) const {
+  return ReadFixed<float>(ValidateHandle(column), DataType::FLOAT);
 }
 
 double TupleAccessor::GetDouble(const std::string& column_name) const {
-  ValidateColumnName(column_name, DataType::DOUBLE);
-  size_t index = GetFieldIndex(column_name);
-  return GetDouble(index);
+  return GetDouble(GetFieldIndex(column_name));
 }
 
 double TupleAccessor::GetDouble(size_t field_index) const {
-  ValidateFieldIndex(field_index, DataType::DOUBLE);
-  EnsureDeserialized();
-  return cached_values_[field_index].GetDouble();
+  return ReadFixed<double>(ValidateFieldIndex(field_index), DataType::DOUBLE);
+}
+
+double TupleAccessor::GetDouble(const ColumnHandle& column) const {
+  return ReadFixed<double>(ValidateHandle(column), DataType::DOUBLE);
 }
 
 std::string TupleAccessor::GetString(const std::string& column_name) const {
-  size_t index = GetFieldIndex(column_name);
-  ColumnDefinition col = schema_.GetColumn(index);
-  DataType type = col.GetDataType();
-  if (type != DataType::CHAR && type != DataType::VARCHAR &&
-      type != DataType::TEXT) {
-    throw std::runtime_error("Type mismatch: expected string type");
-  }
-  return GetString(index);
+  return GetString(GetFieldIndex(column_name));
 }
 
 std::string TupleAccessor::GetString(size_t field_index) const {
-  if (field_index >= schema_.GetColumnCount()) {
-    throw std::runtime_error("Field index out of bounds");
-  }
-  ColumnDefinition col = schema_.GetColumn(field_index);
-  DataType type = col.GetDataType();
-  if (type != DataType::CHAR && type != DataType::VARCHAR &&
-      type != DataType::TEXT) {
-    throw std::runtime_error("Type mismatch: expected string type");
-  }
-  EnsureDeserialized();
-  return cached_values_[field_index].GetString();
+  return std::string(ReadString(ValidateFieldIndex(field_index)));
+}
+
+std::string TupleAccessor::GetString(const ColumnHandle& column) const {
+  return std::string(ReadString(ValidateHandle(column)));
 }
 
 std::vector<uint8_t> TupleAccessor::GetBlob(
     const std::string& column_name) const {
-  ValidateColumnName(column_name, DataType::BLOB);
-  size_t index = GetFieldIndex(column_name);
-  return GetBlob(index);
+  return GetBlob(GetFieldIndex(column_name));
 }
 
 std::vector<uint8_t> TupleAccessor::GetBlob(size_t field_index) const {
-  ValidateFieldIndex(field_index, DataType::BLOB);
-  EnsureDeserialized();
-  return cached_values_[field_index].GetBlob();
+  std::string_view bytes = GetBlobView(field_index);
+  return std::vector<uint8_t>(bytes.begin(), bytes.end());
+}
+
+std::vector<uint8_t> TupleAccessor::GetBlob(const ColumnHandle& column) const {
+  std::string_view bytes = GetBlobView(column);
+  return std::vector<uint8_t>(bytes.begin(), bytes.end());
+}
+
+std::string_view TupleAccessor::GetStringView(
+    const std::string& column_name) const {
+  return GetStringView(GetFieldIndex(column_name));
+}
+
+std::string_view TupleAccessor::GetStringView(size_t field_index) const {
+  return ReadString(ValidateFieldIndex(field_index));
+}
+
+std::string_view TupleAccessor::GetStringView(
+    const ColumnHandle& column) const {
+  return ReadString(ValidateHandle(column));
+}
+
+std::string_view TupleAccessor::GetBlobView(
+    const std::string& column_name) const {
+  return GetBlobView(GetFieldIndex(column_name));
+}
+
+std::string_view TupleAccessor::GetBlobView(size_t field_index) const {
+  return ReadBlob(ValidateFieldIndex(field_index));
+}
+
+std::string_view TupleAccessor::GetBlobView(const ColumnHandle& column) const {
+  return ReadBlob(ValidateHandle(column));
+}
+
+std::string_view TupleAccessor::ReadBlob(const FieldLayout& field) const {
+  if (field.type != DataType::BLOB) {
+    throw std::runtime_error("Type mismatch for field index");
+  }
+  CheckNotNull(field);
+  return ReadVariable(field);
 }
 
 FieldValue TupleAccessor::GetFieldValue(const std::string& column_name) const {
-  size_t index = GetFieldIndex(column_name);
-  return GetFieldValue(index);
+  return GetFieldValue(GetFieldIndex(column_name));
 }
 
 FieldValue TupleAccessor::GetFieldValue(size_t field_index) const {
-  if (field_index >= schema_.GetColumnCount()) {
-    throw std::runtime_error("Field index out of bounds");
+  return ReadFieldValue(ValidateFieldIndex(field_index));
+}
+
+FieldValue TupleAccessor::GetFieldValue(const ColumnHandle& column) const {
+  return ReadFieldValue(ValidateHandle(column));
+}
+
+FieldValue TupleAccessor::ReadFieldValue(const FieldLayout& field) const {
+  DataType type = field.type;
+  if (IsFieldNull(field)) {
+    return FieldValue::Null(type);
+  }
+
+  switch (type) {
+    case DataType::BOOLEAN:
+      return FieldValue::Boolean(ReadFixed<bool>(field, type));
+    case DataType::TINYINT:
+      return FieldValue::TinyInt(ReadFixed<int8_t>(field, type));
+    case DataType::SMALLINT:
+      return FieldValue::SmallInt(ReadFixed<int16_t>(field, type));
+    case DataType::INTEGER:
+      return FieldValue::Integer(ReadFixed<int32_t>(field, type));
+    case DataType::BIGINT:
+      return FieldValue::BigInt(ReadFixed<int64_t>(field, type));
+    case DataType::FLOAT:
+      return FieldValue::Float(ReadFixed<float>(field, type));
+    case DataType::DOUBLE:
+      return FieldValue::Double(ReadFixed<double>(field, type));
+    case DataType::CHAR:
+      return FieldValue::Char(std::string(ReadString(field)));
+    case DataType::VARCHAR:
+      return FieldValue::VarChar(std::string(ReadString(field)));
+    case DataType::TEXT:
+      return FieldValue::Text(std::string(ReadString(field)));
+    case DataType::BLOB: {
+      std::string_view bytes = ReadBlob(field);
+      return FieldValue::Blob(std::vector<uint8_t>(bytes.begin(), bytes.end()));
+    }
   }
-  EnsureDeserialized();
-  return cached_values_[field_index];
+  throw std::runtime_error("Unknown data type");
 }
@@ -2,29 +2,40 @@
 
 #include <stdexcept>
 
+namespace {
+
+std::string_view BlobBytes(const std::vector<uint8_t>& value) {
+  return std::string_view(reinterpret_cast<const char*>(value.data()),
+                          value.size());
+}
+
+}  // namespace
+
 TupleBuilder::TupleBuilder(const Schema& schema) : schema_(schema) {
   if (!schema_.IsFinalized()) {
     throw std::runtime_error("Schema must be finalized");
   }
-  values_.resize(schema_.GetColumnCount());
+  Reset();
 }
 
 size_t TupleBuilder::GetFieldIndex(const std::string& column_name) const {
-  if (!schema_.HasColumn(column_name)) {
+  const ColumnDefinition* col = schema_.FindColumn(column_name);
+  if (col == nullptr) {
     throw std::runtime_error("Column not found: " + column_name);
   }
-  return schema_.GetColumn(column_name).GetFieldIndex();
+  return col->GetFieldIndex();
 }
 
-void TupleBuilder::ValidateColumnName(const std::string& name,
-                                      DataType expected_type) const {
-  if (!schema_.HasColumn(name)) {
+size_t TupleBuilder::ValidateColumnName(const std::string& name,
+                                        DataType expected_type) const {
+  const ColumnDefinition* col = schema_.FindColumn(name);
+  if (col == nullptr) {
     throw std::runtime_error("Column not found: " + name);
   }
-  ColumnDefinition col = schema_.GetColumn(name);
-  if (col.GetDataType() != expected_type) {
+  if (col->GetDataType() != expected_type) {
     throw std::runtime_error("Type mismatch for column: " + name);
   }
+  return col->GetFieldIndex();
 }
 
 void TupleBuilder::ValidateFieldIndex(size_t index,
@@ -32,118 +43,124 @@ void TupleBuilder::ValidateFieldIndex(size_t index,
   if (index >= schema_.GetColumnCount()) {
     throw std::runtime_error("Field index out of bounds");
   }
-  ColumnDefinition col = schema_.GetColumn(index);
-  if (col.GetDataType() != expected_type) {
+  if (schema_.GetLayout()[index].type != expected_type) {
     throw std::runtime_error("Type mismatch for field index");
   }
 }
 
+size_t TupleBuilder::ValidateHandle(const ColumnHandle& column,
+                                    DataType expected_type) const {
+  const size_t index = column.field.field_index;
+  if (index >= schema_.GetColumnCount() ||
+      schema_.GetLayout()[index].type != column.field.type) {
+    throw std::runtime_error("Column handle does not match the schema");
+  }
+  if (column.field.type != expected_type) {
+    throw std::runtime_error("Type mismatch for column handle");
+  }
+  return index;
+}
+
 void TupleBuilder::ValidateComplete() const {
   for (size_t i = 0; i < schema_.GetColumnCount(); i++) {
-    ColumnDefinition col = schema_.GetColumn(i);
-    if (!col.GetIsNullable() && !values_[i].has_value()) {
+    const ColumnDefinition& col = schema_.GetColumnRef(i);
+    if (!col.GetIsNullable() && !is_set_[i]) {
       throw std::runtime_error("Non-nullable field not set: " +
                                col.GetColumnName());
     }
   }
 }
 
+void TupleBuilder::Set(size_t index, const ValueRef& value) {
+  values_[index] = value;
+  is_set_[index] = true;
+}
+
 TupleBuilder& TupleBuilder::SetNull(const std::string& column_name) {
   size_t index = GetFieldIndex(column_name);
-  ColumnDefinition col = schema_.GetColumn(index);
+  const ColumnDefinition& col = schema_.GetColumnRef(index);
   if (!col.GetIsNullable()) {
     throw std::runtime_error("Cannot set NULL on non-nullable column: " +
                              column_name);
   }
-  values_[index] = FieldValue::Null(col.GetDataType());
+  Set(index, ValueRef::Null(col.GetDataType()));
   return *this;
 }
 
 TupleBuilder& TupleBuilder::SetBoolean(const std::string& column_name,
                                        bool value) {
-  ValidateColumnName(column_name, DataType::BOOLEAN);
-  size_t index = GetFieldIndex(column_name);
-  values_[index] = FieldValue::Boolean(value);
+  size_t index = ValidateColumnName(column_name, DataType::BOOLEAN);
+  Set(index, ValueRef::Boolean(value));
   return *this;
 }
 
 TupleBuilder& TupleBuilder::SetTinyInt(const std::string& column_name,
                                        int8_t value) {
-  ValidateColumnName(column_name, DataType::TINYINT);
-  size_t index = GetFieldIndex(column_name);
-  values_[index] = FieldValue::TinyInt(value);
+  size_t index = ValidateColumnName(column_name, DataType::TINYINT);
+  Set(index, ValueRef::TinyInt(value));
   return *this;
 }
 
 TupleBuilder& TupleBuilder::SetSmallInt(const std::string& column_name,
                                         int16_t value) {
-  ValidateColumnName(column_name, DataType::SMALLINT);
-  size_t index = GetFieldIndex(column_name);
-  values_[index] = FieldValue::SmallInt(value);
+  size_t index = ValidateColumnName(column_name, DataType::SMALLINT);
+  Set(index, ValueRef::SmallInt(value));
   return *this;
 }
 
 TupleBuilder& TupleBuilder::SetInteger(const std::string& column_name,
                                        int32_t value) {
-  ValidateColumnName(column_name, DataType::INTEGER);
-  size_t index = GetFieldIndex(column_name);
-  values_[index] = FieldValue::Integer(value);
+  size_t index = ValidateColumnName(column_name, DataType::INTEGER);
+  Set(index, ValueRef::Integer(value));
   return *this;
 }
 
 TupleBuilder& TupleBuilder::SetBigInt(const std::string& column_name,
                                       int64_t value) {
-  ValidateColumnName(column_name, DataType::BIGINT);
-  size_t index = GetFieldIndex(column_name);
-  values_[index] = FieldValue::BigInt(value);
+  size_t index = ValidateColumnName(column_name, DataType::BIGINT);
+  Set(index, ValueRef::BigInt(value));
   return *this;
 }
 
 TupleBuilder& TupleBuilder::SetFloat(const std::string& column_name,
                                      float value) {
-  ValidateColumnName(column_name, DataType::FLOAT);
-  size_t index = GetFieldIndex(column_name);
-  values_[index] = FieldValue::Float(value);
+  size_t index = ValidateColumnName(column_name, DataType::FLOAT);
+  Set(index, ValueRef::Float(value));
   return *this;
 }
 
 TupleBuilder& TupleBuilder::SetDouble(const std::string& column_name,
                                       double value) {
-  ValidateColumnName(column_name, DataType::DOUBLE);
-  size_t index = GetFieldIndex(column_name);
-  values_[index] = FieldValue::Double(value);
+  size_t index = ValidateColumnName(column_name, DataType::DOUBLE);
+  Set(index, ValueRef::Double(value));
   return *this;
 }
 
 TupleBuilder& TupleBuilder::SetChar(const std::string& column_name,
                                     const std::string& value) {
-  ValidateColumnName(column_name, DataType::CHAR);
-  size_t index = GetFieldIndex(column_name);
-  values_[index] = FieldValue::Char(value);
+  size_t index = ValidateColumnName(column_name, DataType::CHAR);
+  Set(index, ValueRef::Char(value, &arena_));
   return *this;
 }
 
 TupleBuilder& TupleBuilder::SetVarChar(const std::string& column_name,
                                        const std::string& value) {
-  ValidateColumnName(column_name, DataType::VARCHAR);
-  size_t index = GetFieldIndex(column_name);
-  values_[index] = FieldValue::VarChar(value);
+  size_t index = ValidateColumnName(column_name, DataType::VARCHAR);
+  Set(index, ValueRef::VarChar(value, &arena_));
   return *this;
 }
 
 TupleBuilder& TupleBuilder::SetText(const std::string& column_name,
                                     const std::string& value) {
-  ValidateColumnName(column_name, DataType::TEXT);
-  size_t index = GetFieldIndex(column_name);
-  values_[index] = FieldValue::Text(value);
+  size_t index = ValidateColumnName(column_name, DataType::TEXT);
+  Set(index, ValueRef::Text(value, &arena_));
   return *this;
 }
 
 TupleBuilder& TupleBuilder::SetBlob(const std::string& column_name,
                                     const std::vector<uint8_t>& value) {
-  ValidateColumnName(column_name, DataType::BLOB);
-  size_t index = GetFieldIndex(column_name);
-  values_[index] = FieldValue::Blob(value);
+  size_t index = ValidateColumnName(column_name, DataType::BLOB);
+  Set(index, ValueRef::Blob(BlobBytes(value), &arena_));
   return *this;
 }
 
@@ -151,81 +168,165 @@ TupleBuilder& TupleBuilder::SetNull(size_t field_index) {
   if (field_index >= schema_.GetColumnCount()) {
     throw std::runtime_error("Field index out of bounds");
   }
-  ColumnDefinition col = schema_.GetColumn(field_index);
+  const ColumnDefinition& col = schema_.GetColumnRef(field_index);
   if (!col.GetIsNullable()) {
     throw std::runtime_error("Cannot set NULL on non-nullable column");
   }
-  values_[field_index] = FieldValue::Null(col.GetDataType());
+  Set(field_index, ValueRef::Null(col.GetDataType()));
   return *this;
 }
 
 TupleBuilder& TupleBuilder::SetBoolean(size_t field_index, bool value) {
   ValidateFieldIndex(field_index, DataType::BOOLEAN);
-  values_[field_index] = FieldValue::Boolean(value);
+  Set(field_index, ValueRef::Boolean(value));
   return *this;
 }
 
 TupleBuilder& TupleBuilder::SetTinyInt(size_t field_index, int8_t value) {
   ValidateFieldIndex(field_index, DataType::TINYINT);
-  values_[field_index] = FieldValue::TinyInt(value);
+  Set(field_index, ValueRef::TinyInt(value));
   return *this;
 }
 
 TupleBuilder& TupleBuilder::SetSmallInt(size_t field_index, int16_t value) {
   ValidateFieldIndex(field_index, DataType::SMALLINT);
-  values_[field_index] = FieldValue::SmallInt(value);
+  Set(field_index, ValueRef::SmallInt(value));
   return *this;
 }
 
 TupleBuilder& TupleBuilder::SetInteger(size_t field_index, int32_t value) {
   ValidateFieldIndex(field_index, DataType::INTEGER);
-  values_[field_index] = FieldValue::Integer(value);
+  Set(field_index, ValueRef::Integer(value));
   return *this;
 }
 
 TupleBuilder& TupleBuilder::SetBigInt(size_t field_index, int64_t value) {
   ValidateFieldIndex(field_index, DataType::BIGINT);
-  values_[field_index] = FieldValue::BigInt(value);
+  Set(field_index, ValueRef::BigInt(value));
   return *this;
 }
 
 TupleBuilder& TupleBuilder::SetFloat(size_t field_index, float value) {
   ValidateFieldIndex(field_index, DataType::FLOAT);
-  values_[field_index] = FieldValue::Float(value);
+  Set(field_index, ValueRef::Float(value));
   return *this;
 }
 
 TupleBuilder& TupleBuilder::SetDouble(size_t field_index, double value) {
   ValidateFieldIndex(field_index, DataType::DOUBLE);
-  values_[field_index] = FieldValue::Double(value);
+  Set(field_index, ValueRef::Double(value));
   return *this;
 }
 
 TupleBuilder& TupleBuilder::SetChar(size_t field_index,
                                     const std::string& value) {
   ValidateFieldIndex(field_index, DataType::CHAR);
-  values_[field_index] = FieldValue::Char(value);
+  Set(field_index, ValueRef::Char(value, &arena_));
   return *this;
 }
 
 TupleBuilder& TupleBuilder::SetVarChar(size_t field_index,
                                        const std::string& value) {
   ValidateFieldIndex(field_index, DataType::VARCHAR);
-  values_[field_index] = FieldValue::VarChar(value);
+  Set(field_index, ValueRef::VarChar(value, &arena_));
   return *this;
 }
 
 TupleBuilder& TupleBuilder::SetText(size_t field_index,
                                     const std::string& value) {
   ValidateFieldIndex(field_index, DataType::TEXT);
-  values_[field_index] = FieldValue::Text(value);
+  Set(field_index, ValueRef::Text(value, &arena_));
   return *this;
 }
 
 TupleBuilder& TupleBuilder::SetBlob(size_t field_index,
                                     const std::vector<uint8_t>& value) {
   ValidateFieldIndex(field_index, DataType::BLOB);
-  values_[field_index] = FieldValue::Blob(value);
+  Set(field_index, ValueRef::Blob(BlobBytes(value), &arena_));
+  return *this;
+}
+
+TupleBuilder& TupleBuilder::SetNull(const ColumnHandle& column) {
+  size_t index = ValidateHandle(column, column.field.type);
+  if (!column.is_nullable) {
+    throw std::runtime_error("Cannot set NULL on non-nullable column");
+  }
+  Set(index, ValueRef::Null(column.field.type));
+  return *this;
+}
+
+TupleBuilder& TupleBuilder::SetBoolean(const ColumnHandle& column, bool value) {
+  size_t index = ValidateHandle(column, DataType::BOOLEAN);
+  Set(index, ValueRef::Boolean(value));
+  return *this;
+}
+
+TupleBuilder& TupleBuilder::SetTinyInt(const ColumnHandle& column,
+                                       int8_t value) {
+  size_t index = ValidateHandle(column, DataType::TINYINT);
+  Set(index, ValueRef::TinyInt(value));
+  return *this;
+}
+
+TupleBuilder& TupleBuilder::SetSmallInt(const ColumnHandle& column,
+                                        int16_t value) {
+  size_t index = ValidateHandle(column, DataType::SMALLINT);
+  Set(index, ValueRef::SmallInt(value));
+  return *this;
+}
+
+TupleBuilder& TupleBuilder::SetInteger(const ColumnHandle& column,
+                                       int32_t value) {
+  size_t index = ValidateHandle(column, DataType::INTEGER);
+  Set(index, ValueRef::Integer(value));
+  return *this;
+}
+
+TupleBuilder& TupleBuilder::SetBigInt(const ColumnHandle& column,
+                                      int64_t value) {
+  size_t index = ValidateHandle(column, DataType::BIGINT);
+  Set(index, ValueRef::BigInt(value));
+  return *this;
+}
+
+TupleBuilder& TupleBuilder::SetFloat(const ColumnHandle& column, float value) {
+  size_t index = ValidateHandle(column, DataType::FLOAT);
+  Set(index, ValueRef::Float(value));
+  return *this;
+}
+
+TupleBuilder& TupleBuilder::SetDouble(const ColumnHandle& column,
+                                      double value) {
+  size_t index = ValidateHandle(column, DataType::DOUBLE);
+  Set(index, ValueRef::Double(value));
+  return *this;
+}
+
+TupleBuilder& TupleBuilder::SetChar(const ColumnHandle& column,
+                                    std::string_view value) {
+  size_t index = ValidateHandle(column, DataType::CHAR);
+  Set(index, ValueRef::Char(value, &arena_));
+  return *this;
+}
+
+TupleBuilder& TupleBuilder::SetVarChar(const ColumnHandle& column,
+                                       std::string_view value) {
+  size_t index = ValidateHandle(column, DataType::VARCHAR);
+  Set(index, ValueRef::VarChar(value, &arena_));
+  return *this;
+}
+
+TupleBuilder& TupleBuilder::SetText(const ColumnHandle& column,
+                                    std::string_view value) {
+  size_t index = ValidateHandle(column, DataType::TEXT);
+  Set(index, ValueRef::Text(value, &arena_));
+  return *this;
+}
+
+TupleBuilder& TupleBuilder::SetBlob(const ColumnHandle& column,
+                                    const std::vector<uint8_t>& value) {
+  size_t index = ValidateHandle(column, DataType::BLOB);
+  Set(index, ValueRef::Blob(BlobBytes(value), &arena_));
   return *this;
 }
 
@@ -234,21 +335,24 @@ std::vector<FieldValue> TupleBuilder::Build() const {
 
   std::vector<FieldValue> result;
   result.reserve(values_.size());
-
-  for (const auto& opt_value : values_) {
-    if (opt_value.has_value()) {
-      result.push_back(*opt_value);
-    } else {
-      size_t index = &opt_value - &values_[0];
-      result.push_back(
-          FieldValue::Null(schema_.GetColumn(index).GetDataType()));
-    }
+  for (const ValueRef& value : values_) {
+    result.push_back(value.ToFieldValue());
   }
 
   return result;
 }
 
+const std::vector<ValueRef>& TupleBuilder::BuildRefs() const {
+  ValidateComplete();
+  return values_;
+}
+
 void TupleBuilder::Reset() {
+  arena_.Reset();
+  const std::vector<FieldLayout>& layout = schema_.GetLayout();
   values_.clear();
-  values_.resize(schema_.GetColumnCount());
+  for (const FieldLayout& field : layout) {
+    values_.push_back(ValueRef::Null(field.type));
+  }
+  is_set_.assign(layout.size(), false);
 }
@@ -2,508 +2,524 @@
 
 #include <cstring>
 #include <stdexcept>
+#include <string>
+#include <type_traits>
 
-#include "../../include/schema/alignment.h"
+namespace {
 
-size_t TupleSerializer::SerializeFixedLength(
-    const Schema& schema, const std::vector<FieldValue>& values, char* buffer,
-    size_t buffer_size) {
-  if (!schema.IsFinalized()) {
-    throw std::runtime_error("Schema must be finalized before serialization");
-  }
+// Marker stored in a header offset slot for a NULL variable-length field
+constexpr uint16_t NULL_VAR_OFFSET = 0xFFFF;
 
-  if (!schema.IsFixedLength()) {
-    throw std::runtime_error(
-        "Use SerializeVariableLength for variable-length schemas");
-  }
+// The encode/decode loops below are shared by FieldValue and ValueRef; the
+// helpers in between cover the places where the two APIs differ.
 
-  if (values.size() != schema.GetColumnCount()) {
-    throw std::runtime_error("Value count does not match column count");
+std::string_view VarBytes(const FieldValue& value, DataType type) {
+  if (type == DataType::BLOB) {
+    const std::vector<uint8_t>& blob = value.GetBlob();
+    return std::string_view(reinterpret_cast<const char*>(blob.data()),
+                            blob.size());
   }
+  return value.GetString();
+}
 
-  size_t field_count = schema.GetColumnCount();
-
-  TupleHeader header(field_count, 0);
-  size_t header_size = header.GetHeaderSize();
+std::string_view VarBytes(const ValueRef& value, DataType type) {
+  return type == DataType::BLOB ? value.GetBlob() : value.GetString();
+}
 
-  if (buffer_size < header_size) {
-    throw std::runtime_error("Buffer too small for tuple header");
+template <typename Value>
+Value MakeBytes(DataType type, std::string_view bytes, Arena* arena);
+
+template <>
+FieldValue MakeBytes<FieldValue>(DataType type, std::string_view bytes,
+                                 Arena* /*arena*/) {
+  switch (type) {
+    case DataType::VARCHAR:
+      return FieldValue::VarChar(std::string(bytes));
+    case DataType::TEXT:
+      return FieldValue::Text(std::string(bytes));
+    case DataType::BLOB:
+      return FieldValue::Blob(std::vector<uint8_t>(
+          reinterpret_cast<const uint8_t*>(bytes.data()),
+          reinterpret_cast<const uint8_t*>(bytes.data()) + bytes.size()));
+    default:
+      return FieldValue::Char(std::string(bytes));
   }
+}
 
-  std::memset(buffer, 0, buffer_size);
+template <>
+ValueRef MakeBytes<ValueRef>(DataType type, std::string_view bytes,
+                             Arena* arena) {
+  switch (type) {
+    case DataType::VARCHAR:
+      return ValueRef::VarChar(bytes, arena);
+    case DataType::TEXT:
+      return ValueRef::Text(bytes, arena);
+    case DataType::BLOB:
+      return ValueRef::Blob(bytes, arena);
+    default:
+      return ValueRef::Char(bytes, arena);
+  }
+}
 
-  size_t current_offset = header_size;
+// Code of a dictionary-encoded field, read from or written to src/dest
+dictionary_code_t ReadCode(const char* src) {
+  dictionary_code_t code;
+  std::memcpy(&code, src, sizeof(code));
+  return code;
+}
 
-  // Serialize fixed-length fields with proper alignment
-  // Algorithm:
-  // 1. For each column in order:
-  //    a. Align current_offset for this field's type
-  //    b. If field is null, set null bit and skip writing data
-  //    c. Otherwise, write field value at aligned offset
-  //    d. Advance offset by field size
-  for (size_t i = 0; i < field_count; i++) {
-    ColumnDefinition col = schema.GetColumn(i);
-    DataType type = col.GetDataType();
+void WriteCode(const FieldLayout& field, std::string_view value, char* dest) {
+  dictionary_code_t code;
+  if (!field.dictionary->Encode(value, &code)) {
+    throw std::runtime_error("Dictionary of field " +
+                             std::to_string(field.field_index) +
+                             " is full or its value too long");
+  }
+  std::memcpy(dest, &code, sizeof(code));
+}
 
-    // Align offset for this field's type
-    // Example: current_offset=9, type=INTEGER (4-byte alignment)
-    //   aligned_offset = AlignOffset(9, INTEGER) = 12
-    //   Padding of 3 bytes inserted at offsets 9,10,11
-    current_offset = alignment::AlignOffset(current_offset, type);
+// Write a non-null fixed-length value at its planned offset
+template <typename Value>
+void WriteFixedField(const FieldLayout& field, const Value& value,
+                     char* dest) {
+  if (field.IsDictionaryEncoded()) {
+    WriteCode(field, value.GetString(), dest);
+    return;
+  }
+  switch (field.type) {
+    case DataType::BOOLEAN: {
+      bool val = value.GetBoolean();
+      std::memcpy(dest, &val, sizeof(bool));
+      break;
+    }
+    case DataType::TINYINT: {
+      int8_t val = value.GetTinyInt();
+      std::memcpy(dest, &val, sizeof(int8_t));
+      break;
+    }
+    case DataType::SMALLINT: {
+      int16_t val = value.GetSmallInt();
+      std::memcpy(dest, &val, sizeof(int16_t));
+      break;
+    }
+    case DataType::INTEGER: {
+      int32_t val = value.GetInteger();
+      std::memcpy(dest, &val, sizeof(int32_t));
+      break;
+    }
+    case DataType::BIGINT: {
+      int64_t val = value.GetBigInt();
+      std::memcpy(dest, &val, sizeof(int64_t));
+      break;
+    }
+    case DataType::FLOAT: {
+      float val = value.GetFloat();
+      std::memcpy(dest, &val, sizeof(float));
+      break;
+    }
+    case DataType::DOUBLE: {
+      double val = value.GetDouble();
+      std::memcpy(dest, &val, sizeof(double));
+      break;
+    }
+    case DataType::CHAR: {
+      // CHAR(n) is NUL-padded; the padding is already zeroed
+      std::string_view str = value.GetString();
+      if (str.length() > field.size) {
+        throw std::runtime_error("CHAR value exceeds fixed size");
+      }
+      std::memcpy(dest, str.data(), str.length());
+      break;
+    }
+    default:
+      throw std::runtime_error("Unexpected type in fixed-length serialization");
+  }
+}
 
-    if (values[i].IsNull()) {
-      header.SetFieldNull(i, true);
-      // Skip writing data for null fields
-    } else {
-      // Pointer arithmetic: Calculate destination address
-      // buffer + current_offset points to the aligned location
-      char* dest = buffer + current_offset;
-
-      // Write value based on type using memcpy
-      switch (type) {
-        case DataType::BOOLEAN: {
-          bool val = values[i].GetBoolean();
-          std::memcpy(dest, &val, sizeof(bool));
-          break;
-        }
-        case DataType::TINYINT: {
-          int8_t val = values[i].GetTinyInt();
-          std::memcpy(dest, &val, sizeof(int8_t));
-          break;
-        }
-        case DataType::SMALLINT: {
-          int16_t val = values[i].GetSmallInt();
-          std::memcpy(dest, &val, sizeof(int16_t));
-          break;
-        }
-        case DataType::INTEGER: {
-          int32_t val = values[i].GetInteger();
-          std::memcpy(dest, &val, sizeof(int32_t));
-          break;
-        }
-        case DataType::BIGINT: {
-          int64_t val = values[i].GetBigInt();
-          std::memcpy(dest, &val, sizeof(int64_t));
-          break;
-        }
-        case DataType::FLOAT: {
-          float val = values[i].GetFloat();
-          std::memcpy(dest, &val, sizeof(float));
-          break;
-        }
-        case DataType::DOUBLE: {
-          double val = values[i].GetDouble();
-          std::memcpy(dest, &val, sizeof(double));
-          break;
-        }
-        case DataType::CHAR: {
-          const std::string& str = values[i].GetString();
-          size_t char_size = col.GetFixedSize();
-          if (str.length() > char_size) {
-            throw std::runtime_error("CHAR value exceeds fixed size");
-          }
-          std::memcpy(dest, str.c_str(), str.length());
-          break;
-        }
-        default:
-          throw std::runtime_error(
-              "Unexpected variable-length type in fixed-length schema");
+template <typename Value>
+Value ReadFixedField(const FieldLayout& field, const char* src, Arena* arena) {
+  if (field.IsDictionaryEncoded()) {
+    // Decoded values live as long as the dictionary, even without an arena
+    return MakeBytes<Value>(field.type,
+                            field.dictionary->Decode(ReadCode(src)), arena);
+  }
+  switch (field.type) {
+    case DataType::BOOLEAN: {
+      bool val;
+      std::memcpy(&val, src, sizeof(bool));
+      return Value::Boolean(val);
+    }
+    case DataType::TINYINT: {
+      int8_t val;
+      std::memcpy(&val, src, sizeof(int8_t));
+      return Value::TinyInt(val);
+    }
+    case DataType::SMALLINT: {
+      int16_t val;
+      std::memcpy(&val, src, sizeof(int16_t));
+      return Value::SmallInt(val);
+    }
+    case DataType::INTEGER: {
+      int32_t val;
+      std::memcpy(&val, src, sizeof(int32_t));
+      return Value::Integer(val);
+    }
+    case DataType::BIGINT: {
+      int64_t val;
+      std::memcpy(&val, src, sizeof(int64_t));
+      return Value::BigInt(val);
+    }
+    case DataType::FLOAT: {
+      float val;
+      std::memcpy(&val, src, sizeof(float));
+      return Value::Float(val);
+    }
+    case DataType::DOUBLE: {
+      double val;
+      std::memcpy(&val, src, sizeof(double));
+      return Value::Double(val);
+    }
+    case DataType::CHAR: {
+      size_t length = field.size;
+      const void* nul = std::memchr(src, '\0', length);
+      if (nul != nullptr) {
+        length = static_cast<const char*>(nul) - src;
       }
+      return MakeBytes<Value>(DataType::CHAR, std::string_view(src, length),
+                              arena);
     }
+    default:
+      throw std::runtime_error(
+          "Unexpected type in fixed-length deserialization");
+  }
+}
 
-    current_offset += col.GetFixedSize();
+// Encode the fixed section shared by both formats. Zeroes the header and
+// fixed section first so padding and NULL fields are deterministic, and
+// sets the null bits of the fixed fields in place.
+template <typename Value>
+void SerializeFixedSection(const Schema& schema,
+                               const std::vector<Value>& values, char* buffer,
+                               size_t buffer_size) {
+  if (values.size() != schema.GetColumnCount()) {
+    throw std::runtime_error("Value count does not match column count");
+  }
+  if (buffer_size < schema.GetTupleHeaderSize()) {
+    throw std::runtime_error("Buffer too small for tuple header");
+  }
+  if (buffer_size < schema.GetFixedSectionEnd()) {
+    throw std::runtime_error("Buffer too small for fixed-length data");
   }
 
-  header.SerializeTo(buffer);
+  std::memset(buffer, 0, schema.GetFixedSectionEnd());
 
-  return current_offset;
+  const std::vector<FieldLayout>& layout = schema.GetLayout();
+  for (size_t i = 0; i < layout.size(); i++) {
+    const FieldLayout& field = layout[i];
+    if (!field.IsFixedLength()) {
+      continue;
+    }
+    if (values[i].IsNull()) {
+      TupleHeader::SetNullBit(buffer, i, true);
+    } else {
+      WriteFixedField(field, values[i], buffer + field.offset);
+    }
+  }
 }
 
-std::vector<FieldValue> TupleSerializer::DeserializeFixedLength(
-    const Schema& schema, const char* buffer, size_t buffer_size) {
+void CheckDeserializable(const Schema& schema, size_t buffer_size) {
   if (!schema.IsFinalized()) {
     throw std::runtime_error("Schema must be finalized before deserialization");
   }
-
-  if (!schema.IsFixedLength()) {
-    throw std::runtime_error(
-        "Use DeserializeVariableLength for variable-length schemas");
+  if (buffer_size < schema.GetTupleHeaderSize()) {
+    throw std::runtime_error("Buffer too small for tuple header");
   }
+  if (buffer_size < schema.GetFixedSectionEnd()) {
+    throw std::runtime_error("Buffer too small for fixed-length data");
+  }
+}
 
-  size_t field_count = schema.GetColumnCount();
-  TupleHeader header = TupleHeader::DeserializeFrom(buffer, field_count, 0);
-  size_t header_size = header.GetHeaderSize();
+template <typename Value>
+size_t SerializeFixedImpl(const Schema& schema,
+                          const std::vector<Value>& values, char* buffer,
+                          size_t buffer_size) {
+  SerializeFixedSection(schema, values, buffer, buffer_size);
+  return schema.GetFixedSectionEnd();
+}
 
-  if (buffer_size < header_size) {
-    throw std::runtime_error("Buffer too small for tuple header");
+// Free the values a failed serialization already stored out of line
+void FreeOverflowValues(OverflowValueStore* overflow,
+                        const std::vector<OverflowPointer>& pointers) {
+  for (const OverflowPointer& pointer : pointers) {
+    overflow->Free(pointer);
   }
+}
 
-  std::vector<FieldValue> result;
-  result.reserve(field_count);
+template <typename Value>
+size_t SerializeVariableImpl(const Schema& schema,
+                             const std::vector<Value>& values, char* buffer,
+                             size_t buffer_size,
+                             OverflowValueStore* overflow) {
+  SerializeFixedSection(schema, values, buffer, buffer_size);
+
+  // Variable-length data starts on an 8-byte boundary
+  // Example: fixed section ends at 53 -> data starts at 56
+  size_t current_offset = (schema.GetFixedSectionEnd() + 7) / 8 * 8;
+  if (current_offset > buffer_size) {
+    throw std::runtime_error("Buffer too small for variable-length data");
+  }
+  std::memset(buffer + schema.GetFixedSectionEnd(), 0,
+              current_offset - schema.GetFixedSectionEnd());
 
-  size_t current_offset = header_size;
+  // Format: [2-byte length][data bytes]
+  // Example: VARCHAR "Hello" -> [0x05, 0x00, 'H', 'e', 'l', 'l', 'o']
+  // Out of line: [OVERFLOW_VALUE_MARKER][OverflowPointer]
+  std::vector<OverflowPointer> stored;
+  const std::vector<FieldLayout>& layout = schema.GetLayout();
+  for (size_t i = 0; i < layout.size(); i++) {
+    const FieldLayout& field = layout[i];
+    if (field.IsFixedLength()) {
+      continue;
+    }
+
+    char* slot = buffer + schema.GetVarOffsetsStart() +
+                 field.var_index * sizeof(uint16_t);
+    if (values[i].IsNull()) {
+      TupleHeader::SetNullBit(buffer, i, true);
+      std::memcpy(slot, &NULL_VAR_OFFSET, sizeof(uint16_t));
+      continue;
+    }
 
-  for (size_t i = 0; i < field_count; i++) {
-    ColumnDefinition col = schema.GetColumn(i);
-    DataType type = col.GetDataType();
+    std::string_view bytes = VarBytes(values[i], field.type);
+    const bool out_of_line =
+        overflow != nullptr && bytes.size() > OVERFLOW_VALUE_THRESHOLD;
+    const size_t field_size = out_of_line
+                                  ? OVERFLOW_FIELD_SIZE
+                                  : sizeof(uint16_t) + bytes.size();
+    if (current_offset + field_size > buffer_size) {
+      FreeOverflowValues(overflow, stored);
+      throw std::runtime_error("Buffer too small for variable-length data");
+    }
 
-    current_offset = alignment::AlignOffset(current_offset, type);
+    uint16_t offset = static_cast<uint16_t>(current_offset);
+    std::memcpy(slot, &offset, sizeof(uint16_t));
 
-    if (header.IsFieldNull(i)) {
-      result.push_back(FieldValue::Null(type));
-    } else {
-      const char* src = buffer + current_offset;
-
-      switch (type) {
-        case DataType::BOOLEAN: {
-          bool val;
-          std::memcpy(&val, src, sizeof(bool));
-          result.push_back(FieldValue::Boolean(val));
-          break;
-        }
-        case DataType::TINYINT: {
-          int8_t val;
-          std::memcpy(&val, src, sizeof(int8_t));
-          result.push_back(FieldValue::TinyInt(val));
-          break;
-        }
-        case DataType::SMALLINT: {
-          int16_t val;
-          std::memcpy(&val, src, sizeof(int16_t));
-          result.push_back(FieldValue::SmallInt(val));
-          break;
-        }
-        case DataType::INTEGER: {
-          int32_t val;
-          std::memcpy(&val, src, sizeof(int32_t));
-          result.push_back(FieldValue::Integer(val));
-          break;
-        }
-        case DataType::BIGINT: {
-          int64_t val;
-          std::memcpy(&val, src, sizeof(int64_t));
-          result.push_back(FieldValue::BigInt(val));
-          break;
-        }
-        case DataType::FLOAT: {
-          float val;
-          std::memcpy(&val, src, sizeof(float));
-          result.push_back(FieldValue::Float(val));
-          break;
-        }
-        case DataType::DOUBLE: {
-          double val;
-          std::memcpy(&val, src, sizeof(double));
-          result.push_back(FieldValue::Double(val));
-          break;
-        }
-        case DataType::CHAR: {
-          size_t char_size = col.GetFixedSize();
-          std::string str(src, char_size);
-          size_t null_pos = str.find('\0');
-          if (null_pos != std::string::npos) {
-            str = str.substr(0, null_pos);
-          }
-          result.push_back(FieldValue::Char(str));
-          break;
-        }
-        default:
-          throw std::runtime_error(
-              "Unexpected variable-length type in fixed-length schema");
+    if (out_of_line) {
+      OverflowPointer pointer{};
+      ErrorCode result = overflow->Write(bytes, &pointer);
+      if (result.code != 0) {
+        FreeOverflowValues(overflow, stored);
+        throw std::runtime_error("Failed to store value out of line: " +
+                                 result.message);
       }
+      stored.push_back(pointer);
+      std::memcpy(buffer + current_offset, &OVERFLOW_VALUE_MARKER,
+                  sizeof(uint16_t));
+      std::memcpy(buffer + current_offset + sizeof(uint16_t), &pointer,
+                  sizeof(pointer));
+      current_offset += OVERFLOW_FIELD_SIZE;
+      continue;
+    }
+    if (bytes.size() >= OVERFLOW_VALUE_MARKER) {
+      FreeOverflowValues(overflow, stored);
+      throw std::runtime_error("Variable-length value too large for a tuple");
     }
 
-    current_offset += col.GetFixedSize();
+    uint16_t length = static_cast<uint16_t>(bytes.size());
+    std::memcpy(buffer + current_offset, &length, sizeof(uint16_t));
+    current_offset += sizeof(uint16_t);
+    if (length > 0) {
+      std::memcpy(buffer + current_offset, bytes.data(), length);
+      current_offset += length;
+    }
   }
 
-  return result;
+  return current_offset;
 }
 
-size_t TupleSerializer::SerializeVariableLength(
-    const Schema& schema, const std::vector<FieldValue>& values, char* buffer,
-    size_t buffer_size) {
-  if (!schema.IsFinalized()) {
-    throw std::runtime_error("Schema must be finalized before serialization");
+// Pointer of the out-of-line field at offset
+OverflowPointer ReadOverflowPointer(const char* buffer, size_t buffer_size,
+                                    size_t offset) {
+  if (offset + OVERFLOW_FIELD_SIZE > buffer_size) {
+    throw std::runtime_error("Variable-length field past end of buffer");
   }
+  OverflowPointer pointer;
+  std::memcpy(&pointer, buffer + offset + sizeof(uint16_t), sizeof(pointer));
+  return pointer;
+}
 
-  if (values.size() != schema.GetColumnCount()) {
-    throw std::runtime_error("Value count does not match column count");
+template <typename Value>
+Value ReadOverflowField(const FieldLayout& field, const char* buffer,
+                        size_t buffer_size, size_t offset, Arena* arena,
+                        const OverflowValueStore* overflow) {
+  const OverflowPointer pointer =
+      ReadOverflowPointer(buffer, buffer_size, offset);
+  if (overflow == nullptr) {
+    throw std::runtime_error("Value is stored out of line; an "
+                             "OverflowValueStore is needed to read it");
+  }
+  if (std::is_same<Value, ValueRef>::value && arena == nullptr) {
+    throw std::runtime_error("Out-of-line values need an arena to be "
+                             "deserialized into");
   }
+  std::string bytes;
+  ErrorCode result = overflow->Read(pointer, &bytes);
+  if (result.code != 0) {
+    throw std::runtime_error("Failed to read out-of-line value: " +
+                             result.message);
+  }
+  return MakeBytes<Value>(field.type, bytes, arena);
+}
 
-  size_t field_count = schema.GetColumnCount();
-  uint16_t var_field_count = 0;
+// Works for both formats: a fixed-length tuple is the same layout with no
+// variable section. Appends to *values.
+template <typename Value>
+void DeserializeImpl(const Schema& schema, const char* buffer,
+                     size_t buffer_size, Arena* arena,
+                     std::vector<Value>* values,
+                     const OverflowValueStore* overflow) {
+  CheckDeserializable(schema, buffer_size);
+
+  const std::vector<FieldLayout>& layout = schema.GetLayout();
+  values->reserve(values->size() + layout.size());
+
+  for (const FieldLayout& field : layout) {
+    if (TupleHeader::IsNullBitSet(buffer, field.field_index)) {
+      values->push_back(Value::Null(field.type));
+      continue;
+    }
 
-  for (size_t i = 0; i < field_count; i++) {
-    if (!schema.GetColumn(i).IsFixedLength()) {
-      var_field_count++;
+    if (field.IsFixedLength()) {
+      values->push_back(
+          ReadFixedField<Value>(field, buffer + field.offset, arena));
+      continue;
+    }
+
+    uint16_t offset;
+    std::memcpy(&offset,
+                buffer + schema.GetVarOffsetsStart() +
+                    field.var_index * sizeof(uint16_t),
+                sizeof(uint16_t));
+    if (offset == NULL_VAR_OFFSET) {
+      values->push_back(Value::Null(field.type));
+      continue;
+    }
+    if (static_cast<size_t>(offset) + sizeof(uint16_t) > buffer_size) {
+      throw std::runtime_error("Variable-length field past end of buffer");
     }
-  }
 
-  TupleHeader header(field_count, var_field_count);
-  size_t header_size = header.GetHeaderSize();
+    uint16_t length;
+    std::memcpy(&length, buffer + offset, sizeof(uint16_t));
+    if (length == OVERFLOW_VALUE_MARKER) {
+      values->push_back(ReadOverflowField<Value>(
+          field, buffer, buffer_size, offset, arena, overflow));
+      continue;
+    }
+    if (offset + sizeof(uint16_t) + length > buffer_size) {
+      throw std::runtime_error("Variable-length field past end of buffer");
+    }
 
-  if (buffer_size < header_size) {
-    throw std::runtime_error("Buffer too small for tuple header");
+    std::string_view bytes(buffer + offset + sizeof(uint16_t), length);
+    values->push_back(MakeBytes<Value>(field.type, bytes, arena));
   }
+}
 
-  std::memset(buffer, 0, buffer_size);
-
-  size_t current_offset = header_size;
-  uint16_t var_field_index = 0;
-
-  // Serialize fixed-length fields first
-  for (size_t i = 0; i < field_count; i++) {
-    ColumnDefinition col = schema.GetColumn(i);
-    DataType type = col.GetDataType();
-
-    if (col.IsFixedLength()) {
-      current_offset = alignment::AlignOffset(current_offset, type);
-
-      if (values[i].IsNull()) {
-        header.SetFieldNull(i, true);
-      } else {
-        char* dest = buffer + current_offset;
-
-        switch (type) {
-          case DataType::BOOLEAN: {
-            bool val = values[i].GetBoolean();
-            std::memcpy(dest, &val, sizeof(bool));
-            break;
-          }
-          case DataType::TINYINT: {
-            int8_t val = values[i].GetTinyInt();
-            std::memcpy(dest, &val, sizeof(int8_t));
-            break;
-          }
-          case DataType::SMALLINT: {
-            int16_t val = values[i].GetSmallInt();
-            std::memcpy(dest, &val, sizeof(int16_t));
-            break;
-          }
-          case DataType::INTEGER: {
-            int32_t val = values[i].GetInteger();
-            std::memcpy(dest, &val, sizeof(int32_t));
-            break;
-          }
-          case DataType::BIGINT: {
-            int64_t val = values[i].GetBigInt();
-            std::memcpy(dest, &val, sizeof(int64_t));
-            break;
-          }
-          case DataType::FLOAT: {
-            float val = values[i].GetFloat();
-            std::memcpy(dest, &val, sizeof(float));
-            break;
-          }
-          case DataType::DOUBLE: {
-            double val = values[i].GetDouble();
-            std::memcpy(dest, &val, sizeof(double));
-            break;
-          }
-          default:
-            throw std::runtime_error(
-                "Unexpected type in fixed-length serialization");
-        }
-      }
+}  // namespace
 
-      current_offset += col.GetFixedSize();
-    }
+size_t TupleSerializer::SerializeFixedLength(
+    const Schema& schema, const std::vector<FieldValue>& values, char* buffer,
+    size_t buffer_size) {
+  if (!schema.IsFinalized()) {
+    throw std::runtime_error("Schema must be finalized before serialization");
+  }
+
+  if (!schema.IsFixedLength()) {
+    throw std::runtime_error(
+        "Use SerializeVariableLength for variable-length schemas");
   }
 
-  // Align to 8-byte boundary before variable-length data
-  // Example: current_offset=53 -> aligned to 56
-  current_offset = (current_offset + 7) / 8 * 8;
+  return SerializeFixedImpl(schema, values, buffer, buffer_size);
+}
 
-  // Serialize variable-length fields
-  // Format: [2-byte length][data bytes]
-  // Example: VARCHAR "Hello" -> [0x05, 0x00, 'H', 'e', 'l', 'l', 'o']
-  for (size_t i = 0; i < field_count; i++) {
-    ColumnDefinition col = schema.GetColumn(i);
-
-    if (!col.IsFixedLength()) {
-      if (values[i].IsNull()) {
-        header.SetFieldNull(i, true);
-        header.SetVariableLengthOffset(var_field_index, 0xFFFF);
-      } else {
-        header.SetVariableLengthOffset(var_field_index, current_offset);
-
-        DataType type = col.GetDataType();
-        if (type == DataType::VARCHAR || type == DataType::TEXT ||
-            type == DataType::CHAR) {
-          const std::string& str = values[i].GetString();
-          uint16_t length = static_cast<uint16_t>(str.length());
-
-          if (current_offset + sizeof(uint16_t) + length > buffer_size) {
-            throw std::runtime_error(
-                "Buffer too small for variable-length data");
-          }
-
-          // Pointer arithmetic: Write length prefix
-          std::memcpy(buffer + current_offset, &length, sizeof(uint16_t));
-          current_offset += sizeof(uint16_t);
-
-          // Pointer arithmetic: Write string data
-          if (length > 0) {
-            std::memcpy(buffer + current_offset, str.c_str(), length);
-            current_offset += length;
-          }
-        } else if (type == DataType::BLOB) {
-          const std::vector<uint8_t>& blob = values[i].GetBlob();
-          uint16_t length = static_cast<uint16_t>(blob.size());
-
-          if (current_offset + sizeof(uint16_t) + length > buffer_size) {
-            throw std::runtime_error(
-                "Buffer too small for variable-length data");
-          }
-
-          std::memcpy(buffer + current_offset, &length, sizeof(uint16_t));
-          current_offset += sizeof(uint16_t);
-
-          if (length > 0) {
-            std::memcpy(buffer + current_offset, blob.data(), length);
-            current_offset += length;
-          }
-        }
-      }
-      var_field_index++;
-    }
+std::vector<FieldValue> TupleSerializer::DeserializeFixedLength(
+    const Schema& schema, const char* buffer, size_t buffer_size) {
+  if (schema.IsFinalized() && !schema.IsFixedLength()) {
+    throw std::runtime_error(
+        "Use DeserializeVariableLength for variable-length schemas");
   }
 
-  header.SerializeTo(buffer);
+  std::vector<FieldValue> result;
+  DeserializeImpl(schema, buffer, buffer_size, nullptr, &result, nullptr);
+  return result;
+}
 
-  return current_offset;
+size_t TupleSerializer::SerializeVariableLength(
+    const Schema& schema, const std::vector<FieldValue>& values, char* buffer,
+    size_t buffer_size, OverflowValueStore* overflow) {
+  if (!schema.IsFinalized()) {
+    throw std::runtime_error("Schema must be finalized before serialization");
+  }
+
+  return SerializeVariableImpl(schema, values, buffer, buffer_size, overflow);
 }
 
 std::vector<FieldValue> TupleSerializer::DeserializeVariableLength(
-    const Schema& schema, const char* buffer, size_t buffer_size) {
+    const Schema& schema, const char* buffer, size_t buffer_size,
+    const OverflowValueStore* overflow) {
+  std::vector<FieldValue> result;
+  DeserializeImpl(schema, buffer, buffer_size, nullptr, &result, overflow);
+  return result;
+}
+
+size_t TupleSerializer::Serialize(const Schema& schema,
+                                  const std::vector<ValueRef>& values,
+                                  char* buffer, size_t buffer_size,
+                                  OverflowValueStore* overflow) {
   if (!schema.IsFinalized()) {
-    throw std::runtime_error("Schema must be finalized before deserialization");
+    throw std::runtime_error("Schema must be finalized before serialization");
   }
 
-  size_t field_count = schema.GetColumnCount();
-  uint16_t var_field_count = 0;
-
-  for (size_t i = 0; i < field_count; i++) {
-    if (!schema.GetColumn(i).IsFixedLength()) {
-      var_field_count++;
-    }
+  if (schema.IsFixedLength()) {
+    return SerializeFixedImpl(schema, values, buffer, buffer_size);
   }
+  return SerializeVariableImpl(schema, values, buffer, buffer_size, overflow);
+}
 
-  TupleHeader header =
-      TupleHeader::DeserializeFrom(buffer, field_count, var_field_count);
-  size_t header_size = header.GetHeaderSize();
+void TupleSerializer::Deserialize(const Schema& schema, const char* buffer,
+                                  size_t buffer_size, Arena* arena,
+                                  std::vector<ValueRef>* values,
+                                  const OverflowValueStore* overflow) {
+  values->clear();
+  DeserializeImpl(schema, buffer, buffer_size, arena, values, overflow);
+}
 
-  if (buffer_size < header_size) {
-    throw std::runtime_error("Buffer too small for tuple header");
+void TupleSerializer::GetOverflowPointers(
+    const Schema& schema, const char* buffer, size_t buffer_size,
+    std::vector<OverflowPointer>* pointers) {
+  CheckDeserializable(schema, buffer_size);
+  if (schema.IsFixedLength()) {
+    return;
   }
 
-  std::vector<FieldValue> result;
-  result.reserve(field_count);
-
-  size_t current_offset = header_size;
-  uint16_t var_field_index = 0;
-
-  for (size_t i = 0; i < field_count; i++) {
-    ColumnDefinition col = schema.GetColumn(i);
-    DataType type = col.GetDataType();
-
-    if (col.IsFixedLength()) {
-      current_offset = alignment::AlignOffset(current_offset, type);
-
-      if (header.IsFieldNull(i)) {
-        result.push_back(FieldValue::Null(type));
-      } else {
-        const char* src = buffer + current_offset;
-
-        switch (type) {
-          case DataType::BOOLEAN: {
-            bool val;
-            std::memcpy(&val, src, sizeof(bool));
-            result.push_back(FieldValue::Boolean(val));
-            break;
-          }
-          case DataType::TINYINT: {
-            int8_t val;
-            std::memcpy(&val, src, sizeof(int8_t));
-            result.push_back(FieldValue::TinyInt(val));
-            break;
-          }
-          case DataType::SMALLINT: {
-            int16_t val;
-            std::memcpy(&val, src, sizeof(int16_t));
-            result.push_back(FieldValue::SmallInt(val));
-            break;
-          }
-          case DataType::INTEGER: {
-            int32_t val;
-            std::memcpy(&val, src, sizeof(int32_t));
-            result.push_back(FieldValue::Integer(val));
-            break;
-          }
-          case DataType::BIGINT: {
-            int64_t val;
-            std::memcpy(&val, src, sizeof(int64_t));
-            result.push_back(FieldValue::BigInt(val));
-            break;
-          }
-          case DataType::FLOAT: {
-            float val;
-            std::memcpy(&val, src, sizeof(float));
-            result.push_back(FieldValue::Float(val));
-            break;
-          }
-          case DataType::DOUBLE: {
-            double val;
-            std::memcpy(&val, src, sizeof(double));
-            result.push_back(FieldValue::Double(val));
-            break;
-          }
-          default:
-            throw std::runtime_error(
-                "Unexpected type in fixed-length deserialization");
-        }
-      }
-
-      current_offset += col.GetFixedSize();
-    } else {
-      if (header.IsFieldNull(i)) {
-        result.push_back(FieldValue::Null(type));
-      } else {
-        uint16_t offset = header.GetVariableLengthOffset(var_field_index);
-        if (offset == 0xFFFF) {
-          result.push_back(FieldValue::Null(type));
-        } else {
-          const char* src = buffer + offset;
-
-          if (type == DataType::VARCHAR || type == DataType::TEXT ||
-              type == DataType::CHAR) {
-            uint16_t length;
-            std::memcpy(&length, src, sizeof(uint16_t));
-            src += sizeof(uint16_t);
-
-            std::string str(src, length);
-            if (type == DataType::CHAR) {
-              result.push_back(FieldValue::Char(str));
-            } else if (type == DataType::VARCHAR) {
-              result.push_back(FieldValue::VarChar(str));
-            } else {
-              result.push_back(FieldValue::Text(str));
-            }
-          } else if (type == DataType::BLOB) {
-            uint16_t length;
-            std::memcpy(&length, src, sizeof(uint16_t));
-            src += sizeof(uint16_t);
-
-            std::vector<uint8_t> blob(src, src + length);
-            result.push_back(FieldValue::Blob(blob));
-          }
-        }
-      }
-      var_field_index++;
+  for (const FieldLayout& field : schema.GetLayout()) {
+    if (field.IsFixedLength()) {
+      continue;
+    }
+    uint16_t offset;
+    std::memcpy(&offset,
+                buffer + schema.GetVarOffsetsStart() +
+                    field.var_index * sizeof(uint16_t),
+                sizeof(uint16_t));
+    if (offset == NULL_VAR_OFFSET ||
+        static_cast<size_t>(offset) + sizeof(uint16_t) > buffer_size) {
+      continue;
+    }
+    uint16_t length;
+    std::memcpy(&length, buffer + offset, sizeof(uint16_t));
+    if (length == OVERFLOW_VALUE_MARKER) {
+      pointers->push_back(ReadOverflowPointer(buffer, buffer_size, offset));
     }
   }
-
-  return result;
 }
 
 size_t TupleSerializer::CalculateSerializedSize(
@@ -512,27 +528,12 @@ size_t TupleSerializer::CalculateSerializedSize(
     throw std::runtime_error("Schema must be finalized");
   }
 
-  size_t field_count = schema.GetColumnCount();
-  uint16_t var_field_count = 0;
-
-  for (size_t i = 0; i < field_count; i++) {
-    if (!schema.GetColumn(i).IsFixedLength()) {
-      var_field_count++;
-    }
-  }
-
-  size_t size = TupleHeader::CalculateHeaderSize(var_field_count);
-
-  for (size_t i = 0; i < field_count; i++) {
-    ColumnDefinition col = schema.GetColumn(i);
+  size_t size = schema.GetFixedSectionEnd();
 
-    if (col.IsFixedLength()) {
-      size = alignment::AlignOffset(size, col.GetDataType());
-      size += col.GetFixedSize();
-    } else {
-      if (!values[i].IsNull()) {
-        size += values[i].GetSerializedSize();
-      }
+  const std::vector<FieldLayout>& layout = schema.GetLayout();
+  for (size_t i = 0; i < layout.size(); i++) {
+    if (!layout[i].IsFixedLength() && !values[i].IsNull()) {
+      size += values[i].GetSerializedSize();
     }
   }
 
@@ -0,0 +1,224 @@
+#include "../../include/tuple/value_ref.h"
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include "../../include/schema/alignment.h"
+
+ValueRef::ValueRef(DataType type, bool is_null)
+    : length_(0), type_(static_cast<uint8_t>(type)), is_null_(is_null) {
+  std::memset(&data_, 0, sizeof(data_));
+}
+
+ValueRef ValueRef::Null(DataType type) { return ValueRef(type, true); }
+
+ValueRef ValueRef::Boolean(bool value) {
+  ValueRef ref(DataType::BOOLEAN, false);
+  ref.data_.boolean_val = value;
+  return ref;
+}
+
+ValueRef ValueRef::TinyInt(int8_t value) {
+  ValueRef ref(DataType::TINYINT, false);
+  ref.data_.tinyint_val = value;
+  return ref;
+}
+
+ValueRef ValueRef::SmallInt(int16_t value) {
+  ValueRef ref(DataType::SMALLINT, false);
+  ref.data_.smallint_val = value;
+  return ref;
+}
+
+ValueRef ValueRef::Integer(int32_t value) {
+  ValueRef ref(DataType::INTEGER, false);
+  ref.data_.integer_val = value;
+  return ref;
+}
+
+ValueRef ValueRef::BigInt(int64_t value) {
+  ValueRef ref(DataType::BIGINT, false);
+  ref.data_.bigint_val = value;
+  return ref;
+}
+
+ValueRef ValueRef::Float(float value) {
+  ValueRef ref(DataType::FLOAT, false);
+  ref.data_.float_val = value;
+  return ref;
+}
+
+ValueRef ValueRef::Double(double value) {
+  ValueRef ref(DataType::DOUBLE, false);
+  ref.data_.double_val = value;
+  return ref;
+}
+
+ValueRef ValueRef::Bytes(DataType type, std::string_view value,
+                         Arena* arena) {
+  ValueRef ref(type, false);
+  ref.data_.bytes = arena == nullptr ? value.data()
+                                     : arena->Copy(value.data(), value.size());
+  ref.length_ = static_cast<uint32_t>(value.size());
+  return ref;
+}
+
+ValueRef ValueRef::Char(std::string_view value, Arena* arena) {
+  return Bytes(DataType::CHAR, value, arena);
+}
+
+ValueRef ValueRef::VarChar(std::string_view value, Arena* arena) {
+  return Bytes(DataType::VARCHAR, value, arena);
+}
+
+ValueRef ValueRef::Text(std::string_view value, Arena* arena) {
+  return Bytes(DataType::TEXT, value, arena);
+}
+
+ValueRef ValueRef::Blob(std::string_view bytes, Arena* arena) {
+  return Bytes(DataType::BLOB, bytes, arena);
+}
+
+ValueRef ValueRef::FromFieldValue(const FieldValue& value, Arena* arena) {
+  DataType type = value.GetType();
+  if (value.IsNull()) {
+    return Null(type);
+  }
+
+  switch (type) {
+    case DataType::BOOLEAN:
+      return Boolean(value.GetBoolean());
+    case DataType::TINYINT:
+      return TinyInt(value.GetTinyInt());
+    case DataType::SMALLINT:
+      return SmallInt(value.GetSmallInt());
+    case DataType::INTEGER:
+      return Integer(value.GetInteger());
+    case DataType::BIGINT:
+      return BigInt(value.GetBigInt());
+    case DataType::FLOAT:
+      return Float(value.GetFloat());
+    case DataType::DOUBLE:
+      return Double(value.GetDouble());
+    case DataType::CHAR:
+    case DataType::VARCHAR:
+    case DataType::TEXT:
+      return Bytes(type, value.GetString(), arena);
+    case DataType::BLOB: {
+      const std::vector<uint8_t>& blob = value.GetBlob();
+      return Blob(std::string_view(reinterpret_cast<const char*>(blob.data()),
+                                   blob.size()),
+                  arena);
+    }
+  }
+  throw std::runtime_error("Unknown data type");
+}
+
+FieldValue ValueRef::ToFieldValue() const {
+  DataType type = GetType();
+  if (is_null_) {
+    return FieldValue::Null(type);
+  }
+
+  switch (type) {
+    case DataType::BOOLEAN:
+      return FieldValue::Boolean(data_.boolean_val);
+    case DataType::TINYINT:
+      return FieldValue::TinyInt(data_.tinyint_val);
+    case DataType::SMALLINT:
+      return FieldValue::SmallInt(data_.smallint_val);
+    case DataType::INTEGER:
+      return FieldValue::Integer(data_.integer_val);
+    case DataType::BIGINT:
+      return FieldValue::BigInt(data_.bigint_val);
+    case DataType::FLOAT:
+      return FieldValue::Float(data_.float_val);
+    case DataType::DOUBLE:
+      return FieldValue::Double(data_.double_val);
+    case DataType::CHAR:
+      return FieldValue::Char(std::string(data_.bytes, length_));
+    case DataType::VARCHAR:
+      return FieldValue::VarChar(std::string(data_.bytes, length_));
+    case DataType::TEXT:
+      return FieldValue::Text(std::string(data_.bytes, length_));
+    case DataType::BLOB: {
+      const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data_.bytes);
+      return FieldValue::Blob(std::vector<uint8_t>(bytes, bytes + length_));
+    }
+  }
+  throw std::runtime_error("Unknown data type");
+}
+
+void ValueRef::Check(DataType expected, const char* message) const {
+  if (is_null_) {
+    throw std::runtime_error("Cannot read NULL value");
+  }
+  if (GetType() != expected) {
+    throw std::runtime_error(message);
+  }
+}
+
+bool ValueRef::GetBoolean() const {
+  Check(DataType::BOOLEAN, "Type mismatch: expected BOOLEAN");
+  return data_.boolean_val;
+}
+
+int8_t ValueRef::GetTinyInt() const {
+  Check(DataType::TINYINT, "Type mismatch: expected TINYINT");
+  return data_.tinyint_val;
+}
+
+int16_t ValueRef::GetSmallInt() const {
+  Check(DataType::SMALLINT, "Type mismatch: expected SMALLINT");
+  return data_.smallint_val;
+}
+
+int32_t ValueRef::GetInteger() const {
+  Check(DataType::INTEGER, "Type mismatch: expected INTEGER");
+  return data_.integer_val;
+}
+
+int64_t ValueRef::GetBigInt() const {
+  Check(DataType::BIGINT, "Type mismatch: expected BIGINT");
+  return data_.bigint_val;
+}
+
+float ValueRef::GetFloat() const {
+  Check(DataType::FLOAT, "Type mismatch: expected FLOAT");
+  return data_.float_val;
+}
+
+double ValueRef::GetDouble() const {
+  Check(DataType::DOUBLE, "Type mismatch: expected DOUBLE");
+  return data_.double_val;
+}
+
+std::string_view ValueRef::GetString() const {
+  if (is_null_) {
+    throw std::runtime_error("Cannot read NULL value");
+  }
+  DataType type = GetType();
+  if (type != DataType::CHAR && type != DataType::VARCHAR &&
+      type != DataType::TEXT) {
+    throw std::runtime_error("Type mismatch: expected string type");
+  }
+  return std::string_view(data_.bytes, length_);
+}
+
+std::string_view ValueRef::GetBlob() const {
+  Check(DataType::BLOB, "Type mismatch: expected BLOB");
+  return std::string_view(data_.bytes, length_);
+}
+
+size_t ValueRef::GetSerializedSize() const {
+  if (is_null_) {
+    return 0;
+  }
+
+  size_t fixed_size = alignment::GetFixedSize(GetType(), 0);
+  if (fixed_size > 0) {
+    return fixed_size;
+  }
+  return sizeof(uint16_t) + length_;
+}
@@ -0,0 +1,719 @@
+#include "../../include/workload/workload_driver.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#include "../../include/common/logger.h"
+#include "../../include/common/trace.h"
+#include "../../include/page/page.h"
+#include "../../include/storage/free_space_map.h"
+#include "../../include/storage/log_manager.h"
+#include "../../include/storage/page_manager.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t MAX_WORKLOAD_TUPLE_SIZE =
+    PAGE_SIZE - sizeof(PageHeader) - SLOT_ENTRY_SIZE;
+
+const char* const OP_NAMES[WORKLOAD_OP_COUNT] = {"READ", "UPDATE", "INSERT",
+                                                 "DELETE"};
+
+// Key table entries: 0 is "no tuple" (page 0 is never a data page)
+uint64_t PackTupleId(TupleId tuple_id) {
+  return (static_cast<uint64_t>(tuple_id.page_id) << 16) | tuple_id.slot_id;
+}
+
+TupleId UnpackTupleId(uint64_t packed) {
+  return {static_cast<page_id_t>(packed >> 16),
+          static_cast<slot_id_t>(packed & 0xFFFF)};
+}
+
+// FNV-1a over the rank, so popular keys are spread over the key space
+// instead of clustering at its start
+uint64_t ScrambleKey(uint64_t rank) {
+  uint64_t hash = 0xCBF29CE484222325ULL;
+  for (int i = 0; i < 8; i++) {
+    hash ^= (rank >> (i * 8)) & 0xFF;
+    hash *= 0x100000001B3ULL;
+  }
+  return hash;
+}
+
+std::string ValidateConfig(const WorkloadConfig& config) {
+  const double proportions[WORKLOAD_OP_COUNT] = {
+      config.read_proportion, config.update_proportion,
+      config.insert_proportion, config.delete_proportion};
+  double total = 0;
+  for (double proportion : proportions) {
+    if (proportion < 0) {
+      return "operation proportions must not be negative";
+    }
+    total += proportion;
+  }
+  if (total <= 0) {
+    return "at least one operation proportion must be positive";
+  }
+  if (config.record_count == 0) {
+    return "records must be positive";
+  }
+  if (config.threads == 0) {
+    return "threads must be positive";
+  }
+  if (config.cache_mb == 0) {
+    return "cache-mb must be positive";
+  }
+  if (config.min_tuple_size == 0 ||
+      config.min_tuple_size > config.max_tuple_size) {
+    return "tuple sizes must satisfy 0 < min-tuple-size <= max-tuple-size";
+  }
+  if (config.max_tuple_size > MAX_WORKLOAD_TUPLE_SIZE) {
+    return "max-tuple-size must be at most " +
+           std::to_string(MAX_WORKLOAD_TUPLE_SIZE);
+  }
+  if (config.distribution == KeyDistribution::ZIPFIAN &&
+      !(config.zipfian_theta > 0 && config.zipfian_theta < 1)) {
+    return "theta must be in (0, 1)";
+  }
+  return "";
+}
+
+bool ParseUnsigned(const std::string& text, uint64_t max, uint64_t* value) {
+  if (text.empty() || text[0] == '-') {
+    return false;
+  }
+  char* end = nullptr;
+  errno = 0;
+  unsigned long long parsed = std::strtoull(text.c_str(), &end, 10);
+  if (errno != 0 || *end != '\0' || parsed > max) {
+    return false;
+  }
+  *value = parsed;
+  return true;
+}
+
+bool ParseDouble(const std::string& text, double* value) {
+  if (text.empty()) {
+    return false;
+  }
+  char* end = nullptr;
+  errno = 0;
+  double parsed = std::strtod(text.c_str(), &end);
+  if (errno != 0 || *end != '\0' || !std::isfinite(parsed)) {
+    return false;
+  }
+  *value = parsed;
+  return true;
+}
+
+const char* DistributionName(KeyDistribution distribution) {
+  return distribution == KeyDistribution::ZIPFIAN ? "zipfian" : "uniform";
+}
+
+const char* ReplacerName(ReplacerType replacer) {
+  return replacer == ReplacerType::CLOCK ? "clock" : "lru-k";
+}
+
+const char* DurabilityName(DurabilityMode durability) {
+  switch (durability) {
+    case DurabilityMode::IMMEDIATE:
+      return "immediate";
+    case DurabilityMode::BATCHED:
+      return "batched";
+    case DurabilityMode::PERIODIC:
+      return "periodic";
+  }
+  return "unknown";
+}
+
+// Shared state of one run
+struct WorkloadTable {
+  PageManager* page_manager;
+  // key -> packed TupleId (0: deleted or not yet inserted)
+  std::unique_ptr<std::atomic<uint64_t>[]> keys;
+  size_t key_capacity;
+  std::atomic<size_t> next_key{0};
+};
+
+class WorkloadThread {
+ public:
+  WorkloadThread(const WorkloadConfig& config, WorkloadTable* table,
+                 const ZipfianGenerator* zipfian, size_t thread_index)
+      : table_(table),
+        zipfian_(zipfian),
+        rng_(config.seed * 0x9E3779B97F4A7C15ULL + thread_index),
+        size_dist_(config.min_tuple_size, config.max_tuple_size),
+        buffer_(config.max_tuple_size) {
+    const double proportions[WORKLOAD_OP_COUNT] = {
+        config.read_proportion, config.update_proportion,
+        config.insert_proportion, config.delete_proportion};
+    double total = 0;
+    for (double proportion : proportions) {
+      total += proportion;
+    }
+    double cumulative = 0;
+    for (size_t i = 0; i < WORKLOAD_OP_COUNT; i++) {
+      cumulative += proportions[i] / total;
+      thresholds_[i] = cumulative;
+      if (proportions[i] > 0) {
+        last_op_ = static_cast<WorkloadOp>(i);
+      }
+    }
+  }
+
+  // Insert keys [first, end) of the initial data set
+  void Load(size_t first, size_t end) {
+    for (size_t key = first; key < end; key++) {
+      uint16_t size = NextTupleSize();
+      FillTuple(key, size);
+      TupleId tuple_id =
+          table_->page_manager->InsertTuple(buffer_.data(), size);
+      if (tuple_id.slot_id != INVALID_SLOT_ID) {
+        table_->keys[key].store(PackTupleId(tuple_id),
+                                std::memory_order_release);
+      }
+    }
+  }
+
+  void Run(size_t operation_count,
+           std::array<WorkloadOpStats, WORKLOAD_OP_COUNT>* stats) {
+    for (size_t i = 0; i < operation_count; i++) {
+      WorkloadOp op = NextOp();
+      WorkloadOpStats& op_stats = (*stats)[static_cast<size_t>(op)];
+      Clock::time_point start = Clock::now();
+      Outcome outcome = Execute(op);
+      auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+          Clock::now() - start);
+      op_stats.latency.Record(static_cast<uint64_t>(elapsed.count()));
+      switch (outcome) {
+        case Outcome::OK:
+          op_stats.completed++;
+          break;
+        case Outcome::NOT_FOUND:
+          op_stats.not_found++;
+          break;
+        case Outcome::FAILED:
+          op_stats.failed++;
+          break;
+      }
+    }
+  }
+
+ private:
+  enum class Outcome { OK, NOT_FOUND, FAILED };
+
+  WorkloadTable* table_;
+  const ZipfianGenerator* zipfian_;
+  std::mt19937_64 rng_;
+  std::uniform_real_distribution<double> unit_{0.0, 1.0};
+  std::uniform_int_distribution<uint32_t> size_dist_;
+  std::vector<char> buffer_;
+  double thresholds_[WORKLOAD_OP_COUNT];
+  // Picked if rounding leaves u above the last threshold
+  WorkloadOp last_op_ = WorkloadOp::READ;
+
+  WorkloadOp NextOp() {
+    double u = unit_(rng_);
+    for (size_t i = 0; i < WORKLOAD_OP_COUNT; i++) {
+      if (u < thresholds_[i]) {
+        return static_cast<WorkloadOp>(i);
+      }
+    }
+    return last_op_;
+  }
+
+  uint16_t NextTupleSize() { return static_cast<uint16_t>(size_dist_(rng_)); }
+
+  // Key of an existing record (one of the next_key keys handed out so far)
+  size_t NextKey() {
+    size_t key_count = std::min(table_->next_key.load(), table_->key_capacity);
+    if (zipfian_ != nullptr) {
+      return ScrambleKey(zipfian_->Next(unit_(rng_))) % key_count;
+    }
+    return std::min(static_cast<size_t>(unit_(rng_) * key_count),
+                    key_count - 1);
+  }
+
+  void FillTuple(size_t key, uint16_t size) {
+    std::fill(buffer_.begin(), buffer_.begin() + size,
+              static_cast<char>('a' + key % 26));
+  }
+
+  Outcome Execute(WorkloadOp op) {
+    PageManager* pm = table_->page_manager;
+    if (op == WorkloadOp::INSERT) {
+      size_t key = table_->next_key.fetch_add(1);
+      if (key >= table_->key_capacity) {
+        return Outcome::FAILED;
+      }
+      uint16_t size = NextTupleSize();
+      FillTuple(key, size);
+      TupleId tuple_id = pm->InsertTuple(buffer_.data(), size);
+      if (tuple_id.slot_id == INVALID_SLOT_ID) {
+        return Outcome::FAILED;
+      }
+      table_->keys[key].store(PackTupleId(tuple_id),
+                              std::memory_order_release);
+      return Outcome::OK;
+    }
+
+    size_t key = NextKey();
+    std::atomic<uint64_t>& entry = table_->keys[key];
+    if (op == WorkloadOp::DELETE) {
+      uint64_t packed = entry.exchange(0, std::memory_order_acq_rel);
+      if (packed == 0) {
+        return Outcome::NOT_FOUND;
+      }
+      return pm->DeleteTuple(UnpackTupleId(packed)).code == 0
+                 ? Outcome::OK
+                 : Outcome::FAILED;
+    }
+
+    uint64_t packed = entry.load(std::memory_order_acquire);
+    if (packed == 0) {
+      return Outcome::NOT_FOUND;
+    }
+    ErrorCode result;
+    if (op == WorkloadOp::READ) {
+      result = pm->GetTuple(UnpackTupleId(packed), buffer_.data(),
+                            static_cast<uint16_t>(buffer_.size()));
+    } else {
+      uint16_t size = NextTupleSize();
+      FillTuple(key, size);
+      result = pm->UpdateTuple(UnpackTupleId(packed), buffer_.data(), size);
+    }
+    if (result.code == 0) {
+      return Outcome::OK;
+    }
+    // Lost a race with a delete of the same key
+    return entry.load(std::memory_order_acquire) != packed
+               ? Outcome::NOT_FOUND
+               : Outcome::FAILED;
+  }
+};
+
+double SecondsSince(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+}  // namespace
+
+ZipfianGenerator::ZipfianGenerator(uint64_t item_count, double theta)
+    : item_count_(item_count), theta_(theta) {
+  if (item_count == 0) {
+    throw std::invalid_argument("ZipfianGenerator: item_count must be > 0");
+  }
+  if (!(theta > 0 && theta < 1)) {
+    throw std::invalid_argument("ZipfianGenerator: theta must be in (0, 1)");
+  }
+  zetan_ = 0;
+  for (uint64_t i = 1; i <= item_count; i++) {
+    zetan_ += 1.0 / std::pow(static_cast<double>(i), theta);
+  }
+  double zeta2 = 1.0 + std::pow(0.5, theta);
+  alpha_ = 1.0 / (1.0 - theta);
+  eta_ = (1.0 - std::pow(2.0 / static_cast<double>(item_count), 1.0 - theta)) /
+         (1.0 - zeta2 / zetan_);
+}
+
+uint64_t ZipfianGenerator::Next(double u) const {
+  double uz = u * zetan_;
+  if (uz < 1.0 || item_count_ == 1) {
+    return 0;
+  }
+  if (uz < 1.0 + std::pow(0.5, theta_)) {
+    return 1;
+  }
+  double rank = static_cast<double>(item_count_) *
+                std::pow(eta_ * u - eta_ + 1.0, alpha_);
+  return std::min(static_cast<uint64_t>(rank), item_count_ - 1);
+}
+
+uint64_t WorkloadReport::GetTotalOperations() const {
+  uint64_t total = 0;
+  for (const WorkloadOpStats& stats : ops) {
+    total += stats.latency.GetCount();
+  }
+  return total;
+}
+
+double WorkloadReport::GetThroughput() const {
+  return run_seconds > 0
+             ? static_cast<double>(GetTotalOperations()) / run_seconds
+             : 0;
+}
+
+bool ParseWorkloadArgs(const std::vector<std::string>& args,
+                       WorkloadConfig* config, std::string* error) {
+  WorkloadConfig parsed = *config;
+  for (const std::string& arg : args) {
+    if (arg.rfind("--", 0) != 0) {
+      *error = "unexpected argument '" + arg + "'";
+      return false;
+    }
+    size_t equals = arg.find('=');
+    std::string name = arg.substr(2, equals == std::string::npos
+                                         ? std::string::npos
+                                         : equals - 2);
+    bool has_value = equals != std::string::npos;
+    std::string value = has_value ? arg.substr(equals + 1) : "";
+
+    if (name == "direct-io" || name == "wal") {
+      if (has_value) {
+        *error = "option --" + name + " takes no value";
+        return false;
+      }
+      (name == "wal" ? parsed.use_wal : parsed.direct_io) = true;
+      continue;
+    }
+    static const char* const VALUE_OPTIONS[] = {
+        "records",    "operations",     "read",           "update",
+        "insert",     "delete",         "distribution",   "theta",
+        "tuple-size", "min-tuple-size", "max-tuple-size", "threads",
+        "cache-mb",   "replacer",       "durability",     "dir",
+        "seed",       "trace",          "trace-sample"};
+    if (std::find(std::begin(VALUE_OPTIONS), std::end(VALUE_OPTIONS),
+                  name) == std::end(VALUE_OPTIONS)) {
+      *error = "unknown option --" + name;
+      return false;
+    }
+    if (!has_value) {
+      *error = "option --" + name + " needs a value";
+      return false;
+    }
+
+    uint64_t number = 0;
+    bool ok = true;
+    if (name == "records") {
+      ok = ParseUnsigned(value, UINT32_MAX, &number);
+      parsed.record_count = number;
+    } else if (name == "operations") {
+      ok = ParseUnsigned(value, UINT32_MAX, &number);
+      parsed.operation_count = number;
+    } else if (name == "read") {
+      ok = ParseDouble(value, &parsed.read_proportion);
+    } else if (name == "update") {
+      ok = ParseDouble(value, &parsed.update_proportion);
+    } else if (name == "insert") {
+      ok = ParseDouble(value, &parsed.insert_proportion);
+    } else if (name == "delete") {
+      ok = ParseDouble(value, &parsed.delete_proportion);
+    } else if (name == "distribution") {
+      if (value == "uniform") {
+        parsed.distribution = KeyDistribution::UNIFORM;
+      } else if (value == "zipfian") {
+        parsed.distribution = KeyDistribution::ZIPFIAN;
+      } else {
+        ok = false;
+      }
+    } else if (name == "theta") {
+      ok = ParseDouble(value, &parsed.zipfian_theta);
+    } else if (name == "tuple-size") {
+      ok = ParseUnsigned(value, UINT16_MAX, &number);
+      parsed.min_tuple_size = static_cast<uint16_t>(number);
+      parsed.max_tuple_size = static_cast<uint16_t>(number);
+    } else if (name == "min-tuple-size") {
+      ok = ParseUnsigned(value, UINT16_MAX, &number);
+      parsed.min_tuple_size = static_cast<uint16_t>(number);
+    } else if (name == "max-tuple-size") {
+      ok = ParseUnsigned(value, UINT16_MAX, &number);
+      parsed.max_tuple_size = static_cast<uint16_t>(number);
+    } else if (name == "threads") {
+      ok = ParseUnsigned(value, 1024, &number);
+      parsed.threads = number;
+    } else if (name == "cache-mb") {
+      ok = ParseUnsigned(value, UINT32_MAX, &number);
+      parsed.cache_mb = number;
+    } else if (name == "replacer") {
+      if (value == "lru-k") {
+        parsed.replacer = ReplacerType::LRU_K;
+      } else if (value == "clock") {
+        parsed.replacer = ReplacerType::CLOCK;
+      } else {
+        ok = false;
+      }
+    } else if (name == "durability") {
+      if (value == "immediate") {
+        parsed.durability = DurabilityMode::IMMEDIATE;
+      } else if (value == "batched") {
+        parsed.durability = DurabilityMode::BATCHED;
+      } else if (value == "periodic") {
+        parsed.durability = DurabilityMode::PERIODIC;
+      } else {
+        ok = false;
+      }
+    } else if (name == "dir") {
+      ok = !value.empty();
+      parsed.directory = value;
+    } else if (name == "seed") {
+      ok = ParseUnsigned(value, UINT64_MAX, &parsed.seed);
+    } else if (name == "trace") {
+      ok = !value.empty();
+      parsed.trace_file = value;
+    } else if (name == "trace-sample") {
+      ok = ParseUnsigned(value, UINT32_MAX, &number);
+      parsed.trace_sample_rate = static_cast<uint32_t>(number);
+    }
+    if (!ok) {
+      *error = "invalid value '" + value + "' for --" + name;
+      return false;
+    }
+  }
+
+  if (!parsed.trace_file.empty() && parsed.trace_sample_rate == 0) {
+    parsed.trace_sample_rate = 100;
+  }
+
+  std::string invalid = ValidateConfig(parsed);
+  if (!invalid.empty()) {
+    *error = invalid;
+    return false;
+  }
+  *config = parsed;
+  return true;
+}
+
+std::string WorkloadUsage() {
+  WorkloadConfig defaults;
+  std::ostringstream out;
+  out << "Usage: storage_engine workload [options]\n"
+      << "\n"
+      << "Data set and mix:\n"
+      << "  --records=N            initial records (" << defaults.record_count
+      << ")\n"
+      << "  --operations=N         operations in the run phase ("
+      << defaults.operation_count << ")\n"
+      << "  --read=P --update=P --insert=P --delete=P\n"
+      << "                         operation proportions, normalized ("
+      << defaults.read_proportion << "/" << defaults.update_proportion << "/"
+      << defaults.insert_proportion << "/" << defaults.delete_proportion
+      << ")\n"
+      << "  --distribution=D       uniform | zipfian ("
+      << DistributionName(defaults.distribution) << ")\n"
+      << "  --theta=X              zipfian skew in (0, 1) ("
+      << defaults.zipfian_theta << ")\n"
+      << "  --tuple-size=N         fixed tuple size in bytes ("
+      << defaults.max_tuple_size << ")\n"
+      << "  --min-tuple-size=N --max-tuple-size=N\n"
+      << "                         uniform tuple size range\n"
+      << "\n"
+      << "Engine:\n"
+      << "  --threads=N            client threads (" << defaults.threads
+      << ")\n"
+      << "  --cache-mb=N           buffer pool size (" << defaults.cache_mb
+      << ")\n"
+      << "  --replacer=R           lru-k | clock ("
+      << ReplacerName(defaults.replacer) << ")\n"
+      << "  --durability=M         immediate | batched | periodic ("
+      << DurabilityName(defaults.durability) << ")\n"
+      << "  --direct-io            bypass the page cache (O_DIRECT)\n"
+      << "  --wal                  write-ahead log with group commit\n"
+      << "  --dir=PATH             directory for the table files ("
+      << defaults.directory << ")\n"
+      << "  --seed=N               random seed (" << defaults.seed << ")\n"
+      << "\n"
+      << "Tracing (builds with ENABLE_TRACING):\n"
+      << "  --trace=FILE           write sampled spans as Chrome trace JSON\n"
+      << "  --trace-sample=N       trace one operation in N per thread "
+         "(100 with --trace)\n";
+  return out.str();
+}
+
+ErrorCode RunWorkload(const WorkloadConfig& config, WorkloadReport* report) {
+  std::string invalid = ValidateConfig(config);
+  if (!invalid.empty()) {
+    return {-1, "RunWorkload: " + invalid};
+  }
+
+  std::string base = (std::filesystem::path(config.directory) /
+                      ("workload_" + std::to_string(getpid())))
+                         .string();
+  const std::string files[] = {base + ".db", base + ".fsm", base + ".wal"};
+  auto remove_files = [&files]() {
+    std::error_code ignored;
+    for (const std::string& file : files) {
+      std::filesystem::remove(file, ignored);
+    }
+  };
+  remove_files();
+
+  *report = WorkloadReport();
+  size_t expected_inserts =
+      config.insert_proportion > 0 ? config.operation_count : 0;
+  WorkloadTable table;
+  table.key_capacity = config.record_count + expected_inserts;
+  table.keys.reset(new std::atomic<uint64_t>[table.key_capacity]);
+  for (size_t i = 0; i < table.key_capacity; i++) {
+    table.keys[i].store(0, std::memory_order_relaxed);
+  }
+
+  std::unique_ptr<ZipfianGenerator> zipfian;
+  if (config.distribution == KeyDistribution::ZIPFIAN) {
+    zipfian = std::make_unique<ZipfianGenerator>(config.record_count,
+                                                 config.zipfian_theta);
+  }
+
+  try {
+    DiskManager disk_manager(files[0], config.durability,
+                             DEFAULT_SYNC_INTERVAL_MS, IOEngineType::AUTO,
+                             config.direct_io);
+    FreeSpaceMap fsm(files[1]);
+    std::unique_ptr<LogManager> log_manager;
+    if (config.use_wal) {
+      log_manager = std::make_unique<LogManager>(files[2]);
+    }
+    std::unique_ptr<PageManager> page_manager = std::make_unique<PageManager>(
+        &disk_manager, &fsm, config.cache_mb, config.replacer,
+        log_manager.get());
+    table.page_manager = page_manager.get();
+
+    std::vector<std::unique_ptr<WorkloadThread>> workers;
+    for (size_t i = 0; i < config.threads; i++) {
+      workers.push_back(std::make_unique<WorkloadThread>(
+          config, &table, zipfian.get(), i));
+    }
+
+    Clock::time_point load_start = Clock::now();
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < config.threads; i++) {
+      size_t first = config.record_count * i / config.threads;
+      size_t end = config.record_count * (i + 1) / config.threads;
+      threads.emplace_back(
+          [&workers, i, first, end]() { workers[i]->Load(first, end); });
+    }
+    for (std::thread& thread : threads) {
+      thread.join();
+    }
+    table.next_key.store(config.record_count);
+    report->load_seconds = SecondsSince(load_start);
+
+    std::vector<std::array<WorkloadOpStats, WORKLOAD_OP_COUNT>> stats(
+        config.threads);
+    threads.clear();
+    Tracer& tracer = Tracer::Instance();
+    const uint32_t previous_sample_rate = tracer.GetSampleRate();
+    if (!config.trace_file.empty()) {
+      tracer.Clear();
+      tracer.SetSampleRate(config.trace_sample_rate);
+    }
+    Clock::time_point run_start = Clock::now();
+    for (size_t i = 0; i < config.threads; i++) {
+      size_t count = config.operation_count * (i + 1) / config.threads -
+                     config.operation_count * i / config.threads;
+      threads.emplace_back([&workers, &stats, i, count]() {
+        workers[i]->Run(count, &stats[i]);
+      });
+    }
+    for (std::thread& thread : threads) {
+      thread.join();
+    }
+    report->run_seconds = SecondsSince(run_start);
+    if (!config.trace_file.empty()) {
+      tracer.SetSampleRate(previous_sample_rate);
+      if (!tracer.WriteChromeTrace(config.trace_file)) {
+        LOG_ERROR_STREAM("RunWorkload: Cannot write trace file "
+                         << config.trace_file);
+      }
+    }
+
+    for (const auto& thread_stats : stats) {
+      for (size_t op = 0; op < WORKLOAD_OP_COUNT; op++) {
+        report->ops[op].completed += thread_stats[op].completed;
+        report->ops[op].not_found += thread_stats[op].not_found;
+        report->ops[op].failed += thread_stats[op].failed;
+        report->ops[op].latency.Merge(thread_stats[op].latency);
+      }
+    }
+    report->metrics = page_manager->GetMetrics();
+    page_manager.reset();
+  } catch (const std::exception& e) {
+    LOG_ERROR_STREAM("RunWorkload: " << e.what());
+    remove_files();
+    return {-2, std::string("RunWorkload: ") + e.what()};
+  }
+
+  remove_files();
+  return {0, "RunWorkload: Success"};
+}
+
+void PrintWorkloadReport(const WorkloadConfig& config,
+                         const WorkloadReport& report, std::ostream& out) {
+  std::ios_base::fmtflags flags = out.flags();
+  std::streamsize precision = out.precision();
+
+  out << "Workload: " << config.record_count << " records, "
+      << config.operation_count << " operations, " << config.threads
+      << " threads, " << DistributionName(config.distribution);
+  if (config.distribution == KeyDistribution::ZIPFIAN) {
+    out << " (theta " << config.zipfian_theta << ")";
+  }
+  out << ", tuples " << config.min_tuple_size << "-" << config.max_tuple_size
+      << " B\n";
+  out << "Engine:   " << config.cache_mb << " MB cache, "
+      << ReplacerName(config.replacer) << ", "
+      << DurabilityName(config.durability)
+      << (config.direct_io ? ", direct I/O" : "")
+      << (config.use_wal ? ", WAL" : "") << "\n";
+
+  out << std::fixed << std::setprecision(2);
+  double load_rate = report.load_seconds > 0
+                         ? static_cast<double>(config.record_count) /
+                               report.load_seconds
+                         : 0;
+  out << "Load:     " << report.load_seconds << " s (" << std::setprecision(0)
+      << load_rate << " records/s)\n";
+  out << std::setprecision(2) << "Run:      " << report.run_seconds << " s ("
+      << std::setprecision(0) << report.GetThroughput() << " ops/s)\n";
+  const StorageMetrics& metrics = report.metrics;
+  out << std::setprecision(2) << "Cache:    "
+      << metrics.buffer_pool.GetHitRate() * 100 << "% hits, "
+      << metrics.buffer_pool.dirty_evictions << " dirty / "
+      << metrics.buffer_pool.clean_evictions << " clean evictions\n";
+  out << "Disk:     " << metrics.disk.page_reads << " reads, "
+      << metrics.disk.page_writes << " writes, " << metrics.disk.syncs
+      << " syncs\n\n";
+
+  out << std::left << std::setw(8) << "op" << std::right << std::setw(11)
+      << "count" << std::setw(11) << "not found" << std::setw(8) << "failed"
+      << std::setw(10) << "mean us" << std::setw(10) << "p50 us"
+      << std::setw(10) << "p99 us" << std::setw(10) << "p999 us"
+      << std::setw(10) << "max us" << "\n";
+  out << std::setprecision(1);
+  auto micros = [](double nanos) { return nanos / 1000.0; };
+  for (size_t op = 0; op < WORKLOAD_OP_COUNT; op++) {
+    const WorkloadOpStats& stats = report.ops[op];
+    const LatencyHistogram& latency = stats.latency;
+    if (latency.GetCount() == 0) {
+      continue;
+    }
+    out << std::left << std::setw(8) << OP_NAMES[op] << std::right
+        << std::setw(11) << stats.completed << std::setw(11)
+        << stats.not_found << std::setw(8) << stats.failed << std::setw(10)
+        << micros(latency.GetMean()) << std::setw(10)
+        << micros(static_cast<double>(latency.GetPercentile(0.50)))
+        << std::setw(10)
+        << micros(static_cast<double>(latency.GetPercentile(0.99)))
+        << std::setw(10)
+        << micros(static_cast<double>(latency.GetPercentile(0.999)))
+        << std::setw(10) << micros(static_cast<double>(latency.GetMax()))
+        << "\n";
+  }
+
+  out.flags(flags);
+  out.precision(precision);
+}
@@ -0,0 +1,42 @@
+#include "../include/common/arena.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+
+TEST(ArenaTest, ZeroBlockSizeThrows) {
+  EXPECT_THROW(Arena(0), std::invalid_argument);
+}
+
+TEST(ArenaTest, AllocationsAreAlignedAndDistinct) {
+  Arena arena(256);
+  char* a = arena.Allocate(3, 1);
+  char* b = arena.Allocate(8, 8);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(b) % 8, 0);
+  EXPECT_GE(b, a + 3);
+
+  const char* copy = arena.Copy("hello", 5);
+  EXPECT_EQ(std::memcmp(copy, "hello", 5), 0);
+  EXPECT_EQ(arena.Copy("x", 0), nullptr);
+  EXPECT_EQ(arena.GetBytesUsed(), 16);
+}
+
+TEST(ArenaTest, ResetReusesBlocks) {
+  Arena arena(128);
+  for (int i = 0; i < 10; i++) {
+    arena.Allocate(100, 1);  // one block each
+  }
+  arena.Allocate(1000, 1);  // oversized block
+  size_t capacity = arena.GetCapacity();
+  EXPECT_GE(capacity, 10 * 128 + 1000);
+
+  // Same workload after Reset() needs no new blocks
+  arena.Reset();
+  EXPECT_EQ(arena.GetBytesUsed(), 0);
+  for (int i = 0; i < 10; i++) {
+    arena.Allocate(100, 1);
+  }
+  arena.Allocate(1000, 1);
+  EXPECT_EQ(arena.GetCapacity(), capacity);
+}
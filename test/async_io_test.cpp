@@ -0,0 +1,244 @@
+#include "../include/storage/async_io.h"
+
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <vector>
+
+#include "../include/buffer/buffer_pool_manager.h"
+#include "../include/storage/disk_manager.h"
+#include "../include/storage/io_uring_engine.h"
+
+namespace fs = std::filesystem;
+
+// Runs every engine test against both io_uring and the thread pool
+class AsyncIOEngineTest : public ::testing::TestWithParam<IOEngineType> {
+ protected:
+  void SetUp() override {
+    if (GetParam() == IOEngineType::IO_URING && !IoUringEngine::IsSupported()) {
+      GTEST_SKIP() << "io_uring not available on this system";
+    }
+
+    fs::create_directories("/tmp/test");
+    file_ = "/tmp/test/async_io_" +
+            std::to_string(
+                std::chrono::system_clock::now().time_since_epoch().count()) +
+            ".dat";
+    fd_ = open(file_.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    ASSERT_GE(fd_, 0);
+
+    engine_ = AsyncIOEngine::Create(GetParam());
+    ASSERT_NE(engine_, nullptr);
+  }
+
+  void TearDown() override {
+    engine_.reset();
+    if (fd_ >= 0) {
+      close(fd_);
+      std::remove(file_.c_str());
+    }
+  }
+
+  std::string file_;
+  int fd_ = -1;
+  std::unique_ptr<AsyncIOEngine> engine_;
+};
+
+TEST_P(AsyncIOEngineTest, WriteThenReadBatch) {
+  const int num_blocks = 32;
+  std::vector<std::vector<char>> out(num_blocks, std::vector<char>(4096));
+  std::vector<std::vector<char>> in(num_blocks, std::vector<char>(4096));
+
+  std::vector<IORequest> writes;
+  for (int i = 0; i < num_blocks; i++) {
+    memset(out[i].data(), 'a' + (i % 26), out[i].size());
+    writes.push_back({IOOpType::WRITE, fd_, out[i].data(), out[i].size(),
+                      static_cast<off_t>(i) * 4096, nullptr});
+  }
+  for (const IOHandle& handle : engine_->Submit(std::move(writes))) {
+    EXPECT_EQ(handle.Wait().code, 0);
+  }
+
+  std::vector<IORequest> reads;
+  for (int i = 0; i < num_blocks; i++) {
+    reads.push_back({IOOpType::READ, fd_, in[i].data(), in[i].size(),
+                     static_cast<off_t>(i) * 4096, nullptr});
+  }
+  std::vector<IOHandle> handles = engine_->Submit(std::move(reads));
+  ASSERT_EQ(handles.size(), static_cast<size_t>(num_blocks));
+  for (int i = 0; i < num_blocks; i++) {
+    EXPECT_EQ(handles[i].Wait().code, 0);
+    EXPECT_TRUE(handles[i].IsReady());
+    EXPECT_EQ(in[i], out[i]);
+  }
+}
+
+TEST_P(AsyncIOEngineTest, BatchLargerThanQueueDepth) {
+  // More requests than the default ring can hold in one go
+  const int num_blocks = 300;
+  std::vector<char> block(512, 'z');
+  std::vector<IORequest> writes;
+  for (int i = 0; i < num_blocks; i++) {
+    writes.push_back({IOOpType::WRITE, fd_, block.data(), block.size(),
+                      static_cast<off_t>(i) * 512, nullptr});
+  }
+  for (const IOHandle& handle : engine_->Submit(std::move(writes))) {
+    EXPECT_EQ(handle.Wait().code, 0);
+  }
+  EXPECT_EQ(fs::file_size(file_), static_cast<uintmax_t>(num_blocks) * 512);
+}
+
+TEST_P(AsyncIOEngineTest, ShortReadAndHookResult) {
+  char buffer[128];
+  ssize_t seen = 1;
+  IORequest request{IOOpType::READ, fd_, buffer, sizeof(buffer), 0, nullptr};
+  request.on_complete = [&seen](ssize_t res) -> ErrorCode {
+    seen = res;
+    return {res == 0 ? -7 : 0, "hook"};
+  };
+
+  std::vector<IORequest> requests;
+  requests.push_back(std::move(request));
+  ErrorCode result = engine_->Submit(std::move(requests)).front().Wait();
+
+  // Empty file: zero bytes read, hook maps it to its own error code
+  EXPECT_EQ(seen, 0);
+  EXPECT_EQ(result.code, -7);
+}
+
+TEST_P(AsyncIOEngineTest, BadDescriptorFails) {
+  char buffer[64];
+  std::vector<IORequest> requests;
+  requests.push_back(
+      {IOOpType::READ, -1, buffer, sizeof(buffer), 0, nullptr});
+  EXPECT_NE(engine_->Submit(std::move(requests)).front().Wait().code, 0);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Engines, AsyncIOEngineTest,
+    ::testing::Values(IOEngineType::IO_URING, IOEngineType::THREAD_POOL),
+    [](const ::testing::TestParamInfo<IOEngineType>& info) {
+      return info.param == IOEngineType::IO_URING ? "IoUring" : "ThreadPool";
+    });
+
+// ============================================================================
+// DiskManager / BufferPoolManager integration
+// ============================================================================
+
+class AsyncDiskIOTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    fs::create_directories("/tmp/test");
+    db_file_ = "/tmp/test/async_dm_" +
+               std::to_string(
+                   std::chrono::system_clock::now().time_since_epoch().count()) +
+               ".db";
+  }
+
+  void TearDown() override { std::remove(db_file_.c_str()); }
+
+  std::string db_file_;
+};
+
+TEST_F(AsyncDiskIOTest, DiskManagerAsyncRoundTrip) {
+  DiskManager disk_manager(db_file_);
+
+  auto page = Page::CreateNew();
+  const page_id_t page_id = disk_manager.AllocatePage();
+  page->SetPageId(page_id);
+  const char* data = "async tuple";
+  ASSERT_NE(page->InsertTuple(data, strlen(data)), INVALID_SLOT_ID);
+
+  ASSERT_EQ(disk_manager.WritePageAsync(page_id, page->GetRawBuffer())
+                .Wait()
+                .code,
+            0);
+  disk_manager.Sync();
+
+  auto loaded = Page::CreateNew();
+  ErrorCode result =
+      disk_manager.ReadPageAsync(page_id, loaded->GetRawBuffer()).Wait();
+  ASSERT_EQ(result.code, 0) << result.message;
+  EXPECT_TRUE(loaded->VerifyChecksum());
+  SlotEntry entry = loaded->GetSlotEntry(0);
+  EXPECT_EQ(std::string(loaded->GetRawBuffer() + entry.offset, entry.length),
+            data);
+}
+
+TEST_F(AsyncDiskIOTest, AsyncReadDetectsCorruption) {
+  DiskManager disk_manager(db_file_);
+
+  auto page = Page::CreateNew();
+  const page_id_t page_id = disk_manager.AllocatePage();
+  page->SetPageId(page_id);
+  disk_manager.WritePage(page_id, page->GetRawBuffer());
+
+  // Flip a byte in the page's data area behind the DiskManager's back.
+  // It is the only page, so it occupies the last PAGE_SIZE bytes.
+  const int fd = open(db_file_.c_str(), O_RDWR);
+  ASSERT_GE(fd, 0);
+  const char garbage = 0x5A;
+  const off_t page_start =
+      static_cast<off_t>(fs::file_size(db_file_)) - PAGE_SIZE;
+  ASSERT_EQ(pwrite(fd, &garbage, 1, page_start + 100), 1);
+  close(fd);
+
+  auto loaded = Page::CreateNew();
+  EXPECT_NE(disk_manager.ReadPageAsync(page_id, loaded->GetRawBuffer())
+                .Wait()
+                .code,
+            0);
+}
+
+TEST_F(AsyncDiskIOTest, ThreadPoolEngineSelectable) {
+  DiskManager disk_manager(db_file_, DurabilityMode::IMMEDIATE,
+                           DEFAULT_SYNC_INTERVAL_MS, IOEngineType::THREAD_POOL);
+  EXPECT_STREQ(disk_manager.GetIOEngineName(), "thread_pool");
+}
+
+TEST_F(AsyncDiskIOTest, FetchPagesBatchesMisses) {
+  DiskManager disk_manager(db_file_);
+  std::vector<page_id_t> ids;
+  {
+    BufferPoolManager bpm(16, &disk_manager);
+    for (int i = 0; i < 10; i++) {
+      page_id_t pid;
+      Page* page = bpm.NewPage(&pid);
+      ASSERT_NE(page, nullptr);
+      std::string data = "batched-" + std::to_string(pid);
+      ASSERT_NE(page->InsertTuple(data.c_str(), data.size()), INVALID_SLOT_ID);
+      bpm.UnpinPage(pid, true);
+      ids.push_back(pid);
+    }
+  }  // flushed to disk
+
+  BufferPoolManager bpm(16, &disk_manager);
+  ASSERT_NE(bpm.FetchPage(ids[0]), nullptr);  // one hit in the batch
+
+  std::vector<page_id_t> request = ids;
+  request.push_back(ids[3]);  // duplicate miss
+  std::vector<Page*> pages = bpm.FetchPages(request);
+  ASSERT_EQ(pages.size(), request.size());
+
+  for (size_t i = 0; i < request.size(); i++) {
+    ASSERT_NE(pages[i], nullptr);
+    SlotEntry entry = pages[i]->GetSlotEntry(0);
+    EXPECT_EQ(std::string(pages[i]->GetRawBuffer() + entry.offset,
+                          entry.length),
+              "batched-" + std::to_string(request[i]));
+  }
+
+  EXPECT_EQ(bpm.GetPinCount(ids[0]), 2);
+  EXPECT_EQ(bpm.GetPinCount(ids[3]), 2);
+  EXPECT_EQ(bpm.GetResidentPageCount(), ids.size());
+
+  bpm.UnpinPage(ids[0], false);
+  for (size_t i = 0; i < request.size(); i++) {
+    bpm.UnpinPage(request[i], false);
+  }
+  EXPECT_EQ(bpm.GetPinCount(ids[3]), 0);
+}
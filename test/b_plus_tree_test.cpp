@@ -0,0 +1,380 @@
+#include "../include/index/b_plus_tree.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../include/storage/disk_manager.h"
+#include "../include/storage/page_manager.h"
+#include "../include/tuple/tuple_builder.h"
+#include "../include/tuple/tuple_serializer.h"
+
+namespace fs = std::filesystem;
+
+class BPlusTreeTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    fs::create_directories("/tmp/test");
+    db_file_ = "/tmp/test/b_plus_tree_test_" +
+               std::to_string(std::chrono::system_clock::now()
+                                  .time_since_epoch()
+                                  .count()) +
+               ".idx";
+    disk_manager_ = std::make_unique<DiskManager>(db_file_);
+    bpm_ = std::make_unique<BufferPoolManager>(256, disk_manager_.get());
+  }
+
+  void TearDown() override {
+    bpm_.reset();
+    disk_manager_.reset();
+    std::remove(db_file_.c_str());
+  }
+
+  // 8-byte big-endian key, so key order is numeric order
+  static std::string Key(uint64_t value) {
+    std::string key(8, '\0');
+    for (int i = 0; i < 8; i++) {
+      key[i] = static_cast<char>(value >> (8 * (7 - i)));
+    }
+    return key;
+  }
+
+  static TupleId Tid(uint64_t value) {
+    return {static_cast<page_id_t>(value / 100 + 1),
+            static_cast<slot_id_t>(value % 100)};
+  }
+
+  static std::vector<TupleId> Scan(const BPlusTree& tree, const char* low,
+                                   const char* high) {
+    std::vector<TupleId> result;
+    BPlusTreeScan scan(&tree, low, high);
+    TupleId tid;
+    while (scan.Next(&tid)) {
+      result.push_back(tid);
+    }
+    EXPECT_EQ(scan.GetStatus().code, 0);
+    return result;
+  }
+
+  std::string db_file_;
+  std::unique_ptr<DiskManager> disk_manager_;
+  std::unique_ptr<BufferPoolManager> bpm_;
+};
+
+TEST_F(BPlusTreeTest, InsertLookupAndScanInRandomOrder) {
+  BPlusTree tree(bpm_.get(), 8, /*unique=*/true, INVALID_PAGE_ID,
+                 /*max_node_entries=*/4);
+  std::vector<uint64_t> values(2000);
+  for (size_t i = 0; i < values.size(); i++) {
+    values[i] = i * 2;  // odd keys stay absent
+  }
+  std::shuffle(values.begin(), values.end(), std::mt19937(42));
+  for (uint64_t value : values) {
+    ASSERT_EQ(tree.Insert(Key(value).data(), Tid(value)).code, 0) << value;
+  }
+  ASSERT_EQ(tree.CheckIntegrity().code, 0) << tree.CheckIntegrity().message;
+  EXPECT_GE(tree.GetHeight(), 5u);
+
+  for (uint64_t value = 0; value < 4000; value++) {
+    std::vector<TupleId> found;
+    ASSERT_EQ(tree.Lookup(Key(value).data(), &found).code, 0);
+    if (value % 2 == 0) {
+      ASSERT_EQ(found.size(), 1u) << value;
+      EXPECT_EQ(found[0], Tid(value));
+    } else {
+      EXPECT_TRUE(found.empty()) << value;
+    }
+  }
+
+  // [101, 201] holds the even keys 102..200
+  std::vector<TupleId> range =
+      Scan(tree, Key(101).data(), Key(201).data());
+  ASSERT_EQ(range.size(), 50u);
+  for (size_t i = 0; i < range.size(); i++) {
+    EXPECT_EQ(range[i], Tid(102 + 2 * i));
+  }
+  EXPECT_EQ(Scan(tree, nullptr, nullptr).size(), 2000u);
+  EXPECT_EQ(Scan(tree, Key(3990).data(), nullptr).size(), 5u);
+  EXPECT_TRUE(Scan(tree, Key(5000).data(), nullptr).empty());
+}
+
+TEST_F(BPlusTreeTest, UniqueIndexRejectsDuplicateKeys) {
+  BPlusTree tree(bpm_.get(), 8, /*unique=*/true);
+  ASSERT_EQ(tree.Insert(Key(1).data(), Tid(1)).code, 0);
+  EXPECT_NE(tree.Insert(Key(1).data(), Tid(2)).code, 0);
+
+  // Deleting needs the matching TupleId
+  EXPECT_NE(tree.Delete(Key(1).data(), Tid(2)).code, 0);
+  EXPECT_EQ(tree.Delete(Key(1).data(), Tid(1)).code, 0);
+  EXPECT_NE(tree.Delete(Key(1).data(), Tid(1)).code, 0);
+  EXPECT_EQ(tree.Insert(Key(1).data(), Tid(2)).code, 0);
+}
+
+TEST_F(BPlusTreeTest, NonUniqueIndexKeepsDuplicatesInTupleIdOrder) {
+  BPlusTree tree(bpm_.get(), 8, /*unique=*/false, INVALID_PAGE_ID, 4);
+  // 30 duplicates of key 5 span several leaves
+  for (uint64_t i = 30; i > 0; i--) {
+    ASSERT_EQ(tree.Insert(Key(5).data(), Tid(i)).code, 0);
+    ASSERT_EQ(tree.Insert(Key(i % 2 == 0 ? 4 : 6).data(), Tid(i)).code, 0);
+  }
+  EXPECT_NE(tree.Insert(Key(5).data(), Tid(7)).code, 0);
+  ASSERT_EQ(tree.CheckIntegrity().code, 0) << tree.CheckIntegrity().message;
+
+  std::vector<TupleId> found;
+  ASSERT_EQ(tree.Lookup(Key(5).data(), &found).code, 0);
+  ASSERT_EQ(found.size(), 30u);
+  for (size_t i = 0; i < found.size(); i++) {
+    EXPECT_EQ(found[i], Tid(i + 1));
+  }
+
+  ASSERT_EQ(tree.Delete(Key(5).data(), Tid(7)).code, 0);
+  found.clear();
+  ASSERT_EQ(tree.Lookup(Key(5).data(), &found).code, 0);
+  EXPECT_EQ(found.size(), 29u);
+  EXPECT_EQ(std::count(found.begin(), found.end(), Tid(7)), 0);
+}
+
+TEST_F(BPlusTreeTest, DeletesRebalanceAndFreePages) {
+  BPlusTree tree(bpm_.get(), 8, /*unique=*/true, INVALID_PAGE_ID, 4);
+  std::vector<uint64_t> values(1500);
+  for (size_t i = 0; i < values.size(); i++) {
+    values[i] = i;
+    ASSERT_EQ(tree.Insert(Key(i).data(), Tid(i)).code, 0);
+  }
+  const size_t full_height = tree.GetHeight();
+
+  std::shuffle(values.begin(), values.end(), std::mt19937(7));
+  for (size_t i = 0; i < values.size(); i++) {
+    ASSERT_EQ(tree.Delete(Key(values[i]).data(), Tid(values[i])).code, 0);
+    if (i % 100 == 0) {
+      ASSERT_EQ(tree.CheckIntegrity().code, 0)
+          << i << ": " << tree.CheckIntegrity().message;
+    }
+    if (i == values.size() / 2) {
+      // The remaining half is still reachable, in order
+      std::vector<uint64_t> rest(values.begin() + i + 1, values.end());
+      std::sort(rest.begin(), rest.end());
+      std::vector<TupleId> scanned = Scan(tree, nullptr, nullptr);
+      ASSERT_EQ(scanned.size(), rest.size());
+      for (size_t j = 0; j < rest.size(); j++) {
+        ASSERT_EQ(scanned[j], Tid(rest[j]));
+      }
+    }
+  }
+
+  EXPECT_EQ(tree.GetHeight(), 1u);
+  EXPECT_LT(tree.GetHeight(), full_height);
+  EXPECT_TRUE(Scan(tree, nullptr, nullptr).empty());
+  EXPECT_EQ(tree.CheckIntegrity().code, 0);
+  // Merged nodes went back to the file's free list
+  EXPECT_GT(disk_manager_->GetFreePageCount(), 100u);
+}
+
+TEST_F(BPlusTreeTest, BulkLoadBuildsBalancedTree) {
+  BPlusTree tree(bpm_.get(), 8, /*unique=*/false);
+  std::vector<IndexEntry> entries;
+  for (uint64_t i = 0; i < 100000; i++) {
+    entries.push_back({Key(i / 2), Tid(i)});  // two tuples per key
+  }
+  ASSERT_EQ(tree.BulkLoad(entries).code, 0);
+  ASSERT_EQ(tree.CheckIntegrity().code, 0) << tree.CheckIntegrity().message;
+  EXPECT_EQ(tree.GetHeight(), 2u);  // ~185 leaves under one root
+
+  // A cold point lookup reads one page per level
+  ASSERT_EQ(bpm_->EvictAllPages().code, 0);
+  const uint64_t misses_before = bpm_->GetMetrics().misses;
+  std::vector<TupleId> found;
+  ASSERT_EQ(tree.Lookup(Key(31337).data(), &found).code, 0);
+  ASSERT_EQ(found.size(), 2u);
+  EXPECT_EQ(found[0], Tid(62674));
+  EXPECT_EQ(found[1], Tid(62675));
+  EXPECT_LE(bpm_->GetMetrics().misses - misses_before, tree.GetHeight() + 1);
+
+  // Still writable afterwards
+  ASSERT_EQ(tree.Insert(Key(1).data(), Tid(999999)).code, 0);
+  ASSERT_EQ(tree.Delete(Key(2).data(), Tid(4)).code, 0);
+  EXPECT_EQ(tree.CheckIntegrity().code, 0);
+  EXPECT_EQ(Scan(tree, nullptr, nullptr).size(), 100000u);
+}
+
+TEST_F(BPlusTreeTest, BulkLoadSmallNodesKeepsOccupancy) {
+  for (size_t count : {1u, 4u, 5u, 9u, 17u, 333u}) {
+    BPlusTree tree(bpm_.get(), 8, /*unique=*/true, INVALID_PAGE_ID, 4);
+    std::vector<IndexEntry> entries;
+    for (uint64_t i = 0; i < count; i++) {
+      entries.push_back({Key(i), Tid(i)});
+    }
+    ASSERT_EQ(tree.BulkLoad(entries, 0.5).code, 0) << count;
+    ASSERT_EQ(tree.CheckIntegrity().code, 0)
+        << count << ": " << tree.CheckIntegrity().message;
+    EXPECT_EQ(Scan(tree, nullptr, nullptr).size(), count);
+  }
+}
+
+TEST_F(BPlusTreeTest, BulkLoadRejectsBadInput) {
+  BPlusTree tree(bpm_.get(), 8, /*unique=*/true);
+  EXPECT_NE(tree.BulkLoad({{Key(2), Tid(2)}, {Key(1), Tid(1)}}).code, 0);
+  EXPECT_NE(tree.BulkLoad({{Key(1), Tid(1)}, {Key(1), Tid(2)}}).code, 0);
+  EXPECT_NE(tree.BulkLoad({{"short", Tid(1)}}).code, 0);
+  EXPECT_NE(tree.BulkLoad({{Key(1), Tid(1)}}, 1.5).code, 0);
+
+  ASSERT_EQ(tree.Insert(Key(1).data(), Tid(1)).code, 0);
+  EXPECT_NE(tree.BulkLoad({{Key(2), Tid(2)}}).code, 0);
+}
+
+TEST_F(BPlusTreeTest, ReopensFromMetaPage) {
+  page_id_t meta_page_id;
+  {
+    BPlusTree tree(bpm_.get(), 8, /*unique=*/true, INVALID_PAGE_ID, 8);
+    for (uint64_t i = 0; i < 500; i++) {
+      ASSERT_EQ(tree.Insert(Key(i).data(), Tid(i)).code, 0);
+    }
+    meta_page_id = tree.GetMetaPageId();
+  }
+  bpm_.reset();
+  disk_manager_.reset();
+
+  disk_manager_ = std::make_unique<DiskManager>(db_file_);
+  bpm_ = std::make_unique<BufferPoolManager>(64, disk_manager_.get());
+  EXPECT_THROW(BPlusTree(bpm_.get(), 4, true, meta_page_id),
+               std::runtime_error);
+  EXPECT_THROW(BPlusTree(bpm_.get(), 8, false, meta_page_id),
+               std::runtime_error);
+
+  BPlusTree tree(bpm_.get(), 8, /*unique=*/true, meta_page_id);
+  EXPECT_EQ(tree.GetMaxLeafEntries(), 8u);
+  EXPECT_EQ(tree.CheckIntegrity().code, 0);
+  std::vector<TupleId> found;
+  ASSERT_EQ(tree.Lookup(Key(321).data(), &found).code, 0);
+  ASSERT_EQ(found.size(), 1u);
+  EXPECT_EQ(found[0], Tid(321));
+  EXPECT_EQ(Scan(tree, nullptr, nullptr).size(), 500u);
+}
+
+TEST_F(BPlusTreeTest, ConcurrentInsertsDeletesAndScans) {
+  BPlusTree tree(bpm_.get(), 8, /*unique=*/true, INVALID_PAGE_ID, 8);
+  constexpr uint64_t kThreads = 4;
+  constexpr uint64_t kPerThread = 2000;
+  std::atomic<bool> failed{false};
+
+  std::vector<std::thread> threads;
+  for (uint64_t t = 0; t < kThreads; t++) {
+    threads.emplace_back([&, t]() {
+      for (uint64_t i = 0; i < kPerThread; i++) {
+        const uint64_t value = i * kThreads + t;  // interleaved keys
+        if (tree.Insert(Key(value).data(), Tid(value)).code != 0) {
+          failed = true;
+        }
+      }
+    });
+  }
+  std::atomic<bool> done{false};
+  std::thread reader([&]() {
+    while (!done) {
+      // Whatever a scan sees must be in key order
+      uint64_t previous = 0;
+      bool first = true;
+      BPlusTreeScan scan(&tree, nullptr, nullptr);
+      TupleId tid;
+      while (scan.Next(&tid)) {
+        const uint64_t value = (tid.page_id - 1) * 100 + tid.slot_id;
+        if (!first && value <= previous) {
+          failed = true;
+        }
+        previous = value;
+        first = false;
+      }
+    }
+  });
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  ASSERT_FALSE(failed);
+  ASSERT_EQ(tree.CheckIntegrity().code, 0) << tree.CheckIntegrity().message;
+  ASSERT_EQ(Scan(tree, nullptr, nullptr).size(), kThreads * kPerThread);
+
+  // Each thread deletes its odd keys while the reader keeps scanning
+  threads.clear();
+  for (uint64_t t = 0; t < kThreads; t++) {
+    threads.emplace_back([&, t]() {
+      for (uint64_t i = 1; i < kPerThread; i += 2) {
+        const uint64_t value = i * kThreads + t;
+        if (tree.Delete(Key(value).data(), Tid(value)).code != 0) {
+          failed = true;
+        }
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  done = true;
+  reader.join();
+
+  ASSERT_FALSE(failed);
+  ASSERT_EQ(tree.CheckIntegrity().code, 0) << tree.CheckIntegrity().message;
+  std::vector<TupleId> rest = Scan(tree, nullptr, nullptr);
+  ASSERT_EQ(rest.size(), kThreads * kPerThread / 2);
+  for (TupleId tid : rest) {
+    const uint64_t value = (tid.page_id - 1) * 100 + tid.slot_id;
+    EXPECT_EQ((value / kThreads) % 2, 0u) << value;
+  }
+}
+
+TEST_F(BPlusTreeTest, IndexesTableTuplesByColumn) {
+  const std::string table_file = db_file_ + ".db";
+  const std::string fsm_file = db_file_ + ".fsm";
+  {
+    DiskManager table_dm(table_file);
+    FreeSpaceMap fsm(fsm_file);
+    PageManager pm(&table_dm, &fsm);
+
+    Schema schema;
+    schema.AddColumn("id", DataType::INTEGER, false, 0);
+    schema.AddColumn("city", DataType::VARCHAR, false, 16);
+    schema.Finalize();
+    IndexKeyEncoder encoder(schema, {"city"});
+    BPlusTree tree(bpm_.get(), encoder.GetKeySize(), /*unique=*/false);
+
+    const std::vector<std::string> cities = {"Oslo", "Lima", "Rome", "Kyiv"};
+    std::vector<char> row(128);
+    std::vector<char> key(encoder.GetKeySize());
+    for (int i = 0; i < 400; i++) {
+      TupleBuilder builder(schema);
+      const size_t size = TupleSerializer::Serialize(
+          schema,
+          builder.SetInteger("id", i).SetVarChar("city", cities[i % 4])
+              .BuildRefs(),
+          row.data(), row.size());
+      TupleId tid = pm.InsertTuple(row.data(), static_cast<uint16_t>(size));
+      ASSERT_NE(tid.slot_id, INVALID_SLOT_ID);
+
+      TupleAccessor tuple(schema, row.data(), size);
+      ASSERT_TRUE(encoder.Encode(tuple, key.data()));
+      ASSERT_EQ(tree.Insert(key.data(), tid).code, 0);
+    }
+
+    // Every match really is a Rome row
+    ASSERT_TRUE(encoder.Encode({FieldValue::VarChar("Rome")}, key.data()));
+    std::vector<TupleId> found;
+    ASSERT_EQ(tree.Lookup(key.data(), &found).code, 0);
+    ASSERT_EQ(found.size(), 100u);
+    for (TupleId tid : found) {
+      ASSERT_EQ(pm.GetTuple(tid, row.data(), row.size()).code, 0);
+      TupleAccessor tuple(schema, row.data(), row.size());
+      EXPECT_EQ(tuple.GetString("city"), "Rome");
+      EXPECT_EQ(tuple.GetInteger("id") % 4, 2);
+    }
+  }
+  std::remove(table_file.c_str());
+  std::remove(fsm_file.c_str());
+}
@@ -0,0 +1,300 @@
+#include "../include/tuple/batch_decoder.h"
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../include/tuple/tuple_accessor.h"
+#include "../include/tuple/tuple_builder.h"
+#include "../include/tuple/tuple_serializer.h"
+
+namespace {
+
+// In-memory out-of-line store
+class MapStore : public OverflowValueStore {
+ public:
+  ErrorCode Write(std::string_view value, OverflowPointer* pointer) override {
+    const uint32_t id = static_cast<uint32_t>(values_.size() + 1);
+    values_[id] = std::string(value);
+    *pointer = {id, static_cast<uint32_t>(value.size())};
+    return {0, "ok"};
+  }
+  ErrorCode Read(const OverflowPointer& pointer,
+                 std::string* value) const override {
+    auto it = values_.find(pointer.first_page_id);
+    if (it == values_.end()) {
+      return {-1, "missing"};
+    }
+    *value = it->second;
+    return {0, "ok"};
+  }
+  ErrorCode Free(const OverflowPointer& pointer) override {
+    values_.erase(pointer.first_page_id);
+    return {0, "ok"};
+  }
+
+ private:
+  std::map<uint32_t, std::string> values_;
+};
+
+}  // namespace
+
+class BatchDecoderTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    schema_.AddColumn("id", DataType::BIGINT, false, 0);
+    schema_.AddColumn("name", DataType::VARCHAR, true, 4000);
+    schema_.AddColumn("score", DataType::DOUBLE, true, 0);
+    schema_.AddColumn("flag", DataType::BOOLEAN, false, 0);
+    schema_.AddColumn("code", DataType::CHAR, true, 5);
+    schema_.AddColumn("count", DataType::INTEGER, true, 0);
+    schema_.Finalize();
+  }
+
+  // Row i: name NULL every 5th row, score every 3rd, code every 4th
+  void AddRows(int begin, int end, OverflowValueStore* overflow = nullptr) {
+    for (int i = begin; i < end; i++) {
+      TupleBuilder builder(schema_);
+      builder.SetBigInt("id", i * 1000003LL).SetBoolean("flag", i % 2 == 1);
+      builder.SetInteger("count", -i);
+      if (i % 5 == 0) {
+        builder.SetNull("name");
+      } else {
+        builder.SetVarChar("name", Name(i));
+      }
+      if (i % 3 == 0) {
+        builder.SetNull("score");
+      } else {
+        builder.SetDouble("score", i * 0.25);
+      }
+      if (i % 4 == 0) {
+        builder.SetNull("code");
+      } else {
+        builder.SetChar("code", std::string(i % 5 + 1, 'c'));
+      }
+      std::vector<char> buffer(4096);
+      buffer.resize(TupleSerializer::Serialize(schema_, builder.BuildRefs(),
+                                               buffer.data(), buffer.size(),
+                                               overflow));
+      rows_.push_back(buffer);
+    }
+  }
+
+  static std::string Name(int i) {
+    std::string name = "user-" + std::to_string(i);
+    if (i % 50 == 1) {
+      name.resize(OVERFLOW_VALUE_THRESHOLD + 100, 'n');  // out of line
+    }
+    return name;
+  }
+
+  std::vector<TupleSlice> Slices() const {
+    std::vector<TupleSlice> slices;
+    for (const std::vector<char>& row : rows_) {
+      slices.push_back({row.data(), static_cast<uint16_t>(row.size())});
+    }
+    return slices;
+  }
+
+  // Every projected value of the batch matches TupleAccessor's decoding
+  void ExpectMatchesAccessor(const ColumnBatch& batch,
+                             const std::vector<size_t>& projection,
+                             const OverflowValueStore* overflow) const {
+    ASSERT_EQ(batch.GetRowCount(), rows_.size());
+    ASSERT_EQ(batch.GetColumnCount(), projection.size());
+    for (size_t r = 0; r < rows_.size(); r++) {
+      TupleAccessor tuple(schema_, rows_[r].data(), rows_[r].size(), overflow);
+      for (size_t c = 0; c < projection.size(); c++) {
+        const size_t field = projection[c];
+        const ColumnVector& column = batch.GetColumn(c);
+        ASSERT_EQ(column.GetRowCount(), rows_.size());
+        ASSERT_EQ(column.IsValid(r), !tuple.IsNull(field)) << r << "," << c;
+        if (tuple.IsNull(field)) {
+          continue;
+        }
+        switch (schema_.GetColumnRef(field).GetDataType()) {
+          case DataType::BIGINT:
+            EXPECT_EQ(column.Data<int64_t>()[r], tuple.GetBigInt(field));
+            break;
+          case DataType::INTEGER:
+            EXPECT_EQ(column.Data<int32_t>()[r], tuple.GetInteger(field));
+            break;
+          case DataType::DOUBLE:
+            EXPECT_EQ(column.Data<double>()[r], tuple.GetDouble(field));
+            break;
+          case DataType::BOOLEAN:
+            EXPECT_EQ(column.Data<bool>()[r], tuple.GetBoolean(field));
+            break;
+          default:
+            EXPECT_EQ(column.GetString(r), tuple.GetStringView(field));
+            break;
+        }
+      }
+    }
+  }
+
+  Schema schema_;
+  std::vector<std::vector<char>> rows_;
+};
+
+TEST_F(BatchDecoderTest, DecodesProjectedColumnsLikeTupleAccessor) {
+  MapStore store;
+  AddRows(0, 300, &store);
+  const std::vector<size_t> projection = {4, 0, 2, 1, 3, 5};
+  BatchDecoder decoder(schema_, projection, &store);
+  ColumnBatch batch;
+  decoder.Decode(Slices(), &batch);
+  ExpectMatchesAccessor(batch, projection, &store);
+
+  // Validity and null counts
+  const ColumnVector& score = batch.GetColumn(2);
+  EXPECT_EQ(score.GetNullCount(), 100u);
+  EXPECT_EQ(score.GetValidity()[0] & 0xF, 0b0110u);
+  EXPECT_EQ(score.Data<double>()[0], 0.0);
+  EXPECT_EQ(batch.GetColumn(1).GetNullCount(), 0u);
+  const ColumnVector& name = batch.GetColumn(3);
+  EXPECT_EQ(name.GetNullCount(), 60u);
+  EXPECT_EQ(name.GetOffsets()[0], name.GetOffsets()[1]);  // row 0 is NULL
+  EXPECT_EQ(name.GetString(1).size(), OVERFLOW_VALUE_THRESHOLD + 100);
+  EXPECT_EQ(name.GetWidth(), 0u);
+  EXPECT_EQ(batch.GetColumn(0).GetWidth(), 5u);
+}
+
+TEST_F(BatchDecoderTest, AppendsAcrossCallsAndClearKeepsColumns) {
+  AddRows(2, 150);  // without a store, long names stay inline
+  std::vector<TupleSlice> slices = Slices();
+  const std::vector<size_t> projection = {5, 1};
+  BatchDecoder decoder(schema_, projection);
+  ColumnBatch batch;
+  decoder.Decode(slices.data(), 70, &batch);
+  decoder.Decode(slices.data() + 70, slices.size() - 70, &batch);
+  ExpectMatchesAccessor(batch, projection, nullptr);
+
+  batch.Clear();
+  EXPECT_EQ(batch.GetRowCount(), 0u);
+  EXPECT_EQ(batch.GetColumnCount(), 2u);
+  decoder.Decode(slices, &batch);
+  ExpectMatchesAccessor(batch, projection, nullptr);
+
+  // A batch laid out for another projection is rejected
+  BatchDecoder other(schema_, {0});
+  EXPECT_THROW(other.Decode(slices, &batch), std::invalid_argument);
+}
+
+TEST_F(BatchDecoderTest, FailedDecodeLeavesEarlierRows) {
+  AddRows(0, 10);
+  std::vector<TupleSlice> slices = Slices();
+  BatchDecoder decoder(schema_, {0, 1});
+  ColumnBatch batch;
+  decoder.Decode(slices.data(), 10, &batch);
+
+  // Truncated name
+  std::vector<char> broken = rows_[3];
+  broken.resize(broken.size() - 2);
+  std::vector<TupleSlice> bad = {slices[1],
+                                 {broken.data(),
+                                  static_cast<uint16_t>(broken.size())}};
+  EXPECT_THROW(decoder.Decode(bad, &batch), std::runtime_error);
+  EXPECT_EQ(batch.GetRowCount(), 10u);
+  EXPECT_EQ(batch.GetColumn(0).GetRowCount(), 10u);
+  EXPECT_EQ(batch.GetColumn(1).GetRowCount(), 10u);
+  EXPECT_EQ(batch.GetColumn(1).GetNullCount(), 2u);
+
+  // Out-of-line value without a store
+  MapStore store;
+  rows_.clear();
+  AddRows(1, 2, &store);
+  EXPECT_THROW(decoder.Decode(Slices(), &batch), std::runtime_error);
+  EXPECT_EQ(batch.GetColumn(1).GetRowCount(), 10u);
+
+  std::vector<char> tiny(4);
+  EXPECT_THROW(decoder.Decode({{tiny.data(), 4}}, &batch),
+               std::runtime_error);
+  EXPECT_THROW(BatchDecoder(schema_, {6}), std::invalid_argument);
+}
+
+TEST_F(BatchDecoderTest, FixedLengthSchema) {
+  Schema fixed;
+  fixed.AddColumn("a", DataType::SMALLINT, false, 0);
+  fixed.AddColumn("b", DataType::FLOAT, true, 0);
+  fixed.AddColumn("c", DataType::TINYINT, false, 0);
+  fixed.Finalize();
+
+  std::vector<std::vector<char>> rows;
+  std::vector<TupleSlice> slices;
+  for (int i = 0; i < 130; i++) {
+    TupleBuilder builder(fixed);
+    builder.SetSmallInt("a", static_cast<int16_t>(i * 7));
+    builder.SetTinyInt("c", static_cast<int8_t>(i));
+    if (i == 128) {
+      builder.SetNull("b");
+    } else {
+      builder.SetFloat("b", i * 1.5f);
+    }
+    rows.emplace_back(fixed.GetFixedSectionEnd());
+    TupleSerializer::Serialize(fixed, builder.BuildRefs(), rows.back().data(),
+                               rows.back().size());
+  }
+  for (const std::vector<char>& row : rows) {
+    slices.push_back({row.data(), static_cast<uint16_t>(row.size())});
+  }
+
+  BatchDecoder decoder(fixed, {0, 1, 2});
+  ColumnBatch batch;
+  decoder.Decode(slices, &batch);
+  for (int i = 0; i < 130; i++) {
+    EXPECT_EQ(batch.GetColumn(0).Data<int16_t>()[i], i * 7);
+    EXPECT_EQ(batch.GetColumn(2).Data<int8_t>()[i], static_cast<int8_t>(i));
+    if (i != 128) {
+      EXPECT_EQ(batch.GetColumn(1).Data<float>()[i], i * 1.5f);
+    }
+  }
+  const ColumnVector& b = batch.GetColumn(1);
+  EXPECT_EQ(b.GetValidity()[0], ~uint64_t{0});
+  EXPECT_EQ(b.GetValidity()[2], 0b10u);  // rows 128 (NULL) and 129
+  EXPECT_EQ(b.GetNullCount(), 1u);
+}
+
+TEST(BatchDecoderDictionaryTest, DecodesEncodedColumnsToStrings) {
+  Schema schema;
+  schema.AddColumn("status", DataType::VARCHAR, true, 16,
+                   ColumnEncoding::DICTIONARY);
+  schema.AddColumn("country", DataType::CHAR, false, 4,
+                   ColumnEncoding::DICTIONARY);
+  schema.Finalize();
+
+  const char* statuses[] = {"new", "paid", "shipped"};
+  std::vector<std::vector<char>> rows;
+  std::vector<TupleSlice> slices;
+  for (int i = 0; i < 70; i++) {
+    std::vector<FieldValue> values = {
+        i == 65 ? FieldValue::Null(DataType::VARCHAR)
+                : FieldValue::VarChar(statuses[i % 3]),
+        FieldValue::Char(i % 2 == 0 ? "DE" : "FR")};
+    rows.emplace_back(64);
+    rows.back().resize(TupleSerializer::SerializeVariableLength(
+        schema, values, rows.back().data(), rows.back().size()));
+  }
+  for (const std::vector<char>& row : rows) {
+    slices.push_back({row.data(), static_cast<uint16_t>(row.size())});
+  }
+
+  BatchDecoder decoder(schema, {0, 1});
+  ColumnBatch batch;
+  decoder.Decode(slices, &batch);
+  const ColumnVector& status = batch.GetColumn(0);
+  const ColumnVector& country = batch.GetColumn(1);
+  EXPECT_EQ(status.GetWidth(), 0u);
+  EXPECT_EQ(country.GetWidth(), 0u);
+  EXPECT_EQ(status.GetNullCount(), 1u);
+  for (int i = 0; i < 70; i++) {
+    EXPECT_EQ(status.IsValid(i), i != 65);
+    if (i != 65) {
+      EXPECT_EQ(status.GetString(i), statuses[i % 3]);
+    }
+    EXPECT_EQ(country.GetString(i), i % 2 == 0 ? "DE" : "FR");
+  }
+}
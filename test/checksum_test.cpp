@@ -88,3 +88,70 @@ TEST(ChecksumTest, Consistency) {
     EXPECT_EQ(result_crc, first_crc) << "Inconsistent CRC on iteration " << i;
   }
 }
+
+// ============================================================================
+// CRC32C Tests
+// ============================================================================
+
+TEST(ChecksumTest, Crc32cKnownValues) {
+  struct TestCase {
+    std::string input;
+    uint32_t expected_crc;
+  };
+
+  // CRC32C (Castagnoli) check values
+  std::vector<TestCase> test_cases = {
+      {"", 0x00000000},
+      {"a", 0xC1D04330},
+      {"abc", 0x364B3FB7},
+      {"123456789", 0xE3069283},
+      {"The quick brown fox jumps over the lazy dog", 0x22620404}};
+
+  for (const auto& test_case : test_cases) {
+    uint32_t result_crc = checksum::Compute(
+        checksum::Algorithm::CRC32C,
+        reinterpret_cast<const uint8_t*>(test_case.input.c_str()),
+        test_case.input.size());
+    EXPECT_EQ(result_crc, test_case.expected_crc)
+        << "CRC32C mismatch for input: '" << test_case.input << "' using "
+        << checksum::Crc32cImplementation();
+  }
+
+  // 32 zero bytes exercises the 8-byte loop on every implementation
+  std::vector<uint8_t> zeros(32, 0);
+  EXPECT_EQ(checksum::Compute(checksum::Algorithm::CRC32C, zeros.data(),
+                              zeros.size()),
+            0x8A9136AA);
+}
+
+// Dispatched implementation must agree with slicing-by-8 for every length and
+// start alignment
+TEST(ChecksumTest, Crc32cDispatchMatchesPortable) {
+  std::vector<uint8_t> data(8192 + 16);
+  for (size_t i = 0; i < data.size(); i++) {
+    data[i] = static_cast<uint8_t>(i * 131 + 7);
+  }
+
+  for (size_t offset = 0; offset < 8; offset++) {
+    for (size_t length : {0, 1, 3, 7, 8, 9, 15, 64, 1000, 8192}) {
+      uint32_t dispatched = checksum::Update(checksum::Algorithm::CRC32C,
+                                             checksum::Init(),
+                                             data.data() + offset, length);
+      uint32_t portable = checksum::UpdateCrc32cPortable(
+          checksum::Init(), data.data() + offset, length);
+      EXPECT_EQ(dispatched, portable)
+          << "offset " << offset << " length " << length;
+    }
+  }
+}
+
+TEST(ChecksumTest, Crc32cIncrementalMatchesOneShot) {
+  const std::string input = "The quick brown fox jumps over the lazy dog";
+  const auto* bytes = reinterpret_cast<const uint8_t*>(input.c_str());
+
+  uint32_t crc = checksum::Init();
+  crc = checksum::Update(checksum::Algorithm::CRC32C, crc, bytes, 10);
+  crc = checksum::Update(checksum::Algorithm::CRC32C, crc, bytes + 10,
+                         input.size() - 10);
+  EXPECT_EQ(checksum::Finalize(crc), 0x22620404);
+}
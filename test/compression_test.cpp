@@ -0,0 +1,341 @@
+#include "../include/common/compression.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../include/storage/log_manager.h"
+#include "../include/storage/page_manager.h"
+#include "../include/storage/table_scan.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// JSON-ish rows that share most of their bytes, like one table's rows
+std::string Row(int i) {
+  return "{\"id\":" + std::to_string(i) + ",\"status\":\"" +
+         (i % 3 == 0 ? "active" : "suspended") +
+         "\",\"country\":\"NZ\",\"plan\":\"enterprise-annual\","
+         "\"email\":\"user" +
+         std::to_string(i * 7919 % 100000) + "@example.com\"}";
+}
+
+std::string RoundTrip(const TupleCompressor& compressor,
+                      const std::string& stored) {
+  char out[PAGE_SIZE];
+  uint16_t size = 0;
+  ErrorCode result =
+      compressor.Decompress(stored.data(), static_cast<uint16_t>(stored.size()),
+                            out, sizeof(out), &size);
+  EXPECT_EQ(result.code, 0) << result.message;
+  return std::string(out, size);
+}
+
+std::string Compress(const TupleCompressor& compressor,
+                     const std::string& tuple) {
+  char out[PAGE_SIZE];
+  const uint16_t size =
+      compressor.Compress(tuple.data(), static_cast<uint16_t>(tuple.size()),
+                          out, sizeof(out));
+  return std::string(out, size);
+}
+
+}  // namespace
+
+TEST(TupleCompressorTest, RoundTripsRepetitiveData) {
+  TupleCompressor compressor;
+  std::string tuple;
+  for (int i = 0; i < 100; i++) {
+    tuple += "abcdefgh" + std::to_string(i % 7);
+  }
+
+  const std::string stored = Compress(compressor, tuple);
+  ASSERT_FALSE(stored.empty());
+  EXPECT_LT(stored.size(), tuple.size() / 4);
+  EXPECT_EQ(TupleCompressor::RawSize(stored.data(),
+                                     static_cast<uint16_t>(stored.size())),
+            tuple.size());
+  EXPECT_EQ(RoundTrip(compressor, stored), tuple);
+
+  // Long single-byte runs use overlapping matches
+  const std::string run(4000, 'z');
+  EXPECT_EQ(RoundTrip(compressor, Compress(compressor, run)), run);
+}
+
+TEST(TupleCompressorTest, OnlyCompressesWhenSmaller) {
+  TupleCompressor compressor;
+  std::mt19937 rng(7);
+  std::string noise(500, '\0');
+  for (char& c : noise) {
+    c = static_cast<char>(rng());
+  }
+  EXPECT_TRUE(Compress(compressor, noise).empty());
+  EXPECT_TRUE(Compress(compressor, "short tuple").empty());
+
+  // Compresses to 15 bytes, which does not fit in 12
+  char out[12];
+  const std::string tuple(200, 'a');
+  EXPECT_EQ(compressor.Compress(tuple.data(), 200, out, sizeof(out)), 0);
+}
+
+TEST(TupleCompressorTest, DictionaryCompressesShortRows) {
+  std::vector<std::string> samples;
+  for (int i = 0; i < 200; i++) {
+    samples.push_back(Row(i));
+  }
+  const std::string dictionary = TupleCompressor::TrainDictionary(samples);
+  ASSERT_FALSE(dictionary.empty());
+  EXPECT_LE(dictionary.size(), DEFAULT_COMPRESSION_DICTIONARY_SIZE);
+
+  TupleCompressor plain;
+  TupleCompressor trained(dictionary);
+  EXPECT_NE(trained.GetDictionaryId(), 0);
+
+  size_t raw = 0;
+  size_t plain_total = 0;
+  size_t trained_total = 0;
+  for (int i = 1000; i < 1100; i++) {
+    const std::string row = Row(i);
+    const std::string with_plain = Compress(plain, row);
+    const std::string with_dictionary = Compress(trained, row);
+    ASSERT_FALSE(with_dictionary.empty()) << row;
+    EXPECT_EQ(RoundTrip(trained, with_dictionary), row);
+    raw += row.size();
+    plain_total += with_plain.empty() ? row.size() : with_plain.size();
+    trained_total += with_dictionary.size();
+  }
+  EXPECT_LT(trained_total * 2, raw);
+  EXPECT_LT(trained_total, plain_total);
+}
+
+TEST(TupleCompressorTest, RejectsWrongDictionaryAndCorruptInput) {
+  std::vector<std::string> samples;
+  for (int i = 0; i < 50; i++) {
+    samples.push_back(Row(i));
+  }
+  TupleCompressor trained(TupleCompressor::TrainDictionary(samples));
+  TupleCompressor other(std::string(256, 'q'));
+  TupleCompressor plain;
+  const std::string stored = Compress(trained, Row(500));
+  ASSERT_FALSE(stored.empty());
+
+  char out[PAGE_SIZE];
+  uint16_t size = 0;
+  const uint16_t stored_size = static_cast<uint16_t>(stored.size());
+  EXPECT_EQ(other.Decompress(stored.data(), stored_size, out, sizeof(out),
+                             &size)
+                .code,
+            -2);
+  EXPECT_EQ(plain.Decompress(stored.data(), stored_size, out, sizeof(out),
+                             &size)
+                .code,
+            -2);
+  EXPECT_EQ(trained.Decompress(stored.data(), stored_size, out, 10, &size).code,
+            -3);
+  EXPECT_EQ(trained.Decompress(stored.data(), stored_size - 3, out,
+                               sizeof(out), &size)
+                .code,
+            -1);
+
+  // Garbage never reads or writes out of bounds
+  std::mt19937 rng(3);
+  for (int trial = 0; trial < 1000; trial++) {
+    std::string garbage = stored;
+    garbage[COMPRESSED_TUPLE_HEADER_SIZE + rng() % (garbage.size() - 4)] =
+        static_cast<char>(rng());
+    trained.Decompress(garbage.data(), stored_size, out, sizeof(out), &size);
+  }
+
+  EXPECT_THROW(
+      TupleCompressor(std::string(MAX_COMPRESSION_DICTIONARY_SIZE + 1, 'x')),
+      std::invalid_argument);
+}
+
+class CompressedTableTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    fs::create_directories("/tmp/test");
+    base_ = "/tmp/test/compression_test_" +
+            std::to_string(
+                std::chrono::system_clock::now().time_since_epoch().count());
+    std::vector<std::string> samples;
+    for (int i = 0; i < 200; i++) {
+      samples.push_back(Row(i));
+    }
+    compressor_ = std::make_unique<TupleCompressor>(
+        TupleCompressor::TrainDictionary(samples));
+  }
+
+  void TearDown() override {
+    for (const char* suffix : {".db", ".fsm", ".wal", "_plain.db",
+                               "_plain.fsm", "_crash.db", "_crash.fsm",
+                               "_crash.wal"}) {
+      std::remove((base_ + suffix).c_str());
+    }
+  }
+
+  static std::string ReadTuple(const PageManager& pm, TupleId tid) {
+    char buffer[PAGE_SIZE];
+    if (pm.GetTuple(tid, buffer, sizeof(buffer)).code != 0) {
+      return "<missing>";
+    }
+    return buffer;
+  }
+
+  std::string base_;
+  std::unique_ptr<TupleCompressor> compressor_;
+};
+
+TEST_F(CompressedTableTest, ReadsAreTransparentAndPagesHoldMore) {
+  std::vector<TupleId> tids;
+  size_t compressed_pages = 0;
+  {
+    DiskManager disk_manager(base_ + ".db");
+    FreeSpaceMap fsm(base_ + ".fsm");
+    PageManager pm(&disk_manager, &fsm);
+    pm.SetTupleCompressor(compressor_.get());
+
+    for (int i = 0; i < 500; i++) {
+      const std::string row = Row(i);
+      tids.push_back(
+          pm.InsertTuple(row.data(), static_cast<uint16_t>(row.size())));
+    }
+    std::vector<std::string> rows;
+    std::vector<TupleSlice> batch;
+    for (int i = 500; i < 1000; i++) {
+      rows.push_back(Row(i));
+    }
+    for (const std::string& row : rows) {
+      batch.push_back({row.data(), static_cast<uint16_t>(row.size())});
+    }
+    for (TupleId tid : pm.InsertTuples(batch)) {
+      tids.push_back(tid);
+    }
+    // Too short to compress: stored as is
+    tids.push_back(pm.InsertTuple("tiny", 4));
+
+    for (int i = 0; i < 1000; i++) {
+      ASSERT_EQ(ReadTuple(pm, tids[i]), Row(i)) << i;
+    }
+    EXPECT_EQ(ReadTuple(pm, tids.back()), "tiny");
+
+    PageGuard page = PageGuard(pm.GetBufferPool(), tids[0].page_id,
+                               pm.GetBufferPool()->FetchPage(tids[0].page_id),
+                               LatchMode::SHARED);
+    ASSERT_TRUE(page);
+    EXPECT_TRUE(page->IsSlotCompressed(tids[0].slot_id));
+    page.Release();
+
+    PinnedTuple view;
+    ASSERT_EQ(pm.GetTupleView(tids[1], &view).code, 0);
+    EXPECT_EQ(std::string(view.Data(), view.Size()), Row(1));
+    view.Release();
+
+    char small[8];
+    EXPECT_EQ(pm.GetTuple(tids[0], small, sizeof(small)).code, -3);
+
+    TableScan scan(&pm);
+    TupleView tuple;
+    size_t scanned = 0;
+    while (scan.Next(&tuple)) {
+      if (tuple.tuple_id == tids.back()) {
+        EXPECT_EQ(std::string(tuple.data, tuple.size), "tiny");
+      } else {
+        EXPECT_EQ(std::string(tuple.data, tuple.size).substr(0, 6),
+                  "{\"id\":");
+      }
+      scanned++;
+    }
+    EXPECT_EQ(scanned, tids.size());
+    compressed_pages = scan.GetPagesScanned();
+  }
+
+  DiskManager disk_manager(base_ + "_plain.db");
+  FreeSpaceMap fsm(base_ + "_plain.fsm");
+  PageManager pm(&disk_manager, &fsm);
+  for (int i = 0; i < 1000; i++) {
+    const std::string row = Row(i);
+    pm.InsertTuple(row.data(), static_cast<uint16_t>(row.size()));
+  }
+  EXPECT_LT(compressed_pages * 3, (disk_manager.GetNextPageId() - 1) * 2);
+}
+
+TEST_F(CompressedTableTest, UpdatesSwitchBetweenForms) {
+  DiskManager disk_manager(base_ + ".db");
+  FreeSpaceMap fsm(base_ + ".fsm");
+  PageManager pm(&disk_manager, &fsm);
+  pm.SetTupleCompressor(compressor_.get());
+
+  const std::string row = Row(1);
+  const TupleId tid =
+      pm.InsertTuple(row.data(), static_cast<uint16_t>(row.size()));
+
+  // Incompressible in place, compressible again, then a forwarding move
+  ASSERT_EQ(pm.UpdateTuple(tid, "plain", 5).code, 0);
+  EXPECT_EQ(ReadTuple(pm, tid), "plain");
+  ASSERT_EQ(pm.UpdateTuple(tid, row.data(), row.size()).code, 0);
+  EXPECT_EQ(ReadTuple(pm, tid), row);
+
+  std::string filler(1000, 'f');
+  for (char& c : filler) {
+    c = static_cast<char>('a' + (&c - filler.data()) * 7919 % 26);
+  }
+  while (pm.InsertTuple(filler.data(), 1000).page_id == tid.page_id) {
+  }
+  std::string large;
+  for (int i = 0; i < 40; i++) {
+    large += Row(i);
+  }
+  ASSERT_EQ(pm.UpdateTuple(tid, large.data(), large.size()).code, 0);
+  EXPECT_EQ(ReadTuple(pm, tid), large);
+
+  // Without the dictionary the tuple cannot be read, but is not garbled
+  pm.SetTupleCompressor(nullptr);
+  char buffer[PAGE_SIZE];
+  EXPECT_EQ(pm.GetTuple(tid, buffer, sizeof(buffer)).code, -4);
+  PinnedTuple view;
+  EXPECT_EQ(pm.GetTupleView(tid, &view).code, -5);
+}
+
+TEST_F(CompressedTableTest, RecoveryReplaysCompressedRecords) {
+  std::vector<TupleId> tids;
+  {
+    DiskManager disk_manager(base_ + ".db", DurabilityMode::BATCHED);
+    FreeSpaceMap fsm(base_ + ".fsm");
+    LogManager log(base_ + ".wal");
+    PageManager pm(&disk_manager, &fsm, 1, ReplacerType::LRU_K, &log);
+    pm.SetTupleCompressor(compressor_.get());
+
+    for (int i = 0; i < 100; i++) {
+      const std::string row = Row(i);
+      tids.push_back(
+          pm.InsertTuple(row.data(), static_cast<uint16_t>(row.size())));
+    }
+    const std::string updated = Row(12345);
+    ASSERT_EQ(pm.UpdateTuple(tids[5], updated.data(), updated.size()).code, 0);
+    ASSERT_EQ(pm.UpdateTuple(tids[6], "plain", 5).code, 0);
+
+    for (const char* suffix : {".wal", ".db", ".fsm"}) {
+      fs::copy_file(base_ + suffix, base_ + "_crash" + suffix,
+                    fs::copy_options::overwrite_existing);
+    }
+  }
+
+  DiskManager disk_manager(base_ + "_crash.db", DurabilityMode::BATCHED);
+  FreeSpaceMap fsm(base_ + "_crash.fsm");
+  LogManager log(base_ + "_crash.wal");
+  PageManager pm(&disk_manager, &fsm, 1, ReplacerType::LRU_K, &log);
+  pm.SetTupleCompressor(compressor_.get());
+  for (int i = 0; i < 100; i++) {
+    const std::string expected =
+        i == 5 ? Row(12345) : i == 6 ? std::string("plain") : Row(i);
+    EXPECT_EQ(ReadTuple(pm, tids[i]), expected) << i;
+  }
+}
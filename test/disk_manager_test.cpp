@@ -4,10 +4,17 @@
 
 #include <cstring>
 #include <filesystem>
+#include <fstream>
+#include <random>
 #include <thread>
 #include <vector>
 
+#include "../include/common/checksum.h"
 #include "../include/page/page.h"
+#include "../include/schema/schema.h"
+#include "../include/storage/page_snapshot.h"
+#include "../include/tuple/tuple_accessor.h"
+#include "../include/tuple/tuple_serializer.h"
 
 namespace fs = std::filesystem;
 
@@ -27,6 +34,10 @@ class DiskManagerTest : public ::testing::Test {
     if (fs::exists(test_db_file_)) {
       fs::remove(test_db_file_);
     }
+    fs::remove(test_db_file_ + ".pmap");
+    fs::remove(test_db_file_ + ".tsp");
+    fs::remove(test_db_file_ + ".s1");
+    fs::remove(test_db_file_ + ".s2");
   }
 
   uint64_t GetTestId() {
@@ -217,6 +228,85 @@ TEST_F(DiskManagerTest, DeallocatePage) {
   EXPECT_NO_THROW(disk_manager.DeallocatePage(page_id));
 }
 
+// Test: A deallocated page is handed out again before the file grows
+TEST_F(DiskManagerTest, DeallocatedPageIsReused) {
+  DiskManager disk_manager(test_db_file_, DurabilityMode::BATCHED);
+  auto page = Page::CreateNew();
+  for (int i = 0; i < 3; i++) {
+    page_id_t page_id = disk_manager.AllocatePage();
+    page->SetPageId(page_id);
+    disk_manager.WritePage(page_id, page->GetRawBuffer());
+  }
+
+  disk_manager.DeallocatePage(2);
+  disk_manager.DeallocatePage(2);  // already free: ignored
+  EXPECT_EQ(disk_manager.GetFreePageCount(), 1u);
+  EXPECT_THROW(disk_manager.DeallocatePage(INVALID_PAGE_ID),
+               std::invalid_argument);
+  EXPECT_THROW(disk_manager.DeallocatePage(100), std::invalid_argument);
+
+  // A freed page reads as an empty free page
+  disk_manager.ReadPage(2, page->GetRawBuffer());
+  EXPECT_EQ(page->GetPageType(), PAGE_TYPE_FREE);
+  EXPECT_EQ(page->GetSlotCount(), 0);
+
+  EXPECT_EQ(disk_manager.AllocatePage(), 2u);
+  EXPECT_EQ(disk_manager.GetFreePageCount(), 0u);
+  EXPECT_EQ(disk_manager.AllocatePage(), 4u);
+}
+
+// Test: The free list survives a reopen
+TEST_F(DiskManagerTest, FreeListPersists) {
+  {
+    DiskManager disk_manager(test_db_file_, DurabilityMode::BATCHED);
+    auto page = Page::CreateNew();
+    for (int i = 0; i < 4; i++) {
+      page_id_t page_id = disk_manager.AllocatePage();
+      page->SetPageId(page_id);
+      disk_manager.WritePage(page_id, page->GetRawBuffer());
+    }
+    disk_manager.DeallocatePage(1);
+    disk_manager.DeallocatePage(3);
+  }
+
+  DiskManager disk_manager(test_db_file_, DurabilityMode::BATCHED);
+  EXPECT_EQ(disk_manager.GetFreePageCount(), 2u);
+  EXPECT_EQ(disk_manager.AllocatePage(), 3u);  // most recently freed first
+  EXPECT_EQ(disk_manager.AllocatePage(), 1u);
+  EXPECT_EQ(disk_manager.AllocatePage(), 5u);
+}
+
+// Test: Free pages at the end of the file are given back
+TEST_F(DiskManagerTest, TruncateFreeTailShrinksFile) {
+  {
+    DiskManager disk_manager(test_db_file_, DurabilityMode::BATCHED);
+    auto page = Page::CreateNew();
+    for (int i = 0; i < 6; i++) {
+      page_id_t page_id = disk_manager.AllocatePage();
+      page->SetPageId(page_id);
+      disk_manager.WritePage(page_id, page->GetRawBuffer());
+    }
+    disk_manager.DeallocatePage(2);
+    disk_manager.DeallocatePage(6);
+    disk_manager.DeallocatePage(5);
+    disk_manager.DeallocatePage(3);
+    EXPECT_EQ(fs::file_size(test_db_file_), 7 * PAGE_SIZE);
+
+    EXPECT_EQ(disk_manager.TruncateFreeTail(), 2u);
+    EXPECT_EQ(disk_manager.TruncateFreeTail(), 0u);
+    EXPECT_EQ(disk_manager.GetNextPageId(), 5u);
+    EXPECT_EQ(disk_manager.GetFreePageCount(), 2u);
+    EXPECT_EQ(fs::file_size(test_db_file_), 5 * PAGE_SIZE);
+  }
+
+  // Remaining free pages come back lowest first
+  DiskManager disk_manager(test_db_file_, DurabilityMode::BATCHED);
+  EXPECT_EQ(disk_manager.GetNextPageId(), 5u);
+  EXPECT_EQ(disk_manager.AllocatePage(), 2u);
+  EXPECT_EQ(disk_manager.AllocatePage(), 3u);
+  EXPECT_EQ(disk_manager.AllocatePage(), 5u);
+}
+
 // Test: Write nullptr should throw
 TEST_F(DiskManagerTest, WriteNullptrThrows) {
   DiskManager disk_manager(test_db_file_);
@@ -471,3 +561,1143 @@ TEST_F(DiskManagerTest, NextPageIdPersistence) {
     EXPECT_EQ(page_id, 4);  // Should continue from where we left off
   }
 }
+
+// ============================================================================
+// Durability Mode Tests
+// ============================================================================
+
+TEST_F(DiskManagerTest, ImmediateModeSyncsEveryWrite) {
+  DiskManager disk_manager(test_db_file_);
+  EXPECT_EQ(disk_manager.GetDurabilityMode(), DurabilityMode::IMMEDIATE);
+
+  char buffer[PAGE_SIZE];
+  memset(buffer, 0, PAGE_SIZE);
+  for (int i = 0; i < 5; i++) {
+    disk_manager.WritePage(disk_manager.AllocatePage(), buffer);
+  }
+  EXPECT_EQ(disk_manager.GetSyncCount(), 5);
+
+  // Deferred writes share one sync
+  for (int i = 0; i < 5; i++) {
+    disk_manager.WritePage(disk_manager.AllocatePage(), buffer, true);
+  }
+  EXPECT_EQ(disk_manager.GetSyncCount(), 5);
+  disk_manager.Sync();
+  EXPECT_EQ(disk_manager.GetSyncCount(), 6);
+}
+
+TEST_F(DiskManagerTest, BatchedModeSyncsOnlyOnRequest) {
+  DiskManager disk_manager(test_db_file_, DurabilityMode::BATCHED);
+
+  char buffer[PAGE_SIZE];
+  memset(buffer, 0, PAGE_SIZE);
+  for (int i = 0; i < 10; i++) {
+    disk_manager.WritePage(disk_manager.AllocatePage(), buffer);
+  }
+  EXPECT_EQ(disk_manager.GetSyncCount(), 0);
+
+  disk_manager.Sync();
+  EXPECT_EQ(disk_manager.GetSyncCount(), 1);
+
+  // Nothing pending: Sync() is a no-op
+  disk_manager.Sync();
+  EXPECT_EQ(disk_manager.GetSyncCount(), 1);
+}
+
+TEST_F(DiskManagerTest, PeriodicModeSyncsInBackground) {
+  DiskManager disk_manager(test_db_file_, DurabilityMode::PERIODIC, 10);
+
+  char buffer[PAGE_SIZE];
+  memset(buffer, 0, PAGE_SIZE);
+  disk_manager.WritePage(disk_manager.AllocatePage(), buffer);
+
+  for (int i = 0; i < 100 && disk_manager.GetSyncCount() == 0; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_GE(disk_manager.GetSyncCount(), 1);
+}
+
+TEST_F(DiskManagerTest, PeriodicModeRejectsZeroInterval) {
+  EXPECT_THROW(DiskManager(test_db_file_, DurabilityMode::PERIODIC, 0),
+               std::invalid_argument);
+}
+
+// ============================================================================
+// Direct I/O Tests
+// ============================================================================
+
+TEST_F(DiskManagerTest, DirectIORoundTrip) {
+  page_id_t page_id;
+  {
+    DiskManager disk_manager(test_db_file_, DurabilityMode::IMMEDIATE,
+                             DEFAULT_SYNC_INTERVAL_MS, IOEngineType::AUTO,
+                             true);
+    page_id = disk_manager.AllocatePage();
+
+    // Page buffers are PAGE_SIZE aligned, so they take the O_DIRECT path
+    auto page = Page::CreateNew();
+    page->SetPageId(page_id);
+    const char* data = "direct";
+    ASSERT_NE(page->InsertTuple(data, strlen(data)), INVALID_SLOT_ID);
+    disk_manager.WritePage(page_id, page->GetRawBuffer());
+
+    // An unaligned buffer is served through the buffered descriptor
+    std::vector<char> storage(PAGE_SIZE + 1);
+    char* unaligned = storage.data() + 1;
+    disk_manager.ReadPage(page_id, unaligned);
+    EXPECT_EQ(memcmp(unaligned, page->GetRawBuffer(), PAGE_SIZE), 0);
+  }
+
+  // Reopen (buffered) and read back what the direct write persisted
+  DiskManager disk_manager(test_db_file_);
+  EXPECT_FALSE(disk_manager.IsDirectIO());
+  auto page = Page::CreateNew();
+  disk_manager.ReadPage(page_id, page->GetRawBuffer());
+  SlotEntry entry = page->GetSlotEntry(0);
+  EXPECT_EQ(std::string(page->GetRawBuffer() + entry.offset, entry.length),
+            "direct");
+}
+
+TEST_F(DiskManagerTest, DirectIOAlignedLayout) {
+  DiskManager disk_manager(test_db_file_, DurabilityMode::BATCHED,
+                           DEFAULT_SYNC_INTERVAL_MS, IOEngineType::AUTO, true);
+
+  // Page 0 holds the file header in the aligned layout
+  char buffer[PAGE_SIZE];
+  memset(buffer, 0, PAGE_SIZE);
+  EXPECT_THROW(disk_manager.WritePage(INVALID_PAGE_ID, buffer),
+               std::invalid_argument);
+
+  page_id_t page_id = disk_manager.AllocatePage();
+  disk_manager.WritePage(page_id, buffer);
+  EXPECT_EQ(fs::file_size(test_db_file_), (page_id + 1) * PAGE_SIZE);
+}
+
+TEST_F(DiskManagerTest, DirectIOFallsBackOnLegacyLayout) {
+  // Header written right before page data, as files created before the
+  // aligned layout were: magic, version 1, next_page_id 1, no flags
+  {
+    std::vector<char> header(1024, 0);
+    memcpy(header.data(), "STOR", 4);
+    uint32_t version = 1;
+    uint32_t next_page_id = 1;
+    memcpy(header.data() + 4, &version, sizeof(version));
+    memcpy(header.data() + 8, &next_page_id, sizeof(next_page_id));
+    FILE* file = fopen(test_db_file_.c_str(), "wb");
+    ASSERT_NE(file, nullptr);
+    fwrite(header.data(), 1, header.size(), file);
+    fclose(file);
+  }
+
+  DiskManager disk_manager(test_db_file_, DurabilityMode::IMMEDIATE,
+                           DEFAULT_SYNC_INTERVAL_MS, IOEngineType::AUTO, true);
+  EXPECT_FALSE(disk_manager.IsDirectIO());
+
+  // Still fully usable through the page cache
+  auto page = Page::CreateNew();
+  page_id_t page_id = disk_manager.AllocatePage();
+  page->SetPageId(page_id);
+  disk_manager.WritePage(page_id, page->GetRawBuffer());
+  EXPECT_NO_THROW(disk_manager.ReadPage(page_id, page->GetRawBuffer()));
+}
+
+TEST_F(DiskManagerTest, UpgradesV1FileOnOpen) {
+  page_id_t page_id;
+  {
+    DiskManager disk_manager(test_db_file_);
+    EXPECT_EQ(disk_manager.GetFormatVersion(),
+              DiskManager::FILE_FORMAT_VERSION);
+    page_id = disk_manager.AllocatePage();
+  }
+
+  // A version 1 page (data from byte 40): slot 0 forwarded to slot 1
+  // through next_ptr, slot 2 deleted
+  auto page = Page::CreateNew();
+  page->SetFreeStart(40);
+  ASSERT_NE(page->InsertTuple("old", 3), INVALID_SLOT_ID);
+  ASSERT_NE(page->InsertTuple("moved", 5), INVALID_SLOT_ID);
+  ASSERT_NE(page->InsertTuple("gone", 4), INVALID_SLOT_ID);
+  page->MarkSlotDeleted(2);
+  SlotEntry& forwarded = page->GetSlotEntry(0);
+  forwarded.flags |= SLOT_FORWARDED;
+  forwarded.length = 0;
+  forwarded.next_ptr[0] = static_cast<uint8_t>(page_id & 0xFF);
+  forwarded.next_ptr[1] = static_cast<uint8_t>(page_id >> 8);
+  forwarded.next_ptr[2] = 1;
+
+  char* buffer = page->GetRawBuffer();
+  const PageHeader current = *GetHeaderFromBuffer(buffer);
+  std::memset(buffer, 0, 40);
+  const uint16_t v1_fields[5] = {static_cast<uint16_t>(page_id),
+                                 current.slot_id, current.free_start,
+                                 current.free_end, current.slot_count};
+  std::memcpy(buffer, v1_fields, sizeof(v1_fields));
+  buffer[10] = static_cast<char>(current.page_type);
+  buffer[11] = static_cast<char>(PAGE_FLAG_CRC32C);
+  uint32_t crc = checksum::Init();
+  crc = checksum::Update(checksum::Algorithm::CRC32C, crc,
+                         reinterpret_cast<const uint8_t*>(buffer), 16);
+  crc = checksum::Update(checksum::Algorithm::CRC32C, crc,
+                         reinterpret_cast<const uint8_t*>(buffer) + 40,
+                         PAGE_SIZE - 40);
+  const uint32_t v1_checksum = checksum::Finalize(crc);
+  std::memcpy(buffer + 12, &v1_checksum, sizeof(v1_checksum));
+
+  {
+    FILE* file = fopen(test_db_file_.c_str(), "r+b");
+    ASSERT_NE(file, nullptr);
+    fseek(file, static_cast<long>(page_id * PAGE_SIZE), SEEK_SET);
+    fwrite(buffer, 1, PAGE_SIZE, file);
+    const uint32_t version = 1;
+    fseek(file, 4, SEEK_SET);
+    fwrite(&version, sizeof(version), 1, file);
+    fclose(file);
+  }
+
+  for (int open = 0; open < 2; open++) {
+    DiskManager disk_manager(test_db_file_);
+    EXPECT_EQ(disk_manager.GetFormatVersion(),
+              DiskManager::FILE_FORMAT_VERSION);
+
+    auto reloaded = Page::CreateNew();
+    ASSERT_NO_THROW(
+        disk_manager.ReadPage(page_id, reloaded->GetRawBuffer()));
+    EXPECT_EQ(reloaded->GetPageId(), page_id);
+    EXPECT_EQ(reloaded->GetSlotCount(), 3);
+    EXPECT_EQ(reloaded->GetDeletedTupleCount(), 1);
+    EXPECT_EQ(reloaded->GetFragmentedBytes(), 4);
+    TupleId target = reloaded->FollowForwardingChain(0);
+    EXPECT_EQ(target.page_id, page_id);
+    EXPECT_EQ(target.slot_id, 1);
+    SlotEntry entry = reloaded->GetSlotEntry(1);
+    EXPECT_EQ(std::string(reloaded->GetRawBuffer() + entry.offset,
+                          entry.length),
+              "moved");
+  }
+}
+
+TEST_F(DiskManagerTest, UpgradesV3FileOnOpen) {
+  page_id_t roomy_id, full_id;
+  {
+    DiskManager disk_manager(test_db_file_);
+    roomy_id = disk_manager.AllocatePage();
+    full_id = disk_manager.AllocatePage();
+  }
+
+  // Rewrite a current page in the 24-byte version 3 layout
+  auto write_v3 = [&](Page* page, page_id_t page_id, size_t extend_last) {
+    char* buffer = page->GetRawBuffer();
+    const size_t shift = sizeof(PageHeader) - 24;
+    std::memmove(buffer + 24, buffer + sizeof(PageHeader),
+                 page->GetFreeStart() - sizeof(PageHeader));
+    for (slot_id_t i = 0; i < page->GetSlotCount(); i++) {
+      page->GetSlotEntry(i).offset -= shift;
+    }
+    page->SetFreeStart(page->GetFreeStart() - shift);
+    // Use the 8 bytes a version 3 page had to spare
+    if (extend_last > 0) {
+      SlotEntry& last = page->GetSlotEntry(page->GetSlotCount() - 1);
+      std::memset(buffer + last.offset + last.length, 'x', extend_last);
+      last.length += extend_last;
+      page->SetFreeStart(page->GetFreeStart() + extend_last);
+    }
+    page->SetPageId(page_id);
+    page->SetFlags(PAGE_FLAG_CRC32C);
+    page->SetChecksum(page->ComputeChecksum());
+
+    FILE* file = fopen(test_db_file_.c_str(), "r+b");
+    ASSERT_NE(file, nullptr);
+    fseek(file, static_cast<long>(page_id * PAGE_SIZE), SEEK_SET);
+    fwrite(buffer, 1, PAGE_SIZE, file);
+    fclose(file);
+  };
+
+  auto roomy = Page::CreateNew();
+  ASSERT_NE(roomy->InsertTuple("small", 5), INVALID_SLOT_ID);
+  write_v3(roomy.get(), roomy_id, 0);
+
+  // Fill the page so the version 3 layout has no free byte left
+  auto full = Page::CreateNew();
+  const std::string filler(100, 'f');
+  while (full->InsertTuple(filler.data(), filler.size()) != INVALID_SLOT_ID) {
+  }
+  const size_t tail_size =
+      full->GetFreeEnd() - full->GetFreeStart() - SLOT_ENTRY_SIZE;
+  const std::string tail(tail_size, 't');
+  ASSERT_NE(full->InsertTuple(tail.data(), tail.size()), INVALID_SLOT_ID);
+  ASSERT_EQ(full->GetFreeEnd(), full->GetFreeStart());
+  const slot_id_t last_slot = full->GetSlotCount() - 1;
+  write_v3(full.get(), full_id, sizeof(PageHeader) - 24);
+
+  {
+    FILE* file = fopen(test_db_file_.c_str(), "r+b");
+    ASSERT_NE(file, nullptr);
+    const uint32_t version = 3;
+    fseek(file, 4, SEEK_SET);
+    fwrite(&version, sizeof(version), 1, file);
+    fclose(file);
+  }
+
+  for (int open = 0; open < 2; open++) {
+    DiskManager disk_manager(test_db_file_);
+    EXPECT_EQ(disk_manager.GetFormatVersion(),
+              DiskManager::FILE_FORMAT_VERSION);
+    EXPECT_EQ(disk_manager.GetNextPageId(), full_id + 2);
+
+    auto reloaded = Page::CreateNew();
+    ASSERT_NO_THROW(
+        disk_manager.ReadPage(roomy_id, reloaded->GetRawBuffer()));
+    EXPECT_EQ(reloaded->GetPageLsn(), INVALID_LSN);
+    SlotEntry entry = reloaded->GetSlotEntry(0);
+    EXPECT_EQ(entry.offset, sizeof(PageHeader));
+    EXPECT_EQ(std::string(reloaded->GetRawBuffer() + entry.offset,
+                          entry.length),
+              "small");
+
+    // The last tuple moved to an overflow page behind a forwarding stub
+    ASSERT_NO_THROW(disk_manager.ReadPage(full_id, reloaded->GetRawBuffer()));
+    entry = reloaded->GetSlotEntry(0);
+    EXPECT_EQ(std::string(reloaded->GetRawBuffer() + entry.offset,
+                          entry.length),
+              filler);
+    TupleId target = reloaded->FollowForwardingChain(last_slot);
+    EXPECT_EQ(target.page_id, full_id + 1);
+
+    auto overflow = Page::CreateNew();
+    ASSERT_NO_THROW(
+        disk_manager.ReadPage(target.page_id, overflow->GetRawBuffer()));
+    entry = overflow->GetSlotEntry(target.slot_id);
+    EXPECT_EQ(std::string(overflow->GetRawBuffer() + entry.offset,
+                          entry.length),
+              tail + std::string(sizeof(PageHeader) - 24, 'x'));
+  }
+}
+
+TEST_F(DiskManagerTest, SlotStatisticsPersistAcrossReads) {
+  DiskManager disk_manager(test_db_file_);
+  page_id_t page_id = disk_manager.AllocatePage();
+
+  auto page = Page::CreateNew();
+  page->SetPageId(page_id);
+  ASSERT_NE(page->InsertTuple("keep", 4), INVALID_SLOT_ID);
+  slot_id_t doomed = page->InsertTuple("delete me", 9);
+  ASSERT_NE(doomed, INVALID_SLOT_ID);
+  ASSERT_EQ(page->DeleteTuple(doomed).code, 0);
+  disk_manager.WritePage(page_id, page->GetRawBuffer());
+
+  // Read into a fresh frame: the counters come straight from the header
+  auto reloaded = Page::CreateNew();
+  disk_manager.ReadPage(page_id, reloaded->GetRawBuffer());
+  EXPECT_EQ(reloaded->GetDeletedTupleCount(), 1);
+  EXPECT_EQ(reloaded->GetFragmentedBytes(), 9);
+  EXPECT_EQ(memcmp(reloaded->GetRawBuffer(), page->GetRawBuffer(),
+                   sizeof(PageHeader)),
+            0);
+}
+
+TEST_F(DiskManagerTest, AllocatePagesReservesContiguousRange) {
+  DiskManager disk_manager(test_db_file_);
+  const page_id_t first = disk_manager.AllocatePages(10);
+  EXPECT_NE(first, INVALID_PAGE_ID);
+  EXPECT_EQ(disk_manager.AllocatePage(), first + 10);
+  EXPECT_THROW(disk_manager.AllocatePages(0), std::invalid_argument);
+}
+
+TEST_F(DiskManagerTest, WritePagesVectoredRoundTrip) {
+  const size_t count = 5;
+  page_id_t first;
+  {
+    DiskManager disk_manager(test_db_file_, DurabilityMode::BATCHED);
+    first = disk_manager.AllocatePages(count);
+
+    std::vector<std::unique_ptr<Page>> pages;
+    std::vector<const char*> buffers;
+    for (size_t i = 0; i < count; i++) {
+      pages.push_back(Page::CreateNew());
+      pages.back()->SetPageId(first + i);
+      const std::string data = "vectored-" + std::to_string(i);
+      ASSERT_NE(pages.back()->InsertTuple(data.c_str(), data.size()),
+                INVALID_SLOT_ID);
+      buffers.push_back(pages.back()->GetRawBuffer());
+    }
+
+    const uint64_t syncs_before = disk_manager.GetSyncCount();
+    disk_manager.WritePages(first, buffers, /*defer_sync=*/true);
+    EXPECT_EQ(disk_manager.GetSyncCount(), syncs_before);
+    disk_manager.Sync();
+  }
+
+  // Every page landed at its own offset with a valid checksum
+  DiskManager disk_manager(test_db_file_);
+  for (size_t i = 0; i < count; i++) {
+    auto page = Page::CreateNew();
+    disk_manager.ReadPage(first + i, page->GetRawBuffer());
+    SlotEntry entry = page->GetSlotEntry(0);
+    EXPECT_EQ(std::string(page->GetRawBuffer() + entry.offset, entry.length),
+              "vectored-" + std::to_string(i));
+  }
+}
+
+TEST_F(DiskManagerTest, ReadOnlyViewsPointIntoMapping) {
+  const size_t count = 3;
+  page_id_t first;
+  {
+    DiskManager disk_manager(test_db_file_, DurabilityMode::BATCHED);
+    first = disk_manager.AllocatePages(count);
+    for (size_t i = 0; i < count; i++) {
+      auto page = Page::CreateNew();
+      page->SetPageId(first + i);
+      const std::string data = "mapped-" + std::to_string(i);
+      ASSERT_NE(page->InsertTuple(data.c_str(), data.size()), INVALID_SLOT_ID);
+      disk_manager.WritePage(first + i, page->GetRawBuffer(), true);
+    }
+    disk_manager.Sync();
+    EXPECT_THROW(disk_manager.GetPageView(first), std::runtime_error);
+  }
+
+  auto disk_manager =
+      DiskManager::OpenReadOnly(test_db_file_, AccessPattern::SEQUENTIAL);
+  EXPECT_TRUE(disk_manager->IsReadOnly());
+  EXPECT_EQ(disk_manager->GetNextPageId(), first + count);
+  for (size_t i = 0; i < count; i++) {
+    PageView view = disk_manager->GetPageView(first + i);
+    EXPECT_EQ(view.GetPageId(), first + i);
+    EXPECT_EQ(view.GetSlotCount(), 1);
+
+    // The same bytes again, not a copy
+    EXPECT_EQ(disk_manager->GetPageView(first + i).GetRawBuffer(),
+              view.GetRawBuffer());
+
+    auto page = Page::CreateNew();
+    disk_manager->ReadPage(first + i, page->GetRawBuffer());
+    SlotEntry entry = page->GetSlotEntry(0);
+    EXPECT_EQ(std::string(page->GetRawBuffer() + entry.offset, entry.length),
+              "mapped-" + std::to_string(i));
+  }
+  disk_manager->AdviseAccess(AccessPattern::RANDOM);
+  EXPECT_THROW(disk_manager->GetPageView(first + count),
+               std::invalid_argument);
+}
+
+TEST_F(DiskManagerTest, ReadOnlyRejectsWrites) {
+  page_id_t page_id;
+  {
+    DiskManager disk_manager(test_db_file_);
+    page_id = disk_manager.AllocatePage();
+    auto page = Page::CreateNew();
+    page->SetPageId(page_id);
+    disk_manager.WritePage(page_id, page->GetRawBuffer());
+  }
+
+  auto disk_manager = DiskManager::OpenReadOnly(test_db_file_);
+  auto page = Page::CreateNew();
+  page->SetPageId(page_id);
+  EXPECT_THROW(disk_manager->WritePage(page_id, page->GetRawBuffer()),
+               std::runtime_error);
+  EXPECT_THROW(disk_manager->AllocatePage(), std::runtime_error);
+  EXPECT_THROW(disk_manager->SyncFileHeader(), std::runtime_error);
+  disk_manager.reset();
+
+  EXPECT_THROW(DiskManager::OpenReadOnly(test_db_file_ + ".missing"),
+               std::runtime_error);
+}
+
+TEST_F(DiskManagerTest, ReadOnlyVerifiesChecksumOnFirstAccess) {
+  page_id_t good;
+  page_id_t bad;
+  {
+    DiskManager disk_manager(test_db_file_);
+    good = disk_manager.AllocatePage();
+    bad = disk_manager.AllocatePage();
+    for (page_id_t page_id : {good, bad}) {
+      auto page = Page::CreateNew();
+      page->SetPageId(page_id);
+      disk_manager.WritePage(page_id, page->GetRawBuffer());
+    }
+  }
+
+  // Flip a byte in the second page's data area
+  {
+    FILE* file = fopen(test_db_file_.c_str(), "r+b");
+    ASSERT_NE(file, nullptr);
+    fseek(file, static_cast<long>(bad * PAGE_SIZE + PAGE_SIZE / 2), SEEK_SET);
+    fputc(0x5A, file);
+    fclose(file);
+  }
+
+  // Opening touches no page, so the damage only surfaces on access
+  auto disk_manager = DiskManager::OpenReadOnly(test_db_file_);
+  EXPECT_EQ(disk_manager->GetPageView(good).GetPageId(), good);
+  EXPECT_THROW(disk_manager->GetPageView(bad), std::runtime_error);
+  EXPECT_THROW(disk_manager->GetPageView(bad), std::runtime_error);
+}
+
+namespace {
+
+// A page of repetitive rows, which compresses well below 4 KB
+std::unique_ptr<Page> CompressiblePage(page_id_t page_id) {
+  auto page = Page::CreateNew();
+  page->SetPageId(page_id);
+  for (int i = 0; i < 60; i++) {
+    const std::string row = "row-" + std::to_string(page_id) + "-" +
+                            std::to_string(i) + ":status=active;plan=basic";
+    page->InsertTuple(row.c_str(), static_cast<uint16_t>(row.size()));
+  }
+  return page;
+}
+
+// A page of random bytes, which does not compress
+std::unique_ptr<Page> NoisePage(page_id_t page_id) {
+  auto page = Page::CreateNew();
+  page->SetPageId(page_id);
+  std::mt19937 rng(page_id);
+  std::string noise(6000, '\0');
+  for (char& c : noise) {
+    c = static_cast<char>(rng());
+  }
+  page->InsertTuple(noise.data(), static_cast<uint16_t>(noise.size()));
+  return page;
+}
+
+std::string FirstTuple(const Page& page) {
+  const SlotEntry entry = page.GetSlotEntry(0);
+  return std::string(page.GetRawBuffer() + entry.offset, entry.length);
+}
+
+}  // namespace
+
+TEST_F(DiskManagerTest, CompressedPagesRoundTripInHalfTheSpace) {
+  const size_t count = 64;
+  page_id_t first;
+  std::vector<std::string> expected;
+  {
+    DiskManager disk_manager(test_db_file_, DurabilityMode::BATCHED,
+                             DEFAULT_SYNC_INTERVAL_MS, IOEngineType::AUTO,
+                             /*use_direct_io=*/false,
+                             /*compress_pages=*/true);
+    EXPECT_TRUE(disk_manager.IsPageCompressed());
+    first = disk_manager.AllocatePages(count);
+    std::vector<std::unique_ptr<Page>> pages;
+    std::vector<const char*> buffers;
+    for (size_t i = 0; i < count; i++) {
+      const page_id_t page_id = first + static_cast<page_id_t>(i);
+      pages.push_back(i % 16 == 15 ? NoisePage(page_id)
+                                   : CompressiblePage(page_id));
+      expected.push_back(FirstTuple(*pages.back()));
+      buffers.push_back(pages.back()->GetRawBuffer());
+    }
+    disk_manager.WritePages(first, buffers, /*defer_sync=*/true);
+    disk_manager.Sync();
+
+    // 60 one-block pages, 4 two-block pages
+    EXPECT_EQ(disk_manager.GetStoredPageBytes(),
+              (60 + 4 * 2) * PAGE_EXTENT_BLOCK_SIZE);
+  }
+  EXPECT_LT(fs::file_size(test_db_file_), (count + 1) * PAGE_SIZE * 6 / 10);
+
+  // The mode comes from the file, not the constructor
+  DiskManager disk_manager(test_db_file_);
+  ASSERT_TRUE(disk_manager.IsPageCompressed());
+  std::vector<std::unique_ptr<Page>> pages;
+  std::vector<page_id_t> page_ids;
+  std::vector<char*> buffers;
+  for (size_t i = 0; i < count; i++) {
+    auto page = Page::CreateNew();
+    disk_manager.ReadPage(first + static_cast<page_id_t>(i),
+                          page->GetRawBuffer());
+    EXPECT_EQ(FirstTuple(*page), expected[i]) << i;
+
+    pages.push_back(Page::CreateNew());
+    page_ids.push_back(first + static_cast<page_id_t>(i));
+    buffers.push_back(pages.back()->GetRawBuffer());
+  }
+
+  std::vector<IOHandle> handles =
+      disk_manager.ReadPagesAsync(page_ids, buffers);
+  for (size_t i = 0; i < count; i++) {
+    ASSERT_EQ(handles[i].Wait().code, 0) << handles[i].Wait().message;
+    EXPECT_EQ(FirstTuple(*pages[i]), expected[i]) << i;
+  }
+
+  auto never_written = Page::CreateNew();
+  EXPECT_THROW(disk_manager.ReadPage(disk_manager.AllocatePage(),
+                                     never_written->GetRawBuffer()),
+               std::runtime_error);
+  EXPECT_THROW(DiskManager::OpenReadOnly(test_db_file_), std::runtime_error);
+}
+
+TEST_F(DiskManagerTest, CompressedPageMovesReuseBlocksAfterSync) {
+  DiskManager disk_manager(test_db_file_, DurabilityMode::BATCHED,
+                           DEFAULT_SYNC_INTERVAL_MS, IOEngineType::AUTO, false,
+                           /*compress_pages=*/true);
+  const page_id_t page_id = disk_manager.AllocatePage();
+  disk_manager.WritePage(page_id, CompressiblePage(page_id)->GetRawBuffer());
+  disk_manager.Sync();
+  EXPECT_EQ(disk_manager.GetStoredPageBytes(), PAGE_EXTENT_BLOCK_SIZE);
+
+  // Growing moves the page; its old block stays reserved until the map no
+  // longer lists it durably
+  auto noise = NoisePage(page_id);
+  disk_manager.WritePage(page_id, noise->GetRawBuffer());
+  EXPECT_EQ(disk_manager.GetStoredPageBytes(), 3 * PAGE_EXTENT_BLOCK_SIZE);
+  disk_manager.Sync();
+  EXPECT_EQ(disk_manager.GetStoredPageBytes(), 2 * PAGE_EXTENT_BLOCK_SIZE);
+
+  // Same size: in place. Then the freed block is reused.
+  disk_manager.WritePage(page_id, noise->GetRawBuffer());
+  const page_id_t other = disk_manager.AllocatePage();
+  disk_manager.WritePageAsync(other, CompressiblePage(other)->GetRawBuffer())
+      .Wait();
+  disk_manager.Sync();
+  EXPECT_EQ(disk_manager.GetStoredPageBytes(), 3 * PAGE_EXTENT_BLOCK_SIZE);
+  EXPECT_EQ(fs::file_size(test_db_file_),
+            PAGE_SIZE + 3 * PAGE_EXTENT_BLOCK_SIZE);
+
+  auto page = Page::CreateNew();
+  disk_manager.ReadPage(page_id, page->GetRawBuffer());
+  EXPECT_EQ(FirstTuple(*page), FirstTuple(*noise));
+  disk_manager.ReadPage(other, page->GetRawBuffer());
+  EXPECT_EQ(FirstTuple(*page), FirstTuple(*CompressiblePage(other)));
+}
+
+TEST_F(DiskManagerTest, CompressedFileFreeListAndTruncate) {
+  DiskManager disk_manager(test_db_file_, DurabilityMode::BATCHED,
+                           DEFAULT_SYNC_INTERVAL_MS, IOEngineType::AUTO, false,
+                           /*compress_pages=*/true);
+  std::vector<page_id_t> page_ids;
+  for (int i = 0; i < 4; i++) {
+    page_ids.push_back(disk_manager.AllocatePage());
+    disk_manager.WritePage(page_ids.back(),
+                           NoisePage(page_ids.back())->GetRawBuffer());
+  }
+  disk_manager.Sync();
+
+  disk_manager.DeallocatePage(page_ids[1]);
+  EXPECT_EQ(disk_manager.AllocatePage(), page_ids[1]);
+  disk_manager.DeallocatePage(page_ids[1]);
+  disk_manager.DeallocatePage(page_ids[3]);
+  disk_manager.DeallocatePage(page_ids[2]);
+  disk_manager.Sync();
+  const uintmax_t size_before = fs::file_size(test_db_file_);
+  EXPECT_EQ(disk_manager.TruncateFreeTail(), 2u);
+  EXPECT_EQ(disk_manager.GetNextPageId(), page_ids[2]);
+
+  // Pages 0 and 1 remain: a two-block page and a one-block free page
+  EXPECT_EQ(disk_manager.GetStoredPageBytes(), 3 * PAGE_EXTENT_BLOCK_SIZE);
+  EXPECT_LE(fs::file_size(test_db_file_), size_before);
+  auto page = Page::CreateNew();
+  disk_manager.ReadPage(page_ids[0], page->GetRawBuffer());
+  EXPECT_EQ(FirstTuple(*page), FirstTuple(*NoisePage(page_ids[0])));
+}
+
+namespace {
+
+// Page id stored in the page-sized slot at local page local_page of file
+page_id_t StoredPageId(const std::string& file, size_t local_page) {
+  std::ifstream in(file, std::ios::binary);
+  in.seekg(static_cast<std::streamoff>(local_page * PAGE_SIZE));
+  PageHeader header{};
+  in.read(reinterpret_cast<char*>(&header), sizeof(header));
+  return in ? header.page_id : INVALID_PAGE_ID;
+}
+
+}  // namespace
+
+TEST_F(DiskManagerTest, StripedPagesSpreadOverFiles) {
+  // Extents of 4: ids 0-3 in file 0, 4-7 in file 1, 8-11 in file 2, ...
+  TablespaceLayout layout{{test_db_file_ + ".s1", test_db_file_ + ".s2"}, 4};
+  const size_t count = 24;
+  page_id_t first;
+  {
+    DiskManager disk_manager(test_db_file_, DurabilityMode::BATCHED,
+                             DEFAULT_SYNC_INTERVAL_MS, IOEngineType::AUTO,
+                             false, false, layout);
+    EXPECT_EQ(disk_manager.GetStripeCount(), 3u);
+    first = disk_manager.AllocatePages(count);
+
+    // One vectored call crossing six extents, then single-page writes
+    std::vector<std::unique_ptr<Page>> pages;
+    std::vector<const char*> buffers;
+    for (size_t i = 0; i < count - 2; i++) {
+      pages.push_back(CompressiblePage(first + static_cast<page_id_t>(i)));
+      buffers.push_back(pages.back()->GetRawBuffer());
+    }
+    disk_manager.WritePages(first, buffers, /*defer_sync=*/true);
+    disk_manager.WritePage(23, CompressiblePage(23)->GetRawBuffer());
+    ASSERT_EQ(disk_manager
+                  .WritePageAsync(24, CompressiblePage(24)->GetRawBuffer())
+                  .Wait()
+                  .code,
+              0);
+    disk_manager.Sync();
+  }
+
+  EXPECT_EQ(StoredPageId(test_db_file_, 1), 1u);
+  EXPECT_EQ(StoredPageId(test_db_file_, 4), 12u);
+  EXPECT_EQ(StoredPageId(test_db_file_, 8), 24u);
+  EXPECT_EQ(StoredPageId(test_db_file_ + ".s1", 0), 4u);
+  EXPECT_EQ(StoredPageId(test_db_file_ + ".s1", 7), 19u);
+  EXPECT_EQ(StoredPageId(test_db_file_ + ".s2", 0), 8u);
+  EXPECT_EQ(StoredPageId(test_db_file_ + ".s2", 7), 23u);
+  EXPECT_EQ(fs::file_size(test_db_file_), 9 * PAGE_SIZE);
+  EXPECT_EQ(fs::file_size(test_db_file_ + ".s1"), 8 * PAGE_SIZE);
+  EXPECT_EQ(fs::file_size(test_db_file_ + ".s2"), 8 * PAGE_SIZE);
+
+  // The layout comes from the file, not the constructor
+  DiskManager disk_manager(test_db_file_);
+  ASSERT_EQ(disk_manager.GetStripeCount(), 3u);
+  std::vector<std::unique_ptr<Page>> pages;
+  std::vector<page_id_t> page_ids;
+  std::vector<char*> buffers;
+  for (size_t i = 0; i < count; i++) {
+    const page_id_t page_id = first + static_cast<page_id_t>(i);
+    auto page = Page::CreateNew();
+    disk_manager.ReadPage(page_id, page->GetRawBuffer());
+    EXPECT_EQ(FirstTuple(*page), FirstTuple(*CompressiblePage(page_id)));
+
+    pages.push_back(Page::CreateNew());
+    page_ids.push_back(page_id);
+    buffers.push_back(pages.back()->GetRawBuffer());
+  }
+
+  // Split over three device queues, handles still in request order
+  std::vector<IOHandle> handles =
+      disk_manager.ReadPagesAsync(page_ids, buffers);
+  ASSERT_EQ(handles.size(), count);
+  for (size_t i = 0; i < count; i++) {
+    ASSERT_EQ(handles[i].Wait().code, 0) << handles[i].Wait().message;
+    EXPECT_EQ(pages[i]->GetPageId(), page_ids[i]);
+  }
+  EXPECT_THROW(DiskManager::OpenReadOnly(test_db_file_), std::runtime_error);
+}
+
+TEST_F(DiskManagerTest, StripedFileTruncatesEveryFile) {
+  TablespaceLayout layout{{test_db_file_ + ".s1", test_db_file_ + ".s2"}, 2};
+  DiskManager disk_manager(test_db_file_, DurabilityMode::BATCHED,
+                           DEFAULT_SYNC_INTERVAL_MS, IOEngineType::AUTO,
+                           /*use_direct_io=*/true, false, layout);
+  for (int i = 0; i < 11; i++) {
+    const page_id_t page_id = disk_manager.AllocatePage();
+    disk_manager.WritePage(page_id, CompressiblePage(page_id)->GetRawBuffer());
+  }
+  for (page_id_t page_id = 11; page_id >= 5; page_id--) {
+    disk_manager.DeallocatePage(page_id);
+  }
+
+  // Ids 0-4 remain: file 0 keeps 0-1, file 1 keeps 2-3, file 2 keeps 4
+  EXPECT_EQ(disk_manager.TruncateFreeTail(), 7u);
+  EXPECT_EQ(disk_manager.GetNextPageId(), 5u);
+  EXPECT_EQ(fs::file_size(test_db_file_), 2 * PAGE_SIZE);
+  EXPECT_EQ(fs::file_size(test_db_file_ + ".s1"), 2 * PAGE_SIZE);
+  EXPECT_EQ(fs::file_size(test_db_file_ + ".s2"), 1 * PAGE_SIZE);
+
+  auto page = Page::CreateNew();
+  disk_manager.ReadPage(4, page->GetRawBuffer());
+  EXPECT_EQ(FirstTuple(*page), FirstTuple(*CompressiblePage(4)));
+}
+
+TEST_F(DiskManagerTest, StripedLayoutRejectsCompressedPages) {
+  TablespaceLayout layout{{test_db_file_ + ".s1"}};
+  EXPECT_THROW(DiskManager(test_db_file_, DurabilityMode::BATCHED,
+                           DEFAULT_SYNC_INTERVAL_MS, IOEngineType::AUTO, false,
+                           /*compress_pages=*/true, layout),
+               std::invalid_argument);
+  EXPECT_FALSE(fs::exists(test_db_file_));
+
+  // A zero extent size leaves no half-created file behind either
+  layout.extent_pages = 0;
+  EXPECT_THROW(DiskManager(test_db_file_, DurabilityMode::BATCHED,
+                           DEFAULT_SYNC_INTERVAL_MS, IOEngineType::AUTO,
+                           false, false, layout),
+               std::invalid_argument);
+  EXPECT_FALSE(fs::exists(test_db_file_));
+}
+
+TEST_F(DiskManagerTest, TrustedWritesSkipChecksumOnReadBack) {
+  std::vector<char> page(PAGE_SIZE, 0);
+  page_id_t trusted, untrusted;
+  {
+    DiskManager disk_manager(test_db_file_);
+    trusted = disk_manager.AllocatePage();
+    untrusted = disk_manager.AllocatePage();
+    disk_manager.WritePage(untrusted, page.data());
+    disk_manager.SetTrustWrittenPages(true);
+    disk_manager.WritePage(trusted, page.data());
+
+    // Corrupt both on disk behind the DiskManager's back
+    for (page_id_t page_id : {trusted, untrusted}) {
+      std::fstream file(test_db_file_,
+                        std::ios::in | std::ios::out | std::ios::binary);
+      file.seekp(static_cast<std::streamoff>(page_id) * PAGE_SIZE + 1000);
+      file.put(0x5A);
+    }
+
+    // Only the page written while trusting is read back unverified
+    disk_manager.ReadPage(trusted, page.data());
+    EXPECT_THROW(disk_manager.ReadPage(untrusted, page.data()),
+                 std::runtime_error);
+    ASSERT_EQ(disk_manager.ReadPageAsync(trusted, page.data()).Wait().code, 0);
+    const DiskMetrics metrics = disk_manager.GetMetrics();
+    EXPECT_EQ(metrics.checksum_skips, 2u);
+    EXPECT_EQ(metrics.checksum_failures, 1u);
+  }
+
+  // A new DiskManager trusts nothing it did not write itself
+  DiskManager disk_manager(test_db_file_);
+  disk_manager.SetTrustWrittenPages(true);
+  EXPECT_THROW(disk_manager.ReadPage(trusted, page.data()), std::runtime_error);
+  EXPECT_EQ(disk_manager.GetMetrics().checksum_skips, 0u);
+}
+
+TEST_F(DiskManagerTest, PageBitmapSpansChunks) {
+  PageBitmap bitmap;
+  const page_id_t ids[] = {0, 63, 64, PageBitmap::CHUNK_PAGES - 1,
+                           PageBitmap::CHUNK_PAGES, UINT32_MAX};
+  for (page_id_t page_id : ids) {
+    EXPECT_FALSE(bitmap.Test(page_id));
+    bitmap.Set(page_id);
+  }
+  for (page_id_t page_id : ids) {
+    EXPECT_TRUE(bitmap.Test(page_id));
+  }
+  EXPECT_FALSE(bitmap.Test(1));
+  EXPECT_FALSE(bitmap.Test(PageBitmap::CHUNK_PAGES + 1));
+
+  bitmap.Clear(64);
+  bitmap.Clear(12345678);  // chunk never allocated
+  EXPECT_FALSE(bitmap.Test(64));
+  EXPECT_TRUE(bitmap.Test(63));
+}
+
+TEST_F(DiskManagerTest, SchemaDataSurvivesReopen) {
+  auto make_schema = [](Schema* schema) {
+    schema->AddColumn("id", DataType::INTEGER, false, 0);
+    schema->AddColumn("status", DataType::VARCHAR, false, 16,
+                      ColumnEncoding::DICTIONARY);
+    schema->Finalize();
+  };
+  std::vector<char> tuple(64);
+  std::vector<char> page(PAGE_SIZE);
+  page_id_t page_id;
+  {
+    DiskManager disk_manager(test_db_file_);
+    EXPECT_EQ(disk_manager.ReadSchemaData(), "");
+    EXPECT_GT(disk_manager.GetSchemaCapacity(), PAGE_SIZE / 2);
+    page_id = disk_manager.AllocatePage();
+    PageHeader* header = GetHeaderFromBuffer(page.data());
+    header->page_id = page_id;
+    header->free_start = sizeof(PageHeader);
+    header->free_end = PAGE_SIZE;
+    std::memset(page.data() + 100, 0x33, 500);
+    disk_manager.WritePage(page_id, page.data());
+
+    Schema schema;
+    make_schema(&schema);
+    TupleSerializer::SerializeVariableLength(
+        schema, {FieldValue::Integer(1), FieldValue::VarChar("paid")},
+        tuple.data(), tuple.size());
+    TupleSerializer::SerializeVariableLength(
+        schema, {FieldValue::Integer(2), FieldValue::VarChar("shipped")},
+        tuple.data(), tuple.size());
+
+    std::string data = disk_manager.ReadSchemaData();
+    schema.AppendDictionaryEntries(&data);
+    disk_manager.WriteSchemaData(data);
+    EXPECT_EQ(disk_manager.ReadSchemaData(), data);
+
+    EXPECT_THROW(disk_manager.WriteSchemaData(
+                     std::string(disk_manager.GetSchemaCapacity() + 1, 'x')),
+                 std::invalid_argument);
+  }
+
+  // The schema area stays within the header's slot
+  DiskManager disk_manager(test_db_file_);
+  std::vector<char> read_back(PAGE_SIZE);
+  disk_manager.ReadPage(page_id, read_back.data());
+  EXPECT_EQ(std::memcmp(read_back.data() + 100, page.data() + 100, 500), 0);
+
+  Schema schema;
+  make_schema(&schema);
+  schema.LoadDictionaries(disk_manager.ReadSchemaData());
+  TupleAccessor accessor(schema, tuple.data(), tuple.size());
+  EXPECT_EQ(accessor.GetInteger("id"), 2);
+  EXPECT_EQ(accessor.GetString("status"), "shipped");
+}
+
+TEST_F(DiskManagerTest, DictionariesStopAtTheSchemaArea) {
+  Schema schema;
+  schema.AddColumn("id", DataType::INTEGER, false, 0);
+  schema.AddColumn("city", DataType::VARCHAR, false, 200,
+                   ColumnEncoding::DICTIONARY);
+  schema.Finalize();
+  std::vector<char> tuple(256);
+
+  // Distinct 200-byte values until the dictionary refuses one
+  int32_t written = 0;
+  for (;; written++) {
+    std::string city(200, static_cast<char>('a' + written % 26));
+    city.replace(0, 4, reinterpret_cast<const char*>(&written), 4);
+    try {
+      TupleSerializer::SerializeVariableLength(
+          schema, {FieldValue::Integer(written), FieldValue::VarChar(city)},
+          tuple.data(), tuple.size());
+    } catch (const std::runtime_error&) {
+      break;
+    }
+  }
+  ColumnDictionary* dictionary = schema.GetDictionary(1);
+  EXPECT_EQ(dictionary->GetSize(), static_cast<size_t>(written));
+  EXPECT_EQ(written, static_cast<int32_t>(
+                         DICTIONARY_BUDGET_BYTES /
+                         (DictionaryBudget::ENTRY_OVERHEAD + 200)));
+
+  // Values already in the dictionary still encode once the budget is spent
+  dictionary_code_t code;
+  const std::string first = std::string(dictionary->Decode(0));
+  EXPECT_TRUE(dictionary->Encode(first, &code));
+  EXPECT_EQ(code, 0);
+
+  // Every code handed out is persisted
+  DiskManager disk_manager(test_db_file_);
+  std::string data;
+  schema.AppendDictionaryEntries(&data);
+  ASSERT_LE(data.size(), disk_manager.GetSchemaCapacity());
+  disk_manager.WriteSchemaData(data);
+
+  Schema reloaded;
+  reloaded.AddColumn("id", DataType::INTEGER, false, 0);
+  reloaded.AddColumn("city", DataType::VARCHAR, false, 200,
+                     ColumnEncoding::DICTIONARY);
+  reloaded.Finalize();
+  reloaded.LoadDictionaries(disk_manager.ReadSchemaData());
+  EXPECT_EQ(reloaded.GetDictionary(1)->GetSize(),
+            static_cast<size_t>(written));
+}
+
+namespace {
+
+// FirstTuple() of a page-sized image
+std::string FirstTupleOf(const char* image) {
+  auto page = Page::CreateNew();
+  std::memcpy(page->GetRawBuffer(), image, PAGE_SIZE);
+  return FirstTuple(*page);
+}
+
+}  // namespace
+
+TEST_F(DiskManagerTest, SnapshotImageIgnoresLaterWrites) {
+  DiskManager disk_manager(test_db_file_, DurabilityMode::BATCHED);
+  std::vector<page_id_t> page_ids;
+  for (int i = 0; i < 3; i++) {
+    page_ids.push_back(disk_manager.AllocatePage());
+    disk_manager.WritePage(page_ids.back(),
+                           CompressiblePage(page_ids.back())->GetRawBuffer());
+  }
+
+  std::unique_ptr<PageSnapshot> snapshot = disk_manager.StartSnapshot();
+  EXPECT_EQ(snapshot->GetEpoch(), 1u);
+  EXPECT_EQ(snapshot->GetPageCount(), page_ids.back() + 1);
+  EXPECT_THROW(disk_manager.StartSnapshot(), std::runtime_error);
+
+  // Rewritten twice, freed, and a page past the image
+  disk_manager.WritePage(page_ids[1], NoisePage(page_ids[1])->GetRawBuffer());
+  disk_manager.WritePage(page_ids[1], NoisePage(page_ids[2])->GetRawBuffer());
+  disk_manager.DeallocatePage(page_ids[2]);
+  const page_id_t extra = disk_manager.AllocatePages(1);
+  disk_manager.WritePage(extra, NoisePage(extra)->GetRawBuffer());
+  EXPECT_EQ(snapshot->GetPreservedPageCount(), 2u);
+  EXPECT_EQ(disk_manager.GetMetrics().snapshot_preserved_pages, 2u);
+
+  std::vector<char> image(3 * PAGE_SIZE);
+  snapshot->ReadPages(page_ids[0], 3, image.data());
+  for (size_t i = 0; i < 3; i++) {
+    EXPECT_EQ(FirstTupleOf(image.data() + i * PAGE_SIZE),
+              FirstTuple(*CompressiblePage(page_ids[i])));
+  }
+  EXPECT_THROW(snapshot->ReadPages(extra, 1, image.data()),
+               std::invalid_argument);
+
+  // The live file moved on
+  auto page = Page::CreateNew();
+  disk_manager.ReadPage(page_ids[1], page->GetRawBuffer());
+  EXPECT_EQ(FirstTuple(*page), FirstTuple(*NoisePage(page_ids[2])));
+
+  snapshot.reset();
+  EXPECT_FALSE(fs::exists(test_db_file_ + ".snap"));
+  EXPECT_EQ(disk_manager.StartSnapshot()->GetEpoch(), 2u);
+}
+
+TEST_F(DiskManagerTest, SnapshotKeepsTruncatedPages) {
+  DiskManager disk_manager(test_db_file_, DurabilityMode::BATCHED,
+                           DEFAULT_SYNC_INTERVAL_MS, IOEngineType::AUTO, false,
+                           /*compress_pages=*/true);
+  std::vector<page_id_t> page_ids;
+  for (int i = 0; i < 3; i++) {
+    page_ids.push_back(disk_manager.AllocatePage());
+    disk_manager.WritePage(page_ids.back(),
+                           NoisePage(page_ids.back())->GetRawBuffer());
+  }
+  disk_manager.Sync();
+
+  std::unique_ptr<PageSnapshot> snapshot = disk_manager.StartSnapshot();
+  disk_manager.DeallocatePage(page_ids[2]);
+  EXPECT_EQ(disk_manager.TruncateFreeTail(), 1u);
+
+  std::vector<char> image(PAGE_SIZE);
+  snapshot->ReadPages(page_ids[2], 1, image.data());
+  EXPECT_EQ(FirstTupleOf(image.data()), FirstTuple(*NoisePage(page_ids[2])));
+}
+
+TEST_F(DiskManagerTest, SnapshotBackupOpensAsDatabaseFile) {
+  const std::string backup_file = test_db_file_ + ".bak";
+  std::vector<page_id_t> page_ids;
+  {
+    DiskManager disk_manager(test_db_file_, DurabilityMode::BATCHED);
+    for (int i = 0; i < 100; i++) {
+      page_ids.push_back(disk_manager.AllocatePage());
+      disk_manager.WritePage(page_ids.back(),
+                             NoisePage(page_ids.back())->GetRawBuffer());
+    }
+    disk_manager.WriteSchemaData("schema");
+
+    std::unique_ptr<PageSnapshot> snapshot = disk_manager.StartSnapshot();
+    for (page_id_t page_id : page_ids) {
+      disk_manager.WritePage(page_id,
+                             CompressiblePage(page_id)->GetRawBuffer());
+    }
+    disk_manager.WriteSchemaData("schema v2");
+    snapshot->WriteBackup(backup_file);
+  }
+
+  DiskManager backup(backup_file);
+  EXPECT_EQ(backup.GetNextPageId(), page_ids.back() + 1);
+  EXPECT_EQ(backup.ReadSchemaData(), "schema");
+  auto page = Page::CreateNew();
+  for (page_id_t page_id : page_ids) {
+    backup.ReadPage(page_id, page->GetRawBuffer());
+    EXPECT_EQ(FirstTuple(*page), FirstTuple(*NoisePage(page_id)));
+  }
+  fs::remove(backup_file);
+}
+
+TEST_F(DiskManagerTest, IncrementalBackupRollsBackupForward) {
+  const std::string backup_file = test_db_file_ + ".bak";
+  const std::string incremental_file = test_db_file_ + ".inc";
+  DiskManager disk_manager(test_db_file_, DurabilityMode::BATCHED);
+  std::vector<page_id_t> page_ids;
+  for (int i = 0; i < 8; i++) {
+    page_ids.push_back(disk_manager.AllocatePage());
+    disk_manager.WritePage(page_ids.back(),
+                           NoisePage(page_ids.back())->GetRawBuffer());
+  }
+
+  // Without a base the incremental backup is complete
+  {
+    std::unique_ptr<PageSnapshot> snapshot = disk_manager.StartSnapshot();
+    EXPECT_EQ(snapshot->GetBaseEpoch(), 0u);
+    EXPECT_EQ(snapshot->WriteIncrementalBackup(incremental_file),
+              page_ids.size());
+    snapshot->WriteBackup(backup_file);
+    disk_manager.WritePage(page_ids[2],
+                           CompressiblePage(page_ids[2])->GetRawBuffer());
+  }
+  disk_manager.WritePage(page_ids[5],
+                         CompressiblePage(page_ids[5])->GetRawBuffer());
+  const page_id_t extra = disk_manager.AllocatePage();
+  disk_manager.WritePage(extra, NoisePage(extra)->GetRawBuffer());
+
+  {
+    std::unique_ptr<PageSnapshot> snapshot = disk_manager.StartSnapshot();
+    EXPECT_EQ(snapshot->GetBaseEpoch(), 1u);
+    EXPECT_TRUE(snapshot->IsChangedSinceBase(page_ids[2]));
+    EXPECT_FALSE(snapshot->IsChangedSinceBase(page_ids[3]));
+    EXPECT_EQ(snapshot->WriteIncrementalBackup(incremental_file), 3u);
+    disk_manager.WritePage(page_ids[0],
+                           CompressiblePage(page_ids[0])->GetRawBuffer());
+  }
+  PageSnapshot::ApplyIncrementalBackup(backup_file, incremental_file);
+  EXPECT_THROW(PageSnapshot::ApplyIncrementalBackup(incremental_file,
+                                                    backup_file),
+               std::runtime_error);
+
+  DiskManager backup(backup_file);
+  EXPECT_EQ(backup.GetNextPageId(), extra + 1);
+  auto page = Page::CreateNew();
+  for (page_id_t page_id : page_ids) {
+    backup.ReadPage(page_id, page->GetRawBuffer());
+    const bool rewritten = page_id == page_ids[2] || page_id == page_ids[5];
+    EXPECT_EQ(FirstTuple(*page),
+              FirstTuple(rewritten ? *CompressiblePage(page_id)
+                                   : *NoisePage(page_id)));
+  }
+  backup.ReadPage(extra, page->GetRawBuffer());
+  EXPECT_EQ(FirstTuple(*page), FirstTuple(*NoisePage(extra)));
+  fs::remove(backup_file);
+  fs::remove(incremental_file);
+}
+
+TEST_F(DiskManagerTest, IncrementalBackupRejectsWrongBase) {
+  const std::string backup_file = test_db_file_ + ".bak";
+  const std::string other_file = test_db_file_ + ".other";
+  const std::string other_backup_file = test_db_file_ + ".other.bak";
+  std::vector<std::string> increments;
+  page_id_t page_id;
+  {
+    DiskManager disk_manager(test_db_file_, DurabilityMode::BATCHED);
+    page_id = disk_manager.AllocatePage();
+    for (int epoch = 1; epoch <= 3; epoch++) {
+      disk_manager.WritePage(page_id,
+                             NoisePage(page_id + epoch)->GetRawBuffer());
+      std::unique_ptr<PageSnapshot> snapshot = disk_manager.StartSnapshot();
+      EXPECT_EQ(snapshot->GetEpoch(), static_cast<uint64_t>(epoch));
+      if (epoch == 1) {
+        snapshot->WriteBackup(backup_file);
+      } else {
+        increments.push_back(test_db_file_ + ".inc" + std::to_string(epoch));
+        snapshot->WriteIncrementalBackup(increments.back());
+      }
+    }
+  }
+  {
+    DiskManager other(other_file);
+    other.AllocatePage();
+    other.StartSnapshot()->WriteBackup(other_backup_file);
+  }
+
+  // Skipping an increment, or another file's backup, is refused untouched
+  EXPECT_THROW(PageSnapshot::ApplyIncrementalBackup(backup_file, increments[1]),
+               std::runtime_error);
+  EXPECT_THROW(
+      PageSnapshot::ApplyIncrementalBackup(other_backup_file, increments[0]),
+      std::runtime_error);
+  auto page = Page::CreateNew();
+  {
+    DiskManager backup(backup_file);
+    backup.ReadPage(page_id, page->GetRawBuffer());
+    EXPECT_EQ(FirstTuple(*page), FirstTuple(*NoisePage(page_id + 1)));
+  }
+
+  // In order it applies, and again after an interruption
+  PageSnapshot::ApplyIncrementalBackup(backup_file, increments[0]);
+  PageSnapshot::ApplyIncrementalBackup(backup_file, increments[0]);
+  PageSnapshot::ApplyIncrementalBackup(backup_file, increments[1]);
+  {
+    DiskManager backup(backup_file);
+    backup.ReadPage(page_id, page->GetRawBuffer());
+    EXPECT_EQ(FirstTuple(*page), FirstTuple(*NoisePage(page_id + 3)));
+  }
+
+  // Epochs go on after a reopen; the first snapshot has no base
+  {
+    DiskManager disk_manager(test_db_file_);
+    std::unique_ptr<PageSnapshot> snapshot = disk_manager.StartSnapshot();
+    EXPECT_EQ(snapshot->GetEpoch(), 4u);
+    EXPECT_EQ(snapshot->GetBaseEpoch(), 0u);
+  }
+
+  for (const std::string& file :
+       {backup_file, other_file, other_backup_file, increments[0],
+        increments[1]}) {
+    fs::remove(file);
+  }
+}
@@ -0,0 +1,92 @@
+#include "../include/tuple/fixed_tuple_codec.h"
+
+#include <gtest/gtest.h>
+
+#include "../include/tuple/tuple_accessor.h"
+#include "../include/tuple/tuple_serializer.h"
+
+namespace {
+
+using OrderCodec =
+    FixedTupleCodec<bool, int32_t, double, int16_t, FixedChar<6>, int64_t>;
+
+Schema MakeOrderSchema() {
+  Schema schema;
+  schema.AddColumn("shipped", DataType::BOOLEAN, false, 0);
+  schema.AddColumn("id", DataType::INTEGER, false, 0);
+  schema.AddColumn("price", DataType::DOUBLE, true, 0);
+  schema.AddColumn("qty", DataType::SMALLINT, false, 0);
+  schema.AddColumn("code", DataType::CHAR, false, 6);
+  schema.AddColumn("customer", DataType::BIGINT, false, 0);
+  schema.Finalize();
+  return schema;
+}
+
+}  // namespace
+
+// Layout is fully resolved at compile time
+static_assert(OrderCodec::OFFSETS[0] == 8, "bool follows the bitmap");
+static_assert(OrderCodec::OFFSETS[1] == 12, "INTEGER aligned to 4");
+static_assert(OrderCodec::OFFSETS[2] == 16, "DOUBLE aligned to 8");
+static_assert(OrderCodec::TUPLE_SIZE == 40, "compile-time tuple size");
+
+TEST(FixedTupleCodecTest, LayoutMatchesRuntimeSchema) {
+  Schema schema = MakeOrderSchema();
+  EXPECT_TRUE(OrderCodec::MatchesSchema(schema));
+  EXPECT_EQ(OrderCodec::TUPLE_SIZE, schema.GetFixedSectionEnd());
+
+  Schema reordered;
+  reordered.AddColumn("id", DataType::INTEGER, false, 0);
+  reordered.AddColumn("shipped", DataType::BOOLEAN, false, 0);
+  reordered.Finalize();
+  EXPECT_FALSE(OrderCodec::MatchesSchema(reordered));
+}
+
+TEST(FixedTupleCodecTest, EncodeIsByteCompatibleWithSerializer) {
+  Schema schema = MakeOrderSchema();
+  std::vector<FieldValue> values = {
+      FieldValue::Boolean(true),  FieldValue::Integer(77),
+      FieldValue::Double(19.5),   FieldValue::SmallInt(3),
+      FieldValue::Char("AB12"),   FieldValue::BigInt(1LL << 40)};
+
+  char runtime[64];
+  size_t runtime_size = TupleSerializer::SerializeFixedLength(
+      schema, values, runtime, sizeof(runtime));
+
+  char compiled[OrderCodec::TUPLE_SIZE];
+  size_t compiled_size = OrderCodec::Encode(
+      {true, 77, 19.5, 3, FixedChar<6>::From("AB12"), 1LL << 40}, compiled);
+
+  ASSERT_EQ(compiled_size, runtime_size);
+  EXPECT_EQ(std::memcmp(compiled, runtime, runtime_size), 0);
+
+  // Runtime readers understand compiled rows
+  TupleAccessor accessor(schema, compiled, compiled_size);
+  EXPECT_EQ(accessor.GetInteger("id"), 77);
+  EXPECT_EQ(accessor.GetStringView("code"), "AB12");
+  EXPECT_EQ(accessor.GetBigInt("customer"), 1LL << 40);
+}
+
+TEST(FixedTupleCodecTest, DecodesRuntimeRowsIncludingNulls) {
+  Schema schema = MakeOrderSchema();
+  std::vector<FieldValue> values = {
+      FieldValue::Boolean(false), FieldValue::Integer(-5),
+      FieldValue::Null(DataType::DOUBLE), FieldValue::SmallInt(-2),
+      FieldValue::Char("XYZ123"), FieldValue::BigInt(9)};
+
+  char buffer[64];
+  TupleSerializer::SerializeFixedLength(schema, values, buffer,
+                                        sizeof(buffer));
+
+  auto [shipped, id, price, qty, code, customer] = OrderCodec::Decode(buffer);
+  EXPECT_FALSE(shipped);
+  EXPECT_EQ(id, -5);
+  EXPECT_TRUE(OrderCodec::IsNull<2>(buffer));
+  EXPECT_FALSE(OrderCodec::IsNull<1>(buffer));
+  EXPECT_EQ(price, 0.0);
+  EXPECT_EQ(qty, -2);
+  EXPECT_EQ(code.View(), "XYZ123");
+  EXPECT_EQ(customer, 9);
+
+  EXPECT_THROW(FixedChar<2>::From("toolong"), std::invalid_argument);
+}
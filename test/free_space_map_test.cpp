@@ -5,6 +5,10 @@
 #include <chrono>
 #include <cstdio>
 #include <filesystem>
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
 
 class FreeSpaceMapTest : public ::testing::Test {
  protected:
@@ -112,8 +116,6 @@ TEST_F(FreeSpaceMapTest, FindPageWithSpaceReturnsCorrectPage) {
   fsm.UpdatePageFreeSpace(4, 8000);  // Almost full space
 
   // Find page with at least 1000 bytes - should return a valid page
-  // Note: Order is non-deterministic (unordered_set), so just verify we get a
-  // valid page
   page_id_t found = fsm.FindPageWithSpace(1000);
   EXPECT_NE(found, INVALID_PAGE_ID);
   EXPECT_GE(FreeSpaceMap::CategoryToBytes(fsm.GetCategory(found)),
@@ -482,6 +484,323 @@ TEST_F(FreeSpaceMapTest, RealisticWorkloadSimulation) {
   EXPECT_GT(partial_pages, 0);
 }
 
+// Test 19: Search returns the lowest qualifying page id
+TEST_F(FreeSpaceMapTest, FindPageWithSpaceIsFirstFit) {
+  FreeSpaceMap fsm(test_file_);
+  ASSERT_TRUE(fsm.Initialize());
+
+  fsm.UpdatePageFreeSpace(1, 500);
+  fsm.UpdatePageFreeSpace(2, 4000);
+  fsm.UpdatePageFreeSpace(3, 6000);
+  fsm.UpdatePageFreeSpace(4, 4000);
+
+  EXPECT_EQ(fsm.FindPageWithSpace(100), 1);
+  EXPECT_EQ(fsm.FindPageWithSpace(3000), 2);
+  EXPECT_EQ(fsm.FindPageWithSpace(5000), 3);
+
+  // Page 0 is INVALID_PAGE_ID and is never returned
+  FreeSpaceMap fsm_zero(test_file_ + ".zero");
+  ASSERT_TRUE(fsm_zero.Initialize());
+  fsm_zero.UpdatePageFreeSpace(0, 8000);
+  EXPECT_EQ(fsm_zero.FindPageWithSpace(100), INVALID_PAGE_ID);
+  std::remove((test_file_ + ".zero").c_str());
+}
+
+// Test 20: Vectorized search finds a match at every position within and
+// across vector blocks
+TEST_F(FreeSpaceMapTest, FindPageWithSpaceLargeSparseMap) {
+  FreeSpaceMap fsm(test_file_);
+  ASSERT_TRUE(fsm.Initialize());
+
+  const page_id_t page_count = 100000;
+  for (page_id_t i = 1; i < page_count; i++) {
+    fsm.UpdatePageFreeSpace(i, 0);  // allocated but full
+  }
+
+  for (page_id_t target : {1u, 15u, 16u, 31u, 32u, 33u, 63u, 64u, 65u,
+                           77777u, page_count - 1}) {
+    fsm.UpdatePageFreeSpace(target, 4000);
+    EXPECT_EQ(fsm.FindPageWithSpace(3000), target);
+    EXPECT_EQ(fsm.FindPageWithSpace(5000), INVALID_PAGE_ID);
+    fsm.UpdatePageFreeSpace(target, 0);
+  }
+  EXPECT_EQ(fsm.FindPageWithSpace(1), INVALID_PAGE_ID);
+}
+
+// Test 21: Tree descent agrees with a brute-force first-fit scan
+TEST_F(FreeSpaceMapTest, TreeSearchMatchesBruteForce) {
+  FreeSpaceMap fsm(test_file_);
+  ASSERT_TRUE(fsm.Initialize());
+
+  const page_id_t page_count = 30000;  // three levels above the leaves
+  std::vector<uint16_t> free_bytes(page_count, 0);
+  std::mt19937 rng(42);
+  for (int update = 0; update < 20000; update++) {
+    page_id_t page = 1 + rng() % (page_count - 1);
+    free_bytes[page] = static_cast<uint16_t>(rng() % 8192);
+    fsm.UpdatePageFreeSpace(page, free_bytes[page]);
+  }
+
+  for (uint16_t required : {1, 100, 2000, 6000, 8000, 8150}) {
+    const uint8_t threshold =
+        std::max<uint8_t>(FreeSpaceMap::BytesToCategory(required), 1);
+    page_id_t expected = INVALID_PAGE_ID;
+    for (page_id_t page = 1; page < page_count; page++) {
+      if (FreeSpaceMap::BytesToCategory(free_bytes[page]) >= threshold) {
+        expected = page;
+        break;
+      }
+    }
+    EXPECT_EQ(fsm.FindPageWithSpace(required), expected)
+        << "required " << required;
+  }
+
+  // Shrinking the current answer moves the search to the next candidate
+  page_id_t first = fsm.FindPageWithSpace(1);
+  ASSERT_NE(first, INVALID_PAGE_ID);
+  fsm.UpdatePageFreeSpace(first, 0);
+  EXPECT_GT(fsm.FindPageWithSpace(1), first);
+}
+
+// Test 22: Search cost stays flat on a 1M-page table
+TEST_F(FreeSpaceMapTest, MillionPageSearchIsLogarithmic) {
+  FreeSpaceMap fsm(test_file_);
+  ASSERT_TRUE(fsm.Initialize());
+
+  const page_id_t page_count = 1 << 20;
+  for (page_id_t i = 1; i < page_count; i++) {
+    fsm.SetCategory(i, 0);  // allocated but full
+  }
+  fsm.UpdatePageFreeSpace(page_count - 1, 4000);
+
+  auto start = std::chrono::high_resolution_clock::now();
+  for (int iteration = 0; iteration < 1000; iteration++) {
+    EXPECT_EQ(fsm.FindPageWithSpace(3000), page_count - 1);
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+  double avg_time_us =
+      std::chrono::duration_cast<std::chrono::microseconds>(end - start)
+          .count() /
+      1000.0;
+  std::cout << "Average FindPageWithSpace time for 1M pages: " << avg_time_us
+            << " microseconds" << std::endl;
+
+  // A linear scan of 1M bytes would take far longer (generous for ASAN)
+  EXPECT_LT(avg_time_us, 100.0);
+}
+
+// Test 23: Flush writes only the FSM pages that changed
+TEST_F(FreeSpaceMapTest, FlushWritesOnlyDirtyPages) {
+  const page_id_t spread = FreeSpaceMap::FSM_CATEGORIES_PER_PAGE;
+  {
+    FreeSpaceMap fsm(test_file_);
+    ASSERT_TRUE(fsm.Initialize());
+    for (page_id_t i = 1; i < 3 * spread; i += 97) {
+      fsm.UpdatePageFreeSpace(i, 4000);
+    }
+    EXPECT_EQ(fsm.GetDirtyFSMPageCount(), 3);
+    ASSERT_TRUE(fsm.Flush());
+    EXPECT_EQ(fsm.GetDirtyFSMPageCount(), 0);
+    EXPECT_EQ(std::filesystem::file_size(test_file_),
+              3 * FreeSpaceMap::FSM_PAGE_SIZE);
+
+    // One data page in the middle FSM page
+    fsm.UpdatePageFreeSpace(spread + 5, 6000);
+    EXPECT_EQ(fsm.GetDirtyFSMPageCount(), 1);
+    ASSERT_TRUE(fsm.Flush());
+  }
+
+  FreeSpaceMap reloaded(test_file_);
+  ASSERT_TRUE(reloaded.Initialize());
+  EXPECT_EQ(reloaded.GetDirtyFSMPageCount(), 0);
+  EXPECT_EQ(reloaded.GetCategory(spread + 5),
+            FreeSpaceMap::BytesToCategory(6000));
+  EXPECT_EQ(reloaded.GetCategory(1), FreeSpaceMap::BytesToCategory(4000));
+  EXPECT_EQ(reloaded.FindPageWithSpace(5000), spread + 5);
+}
+
+// Test 24: Files in the original single-blob format load and are converted
+TEST_F(FreeSpaceMapTest, LoadsAndConvertsLegacyFormat) {
+  {
+    // magic, page_count, allocated_count, ids, categories
+    std::vector<uint32_t> header = {FreeSpaceMap::FSM_LEGACY_MAGIC_NUMBER, 3,
+                                    2, 1, 2};
+    std::vector<uint8_t> categories = {0, 100, 200};
+    FILE* file = fopen(test_file_.c_str(), "wb");
+    ASSERT_NE(file, nullptr);
+    fwrite(header.data(), sizeof(uint32_t), header.size(), file);
+    fwrite(categories.data(), 1, categories.size(), file);
+    fclose(file);
+  }
+
+  {
+    FreeSpaceMap fsm(test_file_);
+    ASSERT_TRUE(fsm.Initialize());
+    EXPECT_EQ(fsm.GetPageCount(), 3);
+    EXPECT_EQ(fsm.GetCategory(1), 100);
+    EXPECT_EQ(fsm.GetCategory(2), 200);
+    EXPECT_EQ(fsm.FindPageWithSpace(FreeSpaceMap::CategoryToBytes(150)), 2);
+    ASSERT_TRUE(fsm.Flush());
+  }
+
+  EXPECT_EQ(std::filesystem::file_size(test_file_),
+            FreeSpaceMap::FSM_PAGE_SIZE);
+  FreeSpaceMap converted(test_file_);
+  ASSERT_TRUE(converted.Initialize());
+  EXPECT_EQ(converted.GetPageCount(), 3);
+  EXPECT_EQ(converted.GetCategory(2), 200);
+}
+
+// Test 25: Insert streams hand each thread its own target page
+TEST_F(FreeSpaceMapTest, InsertStreamsGiveThreadsDistinctTargets) {
+  FreeSpaceMap fsm(test_file_);
+  ASSERT_TRUE(fsm.Initialize());
+  for (page_id_t page_id = 1; page_id <= 8; page_id++) {
+    fsm.UpdatePageFreeSpace(page_id, 8000);
+  }
+
+  const size_t num_streams = 4;
+  fsm.SetInsertStreams(num_streams);
+  EXPECT_EQ(fsm.GetInsertStreamCount(), num_streams);
+
+  // Threads started one after another get consecutive stream numbers
+  std::vector<page_id_t> first(num_streams), second(num_streams);
+  for (size_t t = 0; t < num_streams; t++) {
+    std::thread inserter([&, t]() {
+      first[t] = fsm.FindInsertTarget(100);
+      second[t] = fsm.FindInsertTarget(100);
+    });
+    inserter.join();
+  }
+
+  std::set<page_id_t> targets(first.begin(), first.end());
+  EXPECT_EQ(targets.size(), num_streams);
+  EXPECT_EQ(targets.count(INVALID_PAGE_ID), 0u);
+  EXPECT_EQ(first, second);  // a target is kept while it has room
+
+  // Claimed pages are invisible to the classic search
+  page_id_t unclaimed = fsm.FindPageWithSpace(100);
+  EXPECT_NE(unclaimed, INVALID_PAGE_ID);
+  EXPECT_EQ(targets.count(unclaimed), 0u);
+}
+
+// Test 26: A filled target is handed back and replaced
+TEST_F(FreeSpaceMapTest, FilledTargetIsHandedBack) {
+  FreeSpaceMap fsm(test_file_);
+  ASSERT_TRUE(fsm.Initialize());
+  fsm.UpdatePageFreeSpace(1, 8000);
+  fsm.UpdatePageFreeSpace(2, 8000);
+  fsm.SetInsertStreams(2);
+
+  page_id_t target = fsm.FindInsertTarget(1000);
+  ASSERT_NE(target, INVALID_PAGE_ID);
+  const page_id_t other = target == 1 ? 2 : 1;
+  EXPECT_EQ(fsm.FindPageWithSpace(100), other);
+
+  // Too little room left for this stream's tuples: it moves on, and the old
+  // target becomes available to smaller requests again
+  fsm.UpdatePageFreeSpace(target, 500);
+  EXPECT_EQ(fsm.FindInsertTarget(1000), other);
+  EXPECT_EQ(fsm.FindPageWithSpace(100), target);
+
+  // Nothing left to claim: the caller allocates and adopts a new page
+  fsm.UpdatePageFreeSpace(other, 0);
+  EXPECT_EQ(fsm.FindInsertTarget(1000), INVALID_PAGE_ID);
+  fsm.UpdatePageFreeSpace(3, 8000);
+  fsm.AssignInsertTarget(3);
+  EXPECT_EQ(fsm.FindInsertTarget(1000), 3u);
+  EXPECT_EQ(fsm.FindPageWithSpace(1000), INVALID_PAGE_ID);
+
+  // Turning streams off releases every claim
+  fsm.SetInsertStreams(0);
+  EXPECT_EQ(fsm.GetInsertStreamCount(), 0u);
+  EXPECT_EQ(fsm.FindPageWithSpace(1000), 3u);
+  EXPECT_EQ(fsm.FindInsertTarget(100), target);
+}
+
+// Test 27: Claims are tracked correctly through the max-tree
+TEST_F(FreeSpaceMapTest, InsertStreamsOnLargeMap) {
+  FreeSpaceMap fsm(test_file_);
+  ASSERT_TRUE(fsm.Initialize());
+  const page_id_t num_pages = 100000;
+  for (page_id_t page_id = 1; page_id < num_pages; page_id++) {
+    fsm.UpdatePageFreeSpace(page_id, page_id % 1000 == 0 ? 8000 : 100);
+  }
+  fsm.SetInsertStreams(8);
+
+  std::set<page_id_t> targets;
+  for (int t = 0; t < 8; t++) {
+    std::thread inserter(
+        [&]() { targets.insert(fsm.FindInsertTarget(4000)); });
+    inserter.join();
+  }
+  EXPECT_EQ(targets, (std::set<page_id_t>{1000, 2000, 3000, 4000, 5000, 6000,
+                                          7000, 8000}));
+  EXPECT_EQ(fsm.FindPageWithSpace(4000), 9000u);
+}
+
+// Test 28: Opening reads no FSM page; pages load as they are needed
+TEST_F(FreeSpaceMapTest, LoadsFSMPagesOnDemand) {
+  const page_id_t spread = FreeSpaceMap::FSM_CATEGORIES_PER_PAGE;
+  {
+    FreeSpaceMap fsm(test_file_);
+    ASSERT_TRUE(fsm.Initialize());
+    for (page_id_t i = 1; i < 2 * spread; i += 101) {
+      fsm.UpdatePageFreeSpace(i, 100);  // nearly full everywhere
+    }
+    fsm.UpdatePageFreeSpace(spread + 1, 100);
+    fsm.UpdatePageFreeSpace(2 * spread + 7, 7000);
+    ASSERT_TRUE(fsm.Flush());
+  }
+
+  FreeSpaceMap fsm(test_file_);
+  ASSERT_TRUE(fsm.Initialize());
+  EXPECT_EQ(fsm.GetLoadedFSMPageCount(), 0u);
+  EXPECT_EQ(fsm.GetPageCount(), 2 * spread + 8);
+
+  EXPECT_EQ(fsm.GetCategory(spread + 1), FreeSpaceMap::BytesToCategory(100));
+  EXPECT_EQ(fsm.GetLoadedFSMPageCount(), 1u);
+
+  // The search walks through the placeholders of FSM pages 0 and 2
+  EXPECT_EQ(fsm.FindPageWithSpace(6000), 2 * spread + 7);
+  EXPECT_EQ(fsm.GetLoadedFSMPageCount(), 3u);
+  EXPECT_EQ(fsm.FindPageWithSpace(8000), INVALID_PAGE_ID);
+}
+
+// Test 29: Updates after a lazy open never flush placeholders
+TEST_F(FreeSpaceMapTest, FlushAfterLazyOpenKeepsUnloadedPages) {
+  const page_id_t spread = FreeSpaceMap::FSM_CATEGORIES_PER_PAGE;
+  {
+    FreeSpaceMap fsm(test_file_);
+    ASSERT_TRUE(fsm.Initialize());
+    fsm.UpdatePageFreeSpace(5, 1000);
+    fsm.UpdatePageFreeSpace(spread + 5, 2000);
+    fsm.UpdatePageFreeSpace(2 * spread + 5, 3000);
+    ASSERT_TRUE(fsm.Flush());
+  }
+
+  {
+    FreeSpaceMap fsm(test_file_);
+    ASSERT_TRUE(fsm.Initialize());
+    fsm.UpdatePageFreeSpace(spread + 6, 4000);
+    EXPECT_EQ(fsm.GetLoadedFSMPageCount(), 1u);
+    // Growing the page count rewrites FSM page 0's header
+    fsm.UpdatePageFreeSpace(3 * spread + 1, 5000);
+    ASSERT_TRUE(fsm.Flush());
+  }
+
+  FreeSpaceMap fsm(test_file_);
+  ASSERT_TRUE(fsm.Initialize());
+  EXPECT_EQ(fsm.GetPageCount(), 3 * spread + 2);
+  EXPECT_EQ(fsm.GetCategory(5), FreeSpaceMap::BytesToCategory(1000));
+  EXPECT_EQ(fsm.GetCategory(spread + 5), FreeSpaceMap::BytesToCategory(2000));
+  EXPECT_EQ(fsm.GetCategory(spread + 6), FreeSpaceMap::BytesToCategory(4000));
+  EXPECT_EQ(fsm.GetCategory(2 * spread + 5),
+            FreeSpaceMap::BytesToCategory(3000));
+  EXPECT_EQ(fsm.GetCategory(3 * spread + 1),
+            FreeSpaceMap::BytesToCategory(5000));
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
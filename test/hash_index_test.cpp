@@ -0,0 +1,339 @@
+#include "../include/index/hash_index.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../include/index/b_plus_tree.h"
+#include "../include/index/table_index.h"
+#include "../include/storage/disk_manager.h"
+#include "../include/storage/page_manager.h"
+#include "../include/tuple/tuple_builder.h"
+#include "../include/tuple/tuple_serializer.h"
+
+namespace fs = std::filesystem;
+
+class HashIndexTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    fs::create_directories("/tmp/test");
+    db_file_ = "/tmp/test/hash_index_test_" +
+               std::to_string(std::chrono::system_clock::now()
+                                  .time_since_epoch()
+                                  .count()) +
+               ".idx";
+    disk_manager_ = std::make_unique<DiskManager>(db_file_);
+    bpm_ = std::make_unique<BufferPoolManager>(256, disk_manager_.get());
+  }
+
+  void TearDown() override {
+    bpm_.reset();
+    disk_manager_.reset();
+    std::remove(db_file_.c_str());
+  }
+
+  static std::string Key(uint64_t value) {
+    std::string key(8, '\0');
+    for (int i = 0; i < 8; i++) {
+      key[i] = static_cast<char>(value >> (8 * (7 - i)));
+    }
+    return key;
+  }
+
+  static TupleId Tid(uint64_t value) {
+    return {static_cast<page_id_t>(value / 100 + 1),
+            static_cast<slot_id_t>(value % 100)};
+  }
+
+  static std::vector<TupleId> Find(const KeyIndex& index, uint64_t value) {
+    std::vector<TupleId> found;
+    EXPECT_EQ(index.Lookup(Key(value).data(), &found).code, 0);
+    return found;
+  }
+
+  std::string db_file_;
+  std::unique_ptr<DiskManager> disk_manager_;
+  std::unique_ptr<BufferPoolManager> bpm_;
+};
+
+TEST_F(HashIndexTest, InsertAndLookupAcrossSplits) {
+  HashIndex index(bpm_.get(), 8, /*unique=*/false, INVALID_PAGE_ID, 8);
+  std::vector<uint64_t> values(5000);
+  std::iota(values.begin(), values.end(), 0);
+  std::shuffle(values.begin(), values.end(), std::mt19937(42));
+  for (uint64_t value : values) {
+    ASSERT_EQ(index.Insert(Key(value).data(), Tid(value)).code, 0) << value;
+  }
+
+  ASSERT_EQ(index.CheckIntegrity().code, 0) << index.CheckIntegrity().message;
+  EXPECT_GE(index.GetBucketCount(), 5000u / 8);
+  EXPECT_GE(size_t{1} << index.GetGlobalDepth(), index.GetBucketCount());
+  for (uint64_t value = 0; value < 5000; value++) {
+    std::vector<TupleId> found = Find(index, value);
+    ASSERT_EQ(found.size(), 1u) << value;
+    EXPECT_EQ(found[0], Tid(value));
+  }
+  EXPECT_TRUE(Find(index, 5000).empty());
+}
+
+TEST_F(HashIndexTest, UniqueIndexRejectsDuplicateKeys) {
+  HashIndex index(bpm_.get(), 8, /*unique=*/true);
+  ASSERT_EQ(index.Insert(Key(7).data(), Tid(1)).code, 0);
+  EXPECT_NE(index.Insert(Key(7).data(), Tid(2)).code, 0);
+  EXPECT_NE(index.Insert(nullptr, Tid(3)).code, 0);
+
+  std::vector<TupleId> found = Find(index, 7);
+  ASSERT_EQ(found.size(), 1u);
+  EXPECT_EQ(found[0], Tid(1));
+}
+
+TEST_F(HashIndexTest, NonUniqueDuplicatesAreBoundedByABucket) {
+  HashIndex index(bpm_.get(), 8, /*unique=*/false, INVALID_PAGE_ID, 8);
+  for (uint64_t i = 0; i < 8; i++) {
+    ASSERT_EQ(index.Insert(Key(3).data(), Tid(i)).code, 0);
+  }
+  EXPECT_NE(index.Insert(Key(3).data(), Tid(0)).code, 0);  // same entry
+
+  // Eight entries that hash alike fill a bucket no split can divide
+  EXPECT_NE(index.Insert(Key(3).data(), Tid(8)).code, 0);
+  EXPECT_EQ(Find(index, 3).size(), 8u);
+
+  // Other keys still split their way around the full bucket
+  for (uint64_t value = 100; value < 200; value++) {
+    ASSERT_EQ(index.Insert(Key(value).data(), Tid(value)).code, 0);
+  }
+  EXPECT_EQ(index.CheckIntegrity().code, 0) << index.CheckIntegrity().message;
+  EXPECT_EQ(Find(index, 3).size(), 8u);
+}
+
+TEST_F(HashIndexTest, DeleteRemovesOnlyTheGivenEntry) {
+  HashIndex index(bpm_.get(), 8, /*unique=*/false, INVALID_PAGE_ID, 16);
+  for (uint64_t value = 0; value < 1000; value++) {
+    ASSERT_EQ(index.Insert(Key(value / 2).data(), Tid(value)).code, 0);
+  }
+  for (uint64_t value = 0; value < 1000; value += 2) {
+    ASSERT_EQ(index.Delete(Key(value / 2).data(), Tid(value)).code, 0);
+  }
+  EXPECT_NE(index.Delete(Key(0).data(), Tid(0)).code, 0);
+  EXPECT_NE(index.Delete(Key(0).data(), Tid(999)).code, 0);
+
+  ASSERT_EQ(index.CheckIntegrity().code, 0) << index.CheckIntegrity().message;
+  for (uint64_t key = 0; key < 500; key++) {
+    std::vector<TupleId> found = Find(index, key);
+    ASSERT_EQ(found.size(), 1u) << key;
+    EXPECT_EQ(found[0], Tid(key * 2 + 1));
+  }
+
+  // Freed space is reused without growing
+  const size_t buckets = index.GetBucketCount();
+  for (uint64_t value = 0; value < 1000; value += 2) {
+    ASSERT_EQ(index.Insert(Key(value / 2).data(), Tid(value)).code, 0);
+  }
+  EXPECT_EQ(index.GetBucketCount(), buckets);
+}
+
+TEST_F(HashIndexTest, ColdLookupReadsOnePage) {
+  HashIndex index(bpm_.get(), 8, /*unique=*/true);
+  for (uint64_t value = 0; value < 100000; value++) {
+    ASSERT_EQ(index.Insert(Key(value).data(), Tid(value)).code, 0);
+  }
+  ASSERT_EQ(index.CheckIntegrity().code, 0) << index.CheckIntegrity().message;
+  EXPECT_GT(index.GetBucketCount(), 100000u / index.GetBucketCapacity());
+
+  ASSERT_EQ(bpm_->EvictAllPages().code, 0);
+  for (uint64_t value : {0u, 31337u, 99999u}) {
+    const uint64_t misses_before = bpm_->GetMetrics().misses;
+    std::vector<TupleId> found = Find(index, value);
+    ASSERT_EQ(found.size(), 1u);
+    EXPECT_EQ(found[0], Tid(value));
+    EXPECT_LE(bpm_->GetMetrics().misses - misses_before, 1u);
+  }
+}
+
+TEST_F(HashIndexTest, ReopensFromMetaPage) {
+  page_id_t meta_page_id;
+  // Enough small buckets for the directory to span several pages
+  bpm_ = std::make_unique<BufferPoolManager>(8192, disk_manager_.get());
+  {
+    HashIndex index(bpm_.get(), 8, /*unique=*/true, INVALID_PAGE_ID, 4);
+    for (uint64_t value = 0; value < 20000; value++) {
+      ASSERT_EQ(index.Insert(Key(value).data(), Tid(value)).code, 0);
+    }
+    EXPECT_GT(size_t{1} << index.GetGlobalDepth(), 4096u);
+    meta_page_id = index.GetMetaPageId();
+  }
+  bpm_.reset();
+  disk_manager_.reset();
+
+  disk_manager_ = std::make_unique<DiskManager>(db_file_);
+  bpm_ = std::make_unique<BufferPoolManager>(256, disk_manager_.get());
+  EXPECT_THROW(HashIndex(bpm_.get(), 4, true, meta_page_id),
+               std::runtime_error);
+  EXPECT_THROW(HashIndex(bpm_.get(), 8, false, meta_page_id),
+               std::runtime_error);
+
+  HashIndex index(bpm_.get(), 8, /*unique=*/true, meta_page_id);
+  EXPECT_EQ(index.GetBucketCapacity(), 4u);
+  ASSERT_EQ(index.CheckIntegrity().code, 0) << index.CheckIntegrity().message;
+  for (uint64_t value = 0; value < 20000; value += 997) {
+    std::vector<TupleId> found = Find(index, value);
+    ASSERT_EQ(found.size(), 1u) << value;
+    EXPECT_EQ(found[0], Tid(value));
+  }
+  ASSERT_EQ(index.Insert(Key(20000).data(), Tid(20000)).code, 0);
+}
+
+TEST_F(HashIndexTest, ConcurrentInsertsLookupsAndDeletes) {
+  HashIndex index(bpm_.get(), 8, /*unique=*/true, INVALID_PAGE_ID, 8);
+  constexpr uint64_t kThreads = 4;
+  constexpr uint64_t kPerThread = 3000;
+  std::atomic<bool> failed{false};
+  std::atomic<bool> done{false};
+
+  // Keys below kPerThread are present throughout
+  for (uint64_t value = 0; value < kPerThread; value++) {
+    ASSERT_EQ(index.Insert(Key(value).data(), Tid(value)).code, 0);
+  }
+  std::thread reader([&]() {
+    std::mt19937 rng(7);
+    while (!done) {
+      const uint64_t value = rng() % kPerThread;
+      std::vector<TupleId> found;
+      if (index.Lookup(Key(value).data(), &found).code != 0 ||
+          found.size() != 1 || found[0] != Tid(value)) {
+        failed = true;
+      }
+    }
+  });
+
+  std::vector<std::thread> writers;
+  for (uint64_t t = 0; t < kThreads; t++) {
+    writers.emplace_back([&, t]() {
+      for (uint64_t i = 0; i < kPerThread; i++) {
+        const uint64_t value = kPerThread + i * kThreads + t;
+        if (index.Insert(Key(value).data(), Tid(value)).code != 0) {
+          failed = true;
+        }
+        if (i % 2 == 1 &&
+            index.Delete(Key(value).data(), Tid(value)).code != 0) {
+          failed = true;
+        }
+      }
+    });
+  }
+  for (std::thread& writer : writers) {
+    writer.join();
+  }
+  done = true;
+  reader.join();
+
+  ASSERT_FALSE(failed);
+  ASSERT_EQ(index.CheckIntegrity().code, 0) << index.CheckIntegrity().message;
+  for (uint64_t v = kPerThread; v < kPerThread * (kThreads + 1); v++) {
+    const uint64_t i = (v - kPerThread) / kThreads;
+    EXPECT_EQ(Find(index, v).size(), i % 2 == 0 ? 1u : 0u) << v;
+  }
+}
+
+TEST_F(HashIndexTest, PageManagerMaintainsAttachedIndexes) {
+  const std::string table_file = db_file_ + ".db";
+  const std::string fsm_file = db_file_ + ".fsm";
+  {
+    DiskManager table_dm(table_file);
+    FreeSpaceMap fsm(fsm_file);
+    PageManager pm(&table_dm, &fsm);
+
+    Schema schema;
+    schema.AddColumn("id", DataType::INTEGER, false, 0);
+    schema.AddColumn("city", DataType::VARCHAR, true, 16);
+    schema.Finalize();
+
+    HashIndex by_id_index(bpm_.get(), 4, /*unique=*/true);
+    TableIndex by_id(schema, {"id"}, &by_id_index);
+    DiskManager tree_dm(db_file_ + ".bpt");
+    BufferPoolManager tree_pool(64, &tree_dm);
+    BPlusTree by_city_tree(&tree_pool, 16, /*unique=*/false);
+    TableIndex by_city(schema, {"city"}, &by_city_tree);
+    EXPECT_THROW(TableIndex(schema, {"id"}, &by_city_tree),
+                 std::invalid_argument);
+    pm.AttachIndex(&by_id);
+    pm.AttachIndex(&by_city);
+
+    std::vector<char> row(128);
+    auto make_row = [&](int id, const char* city) {
+      TupleBuilder builder(schema);
+      builder.SetInteger("id", id);
+      if (city != nullptr) {
+        builder.SetVarChar("city", city);
+      } else {
+        builder.SetNull("city");
+      }
+      return static_cast<uint16_t>(TupleSerializer::Serialize(
+          schema, builder.BuildRefs(), row.data(), row.size()));
+    };
+    auto ids_of = [](const TableIndex& index, const FieldValue& value) {
+      std::vector<TupleId> found;
+      EXPECT_EQ(index.Lookup({value}, &found).code, 0);
+      return found;
+    };
+
+    std::vector<TupleId> tids;
+    for (int i = 0; i < 20; i++) {
+      uint16_t size = make_row(i, i % 2 == 0 ? "Oslo" : "Lima");
+      tids.push_back(pm.InsertTuple(row.data(), size));
+      ASSERT_NE(tids.back().slot_id, INVALID_SLOT_ID);
+    }
+    EXPECT_EQ(ids_of(by_city, FieldValue::VarChar("Oslo")).size(), 10u);
+    ASSERT_EQ(ids_of(by_id, FieldValue::Integer(5)).size(), 1u);
+    EXPECT_EQ(ids_of(by_id, FieldValue::Integer(5))[0], tids[5]);
+
+    // A duplicate id is refused and leaves nothing behind
+    uint16_t size = make_row(5, "Rome");
+    EXPECT_EQ(pm.InsertTuple(row.data(), size).slot_id, INVALID_SLOT_ID);
+    EXPECT_TRUE(ids_of(by_city, FieldValue::VarChar("Rome")).empty());
+    std::vector<TupleSlice> batch = {{row.data(), size}};
+    EXPECT_EQ(pm.InsertTuples(batch)[0].slot_id, INVALID_SLOT_ID);
+
+    // Moving a row to another city, growing it past its slot
+    size = make_row(5, "Rome-the-eternal");
+    ASSERT_EQ(pm.UpdateTuple(tids[5], row.data(), size).code, 0);
+    EXPECT_EQ(ids_of(by_city, FieldValue::VarChar("Lima")).size(), 9u);
+    ASSERT_EQ(ids_of(by_city, FieldValue::VarChar("Rome-the-eternal")).size(),
+              1u);
+    EXPECT_EQ(ids_of(by_id, FieldValue::Integer(5))[0], tids[5]);
+
+    // Taking another row's id fails and keeps the row as it was
+    size = make_row(6, "Bern");
+    EXPECT_NE(pm.UpdateTuple(tids[5], row.data(), size).code, 0);
+    EXPECT_TRUE(ids_of(by_city, FieldValue::VarChar("Bern")).empty());
+    ASSERT_EQ(pm.GetTuple(tids[5], row.data(), row.size()).code, 0);
+    EXPECT_EQ(TupleAccessor(schema, row.data(), row.size()).GetString("city"),
+              "Rome-the-eternal");
+
+    // NULL keys are not indexed
+    size = make_row(7, nullptr);
+    ASSERT_EQ(pm.UpdateTuple(tids[7], row.data(), size).code, 0);
+    EXPECT_EQ(ids_of(by_city, FieldValue::VarChar("Lima")).size(), 8u);
+
+    ASSERT_EQ(pm.DeleteTuple(tids[4]).code, 0);
+    ASSERT_EQ(pm.DeleteTuple(tids[7]).code, 0);
+    EXPECT_TRUE(ids_of(by_id, FieldValue::Integer(4)).empty());
+    EXPECT_TRUE(ids_of(by_id, FieldValue::Integer(7)).empty());
+    EXPECT_EQ(ids_of(by_city, FieldValue::VarChar("Oslo")).size(), 9u);
+    EXPECT_EQ(by_id_index.CheckIntegrity().code, 0);
+    EXPECT_EQ(by_city_tree.CheckIntegrity().code, 0);
+  }
+  std::remove(table_file.c_str());
+  std::remove(fsm_file.c_str());
+  std::remove((db_file_ + ".bpt").c_str());
+}
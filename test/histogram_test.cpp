@@ -0,0 +1,94 @@
+#include "../include/common/histogram.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+TEST(LatencyHistogramTest, PercentilesWithinBucketPrecision) {
+  LatencyHistogram histogram;
+  EXPECT_EQ(histogram.GetPercentile(0.5), 0u);
+  for (uint64_t i = 1; i <= 10000; i++) {
+    histogram.Record(i * 100);
+  }
+  EXPECT_EQ(histogram.GetCount(), 10000u);
+  EXPECT_EQ(histogram.GetMax(), 1000000u);
+  EXPECT_NEAR(histogram.GetMean(), 500050.0, 1.0);
+
+  const double fractions[] = {0.5, 0.99, 0.999};
+  for (double fraction : fractions) {
+    double exact = fraction * 1000000.0;
+    double reported = static_cast<double>(histogram.GetPercentile(fraction));
+    EXPECT_GE(reported, exact);
+    EXPECT_LE(reported, exact * (1.0 + 1.0 / 16));
+  }
+  EXPECT_EQ(histogram.GetPercentile(1.0), 1000000u);
+
+  // Small values are exact
+  LatencyHistogram small;
+  small.Record(3);
+  small.Record(7);
+  EXPECT_EQ(small.GetPercentile(0.5), 3u);
+  EXPECT_EQ(small.GetPercentile(1.0), 7u);
+}
+
+TEST(LatencyHistogramTest, MergeCombinesSamples) {
+  LatencyHistogram first;
+  LatencyHistogram second;
+  for (int i = 0; i < 99; i++) {
+    first.Record(1000);
+  }
+  second.Record(1000000);
+  first.Merge(second);
+  EXPECT_EQ(first.GetCount(), 100u);
+  EXPECT_EQ(first.GetMax(), 1000000u);
+  EXPECT_LE(first.GetPercentile(0.99), 1000u + 1000u / 16);
+  EXPECT_EQ(first.GetPercentile(1.0), 1000000u);
+}
+
+TEST(LatencyHistogramTest, BucketsCoverFullRange) {
+  // Bucket bounds are increasing and every value lands in a bucket whose
+  // bound is at least the value and within 1/16 above it
+  const uint64_t values[] = {0,          1,
+                             15,         16,
+                             17,         1000,
+                             123456789,  1ULL << 40,
+                             UINT64_MAX / 2, UINT64_MAX};
+  for (uint64_t value : values) {
+    const size_t bucket = LatencyHistogram::BucketFor(value);
+    ASSERT_LT(bucket, LatencyHistogram::BUCKET_COUNT);
+    const uint64_t bound = LatencyHistogram::BucketUpperBound(bucket);
+    EXPECT_GE(bound, value);
+    EXPECT_LE(bound - value, value / 16) << value;
+  }
+  for (size_t bucket = 1; bucket < LatencyHistogram::BucketFor(UINT64_MAX);
+       bucket++) {
+    EXPECT_GT(LatencyHistogram::BucketUpperBound(bucket),
+              LatencyHistogram::BucketUpperBound(bucket - 1));
+  }
+}
+
+TEST(AtomicLatencyHistogramTest, ConcurrentRecordsAreAllCounted) {
+  AtomicLatencyHistogram histogram;
+  const int threads = 4;
+  const int per_thread = 10000;
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; t++) {
+    workers.emplace_back([&histogram, t]() {
+      for (int i = 0; i < per_thread; i++) {
+        histogram.Record(static_cast<uint64_t>(t * per_thread + i));
+      }
+    });
+  }
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+
+  LatencyHistogram snapshot = histogram.Snapshot();
+  EXPECT_EQ(snapshot.GetCount(), static_cast<uint64_t>(threads * per_thread));
+  EXPECT_EQ(snapshot.GetMax(), static_cast<uint64_t>(threads * per_thread - 1));
+  EXPECT_NEAR(snapshot.GetMean(), (threads * per_thread - 1) / 2.0, 0.01);
+  const double median = static_cast<double>(snapshot.GetPercentile(0.5));
+  EXPECT_GE(median, threads * per_thread / 2.0 - 1);
+  EXPECT_LE(median, threads * per_thread / 2.0 * (1.0 + 1.0 / 16));
+}
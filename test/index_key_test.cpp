@@ -0,0 +1,128 @@
+#include "../include/index/index_key.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include "../include/tuple/tuple_builder.h"
+#include "../include/tuple/tuple_serializer.h"
+
+namespace {
+
+std::vector<char> EncodeOne(const IndexKeyEncoder& encoder,
+                            const FieldValue& value) {
+  std::vector<char> key(encoder.GetKeySize());
+  EXPECT_TRUE(encoder.Encode(std::vector<FieldValue>{value}, key.data()));
+  return key;
+}
+
+int CompareKeys(const std::vector<char>& a, const std::vector<char>& b) {
+  return std::memcmp(a.data(), b.data(), a.size());
+}
+
+}  // namespace
+
+TEST(IndexKeyEncoderTest, IntegersKeepTheirOrder) {
+  Schema schema;
+  schema.AddColumn("id", DataType::BIGINT, false, 0);
+  schema.Finalize();
+  IndexKeyEncoder encoder(schema, {"id"});
+  ASSERT_EQ(encoder.GetKeySize(), 8);
+
+  const std::vector<int64_t> values = {INT64_MIN, -1000, -1, 0,
+                                       1,         255,   256, INT64_MAX};
+  for (size_t i = 1; i < values.size(); i++) {
+    EXPECT_LT(CompareKeys(EncodeOne(encoder, FieldValue::BigInt(values[i - 1])),
+                          EncodeOne(encoder, FieldValue::BigInt(values[i]))),
+              0)
+        << values[i - 1] << " vs " << values[i];
+  }
+}
+
+TEST(IndexKeyEncoderTest, DoublesKeepTheirOrder) {
+  Schema schema;
+  schema.AddColumn("price", DataType::DOUBLE, false, 0);
+  schema.Finalize();
+  IndexKeyEncoder encoder(schema, {"price"});
+
+  const std::vector<double> values = {-1e300, -2.5, -0.5, 0.0, 1e-300, 0.5,
+                                      2.5,    1e300};
+  for (size_t i = 1; i < values.size(); i++) {
+    EXPECT_LT(CompareKeys(EncodeOne(encoder, FieldValue::Double(values[i - 1])),
+                          EncodeOne(encoder, FieldValue::Double(values[i]))),
+              0)
+        << values[i - 1] << " vs " << values[i];
+  }
+}
+
+TEST(IndexKeyEncoderTest, CompositeKeyOrdersByColumnsInTurn) {
+  Schema schema;
+  schema.AddColumn("id", DataType::INTEGER, false, 0);
+  schema.AddColumn("name", DataType::VARCHAR, false, 8);
+  schema.Finalize();
+  IndexKeyEncoder encoder(schema, {"name", "id"});
+  ASSERT_EQ(encoder.GetKeySize(), 12);
+
+  auto encode = [&](const std::string& name, int32_t id) {
+    std::vector<char> key(encoder.GetKeySize());
+    EXPECT_TRUE(encoder.Encode(
+        {FieldValue::VarChar(name), FieldValue::Integer(id)}, key.data()));
+    return key;
+  };
+  EXPECT_LT(CompareKeys(encode("ab", 9), encode("abc", 1)), 0);
+  EXPECT_LT(CompareKeys(encode("abc", 1), encode("abc", 2)), 0);
+  EXPECT_LT(CompareKeys(encode("abc", -5), encode("abd", -9)), 0);
+
+  // Too long for the column
+  std::vector<char> key(encoder.GetKeySize());
+  EXPECT_FALSE(encoder.Encode(
+      {FieldValue::VarChar("longer than 8"), FieldValue::Integer(1)},
+      key.data()));
+}
+
+TEST(IndexKeyEncoderTest, EncodesFromSerializedTuple) {
+  Schema schema;
+  schema.AddColumn("id", DataType::INTEGER, false, 0);
+  schema.AddColumn("email", DataType::VARCHAR, true, 32);
+  schema.Finalize();
+  IndexKeyEncoder encoder(schema, {"email"});
+
+  TupleBuilder builder(schema);
+  std::vector<char> row(256);
+  const size_t size = TupleSerializer::Serialize(
+      schema, builder.SetInteger("id", 7).SetVarChar("email", "a@b.c")
+                  .BuildRefs(),
+      row.data(), row.size());
+  ASSERT_GT(size, 0u);
+
+  std::vector<char> from_tuple(encoder.GetKeySize());
+  TupleAccessor tuple(schema, row.data(), size);
+  ASSERT_TRUE(encoder.Encode(tuple, from_tuple.data()));
+  std::vector<char> from_value =
+      EncodeOne(encoder, FieldValue::VarChar("a@b.c"));
+  EXPECT_EQ(from_tuple, from_value);
+
+  // NULL keys are not indexed
+  builder.Reset();
+  const size_t null_size = TupleSerializer::Serialize(
+      schema, builder.SetInteger("id", 8).SetNull("email").BuildRefs(),
+      row.data(), row.size());
+  TupleAccessor null_tuple(schema, row.data(), null_size);
+  EXPECT_FALSE(encoder.Encode(null_tuple, from_tuple.data()));
+}
+
+TEST(IndexKeyEncoderTest, RejectsUnsupportedColumns) {
+  Schema schema;
+  schema.AddColumn("id", DataType::INTEGER, false, 0);
+  schema.AddColumn("data", DataType::BLOB, false, 0);
+  schema.AddColumn("big", DataType::CHAR, false, 300);
+  schema.Finalize();
+
+  EXPECT_THROW(IndexKeyEncoder(schema, {}), std::invalid_argument);
+  EXPECT_THROW(IndexKeyEncoder(schema, {"missing"}), std::invalid_argument);
+  EXPECT_THROW(IndexKeyEncoder(schema, {"data"}), std::invalid_argument);
+  EXPECT_THROW(IndexKeyEncoder(schema, {"big"}), std::invalid_argument);
+  EXPECT_NO_THROW(IndexKeyEncoder(schema, {"id"}));
+}
@@ -0,0 +1,422 @@
+#include "../include/storage/log_manager.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../include/storage/page_manager.h"
+
+namespace fs = std::filesystem;
+
+class LogManagerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    fs::create_directories("/tmp/test");
+    base_ = "/tmp/test/log_test_" +
+            std::to_string(
+                std::chrono::system_clock::now().time_since_epoch().count());
+    log_file_ = base_ + ".wal";
+  }
+
+  void TearDown() override {
+    for (const char* suffix : {".wal", ".db", ".fsm", "_crash.wal",
+                               "_crash.db", "_crash.fsm"}) {
+      std::remove((base_ + suffix).c_str());
+    }
+  }
+
+  static std::vector<LogRecord> ReadAll(const LogManager& log,
+                                        std::vector<std::string>* payloads) {
+    std::vector<LogRecord> records;
+    log.ForEachRecord(log.GetCheckpointLsn(), [&](const LogRecord& record) {
+      records.push_back(record);
+      payloads->emplace_back(record.payload, record.payload_size);
+      return true;
+    });
+    return records;
+  }
+
+  // Snapshot the files of a live PageManager, as a crash would leave them
+  void CopyForCrash() {
+    for (const char* suffix : {".wal", ".db", ".fsm"}) {
+      fs::copy_file(base_ + suffix, base_ + "_crash" + suffix,
+                    fs::copy_options::overwrite_existing);
+    }
+  }
+
+  std::string ReadTuple(PageManager* pm, TupleId tid) {
+    char buffer[PAGE_SIZE];
+    if (pm->GetTuple(tid, buffer, sizeof(buffer)).code != 0) {
+      return "<missing>";
+    }
+    return buffer;
+  }
+
+  std::string base_;
+  std::string log_file_;
+};
+
+TEST_F(LogManagerTest, AppendAndReadBack) {
+  LogManager log(log_file_);
+  EXPECT_EQ(log.GetNextLsn(), LogManager::LOG_HEADER_SIZE);
+  EXPECT_EQ(log.GetCheckpointLsn(), LogManager::LOG_HEADER_SIZE);
+
+  const lsn_t first = log.Append(LogRecordType::INSERT, 3, 7, "hello", 5);
+  const lsn_t second = log.Append(LogRecordType::DELETE, 4, 2);
+  EXPECT_EQ(first, LogManager::LOG_HEADER_SIZE);
+  EXPECT_GT(second, first);
+  EXPECT_EQ(log.Append(LogRecordType::UPDATE, 1, 1, nullptr, 4), INVALID_LSN);
+
+  // Only durable records are visible
+  std::vector<std::string> payloads;
+  EXPECT_TRUE(ReadAll(log, &payloads).empty());
+
+  ASSERT_EQ(log.FlushAll().code, 0);
+  std::vector<LogRecord> records = ReadAll(log, &payloads);
+  ASSERT_EQ(records.size(), 2);
+  EXPECT_EQ(records[0].lsn, first);
+  EXPECT_EQ(records[0].type, LogRecordType::INSERT);
+  EXPECT_EQ(records[0].page_id, 3);
+  EXPECT_EQ(records[0].slot_id, 7);
+  EXPECT_EQ(payloads[0], "hello");
+  EXPECT_EQ(records[1].lsn, second);
+  EXPECT_EQ(records[1].type, LogRecordType::DELETE);
+  EXPECT_EQ(payloads[1], "");
+}
+
+TEST_F(LogManagerTest, ReopenResumesAfterLastRecord) {
+  lsn_t next_lsn;
+  {
+    LogManager log(log_file_);
+    log.Append(LogRecordType::NEW_PAGE, 1, INVALID_SLOT_ID);
+    log.Append(LogRecordType::INSERT, 1, 0, "abc", 3);
+    next_lsn = log.GetNextLsn();
+  }  // destructor flushes
+
+  LogManager log(log_file_);
+  EXPECT_EQ(log.GetNextLsn(), next_lsn);
+  EXPECT_EQ(log.GetDurableLsn(), next_lsn);
+  std::vector<std::string> payloads;
+  EXPECT_EQ(ReadAll(log, &payloads).size(), 2);
+  EXPECT_EQ(log.Append(LogRecordType::DELETE, 1, 0), next_lsn);
+}
+
+TEST_F(LogManagerTest, TornTailIsTruncated) {
+  lsn_t last;
+  {
+    LogManager log(log_file_);
+    log.Append(LogRecordType::INSERT, 1, 0, "first", 5);
+    log.Append(LogRecordType::INSERT, 1, 1, "second", 6);
+    last = log.Append(LogRecordType::INSERT, 1, 2, "third", 5);
+  }
+
+  // Corrupt the payload of the last record, then add a partial record
+  {
+    FILE* file = fopen(log_file_.c_str(), "r+b");
+    ASSERT_NE(file, nullptr);
+    fseek(file, static_cast<long>(last + 24), SEEK_SET);
+    fputc('X', file);
+    fseek(file, 0, SEEK_END);
+    fwrite("garbage", 1, 7, file);
+    fclose(file);
+  }
+
+  {
+    LogManager log(log_file_);
+    EXPECT_EQ(log.GetNextLsn(), last);
+    EXPECT_EQ(fs::file_size(log_file_), last);
+    std::vector<std::string> payloads;
+    EXPECT_EQ(ReadAll(log, &payloads).size(), 2);
+    EXPECT_EQ(log.Append(LogRecordType::INSERT, 1, 2, "again", 5), last);
+  }
+
+  LogManager log(log_file_);
+  std::vector<std::string> payloads;
+  ASSERT_EQ(ReadAll(log, &payloads).size(), 3);
+  EXPECT_EQ(payloads[2], "again");
+}
+
+TEST_F(LogManagerTest, OneFlushCoversEverythingBuffered) {
+  LogManager log(log_file_);
+  EXPECT_EQ(log.Flush(INVALID_LSN).code, 0);
+  EXPECT_EQ(log.GetSyncCount(), 0);
+
+  const lsn_t first = log.Append(LogRecordType::DELETE, 1, 0);
+  for (slot_id_t slot = 1; slot < 10; slot++) {
+    log.Append(LogRecordType::DELETE, 1, slot);
+  }
+  ASSERT_EQ(log.Flush(first).code, 0);
+  EXPECT_EQ(log.GetSyncCount(), 1);
+  EXPECT_EQ(log.GetDurableLsn(), log.GetNextLsn());
+
+  // Already durable: no further fdatasync
+  ASSERT_EQ(log.FlushAll().code, 0);
+  EXPECT_EQ(log.GetSyncCount(), 1);
+}
+
+TEST_F(LogManagerTest, ConcurrentCommitsShareSyncs) {
+  LogManager log(log_file_);
+  const int num_threads = 4;
+  const int commits_per_thread = 50;
+
+  std::atomic<int> failures{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t]() {
+      for (int i = 0; i < commits_per_thread; i++) {
+        const lsn_t lsn =
+            log.Append(LogRecordType::INSERT, static_cast<page_id_t>(t + 1),
+                       static_cast<slot_id_t>(i), "x", 1);
+        if (log.Flush(lsn).code != 0 || log.GetDurableLsn() <= lsn) {
+          failures++;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(failures.load(), 0);
+  EXPECT_LE(log.GetSyncCount(),
+            static_cast<uint64_t>(num_threads * commits_per_thread));
+  std::vector<std::string> payloads;
+  EXPECT_EQ(ReadAll(log, &payloads).size(),
+            static_cast<size_t>(num_threads * commits_per_thread));
+}
+
+TEST_F(LogManagerTest, CheckpointLsnPersists) {
+  lsn_t second;
+  {
+    LogManager log(log_file_);
+    log.Append(LogRecordType::INSERT, 1, 0, "old", 3);
+    second = log.Append(LogRecordType::INSERT, 1, 1, "new", 3);
+    EXPECT_NE(log.SetCheckpointLsn(second).code, 0);  // not durable yet
+    ASSERT_EQ(log.FlushAll().code, 0);
+    ASSERT_EQ(log.SetCheckpointLsn(second).code, 0);
+  }
+
+  LogManager log(log_file_);
+  EXPECT_EQ(log.GetCheckpointLsn(), second);
+  std::vector<std::string> payloads;
+  ASSERT_EQ(ReadAll(log, &payloads).size(), 1);
+  EXPECT_EQ(payloads[0], "new");
+}
+
+TEST_F(LogManagerTest, FirstChangeAfterCheckpointLogsPageImage) {
+  LogManager log(log_file_);
+  char page[PAGE_SIZE] = {'p'};
+
+  // NEW_PAGE is a whole page already
+  const lsn_t created = log.AppendPageChange(
+      LogRecordType::NEW_PAGE, 1, INVALID_SLOT_ID, INVALID_LSN, page);
+  const lsn_t first = log.AppendPageChange(LogRecordType::INSERT, 1, 0,
+                                           created, page, "a", 1);
+  EXPECT_EQ(log.GetPageImageCount(), 0);
+
+  // A page last changed before the checkpoint began gets an image
+  log.BeginCheckpoint();
+  const lsn_t imaged = log.AppendPageChange(LogRecordType::INSERT, 1, 1,
+                                            first, page, "b", 1);
+  log.AppendPageChange(LogRecordType::INSERT, 1, 2, imaged, page, "c", 1);
+  EXPECT_EQ(log.GetPageImageCount(), 1);
+
+  ASSERT_EQ(log.FlushAll().code, 0);
+  std::vector<std::string> payloads;
+  std::vector<LogRecord> records = ReadAll(log, &payloads);
+  ASSERT_EQ(records.size(), 4);
+  EXPECT_EQ(records[1].type, LogRecordType::INSERT);
+  EXPECT_EQ(records[2].type, LogRecordType::PAGE_IMAGE);
+  EXPECT_EQ(records[2].payload_size, PAGE_SIZE);
+  EXPECT_EQ(payloads[2][0], 'p');
+  EXPECT_EQ(records[3].type, LogRecordType::INSERT);
+  EXPECT_EQ(payloads[3], "c");
+}
+
+TEST_F(LogManagerTest, PageWriteFlushesLogFirst) {
+  LogManager log(log_file_);
+  DiskManager disk_manager(base_ + ".db", DurabilityMode::IMMEDIATE);
+  BufferPoolManager bpm(4, &disk_manager);
+  bpm.SetLogManager(&log);
+
+  page_id_t page_id;
+  Page* page = bpm.NewPage(&page_id);
+  ASSERT_NE(page, nullptr);
+  ASSERT_NE(page->InsertTuple("data", 4), INVALID_SLOT_ID);
+  const lsn_t lsn = log.Append(LogRecordType::INSERT, page_id, 0, "data", 4);
+  page->SetPageLsn(lsn);
+  bpm.UnpinPage(page_id, true);
+  EXPECT_LE(log.GetDurableLsn(), lsn);
+
+  ASSERT_EQ(bpm.FlushPage(page_id).code, 0);
+  EXPECT_GT(log.GetDurableLsn(), lsn);
+  // The log covers the page, so the write needs no fsync of its own
+  EXPECT_EQ(disk_manager.GetSyncCount(), 0);
+}
+
+TEST_F(LogManagerTest, RecoveryReplaysCommittedChanges) {
+  TupleId kept, updated, moved, deleted;
+  const std::string big(3000, 'b');
+  {
+    DiskManager disk_manager(base_ + ".db", DurabilityMode::BATCHED);
+    FreeSpaceMap fsm(base_ + ".fsm");
+    LogManager log(log_file_);
+    PageManager pm(&disk_manager, &fsm, 1, ReplacerType::LRU_K, &log);
+
+    kept = pm.InsertTuple("kept", 4);
+    updated = pm.InsertTuple("before", 6);
+    moved = pm.InsertTuple("small", 5);
+    deleted = pm.InsertTuple("doomed", 6);
+    // Fill the page so the big update has to forward
+    std::vector<TupleSlice> filler(3, TupleSlice{big.data(),
+                                                 static_cast<uint16_t>(
+                                                     big.size() - 1000)});
+    pm.InsertTuples(filler);
+    ASSERT_EQ(pm.UpdateTuple(updated, "after!", 6).code, 0);
+    ASSERT_EQ(pm.UpdateTuple(moved, big.data(), big.size()).code, 0);
+    ASSERT_EQ(pm.DeleteTuple(deleted).code, 0);
+
+    // Nothing but the log has been written since the PageManager opened
+    CopyForCrash();
+  }
+
+  for (int open = 0; open < 2; open++) {
+    DiskManager disk_manager(base_ + "_crash.db", DurabilityMode::BATCHED);
+    FreeSpaceMap fsm(base_ + "_crash.fsm");
+    LogManager log(base_ + "_crash.wal");
+    PageManager pm(&disk_manager, &fsm, 1, ReplacerType::LRU_K, &log);
+
+    EXPECT_EQ(ReadTuple(&pm, kept), "kept");
+    EXPECT_EQ(ReadTuple(&pm, updated), "after!");
+    EXPECT_EQ(ReadTuple(&pm, moved), big);
+    EXPECT_EQ(ReadTuple(&pm, deleted), "<missing>");
+
+    // Recovery checkpointed: a second open has nothing to replay
+    EXPECT_EQ(log.GetCheckpointLsn(), log.GetNextLsn() - 24);
+  }
+}
+
+TEST_F(LogManagerTest, RecoveryReplaysUpdatesMovedWithinPage) {
+  TupleId grown, last;
+  const std::string big(1500, 'g');
+  {
+    DiskManager disk_manager(base_ + ".db", DurabilityMode::BATCHED);
+    FreeSpaceMap fsm(base_ + ".fsm");
+    LogManager log(log_file_);
+    PageManager pm(&disk_manager, &fsm, 1, ReplacerType::LRU_K, &log);
+    ASSERT_EQ(pm.SetFillFactor(50).code, 0);
+
+    grown = pm.InsertTuple("grown", 5);
+    last = pm.InsertTuple("last", 4);
+    ASSERT_EQ(pm.UpdateTuple(grown, big.data(), big.size()).code, 0);
+    ASSERT_EQ(pm.UpdateTuple(last, "last, longer", 12).code, 0);
+    ASSERT_EQ(pm.GetMetrics().page_manager.moved_updates, 2u);
+
+    CopyForCrash();
+  }
+
+  DiskManager disk_manager(base_ + "_crash.db", DurabilityMode::BATCHED);
+  FreeSpaceMap fsm(base_ + "_crash.fsm");
+  LogManager log(base_ + "_crash.wal");
+  PageManager pm(&disk_manager, &fsm, 1, ReplacerType::LRU_K, &log);
+
+  EXPECT_EQ(ReadTuple(&pm, grown), big);
+  EXPECT_EQ(ReadTuple(&pm, last), "last, longer");
+  EXPECT_EQ(pm.GetMetrics().page_manager.forwarded_lookups, 0u);
+}
+
+TEST_F(LogManagerTest, RecoverySkipsPagesAlreadyWritten) {
+  std::vector<TupleId> tids;
+  {
+    DiskManager disk_manager(base_ + ".db", DurabilityMode::BATCHED);
+    FreeSpaceMap fsm(base_ + ".fsm");
+    LogManager log(log_file_);
+    PageManager pm(&disk_manager, &fsm, 1, ReplacerType::LRU_K, &log);
+
+    for (int i = 0; i < 20; i++) {
+      const std::string data = "tuple-" + std::to_string(i);
+      tids.push_back(pm.InsertTuple(data.c_str(), data.size()));
+    }
+    // Write the pages back without a checkpoint, then keep changing them
+    ASSERT_EQ(pm.FlushAllPages().code, 0);
+    const lsn_t flushed_at = log.GetNextLsn();
+    for (int i = 0; i < 20; i += 2) {
+      ASSERT_EQ(pm.DeleteTuple(tids[i]).code, 0);
+    }
+    ASSERT_EQ(pm.UpdateTuple(tids[1], "change1", 7).code, 0);
+
+    PageGuard page = PageGuard(pm.GetBufferPool(), tids[1].page_id,
+                               pm.GetBufferPool()->FetchPage(tids[1].page_id),
+                               LatchMode::SHARED);
+    ASSERT_TRUE(page);
+    EXPECT_GE(page->GetPageLsn(), flushed_at);
+    page.Release();
+
+    CopyForCrash();
+  }
+
+  DiskManager disk_manager(base_ + "_crash.db", DurabilityMode::BATCHED);
+  FreeSpaceMap fsm(base_ + "_crash.fsm");
+  LogManager log(base_ + "_crash.wal");
+  PageManager pm(&disk_manager, &fsm, 1, ReplacerType::LRU_K, &log);
+  for (int i = 0; i < 20; i++) {
+    const std::string expected =
+        i % 2 == 0 ? "<missing>"
+                   : (i == 1 ? "change1" : "tuple-" + std::to_string(i));
+    EXPECT_EQ(ReadTuple(&pm, tids[i]), expected) << "tuple " << i;
+  }
+}
+
+TEST_F(LogManagerTest, RecoveryRepairsTornPage) {
+  std::vector<TupleId> tids;
+  {
+    DiskManager disk_manager(base_ + ".db", DurabilityMode::BATCHED);
+    FreeSpaceMap fsm(base_ + ".fsm");
+    LogManager log(log_file_);
+    PageManager pm(&disk_manager, &fsm, 1, ReplacerType::LRU_K, &log);
+
+    const std::string data(500, 'd');
+    for (int i = 0; i < 10; i++) {
+      tids.push_back(pm.InsertTuple(data.c_str(), data.size()));
+    }
+    ASSERT_EQ(pm.Checkpoint().code, 0);
+
+    const uint64_t images = log.GetPageImageCount();
+    const std::string updated(500, 'u');
+    ASSERT_EQ(pm.UpdateTuple(tids[0], updated.c_str(), updated.size()).code,
+              0);
+    ASSERT_EQ(pm.UpdateTuple(tids[9], updated.c_str(), updated.size()).code,
+              0);
+    EXPECT_EQ(log.GetPageImageCount(), images + 1);
+
+    ASSERT_EQ(pm.FlushAllPages().code, 0);
+    CopyForCrash();
+  }
+
+  // Keep only the first 4 KB sector of the page's last write
+  {
+    FILE* file = fopen((base_ + "_crash.db").c_str(), "r+b");
+    ASSERT_NE(file, nullptr);
+    const std::string stale(PAGE_SIZE / 2, 'd');
+    fseek(file, static_cast<long>(tids[0].page_id * PAGE_SIZE + PAGE_SIZE / 2),
+          SEEK_SET);
+    fwrite(stale.data(), 1, stale.size(), file);
+    fclose(file);
+  }
+
+  DiskManager disk_manager(base_ + "_crash.db", DurabilityMode::BATCHED);
+  FreeSpaceMap fsm(base_ + "_crash.fsm");
+  LogManager log(base_ + "_crash.wal");
+  PageManager pm(&disk_manager, &fsm, 1, ReplacerType::LRU_K, &log);
+  for (int i = 0; i < 10; i++) {
+    const char expected = i == 0 || i == 9 ? 'u' : 'd';
+    EXPECT_EQ(ReadTuple(&pm, tids[i]), std::string(500, expected))
+        << "tuple " << i;
+  }
+}
@@ -6,6 +6,9 @@
 #include <filesystem>
 #include <fstream>
 #include <thread>
+#include <vector>
+
+#include "common/ring_buffer.h"
 
 class LoggerTest : public ::testing::Test {
  protected:
@@ -24,6 +27,8 @@ class LoggerTest : public ::testing::Test {
   }
 
   void TearDown() override {
+    storage::Logger::getInstance().disableAsync();
+
     // Clean up test logs
     if (std::filesystem::exists(testLogDir_)) {
       std::filesystem::remove_all(testLogDir_);
@@ -218,4 +223,175 @@ TEST_F(LoggerTest, ThreadSafety) {
 
   // Should have exactly numThreads * messagesPerThread messages
   EXPECT_EQ(count, numThreads * messagesPerThread);
-}
\ No newline at end of file
+}
+// Disabled levels must not evaluate (and therefore not format) the message
+TEST_F(LoggerTest, DisabledLevelSkipsFormatting) {
+  auto& logger = storage::Logger::getInstance();
+  logger.setDebugMode(false);
+
+  int evaluations = 0;
+  auto expensive = [&evaluations]() {
+    evaluations++;
+    return std::string("expensive");
+  };
+
+  EXPECT_FALSE(logger.isEnabled(storage::LogLevel::INFO));
+  LOG_INFO_STREAM("Value: " << expensive());
+  LOG_INFO(expensive());
+  LOG_INFO_F("Value: %s", expensive().c_str());
+  EXPECT_EQ(evaluations, 0);
+
+  // Enabled levels still format
+  EXPECT_TRUE(logger.isEnabled(storage::LogLevel::WARNING));
+  LOG_WARNING_STREAM("Value: " << expensive());
+  EXPECT_EQ(evaluations, 1);
+}
+
+// printf-style macros
+TEST_F(LoggerTest, FormatStyleLogging) {
+  auto& logger = storage::Logger::getInstance();
+  logger.setDebugMode(true);
+
+  LOG_INFO_F("Page %u has %d free bytes", 7u, 128);
+  LOG_ERROR_F("Error code: %s", "E42");
+
+  std::string logContent = readLogFile();
+  EXPECT_TRUE(logContent.find("Page 7 has 128 free bytes") !=
+              std::string::npos);
+  EXPECT_TRUE(logContent.find("Error code: E42") != std::string::npos);
+}
+
+TEST_F(LoggerTest, CompileTimeMinimumLevel) {
+  // ERROR can never be compiled out; INFO is kept in debug builds only
+  EXPECT_TRUE(storage::IsLogLevelCompiledIn(storage::LogLevel::ERROR));
+#ifdef NDEBUG
+  EXPECT_FALSE(storage::IsLogLevelCompiledIn(storage::LogLevel::INFO));
+#else
+  EXPECT_TRUE(storage::IsLogLevelCompiledIn(storage::LogLevel::INFO));
+#endif
+}
+
+size_t CountOccurrences(const std::string& haystack, const std::string& needle) {
+  size_t count = 0;
+  size_t pos = 0;
+  while ((pos = haystack.find(needle, pos)) != std::string::npos) {
+    count++;
+    pos++;
+  }
+  return count;
+}
+
+// ============================================================================
+// Async Logger Tests
+// ============================================================================
+
+TEST(MpscRingBufferTest, FifoAndFullDetection) {
+  storage::MpscRingBuffer<int> ring(3);
+  EXPECT_EQ(ring.Capacity(), 4);  // rounded up to a power of two
+
+  for (int i = 0; i < 4; i++) {
+    EXPECT_TRUE(ring.TryPush(int(i)));
+  }
+  EXPECT_FALSE(ring.TryPush(99));
+
+  int value;
+  for (int i = 0; i < 4; i++) {
+    ASSERT_TRUE(ring.TryPop(&value));
+    EXPECT_EQ(value, i);
+  }
+  EXPECT_FALSE(ring.TryPop(&value));
+  EXPECT_THROW(storage::MpscRingBuffer<int>(0), std::invalid_argument);
+}
+
+TEST(MpscRingBufferTest, ConcurrentProducers) {
+  storage::MpscRingBuffer<int> ring(64);
+  const int num_threads = 4;
+  const int per_thread = 1000;
+
+  std::vector<std::thread> producers;
+  for (int t = 0; t < num_threads; t++) {
+    producers.emplace_back([&ring]() {
+      for (int i = 1; i <= per_thread; i++) {
+        while (!ring.TryPush(int(i))) {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+
+  long long sum = 0;
+  int popped = 0;
+  int value;
+  while (popped < num_threads * per_thread) {
+    if (ring.TryPop(&value)) {
+      sum += value;
+      popped++;
+    } else {
+      std::this_thread::yield();
+    }
+  }
+  for (auto& producer : producers) {
+    producer.join();
+  }
+
+  EXPECT_EQ(sum, 1LL * num_threads * per_thread * (per_thread + 1) / 2);
+}
+
+TEST_F(LoggerTest, AsyncModeWritesEveryRecord) {
+  auto& logger = storage::Logger::getInstance();
+  logger.setDebugMode(true);
+  logger.enableAsync(64, storage::LogOverflowPolicy::BLOCK);
+  EXPECT_TRUE(logger.isAsync());
+
+  std::vector<std::thread> threads;
+  const int numThreads = 8;
+  const int messagesPerThread = 100;
+  for (int i = 0; i < numThreads; i++) {
+    threads.emplace_back([i]() {
+      for (int j = 0; j < messagesPerThread; j++) {
+        LOG_INFO_STREAM("Async thread " << i << " message " << j);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  logger.flush();
+  EXPECT_EQ(CountOccurrences(readLogFile(), "Async thread"),
+            numThreads * messagesPerThread);
+}
+
+TEST_F(LoggerTest, AsyncDropPolicyCountsDroppedRecords) {
+  auto& logger = storage::Logger::getInstance();
+  logger.setDebugMode(true);
+  const uint64_t dropped_before = logger.getDroppedCount();
+  logger.enableAsync(4, storage::LogOverflowPolicy::DROP);
+
+  const int total = 2000;
+  for (int i = 0; i < total; i++) {
+    LOG_INFO_STREAM("Drop test " << i);
+  }
+  logger.flush();
+
+  // Every record is either written or counted as dropped, never both
+  const uint64_t dropped = logger.getDroppedCount() - dropped_before;
+  EXPECT_EQ(CountOccurrences(readLogFile(), "Drop test") + dropped, total);
+}
+
+TEST_F(LoggerTest, DisableAsyncDrainsPendingRecords) {
+  auto& logger = storage::Logger::getInstance();
+  logger.setDebugMode(true);
+  logger.enableAsync(1024, storage::LogOverflowPolicy::BLOCK);
+
+  for (int i = 0; i < 200; i++) {
+    LOG_INFO_STREAM("Shutdown drain " << i);
+  }
+  logger.disableAsync();
+  EXPECT_FALSE(logger.isAsync());
+  EXPECT_EQ(CountOccurrences(readLogFile(), "Shutdown drain"), 200);
+
+  // Back to synchronous writes
+  LOG_INFO("After async");
+  EXPECT_NE(readLogFile().find("After async"), std::string::npos);
+}
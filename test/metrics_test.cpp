@@ -0,0 +1,174 @@
+#include "../include/common/metrics.h"
+
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <filesystem>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "../include/storage/disk_manager.h"
+#include "../include/storage/free_space_map.h"
+#include "../include/storage/page_manager.h"
+
+namespace fs = std::filesystem;
+
+class MetricsTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    fs::create_directories("/tmp/test");
+    const std::string base =
+        "/tmp/test/metrics_test_" +
+        std::to_string(
+            std::chrono::system_clock::now().time_since_epoch().count());
+    db_file_ = base + ".db";
+    fsm_file_ = base + ".fsm";
+  }
+
+  void TearDown() override {
+    fs::remove(db_file_);
+    fs::remove(fsm_file_);
+  }
+
+  std::string db_file_;
+  std::string fsm_file_;
+};
+
+TEST_F(MetricsTest, CountsCacheAndDiskActivity) {
+  DiskManager dm(db_file_, DurabilityMode::BATCHED);
+  FreeSpaceMap fsm(fsm_file_);
+  PageManager pm(&dm, &fsm, 1);  // 128 frames
+
+  // Well over 128 pages of tuples: the pool has to evict
+  std::vector<TupleId> ids;
+  const std::string tuple(1000, 'x');
+  for (int i = 0; i < 3000; i++) {
+    ids.push_back(pm.InsertTuple(tuple.data(), tuple.size()));
+    ASSERT_NE(ids.back().slot_id, INVALID_SLOT_ID);
+  }
+  ASSERT_EQ(pm.FlushAllPages().code, 0);
+
+  StorageMetrics after_load = pm.GetMetrics();
+  EXPECT_GT(after_load.buffer_pool.dirty_evictions, 0u);
+  EXPECT_GE(after_load.disk.page_writes, ids.back().page_id - 1u);
+  EXPECT_EQ(after_load.disk.write_latency.GetCount(),
+            after_load.disk.page_writes);
+  EXPECT_GE(after_load.disk.syncs, 1u);
+  EXPECT_EQ(after_load.disk.sync_latency.GetCount(), after_load.disk.syncs);
+  EXPECT_GT(after_load.fsm.searches, 0u);
+  EXPECT_EQ(after_load.buffer_pool.pool_size, 128u);
+
+  // Per-node occupancy adds up to the pool; every frame was taken somewhere
+  size_t node_frames = 0;
+  size_t node_resident = 0;
+  for (const BufferPoolNodeMetrics& node : after_load.buffer_pool.numa_nodes) {
+    node_frames += node.frames;
+    node_resident += node.resident_pages;
+  }
+  EXPECT_EQ(node_frames, 128u);
+  EXPECT_EQ(node_resident, after_load.buffer_pool.resident_pages);
+  EXPECT_GE(after_load.buffer_pool.local_frame_acquires +
+                after_load.buffer_pool.remote_frame_acquires,
+            static_cast<uint64_t>(ids.back().page_id));
+
+  // Cold reads miss once per page, every later fetch of the page hits
+  pm.ClearCache();
+  char buffer[1000];
+  const StorageMetrics before = pm.GetMetrics();
+  std::set<page_id_t> pages;
+  for (int i = 0; i < 100; i++) {
+    ASSERT_EQ(pm.GetTuple(ids[i], buffer, sizeof(buffer)).code, 0);
+    pages.insert(ids[i].page_id);
+  }
+  const StorageMetrics after = pm.GetMetrics();
+  EXPECT_EQ(after.buffer_pool.misses - before.buffer_pool.misses,
+            pages.size());
+  EXPECT_GE(after.buffer_pool.hits - before.buffer_pool.hits,
+            100u - pages.size());
+  EXPECT_EQ(after.disk.page_reads - before.disk.page_reads, pages.size());
+  EXPECT_EQ(after.disk.read_latency.GetCount(), after.disk.page_reads);
+  EXPECT_GT(after.buffer_pool.GetHitRate(), 0.0);
+  EXPECT_LT(after.buffer_pool.GetHitRate(), 1.0);
+}
+
+TEST_F(MetricsTest, CountsForwardingAndCompaction) {
+  DiskManager dm(db_file_);
+  FreeSpaceMap fsm(fsm_file_);
+  PageManager pm(&dm, &fsm);
+
+  // Fill a page, then grow one tuple so it has to move
+  std::vector<TupleId> ids;
+  const std::string small(500, 's');
+  for (int i = 0; i < 15; i++) {
+    ids.push_back(pm.InsertTuple(small.data(), small.size()));
+  }
+  ASSERT_EQ(ids.front().page_id, ids.back().page_id);
+  const std::string large(4000, 'L');
+  ASSERT_EQ(pm.UpdateTuple(ids[0], large.data(), large.size()).code, 0);
+
+  const uint64_t lookups = pm.GetMetrics().page_manager.forwarded_lookups;
+  char buffer[4000];
+  ASSERT_EQ(pm.GetTuple(ids[0], buffer, sizeof(buffer)).code, 0);
+  const PageManagerMetrics metrics = pm.GetMetrics().page_manager;
+  EXPECT_EQ(metrics.forwarded_lookups, lookups + 1);
+  EXPECT_GE(metrics.forwarding_hops, metrics.forwarded_lookups);
+
+  for (int i = 1; i < 10; i++) {
+    ASSERT_EQ(pm.DeleteTuple(ids[i]).code, 0);
+  }
+  ASSERT_EQ(pm.CompactPage(ids[1].page_id).code, 0);
+  EXPECT_EQ(pm.GetMetrics().page_manager.compactions, 1u);
+}
+
+TEST_F(MetricsTest, CountsChecksumFailures) {
+  page_id_t page_id;
+  {
+    DiskManager dm(db_file_);
+    page_id = dm.AllocatePage();
+    std::vector<char> page(PAGE_SIZE, 0);
+    dm.WritePage(page_id, page.data());
+  }
+
+  // Flip a byte in the page body
+  int fd = open(db_file_.c_str(), O_RDWR);
+  ASSERT_GE(fd, 0);
+  const char garbage = 0x5A;
+  ASSERT_EQ(pwrite(fd, &garbage, 1,
+                   static_cast<off_t>(page_id) * PAGE_SIZE + 1000),
+            1);
+  close(fd);
+
+  DiskManager dm(db_file_);
+  std::vector<char> page(PAGE_SIZE);
+  EXPECT_THROW(dm.ReadPage(page_id, page.data()), std::runtime_error);
+  EXPECT_EQ(dm.GetMetrics().checksum_failures, 1u);
+}
+
+TEST(MetricsFormatTest, RendersPrometheusText) {
+  StorageMetrics metrics;
+  metrics.buffer_pool.hits = 3;
+  metrics.buffer_pool.misses = 1;
+  metrics.disk.page_reads = 1;
+  metrics.disk.read_latency.Record(2000);
+  metrics.buffer_pool.numa_nodes = {{64, 10}, {64, 20}};
+
+  const std::string text = FormatMetrics(metrics);
+  EXPECT_NE(text.find("storage_buffer_pool_node_frames{node=\"1\"} 64\n"),
+            std::string::npos);
+  EXPECT_NE(
+      text.find("storage_buffer_pool_node_resident_pages{node=\"0\"} 10\n"),
+      std::string::npos);
+  EXPECT_NE(text.find("# TYPE storage_buffer_pool_hits_total counter\n"
+                      "storage_buffer_pool_hits_total 3\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("storage_buffer_pool_hit_rate 0.75\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("storage_disk_read_latency_ns{quantile=\"0.99\"} 2000\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("storage_disk_read_latency_ns_count 1\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("storage_compactions_total 0\n"), std::string::npos);
+}
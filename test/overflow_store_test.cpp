@@ -0,0 +1,289 @@
+#include "../include/storage/overflow_store.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../include/storage/disk_manager.h"
+#include "../include/storage/page_manager.h"
+#include "../include/tuple/tuple_accessor.h"
+#include "../include/tuple/tuple_builder.h"
+#include "../include/tuple/tuple_serializer.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+std::string Text(size_t size, char seed) {
+  std::string text(size, '\0');
+  for (size_t i = 0; i < size; i++) {
+    text[i] = static_cast<char>(seed + i % 23);
+  }
+  return text;
+}
+
+// Counts the calls made to the store it wraps
+class CountingStore : public OverflowValueStore {
+ public:
+  explicit CountingStore(OverflowValueStore* store) : store_(store) {}
+
+  ErrorCode Write(std::string_view value, OverflowPointer* pointer) override {
+    writes++;
+    return store_->Write(value, pointer);
+  }
+  ErrorCode Read(const OverflowPointer& pointer,
+                 std::string* value) const override {
+    reads++;
+    return store_->Read(pointer, value);
+  }
+  ErrorCode Free(const OverflowPointer& pointer) override {
+    frees++;
+    return store_->Free(pointer);
+  }
+
+  int writes = 0;
+  mutable int reads = 0;
+  int frees = 0;
+
+ private:
+  OverflowValueStore* store_;
+};
+
+}  // namespace
+
+class OverflowStoreTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    fs::create_directories("/tmp/test");
+    base_ = "/tmp/test/overflow_store_test_" +
+            std::to_string(
+                std::chrono::system_clock::now().time_since_epoch().count());
+    disk_manager_ = std::make_unique<DiskManager>(base_ + ".ovf");
+    bpm_ = std::make_unique<BufferPoolManager>(64, disk_manager_.get());
+    store_ = std::make_unique<OverflowStore>(bpm_.get());
+
+    schema_.AddColumn("id", DataType::INTEGER, false, 0);
+    schema_.AddColumn("title", DataType::VARCHAR, false, 64);
+    schema_.AddColumn("body", DataType::TEXT, true, 0);
+    schema_.AddColumn("image", DataType::BLOB, true, 0);
+    schema_.Finalize();
+  }
+
+  void TearDown() override {
+    store_.reset();
+    bpm_.reset();
+    disk_manager_.reset();
+    for (const char* suffix : {".ovf", ".db", ".fsm"}) {
+      std::remove((base_ + suffix).c_str());
+    }
+  }
+
+  // Serialized row; body and image are left NULL when empty
+  std::vector<char> Row(int id, const std::string& body,
+                        const std::vector<uint8_t>& image,
+                        OverflowValueStore* store) {
+    TupleBuilder builder(schema_);
+    builder.SetInteger("id", id).SetVarChar("title", "row " +
+                                                         std::to_string(id));
+    if (body.empty()) {
+      builder.SetNull("body");
+    } else {
+      builder.SetText("body", body);
+    }
+    if (image.empty()) {
+      builder.SetNull("image");
+    } else {
+      builder.SetBlob("image", image);
+    }
+    std::vector<char> row(PAGE_SIZE);
+    row.resize(TupleSerializer::Serialize(schema_, builder.BuildRefs(),
+                                          row.data(), row.size(), store));
+    return row;
+  }
+
+  std::string base_;
+  std::unique_ptr<DiskManager> disk_manager_;
+  std::unique_ptr<BufferPoolManager> bpm_;
+  std::unique_ptr<OverflowStore> store_;
+  Schema schema_;
+};
+
+TEST_F(OverflowStoreTest, ChainsRoundTripAndFreedPagesAreReused) {
+  const std::vector<size_t> sizes = {1, OVERFLOW_PAGE_CAPACITY,
+                                     OVERFLOW_PAGE_CAPACITY + 1, 100000};
+  std::vector<OverflowPointer> pointers;
+  for (size_t size : sizes) {
+    OverflowPointer pointer{};
+    ASSERT_EQ(store_->Write(Text(size, 'a'), &pointer).code, 0);
+    EXPECT_EQ(pointer.length, size);
+    pointers.push_back(pointer);
+  }
+  EXPECT_EQ(OverflowStore::PagesFor(100000), 13u);
+  const page_id_t next_page_id = disk_manager_->GetNextPageId();
+
+  // Written through: the chains survive dropping the pool
+  ASSERT_EQ(bpm_->EvictAllPages().code, 0);
+  for (size_t i = 0; i < sizes.size(); i++) {
+    std::string value;
+    ASSERT_EQ(store_->Read(pointers[i], &value).code, 0);
+    EXPECT_EQ(value, Text(sizes[i], 'a')) << sizes[i];
+  }
+
+  ASSERT_EQ(store_->Free(pointers.back()).code, 0);
+  OverflowPointer reused{};
+  ASSERT_EQ(store_->Write(Text(90000, 'k'), &reused).code, 0);
+  EXPECT_EQ(disk_manager_->GetNextPageId(), next_page_id);
+  std::string value;
+  ASSERT_EQ(store_->Read(reused, &value).code, 0);
+  EXPECT_EQ(value, Text(90000, 'k'));
+
+  EXPECT_NE(store_->Write("", &reused).code, 0);
+}
+
+TEST_F(OverflowStoreTest, DamagedChainsFailToRead) {
+  OverflowPointer pointer{};
+  ASSERT_EQ(store_->Write(Text(20000, 'a'), &pointer).code, 0);
+
+  std::string value;
+  OverflowPointer wrong_length = pointer;
+  wrong_length.length = 30000;
+  EXPECT_NE(store_->Read(wrong_length, &value).code, 0);
+
+  // Second page of the chain is not a chain start
+  OverflowPointer middle = pointer;
+  middle.first_page_id = pointer.first_page_id + 1;
+  EXPECT_NE(store_->Read(middle, &value).code, 0);
+
+  // Not an overflow page at all
+  page_id_t data_page_id = INVALID_PAGE_ID;
+  ASSERT_NE(bpm_->NewPage(&data_page_id), nullptr);
+  bpm_->UnpinPage(data_page_id, true);
+  EXPECT_NE(store_->Read({data_page_id, 100}, &value).code, 0);
+}
+
+TEST_F(OverflowStoreTest, SerializerMovesOnlyLargeValuesOutOfLine) {
+  const std::string body = Text(50000, 'b');
+  const std::vector<uint8_t> image(3000, 0x7F);
+  const std::string small_body = Text(OVERFLOW_VALUE_THRESHOLD, 's');
+
+  std::vector<char> row = Row(1, body, image, store_.get());
+  EXPECT_LT(row.size(), 100u);
+  std::vector<OverflowPointer> pointers;
+  TupleSerializer::GetOverflowPointers(schema_, row.data(), row.size(),
+                                       &pointers);
+  ASSERT_EQ(pointers.size(), 2u);
+  EXPECT_EQ(pointers[0].length, body.size());
+
+  // At the threshold a value stays inline
+  std::vector<char> inline_row = Row(2, small_body, {}, store_.get());
+  EXPECT_GT(inline_row.size(), OVERFLOW_VALUE_THRESHOLD);
+  pointers.clear();
+  TupleSerializer::GetOverflowPointers(schema_, inline_row.data(),
+                                       inline_row.size(), &pointers);
+  EXPECT_TRUE(pointers.empty());
+
+  std::vector<FieldValue> values = TupleSerializer::DeserializeVariableLength(
+      schema_, row.data(), row.size(), store_.get());
+  EXPECT_EQ(values[2].GetString(), body);
+  EXPECT_EQ(values[3].GetBlob(), image);
+  EXPECT_THROW(TupleSerializer::DeserializeVariableLength(schema_, row.data(),
+                                                          row.size()),
+               std::runtime_error);
+
+  Arena arena;
+  std::vector<ValueRef> refs;
+  TupleSerializer::Deserialize(schema_, row.data(), row.size(), &arena, &refs,
+                               store_.get());
+  EXPECT_EQ(refs[2].GetString(), body);
+  EXPECT_THROW(TupleSerializer::Deserialize(schema_, row.data(), row.size(),
+                                            nullptr, &refs, store_.get()),
+               std::runtime_error);
+
+  // Without a store, values this long cannot be serialized at all
+  EXPECT_THROW(Row(3, Text(70000, 'x'), {}, nullptr), std::runtime_error);
+}
+
+TEST_F(OverflowStoreTest, FailedSerializationFreesStoredValues) {
+  CountingStore counting(store_.get());
+  TupleBuilder builder(schema_);
+  builder.SetInteger("id", 1)
+      .SetVarChar("title", "t")
+      .SetText("body", Text(10000, 'b'))
+      .SetBlob("image", std::vector<uint8_t>(10000, 1));
+  // Room for the title and the body's pointer, not the image's
+  const size_t variable_start = (schema_.GetFixedSectionEnd() + 7) / 8 * 8;
+  std::vector<char> row(variable_start + 3 + OVERFLOW_FIELD_SIZE + 4);
+  EXPECT_THROW(TupleSerializer::Serialize(schema_, builder.BuildRefs(),
+                                          row.data(), row.size(), &counting),
+               std::runtime_error);
+  EXPECT_EQ(counting.writes, 1);
+  EXPECT_EQ(counting.frees, 1);
+}
+
+TEST_F(OverflowStoreTest, AccessorFetchesValuesLazilyOnce) {
+  CountingStore counting(store_.get());
+  const std::string body = Text(30000, 'c');
+  std::vector<char> row = Row(7, body, {}, &counting);
+
+  TupleAccessor accessor(schema_, row.data(), row.size(), &counting);
+  EXPECT_EQ(accessor.GetInteger("id"), 7);
+  EXPECT_EQ(accessor.GetString("title"), "row 7");
+  EXPECT_TRUE(accessor.IsNull("image"));
+  EXPECT_EQ(counting.reads, 0);
+
+  EXPECT_TRUE(accessor.IsStoredOutOfLine(2));
+  EXPECT_FALSE(accessor.IsStoredOutOfLine(1));
+  EXPECT_EQ(accessor.GetStringView("body"), body);
+  EXPECT_EQ(accessor.GetString("body"), body);
+  EXPECT_EQ(accessor.GetFieldValue("body").GetString(), body);
+  EXPECT_EQ(counting.reads, 1);
+
+  TupleAccessor without_store(schema_, row.data(), row.size());
+  EXPECT_EQ(without_store.GetString("title"), "row 7");
+  EXPECT_THROW(without_store.GetString("body"), std::runtime_error);
+}
+
+TEST_F(OverflowStoreTest, PageManagerFreesValuesOfDeletedAndUpdatedTuples) {
+  DiskManager table_dm(base_ + ".db");
+  FreeSpaceMap fsm(base_ + ".fsm");
+  PageManager pm(&table_dm, &fsm);
+  CountingStore counting(store_.get());
+  pm.SetOverflowStore(schema_, &counting);
+
+  // Rows far larger than a page fit in one slot
+  std::vector<char> row = Row(1, Text(40000, 'a'), {}, &counting);
+  const TupleId tid =
+      pm.InsertTuple(row.data(), static_cast<uint16_t>(row.size()));
+  ASSERT_NE(tid.slot_id, INVALID_SLOT_ID);
+
+  PinnedTuple view;
+  ASSERT_EQ(pm.GetTupleView(tid, &view).code, 0);
+  {
+    TupleAccessor accessor(schema_, view.Data(), view.Size(), &counting);
+    EXPECT_EQ(accessor.GetString("body"), Text(40000, 'a'));
+  }
+  view.Release();
+
+  // A new version pointing at the same body keeps it
+  ASSERT_EQ(
+      pm.UpdateTuple(tid, row.data(), static_cast<uint16_t>(row.size())).code,
+      0);
+  EXPECT_EQ(counting.frees, 0);
+
+  // A new body replaces the old chain
+  std::vector<char> rewritten = Row(1, Text(20000, 'z'), {}, &counting);
+  ASSERT_EQ(pm.UpdateTuple(tid, rewritten.data(),
+                           static_cast<uint16_t>(rewritten.size()))
+                .code,
+            0);
+  EXPECT_EQ(counting.frees, 1);
+
+  ASSERT_EQ(pm.DeleteTuple(tid).code, 0);
+  EXPECT_EQ(counting.frees, 2);
+  EXPECT_EQ(counting.writes, counting.frees);
+}
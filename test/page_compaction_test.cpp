@@ -580,3 +580,46 @@ TEST(PageCompactionEdgeCaseTest, AlternatingInsertDelete) {
 
   EXPECT_TRUE(page->VerifyChecksum());
 }
+
+TEST(PageCompactionEdgeCaseTest, CompactIntoCallerScratch) {
+  auto page = Page::CreateNew();
+  ASSERT_NE(page, nullptr);
+
+  std::vector<slot_id_t> slots;
+  for (int i = 0; i < 6; i++) {
+    std::string data = "Tuple" + std::to_string(i);
+    slots.push_back(page->InsertTuple(data.c_str(), data.length() + 1));
+  }
+  for (int i = 0; i < 6; i += 2) {
+    ASSERT_EQ(page->DeleteTuple(slots[i]).code, 0);
+  }
+
+  std::vector<char> scratch(PAGE_SIZE);
+  page->CompactPage(scratch.data());
+
+  EXPECT_EQ(page->GetFragmentedBytes(), 0);
+  for (int i = 1; i < 6; i += 2) {
+    ASSERT_TRUE(page->IsSlotValid(slots[i]));
+    SlotEntry entry = page->GetSlotEntry(slots[i]);
+    EXPECT_STREQ(page->GetRawBuffer() + entry.offset,
+                 ("Tuple" + std::to_string(i)).c_str());
+  }
+  EXPECT_TRUE(page->VerifyChecksum());
+}
+
+TEST(PageCompactionEdgeCaseTest, ReusingClearedSlotKeepsCounters) {
+  auto page = Page::CreateNew();
+  ASSERT_NE(page, nullptr);
+
+  slot_id_t first = page->InsertTuple("first", 6);
+  page->InsertTuple("second", 7);
+  ASSERT_EQ(page->DeleteTuple(first).code, 0);
+  page->CompactPage();
+  ASSERT_EQ(page->GetDeletedTupleCount(), 0);
+
+  // The cleared slot is reused without counting it as reclaimed twice
+  EXPECT_EQ(page->InsertTuple("again", 6), first);
+  EXPECT_EQ(page->GetDeletedTupleCount(), 0);
+  EXPECT_EQ(page->GetFragmentedBytes(), 0);
+  EXPECT_FALSE(page->ShouldCompact());
+}
@@ -2,13 +2,21 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cstring>
+#include <functional>
 #include <random>
+#include <set>
+#include <thread>
 #include <vector>
 
 #include "../include/common/logger.h"
 #include "../include/storage/disk_manager.h"
 #include "../include/storage/free_space_map.h"
+#include "../include/tuple/tuple_accessor.h"
+#include "../include/tuple/tuple_builder.h"
+#include "../include/tuple/tuple_serializer.h"
 
 // Test fixture for PageManager tests
 class PageManagerTest : public ::testing::Test {
@@ -156,15 +164,72 @@ TEST_F(PageManagerTest, UpdateTupleWithForwarding) {
   TupleId tid = page_manager_->InsertTuple(original_data, original_size);
   ASSERT_NE(tid.slot_id, INVALID_SLOT_ID);
 
-  // Update with larger data (should create forwarding chain)
+  // Update with larger data (moves within the page, which has room)
   ErrorCode update_result = page_manager_->UpdateTuple(tid, new_data, new_size);
   EXPECT_EQ(update_result.code, 0);
 
-  // Retrieve using original TupleId (should follow chain)
+  // Retrieve using original TupleId
   char buffer[200];
   ErrorCode get_result = page_manager_->GetTuple(tid, buffer, sizeof(buffer));
   EXPECT_EQ(get_result.code, 0);
   EXPECT_STREQ(buffer, new_data);
+  EXPECT_EQ(page_manager_->GetMetrics().page_manager.moved_updates, 1u);
+  EXPECT_EQ(page_manager_->GetMetrics().page_manager.forwarded_updates, 0u);
+}
+
+TEST_F(PageManagerTest, SetFillFactorRejectsOutOfRange) {
+  EXPECT_EQ(page_manager_->GetFillFactor(), DEFAULT_TABLE_FILL_FACTOR);
+  EXPECT_NE(page_manager_->SetFillFactor(MIN_TABLE_FILL_FACTOR - 1).code, 0);
+  EXPECT_NE(page_manager_->SetFillFactor(101).code, 0);
+  EXPECT_EQ(page_manager_->GetFillFactor(), DEFAULT_TABLE_FILL_FACTOR);
+  EXPECT_EQ(page_manager_->SetFillFactor(70).code, 0);
+  EXPECT_EQ(page_manager_->GetFillFactor(), 70);
+}
+
+TEST_F(PageManagerTest, FillFactorKeepsGrowingUpdatesOnTheirPage) {
+  ASSERT_EQ(page_manager_->SetFillFactor(80).code, 0);
+  const size_t reserve = PAGE_SIZE * 20 / 100;
+
+  std::vector<TupleId> ids;
+  const std::string row(200, 'r');
+  for (int i = 0; i < 100; i++) {
+    ids.push_back(page_manager_->InsertTuple(row.c_str(), row.size()));
+    ASSERT_NE(ids.back().slot_id, INVALID_SLOT_ID);
+  }
+  const page_id_t first_page_id = ids.front().page_id;
+  ASSERT_NE(ids.back().page_id, first_page_id);
+
+  // Inserts stopped short of the reserve, and the FSM does not offer it
+  BufferPoolManager* bpm = page_manager_->GetBufferPool();
+  size_t free_space;
+  {
+    PageGuard page(bpm, first_page_id, bpm->FetchPage(first_page_id),
+                   LatchMode::SHARED);
+    free_space = page->GetFreeEnd() - page->GetFreeStart();
+  }
+  EXPECT_GE(free_space, reserve);
+  EXPECT_LT(free_space, reserve + row.size() + SLOT_ENTRY_SIZE);
+  EXPECT_EQ(fsm_->GetCategory(first_page_id),
+            FreeSpaceMap::BytesToCategory(
+                static_cast<uint16_t>(free_space - reserve)));
+
+  // Grown rows move into the reserve instead of off the page
+  const std::string grown(row.size() + 40, 'g');
+  const size_t updates = reserve / grown.size();
+  for (size_t i = 0; i < updates; i++) {
+    ASSERT_EQ(ids[i].page_id, first_page_id);
+    ASSERT_EQ(
+        page_manager_->UpdateTuple(ids[i], grown.c_str(), grown.size()).code,
+        0);
+  }
+  const PageManagerMetrics metrics = page_manager_->GetMetrics().page_manager;
+  EXPECT_EQ(metrics.moved_updates, updates);
+  EXPECT_EQ(metrics.forwarded_updates, 0u);
+
+  PinnedTuple tuple;
+  ASSERT_EQ(page_manager_->GetTupleView(ids.front(), &tuple).code, 0);
+  EXPECT_EQ(tuple.GetTupleId(), ids.front());
+  EXPECT_EQ(std::string(tuple.Data(), tuple.Size()), grown);
 }
 
 // ============================================================================
@@ -535,3 +600,665 @@ TEST_F(PageManagerTest, FSMSynchronization) {
   ErrorCode flush_result = page_manager_->FlushAllPages();
   EXPECT_EQ(flush_result.code, 0);
 }
+
+// ============================================================================
+// Concurrency Tests
+// ============================================================================
+
+TEST_F(PageManagerTest, ConcurrentReadersAndWriters) {
+  // Seed tuples spread over several pages
+  std::vector<TupleId> seeded;
+  char data[400];
+  for (int i = 0; i < 100; i++) {
+    snprintf(data, sizeof(data), "seed-%03d", i);
+    TupleId tid = page_manager_->InsertTuple(data, sizeof(data));
+    ASSERT_NE(tid.slot_id, INVALID_SLOT_ID);
+    seeded.push_back(tid);
+  }
+
+  const int num_readers = 4;
+  const int num_writers = 2;
+  std::atomic<int> read_failures{0};
+  std::atomic<int> write_failures{0};
+  std::vector<std::thread> threads;
+
+  for (int r = 0; r < num_readers; r++) {
+    threads.emplace_back([&, r]() {
+      char buffer[512];
+      char expected[32];
+      for (int round = 0; round < 5; round++) {
+        for (size_t i = r; i < seeded.size(); i += num_readers) {
+          ErrorCode result =
+              page_manager_->GetTuple(seeded[i], buffer, sizeof(buffer));
+          snprintf(expected, sizeof(expected), "seed-%03zu", i);
+          if (result.code != 0 || strcmp(buffer, expected) != 0) {
+            read_failures++;
+          }
+        }
+      }
+    });
+  }
+
+  for (int w = 0; w < num_writers; w++) {
+    threads.emplace_back([&, w]() {
+      char payload[400];
+      for (int i = 0; i < 50; i++) {
+        snprintf(payload, sizeof(payload), "writer-%d-%d", w, i);
+        TupleId tid = page_manager_->InsertTuple(payload, sizeof(payload));
+        if (tid.slot_id == INVALID_SLOT_ID) {
+          write_failures++;
+        }
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(read_failures.load(), 0);
+  EXPECT_EQ(write_failures.load(), 0);
+}
+
+TEST_F(PageManagerTest, ConcurrentInsertersUseSeparatePages) {
+  const int num_writers = 4;
+  fsm_->SetInsertStreams(num_writers);
+
+  std::vector<std::vector<TupleId>> inserted(num_writers);
+  std::vector<std::thread> threads;
+  for (int w = 0; w < num_writers; w++) {
+    threads.emplace_back([&, w]() {
+      char payload[200];
+      for (int i = 0; i < 50; i++) {
+        snprintf(payload, sizeof(payload), "writer-%d-%d", w, i);
+        inserted[w].push_back(
+            page_manager_->InsertTuple(payload, sizeof(payload)));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // Every writer started on a page of its own
+  std::set<page_id_t> first_pages;
+  for (int w = 0; w < num_writers; w++) {
+    ASSERT_EQ(inserted[w].size(), 50u);
+    first_pages.insert(inserted[w][0].page_id);
+  }
+  EXPECT_EQ(first_pages.size(), static_cast<size_t>(num_writers));
+
+  char buffer[200];
+  char expected[200];
+  for (int w = 0; w < num_writers; w++) {
+    for (int i = 0; i < 50; i++) {
+      ASSERT_NE(inserted[w][i].slot_id, INVALID_SLOT_ID);
+      ASSERT_EQ(
+          page_manager_->GetTuple(inserted[w][i], buffer, sizeof(buffer)).code,
+          0);
+      snprintf(expected, sizeof(expected), "writer-%d-%d", w, i);
+      EXPECT_STREQ(buffer, expected);
+    }
+  }
+}
+
+// ============================================================================
+// Batch Insert Tests
+// ============================================================================
+
+TEST_F(PageManagerTest, InsertTuplesPacksPages) {
+  const int num_tuples = 1000;
+  std::vector<std::string> payloads;
+  for (int i = 0; i < num_tuples; i++) {
+    payloads.push_back("batch-" + std::to_string(i) + std::string(90, 'x'));
+  }
+  std::vector<TupleSlice> tuples;
+  for (const std::string& payload : payloads) {
+    tuples.push_back({payload.c_str(), static_cast<uint16_t>(payload.size())});
+  }
+
+  std::vector<TupleId> tids = page_manager_->InsertTuples(tuples);
+  ASSERT_EQ(tids.size(), tuples.size());
+
+  // Pages are filled in order, one after another
+  std::set<page_id_t> pages;
+  for (size_t i = 0; i < tids.size(); i++) {
+    ASSERT_NE(tids[i].slot_id, INVALID_SLOT_ID);
+    if (i > 0) {
+      EXPECT_GE(tids[i].page_id, tids[i - 1].page_id);
+    }
+    pages.insert(tids[i].page_id);
+  }
+  const size_t bytes_needed = num_tuples * (100 + SLOT_ENTRY_SIZE);
+  EXPECT_LE(pages.size(),
+            bytes_needed / (PAGE_SIZE - sizeof(PageHeader)) + 1);
+
+  char buffer[256];
+  for (size_t i = 0; i < tids.size(); i++) {
+    ASSERT_EQ(page_manager_->GetTuple(tids[i], buffer, sizeof(buffer)).code,
+              0);
+    EXPECT_EQ(std::string(buffer, payloads[i].size()), payloads[i]);
+  }
+}
+
+TEST_F(PageManagerTest, InsertTuplesSkipsInvalidEntries) {
+  std::string oversized(PAGE_SIZE, 'x');
+  std::vector<TupleSlice> tuples = {
+      {"first", 6},
+      {nullptr, 10},
+      {"empty", 0},
+      {oversized.c_str(), static_cast<uint16_t>(oversized.size())},
+      {"last", 5}};
+
+  std::vector<TupleId> tids = page_manager_->InsertTuples(tuples);
+  ASSERT_EQ(tids.size(), tuples.size());
+  EXPECT_NE(tids[0].slot_id, INVALID_SLOT_ID);
+  EXPECT_EQ(tids[1].slot_id, INVALID_SLOT_ID);
+  EXPECT_EQ(tids[2].slot_id, INVALID_SLOT_ID);
+  EXPECT_EQ(tids[3].slot_id, INVALID_SLOT_ID);
+  EXPECT_NE(tids[4].slot_id, INVALID_SLOT_ID);
+  EXPECT_EQ(tids[0].page_id, tids[4].page_id);
+
+  char buffer[16];
+  ASSERT_EQ(page_manager_->GetTuple(tids[4], buffer, sizeof(buffer)).code, 0);
+  EXPECT_STREQ(buffer, "last");
+
+  EXPECT_TRUE(page_manager_->InsertTuples(nullptr, 0).empty());
+}
+
+TEST_F(PageManagerTest, InsertTuplesFillsPagesWithFreeSpace) {
+  TupleId single = page_manager_->InsertTuple("single", 7);
+  ASSERT_NE(single.slot_id, INVALID_SLOT_ID);
+
+  std::vector<TupleSlice> tuples = {{"a", 2}, {"b", 2}, {"c", 2}};
+  std::vector<TupleId> tids = page_manager_->InsertTuples(tuples);
+  for (const TupleId& tid : tids) {
+    EXPECT_EQ(tid.page_id, single.page_id);
+  }
+}
+
+// ============================================================================
+// Zero-Copy Read Tests
+// ============================================================================
+
+TEST_F(PageManagerTest, GetTupleViewPointsIntoPinnedPage) {
+  const char* data = "zero-copy";
+  TupleId tid = page_manager_->InsertTuple(data, strlen(data));
+  ASSERT_NE(tid.slot_id, INVALID_SLOT_ID);
+
+  BufferPoolManager* pool = page_manager_->GetBufferPool();
+  {
+    PinnedTuple tuple;
+    ASSERT_EQ(page_manager_->GetTupleView(tid, &tuple).code, 0);
+    ASSERT_TRUE(tuple);
+    EXPECT_EQ(std::string(tuple.Data(), tuple.Size()), data);
+    EXPECT_EQ(tuple.GetTupleId().page_id, tid.page_id);
+    EXPECT_EQ(pool->GetPinCount(tid.page_id), 1);
+
+    // Moving the view keeps exactly one pin
+    PinnedTuple moved = std::move(tuple);
+    EXPECT_FALSE(tuple);
+    EXPECT_EQ(pool->GetPinCount(tid.page_id), 1);
+
+    moved.Release();
+    EXPECT_FALSE(moved);
+    EXPECT_EQ(pool->GetPinCount(tid.page_id), 0);
+
+    ASSERT_EQ(page_manager_->GetTupleView(tid, &moved).code, 0);
+  }
+  EXPECT_EQ(pool->GetPinCount(tid.page_id), 0);
+}
+
+TEST_F(PageManagerTest, GetTupleViewFollowsForwardingAndFeedsAccessor) {
+  Schema schema;
+  schema.AddColumn("id", DataType::INTEGER, false, 0);
+  schema.AddColumn("name", DataType::VARCHAR, false, 3000);
+  schema.Finalize();
+
+  char original[64];
+  TupleBuilder builder(schema);
+  size_t size = TupleSerializer::SerializeVariableLength(
+      schema, builder.SetInteger("id", 7).SetVarChar("name", "short").Build(),
+      original, sizeof(original));
+  TupleId tid = page_manager_->InsertTuple(original, size);
+  ASSERT_NE(tid.slot_id, INVALID_SLOT_ID);
+
+  // Fill the page so the grown tuple has to move
+  std::string filler(7000, 'f');
+  ASSERT_NE(page_manager_->InsertTuple(filler.c_str(), filler.size()).slot_id,
+            INVALID_SLOT_ID);
+  std::vector<char> grown(4096);
+  builder.Reset();
+  size = TupleSerializer::SerializeVariableLength(
+      schema,
+      builder.SetInteger("id", 8)
+          .SetVarChar("name", std::string(2000, 'n'))
+          .Build(),
+      grown.data(), grown.size());
+  ASSERT_EQ(page_manager_->UpdateTuple(tid, grown.data(), size).code, 0);
+
+  PinnedTuple tuple;
+  ASSERT_EQ(page_manager_->GetTupleView(tid, &tuple).code, 0);
+  EXPECT_NE(tuple.GetTupleId().page_id, tid.page_id);
+  TupleAccessor accessor(schema, tuple.Data(), tuple.Size());
+  EXPECT_EQ(accessor.GetInteger("id"), 8);
+  EXPECT_EQ(accessor.GetString("name").size(), 2000u);
+}
+
+TEST_F(PageManagerTest, GetTupleViewErrors) {
+  EXPECT_NE(page_manager_->GetTupleView({1, 0}, nullptr).code, 0);
+
+  TupleId tid = page_manager_->InsertTuple("gone", 5);
+  ASSERT_EQ(page_manager_->DeleteTuple(tid).code, 0);
+
+  PinnedTuple tuple;
+  EXPECT_NE(page_manager_->GetTupleView(tid, &tuple).code, 0);
+  EXPECT_FALSE(tuple);
+  EXPECT_EQ(page_manager_->GetBufferPool()->GetPinCount(tid.page_id), 0);
+}
+
+// ============================================================================
+// Forwarding Chain Tests
+// ============================================================================
+
+namespace {
+
+// Valid, non-forwarded slots across the whole table
+size_t CountLiveTuples(BufferPoolManager* bpm, page_id_t end_page_id) {
+  size_t live = 0;
+  for (page_id_t page_id = 1; page_id < end_page_id; page_id++) {
+    PageGuard page(bpm, page_id, bpm->FetchPage(page_id), LatchMode::SHARED);
+    if (!page) {
+      continue;
+    }
+    for (slot_id_t slot = 0; slot < page->GetSlotCount(); slot++) {
+      if (page->IsSlotValid(slot) && !page->IsSlotForwarded(slot)) {
+        live++;
+      }
+    }
+  }
+  return live;
+}
+
+// Take the page's free space with a tuple of its own (behind the
+// PageManager's back), all but room for a forwarding stub, so no tuple on
+// it can grow there
+void FillPage(BufferPoolManager* bpm, page_id_t page_id) {
+  PageGuard page(bpm, page_id, bpm->FetchPage(page_id), LatchMode::EXCLUSIVE);
+  ASSERT_TRUE(page);
+  const size_t free_space = page->GetFreeEnd() - page->GetFreeStart();
+  ASSERT_GT(free_space, SLOT_ENTRY_SIZE + FORWARD_STUB_SIZE);
+  const std::string filler(free_space - SLOT_ENTRY_SIZE - FORWARD_STUB_SIZE,
+                           'f');
+  ASSERT_NE(page->InsertTuple(filler.data(), filler.size()), INVALID_SLOT_ID);
+  page.MarkDirty();
+}
+
+}  // namespace
+
+TEST_F(PageManagerTest, RepeatUpdatesPointHomeAtNewestVersion) {
+  BufferPoolManager* bpm = page_manager_->GetBufferPool();
+  TupleId tid = page_manager_->InsertTuple("v0", 2);
+  ASSERT_NE(tid.slot_id, INVALID_SLOT_ID);
+  FillPage(bpm, tid.page_id);
+
+  // Each version's page is filled too, so every update moves the tuple
+  const size_t sizes[] = {100, 1000, 3000, 6000};
+  std::vector<char> buffer(PAGE_SIZE);
+  for (size_t i = 0; i < 4; i++) {
+    std::string data(sizes[i], static_cast<char>('a' + i));
+    ASSERT_EQ(page_manager_->UpdateTuple(tid, data.c_str(), data.size()).code,
+              0);
+    ASSERT_EQ(page_manager_->GetTuple(tid, buffer.data(), buffer.size()).code,
+              0);
+    EXPECT_EQ(std::string(buffer.data(), data.size()), data);
+
+    // One hop from home to the newest version, and no stale copies
+    TupleId target;
+    {
+      PageGuard home(bpm, tid.page_id, bpm->FetchPage(tid.page_id),
+                     LatchMode::SHARED);
+      ASSERT_TRUE(home->IsSlotForwarded(tid.slot_id));
+      target = home->GetForwardingPointer(tid.slot_id);
+    }
+    PageGuard final_page(bpm, target.page_id, bpm->FetchPage(target.page_id),
+                         LatchMode::SHARED);
+    EXPECT_FALSE(final_page->IsSlotForwarded(target.slot_id));
+    final_page.Release();
+    EXPECT_EQ(CountLiveTuples(bpm, disk_manager_->GetNextPageId()), i + 2);
+    FillPage(bpm, target.page_id);
+  }
+}
+
+TEST_F(PageManagerTest, DeleteForwardedTupleFreesHomeStub) {
+  BufferPoolManager* bpm = page_manager_->GetBufferPool();
+  TupleId tid = page_manager_->InsertTuple("tiny", 4);
+  FillPage(bpm, tid.page_id);
+  std::string grown(3000, 'g');
+  ASSERT_EQ(page_manager_->UpdateTuple(tid, grown.c_str(), grown.size()).code,
+            0);
+  ASSERT_EQ(page_manager_->DeleteTuple(tid).code, 0);
+
+  PageGuard home(bpm, tid.page_id, bpm->FetchPage(tid.page_id),
+                 LatchMode::SHARED);
+  EXPECT_FALSE(home->IsSlotValid(tid.slot_id));
+  home.Release();
+  EXPECT_EQ(CountLiveTuples(bpm, disk_manager_->GetNextPageId()), 1u);
+}
+
+TEST_F(PageManagerTest, CollapseForwardingChainsShortensLegacyChains) {
+  BufferPoolManager* bpm = page_manager_->GetBufferPool();
+  TupleId home = page_manager_->InsertTuple("home", 4);
+  TupleId middle = page_manager_->InsertTuple("middle", 6);
+  TupleId last = page_manager_->InsertTuple("last", 4);
+  ASSERT_EQ(home.page_id, last.page_id);
+
+  // Two-hop chain as older code could leave behind
+  {
+    PageGuard page(bpm, home.page_id, bpm->FetchPage(home.page_id),
+                   LatchMode::EXCLUSIVE);
+    ASSERT_EQ(page->MarkSlotForwarded(home.slot_id, middle.page_id,
+                                      middle.slot_id)
+                  .code,
+              0);
+    ASSERT_EQ(page->MarkSlotForwarded(middle.slot_id, last.page_id,
+                                      last.slot_id)
+                  .code,
+              0);
+    page.MarkDirty();
+  }
+
+  EXPECT_EQ(page_manager_->CollapseForwardingChains(), 1u);
+  EXPECT_EQ(page_manager_->CollapseForwardingChains(), 0u);
+
+  {
+    PageGuard page(bpm, home.page_id, bpm->FetchPage(home.page_id),
+                   LatchMode::SHARED);
+    EXPECT_EQ(page->GetForwardingPointer(home.slot_id), last);
+    EXPECT_FALSE(page->IsSlotValid(middle.slot_id));
+  }
+
+  char buffer[16];
+  ASSERT_EQ(page_manager_->GetTuple(home, buffer, sizeof(buffer)).code, 0);
+  EXPECT_EQ(std::string(buffer, 4), "last");
+}
+
+TEST_F(PageManagerTest, ReadersNeverSeeAForwardingStub) {
+  BufferPoolManager* bpm = page_manager_->GetBufferPool();
+  const std::string small(200, 's');
+  const std::string large(3000, 'L');
+  TupleId tid = page_manager_->InsertTuple(small.c_str(), small.size());
+  FillPage(bpm, tid.page_id);
+
+  // The tuple moves off its page and back into its target's free space
+  std::atomic<bool> done{false};
+  std::thread writer([&]() {
+    for (int i = 0; i < 2000; i++) {
+      const std::string& value = i % 2 == 0 ? large : small;
+      if (page_manager_->UpdateTuple(tid, value.c_str(), value.size()).code !=
+          0) {
+        ADD_FAILURE() << "update " << i << " failed";
+        break;
+      }
+    }
+    done = true;
+  });
+
+  auto is_version = [&](const char* data, size_t size) {
+    return (size == small.size() &&
+            std::memcmp(data, small.data(), size) == 0) ||
+           (size == large.size() && std::memcmp(data, large.data(), size) == 0);
+  };
+  std::atomic<int> wrong{0};
+  std::vector<std::thread> readers;
+  for (int r = 0; r < 3; r++) {
+    readers.emplace_back([&]() {
+      PinnedTuple view;
+      std::vector<char> buffer(large.size());
+      while (!done) {
+        if (page_manager_->GetTupleView(tid, &view).code != 0 ||
+            !is_version(view.Data(), view.Size())) {
+          wrong++;
+        }
+        view.Release();
+        if (page_manager_->GetTuple(tid, buffer.data(), buffer.size()).code !=
+                0 ||
+            (std::memcmp(buffer.data(), small.data(), small.size()) != 0 &&
+             std::memcmp(buffer.data(), large.data(), large.size()) != 0)) {
+          wrong++;
+        }
+      }
+    });
+  }
+  writer.join();
+  for (std::thread& reader : readers) {
+    reader.join();
+  }
+  EXPECT_EQ(wrong.load(), 0);
+}
+
+TEST_F(PageManagerTest, ReadersNeverSeeAReusedSlot) {
+  BufferPoolManager* bpm = page_manager_->GetBufferPool();
+  const std::string small(200, 's');
+  const std::string large(3000, 'L');
+  TupleId tid = page_manager_->InsertTuple(small.c_str(), small.size());
+  FillPage(bpm, tid.page_id);
+
+  // Every version the writer frees, the old target and the stubs a
+  // collapse drops, is offered to the inserts of other rows right away
+  std::atomic<bool> done{false};
+  std::thread writer([&]() {
+    const std::string other(200, 'o');
+    const std::string stub_row(8, 'm');
+    for (int i = 0; i < 600; i++) {
+      const std::string& value = i % 2 == 0 ? large : small;
+      if (page_manager_->UpdateTuple(tid, value.c_str(), value.size()).code !=
+          0) {
+        ADD_FAILURE() << "update " << i << " failed";
+        break;
+      }
+      page_manager_->InsertTuple(other.c_str(), other.size());
+
+      if (i % 10 != 5) {
+        continue;
+      }
+      // Two-hop chain home -> middle -> target, then collapse it
+      TupleId target;
+      {
+        PageGuard home(bpm, tid.page_id, bpm->FetchPage(tid.page_id),
+                       LatchMode::SHARED);
+        target = home->GetForwardingPointer(tid.slot_id);
+      }
+      const TupleId middle =
+          page_manager_->InsertTuple(stub_row.c_str(), stub_row.size());
+      {
+        PageGuard page(bpm, middle.page_id, bpm->FetchPage(middle.page_id),
+                       LatchMode::EXCLUSIVE);
+        EXPECT_EQ(page->MarkSlotForwarded(middle.slot_id, target.page_id,
+                                          target.slot_id)
+                      .code,
+                  0);
+        page.MarkDirty();
+      }
+      {
+        PageGuard home(bpm, tid.page_id, bpm->FetchPage(tid.page_id),
+                       LatchMode::EXCLUSIVE);
+        EXPECT_EQ(home->MarkSlotForwarded(tid.slot_id, middle.page_id,
+                                          middle.slot_id)
+                      .code,
+                  0);
+        home.MarkDirty();
+      }
+      page_manager_->CollapseForwardingChains();
+      page_manager_->InsertTuple(stub_row.c_str(), stub_row.size());
+    }
+    done = true;
+  });
+
+  auto is_version = [&](const char* data, size_t size) {
+    return (size == small.size() &&
+            std::memcmp(data, small.data(), size) == 0) ||
+           (size == large.size() && std::memcmp(data, large.data(), size) == 0);
+  };
+  std::atomic<int> wrong{0};
+  std::vector<std::thread> readers;
+  for (int r = 0; r < 3; r++) {
+    readers.emplace_back([&]() {
+      PinnedTuple view;
+      std::vector<char> buffer;
+      std::vector<TupleSlice> tuples;
+      while (!done) {
+        if (page_manager_->GetTupleView(tid, &view).code != 0 ||
+            !is_version(view.Data(), view.Size())) {
+          wrong++;
+        }
+        view.Release();
+        if (page_manager_->GetTuples(&tid, 1, &buffer, &tuples) != 1 ||
+            !is_version(tuples[0].data, tuples[0].size)) {
+          wrong++;
+        }
+      }
+    });
+  }
+  writer.join();
+  for (std::thread& reader : readers) {
+    reader.join();
+  }
+  EXPECT_EQ(wrong.load(), 0);
+}
+
+TEST_F(PageManagerTest, GetTuplesMatchesGetTupleInCallerOrder) {
+  std::vector<TupleId> ids;
+  std::vector<std::string> values;
+  for (int i = 0; i < 600; i++) {
+    values.push_back("tuple-" + std::to_string(i) +
+                     std::string(static_cast<size_t>(i % 50), 'x'));
+    const std::string& value = values.back();
+    ids.push_back(page_manager_->InsertTuple(
+        value.c_str(), static_cast<uint16_t>(value.size())));
+  }
+  // Forwarded (one and two updates), deleted and unknown ids
+  for (int i = 5; i < 600; i += 40) {
+    values[i] = std::string(2000 + i, 'f');
+    ASSERT_EQ(page_manager_
+                  ->UpdateTuple(ids[i], values[i].c_str(),
+                                static_cast<uint16_t>(values[i].size()))
+                  .code,
+              0);
+  }
+  values[5] = std::string(3000, 'g');
+  ASSERT_EQ(page_manager_
+                ->UpdateTuple(ids[5], values[5].c_str(),
+                              static_cast<uint16_t>(values[5].size()))
+                .code,
+            0);
+  ASSERT_EQ(page_manager_->DeleteTuple(ids[7]).code, 0);
+  ASSERT_EQ(page_manager_->FlushAllPages().code, 0);
+  page_manager_->ClearCache();
+
+  std::vector<size_t> order(ids.size());
+  for (size_t i = 0; i < order.size(); i++) {
+    order[i] = i;
+  }
+  std::shuffle(order.begin(), order.end(), std::mt19937(7));
+  order.push_back(3);  // duplicate
+  std::vector<TupleId> request;
+  for (size_t i : order) {
+    request.push_back(ids[i]);
+  }
+  request.push_back({0, INVALID_SLOT_ID});
+
+  const BufferPoolMetrics before = page_manager_->GetMetrics().buffer_pool;
+  std::vector<char> buffer;
+  std::vector<TupleSlice> tuples;
+  EXPECT_EQ(page_manager_->GetTuples(request, &buffer, &tuples),
+            order.size() - 1);
+  ASSERT_EQ(tuples.size(), request.size());
+  for (size_t r = 0; r < order.size(); r++) {
+    if (order[r] == 7) {
+      EXPECT_EQ(tuples[r].data, nullptr);
+      continue;
+    }
+    ASSERT_NE(tuples[r].data, nullptr) << r;
+    EXPECT_EQ(std::string(tuples[r].data, tuples[r].size), values[order[r]]);
+  }
+  EXPECT_EQ(tuples.back().data, nullptr);
+
+  // Every page was read once
+  const BufferPoolMetrics after = page_manager_->GetMetrics().buffer_pool;
+  EXPECT_EQ(after.misses - before.misses, disk_manager_->GetNextPageId() - 1);
+
+  EXPECT_EQ(page_manager_->GetTuples(nullptr, 0, &buffer, &tuples), 0u);
+  EXPECT_TRUE(tuples.empty());
+}
+
+TEST_F(PageManagerTest, GetTuplesPinsAtMostHalfThePool) {
+  // 1 MB pool: 128 frames, so ~300 pages take several batches
+  DiskManager disk_manager(db_file_ + "_small.db");
+  FreeSpaceMap fsm(fsm_file_ + "_small");
+  std::vector<TupleId> ids;
+  {
+    PageManager page_manager(&disk_manager, &fsm, 1);
+    const std::string value(2000, 'v');
+    for (int i = 0; i < 1200; i++) {
+      ids.push_back(page_manager.InsertTuple(value.c_str(), value.size()));
+    }
+    ASSERT_GT(disk_manager.GetNextPageId(),
+              page_manager.GetBufferPool()->GetPoolSize() * 2);
+    page_manager.ClearCache();
+
+    std::vector<char> buffer;
+    std::vector<TupleSlice> tuples;
+    EXPECT_EQ(page_manager.GetTuples(ids, &buffer, &tuples), ids.size());
+    for (const TupleSlice& tuple : tuples) {
+      ASSERT_EQ(tuple.size, value.size());
+      EXPECT_EQ(std::string(tuple.data, tuple.size), value);
+    }
+  }
+  std::remove((db_file_ + "_small.db").c_str());
+  std::remove((fsm_file_ + "_small").c_str());
+}
+
+TEST_F(PageManagerTest, TablesOpenInParallel) {
+  const size_t num_tables = 4;
+  auto table_file = [this](size_t table, const char* extension) {
+    return db_file_ + "_t" + std::to_string(table) + extension;
+  };
+  auto open_tables = [&](const std::function<void(size_t, PageManager*)>&
+                             work) {
+    std::vector<std::thread> threads;
+    for (size_t table = 0; table < num_tables; table++) {
+      threads.emplace_back([&, table]() {
+        DiskManager disk_manager(table_file(table, ".db"),
+                                 DurabilityMode::BATCHED);
+        FreeSpaceMap fsm(table_file(table, ".fsm"));
+        PageManager page_manager(&disk_manager, &fsm, 1);
+        work(table, &page_manager);
+      });
+    }
+    for (std::thread& thread : threads) {
+      thread.join();
+    }
+  };
+
+  std::vector<TupleId> ids(num_tables);
+  open_tables([&](size_t table, PageManager* page_manager) {
+    const std::string data = "table-" + std::to_string(table);
+    ids[table] = page_manager->InsertTuple(data.c_str(), data.size());
+  });
+
+  std::atomic<size_t> matches{0};
+  open_tables([&](size_t table, PageManager* page_manager) {
+    char buffer[16];
+    if (page_manager->GetTuple(ids[table], buffer, sizeof(buffer)).code == 0 &&
+        std::string(buffer, 7) == "table-" + std::to_string(table)) {
+      matches++;
+    }
+  });
+  EXPECT_EQ(matches.load(), num_tables);
+
+  for (size_t table = 0; table < num_tables; table++) {
+    std::remove(table_file(table, ".db").c_str());
+    std::remove(table_file(table, ".fsm").c_str());
+  }
+}
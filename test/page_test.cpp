@@ -29,7 +29,7 @@ TEST(PageTest, CreateNew) {
   EXPECT_EQ(page->GetFreeEnd(), PAGE_SIZE);
   EXPECT_EQ(page->GetSlotCount(), 0);
   EXPECT_EQ(page->GetPageType(), 0);
-  EXPECT_EQ(page->GetFlags(), 0);
+  EXPECT_EQ(page->GetFlags(), PAGE_FLAG_CRC32C);
 
   // Check that checksum is computed
   EXPECT_NE(page->GetChecksum(), 0)
@@ -83,6 +83,22 @@ TEST(PageTest, RecalculateChecksumAfterModification) {
       << "Checksum should be valid after recalculation";
 }
 
+// Pages written before CRC32C (flag clear) are verified with legacy CRC32
+TEST(PageTest, LegacyCrc32PageStillVerifies) {
+  auto page = Page::CreateNew();
+  ASSERT_NE(page, nullptr);
+  const uint32_t crc32c_checksum = page->GetChecksum();
+
+  page->SetFlags(page->GetFlags() & ~PAGE_FLAG_CRC32C);
+  page->SetChecksum(page->ComputeChecksum());
+  EXPECT_NE(page->GetChecksum(), crc32c_checksum);
+  EXPECT_TRUE(page->VerifyChecksum());
+
+  // The flag is covered by the checksum, so flipping it is detected
+  page->SetFlags(page->GetFlags() | PAGE_FLAG_CRC32C);
+  EXPECT_FALSE(page->VerifyChecksum());
+}
+
 // Test all getters return correct initial values
 TEST(PageTest, GettersInitialValues) {
   auto page = Page::CreateNew();
@@ -94,7 +110,7 @@ TEST(PageTest, GettersInitialValues) {
   EXPECT_EQ(page->GetFreeEnd(), PAGE_SIZE);
   EXPECT_EQ(page->GetSlotCount(), 0);
   EXPECT_EQ(page->GetPageType(), 0);
-  EXPECT_EQ(page->GetFlags(), 0);
+  EXPECT_EQ(page->GetFlags(), PAGE_FLAG_CRC32C);
   EXPECT_NE(page->GetChecksum(), 0);
 }
 
@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 
 #include <cstring>
+#include <string>
 #include <vector>
 
 #include "../include/common/types.h"
@@ -180,6 +181,147 @@ TEST(PageUpdateTest, UpdateTupleInPlace_ZeroSize) {
   EXPECT_EQ(result.code, -3);  // New size is zero
 }
 
+// ============================================================================
+// UpdateTuple Tests
+// ============================================================================
+
+TEST(PageUpdateTest, UpdateTuple_LastTupleGrowsInPlace) {
+  auto page = Page::CreateNew();
+  ASSERT_NE(page, nullptr);
+
+  slot_id_t first = page->InsertTuple("first", 5);
+  slot_id_t last = page->InsertTuple("last", 4);
+  ASSERT_NE(last, INVALID_SLOT_ID);
+  const uint16_t offset = page->GetSlotEntry(last).offset;
+
+  // Only the added bytes are taken from the free space
+  const std::string grown = "last, now longer";
+  ASSERT_EQ(page->UpdateTuple(last, grown.c_str(), grown.size()).code, 0);
+  EXPECT_EQ(page->GetSlotEntry(last).offset, offset);
+  EXPECT_EQ(page->GetFreeStart(), offset + grown.size());
+  EXPECT_EQ(std::string(page->GetRawBuffer() + offset, grown.size()), grown);
+  EXPECT_EQ(std::string(page->GetRawBuffer() + page->GetSlotEntry(first).offset,
+                        5),
+            "first");
+  EXPECT_TRUE(page->VerifyChecksum());
+}
+
+TEST(PageUpdateTest, UpdateTuple_GrowingTupleMovesWithinPage) {
+  auto page = Page::CreateNew();
+  ASSERT_NE(page, nullptr);
+
+  slot_id_t slot_id = page->InsertTuple("Short", 5);
+  ASSERT_NE(page->InsertTuple("next", 4), INVALID_SLOT_ID);
+  const uint16_t free_start = page->GetFreeStart();
+
+  const std::string grown = "Short no more, moved to the free space";
+  ErrorCode result = page->UpdateTuple(slot_id, grown.c_str(), grown.size(),
+                                       SLOT_COMPRESSED);
+  ASSERT_EQ(result.code, 0);
+  const SlotEntry& slot = page->GetSlotEntry(slot_id);
+  EXPECT_EQ(slot.offset, free_start);
+  EXPECT_EQ(slot.length, grown.size());
+  EXPECT_TRUE(page->IsSlotCompressed(slot_id));
+  EXPECT_EQ(page->GetFreeStart(), free_start + grown.size());
+  EXPECT_EQ(std::string(page->GetRawBuffer() + slot.offset, slot.length),
+            grown);
+  EXPECT_TRUE(page->VerifyChecksum());
+}
+
+TEST(PageUpdateTest, UpdateTuple_FailsWhenPageIsFull) {
+  auto page = Page::CreateNew();
+  ASSERT_NE(page, nullptr);
+
+  slot_id_t slot_id = page->InsertTuple("Short", 5);
+  const std::string filler(
+      page->GetFreeEnd() - page->GetFreeStart() - SLOT_ENTRY_SIZE - 10, 'f');
+  ASSERT_NE(page->InsertTuple(filler.c_str(), filler.size()), INVALID_SLOT_ID);
+  const uint16_t free_start = page->GetFreeStart();
+
+  const std::string grown(20, 'g');
+  EXPECT_EQ(page->UpdateTuple(slot_id, grown.c_str(), grown.size()).code, -8);
+  EXPECT_EQ(page->GetFreeStart(), free_start);
+  EXPECT_EQ(page->GetSlotEntry(slot_id).length, 5);
+
+  // Errors other than growth are UpdateTupleInPlace's
+  EXPECT_EQ(page->UpdateTuple(99, "x", 1).code, -4);
+  EXPECT_EQ(page->UpdateTuple(slot_id, nullptr, 1).code, -2);
+  EXPECT_EQ(page->UpdateTuple(slot_id, "tiny", 4).code, 0);
+}
+
+TEST(PageUpdateTest, UpdateTuple_RepeatedGrowthIsReclaimedByCompaction) {
+  auto page = Page::CreateNew();
+  ASSERT_NE(page, nullptr);
+
+  // Two tuples grown in turn: each move leaves the old bytes behind, and
+  // there is never a deleted slot
+  std::vector<std::string> tuples = {std::string(500, 'a'),
+                                     std::string(500, 'b')};
+  for (slot_id_t i = 0; i < 2; i++) {
+    ASSERT_EQ(page->InsertTuple(tuples[i].c_str(), tuples[i].size()), i);
+  }
+  for (int round = 0; round < 100; round++) {
+    const slot_id_t slot_id = static_cast<slot_id_t>(round % 2);
+    tuples[slot_id].append(20, tuples[slot_id][0]);
+    ErrorCode result = page->UpdateTuple(slot_id, tuples[slot_id].c_str(),
+                                         tuples[slot_id].size());
+    if (result.code == -8) {
+      ASSERT_GT(page->GetFragmentedBytes(), 0u);
+      ASSERT_TRUE(page->ShouldCompact());
+      page->CompactPage();
+      EXPECT_EQ(page->GetFragmentedBytes(), 0u);
+      result = page->UpdateTuple(slot_id, tuples[slot_id].c_str(),
+                                 tuples[slot_id].size());
+    }
+    ASSERT_EQ(result.code, 0) << "round " << round;
+  }
+
+  EXPECT_EQ(page->GetDeletedTupleCount(), 0u);
+  for (slot_id_t i = 0; i < 2; i++) {
+    const SlotEntry& slot = page->GetSlotEntry(i);
+    EXPECT_EQ(std::string(page->GetRawBuffer() + slot.offset, slot.length),
+              tuples[i]);
+  }
+  EXPECT_TRUE(page->VerifyChecksum());
+}
+
+TEST(PageUpdateTest, InsertTuple_KeepsReservedSpaceFree) {
+  auto page = Page::CreateNew();
+  ASSERT_NE(page, nullptr);
+
+  // An empty page takes any tuple, reserve or not
+  const std::string tuple(3000, 't');
+  ASSERT_NE(page->InsertTuple(tuple.c_str(), tuple.size(), 0, 6000),
+            INVALID_SLOT_ID);
+  const size_t free_space = page->GetFreeEnd() - page->GetFreeStart();
+  const uint16_t reserve =
+      static_cast<uint16_t>(free_space - SLOT_ENTRY_SIZE - 99);
+  EXPECT_EQ(page->InsertTuple(tuple.c_str(), 100, 0, reserve),
+            INVALID_SLOT_ID);
+  EXPECT_NE(page->InsertTuple(tuple.c_str(), 99, 0, reserve), INVALID_SLOT_ID);
+}
+
+TEST(PageUpdateTest, InsertTuple_NoReserveOnceCompactedPageEmpties) {
+  auto page = Page::CreateNew();
+  ASSERT_NE(page, nullptr);
+  slot_id_t slots[3];
+  for (slot_id_t& slot : slots) {
+    slot = page->InsertTuple("tuple", 6);
+    ASSERT_NE(slot, INVALID_SLOT_ID);
+  }
+
+  // Compaction clears the first slot; then the rest are deleted
+  ASSERT_EQ(page->DeleteTuple(slots[0]).code, 0);
+  page->CompactPage();
+  ASSERT_EQ(page->DeleteTuple(slots[1]).code, 0);
+  ASSERT_EQ(page->DeleteTuple(slots[2]).code, 0);
+
+  // No live tuple is left to grow, so the reserve does not apply
+  const std::string tuple(3000, 't');
+  EXPECT_NE(page->InsertTuple(tuple.c_str(), tuple.size(), 0, 6000),
+            INVALID_SLOT_ID);
+}
+
 // ============================================================================
 // MarkSlotForwarded Tests
 // ============================================================================
@@ -0,0 +1,145 @@
+#include "../include/storage/parallel_scan.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../include/tuple/tuple_builder.h"
+#include "../include/tuple/tuple_serializer.h"
+
+namespace fs = std::filesystem;
+
+class ParallelScanTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    fs::create_directories("/tmp/test");
+    const std::string base =
+        "/tmp/test/pscan_test_" +
+        std::to_string(
+            std::chrono::system_clock::now().time_since_epoch().count());
+    db_file_ = base + ".db";
+    fsm_file_ = base + ".fsm";
+    disk_manager_ = new DiskManager(db_file_, DurabilityMode::BATCHED);
+    fsm_ = new FreeSpaceMap(fsm_file_);
+    page_manager_ = new PageManager(disk_manager_, fsm_, 1);
+
+    schema_.AddColumn("id", DataType::INTEGER, false, 0);
+    schema_.AddColumn("amount", DataType::BIGINT, false, 0);
+    schema_.Finalize();
+  }
+
+  void TearDown() override {
+    delete page_manager_;
+    delete fsm_;
+    delete disk_manager_;
+    std::remove(db_file_.c_str());
+    std::remove(fsm_file_.c_str());
+  }
+
+  // Rows (id = i, amount = i * 10) padded so a page holds only a few
+  void LoadRows(int count) {
+    std::vector<std::vector<char>> rows;
+    for (int i = 0; i < count; i++) {
+      TupleBuilder builder(schema_);
+      auto values =
+          builder.SetInteger("id", i).SetBigInt("amount", i * 10LL).Build();
+      std::vector<char> row(1000, 0);
+      ASSERT_GT(TupleSerializer::SerializeFixedLength(schema_, values,
+                                                      row.data(), row.size()),
+                0u);
+      rows.push_back(row);
+    }
+    std::vector<TupleSlice> tuples;
+    for (const std::vector<char>& row : rows) {
+      tuples.push_back({row.data(), static_cast<uint16_t>(row.size())});
+    }
+    for (const TupleId& tid : page_manager_->InsertTuples(tuples)) {
+      ASSERT_NE(tid.slot_id, INVALID_SLOT_ID);
+    }
+    ASSERT_EQ(page_manager_->FlushAllPages().code, 0);
+    page_manager_->ClearCache();
+  }
+
+  std::string db_file_;
+  std::string fsm_file_;
+  DiskManager* disk_manager_;
+  FreeSpaceMap* fsm_;
+  PageManager* page_manager_;
+  Schema schema_;
+};
+
+TEST_F(ParallelScanTest, EveryTupleVisitedOnce) {
+  const int num_rows = 2000;
+  LoadRows(num_rows);
+
+  ParallelScan scan(page_manager_, 4, 8);
+  ASSERT_EQ(scan.GetWorkerCount(), 4u);
+
+  // Per-worker results, merged afterwards
+  std::vector<std::vector<int32_t>> ids(scan.GetWorkerCount());
+  std::vector<int64_t> sums(scan.GetWorkerCount(), 0);
+  scan.Run(schema_, [&](size_t worker, TupleId, const TupleAccessor& row) {
+    ids[worker].push_back(row.GetInteger("id"));
+    sums[worker] += row.GetBigInt("amount");
+  });
+
+  std::multiset<int32_t> seen;
+  int64_t total = 0;
+  for (size_t w = 0; w < ids.size(); w++) {
+    seen.insert(ids[w].begin(), ids[w].end());
+    total += sums[w];
+  }
+  ASSERT_EQ(seen.size(), static_cast<size_t>(num_rows));
+  EXPECT_EQ(std::set<int32_t>(seen.begin(), seen.end()).size(),
+            static_cast<size_t>(num_rows));
+  EXPECT_EQ(total, 10LL * num_rows * (num_rows - 1) / 2);
+}
+
+TEST_F(ParallelScanTest, IdleWorkersStealFromSlowOnes) {
+  LoadRows(400);
+
+  ParallelScan scan(page_manager_, 4, 1);
+  std::atomic<size_t> visited{0};
+  scan.Run([&](size_t worker, const TupleView&) {
+    if (worker == 0) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    visited++;
+  });
+
+  EXPECT_EQ(visited.load(), 400u);
+  EXPECT_GT(scan.GetMorselsStolen(), 0u);
+}
+
+TEST_F(ParallelScanTest, CallbackExceptionIsRethrown) {
+  LoadRows(100);
+
+  ParallelScan scan(page_manager_, 2, 4);
+  EXPECT_THROW(scan.Run([](size_t, const TupleView& tuple) {
+                 if (tuple.tuple_id.slot_id == 3) {
+                   throw std::runtime_error("stop");
+                 }
+               }),
+               std::runtime_error);
+
+  // A later run starts from scratch
+  std::atomic<size_t> visited{0};
+  scan.Run([&](size_t, const TupleView&) { visited++; });
+  EXPECT_EQ(visited.load(), 100u);
+}
+
+TEST_F(ParallelScanTest, EmptyTableAndInvalidArguments) {
+  ParallelScan scan(page_manager_, 3);
+  size_t visited = 0;
+  scan.Run([&](size_t, const TupleView&) { visited++; });
+  EXPECT_EQ(visited, 0u);
+
+  EXPECT_GE(ParallelScan(page_manager_).GetWorkerCount(), 1u);
+  EXPECT_THROW(ParallelScan(nullptr), std::invalid_argument);
+  EXPECT_THROW(ParallelScan(page_manager_, 2, 0), std::invalid_argument);
+}
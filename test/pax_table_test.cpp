@@ -0,0 +1,209 @@
+#include "../include/storage/pax_table.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../include/tuple/tuple_accessor.h"
+#include "../include/tuple/tuple_builder.h"
+#include "../include/tuple/tuple_serializer.h"
+
+namespace fs = std::filesystem;
+
+class PaxTableTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    fs::create_directories("/tmp/test");
+    db_file_ = "/tmp/test/pax_table_test_" +
+               std::to_string(std::chrono::system_clock::now()
+                                  .time_since_epoch()
+                                  .count()) +
+               ".pax";
+    schema_.AddColumn("id", DataType::BIGINT, false, 0);
+    schema_.AddColumn("bytes", DataType::INTEGER, true, 0);
+    schema_.AddColumn("ok", DataType::BOOLEAN, false, 0);
+    schema_.AddColumn("code", DataType::CHAR, false, 3);
+    schema_.Finalize();
+  }
+
+  void TearDown() override { std::remove(db_file_.c_str()); }
+
+  // bytes is NULL for every seventh row
+  std::vector<char> Row(int64_t id) const {
+    TupleBuilder builder(schema_);
+    builder.SetBigInt("id", id).SetBoolean("ok", id % 2 == 0);
+    builder.SetChar("code", id % 3 == 0 ? "abc" : "xy");
+    if (id % 7 == 0) {
+      builder.SetNull("bytes");
+    } else {
+      builder.SetInteger("bytes", static_cast<int32_t>(id * 10));
+    }
+    std::vector<char> row(schema_.GetTupleSize());
+    TupleSerializer::Serialize(schema_, builder.BuildRefs(), row.data(),
+                               row.size());
+    return row;
+  }
+
+  TupleId Insert(PaxTable* table, int64_t id) const {
+    std::vector<char> row = Row(id);
+    return table->InsertTuple(row.data(), static_cast<uint16_t>(row.size()));
+  }
+
+  // Decoded id of the tuple, checking every other column against Row()
+  int64_t ReadId(const PaxTable& table, TupleId tid) const {
+    std::vector<char> buffer(schema_.GetTupleSize());
+    ErrorCode result = table.GetTuple(tid, buffer.data(),
+                                      static_cast<uint16_t>(buffer.size()));
+    EXPECT_EQ(result.code, 0) << result.message;
+    TupleAccessor tuple(schema_, buffer.data(), buffer.size());
+    const int64_t id = tuple.GetBigInt("id");
+    EXPECT_EQ(buffer, Row(id)) << id;
+    EXPECT_EQ(tuple.IsNull("bytes"), id % 7 == 0);
+    return id;
+  }
+
+  std::string db_file_;
+  Schema schema_;
+};
+
+TEST_F(PaxTableTest, LayoutPlacesAlignedMinipages) {
+  PaxLayout layout(schema_);
+  ASSERT_GT(layout.GetCapacity(), 400u);
+  EXPECT_EQ(layout.GetTupleSize(), schema_.GetTupleSize());
+  EXPECT_EQ(layout.GetValidOffset() % PAX_MINIPAGE_ALIGNMENT, 0u);
+
+  size_t end = 0;
+  for (const PaxColumnLayout& column : layout.GetColumns()) {
+    EXPECT_EQ(column.data_offset % 8, 0u);
+    if (column.null_offset != 0) {
+      EXPECT_EQ(column.null_offset % PAX_MINIPAGE_ALIGNMENT, 0u);
+    } else {
+      EXPECT_EQ(column.data_offset % PAX_MINIPAGE_ALIGNMENT, 0u);
+    }
+    EXPECT_GE(column.data_offset, end);
+    end = column.data_offset + size_t{column.size} * layout.GetCapacity();
+  }
+  EXPECT_LE(end, PAGE_SIZE);
+  EXPECT_NE(layout.GetColumns()[1].null_offset, 0);
+  EXPECT_EQ(layout.GetColumns()[0].null_offset, 0);
+
+  Schema variable;
+  variable.AddColumn("name", DataType::VARCHAR, false, 32);
+  variable.Finalize();
+  EXPECT_THROW(PaxLayout{variable}, std::invalid_argument);
+}
+
+TEST_F(PaxTableTest, RowsRoundTripAndDeletedRowsAreReused) {
+  DiskManager disk_manager(db_file_);
+  PaxTable table(&disk_manager, schema_);
+  const size_t count = size_t{table.GetRowsPerPage()} * 3 + 10;
+
+  std::vector<TupleId> tids;
+  for (size_t i = 0; i < count; i++) {
+    tids.push_back(Insert(&table, static_cast<int64_t>(i)));
+    ASSERT_NE(tids.back().slot_id, INVALID_SLOT_ID);
+  }
+  EXPECT_EQ(table.GetPageCount(), 4u);
+  for (size_t i = 0; i < count; i += 37) {
+    EXPECT_EQ(ReadId(table, tids[i]), static_cast<int64_t>(i));
+  }
+
+  std::vector<char> updated = Row(1000001);
+  ASSERT_EQ(table.UpdateTuple(tids[5], updated.data(),
+                              static_cast<uint16_t>(updated.size()))
+                .code,
+            0);
+  EXPECT_EQ(ReadId(table, tids[5]), 1000001);
+
+  ASSERT_EQ(table.DeleteTuple(tids[3]).code, 0);
+  std::vector<char> buffer(schema_.GetTupleSize());
+  EXPECT_NE(table.GetTuple(tids[3], buffer.data(),
+                           static_cast<uint16_t>(buffer.size()))
+                .code,
+            0);
+  EXPECT_NE(table.DeleteTuple(tids[3]).code, 0);
+
+  // A page that gains a free row is filled next
+  EXPECT_EQ(Insert(&table, 2000000), tids[3]);
+  EXPECT_EQ(Insert(&table, 3000000).page_id, tids.back().page_id);
+  EXPECT_EQ(table.GetPageCount(), 4u);
+
+  std::vector<char> short_row(4);
+  EXPECT_EQ(table.InsertTuple(short_row.data(), 4).slot_id, INVALID_SLOT_ID);
+}
+
+TEST_F(PaxTableTest, ScanColumnSeesDenseValueArrays) {
+  DiskManager disk_manager(db_file_);
+  PaxTable table(&disk_manager, schema_);
+  const int64_t count = 5000;
+  int64_t expected = 0;
+  for (int64_t i = 0; i < count; i++) {
+    Insert(&table, i);
+    if (i % 7 != 0) {
+      expected += i * 10;
+    }
+  }
+  ASSERT_EQ(table.DeleteTuple({1, 1}).code, 0);
+  expected -= 10;
+
+  const size_t bytes = schema_.GetColumn("bytes").GetFieldIndex();
+  int64_t total = 0;
+  size_t pages = 0;
+  ErrorCode result =
+      table.ScanColumn(bytes, [&](const PaxColumnChunk& chunk) {
+        pages++;
+        EXPECT_EQ(chunk.value_size, sizeof(int32_t));
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(chunk.values) % 64, 0u);
+        ASSERT_NE(chunk.nulls, nullptr);
+        const int32_t* values = reinterpret_cast<const int32_t*>(chunk.values);
+        for (uint16_t r = 0; r < chunk.rows; r++) {
+          const bool valid = (chunk.valid[r / 8] >> (r % 8)) & 1;
+          const bool null = (chunk.nulls[r / 8] >> (r % 8)) & 1;
+          if (valid && !null) {
+            total += values[r];
+          }
+        }
+      });
+  ASSERT_EQ(result.code, 0) << result.message;
+  EXPECT_EQ(total, expected);
+  EXPECT_EQ(pages, table.GetPageCount());
+
+  // Non-null columns have no null bitmap
+  table.ScanColumn(0, [&](const PaxColumnChunk& chunk) {
+    EXPECT_EQ(chunk.nulls, nullptr);
+  });
+  EXPECT_NE(table.ScanColumn(99, [](const PaxColumnChunk&) {}).code, 0);
+}
+
+TEST_F(PaxTableTest, ReopenedTableKeepsRowsAndFillsFreeRows) {
+  std::vector<TupleId> tids;
+  {
+    DiskManager disk_manager(db_file_);
+    PaxTable table(&disk_manager, schema_);
+    for (int64_t i = 0; i < 1000; i++) {
+      tids.push_back(Insert(&table, i));
+    }
+    ASSERT_EQ(table.DeleteTuple(tids[10]).code, 0);
+  }
+
+  DiskManager disk_manager(db_file_);
+  PaxTable table(&disk_manager, schema_);
+  for (int64_t i = 0; i < 1000; i += 99) {
+    if (i != 10) {
+      EXPECT_EQ(ReadId(table, tids[i]), i);
+    }
+  }
+  EXPECT_EQ(Insert(&table, 77).page_id, tids[0].page_id);
+
+  // A different schema does not match the pages
+  Schema other;
+  other.AddColumn("id", DataType::BIGINT, false, 0);
+  other.Finalize();
+  EXPECT_THROW(PaxTable(&disk_manager, other), std::runtime_error);
+}
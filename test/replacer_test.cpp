@@ -0,0 +1,153 @@
+#include <gtest/gtest.h>
+
+#include "../include/buffer/clock_replacer.h"
+#include "../include/buffer/lru_k_replacer.h"
+
+// ============================================================================
+// CLOCK Replacer Tests
+// ============================================================================
+
+TEST(ClockReplacerTest, EmptyReplacerHasNoVictim) {
+  ClockReplacer replacer(4);
+  frame_id_t victim;
+  EXPECT_EQ(replacer.Size(), 0);
+  EXPECT_FALSE(replacer.Evict(&victim));
+}
+
+TEST(ClockReplacerTest, OnlyEvictableFramesAreVictims) {
+  ClockReplacer replacer(4);
+  for (frame_id_t f = 0; f < 4; f++) {
+    replacer.RecordAccess(f);
+  }
+  replacer.SetEvictable(2, true);
+  EXPECT_EQ(replacer.Size(), 1);
+
+  frame_id_t victim;
+  ASSERT_TRUE(replacer.Evict(&victim));
+  EXPECT_EQ(victim, 2);
+  EXPECT_EQ(replacer.Size(), 0);
+  EXPECT_FALSE(replacer.Evict(&victim));
+}
+
+TEST(ClockReplacerTest, ReferencedFramesGetSecondChance) {
+  ClockReplacer replacer(3);
+  for (frame_id_t f = 0; f < 3; f++) {
+    replacer.RecordAccess(f);
+    replacer.SetEvictable(f, true);
+  }
+
+  // First sweep clears all bits, so frame 0 goes first
+  frame_id_t victim;
+  ASSERT_TRUE(replacer.Evict(&victim));
+  EXPECT_EQ(victim, 0);
+
+  // Touch frame 1 again: frame 2 should be chosen before it
+  replacer.RecordAccess(1);
+  ASSERT_TRUE(replacer.Evict(&victim));
+  EXPECT_EQ(victim, 2);
+  ASSERT_TRUE(replacer.Evict(&victim));
+  EXPECT_EQ(victim, 1);
+}
+
+TEST(ClockReplacerTest, RemoveDropsFrame) {
+  ClockReplacer replacer(2);
+  replacer.SetEvictable(0, true);
+  replacer.SetEvictable(1, true);
+  replacer.Remove(0);
+  EXPECT_EQ(replacer.Size(), 1);
+
+  frame_id_t victim;
+  ASSERT_TRUE(replacer.Evict(&victim));
+  EXPECT_EQ(victim, 1);
+}
+
+// ============================================================================
+// LRU-K Replacer Tests
+// ============================================================================
+
+TEST(LRUKReplacerTest, EmptyReplacerHasNoVictim) {
+  LRUKReplacer replacer(4, 2);
+  frame_id_t victim;
+  EXPECT_FALSE(replacer.Evict(&victim));
+}
+
+TEST(LRUKReplacerTest, InfiniteDistanceEvictedFirst) {
+  LRUKReplacer replacer(4, 2);
+
+  // Frame 0 accessed twice (finite distance), frame 1 once (infinite)
+  replacer.RecordAccess(0);
+  replacer.RecordAccess(0);
+  replacer.RecordAccess(1);
+  replacer.SetEvictable(0, true);
+  replacer.SetEvictable(1, true);
+
+  frame_id_t victim;
+  ASSERT_TRUE(replacer.Evict(&victim));
+  EXPECT_EQ(victim, 1);
+  ASSERT_TRUE(replacer.Evict(&victim));
+  EXPECT_EQ(victim, 0);
+}
+
+TEST(LRUKReplacerTest, OldestKthAccessEvictedAmongFinite) {
+  LRUKReplacer replacer(3, 2);
+
+  // Access pattern: 0 0 1 1 2 2 0
+  // 2nd most recent access: frame0 -> t1, frame1 -> t2, frame2 -> t4
+  replacer.RecordAccess(0);  // t0
+  replacer.RecordAccess(0);  // t1
+  replacer.RecordAccess(1);  // t2
+  replacer.RecordAccess(1);  // t3
+  replacer.RecordAccess(2);  // t4
+  replacer.RecordAccess(2);  // t5
+  replacer.RecordAccess(0);  // t6 -> frame 0 history {t1, t6}
+  for (frame_id_t f = 0; f < 3; f++) {
+    replacer.SetEvictable(f, true);
+  }
+
+  frame_id_t victim;
+  ASSERT_TRUE(replacer.Evict(&victim));
+  EXPECT_EQ(victim, 0);  // 2nd most recent access at t1 is the oldest
+  ASSERT_TRUE(replacer.Evict(&victim));
+  EXPECT_EQ(victim, 1);
+  ASSERT_TRUE(replacer.Evict(&victim));
+  EXPECT_EQ(victim, 2);
+}
+
+TEST(LRUKReplacerTest, PinnedFramesNotEvicted) {
+  LRUKReplacer replacer(2, 2);
+  replacer.RecordAccess(0);
+  replacer.RecordAccess(1);
+  replacer.SetEvictable(0, true);
+  replacer.SetEvictable(1, true);
+  replacer.SetEvictable(0, false);
+  EXPECT_EQ(replacer.Size(), 1);
+
+  frame_id_t victim;
+  ASSERT_TRUE(replacer.Evict(&victim));
+  EXPECT_EQ(victim, 1);
+  EXPECT_FALSE(replacer.Evict(&victim));
+}
+
+TEST(LRUKReplacerTest, ScanDoesNotFlushHotFrames) {
+  LRUKReplacer replacer(4, 2);
+
+  // Hot frame 0 accessed repeatedly
+  for (int i = 0; i < 5; i++) {
+    replacer.RecordAccess(0);
+  }
+  replacer.SetEvictable(0, true);
+
+  // One-off scan touches frames 1..3 once each
+  for (frame_id_t f = 1; f < 4; f++) {
+    replacer.RecordAccess(f);
+    replacer.SetEvictable(f, true);
+  }
+
+  frame_id_t victim;
+  for (frame_id_t expected = 1; expected < 4; expected++) {
+    ASSERT_TRUE(replacer.Evict(&victim));
+    EXPECT_EQ(victim, expected);
+  }
+  ASSERT_TRUE(replacer.Evict(&victim));
+  EXPECT_EQ(victim, 0);
+}
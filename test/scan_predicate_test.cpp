@@ -0,0 +1,379 @@
+#include "../include/tuple/scan_predicate.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <functional>
+#include <limits>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../include/storage/parallel_scan.h"
+#include "../include/storage/table_scan.h"
+#include "../include/tuple/tuple_accessor.h"
+#include "../include/tuple/tuple_builder.h"
+#include "../include/tuple/tuple_serializer.h"
+
+namespace fs = std::filesystem;
+
+class ScanPredicateTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    schema_.AddColumn("id", DataType::BIGINT, false, 0);
+    schema_.AddColumn("qty", DataType::INTEGER, true, 0);
+    schema_.AddColumn("level", DataType::SMALLINT, false, 0);
+    schema_.AddColumn("price", DataType::DOUBLE, true, 0);
+    schema_.AddColumn("ratio", DataType::FLOAT, false, 0);
+    schema_.AddColumn("active", DataType::BOOLEAN, false, 0);
+    schema_.AddColumn("code", DataType::CHAR, false, 4);
+    schema_.AddColumn("region", DataType::VARCHAR, true, 32);
+    schema_.Finalize();
+
+    std::mt19937 rng(42);
+    const char* regions[] = {"eu-west", "eu-north", "us-east", "ap-south"};
+    for (int i = 0; i < 1000; i++) {
+      TupleBuilder builder(schema_);
+      builder.SetBigInt("id", i);
+      builder.SetSmallInt("level", static_cast<int16_t>(rng() % 200 - 100));
+      builder.SetFloat("ratio", static_cast<float>(rng() % 1000) / 100.0f);
+      builder.SetBoolean("active", rng() % 2 == 0);
+      builder.SetChar("code", std::string(1 + rng() % 3, 'A' + rng() % 3));
+      if (rng() % 10 == 0) {
+        builder.SetNull("qty");
+      } else {
+        builder.SetInteger("qty", static_cast<int32_t>(rng() % 100));
+      }
+      if (rng() % 8 == 0) {
+        builder.SetNull("price");
+      } else {
+        builder.SetDouble("price", static_cast<double>(rng() % 10000) / 8);
+      }
+      if (rng() % 6 == 0) {
+        builder.SetNull("region");
+      } else {
+        builder.SetVarChar("region", regions[rng() % 4]);
+      }
+      std::vector<char> row(256);
+      row.resize(TupleSerializer::Serialize(schema_, builder.BuildRefs(),
+                                            row.data(), row.size()));
+      rows_.push_back(row);
+    }
+  }
+
+  std::vector<TupleSlice> Slices() const {
+    std::vector<TupleSlice> slices;
+    for (const std::vector<char>& row : rows_) {
+      slices.push_back({row.data(), static_cast<uint16_t>(row.size())});
+    }
+    return slices;
+  }
+
+  using Reference = std::function<bool(const TupleAccessor& tuple)>;
+
+  // Filter() and Matches() agree with the reference on every row
+  void ExpectSelects(const ScanPredicate& predicate,
+                     const Reference& reference) const {
+    std::vector<uint32_t> expected;
+    for (size_t i = 0; i < rows_.size(); i++) {
+      TupleAccessor tuple(schema_, rows_[i].data(), rows_[i].size());
+      if (reference(tuple)) {
+        expected.push_back(static_cast<uint32_t>(i));
+      }
+      EXPECT_EQ(predicate.Matches(rows_[i].data(), rows_[i].size()),
+                reference(tuple))
+          << i;
+    }
+    std::vector<TupleSlice> slices = Slices();
+    std::vector<uint32_t> selection = {77};
+    predicate.Filter(slices.data(), slices.size(), &selection);
+    EXPECT_EQ(selection, expected);
+
+    // Block boundaries do not matter
+    predicate.Filter(slices.data() + 5, 100, &selection);
+    std::vector<uint32_t> shifted;
+    for (uint32_t i : expected) {
+      if (i >= 5 && i < 105) {
+        shifted.push_back(i - 5);
+      }
+    }
+    EXPECT_EQ(selection, shifted);
+  }
+
+  Schema schema_;
+  std::vector<std::vector<char>> rows_;
+};
+
+TEST_F(ScanPredicateTest, NumericConditionsMatchDecodedValues) {
+  ScanPredicate range(schema_);
+  range.Between("qty", FieldValue::Integer(20), FieldValue::Integer(60))
+      .Compare("level", CompareOp::GE, FieldValue::SmallInt(-10))
+      .Compare("price", CompareOp::LT, FieldValue::Double(800.5));
+  ExpectSelects(range, [](const TupleAccessor& t) {
+    return !t.IsNull("qty") && t.GetInteger("qty") >= 20 &&
+           t.GetInteger("qty") <= 60 && t.GetSmallInt("level") >= -10 &&
+           !t.IsNull("price") && t.GetDouble("price") < 800.5;
+  });
+
+  ScanPredicate in(schema_);
+  in.In("qty", {FieldValue::Integer(3), FieldValue::BigInt(50),
+                FieldValue::Integer(99)})
+      .Compare("active", CompareOp::EQ, FieldValue::Boolean(true))
+      .Compare("id", CompareOp::NE, FieldValue::BigInt(400));
+  ExpectSelects(in, [](const TupleAccessor& t) {
+    if (t.IsNull("qty")) {
+      return false;
+    }
+    const int32_t qty = t.GetInteger("qty");
+    return (qty == 3 || qty == 50 || qty == 99) && t.GetBoolean("active") &&
+           t.GetBigInt("id") != 400;
+  });
+
+  ScanPredicate floats(schema_);
+  floats.Compare("ratio", CompareOp::GT, FieldValue::Integer(5))
+      .Compare("ratio", CompareOp::LE, FieldValue::Float(7.5f))
+      .Compare("id", CompareOp::LT, FieldValue::Integer(900));
+  ExpectSelects(floats, [](const TupleAccessor& t) {
+    return t.GetFloat("ratio") > 5 && t.GetFloat("ratio") <= 7.5f &&
+           t.GetBigInt("id") < 900;
+  });
+
+  // NE never selects NULLs
+  ScanPredicate not_equal(schema_);
+  not_equal.Compare("qty", CompareOp::NE, FieldValue::Integer(10));
+  ExpectSelects(not_equal, [](const TupleAccessor& t) {
+    return !t.IsNull("qty") && t.GetInteger("qty") != 10;
+  });
+}
+
+TEST_F(ScanPredicateTest, StringConditions) {
+  ScanPredicate prefix(schema_);
+  prefix.Prefix("region", "eu-").Compare("code", CompareOp::NE,
+                                         FieldValue::Char("AA"));
+  ExpectSelects(prefix, [](const TupleAccessor& t) {
+    return !t.IsNull("region") && t.GetString("region").rfind("eu-", 0) == 0 &&
+           t.GetString("code") != "AA";
+  });
+
+  ScanPredicate in(schema_);
+  in.In("code", {FieldValue::Char("B"), FieldValue::VarChar("CCC")})
+      .Compare("region", CompareOp::EQ, FieldValue::VarChar("us-east"));
+  ExpectSelects(in, [](const TupleAccessor& t) {
+    const std::string code = t.GetString("code");
+    return (code == "B" || code == "CCC") && !t.IsNull("region") &&
+           t.GetString("region") == "us-east";
+  });
+}
+
+TEST_F(ScanPredicateTest, LiteralEdgeCases) {
+  const int64_t big = int64_t{1} << 40;
+  auto none = [](const TupleAccessor&) { return false; };
+
+  // Outside INTEGER's range: clamped, or empty
+  ScanPredicate above(schema_);
+  above.Compare("qty", CompareOp::GT, FieldValue::BigInt(big));
+  ExpectSelects(above, none);
+  ScanPredicate below(schema_);
+  below.Compare("qty", CompareOp::LT, FieldValue::BigInt(big));
+  ExpectSelects(below, [](const TupleAccessor& t) { return !t.IsNull("qty"); });
+
+  ScanPredicate min(schema_);
+  min.Compare("id", CompareOp::LT,
+              FieldValue::BigInt(std::numeric_limits<int64_t>::min()));
+  ExpectSelects(min, none);
+
+  ScanPredicate nan(schema_);
+  nan.Compare("price", CompareOp::EQ,
+              FieldValue::Double(std::numeric_limits<double>::quiet_NaN()));
+  ExpectSelects(nan, none);
+
+  ScanPredicate empty_in(schema_);
+  empty_in.In("qty", {});
+  ExpectSelects(empty_in, none);
+
+  ScanPredicate inverted(schema_);
+  inverted.Between("level", FieldValue::Integer(5), FieldValue::Integer(-5));
+  ExpectSelects(inverted, none);
+
+  ScanPredicate all(schema_);
+  EXPECT_EQ(all.GetConditionCount(), 0u);
+  ExpectSelects(all, [](const TupleAccessor&) { return true; });
+
+  std::vector<char> tiny(4);
+  EXPECT_FALSE(all.Matches(tiny.data(), tiny.size()));
+}
+
+TEST_F(ScanPredicateTest, RejectsInvalidConditions) {
+  ScanPredicate predicate(schema_);
+  EXPECT_THROW(predicate.Compare("missing", CompareOp::EQ,
+                                 FieldValue::Integer(1)),
+               std::invalid_argument);
+  EXPECT_THROW(predicate.Compare("qty", CompareOp::EQ,
+                                 FieldValue::Double(1.5)),
+               std::invalid_argument);
+  EXPECT_THROW(predicate.Compare("qty", CompareOp::EQ,
+                                 FieldValue::Null(DataType::INTEGER)),
+               std::invalid_argument);
+  EXPECT_THROW(predicate.Compare("region", CompareOp::LT,
+                                 FieldValue::VarChar("m")),
+               std::invalid_argument);
+  EXPECT_THROW(predicate.Compare("region", CompareOp::EQ,
+                                 FieldValue::Integer(1)),
+               std::invalid_argument);
+  EXPECT_THROW(predicate.Prefix("qty", "1"), std::invalid_argument);
+  EXPECT_THROW(predicate.Between("region", FieldValue::VarChar("a"),
+                                 FieldValue::VarChar("b")),
+               std::invalid_argument);
+  EXPECT_EQ(predicate.GetConditionCount(), 0u);
+
+  Schema blob;
+  blob.AddColumn("data", DataType::BLOB, false, 64);
+  blob.Finalize();
+  ScanPredicate on_blob(blob);
+  EXPECT_THROW(on_blob.Prefix("data", "x"), std::invalid_argument);
+}
+
+TEST_F(ScanPredicateTest, TableScansReturnOnlyMatches) {
+  fs::create_directories("/tmp/test");
+  const std::string base =
+      "/tmp/test/scan_predicate_test_" +
+      std::to_string(
+          std::chrono::system_clock::now().time_since_epoch().count());
+  std::set<int64_t> expected;
+  {
+    DiskManager disk_manager(base + ".db");
+    FreeSpaceMap fsm(base + ".fsm");
+    PageManager page_manager(&disk_manager, &fsm, 1);
+    std::vector<TupleSlice> slices = Slices();
+    page_manager.InsertTuples(slices);
+
+    ScanPredicate predicate(schema_);
+    predicate.Compare("qty", CompareOp::LT, FieldValue::Integer(30))
+        .Prefix("region", "eu");
+    for (const std::vector<char>& row : rows_) {
+      TupleAccessor tuple(schema_, row.data(), row.size());
+      if (predicate.Matches(row.data(), row.size())) {
+        expected.insert(tuple.GetBigInt("id"));
+      }
+    }
+    ASSERT_FALSE(expected.empty());
+
+    auto id_of = [&](const char* data, uint16_t size) {
+      return TupleAccessor(schema_, data, size).GetBigInt("id");
+    };
+
+    TableScan scan(&page_manager);
+    scan.SetPredicate(&predicate);
+    std::set<int64_t> seen;
+    TupleView tuple;
+    while (scan.Next(&tuple)) {
+      EXPECT_TRUE(seen.insert(id_of(tuple.data, tuple.size)).second);
+      std::vector<char> stored(tuple.size);
+      ASSERT_EQ(page_manager
+                    .GetTuple(tuple.tuple_id, stored.data(),
+                              static_cast<uint16_t>(stored.size()))
+                    .code,
+                0);
+    }
+    EXPECT_EQ(seen, expected);
+
+    TableScan paged(&page_manager);
+    paged.SetPredicate(&predicate);
+    seen.clear();
+    std::vector<TupleSlice> tuples;
+    while (paged.NextPage(&tuples)) {
+      EXPECT_FALSE(tuples.empty());
+      for (const TupleSlice& slice : tuples) {
+        seen.insert(id_of(slice.data, slice.size));
+      }
+    }
+    EXPECT_EQ(seen, expected);
+
+    ParallelScan parallel(&page_manager, 2, 1);
+    parallel.SetPredicate(&predicate);
+    std::atomic<size_t> calls{0};
+    parallel.Run([&](size_t, const TupleView&) { calls++; });
+    EXPECT_EQ(calls.load(), expected.size());
+  }
+  std::remove((base + ".db").c_str());
+  std::remove((base + ".fsm").c_str());
+}
+
+TEST(ScanPredicateDictionaryTest, EncodedStringConditionsCompareCodes) {
+  Schema schema;
+  schema.AddColumn("id", DataType::INTEGER, false, 0);
+  schema.AddColumn("status", DataType::VARCHAR, true, 16,
+                   ColumnEncoding::DICTIONARY);
+  schema.Finalize();
+
+  const char* statuses[] = {"new", "paid", "shipped", "returned"};
+  std::vector<std::vector<char>> rows;
+  std::vector<TupleSlice> slices;
+  for (int i = 0; i < 150; i++) {
+    std::vector<FieldValue> values = {
+        FieldValue::Integer(i), i % 7 == 0
+                                    ? FieldValue::Null(DataType::VARCHAR)
+                                    : FieldValue::VarChar(statuses[i % 4])};
+    rows.emplace_back(64);
+    rows.back().resize(TupleSerializer::SerializeVariableLength(
+        schema, values, rows.back().data(), rows.back().size()));
+  }
+  for (const std::vector<char>& row : rows) {
+    slices.push_back({row.data(), static_cast<uint16_t>(row.size())});
+  }
+
+  auto expect = [&](const ScanPredicate& predicate, bool by_code,
+                    const std::function<bool(int)>& reference) {
+    EXPECT_EQ(predicate.GetConditions()[0].by_code, by_code);
+    std::vector<uint32_t> expected;
+    for (int i = 0; i < 150; i++) {
+      if (reference(i)) {
+        expected.push_back(static_cast<uint32_t>(i));
+      }
+      EXPECT_EQ(predicate.Matches(rows[i].data(), rows[i].size()),
+                reference(i))
+          << i;
+    }
+    std::vector<uint32_t> selection;
+    predicate.Filter(slices.data(), slices.size(), &selection);
+    EXPECT_EQ(selection, expected);
+  };
+  auto status_is = [&](int i, const char* value) {
+    return i % 7 != 0 && std::string(statuses[i % 4]) == value;
+  };
+
+  ScanPredicate paid(schema);
+  paid.Compare("status", CompareOp::EQ, FieldValue::VarChar("paid"));
+  expect(paid, true, [&](int i) { return status_is(i, "paid"); });
+
+  ScanPredicate not_new(schema);
+  not_new.Compare("status", CompareOp::NE, FieldValue::VarChar("new"));
+  expect(not_new, true,
+         [&](int i) { return i % 7 != 0 && !status_is(i, "new"); });
+
+  ScanPredicate in(schema);
+  in.In("status", {FieldValue::VarChar("new"), FieldValue::VarChar("shipped")});
+  expect(in, true, [&](int i) {
+    return status_is(i, "new") || status_is(i, "shipped");
+  });
+
+  // A value without a code falls back to comparing strings, so it still
+  // matches tuples that give it a code later
+  ScanPredicate lost(schema);
+  lost.In("status", {FieldValue::VarChar("lost"), FieldValue::VarChar("paid")});
+  expect(lost, false, [&](int i) { return status_is(i, "paid"); });
+  std::vector<char> later(64);
+  later.resize(TupleSerializer::SerializeVariableLength(
+      schema, {FieldValue::Integer(150), FieldValue::VarChar("lost")},
+      later.data(), later.size()));
+  EXPECT_TRUE(lost.Matches(later.data(), later.size()));
+
+  ScanPredicate prefix(schema);
+  prefix.Prefix("status", "re");
+  expect(prefix, false, [&](int i) { return status_is(i, "returned"); });
+}
@@ -6,6 +6,12 @@
 
 #include <gtest/gtest.h>
 
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "../include/common/config.h"
+
 // Basic schema creation, finalize and offset/alignment expectations
 TEST(SchemaTest, AddAndFinalizeOffsetsAndSizes) {
   Schema s;
@@ -52,6 +58,40 @@ TEST(SchemaTest, AddAndFinalizeOffsetsAndSizes) {
   EXPECT_TRUE(textcol.GetIsNullable());
 }
 
+// Serialized-tuple offsets: fixed fields follow the TupleHeader in column
+// order, variable fields get consecutive header slots
+TEST(SchemaTest, FinalizeComputesSerializedLayout) {
+  Schema s;
+  s.AddColumn("flag", BOOLEAN, false, 0);
+  s.AddColumn("name", VARCHAR, false, 32);
+  s.AddColumn("id", BIGINT, false, 0);
+  s.AddColumn("note", TEXT, true, 32);
+  s.AddColumn("count", SMALLINT, false, 0);
+  s.Finalize();
+
+  EXPECT_EQ(s.GetVarFieldCount(), 2);
+  // 8-byte bitmap + 2 offsets, rounded to 8
+  EXPECT_EQ(s.GetTupleHeaderSize(), 16);
+
+  const std::vector<FieldLayout>& layout = s.GetLayout();
+  ASSERT_EQ(layout.size(), 5);
+  EXPECT_EQ(layout[0].offset, 16);  // flag
+  EXPECT_EQ(layout[2].offset, 24);  // id, aligned to 8
+  EXPECT_EQ(layout[4].offset, 32);  // count
+  EXPECT_EQ(layout[4].size, 2);
+  EXPECT_EQ(s.GetFixedSectionEnd(), 34);
+
+  EXPECT_FALSE(layout[1].IsFixedLength());
+  EXPECT_EQ(layout[1].var_index, 0);
+  EXPECT_EQ(layout[3].var_index, 1);
+  EXPECT_EQ(layout[3].field_index, 3);
+  EXPECT_EQ(layout[3].type, TEXT);
+
+  ASSERT_NE(s.FindColumn("note"), nullptr);
+  EXPECT_EQ(s.FindColumn("note")->GetFieldIndex(), 3);
+  EXPECT_EQ(s.FindColumn("missing"), nullptr);
+}
+
 TEST(SchemaTest, GetAlignmentDelegatesToAlignmentModule) {
   Schema s;
   EXPECT_EQ(s.GetAlignment(CHAR), 1);
@@ -67,3 +107,163 @@ TEST(SchemaTest, GetColumnNotFoundReturnsDefault) {
   EXPECT_EQ(col.GetDataType(), BOOLEAN);
   EXPECT_FALSE(col.GetIsNullable());
 }
+
+TEST(SchemaTest, WideSchemaWidensNullBitmap) {
+  Schema s;
+  for (size_t i = 0; i < 100; i++) {
+    s.AddColumn("c" + std::to_string(i), DataType::INTEGER, true, 0);
+  }
+  s.AddColumn("name", DataType::VARCHAR, true, 20);
+  s.Finalize();
+
+  // Two bitmap words, then one offset slot, padded to 8
+  EXPECT_EQ(s.GetVarOffsetsStart(), 16);
+  EXPECT_EQ(s.GetTupleHeaderSize(), 24);
+  EXPECT_EQ(s.GetLayout()[0].offset, 24);
+}
+
+TEST(SchemaTest, RejectsColumnsPastLimit) {
+  Schema s;
+  for (size_t i = 0; i < TUPLE_MAX_FIELDS; i++) {
+    s.AddColumn("c" + std::to_string(i), DataType::BOOLEAN, true, 0);
+  }
+  EXPECT_THROW(s.AddColumn("extra", DataType::BOOLEAN, true, 0),
+               std::invalid_argument);
+}
+
+TEST(SchemaTest, DictionaryColumnsStoreTwoByteCodes) {
+  Schema s;
+  s.AddColumn("id", DataType::INTEGER, false, 0);
+  s.AddColumn("status", DataType::VARCHAR, false, 32,
+              ColumnEncoding::DICTIONARY);
+  s.AddColumn("country", DataType::CHAR, true, 16, ColumnEncoding::DICTIONARY);
+  s.AddColumn("note", DataType::VARCHAR, true, 64);
+  EXPECT_THROW(s.AddColumn("qty", DataType::INTEGER, false, 0,
+                           ColumnEncoding::DICTIONARY),
+               std::invalid_argument);
+  EXPECT_THROW(
+      s.AddColumn("body", DataType::TEXT, false, 0, ColumnEncoding::DICTIONARY),
+      std::invalid_argument);
+  s.Finalize();
+
+  // The value's sizes are kept; the tuple stores a code
+  EXPECT_EQ(s.GetColumn("country").GetFixedSize(), 16);
+  EXPECT_EQ(s.GetColumn("status").GetEncoding(), ColumnEncoding::DICTIONARY);
+  EXPECT_EQ(s.GetVarFieldCount(), 1);
+  const std::vector<FieldLayout>& layout = s.GetLayout();
+  EXPECT_EQ(layout[1].size, sizeof(dictionary_code_t));
+  EXPECT_EQ(layout[1].offset, 20);  // after the 16-byte header and id
+  EXPECT_EQ(layout[2].size, sizeof(dictionary_code_t));
+  EXPECT_EQ(layout[2].offset, 22);
+  EXPECT_EQ(s.GetFixedSectionEnd(), 24);
+  EXPECT_NE(s.GetDictionary(1), nullptr);
+  EXPECT_NE(s.GetDictionary(1), s.GetDictionary(2));
+  EXPECT_EQ(s.GetDictionary(0), nullptr);
+  EXPECT_EQ(s.GetDictionary(3), nullptr);
+
+  // Copies share the dictionaries
+  Schema copy = s;
+  EXPECT_EQ(copy.GetDictionary(1), s.GetDictionary(1));
+}
+
+TEST(SchemaTest, ColumnDictionaryAssignsCodesInOrder) {
+  ColumnDictionary dictionary;
+  dictionary_code_t code = 99;
+  EXPECT_FALSE(dictionary.Lookup("new", &code));
+  ASSERT_TRUE(dictionary.Encode("new", &code));
+  EXPECT_EQ(code, 0);
+  ASSERT_TRUE(dictionary.Encode("shipped", &code));
+  EXPECT_EQ(code, 1);
+  ASSERT_TRUE(dictionary.Encode("new", &code));
+  EXPECT_EQ(code, 0);
+  EXPECT_EQ(dictionary.GetSize(), 2);
+  EXPECT_EQ(dictionary.Decode(1), "shipped");
+  EXPECT_THROW(dictionary.Decode(2), std::out_of_range);
+
+  // Views stay valid as the dictionary grows past a chunk
+  std::string_view first = dictionary.Decode(0);
+  for (int i = 0; i < 1000; i++) {
+    ASSERT_TRUE(dictionary.Encode("v" + std::to_string(i), &code));
+  }
+  EXPECT_EQ(first, "new");
+  EXPECT_EQ(dictionary.Decode(501), "v499");
+  EXPECT_FALSE(dictionary.Append("v7"));
+}
+
+TEST(SchemaTest, ColumnDictionaryFillsUp) {
+  ColumnDictionary dictionary;
+  dictionary_code_t code;
+  for (size_t i = 0; i < DICTIONARY_MAX_ENTRIES; i++) {
+    ASSERT_TRUE(dictionary.Append(std::to_string(i)));
+  }
+  EXPECT_FALSE(dictionary.Encode("one more", &code));
+  ASSERT_TRUE(dictionary.Encode("65535", &code));
+  EXPECT_EQ(code, 65535);
+}
+
+TEST(SchemaTest, DictionariesShareABudget) {
+  auto budget = std::make_shared<DictionaryBudget>(
+      2 * (DictionaryBudget::ENTRY_OVERHEAD + 6));
+  ColumnDictionary first(budget);
+  ColumnDictionary second(budget);
+  dictionary_code_t code;
+  EXPECT_TRUE(first.Encode("paid__", &code));
+  EXPECT_TRUE(second.Encode("closed", &code));
+  EXPECT_FALSE(first.Encode("x", &code));
+  EXPECT_FALSE(second.Append("y"));
+  EXPECT_EQ(budget->GetUsed(), budget->GetCapacity());
+  EXPECT_EQ(first.GetSize(), 1u);
+  EXPECT_EQ(second.GetSize(), 1u);
+
+  // A value too long to persist is refused without spending anything
+  ColumnDictionary unbounded;
+  EXPECT_FALSE(unbounded.Encode(std::string(UINT16_MAX + 1, 'x'), &code));
+  EXPECT_EQ(unbounded.GetSize(), 0u);
+}
+
+TEST(SchemaTest, DictionariesPersistByAppending) {
+  auto make_schema = [](Schema* s) {
+    s->AddColumn("status", DataType::VARCHAR, false, 32,
+                 ColumnEncoding::DICTIONARY);
+    s->AddColumn("id", DataType::INTEGER, false, 0);
+    s->AddColumn("country", DataType::CHAR, false, 2,
+                 ColumnEncoding::DICTIONARY);
+    s->Finalize();
+  };
+  Schema s;
+  make_schema(&s);
+  dictionary_code_t code;
+  s.GetDictionary(0)->Encode("new", &code);
+  s.GetDictionary(2)->Encode("DE", &code);
+  s.GetDictionary(0)->Encode("shipped", &code);
+
+  std::string data;
+  s.AppendDictionaryEntries(&data);
+  const std::string first = data;
+  s.AppendDictionaryEntries(&data);
+  EXPECT_EQ(data, first);  // nothing new
+
+  s.GetDictionary(2)->Encode("FR", &code);
+  s.AppendDictionaryEntries(&data);
+  EXPECT_GT(data.size(), first.size());
+  EXPECT_EQ(data.compare(0, first.size(), first), 0);
+
+  Schema reopened;
+  make_schema(&reopened);
+  reopened.LoadDictionaries(data);
+  EXPECT_EQ(reopened.GetDictionary(0)->GetSize(), 2);
+  EXPECT_EQ(reopened.GetDictionary(0)->Decode(1), "shipped");
+  EXPECT_EQ(reopened.GetDictionary(2)->Decode(0), "DE");
+  EXPECT_EQ(reopened.GetDictionary(2)->Decode(1), "FR");
+  EXPECT_THROW(reopened.LoadDictionaries(data), std::runtime_error);
+
+  // Truncated or foreign data is rejected
+  Schema other;
+  make_schema(&other);
+  EXPECT_THROW(other.LoadDictionaries(data.substr(0, data.size() - 1)),
+               std::runtime_error);
+  std::string plain_column = data;
+  plain_column[0] = 1;  // field 1 ("id") is not encoded
+  EXPECT_THROW(other.AppendDictionaryEntries(&plain_column),
+               std::runtime_error);
+}
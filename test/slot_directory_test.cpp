@@ -5,6 +5,9 @@
 #include <gtest/gtest.h>
 
 #include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
 
 #include "../include/common/types.h"
 #include "../include/page/page.h"
@@ -135,6 +138,30 @@ TEST(SlotDirectoryTest, ForwardingPointerMaxValues) {
   EXPECT_EQ(forward.slot_id, 123);
 }
 
+// Stubs carry 32-bit page ids and 16-bit slot ids; length-0 forwarded slots
+// from format version 1 still decode from next_ptr
+TEST(SlotDirectoryTest, ForwardingPointerWideAndLegacy) {
+  auto page = Page::CreateNew();
+  ASSERT_NE(page, nullptr);
+
+  slot_id_t slot_id = page->AddSlot(100, 50);
+  ASSERT_TRUE(page->SetForwardingPointer(slot_id, 4000000000u, 1000));
+  TupleId forward = page->GetForwardingPointer(slot_id);
+  EXPECT_EQ(forward.page_id, 4000000000u);
+  EXPECT_EQ(forward.slot_id, 1000);
+  EXPECT_EQ(page->GetSlotEntry(slot_id).length, FORWARD_STUB_SIZE);
+
+  slot_id_t legacy = page->AddSlot(200, 0);
+  SlotEntry& entry = page->GetSlotEntry(legacy);
+  entry.flags |= SLOT_FORWARDED;
+  entry.next_ptr[0] = 0xD2;
+  entry.next_ptr[1] = 0x04;
+  entry.next_ptr[2] = 0x2A;
+  forward = page->GetForwardingPointer(legacy);
+  EXPECT_EQ(forward.page_id, 1234);
+  EXPECT_EQ(forward.slot_id, 42);
+}
+
 // Test adding up to 1000 slots
 TEST(SlotDirectoryTest, Add1000Slots) {
   auto page = Page::CreateNew();
@@ -363,3 +390,67 @@ TEST(SlotDirectoryTest, ForwardingChain) {
   // Slot 2 should not be forwarded
   EXPECT_FALSE(page->IsSlotForwarded(slot2));
 }
+
+// Deleted slots are reused oldest deletion first, then the directory grows
+TEST(SlotDirectoryTest, FreeSlotListReusesInDeletionOrder) {
+  auto page = Page::CreateNew();
+  const std::string tuple(20, 'x');
+  for (int i = 0; i < 8; ++i) {
+    page->InsertTuple(tuple.data(), tuple.size());
+  }
+
+  ASSERT_EQ(page->DeleteTuple(6).code, 0);
+  ASSERT_EQ(page->DeleteTuple(2).code, 0);
+  ASSERT_EQ(page->DeleteTuple(4).code, 0);
+  EXPECT_EQ(page->InsertTuple(tuple.data(), tuple.size()), 6);
+  ASSERT_EQ(page->DeleteTuple(0).code, 0);
+  EXPECT_EQ(page->InsertTuple(tuple.data(), tuple.size()), 2);
+  EXPECT_EQ(page->InsertTuple(tuple.data(), tuple.size()), 4);
+  EXPECT_EQ(page->InsertTuple(tuple.data(), tuple.size()), 0);
+  EXPECT_EQ(page->InsertTuple(tuple.data(), tuple.size()), 8);
+  EXPECT_EQ(page->GetDeletedTupleCount(), 0);
+  EXPECT_TRUE(page->VerifyChecksum());
+}
+
+// Compaction relinks cleared slots in slot order; the list lives in the
+// page bytes, so a reread page keeps it
+TEST(SlotDirectoryTest, FreeSlotListSurvivesCompactionAndReread) {
+  auto page = Page::CreateNew();
+  const std::string tuple(20, 'x');
+  for (int i = 0; i < 10; ++i) {
+    page->InsertTuple(tuple.data(), tuple.size());
+  }
+  for (slot_id_t slot : {7, 1, 5, 3}) {
+    ASSERT_EQ(page->DeleteTuple(slot).code, 0);
+  }
+  page->CompactPage();
+  EXPECT_TRUE(page->GetFlags() & PAGE_FLAG_FREE_SLOT_LIST);
+
+  auto reread = Page::CreateNew();
+  std::memcpy(reread->GetRawBuffer(), page->GetRawBuffer(), PAGE_SIZE);
+  ASSERT_TRUE(reread->VerifyChecksum());
+  std::vector<slot_id_t> reused;
+  for (int i = 0; i < 5; ++i) {
+    reused.push_back(reread->InsertTuple(tuple.data(), tuple.size()));
+  }
+  EXPECT_EQ(reused, (std::vector<slot_id_t>{1, 3, 5, 7, 10}));
+}
+
+// A page written without the list gets it from one scan on insert
+TEST(SlotDirectoryTest, FreeSlotListBuiltForPageWithoutOne) {
+  auto page = Page::CreateNew();
+  const std::string tuple(20, 'x');
+  for (int i = 0; i < 6; ++i) {
+    page->InsertTuple(tuple.data(), tuple.size());
+  }
+  ASSERT_EQ(page->DeleteTuple(4).code, 0);
+  ASSERT_EQ(page->DeleteTuple(1).code, 0);
+  page->SetFlags(page->GetFlags() & ~PAGE_FLAG_FREE_SLOT_LIST);
+  page->SetChecksum(page->ComputeChecksum());
+
+  EXPECT_EQ(page->InsertTuple(tuple.data(), tuple.size()), 1);
+  EXPECT_TRUE(page->GetFlags() & PAGE_FLAG_FREE_SLOT_LIST);
+  EXPECT_EQ(page->InsertTuple(tuple.data(), tuple.size()), 4);
+  EXPECT_EQ(page->InsertTuple(tuple.data(), tuple.size()), 6);
+  EXPECT_TRUE(page->VerifyChecksum());
+}
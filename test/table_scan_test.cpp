@@ -0,0 +1,184 @@
+#include "../include/storage/table_scan.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+class TableScanTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    fs::create_directories("/tmp/test");
+    const std::string base =
+        "/tmp/test/scan_test_" +
+        std::to_string(
+            std::chrono::system_clock::now().time_since_epoch().count());
+    db_file_ = base + ".db";
+    fsm_file_ = base + ".fsm";
+    disk_manager_ = new DiskManager(db_file_, DurabilityMode::BATCHED);
+    fsm_ = new FreeSpaceMap(fsm_file_);
+    page_manager_ = new PageManager(disk_manager_, fsm_, 1);  // 128 frames
+  }
+
+  void TearDown() override {
+    delete page_manager_;
+    delete fsm_;
+    delete disk_manager_;
+    std::remove(db_file_.c_str());
+    std::remove(fsm_file_.c_str());
+  }
+
+  // Insert count tuples of tuple_size bytes; returns payload -> id
+  std::map<std::string, TupleId> InsertTuples(int count, size_t tuple_size) {
+    std::vector<std::string> payloads;
+    for (int i = 0; i < count; i++) {
+      std::string payload = "tuple-" + std::to_string(i) + "-";
+      payload.resize(tuple_size, 'x');
+      payloads.push_back(payload);
+    }
+    std::vector<TupleSlice> tuples;
+    for (const std::string& payload : payloads) {
+      tuples.push_back(
+          {payload.c_str(), static_cast<uint16_t>(payload.size())});
+    }
+    std::vector<TupleId> tids = page_manager_->InsertTuples(tuples);
+
+    std::map<std::string, TupleId> inserted;
+    for (int i = 0; i < count; i++) {
+      EXPECT_NE(tids[i].slot_id, INVALID_SLOT_ID);
+      inserted[payloads[i]] = tids[i];
+    }
+    return inserted;
+  }
+
+  static std::multiset<std::string> ScanAll(TableScan* scan) {
+    std::multiset<std::string> seen;
+    TupleView tuple;
+    while (scan->Next(&tuple)) {
+      seen.insert(std::string(tuple.data, tuple.size));
+    }
+    return seen;
+  }
+
+  std::string db_file_;
+  std::string fsm_file_;
+  DiskManager* disk_manager_;
+  FreeSpaceMap* fsm_;
+  PageManager* page_manager_;
+};
+
+TEST_F(TableScanTest, EmptyTable) {
+  TableScan scan(page_manager_);
+  TupleView tuple;
+  EXPECT_FALSE(scan.Next(&tuple));
+  EXPECT_EQ(scan.GetPagesScanned(), 0u);
+}
+
+TEST_F(TableScanTest, YieldsEveryLiveTupleOnce) {
+  std::map<std::string, TupleId> inserted = InsertTuples(2000, 100);
+
+  // Delete some and relocate others through a forwarding chain
+  std::multiset<std::string> expected;
+  int i = 0;
+  for (const auto& [payload, tid] : inserted) {
+    if (i % 10 == 0) {
+      ASSERT_EQ(page_manager_->DeleteTuple(tid).code, 0);
+    } else if (i % 10 == 1) {
+      const std::string grown = payload + std::string(3000, 'g');
+      ASSERT_EQ(page_manager_
+                    ->UpdateTuple(tid, grown.c_str(),
+                                  static_cast<uint16_t>(grown.size()))
+                    .code,
+                0);
+      expected.insert(grown);
+    } else {
+      expected.insert(payload);
+    }
+    i++;
+  }
+  ASSERT_EQ(page_manager_->FlushAllPages().code, 0);
+  page_manager_->ClearCache();
+
+  TableScan scan(page_manager_, 8);
+  EXPECT_EQ(ScanAll(&scan), expected);
+  EXPECT_EQ(scan.GetPagesScanned(), disk_manager_->GetNextPageId() - 1);
+  EXPECT_EQ(scan.GetPagesReadFromDisk(), scan.GetPagesScanned());
+}
+
+TEST_F(TableScanTest, SeesUnflushedPagesInBufferPool) {
+  std::map<std::string, TupleId> inserted = InsertTuples(300, 200);
+
+  std::multiset<std::string> expected;
+  for (const auto& entry : inserted) {
+    expected.insert(entry.first);
+  }
+
+  TableScan scan(page_manager_);
+  EXPECT_EQ(ScanAll(&scan), expected);
+  EXPECT_EQ(scan.GetPagesReadFromDisk(), 0u);
+}
+
+TEST_F(TableScanTest, FullScanDoesNotEvictHotPages) {
+  // Far more pages than the 128-frame pool holds
+  InsertTuples(1000, 4000);
+  ASSERT_EQ(page_manager_->FlushAllPages().code, 0);
+  page_manager_->ClearCache();
+
+  // Warm a small working set
+  BufferPoolManager* pool = page_manager_->GetBufferPool();
+  for (page_id_t page_id = 1; page_id <= 10; page_id++) {
+    ASSERT_NE(pool->FetchPage(page_id), nullptr);
+    pool->UnpinPage(page_id, false);
+  }
+  const size_t resident_before = pool->GetResidentPageCount();
+
+  TableScan scan(page_manager_);
+  EXPECT_EQ(ScanAll(&scan).size(), 1000u);
+  EXPECT_GT(scan.GetPagesReadFromDisk(), 400u);
+
+  EXPECT_EQ(pool->GetResidentPageCount(), resident_before);
+  for (page_id_t page_id = 1; page_id <= 10; page_id++) {
+    EXPECT_TRUE(pool->IsPageResident(page_id));
+  }
+}
+
+TEST_F(TableScanTest, RejectsInvalidArguments) {
+  EXPECT_THROW(TableScan(nullptr), std::invalid_argument);
+  EXPECT_THROW(TableScan(page_manager_, 0), std::invalid_argument);
+}
+
+TEST_F(TableScanTest, NextPageReturnsTheRestOfEachPage) {
+  std::map<std::string, TupleId> inserted = InsertTuples(500, 100);
+
+  TableScan scan(page_manager_);
+  TupleView first;
+  ASSERT_TRUE(scan.Next(&first));
+  std::map<std::string, TupleId> seen = {
+      {std::string(first.data, first.size), first.tuple_id}};
+
+  std::vector<TupleSlice> tuples;
+  std::vector<TupleId> tuple_ids;
+  size_t pages = 0;
+  while (scan.NextPage(&tuples, &tuple_ids)) {
+    ASSERT_FALSE(tuples.empty());
+    ASSERT_EQ(tuples.size(), tuple_ids.size());
+    // The first call finishes the page Next() started
+    EXPECT_EQ(tuple_ids.front().page_id,
+              pages == 0 ? first.tuple_id.page_id : tuple_ids.back().page_id);
+    for (size_t i = 0; i < tuples.size(); i++) {
+      EXPECT_EQ(tuple_ids[i].page_id, tuple_ids.front().page_id);
+      seen[std::string(tuples[i].data, tuples[i].size)] = tuple_ids[i];
+    }
+    pages++;
+  }
+  EXPECT_EQ(seen, inserted);
+  EXPECT_EQ(pages, scan.GetPagesScanned());
+  EXPECT_TRUE(tuples.empty());
+  EXPECT_FALSE(scan.Next(&first));
+}
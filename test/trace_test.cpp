@@ -0,0 +1,185 @@
+#include "../include/common/trace.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../include/storage/disk_manager.h"
+#include "../include/storage/free_space_map.h"
+#include "../include/storage/page_manager.h"
+
+namespace fs = std::filesystem;
+
+// The tracer is process-wide: every test starts and ends with it off
+class TraceTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    Tracer::Instance().SetSampleRate(0);
+    Tracer::Instance().Clear();
+  }
+
+  void TearDown() override {
+    Tracer::Instance().SetSampleRate(0);
+    Tracer::Instance().Clear();
+  }
+
+  static size_t CountNamed(const std::vector<TraceEvent>& events,
+                           const char* name) {
+    size_t count = 0;
+    for (const TraceEvent& event : events) {
+      count += std::strcmp(event.name, name) == 0;
+    }
+    return count;
+  }
+};
+
+TEST_F(TraceTest, NothingRecordedWhenOff) {
+  for (int i = 0; i < 100; i++) {
+    TraceSpan span("root");
+  }
+  EXPECT_TRUE(Tracer::Instance().Collect().empty());
+}
+
+TEST_F(TraceTest, NestedSpansRecordDepthAndContainment) {
+  Tracer::Instance().SetSampleRate(1);
+  {
+    TraceSpan root("root");
+    {
+      TraceSpan child("child");
+      TraceSpan grandchild("grandchild");
+    }
+    TraceSpan sibling("sibling");
+  }
+
+  std::vector<TraceEvent> events = Tracer::Instance().Collect();
+  ASSERT_EQ(events.size(), 4u);
+  EXPECT_STREQ(events[0].name, "root");
+  EXPECT_EQ(events[0].depth, 0u);
+  EXPECT_STREQ(events[1].name, "child");
+  EXPECT_EQ(events[1].depth, 1u);
+  EXPECT_STREQ(events[2].name, "grandchild");
+  EXPECT_EQ(events[2].depth, 2u);
+  EXPECT_STREQ(events[3].name, "sibling");
+  EXPECT_EQ(events[3].depth, 1u);
+  for (size_t i = 1; i < events.size(); i++) {
+    EXPECT_GE(events[i].start_ns, events[0].start_ns);
+    EXPECT_LE(events[i].start_ns + events[i].duration_ns,
+              events[0].start_ns + events[0].duration_ns);
+  }
+}
+
+TEST_F(TraceTest, SamplesWholeRootOperations) {
+  Tracer::Instance().SetSampleRate(10);
+  for (int i = 0; i < 100; i++) {
+    TraceSpan root("root");
+    TraceSpan child("child");
+  }
+  std::vector<TraceEvent> events = Tracer::Instance().Collect();
+  // One root in ten, always together with its child
+  EXPECT_EQ(CountNamed(events, "root"), 10u);
+  EXPECT_EQ(CountNamed(events, "child"), 10u);
+}
+
+TEST_F(TraceTest, ThreadsGetSeparateBuffers) {
+  Tracer::Instance().SetSampleRate(1);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([]() {
+      for (int i = 0; i < 50; i++) {
+        TraceSpan span("work");
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  // Buffers outlive their threads
+  std::vector<TraceEvent> events = Tracer::Instance().Collect();
+  EXPECT_EQ(events.size(), 200u);
+  std::set<uint32_t> thread_ids;
+  for (const TraceEvent& event : events) {
+    thread_ids.insert(event.thread_id);
+  }
+  EXPECT_EQ(thread_ids.size(), 4u);
+}
+
+TEST_F(TraceTest, RingBufferKeepsNewestSpans) {
+  Tracer::Instance().SetSampleRate(1);
+  std::thread([]() {
+    for (size_t i = 0; i < DEFAULT_TRACE_BUFFER_EVENTS + 100; i++) {
+      TraceSpan span(i < 100 ? "old" : "new");
+    }
+  }).join();
+
+  std::vector<TraceEvent> events = Tracer::Instance().Collect();
+  EXPECT_EQ(CountNamed(events, "old"), 0u);
+  EXPECT_EQ(CountNamed(events, "new"), DEFAULT_TRACE_BUFFER_EVENTS);
+}
+
+TEST_F(TraceTest, ExportsChromeTraceJson) {
+  Tracer::Instance().SetSampleRate(1);
+  {
+    TraceSpan root("PageManager::GetTuple");
+  }
+  const std::string json = Tracer::Instance().ExportChromeTrace();
+  EXPECT_EQ(json.rfind("{\"traceEvents\":[", 0), 0u);
+  EXPECT_NE(json.find("\"name\":\"PageManager::GetTuple\""),
+            std::string::npos);
+  EXPECT_NE(json.find("\"ph\":\"X\""), std::string::npos);
+  EXPECT_NE(json.find("\"dur\":"), std::string::npos);
+
+  fs::create_directories("/tmp/test");
+  const std::string path = "/tmp/test/trace_test.json";
+  ASSERT_TRUE(Tracer::Instance().WriteChromeTrace(path));
+  std::ifstream file(path);
+  std::stringstream contents;
+  contents << file.rdbuf();
+  EXPECT_EQ(contents.str(), json);
+  fs::remove(path);
+}
+
+TEST_F(TraceTest, BreaksDownColdTupleRead) {
+  fs::create_directories("/tmp/test");
+  const std::string base =
+      "/tmp/test/trace_test_" +
+      std::to_string(
+          std::chrono::system_clock::now().time_since_epoch().count());
+  {
+    DiskManager dm(base + ".db");
+    FreeSpaceMap fsm(base + ".fsm");
+    PageManager pm(&dm, &fsm);
+    const char data[] = "traced tuple";
+    TupleId id = pm.InsertTuple(data, sizeof(data));
+    ASSERT_NE(id.slot_id, INVALID_SLOT_ID);
+    pm.ClearCache();
+
+    Tracer::Instance().SetSampleRate(1);
+    char buffer[64];
+    ASSERT_EQ(pm.GetTuple(id, buffer, sizeof(buffer)).code, 0);
+    Tracer::Instance().SetSampleRate(0);
+
+    std::vector<TraceEvent> events = Tracer::Instance().Collect();
+    ASSERT_FALSE(events.empty());
+    EXPECT_STREQ(events[0].name, "PageManager::GetTuple");
+    EXPECT_EQ(events[0].depth, 0u);
+    EXPECT_EQ(CountNamed(events, "PageManager::GetTuple"), 1u);
+    EXPECT_EQ(CountNamed(events, "PageManager::FollowForwardingChainFull"),
+              1u);
+    EXPECT_GE(CountNamed(events, "PageManager::GetPage"), 1u);
+    EXPECT_GE(CountNamed(events, "BufferPoolManager::PartitionLatch"), 1u);
+    EXPECT_GE(CountNamed(events, "PageGuard::Latch"), 1u);
+    EXPECT_EQ(CountNamed(events, "DiskManager::ReadPage"), 1u);
+    EXPECT_EQ(CountNamed(events, "DiskManager::VerifyChecksum"), 1u);
+  }
+  fs::remove(base + ".db");
+  fs::remove(base + ".fsm");
+}
@@ -2,6 +2,8 @@
 
 #include <gtest/gtest.h>
 
+#include <cstring>
+
 #include "../include/tuple/tuple_builder.h"
 #include "../include/tuple/tuple_serializer.h"
 
@@ -225,3 +227,222 @@ TEST(TupleAccessorTest, LazyDeserialization) {
   EXPECT_EQ(accessor.GetInteger("id"), 42);
   EXPECT_EQ(accessor.GetString("name"), "Alice");
 }
+
+TEST(TupleAccessorTest, ProjectsSingleFieldOfWideTuple) {
+  Schema schema;
+  std::vector<FieldValue> values;
+  for (int i = 0; i < 30; i++) {
+    if (i % 3 == 2) {
+      schema.AddColumn("c" + std::to_string(i), DataType::VARCHAR, false, 64);
+      values.push_back(FieldValue::VarChar("value-" + std::to_string(i)));
+    } else if (i % 3 == 1) {
+      schema.AddColumn("c" + std::to_string(i), DataType::BIGINT, false, 0);
+      values.push_back(FieldValue::BigInt(i * 1000LL));
+    } else {
+      schema.AddColumn("c" + std::to_string(i), DataType::SMALLINT, false, 0);
+      values.push_back(FieldValue::SmallInt(static_cast<int16_t>(i)));
+    }
+  }
+  schema.Finalize();
+
+  char buffer[1024];
+  size_t size = TupleSerializer::SerializeVariableLength(schema, values, buffer,
+                                                         sizeof(buffer));
+
+  // Every column read on its own matches the full deserialization
+  std::vector<FieldValue> expected =
+      TupleSerializer::DeserializeVariableLength(schema, buffer, size);
+  TupleAccessor accessor(schema, buffer, size);
+  for (size_t i = 0; i < expected.size(); i++) {
+    FieldValue actual = accessor.GetFieldValue(i);
+    ASSERT_EQ(actual.GetType(), expected[i].GetType()) << "column " << i;
+    switch (actual.GetType()) {
+      case DataType::VARCHAR:
+        EXPECT_EQ(actual.GetString(), expected[i].GetString());
+        break;
+      case DataType::BIGINT:
+        EXPECT_EQ(actual.GetBigInt(), expected[i].GetBigInt());
+        break;
+      default:
+        EXPECT_EQ(actual.GetSmallInt(), expected[i].GetSmallInt());
+        break;
+    }
+  }
+
+  std::string_view last = accessor.GetStringView("c29");
+  EXPECT_EQ(last, "value-29");
+  EXPECT_GE(last.data(), buffer);
+  EXPECT_LT(last.data(), buffer + size);
+  EXPECT_EQ(accessor.GetBigInt(28), 28000);
+}
+
+TEST(TupleAccessorTest, BlobAndCharViews) {
+  Schema fixed;
+  fixed.AddColumn("code", DataType::CHAR, false, 8);
+  fixed.AddColumn("id", DataType::INTEGER, false, 0);
+  fixed.Finalize();
+
+  std::vector<FieldValue> fixed_values = {FieldValue::Char("abc"),
+                                          FieldValue::Integer(7)};
+  char fixed_buffer[64];
+  size_t fixed_size = TupleSerializer::SerializeFixedLength(
+      fixed, fixed_values, fixed_buffer, sizeof(fixed_buffer));
+
+  TupleAccessor fixed_accessor(fixed, fixed_buffer, fixed_size);
+  EXPECT_EQ(fixed_accessor.GetStringView("code"), "abc");
+  EXPECT_EQ(fixed_accessor.GetInteger("id"), 7);
+
+  Schema var;
+  var.AddColumn("payload", DataType::BLOB, false, 32);
+  var.AddColumn("note", DataType::TEXT, true, 32);
+  var.Finalize();
+
+  std::vector<uint8_t> bytes = {0, 1, 2, 255};
+  std::vector<FieldValue> var_values = {FieldValue::Blob(bytes),
+                                        FieldValue::Null(DataType::TEXT)};
+  char var_buffer[128];
+  size_t var_size = TupleSerializer::SerializeVariableLength(
+      var, var_values, var_buffer, sizeof(var_buffer));
+
+  TupleAccessor var_accessor(var, var_buffer, var_size);
+  std::string_view blob = var_accessor.GetBlobView("payload");
+  ASSERT_EQ(blob.size(), bytes.size());
+  EXPECT_EQ(std::memcmp(blob.data(), bytes.data(), bytes.size()), 0);
+  EXPECT_EQ(var_accessor.GetBlob("payload"), bytes);
+
+  EXPECT_TRUE(var_accessor.IsNull("note"));
+  EXPECT_THROW(var_accessor.GetStringView("note"), std::runtime_error);
+  EXPECT_TRUE(var_accessor.GetFieldValue("note").IsNull());
+  EXPECT_THROW(var_accessor.GetBlobView("note"), std::runtime_error);
+}
+
+TEST(TupleAccessorTest, TruncatedBufferThrows) {
+  Schema schema;
+  schema.AddColumn("id", DataType::INTEGER, false, 0);
+  schema.AddColumn("name", DataType::VARCHAR, false, 100);
+  schema.Finalize();
+
+  std::vector<FieldValue> values = {FieldValue::Integer(1),
+                                    FieldValue::VarChar("Alice")};
+  char buffer[256];
+  size_t size = TupleSerializer::SerializeVariableLength(schema, values, buffer,
+                                                         sizeof(buffer));
+
+  EXPECT_THROW(TupleAccessor(schema, buffer, 4), std::runtime_error);
+
+  TupleAccessor truncated(schema, buffer, size - 2);
+  EXPECT_EQ(truncated.GetInteger("id"), 1);
+  EXPECT_THROW(truncated.GetStringView("name"), std::runtime_error);
+}
+
+TEST(TupleAccessorTest, WideTableNullsPastSixtyFourColumns) {
+  Schema schema;
+  for (int i = 0; i < 80; i++) {
+    schema.AddColumn("c" + std::to_string(i), DataType::BIGINT, true, 0);
+  }
+  schema.AddColumn("tail", DataType::VARCHAR, true, 32);
+  schema.Finalize();
+
+  std::vector<FieldValue> values;
+  for (int i = 0; i < 80; i++) {
+    values.push_back(i == 5 || i == 72 ? FieldValue::Null(DataType::BIGINT)
+                                       : FieldValue::BigInt(i * 10));
+  }
+  values.push_back(FieldValue::VarChar("end"));
+
+  std::vector<char> buffer(2048);
+  size_t size = TupleSerializer::SerializeVariableLength(
+      schema, values, buffer.data(), buffer.size());
+
+  TupleAccessor accessor(schema, buffer.data(), size);
+  EXPECT_TRUE(accessor.IsNull(5));
+  EXPECT_TRUE(accessor.IsNull("c72"));
+  EXPECT_FALSE(accessor.IsNull(64));
+  EXPECT_EQ(accessor.GetBigInt(79), 790);
+  EXPECT_EQ(accessor.GetString("tail"), "end");
+}
+
+TEST(TupleAccessorTest, ResolvedColumnHandles) {
+  Schema schema;
+  schema.AddColumn("id", DataType::BIGINT, false, 0);
+  schema.AddColumn("code", DataType::CHAR, false, 8);
+  schema.AddColumn("name", DataType::VARCHAR, true, 100);
+  schema.AddColumn("score", DataType::DOUBLE, true, 0);
+  schema.Finalize();
+
+  const ColumnHandle id = schema.ResolveColumn("id");
+  const ColumnHandle code = schema.ResolveColumn("code");
+  const ColumnHandle name = schema.ResolveColumn("name");
+  const ColumnHandle score = schema.ResolveColumn("score");
+
+  std::vector<FieldValue> values = {
+      FieldValue::BigInt(9), FieldValue::Char("ab"),
+      FieldValue::VarChar("Alice"), FieldValue::Null(DataType::DOUBLE)};
+  char buffer[256];
+  size_t size = TupleSerializer::SerializeVariableLength(schema, values, buffer,
+                                                         sizeof(buffer));
+
+  TupleAccessor accessor(schema, buffer, size);
+  EXPECT_EQ(accessor.GetBigInt(id), 9);
+  EXPECT_EQ(accessor.GetStringView(code), "ab");
+  EXPECT_EQ(accessor.GetString(name), "Alice");
+  EXPECT_FALSE(accessor.IsNull(name));
+  EXPECT_TRUE(accessor.IsNull(score));
+  EXPECT_TRUE(accessor.GetFieldValue(score).IsNull());
+  EXPECT_EQ(accessor.GetFieldValue(name).GetString(), "Alice");
+
+  EXPECT_THROW(accessor.GetInteger(id), std::runtime_error);
+  EXPECT_THROW(accessor.GetDouble(score), std::runtime_error);
+  EXPECT_THROW(accessor.GetBlobView(name), std::runtime_error);
+}
+
+TEST(TupleAccessorTest, DictionaryEncodedColumnsDecodeTransparently) {
+  Schema schema;
+  schema.AddColumn("id", DataType::INTEGER, false, 0);
+  schema.AddColumn("status", DataType::VARCHAR, true, 32,
+                   ColumnEncoding::DICTIONARY);
+  schema.AddColumn("country", DataType::CHAR, false, 8,
+                   ColumnEncoding::DICTIONARY);
+  schema.Finalize();
+
+  Schema plain;
+  plain.AddColumn("id", DataType::INTEGER, false, 0);
+  plain.AddColumn("status", DataType::VARCHAR, true, 32);
+  plain.AddColumn("country", DataType::CHAR, false, 8);
+  plain.Finalize();
+
+  std::vector<FieldValue> values = {FieldValue::Integer(1),
+                                    FieldValue::VarChar("awaiting-payment"),
+                                    FieldValue::Char("DE")};
+  char buffer[256];
+  char plain_buffer[256];
+  size_t size = TupleSerializer::SerializeVariableLength(schema, values, buffer,
+                                                         sizeof(buffer));
+  size_t plain_size = TupleSerializer::SerializeVariableLength(
+      plain, values, plain_buffer, sizeof(plain_buffer));
+  EXPECT_LT(size, plain_size);
+
+  TupleAccessor accessor(schema, buffer, size);
+  EXPECT_EQ(accessor.GetString("status"), "awaiting-payment");
+  EXPECT_EQ(accessor.GetStringView("country"), "DE");
+  EXPECT_EQ(accessor.GetFieldValue("status").GetType(), DataType::VARCHAR);
+  EXPECT_EQ(accessor.GetString(schema.ResolveColumn("country")), "DE");
+  EXPECT_FALSE(accessor.IsStoredOutOfLine(1));
+  EXPECT_THROW(accessor.GetInteger("status"), std::runtime_error);
+
+  // Repeated values share a code; NULLs round-trip
+  std::vector<FieldValue> second = {FieldValue::Integer(2),
+                                    FieldValue::Null(DataType::VARCHAR),
+                                    FieldValue::Char("DE")};
+  size = TupleSerializer::SerializeVariableLength(schema, second, buffer,
+                                                  sizeof(buffer));
+  EXPECT_EQ(schema.GetDictionary(2)->GetSize(), 1);
+  TupleAccessor nulls(schema, buffer, size);
+  EXPECT_TRUE(nulls.IsNull("status"));
+  EXPECT_EQ(nulls.GetString("country"), "DE");
+
+  std::vector<FieldValue> decoded =
+      TupleSerializer::DeserializeVariableLength(schema, buffer, size);
+  EXPECT_TRUE(decoded[1].IsNull());
+  EXPECT_EQ(decoded[2].GetString(), "DE");
+}
@@ -178,3 +178,72 @@ TEST(TupleBuilderTest, IntegrationWithSerializer) {
   EXPECT_EQ(deserialized[0].GetInteger(), 123);
   EXPECT_EQ(deserialized[1].GetString(), "TestUser");
 }
+
+TEST(TupleBuilderTest, BuildRefsSerializeWithoutFieldValues) {
+  Schema schema;
+  schema.AddColumn("id", DataType::INTEGER, false, 0);
+  schema.AddColumn("name", DataType::VARCHAR, true, 100);
+  schema.Finalize();
+
+  TupleBuilder builder(schema);
+  char buffer[128];
+  for (int i = 0; i < 3; i++) {
+    builder.Reset();
+    builder.SetInteger("id", i);
+    std::string name = "user-" + std::to_string(i);
+    builder.SetVarChar("name", name);
+
+    const std::vector<ValueRef>& refs = builder.BuildRefs();
+    ASSERT_EQ(refs.size(), 2);
+    EXPECT_EQ(refs[1].GetString(), name);
+
+    size_t size = TupleSerializer::Serialize(schema, builder.BuildRefs(),
+                                             buffer, sizeof(buffer));
+    auto values =
+        TupleSerializer::DeserializeVariableLength(schema, buffer, size);
+    EXPECT_EQ(values[0].GetInteger(), i);
+    EXPECT_EQ(values[1].GetString(), name);
+  }
+
+  // Unset nullable fields come back as NULL
+  builder.Reset();
+  builder.SetInteger("id", 9);
+  EXPECT_TRUE(builder.BuildRefs()[1].IsNull());
+}
+
+TEST(TupleBuilderTest, ResolvedColumnHandles) {
+  Schema schema;
+  schema.AddColumn("id", DataType::INTEGER, false, 0);
+  schema.AddColumn("name", DataType::VARCHAR, true, 100);
+  schema.AddColumn("payload", DataType::BLOB, true, 100);
+  schema.Finalize();
+
+  const ColumnHandle id = schema.ResolveColumn("id");
+  const ColumnHandle name = schema.ResolveColumn("name");
+  const ColumnHandle payload = schema.ResolveColumn("payload");
+  EXPECT_EQ(id.GetFieldIndex(), 0);
+  EXPECT_EQ(name.GetDataType(), DataType::VARCHAR);
+  EXPECT_FALSE(id.is_nullable);
+  EXPECT_TRUE(name.is_nullable);
+  EXPECT_THROW(schema.ResolveColumn("missing"), std::runtime_error);
+
+  TupleBuilder builder(schema);
+  for (int row = 0; row < 3; row++) {
+    builder.Reset();
+    builder.SetInteger(id, row).SetVarChar(name, "row").SetNull(payload);
+    std::vector<FieldValue> values = builder.Build();
+    EXPECT_EQ(values[0].GetInteger(), row);
+    EXPECT_EQ(values[1].GetString(), "row");
+    EXPECT_TRUE(values[2].IsNull());
+  }
+
+  EXPECT_THROW(builder.SetBigInt(id, 1), std::runtime_error);
+  EXPECT_THROW(builder.SetNull(id), std::runtime_error);
+
+  // A handle from another schema whose column there has a different type
+  Schema other;
+  other.AddColumn("label", DataType::TEXT, false, 100);
+  other.Finalize();
+  EXPECT_THROW(builder.SetText(other.ResolveColumn("label"), "x"),
+               std::runtime_error);
+}
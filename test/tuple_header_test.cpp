@@ -2,6 +2,8 @@
 
 #include <gtest/gtest.h>
 
+#include <cstring>
+
 TEST(TupleHeaderTest, CreateHeader) {
   TupleHeader header(10, 2);
   EXPECT_EQ(header.GetFieldCount(), 10);
@@ -192,3 +194,46 @@ TEST(TupleHeaderTest, AlternatingNullPattern) {
     EXPECT_EQ(header.IsFieldNull(i), i % 2 == 0);
   }
 }
+
+TEST(TupleHeaderTest, NullBitmapGrowsPastSixtyFourFields) {
+  EXPECT_EQ(TupleHeader::CalculateNullBitmapSize(1), 8);
+  EXPECT_EQ(TupleHeader::CalculateNullBitmapSize(64), 8);
+  EXPECT_EQ(TupleHeader::CalculateNullBitmapSize(65), 16);
+  EXPECT_EQ(TupleHeader::CalculateNullBitmapSize(200), 32);
+
+  // Tables of up to 64 fields keep the 8-byte bitmap
+  EXPECT_EQ(TupleHeader::CalculateHeaderSize(64, 3),
+            TupleHeader::CalculateHeaderSize(3));
+  EXPECT_EQ(TupleHeader::CalculateHeaderSize(65, 0), 16);
+  EXPECT_EQ(TupleHeader::CalculateHeaderSize(200, 5), 48);
+}
+
+TEST(TupleHeaderTest, WideHeaderRoundTrip) {
+  TupleHeader header(200, 3);
+  for (uint16_t i : {0, 63, 64, 127, 128, 199}) {
+    header.SetFieldNull(i, true);
+  }
+  header.SetFieldNull(127, false);
+  header.SetVariableLengthOffset(0, 100);
+  header.SetVariableLengthOffset(2, 500);
+  ASSERT_EQ(header.GetHeaderSize(), 40);
+
+  char buffer[40];
+  header.SerializeTo(buffer);
+
+  // Offsets follow the whole bitmap
+  uint16_t offset;
+  std::memcpy(&offset, buffer + 32, sizeof(offset));
+  EXPECT_EQ(offset, 100);
+
+  auto deserialized = TupleHeader::DeserializeFrom(buffer, 200, 3);
+  for (uint16_t i = 0; i < 200; i++) {
+    const bool expected =
+        i == 0 || i == 63 || i == 64 || i == 128 || i == 199;
+    EXPECT_EQ(deserialized.IsFieldNull(i), expected) << i;
+    EXPECT_EQ(TupleHeader::IsNullBitSet(buffer, i), expected) << i;
+  }
+  EXPECT_EQ(deserialized.GetVariableLengthOffset(0), 100);
+  EXPECT_EQ(deserialized.GetVariableLengthOffset(1), 0);
+  EXPECT_EQ(deserialized.GetVariableLengthOffset(2), 500);
+}
@@ -2,6 +2,8 @@
 
 #include <gtest/gtest.h>
 
+#include <cstring>
+
 TEST(TupleSerializerTest, SerializeFixedLengthAllTypes) {
   Schema schema;
   schema.AddColumn("col_bool", DataType::BOOLEAN, false, 0);
@@ -333,3 +335,131 @@ TEST(TupleSerializerTest, ErrorWrongSerializationMethod) {
                                                      sizeof(buffer)),
                std::runtime_error);
 }
+
+TEST(TupleSerializerTest, VariableLengthFollowsSchemaLayout) {
+  Schema schema;
+  schema.AddColumn("code", DataType::CHAR, false, 4);
+  schema.AddColumn("name", DataType::VARCHAR, true, 100);
+  schema.AddColumn("id", DataType::BIGINT, false, 0);
+  schema.AddColumn("payload", DataType::BLOB, true, 100);
+  schema.Finalize();
+
+  std::vector<FieldValue> values;
+  values.push_back(FieldValue::Char("ab"));
+  values.push_back(FieldValue::Null(DataType::VARCHAR));
+  values.push_back(FieldValue::BigInt(-7));
+  values.push_back(FieldValue::Blob({9, 8, 7}));
+
+  char buffer[256];
+  size_t size = TupleSerializer::SerializeVariableLength(schema, values, buffer,
+                                                         sizeof(buffer));
+
+  // Fixed fields sit at their planned offsets after the header
+  const std::vector<FieldLayout>& layout = schema.GetLayout();
+  int64_t id;
+  std::memcpy(&id, buffer + layout[2].offset, sizeof(id));
+  EXPECT_EQ(id, -7);
+  EXPECT_EQ(std::string(buffer + layout[0].offset), "ab");
+
+  // Variable data starts 8-byte aligned: [len=3][9 8 7]
+  size_t var_start = (schema.GetFixedSectionEnd() + 7) / 8 * 8;
+  EXPECT_EQ(size, var_start + sizeof(uint16_t) + 3);
+
+  std::vector<FieldValue> result =
+      TupleSerializer::DeserializeVariableLength(schema, buffer, size);
+  ASSERT_EQ(result.size(), 4);
+  EXPECT_EQ(result[0].GetString(), "ab");
+  EXPECT_TRUE(result[1].IsNull());
+  EXPECT_EQ(result[2].GetBigInt(), -7);
+  EXPECT_EQ(result[3].GetBlob(), std::vector<uint8_t>({9, 8, 7}));
+}
+
+TEST(TupleSerializerTest, ValueRefRoundTripReusesArena) {
+  Schema schema;
+  schema.AddColumn("id", DataType::INTEGER, false, 0);
+  schema.AddColumn("name", DataType::VARCHAR, true, 100);
+  schema.AddColumn("payload", DataType::BLOB, false, 100);
+  schema.Finalize();
+
+  Arena arena;
+  std::vector<ValueRef> values = {
+      ValueRef::Integer(5), ValueRef::VarChar("alpha", &arena),
+      ValueRef::Blob(std::string_view("\x00\xff", 2), &arena)};
+
+  char buffer[256];
+  size_t size =
+      TupleSerializer::Serialize(schema, values, buffer, sizeof(buffer));
+
+  // Byte-identical to the FieldValue path
+  std::vector<FieldValue> owned = {FieldValue::Integer(5),
+                                   FieldValue::VarChar("alpha"),
+                                   FieldValue::Blob({0x00, 0xff})};
+  char expected[256];
+  size_t expected_size = TupleSerializer::SerializeVariableLength(
+      schema, owned, expected, sizeof(expected));
+  ASSERT_EQ(size, expected_size);
+  EXPECT_EQ(std::memcmp(buffer, expected, size), 0);
+
+  std::vector<ValueRef> decoded;
+  size_t capacity = 0;
+  for (int batch = 0; batch < 3; batch++) {
+    arena.Reset();
+    TupleSerializer::Deserialize(schema, buffer, size, &arena, &decoded);
+    ASSERT_EQ(decoded.size(), 3);
+    EXPECT_EQ(decoded[0].GetInteger(), 5);
+    EXPECT_EQ(decoded[1].GetString(), "alpha");
+    EXPECT_EQ(decoded[2].GetBlob().size(), 2);
+    if (batch == 0) {
+      capacity = arena.GetCapacity();
+    }
+    EXPECT_EQ(arena.GetCapacity(), capacity);
+  }
+
+  // No arena: views point into the tuple buffer
+  TupleSerializer::Deserialize(schema, buffer, size, nullptr, &decoded);
+  EXPECT_GE(decoded[1].GetString().data(), buffer);
+  EXPECT_LT(decoded[1].GetString().data(), buffer + size);
+}
+
+TEST(TupleSerializerTest, WideTableRoundTripsPastSixtyFourColumns) {
+  // 150 columns: every 10th a VARCHAR, the rest INTEGER, all nullable
+  Schema schema;
+  for (int i = 0; i < 150; i++) {
+    schema.AddColumn("c" + std::to_string(i),
+                     i % 10 == 0 ? DataType::VARCHAR : DataType::INTEGER, true,
+                     i % 10 == 0 ? 16 : 0);
+  }
+  schema.Finalize();
+  EXPECT_EQ(schema.GetVarOffsetsStart(), 24);
+  EXPECT_EQ(schema.GetTupleHeaderSize(), 56);  // 24 + 15 offsets, padded
+
+  std::vector<FieldValue> values;
+  for (int i = 0; i < 150; i++) {
+    if (i == 3 || i == 70 || i == 130 || i == 149) {
+      values.push_back(FieldValue::Null(schema.GetLayout()[i].type));
+    } else if (i % 10 == 0) {
+      values.push_back(FieldValue::VarChar("v" + std::to_string(i)));
+    } else {
+      values.push_back(FieldValue::Integer(i));
+    }
+  }
+
+  std::vector<char> buffer(4096);
+  size_t size = TupleSerializer::SerializeVariableLength(
+      schema, values, buffer.data(), buffer.size());
+
+  std::vector<FieldValue> result =
+      TupleSerializer::DeserializeVariableLength(schema, buffer.data(), size);
+  ASSERT_EQ(result.size(), 150);
+  for (int i = 0; i < 150; i++) {
+    ASSERT_EQ(result[i].IsNull(), values[i].IsNull()) << i;
+    if (values[i].IsNull()) {
+      continue;
+    }
+    if (i % 10 == 0) {
+      EXPECT_EQ(result[i].GetString(), "v" + std::to_string(i));
+    } else {
+      EXPECT_EQ(result[i].GetInteger(), i);
+    }
+  }
+}
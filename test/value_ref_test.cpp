@@ -0,0 +1,53 @@
+#include "../include/tuple/value_ref.h"
+
+#include <gtest/gtest.h>
+
+TEST(ValueRefTest, FixedValuesAreInline) {
+  EXPECT_EQ(sizeof(ValueRef), 16);
+
+  EXPECT_TRUE(ValueRef::Boolean(true).GetBoolean());
+  EXPECT_EQ(ValueRef::SmallInt(-3).GetSmallInt(), -3);
+  EXPECT_EQ(ValueRef::BigInt(1LL << 50).GetBigInt(), 1LL << 50);
+  EXPECT_DOUBLE_EQ(ValueRef::Double(2.5).GetDouble(), 2.5);
+  EXPECT_EQ(ValueRef::Integer(7).GetSerializedSize(), 4);
+
+  EXPECT_THROW(ValueRef::Integer(7).GetBigInt(), std::runtime_error);
+  ValueRef null = ValueRef::Null(DataType::INTEGER);
+  EXPECT_TRUE(null.IsNull());
+  EXPECT_THROW(null.GetInteger(), std::runtime_error);
+  EXPECT_EQ(null.GetSerializedSize(), 0);
+}
+
+TEST(ValueRefTest, StringsLiveInArena) {
+  Arena arena;
+  std::string source = "arena-backed";
+  ValueRef text = ValueRef::VarChar(source, &arena);
+  source.assign(source.size(), '#');  // the copy is independent
+
+  EXPECT_EQ(text.GetString(), "arena-backed");
+  EXPECT_EQ(text.GetSerializedSize(), 2 + 12);
+  EXPECT_THROW(text.GetBlob(), std::runtime_error);
+
+  // Without an arena the value borrows the caller's bytes
+  ValueRef borrowed = ValueRef::Text(source, nullptr);
+  EXPECT_EQ(borrowed.GetString().data(), source.data());
+}
+
+TEST(ValueRefTest, ConvertsToAndFromFieldValue) {
+  Arena arena;
+  std::vector<FieldValue> values = {
+      FieldValue::Integer(11), FieldValue::Char("ab"),
+      FieldValue::Blob({1, 2, 3}), FieldValue::Null(DataType::TEXT)};
+
+  for (const FieldValue& value : values) {
+    ValueRef ref = ValueRef::FromFieldValue(value, &arena);
+    FieldValue back = ref.ToFieldValue();
+    ASSERT_EQ(back.GetType(), value.GetType());
+    ASSERT_EQ(back.IsNull(), value.IsNull());
+    EXPECT_EQ(back.GetSerializedSize(), value.GetSerializedSize());
+  }
+
+  ValueRef blob = ValueRef::FromFieldValue(values[2], &arena);
+  EXPECT_EQ(blob.GetBlob(), std::string_view("\x01\x02\x03", 3));
+  EXPECT_EQ(blob.ToFieldValue().GetBlob(), std::vector<uint8_t>({1, 2, 3}));
+}
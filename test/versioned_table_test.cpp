@@ -0,0 +1,294 @@
+#include "../include/storage/versioned_table.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../include/storage/page_manager.h"
+
+namespace fs = std::filesystem;
+
+class VersionedTableTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    fs::create_directories("/tmp/test");
+    base_ = "/tmp/test/versioned_table_test_" +
+            std::to_string(
+                std::chrono::system_clock::now().time_since_epoch().count());
+  }
+
+  void TearDown() override {
+    for (const char* suffix : {".db", ".fsm", ".clock"}) {
+      std::remove((base_ + suffix).c_str());
+    }
+  }
+
+  static TupleId Insert(VersionedTable* table, const std::string& value) {
+    return table->InsertTuple(value.data(),
+                              static_cast<uint16_t>(value.size()));
+  }
+
+  static ErrorCode Update(VersionedTable* table, TupleId tuple_id,
+                          const std::string& value) {
+    return table->UpdateTuple(tuple_id, value.data(),
+                              static_cast<uint16_t>(value.size()));
+  }
+
+  static std::string Get(const VersionedTable& table, TupleId tuple_id,
+                         const Snapshot& snapshot) {
+    std::vector<char> bytes;
+    if (table.GetTuple(tuple_id, snapshot, &bytes).code != 0) {
+      return "<none>";
+    }
+    return std::string(bytes.begin(), bytes.end());
+  }
+
+  // Value of every tuple the scan returns, by the id it was inserted under
+  static std::map<std::pair<page_id_t, slot_id_t>, std::string> Scan(
+      const VersionedTable& table, const Snapshot& snapshot,
+      size_t* duplicates = nullptr) {
+    std::map<std::pair<page_id_t, slot_id_t>, std::string> values;
+    VersionedScan scan(&table, snapshot);
+    TupleView tuple;
+    while (scan.Next(&tuple)) {
+      const bool added =
+          values
+              .emplace(std::make_pair(tuple.tuple_id.page_id,
+                                      tuple.tuple_id.slot_id),
+                       std::string(tuple.data, tuple.size))
+              .second;
+      if (!added && duplicates != nullptr) {
+        ++*duplicates;
+      }
+    }
+    return values;
+  }
+
+  std::string base_;
+};
+
+TEST_F(VersionedTableTest, SnapshotsExcludeWritesInProgress) {
+  uint64_t last = 0;
+  {
+    VersionClock clock(base_ + ".clock");
+    const uint64_t first = clock.BeginWrite();
+    clock.EndWrite(first);
+    const uint64_t second = clock.BeginWrite();
+    ASSERT_GT(second, first);
+
+    Snapshot during = clock.TakeSnapshot();
+    EXPECT_EQ(during.GetTimestamp(), first);
+    clock.EndWrite(second);
+    Snapshot after = clock.TakeSnapshot();
+    EXPECT_EQ(after.GetTimestamp(), second);
+
+    // The oldest registered snapshot holds vacuuming back
+    EXPECT_EQ(clock.GetOldestSnapshotTimestamp(), first);
+    during.Release();
+    EXPECT_EQ(clock.GetOldestSnapshotTimestamp(), second);
+    last = clock.GetLastTimestamp();
+  }
+
+  // Timestamps keep growing after a reopen
+  VersionClock reopened(base_ + ".clock");
+  const uint64_t next = reopened.BeginWrite();
+  EXPECT_GT(next, last);
+  reopened.EndWrite(next);
+}
+
+TEST_F(VersionedTableTest, SnapshotSeesVersionAsOfItsTimestamp) {
+  DiskManager disk_manager(base_ + ".db");
+  FreeSpaceMap fsm(base_ + ".fsm");
+  PageManager page_manager(&disk_manager, &fsm, 1);
+  VersionClock clock(base_ + ".clock");
+  VersionedTable table(&page_manager, &clock);
+
+  const Snapshot before = table.TakeSnapshot();
+  const TupleId id = Insert(&table, "first");
+  ASSERT_NE(id.page_id, static_cast<page_id_t>(INVALID_PAGE_ID));
+  const Snapshot inserted = table.TakeSnapshot();
+  ASSERT_EQ(Update(&table, id, "second version").code, 0);
+  const Snapshot updated = table.TakeSnapshot();
+  ASSERT_EQ(table.DeleteTuple(id).code, 0);
+  const Snapshot deleted = table.TakeSnapshot();
+
+  EXPECT_EQ(Get(table, id, before), "<none>");
+  EXPECT_EQ(Get(table, id, inserted), "first");
+  EXPECT_EQ(Get(table, id, updated), "second version");
+  EXPECT_EQ(Get(table, id, deleted), "<none>");
+
+  std::vector<char> latest;
+  EXPECT_NE(table.GetTuple(id, &latest).code, 0);
+  EXPECT_NE(Update(&table, id, "too late").code, 0);
+  EXPECT_NE(table.DeleteTuple(id).code, 0);
+
+  EXPECT_EQ(Scan(table, inserted).size(), 1u);
+  EXPECT_EQ(Scan(table, updated).begin()->second, "second version");
+  EXPECT_TRUE(Scan(table, deleted).empty());
+}
+
+TEST_F(VersionedTableTest, ScanSeesEachTupleOnceAcrossUpdates) {
+  DiskManager disk_manager(base_ + ".db");
+  FreeSpaceMap fsm(base_ + ".fsm");
+  PageManager page_manager(&disk_manager, &fsm, 1);
+  VersionClock clock(base_ + ".clock");
+  VersionedTable table(&page_manager, &clock);
+
+  std::vector<TupleId> ids;
+  for (int i = 0; i < 500; i++) {
+    ids.push_back(Insert(&table, "v0-" + std::to_string(i)));
+  }
+  const Snapshot old_snapshot = table.TakeSnapshot();
+
+  // New versions land on later pages than the ones they supersede
+  for (int i = 0; i < 500; i++) {
+    ASSERT_EQ(Update(&table, ids[i],
+                     "v1-" + std::to_string(i) + std::string(100, 'x'))
+                  .code,
+              0);
+  }
+  const Snapshot new_snapshot = table.TakeSnapshot();
+
+  size_t duplicates = 0;
+  const auto old_values = Scan(table, old_snapshot, &duplicates);
+  const auto new_values = Scan(table, new_snapshot, &duplicates);
+  EXPECT_EQ(duplicates, 0u);
+  ASSERT_EQ(old_values.size(), 500u);
+  ASSERT_EQ(new_values.size(), 500u);
+  for (int i = 0; i < 500; i++) {
+    const auto key = std::make_pair(ids[i].page_id, ids[i].slot_id);
+    EXPECT_EQ(old_values.at(key), "v0-" + std::to_string(i));
+    EXPECT_EQ(new_values.at(key).substr(0, 3), "v1-");
+  }
+}
+
+TEST_F(VersionedTableTest, ConcurrentUpdatesNeverTearAScan) {
+  DiskManager disk_manager(base_ + ".db");
+  FreeSpaceMap fsm(base_ + ".fsm");
+  PageManager page_manager(&disk_manager, &fsm, 1);
+  VersionClock clock(base_ + ".clock");
+  VersionedTable table(&page_manager, &clock);
+
+  constexpr int kTuples = 200;
+  std::vector<TupleId> ids;
+  for (int i = 0; i < kTuples; i++) {
+    ids.push_back(Insert(&table, "0"));
+  }
+
+  std::atomic<bool> stop{false};
+  std::thread writer([&] {
+    for (int round = 1; !stop.load(); round++) {
+      for (int i = 0; i < kTuples; i++) {
+        Update(&table, ids[i], std::to_string(round));
+      }
+    }
+  });
+
+  for (int scans = 0; scans < 20; scans++) {
+    const Snapshot snapshot = table.TakeSnapshot();
+    size_t duplicates = 0;
+    const auto values = Scan(table, snapshot, &duplicates);
+    EXPECT_EQ(duplicates, 0u);
+    EXPECT_EQ(values.size(), static_cast<size_t>(kTuples));
+
+    // What the scan saw is what point reads at the snapshot see
+    for (int i = 0; i < kTuples; i += 37) {
+      const auto key = std::make_pair(ids[i].page_id, ids[i].slot_id);
+      EXPECT_EQ(values.at(key), Get(table, ids[i], snapshot));
+    }
+  }
+  stop = true;
+  writer.join();
+}
+
+TEST_F(VersionedTableTest, VacuumFreesVersionsNoSnapshotSees) {
+  DiskManager disk_manager(base_ + ".db");
+  FreeSpaceMap fsm(base_ + ".fsm");
+  PageManager page_manager(&disk_manager, &fsm, 1);
+  VersionClock clock(base_ + ".clock");
+  VersionedTable table(&page_manager, &clock);
+
+  std::vector<TupleId> ids;
+  for (int i = 0; i < 10; i++) {
+    ids.push_back(Insert(&table, "v0"));
+    ASSERT_EQ(Update(&table, ids[i], "v1").code, 0);
+    ASSERT_EQ(Update(&table, ids[i], "v2").code, 0);
+  }
+  Snapshot snapshot = table.TakeSnapshot();
+  for (const TupleId& id : ids) {
+    ASSERT_EQ(Update(&table, id, "v3").code, 0);
+  }
+
+  // v0 (the home becomes a marker) and v1 go; the snapshot still needs v2
+  EXPECT_EQ(table.Vacuum(), 20u);
+  EXPECT_EQ(table.Vacuum(), 0u);
+  for (const TupleId& id : ids) {
+    EXPECT_EQ(Get(table, id, snapshot), "v2");
+    EXPECT_EQ(Get(table, id, table.TakeSnapshot()), "v3");
+  }
+
+  snapshot.Release();
+  EXPECT_EQ(table.Vacuum(), 10u);
+  ASSERT_EQ(table.DeleteTuple(ids[0]).code, 0);
+  EXPECT_EQ(table.Vacuum(), 1u);
+
+  const Snapshot now = table.TakeSnapshot();
+  EXPECT_EQ(Get(table, ids[0], now), "<none>");
+  const auto values = Scan(table, now);
+  EXPECT_EQ(values.size(), 9u);
+  for (const auto& entry : values) {
+    EXPECT_EQ(entry.second, "v3");
+  }
+  for (size_t i = 1; i < ids.size(); i++) {
+    ASSERT_EQ(Update(&table, ids[i], "v4").code, 0);
+    EXPECT_EQ(Get(table, ids[i], table.TakeSnapshot()), "v4");
+  }
+}
+
+TEST_F(VersionedTableTest, VacuumFreesUnlinkedPendingVersions) {
+  DiskManager disk_manager(base_ + ".db");
+  FreeSpaceMap fsm(base_ + ".fsm");
+  PageManager page_manager(&disk_manager, &fsm, 1);
+  VersionClock clock(base_ + ".clock");
+  VersionedTable table(&page_manager, &clock);
+
+  const TupleId id = Insert(&table, "kept");
+
+  // What a crash right after storing an update's new version leaves behind
+  const uint64_t timestamp = clock.BeginWrite();
+  clock.EndWrite(timestamp);
+  TupleVersionHeader header{};
+  header.created_ts = timestamp;
+  header.deleted_ts = VERSION_TS_INFINITY;
+  header.home_page_id = id.page_id;
+  header.home_slot_id = id.slot_id;
+  header.flags = VERSION_PENDING;
+  header.next_page_id = INVALID_PAGE_ID;
+  header.next_slot_id = INVALID_SLOT_ID;
+  std::vector<char> orphan(sizeof(header) + 4);
+  std::memcpy(orphan.data(), &header, sizeof(header));
+  std::memcpy(orphan.data() + sizeof(header), "lost", 4);
+  const TupleId orphan_id = page_manager.InsertTuple(
+      orphan.data(), static_cast<uint16_t>(orphan.size()));
+  ASSERT_NE(orphan_id.page_id, static_cast<page_id_t>(INVALID_PAGE_ID));
+
+  const Snapshot snapshot = table.TakeSnapshot();
+  const auto values = Scan(table, snapshot);
+  ASSERT_EQ(values.size(), 1u);
+  EXPECT_EQ(values.begin()->second, "kept");
+
+  EXPECT_EQ(table.Vacuum(), 1u);
+  PinnedTuple stored;
+  EXPECT_NE(page_manager.GetTupleView(orphan_id, &stored).code, 0);
+  EXPECT_EQ(Get(table, id, snapshot), "kept");
+  ASSERT_EQ(Update(&table, id, "updated").code, 0);
+  EXPECT_EQ(Get(table, id, table.TakeSnapshot()), "updated");
+}
@@ -0,0 +1,190 @@
+#include "../include/workload/workload_driver.h"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <sstream>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+TEST(ZipfianGeneratorTest, RanksStayInRangeAndFavorLowRanks) {
+  ZipfianGenerator zipfian(1000, 0.99);
+  std::vector<uint64_t> hits(1000, 0);
+  const int draws = 100000;
+  for (int i = 0; i < draws; i++) {
+    uint64_t rank = zipfian.Next((i + 0.5) / draws);
+    ASSERT_LT(rank, 1000u);
+    hits[rank]++;
+  }
+  // With theta 0.99 rank 0 takes roughly 1/zeta(1000) ~ 13% of the draws
+  EXPECT_GT(hits[0], static_cast<uint64_t>(draws / 10));
+  EXPECT_GT(hits[0], hits[1]);
+  EXPECT_GT(hits[1], hits[10]);
+  EXPECT_GT(hits[10], hits[500]);
+  EXPECT_EQ(zipfian.Next(0.0), 0u);
+  EXPECT_EQ(zipfian.Next(0.999999), 999u);
+}
+
+TEST(ZipfianGeneratorTest, RejectsInvalidParameters) {
+  EXPECT_THROW(ZipfianGenerator(0, 0.99), std::invalid_argument);
+  EXPECT_THROW(ZipfianGenerator(10, 1.0), std::invalid_argument);
+  EXPECT_THROW(ZipfianGenerator(10, 0.0), std::invalid_argument);
+}
+
+TEST(WorkloadArgsTest, ParsesOptions) {
+  WorkloadConfig config;
+  std::string error;
+  ASSERT_TRUE(ParseWorkloadArgs(
+      {"--records=500", "--operations=2000", "--read=0.9", "--update=0.05",
+       "--insert=0.05", "--distribution=uniform", "--min-tuple-size=50",
+       "--max-tuple-size=200", "--threads=4", "--cache-mb=16",
+       "--replacer=clock", "--durability=periodic", "--wal", "--dir=/tmp/x",
+       "--seed=7"},
+      &config, &error))
+      << error;
+  EXPECT_EQ(config.record_count, 500u);
+  EXPECT_EQ(config.operation_count, 2000u);
+  EXPECT_DOUBLE_EQ(config.read_proportion, 0.9);
+  EXPECT_DOUBLE_EQ(config.update_proportion, 0.05);
+  EXPECT_DOUBLE_EQ(config.insert_proportion, 0.05);
+  EXPECT_EQ(config.distribution, KeyDistribution::UNIFORM);
+  EXPECT_EQ(config.min_tuple_size, 50);
+  EXPECT_EQ(config.max_tuple_size, 200);
+  EXPECT_EQ(config.threads, 4u);
+  EXPECT_EQ(config.cache_mb, 16u);
+  EXPECT_EQ(config.replacer, ReplacerType::CLOCK);
+  EXPECT_EQ(config.durability, DurabilityMode::PERIODIC);
+  EXPECT_TRUE(config.use_wal);
+  EXPECT_FALSE(config.direct_io);
+  EXPECT_EQ(config.directory, "/tmp/x");
+  EXPECT_EQ(config.seed, 7u);
+}
+
+TEST(WorkloadArgsTest, TraceDefaultsSampleRate) {
+  WorkloadConfig config;
+  std::string error;
+  ASSERT_TRUE(ParseWorkloadArgs({"--trace=/tmp/x.json"}, &config, &error));
+  EXPECT_EQ(config.trace_file, "/tmp/x.json");
+  EXPECT_EQ(config.trace_sample_rate, 100u);
+
+  ASSERT_TRUE(ParseWorkloadArgs({"--trace-sample=5"}, &config, &error));
+  EXPECT_EQ(config.trace_sample_rate, 5u);
+}
+
+TEST(WorkloadArgsTest, RejectsBadOptionsAndKeepsConfig) {
+  const std::vector<std::vector<std::string>> bad = {
+      {"--bogus=1"},
+      {"records=5"},
+      {"--threads=zero"},
+      {"--threads=0"},
+      {"--read=-1"},
+      {"--read=0", "--update=0"},
+      {"--tuple-size=9000"},
+      {"--min-tuple-size=200", "--max-tuple-size=100"},
+      {"--theta=1.5"},
+      {"--distribution=normal"},
+      {"--wal=yes"},
+      {"--records"},
+  };
+  for (const auto& args : bad) {
+    WorkloadConfig config;
+    std::string error;
+    EXPECT_FALSE(ParseWorkloadArgs(args, &config, &error)) << args[0];
+    EXPECT_FALSE(error.empty());
+    EXPECT_EQ(config.threads, WorkloadConfig().threads);
+  }
+}
+
+TEST(WorkloadDriverTest, RunsMixedWorkload) {
+  const std::string dir = "/tmp/test/workload_driver";
+  fs::remove_all(dir);
+  fs::create_directories(dir);
+  WorkloadConfig config;
+  config.record_count = 2000;
+  config.operation_count = 4000;
+  config.read_proportion = 0.5;
+  config.update_proportion = 0.2;
+  config.insert_proportion = 0.2;
+  config.delete_proportion = 0.1;
+  config.min_tuple_size = 20;
+  config.max_tuple_size = 300;
+  config.threads = 1;
+  config.cache_mb = 1;
+  config.directory = dir;
+
+  WorkloadReport report;
+  ErrorCode result = RunWorkload(config, &report);
+  ASSERT_EQ(result.code, 0) << result.message;
+
+  EXPECT_EQ(report.GetTotalOperations(), config.operation_count);
+  uint64_t failed = 0;
+  for (const WorkloadOpStats& stats : report.ops) {
+    EXPECT_GT(stats.latency.GetCount(), 0u);
+    EXPECT_EQ(stats.completed + stats.not_found + stats.failed,
+              stats.latency.GetCount());
+    failed += stats.failed;
+  }
+  EXPECT_EQ(failed, 0u);
+  EXPECT_EQ(report.ops[static_cast<size_t>(WorkloadOp::INSERT)].not_found,
+            0u);
+  EXPECT_GT(report.GetThroughput(), 0.0);
+
+  std::ostringstream out;
+  PrintWorkloadReport(config, report, out);
+  EXPECT_NE(out.str().find("p999 us"), std::string::npos);
+  EXPECT_NE(out.str().find("DELETE"), std::string::npos);
+
+  // The table files are removed after the run
+  EXPECT_TRUE(fs::is_empty(dir));
+  fs::remove_all(dir);
+}
+
+// Concurrent updates of one key may race (there is no tuple-level lock), so
+// with several threads only the accounting is checked
+TEST(WorkloadDriverTest, RunsConcurrently) {
+  fs::create_directories("/tmp/test");
+  WorkloadConfig config;
+  config.record_count = 2000;
+  config.operation_count = 8000;
+  config.read_proportion = 0.8;
+  config.update_proportion = 0.1;
+  config.insert_proportion = 0.1;
+  config.threads = 4;
+  config.directory = "/tmp/test";
+
+  WorkloadReport report;
+  ErrorCode result = RunWorkload(config, &report);
+  ASSERT_EQ(result.code, 0) << result.message;
+  EXPECT_EQ(report.GetTotalOperations(), config.operation_count);
+  const WorkloadOpStats& inserts =
+      report.ops[static_cast<size_t>(WorkloadOp::INSERT)];
+  EXPECT_EQ(inserts.completed, inserts.latency.GetCount());
+}
+
+TEST(WorkloadDriverTest, RunsWithWriteAheadLog) {
+  fs::create_directories("/tmp/test");
+  WorkloadConfig config;
+  config.record_count = 500;
+  config.operation_count = 1000;
+  config.read_proportion = 0.5;
+  config.update_proportion = 0.5;
+  config.distribution = KeyDistribution::UNIFORM;
+  config.threads = 2;
+  config.use_wal = true;
+  config.directory = "/tmp/test";
+
+  WorkloadReport report;
+  ErrorCode result = RunWorkload(config, &report);
+  ASSERT_EQ(result.code, 0) << result.message;
+  EXPECT_EQ(report.ops[static_cast<size_t>(WorkloadOp::READ)].completed +
+                report.ops[static_cast<size_t>(WorkloadOp::UPDATE)].completed,
+            config.operation_count);
+}
+
+TEST(WorkloadDriverTest, RejectsInvalidConfig) {
+  WorkloadConfig config;
+  config.threads = 0;
+  WorkloadReport report;
+  EXPECT_EQ(RunWorkload(config, &report).code, -1);
+}
@@ -0,0 +1,302 @@
+#include "../include/storage/zone_map.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../include/storage/page_manager.h"
+#include "../include/storage/table_scan.h"
+#include "../include/tuple/tuple_accessor.h"
+#include "../include/tuple/tuple_builder.h"
+#include "../include/tuple/tuple_serializer.h"
+
+namespace fs = std::filesystem;
+
+class ZoneMapTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    schema_.AddColumn("ts", DataType::BIGINT, false, 0);
+    schema_.AddColumn("value", DataType::DOUBLE, true, 0);
+    schema_.AddColumn("host", DataType::VARCHAR, true, 32);
+    schema_.AddColumn("note", DataType::VARCHAR, true, 64);
+    schema_.Finalize();
+
+    fs::create_directories("/tmp/test");
+    base_ = "/tmp/test/zone_map_test_" +
+            std::to_string(
+                std::chrono::system_clock::now().time_since_epoch().count());
+  }
+
+  void TearDown() override {
+    for (const char* suffix : {".db", ".fsm", ".zmap"}) {
+      std::remove((base_ + suffix).c_str());
+    }
+  }
+
+  // Row i: ts i, host-(i % 7), value NULL for every 10th row; note only on
+  // rows from 2000 on
+  std::vector<char> Row(int64_t ts, int i) const {
+    TupleBuilder builder(schema_);
+    builder.SetBigInt("ts", ts);
+    builder.SetVarChar("host", "host-" + std::to_string(i % 7));
+    if (i % 10 == 0) {
+      builder.SetNull("value");
+    } else {
+      builder.SetDouble("value", i * 0.5);
+    }
+    if (i >= 2000) {
+      builder.SetVarChar("note", "late");
+    } else {
+      builder.SetNull("note");
+    }
+    std::vector<char> row(256);
+    row.resize(TupleSerializer::Serialize(schema_, builder.BuildRefs(),
+                                          row.data(), row.size()));
+    return row;
+  }
+
+  std::vector<TupleId> InsertRows(PageManager* page_manager, int begin,
+                                  int end) {
+    std::vector<std::vector<char>> rows;
+    std::vector<TupleSlice> slices;
+    for (int i = begin; i < end; i++) {
+      rows.push_back(Row(i, i));
+    }
+    for (const std::vector<char>& row : rows) {
+      slices.push_back({row.data(), static_cast<uint16_t>(row.size())});
+    }
+    return page_manager->InsertTuples(slices);
+  }
+
+  // ts of every tuple the scan returns
+  std::set<int64_t> Scan(PageManager* page_manager,
+                         const ScanPredicate& predicate,
+                         size_t* pages_skipped = nullptr) const {
+    TableScan scan(page_manager);
+    scan.SetPredicate(&predicate);
+    std::set<int64_t> seen;
+    TupleView tuple;
+    while (scan.Next(&tuple)) {
+      seen.insert(TupleAccessor(schema_, tuple.data, tuple.size)
+                      .GetBigInt("ts"));
+    }
+    if (pages_skipped != nullptr) {
+      *pages_skipped = scan.GetPagesSkipped();
+    }
+    return seen;
+  }
+
+  std::unique_ptr<ZoneMap> NewZoneMap(size_t bloom_bits = 256) const {
+    return std::make_unique<ZoneMap>(
+        base_ + ".zmap", schema_,
+        std::vector<std::string>{"ts", "value", "host", "note"}, bloom_bits);
+  }
+
+  Schema schema_;
+  std::string base_;
+};
+
+TEST_F(ZoneMapTest, RangeAndPointPredicatesSkipPages) {
+  std::unique_ptr<ZoneMap> zone_map = NewZoneMap();
+  DiskManager disk_manager(base_ + ".db");
+  FreeSpaceMap fsm(base_ + ".fsm");
+  PageManager page_manager(&disk_manager, &fsm, 1);
+  page_manager.SetZoneMap(zone_map.get());
+  InsertRows(&page_manager, 0, 3000);
+  const size_t pages = disk_manager.GetNextPageId() - 1;
+  ASSERT_GT(pages, 10u);
+  EXPECT_EQ(zone_map->GetTrackedPageCount(), pages);
+
+  ZoneSummary summary;
+  ASSERT_TRUE(zone_map->GetSummary(1, "ts", &summary));
+  EXPECT_EQ(summary.min_int, 0);
+  EXPECT_GT(summary.row_count, 0u);
+  EXPECT_EQ(summary.max_int, summary.row_count - 1);
+  ASSERT_TRUE(zone_map->GetSummary(1, "value", &summary));
+  EXPECT_EQ(summary.null_count, (summary.row_count + 9) / 10);
+  EXPECT_EQ(summary.min_double, 0.5);
+  EXPECT_FALSE(zone_map->GetSummary(1, "nope", &summary));
+
+  // Time range: only the pages holding it are read
+  ScanPredicate range(schema_);
+  range.Between("ts", FieldValue::BigInt(1000), FieldValue::BigInt(1099));
+  size_t skipped = 0;
+  std::set<int64_t> seen = Scan(&page_manager, range, &skipped);
+  ASSERT_EQ(seen.size(), 100u);
+  EXPECT_EQ(*seen.begin(), 1000);
+  EXPECT_GE(skipped, pages - 4);
+
+  // NE skips nothing here; an all-NULL column skips the early pages
+  ScanPredicate ne(schema_);
+  ne.Compare("ts", CompareOp::NE, FieldValue::BigInt(5));
+  EXPECT_EQ(Scan(&page_manager, ne, &skipped).size(), 2999u);
+  EXPECT_EQ(skipped, 0u);
+  ScanPredicate late(schema_);
+  late.Compare("note", CompareOp::EQ, FieldValue::VarChar("late"));
+  EXPECT_EQ(Scan(&page_manager, late, &skipped).size(), 1000u);
+  EXPECT_GE(skipped, pages / 2);
+
+  // Bloom filters: a value on no page, and one that is everywhere
+  ScanPredicate missing(schema_);
+  missing.In("host", {FieldValue::VarChar("host-9"),
+                      FieldValue::VarChar("other")});
+  EXPECT_TRUE(Scan(&page_manager, missing, &skipped).empty());
+  EXPECT_GE(skipped, pages * 9 / 10);
+  ScanPredicate present(schema_);
+  present.Compare("host", CompareOp::EQ, FieldValue::VarChar("host-3"))
+      .Compare("value", CompareOp::EQ, FieldValue::Double(1.5));
+  seen = Scan(&page_manager, present, &skipped);
+  EXPECT_EQ(seen, std::set<int64_t>{3});
+  EXPECT_GE(skipped, pages - 1);
+}
+
+TEST_F(ZoneMapTest, UpdatesAndDeletesNeverHideTuples) {
+  std::unique_ptr<ZoneMap> zone_map = NewZoneMap(0);
+  DiskManager disk_manager(base_ + ".db");
+  FreeSpaceMap fsm(base_ + ".fsm");
+  PageManager page_manager(&disk_manager, &fsm, 1);
+  page_manager.SetZoneMap(zone_map.get());
+  std::vector<TupleId> ids = InsertRows(&page_manager, 0, 2000);
+
+  // Move some tuples far into the future, some with a longer row that no
+  // longer fits in place
+  std::set<int64_t> moved;
+  for (int i = 0; i < 2000; i += 97) {
+    std::vector<char> row = Row(1000000 + i, i);
+    if (i % 2 == 0) {
+      TupleBuilder builder(schema_);
+      builder.SetBigInt("ts", 1000000 + i)
+          .SetVarChar("host", "host-0")
+          .SetDouble("value", 1)
+          .SetVarChar("note", std::string(64, 'x'));
+      row.resize(256);
+      row.resize(TupleSerializer::Serialize(schema_, builder.BuildRefs(),
+                                            row.data(), row.size()));
+    }
+    ASSERT_EQ(page_manager
+                  .UpdateTuple(ids[i], row.data(),
+                               static_cast<uint16_t>(row.size()))
+                  .code,
+              0);
+    moved.insert(1000000 + i);
+  }
+  ScanPredicate future(schema_);
+  future.Compare("ts", CompareOp::GE, FieldValue::BigInt(1000000));
+  EXPECT_EQ(Scan(&page_manager, future), moved);
+
+  // The old values are gone but still widen their pages
+  ScanPredicate old(schema_);
+  old.Between("ts", FieldValue::BigInt(0), FieldValue::BigInt(100));
+  std::set<int64_t> seen = Scan(&page_manager, old);
+  EXPECT_EQ(seen.size(), 99u);
+  EXPECT_EQ(seen.count(0), 0u);
+  EXPECT_EQ(seen.count(97), 0u);
+
+  // Deletes count down; a rebuild tightens min/max
+  ZoneSummary before;
+  ASSERT_TRUE(zone_map->GetSummary(1, "ts", &before));
+  ASSERT_EQ(page_manager.DeleteTuple(ids[1]).code, 0);
+  ZoneSummary after;
+  ASSERT_TRUE(zone_map->GetSummary(1, "ts", &after));
+  EXPECT_EQ(after.row_count, before.row_count - 1);
+  for (int i = 2; i < 10; i++) {
+    ASSERT_EQ(page_manager.DeleteTuple(ids[i]).code, 0);
+  }
+  ASSERT_EQ(page_manager.RebuildZoneMap(1).code, 0);
+  ASSERT_TRUE(zone_map->GetSummary(1, "ts", &after));
+  EXPECT_EQ(after.min_int, 10);
+  size_t skipped = 0;
+  ScanPredicate first_rows(schema_);
+  first_rows.Compare("ts", CompareOp::LT, FieldValue::BigInt(10));
+  EXPECT_TRUE(Scan(&page_manager, first_rows, &skipped).empty());
+  EXPECT_EQ(skipped, disk_manager.GetNextPageId() - 1);
+}
+
+TEST_F(ZoneMapTest, UntrackedPagesAreSummarizedWhenWritten) {
+  DiskManager disk_manager(base_ + ".db");
+  FreeSpaceMap fsm(base_ + ".fsm");
+  PageManager page_manager(&disk_manager, &fsm, 1);
+  InsertRows(&page_manager, 0, 1000);
+  const size_t pages = disk_manager.GetNextPageId() - 1;
+
+  std::unique_ptr<ZoneMap> zone_map = NewZoneMap();
+  page_manager.SetZoneMap(zone_map.get());
+  EXPECT_EQ(zone_map->GetTrackedPageCount(), 0u);
+
+  // Untracked pages always may match
+  ScanPredicate none(schema_);
+  none.Compare("ts", CompareOp::GT, FieldValue::BigInt(5000));
+  size_t skipped = 0;
+  EXPECT_TRUE(Scan(&page_manager, none, &skipped).empty());
+  EXPECT_EQ(skipped, 0u);
+
+  // The next insert lands on the last page and summarizes all of it
+  std::vector<char> row = Row(5001, 1);
+  const TupleId id =
+      page_manager.InsertTuple(row.data(), static_cast<uint16_t>(row.size()));
+  ASSERT_TRUE(zone_map->IsTracked(id.page_id));
+  ZoneSummary summary;
+  ASSERT_TRUE(zone_map->GetSummary(id.page_id, "ts", &summary));
+  EXPECT_EQ(summary.max_int, 5001);
+  EXPECT_LT(summary.min_int, 1000);
+  EXPECT_EQ(Scan(&page_manager, none), std::set<int64_t>{5001});
+
+  EXPECT_EQ(page_manager.RebuildZoneMap(), disk_manager.GetNextPageId() - 1);
+  EXPECT_EQ(Scan(&page_manager, none, &skipped), std::set<int64_t>{5001});
+  EXPECT_EQ(skipped, disk_manager.GetNextPageId() - 2);
+  EXPECT_GE(skipped, pages - 1);
+  page_manager.SetZoneMap(nullptr);
+}
+
+TEST_F(ZoneMapTest, ReopensCleanFilesAndDiscardsOthers) {
+  {
+    std::unique_ptr<ZoneMap> zone_map = NewZoneMap();
+    DiskManager disk_manager(base_ + ".db");
+    FreeSpaceMap fsm(base_ + ".fsm");
+    PageManager page_manager(&disk_manager, &fsm, 1);
+    page_manager.SetZoneMap(zone_map.get());
+    InsertRows(&page_manager, 0, 1000);
+    ASSERT_EQ(page_manager.FlushAllPages().code, 0);
+    page_manager.SetZoneMap(nullptr);
+  }
+  const size_t tracked = NewZoneMap()->GetTrackedPageCount();
+  EXPECT_GT(tracked, 1u);
+  {
+    std::unique_ptr<ZoneMap> zone_map = NewZoneMap();
+    ZoneSummary summary;
+    ASSERT_TRUE(zone_map->GetSummary(1, "ts", &summary));
+    EXPECT_EQ(summary.min_int, 0);
+    EXPECT_EQ(zone_map->GetTrackedPageCount(), tracked);
+
+    // A change still in progress when the map goes away (a crash) leaves
+    // the file unclean
+    ASSERT_TRUE(zone_map->BeginChange());
+  }
+  EXPECT_EQ(NewZoneMap()->GetTrackedPageCount(), 0u);
+
+  // Built for other columns or another filter size: starts over
+  {
+    std::unique_ptr<ZoneMap> zone_map = NewZoneMap();
+    zone_map->ResetPage(1, nullptr, 0);
+  }
+  EXPECT_EQ(NewZoneMap()->GetTrackedPageCount(), 1u);
+  EXPECT_EQ(NewZoneMap(64)->GetTrackedPageCount(), 0u);
+  {
+    std::unique_ptr<ZoneMap> zone_map = NewZoneMap();
+    zone_map->ResetPage(2, nullptr, 0);
+  }
+  ZoneMap ts_only(base_ + ".zmap", schema_, {"ts"});
+  EXPECT_EQ(ts_only.GetTrackedPageCount(), 0u);
+
+  EXPECT_THROW(ZoneMap(base_ + ".zmap", schema_, {"nope"}),
+               std::invalid_argument);
+  EXPECT_THROW(ZoneMap(base_ + ".zmap", schema_, {"ts"}, 100),
+               std::invalid_argument);
+  EXPECT_THROW(ZoneMap(base_ + ".zmap", schema_, {}), std::invalid_argument);
+}